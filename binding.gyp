@@ -8,6 +8,32 @@
       "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS"],
       "cflags!": ["-fno-exceptions"],
       "cflags_cc!": ["-fno-exceptions"],
+      "sources": [
+        "src/common/appx_manifest.cpp",
+        "src/common/base64.cpp",
+        "src/common/clipboard_change_detector.cpp",
+        "src/common/clipboard_change_payload.cpp",
+        "src/common/clipboard_history.cpp",
+        "src/common/clipboard_provider.cpp",
+        "src/common/clipboard_read.cpp",
+        "src/common/clipboard_snapshot.cpp",
+        "src/common/clipboard_snapshot_cache.cpp",
+        "src/common/clipboard_write.cpp",
+        "src/common/content_hash.cpp",
+        "src/common/event_coalescer.cpp",
+        "src/common/external_bytes.cpp",
+        "src/common/history_log.cpp",
+        "src/common/image_thumbnail.cpp",
+        "src/common/keyword_matcher.cpp",
+        "src/common/mapped_file.cpp",
+        "src/common/native_event.cpp",
+        "src/common/packed_file_list.cpp",
+        "src/common/pasteboard.cpp",
+        "src/common/process_info_cache.cpp",
+        "src/common/sequence_waiter.cpp",
+        "src/common/text_classifier.cpp",
+        "src/common/utf_transcode.cpp"
+      ],
       "conditions": [
         [
           "OS=='mac'",
@@ -47,6 +73,19 @@
               }
             }
           }
+        ],
+        [
+          "OS=='linux'",
+          {
+            "sources": [
+              "src/binding_linux.cpp",
+              "src/linux/x11_pasteboard.cpp",
+              "src/linux/x11_selected_content.cpp",
+              "src/linux/x11_selection_monitor.cpp"
+            ],
+            "cflags_cc": ["-std=c++17"],
+            "libraries": ["-lX11", "-lXfixes"]
+          }
         ]
       ]
     }
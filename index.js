@@ -12,9 +12,29 @@ class ClipboardMonitor {
 
   /**
    * 启动剪贴板监控
-   * @param {Function} callback - 剪贴板变化时的回调函数（无参数）
+   * @param {Function} callback - 剪贴板变化时的回调函数（默认无参数；启用 payload 时参数为变化负载）
+   * @param {Object} [options] - 可选配置
+   * @param {boolean} [options.primary=false] - Linux: 同时监听 X11 PRIMARY 选区（选中即触发）
+   * @param {boolean} [options.payload=false] - Windows: 在监控线程内一次性读取变化负载并作为回调参数，
+   *   避免回调中再次打开剪贴板。负载结构：
+   *   { sequence, opened, formats: [{ id, name, size }], owner: { pid, app, appPath },
+   *     hasText, textPreview, textTruncated, fileCount, historyId }
+   *   size 为 -1 表示未查询：只查询负载本身会读取的格式（文件列表、启用预览时的 Unicode 文本），
+   *   其余格式不调用 GetClipboardData，避免触发格式合成或来源程序的延迟渲染，需要时再按需读取
+   * @param {number} [options.previewLength=256] - Windows: 文本预览最大字节数（UTF-8，0 表示不读取预览）
+   * @param {boolean} [options.classify=false] - Windows（需启用 payload）: 在监控线程内对完整文本分类，
+   *   负载增加 classification: { kinds, exact, types, matches: [{ type, start, end, text }], truncated }，
+   *   kinds/exact 为 ClipboardMonitor.TextKind 位（exact 表示整段文本恰好是该类型），
+   *   start/end 为 JS 字符串下标；json/code 只做整体判定，不产生 matches
+   * @param {Object} [options.coalesce] - Windows: 变化合并参数（连续多次写入剪贴板时合并通知）
+   * @param {boolean} [options.coalesce.leading=false] - 首个变化立即通知（开启后一次多格式复制会收到首个与收尾两次回调）
+   * @param {boolean} [options.coalesce.trailing=true] - 连续写入结束后再通知一次最终状态（不能与 leading 同时为 false）
+   * @param {number} [options.coalesce.quietMs=100] - 静默期：最后一次写入后等待多久视为结束
+   * @param {number} [options.coalesce.maxWaitMs=500] - 持续写入时最长等待多久强制通知一次（0 表示不限制）
+   * @param {boolean} [options.coalesce.groupByFormats=false] - 按格式集合（文本/文件/图片/HTML/PNG）分组合并；
+   *   同一次复制分多次写入、格式集合逐步扩大时仍合并为一次，分组以本轮第一次写入时的集合为准
    */
-  start(callback) {
+  start(callback, options) {
     if (this._isMonitoring) {
       throw new Error('Monitor is already running');
     }
@@ -26,11 +46,15 @@ class ClipboardMonitor {
     this._callback = callback;
     this._isMonitoring = true;
 
-    addon.startMonitor(() => {
+    addon.startMonitor((payload) => {
       if (this._callback) {
-        this._callback();
+        if (payload === undefined) {
+          this._callback();
+        } else {
+          this._callback(payload);
+        }
       }
-    });
+    }, options || {});
   }
 
   /**
@@ -75,21 +99,136 @@ class ClipboardMonitor {
 
   /**
    * 获取剪贴板中的文件列表
-   * @returns {Array<{path: string, name: string, isDirectory: boolean}>} 文件列表
+   * 文件属性在剪贴板关闭后并行查询；网络路径（UNC / 网络驱动器）不查询，超时的条目按非目录返回
+   * @param {Object} [options]
+   * @param {boolean} [options.packed=false] 返回紧凑结构而不是对象数组（适合上万个文件）
+   * @param {number} [options.timeoutMs=1000] 文件属性查询的总超时（毫秒）
+   * @returns {Array<{path: string, name: string, isDirectory: boolean}>|{count: number, paths: Buffer, offsets: Uint32Array, flags: Uint8Array}} 文件列表
    * - path: 文件完整路径
    * - name: 文件名
    * - isDirectory: 是否是目录
+   * packed 模式：第 i 个路径为 paths.toString('utf8', offsets[i], offsets[i + 1])，
+   * flags[i] 为 ClipboardMonitor.FileFlags 的组合（DIRECTORY / UNKNOWN / NETWORK）
    */
-  static getClipboardFiles() {
+  static getClipboardFiles(options) {
     if (platform === 'win32') {
-      return addon.getClipboardFiles();
+      return addon.getClipboardFiles(options);
     } else if (platform === 'darwin') {
       // macOS 暂不支持
       throw new Error('getClipboardFiles is not yet supported on macOS');
     }
+    if (options && options.packed) {
+      return { count: 0, paths: Buffer.alloc(0), offsets: new Uint32Array(1), flags: new Uint8Array(0) };
+    }
     return [];
   }
 
+  /**
+   * 获取剪贴板读取缓存的统计信息
+   * 剪贴板读取结果按平台序列号缓存（Windows: GetClipboardSequenceNumber，macOS: changeCount），
+   * 两次变化之间的重复读取直接从内存返回。Linux 尚无剪贴板读取接口，统计恒为 0
+   * @returns {{hits: number, misses: number, bypassed: number, discarded: number, sequence: number}}
+   * - hits: 命中缓存次数
+   * - misses: 实际读取剪贴板次数
+   * - bypassed: 平台无法提供序列号、直接读取的次数
+   * - discarded: 读取期间剪贴板发生变化、结果未缓存的次数
+   * - sequence: 当前剪贴板序列号
+   */
+  static getCacheStats() {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      return { hits: 0, misses: 0, bypassed: 0, discarded: 0, sequence: 0 };
+    }
+    return addon.getClipboardCacheStats();
+  }
+
+  /**
+   * 在一次剪贴板会话内读取多种格式（只打开剪贴板一次，图像在关闭剪贴板后编码）
+   * @param {number|Array<'text'|'html'|'rtf'|'image'|'files'>} [formats] - ClipboardMonitor.Format 按位或，
+   * 或格式名数组；默认读取全部格式
+   * @param {{utf16?: boolean, binary?: boolean}} [options] - 大内容的零拷贝输出（直接以原生内存作为 JS 缓冲区）
+   * - utf16: text 以 Uint16Array（UTF-16 码元）返回，可用 TextDecoder('utf-16le') 或 String.fromCharCode 按需转换
+   * - binary: image 以 PNG Buffer 返回（不做 base64），html/rtf 以原文 Buffer 返回
+   * @returns {{sequence: number, opened: boolean, lockHeldMs: number, text?: string|Uint16Array, html?: string|Buffer, rtf?: string|Buffer, image?: string|Buffer, files?: string[]}}
+   * - 只返回请求且存在的格式；image 为 base64 PNG，html 在 Windows 上为 CF_HTML 原文（含头部）
+   * - lockHeldMs: 本次持有剪贴板的时长
+   * @example
+   * const { text, html } = ClipboardMonitor.readClipboard(['text', 'html']);
+   * const { image } = ClipboardMonitor.readClipboard(['image'], { binary: true }); // PNG Buffer
+   */
+  static readClipboard(formats, options) {
+    let mask = ClipboardMonitor.Format.ALL;
+    if (Array.isArray(formats)) {
+      mask = 0;
+      for (const name of formats) {
+        const bit = ClipboardMonitor.Format[String(name).toUpperCase()];
+        if (bit === undefined) {
+          throw new TypeError(`Unknown clipboard format: ${name}`);
+        }
+        mask |= bit;
+      }
+    } else if (formats !== undefined) {
+      mask = formats;
+    }
+
+    if (platform !== 'win32' && platform !== 'darwin') {
+      throw new Error('readClipboard is only supported on Windows and macOS');
+    }
+    return addon.readClipboard(mask, options);
+  }
+
+  /**
+   * 尚未被 GC 回收的零拷贝缓冲区统计（readClipboard 的 utf16/binary 输出）
+   * @returns {{liveCount: number, liveBytes: number, adopted: number}}
+   */
+  static getExternalBufferStats() {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      return { liveCount: 0, liveBytes: 0, adopted: 0 };
+    }
+    return addon.getExternalBufferStats();
+  }
+
+  /**
+   * 获取持有剪贴板时长的统计（所有打开剪贴板的读取路径，包括监控线程）
+   * @returns {{count: number, totalMs: number, maxMs: number, lastMs: number}}
+   */
+  static getLockStats() {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      return { count: 0, totalMs: 0, maxMs: 0, lastMs: 0 };
+    }
+    return addon.getClipboardLockStats();
+  }
+
+  /**
+   * 重置剪贴板持有时长统计
+   */
+  static resetLockStats() {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      return;
+    }
+    addon.resetClipboardLockStats();
+  }
+
+  /**
+   * 原子写入多种剪贴板格式：在工作线程中编码全部格式，并在一次剪贴板事务内发布，
+   * 监听方只会收到一次变化通知（分多次写入时每次都会触发一次）
+   * @param {{text?: string, html?: string, rtf?: string, image?: {width: number, height: number, data: Buffer, stride?: number}, png?: Buffer|string, files?: Array<string|{path: string}>}} data
+   * - html: HTML 片段（Windows 自动生成 CF_HTML 头部；已含 <!--StartFragment--> 标记时保留原文）
+   * - image.data: 原始 BGRA 像素（自上而下逐行），stride 默认 width * 4
+   * - png: PNG 文件字节，或 base64 / data URL 字符串（如截图的 base64 属性，原生解码，无需 Buffer.from）
+   * @returns {Promise<boolean>} 写入成功时 resolve(true)，失败时 reject
+   * @example
+   * await ClipboardMonitor.writeClipboard({ text: 'hi', html: '<b>hi</b>' });
+   */
+  static writeClipboard(data) {
+    if (data === null || typeof data !== 'object') {
+      throw new TypeError('data must be an object');
+    }
+    if (platform !== 'win32' && platform !== 'darwin') {
+      return Promise.reject(new Error('writeClipboard is only supported on Windows and macOS'));
+    }
+    return addon.writeClipboard(data);
+  }
+
   /**
    * 设置剪贴板中的文件列表
    * @param {Array<string|{path: string}>} files - 文件路径数组
@@ -123,6 +262,33 @@ class ClipboardMonitor {
   }
 }
 
+// readClipboard 格式掩码（与 src/common/clipboard_read.h 一致）
+ClipboardMonitor.Format = Object.freeze({
+  TEXT: 1,
+  HTML: 2,
+  RTF: 4,
+  IMAGE: 8,
+  FILES: 16,
+  ALL: 31
+});
+
+// 变化负载 classification 的类型位（与 src/common/text_classifier.h 一致）
+ClipboardMonitor.TextKind = Object.freeze({
+  URL: 1,
+  EMAIL: 2,
+  PATH: 4,
+  COLOR: 8,
+  JSON: 16,
+  CODE: 32
+});
+
+// getClipboardFiles({ packed: true }) 的 flags 位（与 src/common/packed_file_list.h 一致）
+ClipboardMonitor.FileFlags = Object.freeze({
+  DIRECTORY: 1,
+  UNKNOWN: 2,
+  NETWORK: 4
+});
+
 class WindowMonitor {
   constructor() {
     this._callback = null;
@@ -478,10 +644,11 @@ class ScreenCapture {
   /**
    * 启动区域截图
    * @param {Function} callback - 截图完成时的回调函数
-   * - 参数: { success: boolean, width?: number, height?: number }
+   * - 参数: { success: boolean, width?: number, height?: number, base64?: string }
    * - success: 是否成功截图
    * - width: 截图宽度（成功时）
    * - height: 截图高度（成功时）
+   * - base64: PNG data URL（成功时；惰性属性，首次读取时才编码）
    */
   static start(callback) {
     if (platform === 'darwin') {
@@ -525,6 +692,93 @@ class IconExtractor {
   }
 }
 
+// 剪贴板历史类（由原生监控线程直接写入，JS 只按索引分页读取）
+class ClipboardHistory {
+  /**
+   * 配置剪贴板历史
+   * @param {Object} options - 配置项
+   * @param {boolean} [options.enabled] - 是否在剪贴板变化时写入历史（需同时启动 ClipboardMonitor）
+   * @param {number} [options.maxEntries=200] - 最多保留的条目数
+   * @param {number} [options.maxBytes=67108864] - 所有条目数据的总字节上限，超出时淘汰最久未使用的条目
+   * @param {string|null} [options.persistDir] - 持久化目录（需已存在）：条目同时写入该目录下的 history.log/history.idx，
+   *   重启后仍可分页读取；传 null 或空字符串关闭持久化。超出持久化容量时最旧的条目被写入墓碑，
+   *   失效记录会在后台自动压缩
+   * @param {number} [options.persistMaxEntries] - 持久化日志最多保留的条目数（0 或未设置时与 maxEntries 相同）
+   * @param {number} [options.persistMaxBytes] - 持久化日志的总字节上限（0 或未设置时与 maxBytes 相同）
+   * @param {number} [options.thumbnailSize=96] - Windows: 图片条目缩略图的长边（0 表示不生成），
+   *   捕获时生成并作为 thumbnail 格式保存
+   */
+  static configure(options) {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      throw new Error('ClipboardHistory is only supported on Windows and macOS');
+    }
+    addon.configureClipboardHistory(options || {});
+  }
+
+  /**
+   * 分页读取历史条目（索引 0 为最新，重复复制的内容会移动到最前并累加 copyCount）
+   * @param {number} [offset=0] - 起始索引
+   * @param {number} [count=50] - 条目数
+   * @returns {Array<{id: number, hash: string, sequence: number, createdAt: number, lastSeenAt: number, copyCount: number, bytes: number, formats: Array<{name: string, size: number}>}>}
+   * - formats.name: text（UTF-8 文本）、html、files（换行分隔的路径）、CF_DIB（Windows 原始位图）、
+   *   thumbnail（CF_DIB 的缩略图）
+   */
+  static getEntries(offset = 0, count = 50) {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      throw new Error('ClipboardHistory is only supported on Windows and macOS');
+    }
+    return addon.getClipboardHistory(offset, count);
+  }
+
+  /**
+   * 读取条目某个格式的数据
+   * @param {number} id - 条目 id
+   * @param {string} format - 格式名
+   * @returns {string|Buffer|{width: number, height: number, data: Buffer}|null} text/html/files 返回字符串，
+   *   thumbnail 返回预乘 BGRA 像素及尺寸，其他格式返回 Buffer；不存在时返回 null
+   */
+  static getData(id, format) {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      throw new Error('ClipboardHistory is only supported on Windows and macOS');
+    }
+    return addon.getClipboardHistoryData(id, format);
+  }
+
+  /**
+   * 删除条目
+   * @param {number} id - 条目 id
+   * @returns {boolean} 是否删除成功
+   */
+  static remove(id) {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      throw new Error('ClipboardHistory is only supported on Windows and macOS');
+    }
+    return addon.removeClipboardHistoryEntry(id);
+  }
+
+  /**
+   * 清空历史
+   */
+  static clear() {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      throw new Error('ClipboardHistory is only supported on Windows and macOS');
+    }
+    addon.clearClipboardHistory();
+  }
+
+  /**
+   * 获取历史统计
+   * @returns {{enabled: boolean, entries: number, bytes: number, maxEntries: number, maxBytes: number, added: number, duplicates: number, evicted: number, rejected: number, persisted: null | {entries: number, records: number, logBytes: number, deadBytes: number, recoveredRecords: number, truncatedBytes: number, compactions: number, evicted: number, indexRebuilt: boolean}}}
+   * - persisted 仅在配置 persistDir 后存在；recoveredRecords/truncatedBytes 反映上次异常退出后的尾部恢复情况
+   */
+  static getStats() {
+    if (platform !== 'win32' && platform !== 'darwin') {
+      throw new Error('ClipboardHistory is only supported on Windows and macOS');
+    }
+    return addon.getClipboardHistoryStats();
+  }
+}
+
 // UWP 应用管理类
 class UwpManager {
   /**
@@ -588,15 +842,24 @@ class MuiResolver {
  * 实现方式：
  * - Windows: 优先使用 UI Automation API，回退到剪贴板方法（适用于 Cursor/VS Code 等编辑器）
  * - macOS: 使用模拟复制方法（Cmd+C）
+ * - Linux: 直接读取 X11 PRIMARY 选区（文本与 text/uri-list），不模拟复制、不触碰 CLIPBOARD
  *
- * 在模拟复制时会自动暂停内部的 clipboardMonitor，防止误触发监听自身发起的事件
+ * 模拟复制期间自身写入产生的剪贴板序列号会被 clipboardMonitor 丢弃，不会触发监听回调
+ * 模拟复制后等待剪贴板序列号变化（而不是固定等待），目标程序写入完成即读取
  *
+ * 该函数会阻塞调用线程直到读取完成；在 Electron 主进程中建议使用 getSelectedContentAsync
+ *
+ * @param {Object} [options] - 可选配置
+ * @param {number} [options.timeoutMs] - 等待目标程序写入剪贴板的最长时间，默认 500（Windows / macOS）；
+ *   Linux 下为读取 PRIMARY 的总超时，默认 100
+ * @param {number} [options.settleMs=15] - 序列号变化后需保持稳定的时间（覆盖分多次写入不同格式的程序）
  * @returns {Array<{type: string, data: any}>} 选中内容数组
  * - type: 'text' | 'file' | 'image'
  * - data: 根据类型不同：
  *   - text: 字符串
  *   - file: 文件路径字符串数组
  *   - image: base64 编码的 PNG 图像（带 format 和 encoding 字段）
+ * @throws {Error} Windows: 剪贴板被其他程序占用、无法保存原内容时抛出（不会清空剪贴板或模拟复制）
  *
  * @example
  * const contents = getSelectedContent();
@@ -614,13 +877,31 @@ class MuiResolver {
  *   }
  * });
  */
-function getSelectedContent() {
-  return addon.getSelectedContent();
+function getSelectedContent(options) {
+  return addon.getSelectedContent(options);
+}
+
+/**
+ * 异步获取当前选中的内容：保存/模拟复制/读取/恢复剪贴板全部在原生工作线程中执行，不阻塞主线程
+ *
+ * @param {Object} [options] - 同 getSelectedContent
+ * @param {number} [options.timeoutMs] - 等待目标程序写入剪贴板的最长时间，超时后以空数组 resolve；
+ *   默认 500（Windows / macOS），Linux 下为读取 PRIMARY 的总超时，默认 100
+ * @param {number} [options.settleMs=15] - 序列号变化后需保持稳定的时间
+ * @returns {Promise<Array<{type: string, data: any}>>} 选中内容数组（格式同 getSelectedContent）；
+ *   Windows 下无法保存原剪贴板时 reject
+ *
+ * @example
+ * const contents = await getSelectedContentAsync({ timeoutMs: 300 });
+ */
+function getSelectedContentAsync(options) {
+  return addon.getSelectedContentAsync(options);
 }
 
 // 导出所有类
 module.exports = {
   ClipboardMonitor,
+  ClipboardHistory,
   WindowMonitor,
   WindowManager,
   ScreenCapture,
@@ -629,7 +910,8 @@ module.exports = {
   IconExtractor,
   UwpManager,
   MuiResolver,
-  getSelectedContent
+  getSelectedContent,
+  getSelectedContentAsync
 };
 
 // 为了向后兼容，默认导出 ClipboardMonitor
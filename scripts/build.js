@@ -17,6 +17,8 @@ try {
     execSync('npm run build:swift', { stdio: 'inherit' });
   } else if (platform === 'win32') {
     console.log('\n🪟 Windows build complete (no Swift needed)');
+  } else if (platform === 'linux') {
+    console.log('\n🐧 Linux build complete (X11 clipboard monitor only)');
   } else {
     console.warn(`\n⚠️  Platform ${platform} is not officially supported`);
   }
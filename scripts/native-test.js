@@ -0,0 +1,125 @@
+#!/usr/bin/env node
+// 编译并运行 test/native 下的 C++ 单元测试 / 基准测试
+//
+// 用法:
+//   node scripts/native-test.js                 # 运行全部 test-*.cpp
+//   node scripts/native-test.js --bench         # 运行全部 bench-*.cpp
+//   node scripts/native-test.js clipboard       # 只运行文件名包含 clipboard 的测试
+//
+// 平台无关模块（src/common）在 Linux/macOS 上直接用系统 C++ 编译器构建，
+// Linux 额外编译 src/linux 下的 X11 后端（需要 DISPLAY，可使用 Xvfb）。
+const { execSync, spawnSync } = require('child_process');
+const fs = require('fs');
+const os = require('os');
+const path = require('path');
+
+const platform = os.platform();
+const rootDir = path.join(__dirname, '..');
+const testDir = path.join(rootDir, 'test', 'native');
+const outDir = path.join(rootDir, 'build', 'native-test');
+
+const args = process.argv.slice(2);
+const mode = args.includes('--bench') ? 'bench' : 'test';
+const filters = args.filter(a => !a.startsWith('--'));
+
+if (platform === 'win32') {
+  console.error('❌ Native tests are built with the system C++ compiler and only run on Linux/macOS');
+  process.exit(1);
+}
+
+const cxx = process.env.CXX || 'c++';
+const cxxflags = ['-std=c++17', '-O2', '-Wall', '-pthread', '-I', path.join(rootDir, 'src')];
+if (process.env.CXXFLAGS) {
+  cxxflags.push(...process.env.CXXFLAGS.split(/\s+/).filter(Boolean));
+}
+
+// 收集需要链接的模块源文件
+function listSources(dir) {
+  const full = path.join(rootDir, 'src', dir);
+  if (!fs.existsSync(full)) return [];
+  return fs.readdirSync(full)
+    .filter(f => f.endsWith('.cpp'))
+    .map(f => path.join(full, f));
+}
+
+const sources = listSources('common');
+const libs = ['-pthread'];
+if (platform === 'linux') {
+  sources.push(...listSources('linux'));
+  libs.push('-lX11', '-lXfixes');
+}
+
+function run(cmd) {
+  execSync(cmd, { stdio: 'inherit', cwd: rootDir });
+}
+
+const files = fs.readdirSync(testDir)
+  .filter(f => f.startsWith(`${mode}-`) && f.endsWith('.cpp'))
+  .filter(f => filters.length === 0 || filters.some(flt => f.includes(flt)))
+  .sort();
+
+if (files.length === 0) {
+  console.log(`⚠️  No ${mode} files matched`);
+  process.exit(0);
+}
+
+fs.mkdirSync(path.join(outDir, 'obj'), { recursive: true });
+
+console.log(`🔨 Compiling ${sources.length} module sources...`);
+const objects = [];
+try {
+  for (const src of sources) {
+    const rel = path.relative(path.join(rootDir, 'src'), src).replace(/[\\/]/g, '_');
+    const obj = path.join(outDir, 'obj', rel.replace(/\.cpp$/, '.o'));
+    // 增量编译：源文件或头文件未变化时复用目标文件
+    const needsBuild = !fs.existsSync(obj) || newestHeaderMtime() > fs.statSync(obj).mtimeMs ||
+      fs.statSync(src).mtimeMs > fs.statSync(obj).mtimeMs;
+    if (needsBuild) {
+      run(`${cxx} ${cxxflags.join(' ')} -c "${src}" -o "${obj}"`);
+    }
+    objects.push(obj);
+  }
+} catch (error) {
+  console.error('\n❌ Module build failed');
+  process.exit(1);
+}
+
+function newestHeaderMtime() {
+  if (newestHeaderMtime.cached !== undefined) return newestHeaderMtime.cached;
+  let newest = 0;
+  const walk = dir => {
+    for (const entry of fs.readdirSync(dir, { withFileTypes: true })) {
+      const full = path.join(dir, entry.name);
+      if (entry.isDirectory()) walk(full);
+      else if (entry.name.endsWith('.h')) newest = Math.max(newest, fs.statSync(full).mtimeMs);
+    }
+  };
+  walk(path.join(rootDir, 'src'));
+  newestHeaderMtime.cached = newest;
+  return newest;
+}
+
+let failed = 0;
+for (const file of files) {
+  const exe = path.join(outDir, file.replace(/\.cpp$/, ''));
+  console.log(`\n📦 ${file}`);
+  try {
+    run(`${cxx} ${cxxflags.join(' ')} -I "${testDir}" "${path.join(testDir, file)}" ${objects.map(o => `"${o}"`).join(' ')} ${libs.join(' ')} -o "${exe}"`);
+  } catch (error) {
+    console.error(`❌ Failed to compile ${file}`);
+    failed++;
+    continue;
+  }
+
+  const result = spawnSync(exe, [], { stdio: 'inherit', cwd: testDir });
+  if (result.status !== 0) {
+    failed++;
+  }
+}
+
+console.log('');
+if (failed > 0) {
+  console.error(`❌ ${failed}/${files.length} ${mode} file(s) failed`);
+  process.exit(1);
+}
+console.log(`✅ All ${files.length} ${mode} file(s) passed`);
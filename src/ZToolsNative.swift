@@ -5,8 +5,8 @@ import ApplicationServices
 // C 风格回调函数类型（无参数）
 public typealias ClipboardCallback = @convention(c) () -> Void
 
-// C 风格回调函数类型（带JSON字符串参数）
-public typealias WindowCallback = @convention(c) (UnsafePointer<CChar>?) -> Void
+// C 风格事件回调：定长记录 + 字符串表（布局见 src/common/native_event.h），回调返回后缓冲区失效
+public typealias NativeEventCallback = @convention(c) (UnsafeRawPointer?, Int) -> Void
 
 // 全局监控状态
 private var clipboardMonitorQueue: DispatchQueue?
@@ -147,6 +147,190 @@ public func stopClipboardMonitor() {
     clipboardMonitorQueue = nil
 }
 
+/// 获取当前剪贴板 changeCount（用于 C++ 层按序列号缓存剪贴板读取结果）
+/// - Returns: NSPasteboard.general.changeCount
+@_cdecl("getClipboardChangeCount")
+public func getClipboardChangeCount() -> Int {
+    return NSPasteboard.general.changeCount
+}
+
+// MARK: - Pasteboard
+
+// 进程内剪贴板读写（替代 C++ 层原先的 pbpaste/osascript/pbcopy 子进程）
+// 所有返回缓冲区均由 malloc 分配，调用方负责 free
+
+/// 把 Data 复制到 malloc 分配的缓冲区；数据为空时返回 nil 且长度为 0
+private func copyToMallocBuffer(_ data: Data, _ outLength: UnsafeMutablePointer<UInt>) -> UnsafeMutableRawPointer? {
+    outLength.pointee = 0
+    guard !data.isEmpty, let buffer = malloc(data.count) else { return nil }
+    data.copyBytes(to: buffer.assumingMemoryBound(to: UInt8.self), count: data.count)
+    outLength.pointee = UInt(data.count)
+    return buffer
+}
+
+/// 读取剪贴板纯文本
+/// - Returns: UTF-8 字节；没有文本时返回 nil
+@_cdecl("pasteboardReadText")
+public func pasteboardReadText(_ outLength: UnsafeMutablePointer<UInt>?) -> UnsafeMutableRawPointer? {
+    guard let outLength = outLength else { return nil }
+    return autoreleasepool {
+        guard let text = NSPasteboard.general.string(forType: .string) else {
+            outLength.pointee = 0
+            return nil
+        }
+        return copyToMallocBuffer(Data(text.utf8), outLength)
+    }
+}
+
+/// 读取剪贴板中的文件列表
+/// - Returns: 以 \0 结尾的 POSIX 路径依次拼接；没有文件时返回 nil
+@_cdecl("pasteboardReadFiles")
+public func pasteboardReadFiles(_ outLength: UnsafeMutablePointer<UInt>?) -> UnsafeMutableRawPointer? {
+    guard let outLength = outLength else { return nil }
+    return autoreleasepool {
+        let options: [NSPasteboard.ReadingOptionKey: Any] = [.urlReadingFileURLsOnly: true]
+        guard let urls = NSPasteboard.general.readObjects(forClasses: [NSURL.self], options: options) as? [URL] else {
+            outLength.pointee = 0
+            return nil
+        }
+        var data = Data()
+        for url in urls {
+            data.append(contentsOf: Array(url.path.utf8))
+            data.append(0)
+        }
+        return copyToMallocBuffer(data, outLength)
+    }
+}
+
+/// 读取剪贴板图像（PNG 原样返回，TIFF 转换为 PNG）
+/// - Returns: PNG 字节；没有图像时返回 nil
+@_cdecl("pasteboardReadImagePNG")
+public func pasteboardReadImagePNG(_ outLength: UnsafeMutablePointer<UInt>?) -> UnsafeMutableRawPointer? {
+    guard let outLength = outLength else { return nil }
+    return autoreleasepool {
+        outLength.pointee = 0
+        let pasteboard = NSPasteboard.general
+        if let png = pasteboard.data(forType: .png) {
+            return copyToMallocBuffer(png, outLength)
+        }
+        guard let tiff = pasteboard.data(forType: .tiff),
+              let rep = NSBitmapImageRep(data: tiff),
+              let png = rep.representation(using: .png, properties: [:]) else {
+            return nil
+        }
+        return copyToMallocBuffer(png, outLength)
+    }
+}
+
+/// 按类型读取剪贴板原始数据（如 public.html、public.rtf）
+/// - Returns: 该类型的字节；不存在时返回 nil
+@_cdecl("pasteboardReadType")
+public func pasteboardReadType(_ type: UnsafePointer<CChar>?, _ outLength: UnsafeMutablePointer<UInt>?) -> UnsafeMutableRawPointer? {
+    guard let outLength = outLength else { return nil }
+    outLength.pointee = 0
+    guard let type = type else { return nil }
+    return autoreleasepool {
+        let pasteboardType = NSPasteboard.PasteboardType(String(cString: type))
+        guard let data = NSPasteboard.general.data(forType: pasteboardType) else { return nil }
+        return copyToMallocBuffer(data, outLength)
+    }
+}
+
+private func appendLittleEndian<T: FixedWidthInteger>(_ value: T, to data: inout Data) {
+    var little = value.littleEndian
+    withUnsafeBytes(of: &little) { data.append(contentsOf: $0) }
+}
+
+/// 保存剪贴板全部 item 的全部类型（布局见 src/common/pasteboard.h 中的 EncodePasteboardSnapshot）
+@_cdecl("pasteboardSave")
+public func pasteboardSave(_ outLength: UnsafeMutablePointer<UInt>?) -> UnsafeMutableRawPointer? {
+    guard let outLength = outLength else { return nil }
+    return autoreleasepool {
+        let items = NSPasteboard.general.pasteboardItems ?? []
+        var data = Data("ZPB1".utf8)
+        appendLittleEndian(UInt32(items.count), to: &data)
+        for item in items {
+            var entries: [(String, Data)] = []
+            for type in item.types {
+                if let value = item.data(forType: type) {
+                    entries.append((type.rawValue, value))
+                }
+            }
+            appendLittleEndian(UInt32(entries.count), to: &data)
+            for (type, value) in entries {
+                let typeBytes = Array(type.utf8)
+                appendLittleEndian(UInt32(typeBytes.count), to: &data)
+                data.append(contentsOf: typeBytes)
+                appendLittleEndian(UInt64(value.count), to: &data)
+                data.append(value)
+            }
+        }
+        return copyToMallocBuffer(data, outLength)
+    }
+}
+
+/// 清空剪贴板并写回 pasteboardSave 保存的内容
+/// - Returns: 1 成功，0 失败（数据损坏或写入失败）
+@_cdecl("pasteboardRestore")
+public func pasteboardRestore(_ bytes: UnsafeRawPointer?, _ length: UInt) -> Int32 {
+    guard let bytes = bytes, length >= 8 else { return 0 }
+    let buffer = UnsafeRawBufferPointer(start: bytes, count: Int(length))
+    var offset = 0
+
+    func read<T: FixedWidthInteger>(_ type: T.Type) -> T? {
+        let size = MemoryLayout<T>.size
+        guard offset + size <= buffer.count else { return nil }
+        var value: T = 0
+        withUnsafeMutableBytes(of: &value) { $0.copyMemory(from: UnsafeRawBufferPointer(rebasing: buffer[offset..<offset + size])) }
+        offset += size
+        return T(littleEndian: value)
+    }
+
+    func readBytes(_ count: Int) -> Data? {
+        guard count >= 0, count <= buffer.count - offset else { return nil }
+        let data = Data(buffer[offset..<offset + count])
+        offset += count
+        return data
+    }
+
+    guard readBytes(4) == Data("ZPB1".utf8), let itemCount = read(UInt32.self) else { return 0 }
+
+    return autoreleasepool {
+        var items: [NSPasteboardItem] = []
+        for _ in 0..<itemCount {
+            guard let entryCount = read(UInt32.self) else { return 0 }
+            let item = NSPasteboardItem()
+            for _ in 0..<entryCount {
+                guard let typeLength = read(UInt32.self),
+                      let typeData = readBytes(Int(typeLength)),
+                      let type = String(data: typeData, encoding: .utf8),
+                      let dataLength = read(UInt64.self),
+                      dataLength <= UInt64(Int.max),
+                      let value = readBytes(Int(dataLength)) else {
+                    return 0
+                }
+                item.setData(value, forType: NSPasteboard.PasteboardType(type))
+            }
+            items.append(item)
+        }
+        guard offset == buffer.count else { return 0 }
+
+        let pasteboard = NSPasteboard.general
+        pasteboard.clearContents()
+        if items.isEmpty {
+            return 1
+        }
+        return pasteboard.writeObjects(items) ? 1 : 0
+    }
+}
+
+/// 清空剪贴板
+/// - Returns: 清空后的 changeCount
+@_cdecl("pasteboardClear")
+public func pasteboardClear() -> Int {
+    return NSPasteboard.general.clearContents()
+}
+
 // MARK: - Window Management
 
 private struct WindowMetadata {
@@ -244,27 +428,90 @@ private func frontFinderWindowInfo() -> (finderId: Int?, path: String?, url: Str
     return (finderId, path, URL(fileURLWithPath: path).absoluteString)
 }
 
-private func jsonForWindowMetadata(_ info: WindowMetadata) -> String {
-    var fields: [String] = []
-    fields.append("\"appName\":\"\(escapeJSON(info.appName))\"")
-    fields.append("\"bundleId\":\"\(escapeJSON(info.bundleId))\"")
-    fields.append("\"title\":\"\(escapeJSON(info.title))\"")
-    fields.append("\"app\":\"\(escapeJSON(info.app))\"")
-    fields.append("\"x\":\(Int(info.bounds.origin.x))")
-    fields.append("\"y\":\(Int(info.bounds.origin.y))")
-    fields.append("\"width\":\(Int(info.bounds.size.width))")
-    fields.append("\"height\":\(Int(info.bounds.size.height))")
-    fields.append("\"appPath\":\"\(escapeJSON(info.appPath))\"")
-    fields.append("\"pid\":\(info.pid)")
-    fields.append("\"windowId\":\(info.windowId)")
-    fields.append("\"axRole\":\"\(escapeJSON(info.axRole))\"")
-    fields.append("\"axSubrole\":\"\(escapeJSON(info.axSubrole))\"")
-    fields.append("\"preciseTarget\":\(info.preciseTarget ? "true" : "false")")
-    if let finderId = info.finderId { fields.append("\"finderId\":\(finderId)") }
-    if let path = info.path { fields.append("\"path\":\"\(escapeJSON(path))\"") }
-    if let url = info.url { fields.append("\"url\":\"\(escapeJSON(url))\"") }
-    if let kind = info.kind { fields.append("\"kind\":\"\(escapeJSON(kind))\"") }
-    return "{\(fields.joined(separator: ","))}"
+// MARK: - Native Event ABI
+
+private let nativeEventVersion: UInt16 = 1
+private let nativeStringAbsent: UInt32 = 0xFFFF_FFFF
+
+private enum NativeEventKind: UInt16 {
+    case window = 1
+    case mouse = 2
+    case colorPicker = 3
+}
+
+/// 事件记录编码：字段按 src/common/native_event.h 中记录结构体的顺序与宽度写出
+private struct NativeEventWriter {
+    private var record = Data()
+    private var strings = Data()
+
+    mutating func int32(_ value: Int32) { appendLittleEndian(value, to: &record) }
+    mutating func uint32(_ value: UInt32) { appendLittleEndian(value, to: &record) }
+    mutating func int64(_ value: Int64) { appendLittleEndian(value, to: &record) }
+
+    /// 字符串写入字符串表，记录中只保存 (偏移, 长度)；nil 表示字段缺失
+    mutating func string(_ value: String?) {
+        guard let value = value else {
+            uint32(nativeStringAbsent)
+            uint32(0)
+            return
+        }
+        let bytes = Array(value.utf8)
+        uint32(UInt32(strings.count))
+        uint32(UInt32(bytes.count))
+        strings.append(contentsOf: bytes)
+    }
+
+    func finish(_ kind: NativeEventKind) -> Data {
+        var data = Data("ZEV1".utf8)
+        appendLittleEndian(nativeEventVersion, to: &data)
+        appendLittleEndian(kind.rawValue, to: &data)
+        appendLittleEndian(UInt32(record.count), to: &data)
+        appendLittleEndian(UInt32(strings.count), to: &data)
+        data.append(record)
+        data.append(strings)
+        return data
+    }
+}
+
+private func sendNativeEvent(_ event: Data, to callback: NativeEventCallback?) {
+    guard let callback = callback else { return }
+    event.withUnsafeBytes { buffer in
+        callback(buffer.baseAddress, buffer.count)
+    }
+}
+
+/// 本库实现的事件 ABI 版本，桥接层加载时校验
+@_cdecl("nativeEventAbiVersion")
+public func nativeEventAbiVersion() -> Int32 {
+    return Int32(nativeEventVersion)
+}
+
+/// 窗口事件（WindowEventRecord）
+private func encodeWindowEvent(_ info: WindowMetadata) -> Data {
+    var writer = NativeEventWriter()
+    writer.int32(Int32(clamping: Int(info.bounds.origin.x)))
+    writer.int32(Int32(clamping: Int(info.bounds.origin.y)))
+    writer.int32(Int32(clamping: Int(info.bounds.size.width)))
+    writer.int32(Int32(clamping: Int(info.bounds.size.height)))
+    writer.int32(info.pid)
+    writer.uint32(UInt32(clamping: info.windowId))
+    writer.int64(Int64(info.finderId ?? 0))
+    var flags: UInt32 = 0
+    if info.preciseTarget { flags |= 1 << 0 }
+    if info.finderId != nil { flags |= 1 << 1 }
+    writer.uint32(flags)
+    writer.uint32(0) // reserved
+    writer.string(info.appName)
+    writer.string(info.bundleId)
+    writer.string(info.title)
+    writer.string(info.app)
+    writer.string(info.appPath)
+    writer.string(info.axRole)
+    writer.string(info.axSubrole)
+    writer.string(info.path)
+    writer.string(info.url)
+    writer.string(info.kind)
+    return writer.finish(.window)
 }
 
 /// 获取窗口标题（使用 Accessibility API）
@@ -341,15 +588,17 @@ private func getAppName(from app: NSRunningApplication) -> String {
     return "Unknown.app"
 }
 
-/// 获取当前激活窗口的信息（JSON 格式）
-/// - Returns: JSON 字符串包含窗口级元数据，需要调用者 free
+/// 获取当前激活窗口的信息（窗口事件记录）
+/// - Returns: malloc 分配的记录字节，调用方负责 free；没有前台应用时返回 nil
 @_cdecl("getActiveWindow")
-public func getActiveWindow() -> UnsafeMutablePointer<CChar>? {
+public func getActiveWindow(_ outLength: UnsafeMutablePointer<UInt>?) -> UnsafeMutableRawPointer? {
+    guard let outLength = outLength else { return nil }
+    outLength.pointee = 0
     guard let metadata = getFrontmostAppUsingCG() else {
-        return strdup("{\"error\":\"No frontmost application\"}")
+        return nil
     }
 
-    return strdup(jsonForWindowMetadata(metadata))
+    return copyToMallocBuffer(encodeWindowEvent(metadata), outLength)
 }
 
 /// 根据 bundleId 激活应用窗口
@@ -451,9 +700,9 @@ private func getFrontmostAppUsingCG() -> WindowMetadata? {
 }
 
 /// 启动窗口激活监控（使用 Core Graphics API + 轮询）
-/// - Parameter callback: 窗口切换时调用的回调，传递JSON字符串
+/// - Parameter callback: 窗口切换时调用的回调，传递窗口事件记录
 @_cdecl("startWindowMonitor")
-public func startWindowMonitor(_ callback: WindowCallback?) {
+public func startWindowMonitor(_ callback: NativeEventCallback?) {
     guard let callback = callback else {
         print("Error: window callback is nil")
         return
@@ -473,10 +722,7 @@ public func startWindowMonitor(_ callback: WindowCallback?) {
         lastBundleId = appInfo.bundleId
         lastWindowId = appInfo.windowId
 
-        let jsonString = jsonForWindowMetadata(appInfo)
-        jsonString.withCString { cString in
-            callback(cString)
-        }
+        sendNativeEvent(encodeWindowEvent(appInfo), to: callback)
     }
 
     // 创建专用队列进行轮询
@@ -501,10 +747,7 @@ public func startWindowMonitor(_ callback: WindowCallback?) {
                 lastBundleId = appInfo.bundleId
                 lastWindowId = currentWindowId
 
-                let jsonString = jsonForWindowMetadata(appInfo)
-                jsonString.withCString { cString in
-                    callback(cString)
-                }
+                sendNativeEvent(encodeWindowEvent(appInfo), to: callback)
             }
         }
 
@@ -758,9 +1001,7 @@ public func unicodeType(_ text: UnsafePointer<CChar>?) -> Int32 {
 
 // MARK: - Mouse Monitor
 
-public typealias MouseCallback = @convention(c) (UnsafePointer<CChar>?) -> Void
-
-private var mouseMonitorCallback: MouseCallback? = nil
+private var mouseMonitorCallback: NativeEventCallback? = nil
 private var mouseEventTap: CFMachPort? = nil
 private var mouseRunLoopSource: CFRunLoopSource? = nil
 private var mouseMonitorRunLoop: CFRunLoop? = nil
@@ -792,9 +1033,10 @@ private let MOUSE_REPLAY_MARKER: Int64 = 0x5A544F4F4C53
 
 private func notifyMouseEvent() {
     guard let callback = mouseMonitorCallback else { return }
-    mouseEventTypeName.withCString { cStr in
-        callback(cStr)
-    }
+    // MouseEventRecord
+    var writer = NativeEventWriter()
+    writer.string(mouseEventTypeName)
+    sendNativeEvent(writer.finish(.mouse), to: callback)
 }
 
 /// CGEventTap 回调函数（拦截模式）
@@ -933,7 +1175,7 @@ func mouseEventTapHandler(_ proxy: CGEventTapProxy, _ type: CGEventType, _ event
 ///   - longPressMs: 长按阈值（毫秒），0 表示监听点击，>0 表示监听长按
 ///   - callback: 事件回调，传递事件类型字符串
 @_cdecl("startMouseMonitor")
-public func startMouseMonitor(_ buttonType: UnsafePointer<CChar>?, _ longPressMs: Int32, _ callback: MouseCallback?) {
+public func startMouseMonitor(_ buttonType: UnsafePointer<CChar>?, _ longPressMs: Int32, _ callback: NativeEventCallback?) {
     guard let callback = callback, let buttonType = buttonType else {
         print("Error: mouse callback or buttonType is nil")
         return
@@ -1102,10 +1344,18 @@ public func replayMouseEvents() {
 
 // MARK: - Color Picker
 
-public typealias ColorPickerCallback = @convention(c) (UnsafePointer<CChar>?) -> Void
 
 // 取色器状态
-private var colorPickerCallback: ColorPickerCallback? = nil
+private var colorPickerCallback: NativeEventCallback? = nil
+
+/// 取色结果（ColorPickerEventRecord）；hex 为 nil 表示取消
+private func notifyColorPicked(_ hex: String?) {
+    var writer = NativeEventWriter()
+    writer.uint32(hex != nil ? 1 : 0)
+    writer.uint32(0) // reserved
+    writer.string(hex)
+    sendNativeEvent(writer.finish(.colorPicker), to: colorPickerCallback)
+}
 private var colorPickerWindow: NSWindow? = nil
 private var colorPickerView: ColorPickerGridView? = nil
 private var isColorPickerActive = false
@@ -1428,10 +1678,7 @@ private func colorPickerEventTapHandler(_ proxy: CGEventTapProxy, _ type: CGEven
         // 左键点击 → 确认取色
         isColorPickerActive = false // 立即标记，防止后续 mouseMoved 继续更新
         let (_, hex) = capturePixelsAroundCursor()
-        let jsonString = "{\"success\":true,\"hex\":\"\(hex)\"}"
-        jsonString.withCString { cStr in
-            colorPickerCallback?(cStr)
-        }
+        notifyColorPicked(hex)
         // 只停事件 tap，不碰窗口（窗口清理由主线程的 stopColorPicker 负责）
         stopColorPickerEventTap()
         return nil // 拦截点击事件
@@ -1441,10 +1688,7 @@ private func colorPickerEventTapHandler(_ proxy: CGEventTapProxy, _ type: CGEven
         let keyCode = event.getIntegerValueField(.keyboardEventKeycode)
         if keyCode == 53 { // ESC
             isColorPickerActive = false
-            let jsonString = "{\"success\":false,\"hex\":null}"
-            jsonString.withCString { cStr in
-                colorPickerCallback?(cStr)
-            }
+            notifyColorPicked(nil)
             stopColorPickerEventTap()
             return nil // 拦截 ESC
         }
@@ -1457,7 +1701,7 @@ private func colorPickerEventTapHandler(_ proxy: CGEventTapProxy, _ type: CGEven
 
 /// 启动取色器
 @_cdecl("startColorPicker")
-public func startColorPicker(_ callback: ColorPickerCallback?) {
+public func startColorPicker(_ callback: NativeEventCallback?) {
     guard let callback = callback else {
         print("Error: color picker callback is nil")
         return
@@ -0,0 +1,249 @@
+#include <napi.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "common/clipboard_change_detector.h"
+#include "linux/x11_selected_content.h"
+#include "linux/x11_selection_monitor.h"
+
+// 全局变量 - 剪贴板监控
+static ztools::X11SelectionMonitor g_selectionMonitor;
+static ztools::ClipboardChangeDetector g_clipboardDetector;
+static std::atomic<bool> g_isMonitoring(false);
+static napi_threadsafe_function g_tsfn = nullptr;
+
+// 在主线程调用 JS 回调
+void CallJs(napi_env env, napi_value js_callback, void* context, void* data) {
+    if (env != nullptr && js_callback != nullptr) {
+        napi_value global;
+        napi_get_global(env, &global);
+        napi_call_function(env, global, js_callback, 0, nullptr, nullptr);
+    }
+}
+
+// 启动剪贴板监控
+// 参数：callback, options?: { primary?: boolean }
+// - primary: 是否同时通知 PRIMARY 选区变化（默认仅 CLIPBOARD）
+Napi::Value StartMonitor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsFunction()) {
+        Napi::TypeError::New(env, "Expected a callback function").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    if (g_isMonitoring || g_tsfn != nullptr) {
+        Napi::Error::New(env, "Monitor already started").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    bool watchPrimary = false;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (options.Has("primary") && options.Get("primary").IsBoolean()) {
+            watchPrimary = options.Get("primary").As<Napi::Boolean>().Value();
+        }
+    }
+
+    // 创建线程安全函数
+    napi_value callback = info[0];
+    napi_value resource_name;
+    napi_create_string_utf8(env, "ClipboardCallback", NAPI_AUTO_LENGTH, &resource_name);
+
+    napi_status status = napi_create_threadsafe_function(
+        env,
+        callback,
+        nullptr,
+        resource_name,
+        0,
+        1,
+        nullptr,
+        nullptr,
+        nullptr,
+        CallJs,
+        &g_tsfn
+    );
+
+    if (status != napi_ok) {
+        Napi::Error::New(env, "Failed to create threadsafe function").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    g_clipboardDetector.Reset();
+    g_clipboardDetector.SetSourceEnabled(ztools::ClipboardSource::Primary, watchPrimary);
+    g_clipboardDetector.SetSink([](const ztools::ClipboardChange&) {
+        if (g_tsfn != nullptr) {
+            napi_call_threadsafe_function(g_tsfn, nullptr, napi_tsfn_nonblocking);
+        }
+    });
+
+    // XFixes 事件驱动：变化到达即上报，无轮询
+    bool started = g_selectionMonitor.Start(
+        [](ztools::ClipboardSource source, uint64_t sequence, uint64_t selectionTime) {
+            g_clipboardDetector.Report(source, sequence, selectionTime);
+        });
+
+    if (!started) {
+        napi_release_threadsafe_function(g_tsfn, napi_tsfn_release);
+        g_tsfn = nullptr;
+        Napi::Error::New(env, "Failed to start clipboard monitor: " + g_selectionMonitor.LastError())
+            .ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    g_isMonitoring = true;
+    return env.Undefined();
+}
+
+// 停止剪贴板监控
+Napi::Value StopMonitor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    g_isMonitoring = false;
+    g_selectionMonitor.Stop();
+    g_clipboardDetector.SetSink(nullptr);
+    g_clipboardDetector.SetPaused(false);  // 重置暂停状态
+
+    if (g_tsfn != nullptr) {
+        napi_release_threadsafe_function(g_tsfn, napi_tsfn_release);
+        g_tsfn = nullptr;
+    }
+
+    return env.Undefined();
+}
+
+// 暂停剪贴板监控（不触发回调，但保持监控线程运行）
+Napi::Value PauseMonitor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    g_clipboardDetector.SetPaused(true);
+    return env.Undefined();
+}
+
+// 恢复剪贴板监控
+Napi::Value ResumeMonitor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    g_clipboardDetector.SetPaused(false);
+    return env.Undefined();
+}
+
+// ==================== 获取选中内容（Linux 实现）====================
+
+// 选中内容直接读取 PRIMARY 选区：不模拟 Ctrl+C，不保存/清空/恢复 CLIPBOARD，
+// 剪贴板监控也不会收到自身写入（无需自身写入抑制）。连接在首次调用时建立并复用
+static ztools::X11Pasteboard g_primarySelection(ztools::ClipboardSource::Primary);
+static std::mutex g_selectedContentMutex;
+
+// 不涉及 N-API，可在工作线程中执行；无法连接 X 服务器或所有者超时时结果为空
+static void CaptureSelectedContent(int timeoutMs, ztools::X11SelectedContent& content) {
+    std::lock_guard<std::mutex> lock(g_selectedContentMutex);
+    if (!g_primarySelection.IsOpen() && !g_primarySelection.Open()) {
+        return;
+    }
+    if (!ztools::ReadSelectedContent(g_primarySelection, timeoutMs, content)) {
+        content = ztools::X11SelectedContent();
+    }
+}
+
+static Napi::Array CreateSelectedContentArray(Napi::Env env, const ztools::X11SelectedContent& content) {
+    Napi::Array result = Napi::Array::New(env);
+    uint32_t index = 0;
+
+    if (content.hasText) {
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("type", "text");
+        item.Set("data", content.text);
+        result.Set(index++, item);
+    }
+
+    if (content.hasFiles) {
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("type", "file");
+        Napi::Array fileArray = Napi::Array::New(env);
+        for (size_t i = 0; i < content.files.size(); i++) {
+            fileArray.Set(uint32_t(i), content.files[i]);
+        }
+        item.Set("data", fileArray);
+        result.Set(index++, item);
+    }
+    return result;
+}
+
+// 解析 { timeoutMs?: number }（settleMs 只用于模拟复制，这里忽略）
+static bool ParseSelectedContentOptions(const Napi::CallbackInfo& info, int& timeoutMs) {
+    Napi::Env env = info.Env();
+    timeoutMs = ztools::kDefaultSelectedContentTimeoutMs;
+    if (info.Length() < 1 || info[0].IsUndefined() || info[0].IsNull()) {
+        return true;
+    }
+    if (!info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected an options object").ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Object obj = info[0].As<Napi::Object>();
+    if (obj.Has("timeoutMs") && obj.Get("timeoutMs").IsNumber()) {
+        double value = obj.Get("timeoutMs").As<Napi::Number>().DoubleValue();
+        timeoutMs = value >= 1 ? static_cast<int>(value < 60000 ? value : 60000) : 1;
+    }
+    return true;
+}
+
+// 获取选中内容（同步）
+// 参数：{ timeoutMs?: number }（可选，默认 100）
+Napi::Value GetSelectedContent(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    int timeoutMs = 0;
+    if (!ParseSelectedContentOptions(info, timeoutMs)) {
+        return env.Undefined();
+    }
+    ztools::X11SelectedContent content;
+    CaptureSelectedContent(timeoutMs, content);
+    return CreateSelectedContentArray(env, content);
+}
+
+class SelectedContentWorker : public Napi::AsyncWorker {
+    public:
+        SelectedContentWorker(int timeoutMs, Napi::Env env, Napi::Promise::Deferred deferred)
+            : Napi::AsyncWorker(env), timeoutMs_(timeoutMs), deferred_(deferred) {}
+        void Execute() override {
+            CaptureSelectedContent(timeoutMs_, content_);
+        }
+        void OnOK() override {
+            deferred_.Resolve(CreateSelectedContentArray(Env(), content_));
+        }
+        void OnError(const Napi::Error& e) override {
+            deferred_.Reject(e.Value());
+        }
+    private:
+        int timeoutMs_;
+        ztools::X11SelectedContent content_;
+        Napi::Promise::Deferred deferred_;
+};
+
+// 获取选中内容（异步）：选区转换在工作线程执行
+// 返回：Promise<Array>，结果与 getSelectedContent 相同
+Napi::Value GetSelectedContentAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    int timeoutMs = 0;
+    if (!ParseSelectedContentOptions(info, timeoutMs)) {
+        return env.Undefined();
+    }
+
+    auto deferred = Napi::Promise::Deferred::New(env);
+    auto* worker = new SelectedContentWorker(timeoutMs, env, deferred);
+    worker->Queue();
+    return deferred.Promise();
+}
+
+// 模块初始化
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("startMonitor", Napi::Function::New(env, StartMonitor));
+    exports.Set("stopMonitor", Napi::Function::New(env, StopMonitor));
+    exports.Set("pauseMonitor", Napi::Function::New(env, PauseMonitor));
+    exports.Set("resumeMonitor", Napi::Function::New(env, ResumeMonitor));
+    exports.Set("getSelectedContent", Napi::Function::New(env, GetSelectedContent));
+    exports.Set("getSelectedContentAsync", Napi::Function::New(env, GetSelectedContentAsync));
+    return exports;
+}
+
+NODE_API_MODULE(ztools_native, Init)
@@ -1,38 +1,54 @@
 #include <cstdlib>
 #include <dlfcn.h>
+#include <memory>
+#include <mutex>
 #include <napi.h>
 #include <string>
 #include <vector>
 #include <unistd.h>  // For usleep
 
+#include "common/base64.h"
+#include "common/clipboard_change_detector.h"
+#include "common/clipboard_snapshot_cache.h"
+#include "common/native_event.h"
+#include "common/pasteboard.h"
+#include "common/sequence_waiter.h"
+#include "clipboard_history_binding.h"
+#include "clipboard_read_binding.h"
+#include "clipboard_write_binding.h"
+
 // Swift 动态库函数类型定义
 typedef void (*ClipboardCallback)();          // 无参数回调
-typedef void (*WindowCallback)(const char *); // 带JSON字符串参数回调
+typedef void (*NativeEventCallback)(const void *, size_t); // 事件回调（布局见 common/native_event.h）
+typedef int (*NativeEventAbiVersionFunc)();   // Swift 库实现的事件 ABI 版本
 typedef void (*StartMonitorFunc)(ClipboardCallback);
 typedef void (*StopMonitorFunc)();
-typedef void (*StartWindowMonitorFunc)(WindowCallback);
+typedef void (*StartWindowMonitorFunc)(NativeEventCallback);
 typedef void (*StopWindowMonitorFunc)();
-typedef char *(*GetActiveWindowFunc)();
+typedef void *(*GetActiveWindowFunc)(size_t *); // 窗口事件记录（malloc 缓冲区），无前台应用时为 nullptr
 typedef int (*ActivateWindowFunc)(const char *);
 typedef int (*SimulatePasteFunc)(); // 模拟粘贴功能
 typedef int (*SimulateKeyboardTapFunc)(const char *,
                                        const char *); // 模拟键盘按键功能
 typedef int (*UnicodeTypeFunc)(const char *);              // Unicode 字符输入
 typedef int (*SetClipboardFilesFunc)(const char *);        // 设置剪贴板文件
-typedef void (*MouseEventCB)(const char *);                       // 鼠标事件回调
-typedef void (*StartMouseMonitorFunc)(const char *, int, MouseEventCB); // 启动鼠标监控
+typedef void (*StartMouseMonitorFunc)(const char *, int, NativeEventCallback); // 启动鼠标监控
 typedef void (*StopMouseMonitorFunc)();                            // 停止鼠标监控
 typedef void (*ReplayMouseEventsFunc)();                           // 重放鼠标事件
 typedef int (*SimulateMouseMoveFunc)(double, double);              // 模拟鼠标移动
 typedef int (*SimulateMouseClickFunc)(double, double);             // 模拟鼠标单击
 typedef int (*SimulateMouseDoubleClickFunc)(double, double);       // 模拟鼠标双击
 typedef int (*SimulateMouseRightClickFunc)(double, double);        // 模拟鼠标右击
-typedef void (*ColorPickerCB)(const char *);                       // 取色器回调
-typedef void (*StartColorPickerFunc)(ColorPickerCB);               // 启动取色器
+typedef void (*StartColorPickerFunc)(NativeEventCallback);         // 启动取色器
 typedef void (*StopColorPickerFunc)();                             // 停止取色器
 typedef void *(*FetchFileIconFunc)(const char *, size_t *);        // 获取文件图标 PNG
 typedef char *(*GetAllFinderWindowsFunc)();                        // 获取所有 Finder 窗口
 typedef int (*SetAddressBarFunc)(const char *, const char *);       // 设置 Finder/文件对话框地址
+typedef long (*GetClipboardChangeCountFunc)();                     // 获取 NSPasteboard changeCount
+typedef void *(*PasteboardReadFunc)(size_t *);                     // 读取剪贴板内容（malloc 缓冲区）
+typedef void *(*PasteboardReadTypeFunc)(const char *, size_t *);   // 按类型读取剪贴板原始数据
+typedef int (*PasteboardRestoreFunc)(const void *, size_t);        // 写回剪贴板快照
+typedef long (*PasteboardClearFunc)();                             // 清空剪贴板
 
 // 全局变量
 static void *swiftLibHandle = nullptr;
@@ -42,6 +58,7 @@ static StartMonitorFunc startMonitorFunc = nullptr;
 static StopMonitorFunc stopMonitorFunc = nullptr;
 static StartWindowMonitorFunc startWindowMonitorFunc = nullptr;
 static StopWindowMonitorFunc stopWindowMonitorFunc = nullptr;
+static NativeEventAbiVersionFunc nativeEventAbiVersionFunc = nullptr;
 static GetActiveWindowFunc getActiveWindowFunc = nullptr;
 static ActivateWindowFunc activateWindowFunc = nullptr;
 static SimulatePasteFunc simulatePasteFunc = nullptr; // 模拟粘贴函数
@@ -63,7 +80,18 @@ static StopColorPickerFunc stopColorPickerFunc = nullptr;
 static FetchFileIconFunc fetchFileIconFunc = nullptr;
 static GetAllFinderWindowsFunc getAllFinderWindowsFunc = nullptr;
 static SetAddressBarFunc setAddressBarFunc = nullptr;
-static bool g_isPaused = false; // 剪贴板监控暂停状态
+static GetClipboardChangeCountFunc getClipboardChangeCountFunc = nullptr;
+static PasteboardReadFunc pasteboardReadTextFunc = nullptr;
+static PasteboardReadFunc pasteboardReadFilesFunc = nullptr;
+static PasteboardReadFunc pasteboardReadImagePngFunc = nullptr;
+static PasteboardReadFunc pasteboardSaveFunc = nullptr;
+static PasteboardReadTypeFunc pasteboardReadTypeFunc = nullptr;
+static PasteboardRestoreFunc pasteboardRestoreFunc = nullptr;
+static PasteboardClearFunc pasteboardClearFunc = nullptr;
+// 平台无关的变化检测核心：负责暂停状态（Swift 端轮询 changeCount 后才回调）
+static ztools::ClipboardChangeDetector g_clipboardDetector;
+// 剪贴板快照缓存：按 changeCount 失效，避免重复读取与 PNG 转换
+static ztools::ClipboardSnapshotCache g_clipboardCache;
 
 // 在主线程调用 JS 回调
 void CallJs(napi_env env, napi_value js_callback, void *context, void *data) {
@@ -75,36 +103,17 @@ void CallJs(napi_env env, napi_value js_callback, void *context, void *data) {
   }
 }
 
-// Swift 回调 -> 推送到线程安全队列
+// 当前 NSPasteboard changeCount（定义在 Swift 库封装之后）
+static uint64_t PasteboardSequence();
+
+// Swift 回调 -> 交给检测核心 -> 推送到线程安全队列
 void OnClipboardChanged() {
-  if (tsfn != nullptr && !g_isPaused) {
-    // 不需要传递数据
-    napi_call_threadsafe_function(tsfn, nullptr, napi_tsfn_nonblocking);
-  }
+  // Swift 回调不携带 changeCount，在此读取当前值用于去重与自身写入抑制（Swift 库未提供时为 0）
+  g_clipboardDetector.Report(ztools::ClipboardSource::Clipboard, PasteboardSequence());
 }
 
-// 辅助函数：从JSON字符串中解析数字值
-int parseJsonNumber(const std::string &jsonString, const std::string &key) {
-  std::string searchKey = "\"" + key + "\":";
-  size_t pos = jsonString.find(searchKey);
-  if (pos != std::string::npos) {
-    size_t start = pos + searchKey.length();
-    size_t end = start;
-    // 查找数字的结束位置（遇到逗号、大括号或引号）
-    while (end < jsonString.length() && jsonString[end] != ',' &&
-           jsonString[end] != '}' && jsonString[end] != '"') {
-      end++;
-    }
-    if (end > start) {
-      try {
-        return std::stoi(jsonString.substr(start, end - start));
-      } catch (...) {
-        return 0;
-      }
-    }
-  }
-  return 0;
-}
+// 剪贴板历史写入（定义在剪贴板读取函数之后）
+static void AddPasteboardToHistory();
 
 Napi::Value ParseJsonValue(Napi::Env env, const std::string &jsonString) {
   Napi::Object json = env.Global().Get("JSON").As<Napi::Object>();
@@ -112,30 +121,74 @@ Napi::Value ParseJsonValue(Napi::Env env, const std::string &jsonString) {
   return parse.Call(json, {Napi::String::New(env, jsonString)});
 }
 
-// 在主线程调用 JS 回调（窗口监控，带JSON参数）
+// 按事件记录的字段表直接创建 JS 对象属性（不经过 JSON 文本）
+class NapiEventObjectBuilder : public ztools::NativeEventFieldVisitor {
+public:
+  explicit NapiEventObjectBuilder(Napi::Env env)
+      : env_(env), object_(Napi::Object::New(env)) {}
+
+  void String(const char *name, const char *data, size_t size) override {
+    object_.Set(name, Napi::String::New(env_, data, size));
+  }
+  void Number(const char *name, double value) override {
+    object_.Set(name, Napi::Number::New(env_, value));
+  }
+  void Boolean(const char *name, bool value) override {
+    object_.Set(name, Napi::Boolean::New(env_, value));
+  }
+  void Null(const char *name) override { object_.Set(name, env_.Null()); }
+
+  Napi::Object Object() const { return object_; }
+
+private:
+  Napi::Env env_;
+  Napi::Object object_;
+};
+
+// 解码事件记录为 JS 对象；记录损坏时返回 false
+bool BuildEventObject(Napi::Env env, const std::string &event,
+                      Napi::Object &object) {
+  NapiEventObjectBuilder builder(env);
+  if (!ztools::VisitNativeEvent(event.data(), event.size(), builder)) {
+    return false;
+  }
+  object = builder.Object();
+  return true;
+}
+
+// Swift 事件回调 -> 复制记录并推送到线程安全队列（回调返回后 Swift 侧缓冲区即失效）
+void QueueNativeEvent(napi_threadsafe_function target, const void *data,
+                      size_t size) {
+  if (target != nullptr && data != nullptr) {
+    auto *event = new std::string(static_cast<const char *>(data), size);
+    if (napi_call_threadsafe_function(target, event, napi_tsfn_nonblocking) !=
+        napi_ok) {
+      delete event;
+    }
+  }
+}
+
+// 在主线程调用 JS 回调（窗口监控）
 void CallWindowJs(napi_env env, napi_value js_callback, void *context,
                   void *data) {
-  if (env != nullptr && js_callback != nullptr && data != nullptr) {
-    char *jsonStr = static_cast<char *>(data);
+  std::unique_ptr<std::string> event(static_cast<std::string *>(data));
+  if (env != nullptr && js_callback != nullptr && event) {
     Napi::Env napiEnv(env);
-    std::string jsonString(jsonStr);
-    free(jsonStr);
+    Napi::Object windowInfo;
+    if (!BuildEventObject(napiEnv, *event, windowInfo)) {
+      return;
+    }
 
     napi_value global;
     napi_get_global(env, &global);
-    Napi::Value parsed = ParseJsonValue(napiEnv, jsonString);
-    napi_value resultValue = parsed;
+    napi_value resultValue = windowInfo;
     napi_call_function(env, global, js_callback, 1, &resultValue, nullptr);
   }
 }
 
 // Swift 窗口回调 -> 推送到线程安全队列
-void OnWindowChanged(const char *jsonStr) {
-  if (windowTsfn != nullptr && jsonStr != nullptr) {
-    // 复制字符串
-    char *jsonCopy = strdup(jsonStr);
-    napi_call_threadsafe_function(windowTsfn, jsonCopy, napi_tsfn_nonblocking);
-  }
+void OnWindowChanged(const void *data, size_t size) {
+  QueueNativeEvent(windowTsfn, data, size);
 }
 
 // 获取当前 .node 文件所在目录
@@ -203,6 +256,8 @@ bool LoadSwiftLibrary(Napi::Env env) {
       (StartWindowMonitorFunc)dlsym(swiftLibHandle, "startWindowMonitor");
   stopWindowMonitorFunc =
       (StopWindowMonitorFunc)dlsym(swiftLibHandle, "stopWindowMonitor");
+  nativeEventAbiVersionFunc =
+      (NativeEventAbiVersionFunc)dlsym(swiftLibHandle, "nativeEventAbiVersion");
   getActiveWindowFunc =
       (GetActiveWindowFunc)dlsym(swiftLibHandle, "getActiveWindow");
   activateWindowFunc =
@@ -237,6 +292,20 @@ bool LoadSwiftLibrary(Napi::Env env) {
       (GetAllFinderWindowsFunc)dlsym(swiftLibHandle, "getAllFinderWindows");
   setAddressBarFunc =
       (SetAddressBarFunc)dlsym(swiftLibHandle, "setAddressBar");
+  getClipboardChangeCountFunc =
+      (GetClipboardChangeCountFunc)dlsym(swiftLibHandle, "getClipboardChangeCount");
+  pasteboardReadTextFunc =
+      (PasteboardReadFunc)dlsym(swiftLibHandle, "pasteboardReadText");
+  pasteboardReadFilesFunc =
+      (PasteboardReadFunc)dlsym(swiftLibHandle, "pasteboardReadFiles");
+  pasteboardReadImagePngFunc =
+      (PasteboardReadFunc)dlsym(swiftLibHandle, "pasteboardReadImagePNG");
+  pasteboardSaveFunc = (PasteboardReadFunc)dlsym(swiftLibHandle, "pasteboardSave");
+  pasteboardReadTypeFunc =
+      (PasteboardReadTypeFunc)dlsym(swiftLibHandle, "pasteboardReadType");
+  pasteboardRestoreFunc =
+      (PasteboardRestoreFunc)dlsym(swiftLibHandle, "pasteboardRestore");
+  pasteboardClearFunc = (PasteboardClearFunc)dlsym(swiftLibHandle, "pasteboardClear");
 
   if (!startMonitorFunc || !stopMonitorFunc || !startWindowMonitorFunc ||
       !stopWindowMonitorFunc || !getActiveWindowFunc || !activateWindowFunc ||
@@ -245,7 +314,12 @@ bool LoadSwiftLibrary(Napi::Env env) {
       !simulateMouseDoubleClickFunc || !simulateMouseRightClickFunc ||
       !startMouseMonitorFunc || !stopMouseMonitorFunc ||
       !startColorPickerFunc || !stopColorPickerFunc ||
-      !setClipboardFilesFunc || !fetchFileIconFunc) {
+      !setClipboardFilesFunc || !fetchFileIconFunc ||
+      !pasteboardReadTextFunc || !pasteboardReadFilesFunc ||
+      !pasteboardReadImagePngFunc || !pasteboardSaveFunc || !pasteboardReadTypeFunc ||
+      !pasteboardRestoreFunc || !pasteboardClearFunc ||
+      !nativeEventAbiVersionFunc ||
+      nativeEventAbiVersionFunc() != ztools::kNativeEventVersion) {
     Napi::Error::New(env, "Failed to load Swift functions")
         .ThrowAsJavaScriptException();
     dlclose(swiftLibHandle);
@@ -285,6 +359,18 @@ Napi::Value StartMonitor(const Napi::CallbackInfo &info) {
   napi_create_threadsafe_function(env, callback, nullptr, resource_name, 0, 1,
                                   nullptr, nullptr, nullptr, CallJs, &tsfn);
 
+  g_clipboardDetector.Reset();
+  g_clipboardDetector.SetSink([](const ztools::ClipboardChange &) {
+    // 先写入历史（在 Swift 监控队列上执行），JS 收到通知时即可分页读取
+    if (g_clipboardHistoryEnabled) {
+      AddPasteboardToHistory();
+    }
+    if (tsfn != nullptr) {
+      // 不需要传递数据
+      napi_call_threadsafe_function(tsfn, nullptr, napi_tsfn_nonblocking);
+    }
+  });
+
   // 启动 Swift 监控
   startMonitorFunc(OnClipboardChanged);
 
@@ -304,7 +390,8 @@ Napi::Value StopMonitor(const Napi::CallbackInfo &info) {
     tsfn = nullptr;
   }
 
-  g_isPaused = false; // 重置暂停状态
+  g_clipboardDetector.SetSink(nullptr);
+  g_clipboardDetector.SetPaused(false); // 重置暂停状态
 
   return env.Undefined();
 }
@@ -312,267 +399,445 @@ Napi::Value StopMonitor(const Napi::CallbackInfo &info) {
 // 暂停剪贴板监控
 Napi::Value PauseMonitor(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
-  g_isPaused = true;
+  g_clipboardDetector.SetPaused(true);
   return env.Undefined();
 }
 
 // 恢复剪贴板监控
 Napi::Value ResumeMonitor(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
-  g_isPaused = false;
+  g_clipboardDetector.SetPaused(false);
   return env.Undefined();
 }
 
 // ==================== 获取选中内容（Mac 实现）====================
 
-// 注意：以下函数使用 popen 调用外部命令（pbpaste, osascript）来操作剪贴板
-//
-// 性能考虑：
-// - 这些是低频操作（用户主动触发 getSelectedContent 时才调用）
-// - 相比高频的剪贴板监控（已由 Swift 库处理），性能影响可接受
-//
-// 未来优化方向：
-// - 将此文件重命名为 .mm 并使用 Objective-C++ 直接调用 NSPasteboard API
-// - 或在 Swift 库中实现这些功能并通过 FFI 调用
-//
-// 当前实现的优点：
-// - 简单可维护，无需额外的 Objective-C++ 编译配置
-// - 与 Swift 库保持清晰的职责分离
-
-// 获取剪贴板文本内容
-std::string GetPasteboardText() {
-  FILE* pipe = popen("pbpaste", "r");
-  if (!pipe) return "";
+// 剪贴板读写全部通过 Swift 库在进程内访问 NSPasteboard，不再启动 pbpaste/osascript/pbcopy 子进程
 
-  std::string result;
-  char buffer[256];
-  while (fgets(buffer, sizeof(buffer), pipe)) {
-    result += buffer;
+// Swift 库导出函数的 Pasteboard 接口封装（调用前需已加载 Swift 库）
+class SwiftPasteboard : public ztools::Pasteboard {
+public:
+  uint64_t ChangeCount() override {
+    if (getClipboardChangeCountFunc == nullptr) {
+      return 0;
+    }
+    // changeCount 可能为 0 或负数，偏移后保证非 0
+    return static_cast<uint64_t>(getClipboardChangeCountFunc()) + (1ull << 32);
   }
-  pclose(pipe);
-  return result;
-}
 
-// 获取剪贴板文件列表
-std::vector<std::string> GetPasteboardFiles() {
-  std::vector<std::string> result;
-
-  // 先检查剪贴板是否真的包含文件 URL 类型，避免普通文本被 AppleScript 强制转成伪路径。
-  FILE* infoPipe = popen("osascript -e 'clipboard info'", "r");
-  if (!infoPipe) return result;
-
-  bool hasFileUrl = false;
-  char infoBuffer[1024];
-  while (fgets(infoBuffer, sizeof(infoBuffer), infoPipe)) {
-    std::string line = infoBuffer;
-    if (line.find("«class furl»") != std::string::npos) {
-      hasFileUrl = true;
-      break;
-    }
+  bool ReadText(std::string &text) override {
+    return Read(pasteboardReadTextFunc, text);
   }
-  pclose(infoPipe);
 
-  if (!hasFileUrl) {
-    return result;
+  bool ReadFiles(std::vector<std::string> &paths) override {
+    std::string joined;
+    if (!Read(pasteboardReadFilesFunc, joined)) {
+      return false;
+    }
+    // 每个路径以 \0 结尾
+    paths.clear();
+    size_t start = 0;
+    while (start < joined.size()) {
+      size_t end = joined.find('\0', start);
+      if (end == std::string::npos) {
+        end = joined.size();
+      }
+      if (end > start) {
+        paths.push_back(joined.substr(start, end - start));
+      }
+      start = end + 1;
+    }
+    return true;
   }
 
-  // 使用 osascript 获取文件列表
-  FILE* pipe = popen("osascript -e 'try' -e 'set theList to (the clipboard as «class furl») as list' -e 'set output to \"\"' -e 'repeat with aFile in theList' -e 'set output to output & POSIX path of aFile & linefeed' -e 'end repeat' -e 'return output' -e 'end try'", "r");
-  if (!pipe) return result;
+  bool ReadImagePng(std::string &png) override {
+    return Read(pasteboardReadImagePngFunc, png);
+  }
 
-  char buffer[1024];
-  while (fgets(buffer, sizeof(buffer), pipe)) {
-    std::string line = buffer;
-    // 移除换行符
-    if (!line.empty() && line[line.length() - 1] == '\n') {
-      line.erase(line.length() - 1);
+  // 按 UTI 读取第一个 item 的原始数据（如 public.html / public.rtf）
+  bool ReadType(const char *type, std::string &data) {
+    data.clear();
+    if (pasteboardReadTypeFunc == nullptr) {
+      return false;
     }
-    if (!line.empty()) {
-      result.push_back(line);
+    size_t length = 0;
+    void *buffer = pasteboardReadTypeFunc(type, &length);
+    if (buffer != nullptr) {
+      data.assign(static_cast<const char *>(buffer), length);
+      free(buffer);
     }
+    return true;
   }
-  pclose(pipe);
-  return result;
-}
 
-// 获取剪贴板图像（base64 PNG）
-std::string GetPasteboardImage() {
-  // 使用临时文件保存图像
-  std::string tmpFile = "/tmp/ztools_clipboard_image.png";
-
-  // 使用 osascript 保存剪贴板图像为 PNG
-  std::string cmd = "osascript -e 'try' -e 'set imgData to the clipboard as «class PNGf»' -e 'set outFile to open for access POSIX file \"" + tmpFile + "\" with write permission' -e 'set eof outFile to 0' -e 'write imgData to outFile' -e 'close access outFile' -e 'end try'";
-  int ret = system(cmd.c_str());
-
-  if (ret != 0) return "";
-
-  // 读取文件并转换为 base64
-  FILE* file = fopen(tmpFile.c_str(), "rb");
-  if (!file) return "";
-
-  fseek(file, 0, SEEK_END);
-  long size = ftell(file);
-  fseek(file, 0, SEEK_SET);
-
-  if (size <= 0) {
-    fclose(file);
-    unlink(tmpFile.c_str());
-    return "";
-  }
-
-  std::vector<unsigned char> buffer(size);
-  fread(buffer.data(), 1, size, file);
-  fclose(file);
-  unlink(tmpFile.c_str());
-
-  // Base64 编码
-  const char* base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  std::string result;
-  int idx = 0;
-  unsigned char char_array_3[3];
-  unsigned char char_array_4[4];
-
-  for (unsigned char c : buffer) {
-    char_array_3[idx++] = c;
-    if (idx == 3) {
-      char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-      char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-      char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-      char_array_4[3] = char_array_3[2] & 0x3f;
-
-      for (int k = 0; k < 4; k++) {
-        result += base64_chars[char_array_4[k]];
-      }
-      idx = 0;
+  bool Save(ztools::PasteboardSnapshot &snapshot) override {
+    std::string encoded;
+    if (!Read(pasteboardSaveFunc, encoded)) {
+      return false;
     }
+    return ztools::DecodePasteboardSnapshot(encoded.data(), encoded.size(), snapshot);
   }
 
-  if (idx) {
-    for (int j = idx; j < 3; j++) {
-      char_array_3[j] = '\0';
+  bool Restore(const ztools::PasteboardSnapshot &snapshot) override {
+    if (pasteboardRestoreFunc == nullptr) {
+      return false;
     }
+    std::string encoded = ztools::EncodePasteboardSnapshot(snapshot);
+    return pasteboardRestoreFunc(encoded.data(), encoded.size()) == 1;
+  }
 
-    char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
-    char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
-    char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
-
-    for (int j = 0; j < idx + 1; j++) {
-      result += base64_chars[char_array_4[j]];
+  bool Clear() override {
+    if (pasteboardClearFunc == nullptr) {
+      return false;
     }
+    pasteboardClearFunc();
+    return true;
+  }
 
-    while (idx++ < 3) {
-      result += '=';
+private:
+  // 调用返回 malloc 缓冲区的导出函数；返回 nullptr 表示没有对应内容
+  static bool Read(PasteboardReadFunc func, std::string &result) {
+    result.clear();
+    if (func == nullptr) {
+      return false;
+    }
+    size_t length = 0;
+    void *data = func(&length);
+    if (data != nullptr) {
+      result.assign(static_cast<const char *>(data), length);
+      free(data);
     }
+    return true;
   }
+};
 
-  return result;
+static SwiftPasteboard g_pasteboard;
+
+// 当前 NSPasteboard changeCount（Swift 库未提供时为 0，缓存将被绕过）
+static uint64_t PasteboardSequence() {
+  return g_pasteboard.ChangeCount();
 }
 
-// 获取选中内容（Mac 实现 - 使用模拟复制）
-Napi::Value GetSelectedContent(const Napi::CallbackInfo &info) {
-  Napi::Env env = info.Env();
-  Napi::Array result = Napi::Array::New(env);
+// 获取剪贴板文本内容（实际读取）
+static bool ReadPasteboardText(std::string &result) {
+  return g_pasteboard.ReadText(result);
+}
 
-  if (!LoadSwiftLibrary(env)) {
-    return result;
+// 获取剪贴板文本内容（按 changeCount 缓存）
+std::string GetPasteboardText() {
+  auto text = g_clipboardCache.Read<std::string>(
+      ztools::ClipboardSlot::Text, PasteboardSequence, ReadPasteboardText);
+  return text ? *text : std::string();
+}
+
+// 把当前剪贴板文本写入历史（文件/图片只在 JS 请求时读取，不在每次变化时读取）
+// 读取结果同时进入快照缓存，JS 随后调用 getClipboardText 时直接命中
+static void AddPasteboardToHistory() {
+  std::string text = GetPasteboardText();
+  if (text.empty()) {
+    return;
+  }
+  std::vector<ztools::ClipboardHistoryFormat> formats;
+  formats.push_back(ztools::ClipboardHistoryFormat{"text", std::move(text)});
+  uint64_t sequence = PasteboardSequence();
+  AddClipboardHistoryEntry(std::move(formats), sequence);
+}
+
+// 获取剪贴板文件列表（实际读取，只接受文件 URL，普通文本不会被当作路径）
+static bool ReadPasteboardFiles(std::vector<std::string> &result) {
+  return g_pasteboard.ReadFiles(result);
+}
+
+// 获取剪贴板文件列表（按 changeCount 缓存）
+std::vector<std::string> GetPasteboardFiles() {
+  auto files = g_clipboardCache.Read<std::vector<std::string>>(
+      ztools::ClipboardSlot::FilesList, PasteboardSequence, ReadPasteboardFiles);
+  return files ? *files : std::vector<std::string>();
+}
+
+// 获取剪贴板图像（实际读取，base64 PNG）
+static bool ReadPasteboardImage(std::string &result) {
+  std::string png;
+  if (!g_pasteboard.ReadImagePng(png)) {
+    return false;
+  }
+  result = ztools::Base64Encode(png.data(), png.size());
+  return true;
+}
+
+// 获取剪贴板图像（按 changeCount 缓存，base64 PNG）
+std::string GetPasteboardImage() {
+  auto image = g_clipboardCache.Read<std::string>(
+      ztools::ClipboardSlot::Image, PasteboardSequence, ReadPasteboardImage);
+  return image ? *image : std::string();
+}
+
+// readClipboard：NSPasteboard 没有独占锁，这里把一次读取的全部 Swift 调用计为"持有"时长；
+// 读取期间 changeCount 变化时重读一次，保证各格式来自同一次剪贴板内容
+static void ReadClipboardFormats(uint32_t mask, ztools::ClipboardReadResult &result) {
+  if (swiftLibHandle == nullptr) {
+    return;
+  }
+  std::string png;
+  for (int attempt = 0; attempt < 2; attempt++) {
+    ztools::ClipboardReadResult current;
+    current.mask = result.mask;
+    current.output = result.output;
+    current.opened = true;
+    ztools::ClipboardLockTimer lockTimer(g_clipboardLockStats);
+    current.sequence = PasteboardSequence();
+
+    if ((mask & ztools::kClipboardReadText) != 0 && g_pasteboard.ReadText(current.text)) {
+      current.hasText = !current.text.empty();
+    }
+    if ((mask & ztools::kClipboardReadHtml) != 0 && g_pasteboard.ReadType("public.html", current.html)) {
+      current.hasHtml = !current.html.empty();
+    }
+    if ((mask & ztools::kClipboardReadRtf) != 0 && g_pasteboard.ReadType("public.rtf", current.rtf)) {
+      current.hasRtf = !current.rtf.empty();
+    }
+    if ((mask & ztools::kClipboardReadFiles) != 0 && g_pasteboard.ReadFiles(current.files)) {
+      current.hasFiles = !current.files.empty();
+    }
+    png.clear();
+    if ((mask & ztools::kClipboardReadImage) != 0) {
+      g_pasteboard.ReadImagePng(png);
+    }
+    bool stable = PasteboardSequence() == current.sequence;
+    current.lockHeldUs = lockTimer.Stop();
+
+    result = std::move(current);
+    if (stable) {
+      break;
+    }
+  }
+
+  // 编码转换不计入持有时长
+  if (result.hasText && (result.output & ztools::kClipboardOutputUtf16) != 0) {
+    result.text = ztools::Utf8ToUtf16Le(result.text);
   }
+  if (!png.empty()) {
+    if ((result.output & ztools::kClipboardOutputBinary) != 0) {
+      result.image = std::move(png);
+    } else {
+      result.image = ztools::Base64Encode(png.data(), png.size());
+    }
+    result.hasImage = true;
+  }
+}
 
-  // 暂停监控以防止触发自身事件
-  bool wasMonitoring = (tsfn != nullptr && !g_isPaused);
-  if (wasMonitoring) {
-    g_isPaused = true;
+// writeClipboard：全部格式编码为一个快照，经 pasteboardRestore 一次 clearContents + writeObjects 写入
+static bool WriteClipboardRequest(const ztools::ClipboardWriteRequest &request, std::string &error) {
+  if (swiftLibHandle == nullptr) {
+    error = "Swift library not loaded";
+    return false;
   }
+  ztools::PasteboardSnapshot snapshot;
+  if (!ztools::BuildPasteboardWriteSnapshot(request, snapshot, &error)) {
+    return false;
+  }
+  ztools::ClipboardLockTimer lockTimer(g_clipboardLockStats);
+  if (!g_pasteboard.Restore(snapshot)) {
+    error = "Failed to write pasteboard";
+    return false;
+  }
+  return true;
+}
 
-  // 保存原剪贴板内容
-  std::string originalText = GetPasteboardText();
-  std::vector<std::string> originalFiles = GetPasteboardFiles();
-  std::string originalImage = GetPasteboardImage();
+// 选中内容（只含原始数据，可在工作线程中生成，再在主线程转换为 JS 数组）
+struct SelectedContent {
+  bool hasText = false;
+  std::string text;
+  bool hasFiles = false;
+  std::vector<std::string> files;
+  bool hasImage = false;
+  std::string image;  // base64 PNG
+};
+
+// 同一时间只允许一次模拟复制（同步与异步版本共用），避免相互覆盖剪贴板
+static std::mutex g_selectedContentMutex;
+
+// 获取选中内容：保存剪贴板 → 模拟 Cmd+C → 等待 changeCount 变化 → 读取 → 恢复
+// 不涉及 N-API，可在工作线程中执行（调用前需已加载 Swift 库）
+static void CaptureSelectedContent(const ztools::SequenceWaitOptions &waitOptions,
+                                   SelectedContent &content) {
+  std::lock_guard<std::mutex> lock(g_selectedContentMutex);
+
+  // 登记自身写入：清空、模拟复制与恢复产生的 changeCount 不会通知 JS，
+  // 恢复完成后用户的下一次复制照常通知（不再暂停监控并延迟恢复）
+  ztools::ClipboardSelfWriteScope selfWrite(g_clipboardDetector, ztools::ClipboardSource::Clipboard,
+                                            PasteboardSequence);
+
+  // 保存原剪贴板全部 item 的全部类型（原始字节，不解码）；保存失败时不模拟复制，否则无法恢复
+  ztools::PasteboardSnapshot original;
+  if (!g_pasteboard.Save(original)) {
+    return;
+  }
 
   // 清空剪贴板
-  system("pbcopy < /dev/null");
+  g_pasteboard.Clear();
 
   // 模拟 Cmd+C（使用 simulateKeyboardTap）
   if (simulateKeyboardTapFunc != nullptr) {
+    uint64_t baseline = PasteboardSequence();
     simulateKeyboardTapFunc("c", "meta");
 
-    // 等待剪贴板更新
-    usleep(100000); // 100ms
-
-    // 读取新的剪贴板内容
-    std::string newText = GetPasteboardText();
-    std::vector<std::string> newFiles = GetPasteboardFiles();
-    std::string newImage = GetPasteboardImage();
-
-    uint32_t index = 0;
-
-    // 检查文本
-    if (!newText.empty() && newText != originalText) {
-      Napi::Object item = Napi::Object::New(env);
-      item.Set("type", "text");
-      item.Set("data", newText);
-      result.Set(index++, item);
+    // 等待剪贴板更新：有 changeCount 时等待其变化，否则退回固定等待
+    bool changed = true;
+    if (getClipboardChangeCountFunc != nullptr) {
+      ztools::SequenceWaiter waiter(PasteboardSequence);
+      changed = waiter.Wait(baseline, waitOptions).changed;
+    } else {
+      usleep(100000); // 100ms
     }
 
-    // 检查文件
-    if (!newFiles.empty()) {
-      bool isDifferent = (newFiles.size() != originalFiles.size());
-      if (!isDifferent) {
-        for (size_t i = 0; i < newFiles.size(); i++) {
-          if (newFiles[i] != originalFiles[i]) {
-            isDifferent = true;
-            break;
-          }
+    // 先按类型比较原始字节，只解码与原剪贴板不同的内容
+    ztools::PasteboardSnapshot copied;
+    if (changed && g_pasteboard.Save(copied)) {
+      if (!ztools::SamePasteboardType(original, copied, "public.utf8-plain-text")) {
+        std::string text;
+        if (g_pasteboard.ReadText(text) && !text.empty()) {
+          content.hasText = true;
+          content.text = std::move(text);
         }
       }
 
-      if (isDifferent) {
-        Napi::Object item = Napi::Object::New(env);
-        item.Set("type", "file");
-        Napi::Array fileArray = Napi::Array::New(env);
-        for (size_t i = 0; i < newFiles.size(); i++) {
-          fileArray.Set(uint32_t(i), newFiles[i]);
+      if (!ztools::SamePasteboardType(original, copied, "public.file-url")) {
+        std::vector<std::string> files;
+        if (g_pasteboard.ReadFiles(files) && !files.empty()) {
+          content.hasFiles = true;
+          content.files = std::move(files);
         }
-        item.Set("data", fileArray);
-        result.Set(index++, item);
       }
-    }
 
-    // 检查图像
-    if (!newImage.empty() && newImage != originalImage) {
-      Napi::Object item = Napi::Object::New(env);
-      item.Set("type", "image");
-      item.Set("data", newImage);
-      item.Set("format", "png");
-      item.Set("encoding", "base64");
-      result.Set(index++, item);
+      if (!ztools::SamePasteboardType(original, copied, "public.png") ||
+          !ztools::SamePasteboardType(original, copied, "public.tiff")) {
+        std::string png;
+        if (g_pasteboard.ReadImagePng(png) && !png.empty()) {
+          content.hasImage = true;
+          content.image = ztools::Base64Encode(png.data(), png.size());
+        }
+      }
     }
   }
 
-  // 恢复原剪贴板内容
-  if (!originalText.empty()) {
-    // 转义单引号
-    std::string escapedText = originalText;
-    size_t pos = 0;
-    while ((pos = escapedText.find("'", pos)) != std::string::npos) {
-      escapedText.replace(pos, 1, "'\\''");
-      pos += 4;
-    }
-    std::string cmd = "printf '%s' '" + escapedText + "' | pbcopy";
-    system(cmd.c_str());
-  } else if (!originalFiles.empty()) {
-    // 恢复文件列表比较复杂，这里简化处理
-    // 实际应用中可能需要更完善的实现
+  // 恢复原剪贴板内容（全部 item 与类型原样写回，包括文件列表、图像与 RTF 等）
+  g_pasteboard.Restore(original);
+}
+
+static Napi::Array CreateSelectedContentArray(Napi::Env env, const SelectedContent &content) {
+  Napi::Array result = Napi::Array::New(env);
+  uint32_t index = 0;
+
+  if (content.hasText) {
+    Napi::Object item = Napi::Object::New(env);
+    item.Set("type", "text");
+    item.Set("data", content.text);
+    result.Set(index++, item);
   }
 
-  // 恢复监控状态
-  if (wasMonitoring) {
-    usleep(50000); // 50ms 延迟
-    g_isPaused = false;
+  if (content.hasFiles) {
+    Napi::Object item = Napi::Object::New(env);
+    item.Set("type", "file");
+    Napi::Array fileArray = Napi::Array::New(env);
+    for (size_t i = 0; i < content.files.size(); i++) {
+      fileArray.Set(uint32_t(i), content.files[i]);
+    }
+    item.Set("data", fileArray);
+    result.Set(index++, item);
   }
 
+  if (content.hasImage) {
+    Napi::Object item = Napi::Object::New(env);
+    item.Set("type", "image");
+    item.Set("data", content.image);
+    item.Set("format", "png");
+    item.Set("encoding", "base64");
+    result.Set(index++, item);
+  }
   return result;
 }
 
+// 解析 { timeoutMs?: number, settleMs?: number }
+static bool ParseSelectedContentOptions(const Napi::CallbackInfo &info,
+                                        ztools::SequenceWaitOptions &options) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || info[0].IsUndefined() || info[0].IsNull()) {
+    return true;
+  }
+  if (!info[0].IsObject()) {
+    Napi::TypeError::New(env, "Expected an options object").ThrowAsJavaScriptException();
+    return false;
+  }
+  Napi::Object obj = info[0].As<Napi::Object>();
+  if (obj.Has("timeoutMs") && obj.Get("timeoutMs").IsNumber()) {
+    double timeoutMs = obj.Get("timeoutMs").As<Napi::Number>().DoubleValue();
+    options.timeoutUs = timeoutMs > 0 ? static_cast<uint64_t>(timeoutMs * 1000) : 0;
+  }
+  if (obj.Has("settleMs") && obj.Get("settleMs").IsNumber()) {
+    double settleMs = obj.Get("settleMs").As<Napi::Number>().DoubleValue();
+    options.settleUs = settleMs > 0 ? static_cast<uint64_t>(settleMs * 1000) : 0;
+  }
+  return true;
+}
+
+// 获取选中内容（Mac 实现 - 使用模拟复制，同步）
+// 参数：{ timeoutMs?: number, settleMs?: number }（可选）
+Napi::Value GetSelectedContent(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!LoadSwiftLibrary(env)) {
+    return Napi::Array::New(env);
+  }
+
+  ztools::SequenceWaitOptions options;
+  if (!ParseSelectedContentOptions(info, options)) {
+    return env.Undefined();
+  }
+  SelectedContent content;
+  CaptureSelectedContent(options, content);
+  return CreateSelectedContentArray(env, content);
+}
+
+class SelectedContentWorker : public Napi::AsyncWorker {
+public:
+  SelectedContentWorker(const ztools::SequenceWaitOptions &options, Napi::Env env,
+                        Napi::Promise::Deferred deferred)
+      : Napi::AsyncWorker(env), options_(options), deferred_(deferred) {}
+
+  void Execute() override { CaptureSelectedContent(options_, content_); }
+
+  void OnOK() override { deferred_.Resolve(CreateSelectedContentArray(Env(), content_)); }
+
+  void OnError(const Napi::Error &e) override { deferred_.Reject(e.Value()); }
+
+private:
+  ztools::SequenceWaitOptions options_;
+  SelectedContent content_;
+  Napi::Promise::Deferred deferred_;
+};
+
+// 获取选中内容（异步）：整个保存/复制/读取/恢复过程在工作线程执行
+// 参数：{ timeoutMs?: number, settleMs?: number }（可选）
+// 返回：Promise<Array>，结果与 getSelectedContent 相同
+Napi::Value GetSelectedContentAsync(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  // Swift 库必须在主线程加载
+  if (!LoadSwiftLibrary(env)) {
+    return env.Undefined();
+  }
+
+  ztools::SequenceWaitOptions options;
+  if (!ParseSelectedContentOptions(info, options)) {
+    return env.Undefined();
+  }
+
+  auto deferred = Napi::Promise::Deferred::New(env);
+  auto *worker = new SelectedContentWorker(options, env, deferred);
+  worker->Queue();
+  return deferred.Promise();
+}
+
 // 获取当前激活窗口
 Napi::Value GetActiveWindow(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
@@ -581,14 +846,21 @@ Napi::Value GetActiveWindow(const Napi::CallbackInfo &info) {
     return env.Null();
   }
 
-  char *jsonStr = getActiveWindowFunc();
-  if (jsonStr == nullptr) {
-    return env.Null();
+  size_t length = 0;
+  void *buffer = getActiveWindowFunc(&length);
+  if (buffer == nullptr) {
+    Napi::Object error = Napi::Object::New(env);
+    error.Set("error", Napi::String::New(env, "No frontmost application"));
+    return error;
   }
 
-  std::string jsonString(jsonStr);
-  free(jsonStr);
-  return ParseJsonValue(env, jsonString);
+  std::string event(static_cast<const char *>(buffer), length);
+  free(buffer);
+  Napi::Object windowInfo;
+  if (!BuildEventObject(env, event, windowInfo)) {
+    return env.Null();
+  }
+  return windowInfo;
 }
 
 // 激活指定窗口
@@ -838,12 +1110,13 @@ Napi::Value SimulateMouseRightClick(const Napi::CallbackInfo &info) {
 // 在主线程调用 JS 回调（鼠标事件）
 void CallMouseJs(napi_env env, napi_value js_callback, void *context,
                  void *data) {
-  if (env != nullptr && js_callback != nullptr && data != nullptr) {
-    char *eventType = static_cast<char *>(data);
+  std::unique_ptr<std::string> event(static_cast<std::string *>(data));
+  if (env != nullptr && js_callback != nullptr && event) {
     Napi::Env napiEnv(env);
-    Napi::Object callbackArg = Napi::Object::New(napiEnv);
-    callbackArg.Set("type", Napi::String::New(napiEnv, eventType));
-    free(eventType);
+    Napi::Object callbackArg;
+    if (!BuildEventObject(napiEnv, *event, callbackArg)) {
+      return;
+    }
 
     napi_value global;
     napi_get_global(env, &global);
@@ -879,11 +1152,8 @@ void CallMouseJs(napi_env env, napi_value js_callback, void *context,
 }
 
 // Swift 鼠标回调 -> 推送到线程安全队列
-void OnMouseEvent(const char *eventType) {
-  if (mouseTsfn != nullptr && eventType != nullptr) {
-    char *copy = strdup(eventType);
-    napi_call_threadsafe_function(mouseTsfn, copy, napi_tsfn_nonblocking);
-  }
+void OnMouseEvent(const void *data, size_t size) {
+  QueueNativeEvent(mouseTsfn, data, size);
 }
 
 // 启动鼠标监控
@@ -960,32 +1230,12 @@ Napi::Value StopMouseMonitor(const Napi::CallbackInfo &info) {
 // 在主线程调用 JS 回调（取色器结果）
 void CallColorPickerJs(napi_env env, napi_value js_callback, void *context,
                        void *data) {
-  if (env != nullptr && js_callback != nullptr && data != nullptr) {
-    char *jsonStr = static_cast<char *>(data);
+  std::unique_ptr<std::string> event(static_cast<std::string *>(data));
+  if (env != nullptr && js_callback != nullptr && event) {
     Napi::Env napiEnv(env);
-    Napi::Object result = Napi::Object::New(napiEnv);
-
-    std::string jsonString(jsonStr);
-    free(jsonStr);
-
-    // 解析 "success":true/false
-    if (jsonString.find("\"success\":true") != std::string::npos) {
-      result.Set("success", Napi::Boolean::New(napiEnv, true));
-    } else {
-      result.Set("success", Napi::Boolean::New(napiEnv, false));
-    }
-
-    // 解析 "hex":"#XXXXXX"
-    size_t hexPos = jsonString.find("\"hex\":\"");
-    if (hexPos != std::string::npos) {
-      size_t start = hexPos + 7;
-      size_t end = jsonString.find("\"", start);
-      if (end != std::string::npos) {
-        std::string hex = jsonString.substr(start, end - start);
-        result.Set("hex", Napi::String::New(napiEnv, hex));
-      }
-    } else {
-      result.Set("hex", napiEnv.Null());
+    Napi::Object result;
+    if (!BuildEventObject(napiEnv, *event, result)) {
+      return;
     }
 
     napi_value global;
@@ -996,12 +1246,8 @@ void CallColorPickerJs(napi_env env, napi_value js_callback, void *context,
 }
 
 // Swift 取色器回调 -> 推送到线程安全队列
-void OnColorPicked(const char *jsonStr) {
-  if (colorPickerTsfn != nullptr && jsonStr != nullptr) {
-    char *jsonCopy = strdup(jsonStr);
-    napi_call_threadsafe_function(colorPickerTsfn, jsonCopy,
-                                  napi_tsfn_nonblocking);
-  }
+void OnColorPicked(const void *data, size_t size) {
+  QueueNativeEvent(colorPickerTsfn, data, size);
 }
 
 // 启动取色器
@@ -1263,6 +1509,21 @@ Napi::Value SetAddressBar(const Napi::CallbackInfo &info) {
   return Napi::Boolean::New(env, success == 1);
 }
 
+// 获取剪贴板缓存统计
+Napi::Value GetClipboardCacheStats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  LoadSwiftLibrary(env);
+  ztools::ClipboardCacheStats stats = g_clipboardCache.Stats();
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+  result.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+  result.Set("bypassed", Napi::Number::New(env, static_cast<double>(stats.bypassed)));
+  result.Set("discarded", Napi::Number::New(env, static_cast<double>(stats.discarded)));
+  result.Set("sequence", Napi::Number::New(env, static_cast<double>(PasteboardSequence())));
+  return result;
+}
+
 // 模块初始化
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set("startMonitor", Napi::Function::New(env, StartMonitor));
@@ -1297,6 +1558,11 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
   exports.Set("getAllExplorerWindows", Napi::Function::New(env, GetAllExplorerWindows));
   exports.Set("setAddressBar", Napi::Function::New(env, SetAddressBar));
   exports.Set("getSelectedContent", Napi::Function::New(env, GetSelectedContent));
+  exports.Set("getSelectedContentAsync", Napi::Function::New(env, GetSelectedContentAsync));
+  exports.Set("getClipboardCacheStats", Napi::Function::New(env, GetClipboardCacheStats));
+  InitClipboardHistory(env, exports);
+  InitClipboardRead(env, exports);
+  InitClipboardWrite(env, exports);
   return exports;
 }
 
@@ -12,7 +12,9 @@
 #include <map>         // For key mapping
 #include <vector>      // For input events
 #include <memory>      // For std::unique_ptr, std::addressof
+#include <mutex>
 #include <cstddef>
+#include <cstring>
 #include <cwchar>
 #include <cwctype>
 #include <shellapi.h>  // For DragQueryFile, SHGetFileInfoW
@@ -39,6 +41,23 @@ namespace Gdiplus {
 #include <gdiplus.h>
 #pragma comment(lib, "gdiplus.lib")
 
+#include "common/appx_manifest.h"
+#include "common/base64.h"
+#include "common/clipboard_change_detector.h"
+#include "common/clipboard_change_payload.h"
+#include "common/clipboard_provider.h"
+#include "common/clipboard_snapshot.h"
+#include "common/clipboard_snapshot_cache.h"
+#include "common/event_coalescer.h"
+#include "common/keyword_matcher.h"
+#include "common/packed_file_list.h"
+#include "common/process_info_cache.h"
+#include "common/sequence_waiter.h"
+#include "common/utf_transcode.h"
+#include "clipboard_history_binding.h"
+#include "clipboard_read_binding.h"
+#include "clipboard_write_binding.h"
+
 // DROPFILES 已由 shlobj.h 提供，不再需要手动定义
 
 // 取消与自定义函数名冲突的Windows宏
@@ -50,13 +69,40 @@ namespace Gdiplus {
 static HWND g_hwnd = NULL;
 static std::thread g_messageThread;
 static std::atomic<bool> g_isMonitoring(false);
-static std::atomic<bool> g_isPaused(false);  // 新增：暂停状态
 static napi_threadsafe_function g_tsfn = nullptr;
+// 平台无关的变化检测核心：负责暂停状态与序列号去重
+static ztools::ClipboardChangeDetector g_clipboardDetector;
+
+// 剪贴板快照缓存：两次变化之间的重复读取直接从内存返回
+static ztools::ClipboardSnapshotCache g_clipboardCache;
 
-// 剪贴板防抖：Edge 等浏览器复制时会分多次写入不同格式，
-// 每次写入都触发 WM_CLIPBOARDUPDATE，使用定时器合并为一次回调
-#define CLIPBOARD_DEBOUNCE_TIMER_ID 1
-#define CLIPBOARD_DEBOUNCE_MS 100
+// 当前剪贴板序列号（无剪贴板访问权限时为 0，缓存将被绕过）
+static uint64_t ClipboardSequence() {
+    return GetClipboardSequenceNumber();
+}
+
+// 剪贴板变化合并：Edge 等浏览器复制时会分多次写入不同格式，
+// 每次写入都触发 WM_CLIPBOARDUPDATE。默认在静默期结束后合并为一次通知（可选 leading 首个变化立即通知），
+// 定时器按合并器的截止时间设置
+#define CLIPBOARD_COALESCE_TIMER_ID 1
+static ztools::EventCoalescer g_clipboardCoalescer;
+// 是否按格式集合分组合并（不同类型内容的连续复制不会被合并为一次）
+static std::atomic<bool> g_clipboardGroupByFormats(false);
+
+// 变化负载（startMonitor 的 payload 选项启用）：在监控线程内一次性读取格式/所有者/预览
+static std::atomic<bool> g_clipboardPayloadEnabled(false);
+static std::atomic<size_t> g_clipboardPreviewBytes(ztools::kDefaultClipboardPreviewBytes);
+// 文本分类（classify 选项）：锁内只复制 CF_UNICODETEXT，关闭剪贴板后转码并分类
+static std::atomic<bool> g_clipboardClassifyEnabled(false);
+// 延迟渲染所有者窗口（截图发布到剪贴板时创建，见“延迟渲染剪贴板”）
+static std::atomic<HWND> g_renderOwnerHwnd(NULL);
+
+// 剪贴板内容是否由本进程以延迟渲染方式发布（调用方已打开剪贴板）：
+// 此时格式尚未渲染，监控线程读取会立即触发渲染，使延迟渲染失去意义
+static bool ClipboardOwnedByDelayedRenderer() {
+    HWND owner = GetClipboardOwner();
+    return owner != NULL && owner == g_renderOwnerHwnd;
+}
 
 // 全局变量 - 窗口监控
 static HWINEVENTHOOK g_winEventHook = NULL;
@@ -99,39 +145,462 @@ static HHOOK g_colorPickerMouseHook = NULL;
 static HHOOK g_colorPickerKeyboardHook = NULL;
 static std::atomic<bool> g_colorPickerCallbackCalled(false);
 
+// 当前剪贴板格式集合的分组键（IsClipboardFormatAvailable 无需打开剪贴板）。
+// 同一次复制分多次写入时集合逐步扩大，由 ClipboardFormatKeyExtends 并入本轮开始时的分组
+static uint64_t ClipboardFormatGroupKey() {
+    static const UINT htmlFormat = RegisterClipboardFormatW(L"HTML Format");
+    static const UINT pngFormat = RegisterClipboardFormatW(L"PNG");
+    uint64_t key = 0;
+    if (IsClipboardFormatAvailable(CF_UNICODETEXT)) key |= 1 << 0;
+    if (IsClipboardFormatAvailable(CF_HDROP)) key |= 1 << 1;
+    if (IsClipboardFormatAvailable(CF_DIB)) key |= 1 << 2;
+    if (htmlFormat != 0 && IsClipboardFormatAvailable(htmlFormat)) key |= 1 << 3;
+    if (pngFormat != 0 && IsClipboardFormatAvailable(pngFormat)) key |= 1 << 4;
+    return key;
+}
+
+// 新的格式集合包含进行中分组的集合：视为同一次复制追加格式
+static bool ClipboardFormatKeyExtends(uint64_t burstKey, uint64_t key) {
+    return (key & burstKey) == burstKey;
+}
+
+// 按合并器最近的截止时间设置（或取消）定时器
+static void ScheduleClipboardCoalesceTimer(HWND hwnd) {
+    uint64_t waitUs = g_clipboardCoalescer.TimeUntilNextDeadline();
+    if (waitUs == ztools::EventCoalescer::kNoDeadline) {
+        KillTimer(hwnd, CLIPBOARD_COALESCE_TIMER_ID);
+        return;
+    }
+    UINT waitMs = static_cast<UINT>((std::min)((waitUs + 999) / 1000, static_cast<uint64_t>(USER_TIMER_MAXIMUM)));
+    SetTimer(hwnd, CLIPBOARD_COALESCE_TIMER_ID, (std::max)(waitMs, static_cast<UINT>(USER_TIMER_MINIMUM)), NULL);
+}
+
 // 窗口过程（处理剪贴板消息）
 LRESULT CALLBACK ClipboardWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
         case WM_CLIPBOARDUPDATE:
-            // 剪贴板变化，使用防抖：重置定时器，延迟触发回调
-            // 这样如果短时间内收到多次 WM_CLIPBOARDUPDATE（如 Edge 复制地址栏），
-            // 只会在最后一次变化后触发一次回调
-            SetTimer(hwnd, CLIPBOARD_DEBOUNCE_TIMER_ID, CLIPBOARD_DEBOUNCE_MS, NULL);
+            // 交给合并器：首个变化可能在此同步触发回调，其余等待定时器
+            g_clipboardCoalescer.Push(g_clipboardGroupByFormats ? ClipboardFormatGroupKey() : 0);
+            ScheduleClipboardCoalesceTimer(hwnd);
             return 0;
         case WM_TIMER:
-            if (wParam == CLIPBOARD_DEBOUNCE_TIMER_ID) {
-                KillTimer(hwnd, CLIPBOARD_DEBOUNCE_TIMER_ID);
-                // 仅在未暂停时触发回调
-                if (g_tsfn != nullptr && !g_isPaused) {
-                    napi_call_threadsafe_function(g_tsfn, nullptr, napi_tsfn_nonblocking);
-                }
+            if (wParam == CLIPBOARD_COALESCE_TIMER_ID) {
+                KillTimer(hwnd, CLIPBOARD_COALESCE_TIMER_ID);
+                g_clipboardCoalescer.Poll();
+                ScheduleClipboardCoalesceTimer(hwnd);
             }
             return 0;
         case WM_DESTROY:
-            KillTimer(hwnd, CLIPBOARD_DEBOUNCE_TIMER_ID);
+            KillTimer(hwnd, CLIPBOARD_COALESCE_TIMER_ID);
+            g_clipboardCoalescer.Clear();
             PostQuitMessage(0);
             return 0;
     }
     return DefWindowProc(hwnd, msg, wParam, lParam);
 }
 
-// 在主线程调用 JS 回调
+// 获取剪贴板格式名称（标准格式使用 CF_* 名称，注册格式查询系统名称）
+static std::string GetClipboardFormatDisplayName(UINT format) {
+    const char* standard = ztools::StandardClipboardFormatName(format);
+    if (standard != nullptr) {
+        return standard;
+    }
+    WCHAR nameBuf[256] = {0};
+    int len = GetClipboardFormatNameW(format, nameBuf, 256);
+    if (len <= 0) {
+        return "";
+    }
+    return ztools::WideToUtf8(nameBuf, len);
+}
+
+// 是否查询该格式的数据大小
+// GetClipboardData 会迫使系统合成格式（CF_TEXT/CF_DIB/CF_DIBV5 等），或让使用延迟渲染的程序
+// （Office、浏览器的 HTML/RTF/PNG）立即生成数据，渲染期间剪贴板一直处于打开状态。
+// 因此只查询负载本来就要读取的格式：CF_HDROP（fileCount）与启用预览时的 CF_UNICODETEXT，
+// 其余格式报告 -1，由调用方按需读取
+static bool ShouldQueryClipboardFormatSize(UINT format, size_t previewBytes) {
+    return format == CF_HDROP || (format == CF_UNICODETEXT && previewBytes > 0);
+}
+
+// 进程元数据来源：条目持有 PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE 句柄，
+// 命中时只用 WaitForSingleObject(0) 确认进程未退出，不再打开进程、读取路径和转码
+class WindowsProcessSource : public ztools::ProcessInfoSource {
+public:
+    bool Open(uint32_t pid, uintptr_t* handle, uint64_t* startTime) override {
+        HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | SYNCHRONIZE, FALSE, pid);
+        if (!hProcess) {
+            return false;
+        }
+        FILETIME creation, exitTime, kernel, user;
+        if (!GetProcessTimes(hProcess, &creation, &exitTime, &kernel, &user)) {
+            CloseHandle(hProcess);
+            return false;
+        }
+        *startTime = (static_cast<uint64_t>(creation.dwHighDateTime) << 32) | creation.dwLowDateTime;
+        *handle = reinterpret_cast<uintptr_t>(hProcess);
+        return true;
+    }
+
+    bool IsAlive(uint32_t, uintptr_t handle, uint64_t) override {
+        // 句柄未关闭前系统不会复用该 pid，进程未退出即为同一进程
+        return WaitForSingleObject(reinterpret_cast<HANDLE>(handle), 0) == WAIT_TIMEOUT;
+    }
+
+    bool ExecutablePath(uint32_t, uintptr_t handle, std::string* path) override {
+        WCHAR buffer[MAX_PATH] = {0};
+        DWORD length = MAX_PATH;
+        if (!QueryFullProcessImageNameW(reinterpret_cast<HANDLE>(handle), 0, buffer, &length)) {
+            return false;
+        }
+        *path = ztools::WideToUtf8(std::wstring(buffer, length));
+        return true;
+    }
+
+    void Close(uintptr_t handle) override {
+        CloseHandle(reinterpret_cast<HANDLE>(handle));
+    }
+};
+
+// 窗口监控、getActiveWindow 与剪贴板来源共用的进程信息缓存（按 pid + 创建时间）
+static WindowsProcessSource g_processSource;
+static ztools::ProcessInfoCache g_processInfoCache(g_processSource);
+
+// 获取剪贴板所有者进程信息
+static void FillClipboardOwner(ztools::ClipboardChangePayload& payload) {
+    HWND owner = GetClipboardOwner();
+    if (owner == NULL) {
+        return;
+    }
+    DWORD processId = 0;
+    GetWindowThreadProcessId(owner, &processId);
+    payload.ownerPid = processId;
+    if (processId == 0) {
+        return;
+    }
+
+    auto process = g_processInfoCache.Lookup(processId);
+    if (process && !process->appPath.empty()) {
+        payload.ownerAppPath = process->appPath;
+        payload.ownerApp = process->app;
+    }
+}
+
+// 读取 Unicode 文本预览（只转换前 previewBytes 个字符，避免大文本整体转码）
+static void FillClipboardTextPreview(ztools::ClipboardChangePayload& payload, size_t previewBytes) {
+    HANDLE hData = GetClipboardData(CF_UNICODETEXT);
+    if (hData == NULL) {
+        return;
+    }
+    const wchar_t* pszText = static_cast<const wchar_t*>(GlobalLock(hData));
+    if (pszText == NULL) {
+        return;
+    }
+    payload.hasText = true;
+
+    // 每个 UTF-16 单元至少对应 1 个 UTF-8 字节，多取 1 个用于判断是否截断
+    size_t maxChars = GlobalSize(hData) / sizeof(wchar_t);
+    size_t wideLen = wcsnlen(pszText, (std::min)(maxChars, previewBytes + 1));
+    bool truncated = wideLen > previewBytes;
+    if (truncated) {
+        wideLen = previewBytes;
+    }
+    // 不拆分代理对
+    if (wideLen > 0 && pszText[wideLen - 1] >= 0xD800 && pszText[wideLen - 1] <= 0xDBFF) {
+        wideLen--;
+        truncated = true;
+    }
+
+    std::string utf8 = ztools::WideToUtf8(pszText, wideLen);
+    GlobalUnlock(hData);
+
+    bool cut = false;
+    payload.textPreview = ztools::TruncateUtf8(utf8, previewBytes, &cut);
+    payload.textTruncated = truncated || cut;
+}
+
+// 监控线程打开剪贴板（其他程序可能仍在写入，短暂重试）
+static bool OpenClipboardForMonitor() {
+    for (int i = 0; i < 3; i++) {
+        if (OpenClipboard(g_hwnd)) {
+            return true;
+        }
+        Sleep(20);
+    }
+    return false;
+}
+
+// 读取变化负载（调用方已打开剪贴板）
+static void FillClipboardPayload(ztools::ClipboardChangePayload& payload, size_t previewBytes) {
+    payload.opened = true;
+    payload.sequence = GetClipboardSequenceNumber();
+
+    FillClipboardOwner(payload);
+
+    // 本进程延迟渲染的格式一律不查询大小（报告 -1）
+    const bool delayedOwner = ClipboardOwnedByDelayedRenderer();
+    UINT format = 0;
+    while ((format = EnumClipboardFormats(format)) != 0) {
+        ztools::ClipboardFormatInfo item;
+        item.id = format;
+        item.name = GetClipboardFormatDisplayName(format);
+        item.size = -1;
+        if (!delayedOwner && ShouldQueryClipboardFormatSize(format, previewBytes)) {
+            HANDLE hData = GetClipboardData(format);
+            if (hData != NULL) {
+                item.size = static_cast<int64_t>(GlobalSize(hData));
+            }
+        }
+        payload.formats.push_back(item);
+
+        if (format == CF_HDROP) {
+            HDROP hDrop = static_cast<HDROP>(GetClipboardData(CF_HDROP));
+            if (hDrop != NULL) {
+                payload.fileCount = DragQueryFileW(hDrop, 0xFFFFFFFF, NULL, 0);
+            }
+        }
+    }
+
+    if (previewBytes > 0 && IsClipboardFormatAvailable(CF_UNICODETEXT)) {
+        FillClipboardTextPreview(payload, previewBytes);
+    } else {
+        payload.hasText = IsClipboardFormatAvailable(CF_UNICODETEXT) || IsClipboardFormatAvailable(CF_TEXT);
+    }
+}
+
+// 读取 HGLOBAL 格式的原始字节
+static bool ReadClipboardGlobalBytes(UINT format, std::string& out) {
+    HANDLE hData = GetClipboardData(format);
+    if (hData == NULL) {
+        return false;
+    }
+    const char* bytes = static_cast<const char*>(GlobalLock(hData));
+    if (bytes == NULL) {
+        return false;
+    }
+    out.assign(bytes, GlobalSize(hData));
+    GlobalUnlock(hData);
+    return true;
+}
+
+// 对完整文本分类（在关闭剪贴板之后调用）；wideBytes 为 CF_UNICODETEXT 的原始字节
+static void ClassifyClipboardText(ztools::ClipboardChangePayload& payload, const std::string& wideBytes) {
+    const wchar_t* wide = reinterpret_cast<const wchar_t*>(wideBytes.data());
+    std::string utf8 = ztools::WideToUtf8(wide, wcsnlen(wide, wideBytes.size() / sizeof(wchar_t)));
+
+    payload.classification = ztools::ClassifyText(utf8);
+    payload.matchTexts.reserve(payload.classification.matches.size());
+    for (const ztools::TextMatch& match : payload.classification.matches) {
+        payload.matchTexts.push_back(utf8.substr(match.begin, match.end - match.begin));
+    }
+    ztools::ConvertTextMatchesToUtf16(utf8.data(), utf8.size(), payload.classification.matches);
+    payload.classified = true;
+}
+
+// 读取写入剪贴板历史的格式（调用方已打开剪贴板）
+// - text:   CF_UNICODETEXT 转 UTF-8
+// - html:   "HTML Format" 原始字节（本身即 UTF-8）
+// - files:  CF_HDROP 路径，换行分隔
+// - CF_DIB: 原始位图数据（不在监控线程编码 PNG）；本进程延迟渲染的截图尚未渲染，不读取
+static void ReadClipboardHistoryFormats(std::vector<ztools::ClipboardHistoryFormat>& formats) {
+    static const UINT htmlFormat = RegisterClipboardFormatW(L"HTML Format");
+
+    if (IsClipboardFormatAvailable(CF_UNICODETEXT)) {
+        HANDLE hData = GetClipboardData(CF_UNICODETEXT);
+        const wchar_t* pszText = hData != NULL ? static_cast<const wchar_t*>(GlobalLock(hData)) : NULL;
+        if (pszText != NULL) {
+            size_t maxChars = GlobalSize(hData) / sizeof(wchar_t);
+            ztools::ClipboardHistoryFormat text;
+            text.name = "text";
+            text.data = ztools::WideToUtf8(pszText, wcsnlen(pszText, maxChars));
+            GlobalUnlock(hData);
+            if (!text.data.empty()) {
+                formats.push_back(std::move(text));
+            }
+        }
+    }
+
+    if (htmlFormat != 0 && IsClipboardFormatAvailable(htmlFormat)) {
+        ztools::ClipboardHistoryFormat html;
+        html.name = "html";
+        if (ReadClipboardGlobalBytes(htmlFormat, html.data)) {
+            // 去掉 GlobalSize 对齐带来的尾部 NUL
+            html.data.resize(strnlen(html.data.data(), html.data.size()));
+            formats.push_back(std::move(html));
+        }
+    }
+
+    if (IsClipboardFormatAvailable(CF_HDROP)) {
+        HDROP hDrop = static_cast<HDROP>(GetClipboardData(CF_HDROP));
+        if (hDrop != NULL) {
+            ztools::ClipboardHistoryFormat files;
+            files.name = "files";
+            UINT fileCount = DragQueryFileW(hDrop, 0xFFFFFFFF, NULL, 0);
+            for (UINT i = 0; i < fileCount; i++) {
+                UINT pathLen = DragQueryFileW(hDrop, i, NULL, 0);
+                if (pathLen == 0) {
+                    continue;
+                }
+                std::wstring wPath(pathLen, L'\0');
+                DragQueryFileW(hDrop, i, &wPath[0], pathLen + 1);
+                if (!files.data.empty()) {
+                    files.data.push_back('\n');
+                }
+                ztools::AppendUtf16AsUtf8(reinterpret_cast<const char16_t*>(wPath.data()), pathLen, files.data);
+            }
+            if (!files.data.empty()) {
+                formats.push_back(std::move(files));
+            }
+        }
+    }
+
+    if (IsClipboardFormatAvailable(CF_DIB) && !ClipboardOwnedByDelayedRenderer()) {
+        ztools::ClipboardHistoryFormat dib;
+        dib.name = "CF_DIB";
+        if (ReadClipboardGlobalBytes(CF_DIB, dib.data) && !dib.data.empty()) {
+            formats.push_back(std::move(dib));
+        }
+    }
+}
+
+// 将变化负载转换为 JS 对象
+static napi_value CreateClipboardPayloadObject(napi_env env, const ztools::ClipboardChangePayload& payload) {
+    napi_value result;
+    napi_create_object(env, &result);
+
+    napi_value sequence;
+    napi_create_double(env, static_cast<double>(payload.sequence), &sequence);
+    napi_set_named_property(env, result, "sequence", sequence);
+
+    napi_value opened;
+    napi_get_boolean(env, payload.opened, &opened);
+    napi_set_named_property(env, result, "opened", opened);
+
+    napi_value formats;
+    napi_create_array_with_length(env, payload.formats.size(), &formats);
+    for (size_t i = 0; i < payload.formats.size(); i++) {
+        const ztools::ClipboardFormatInfo& item = payload.formats[i];
+        napi_value format;
+        napi_create_object(env, &format);
+
+        napi_value id;
+        napi_create_uint32(env, item.id, &id);
+        napi_set_named_property(env, format, "id", id);
+
+        napi_value name;
+        napi_create_string_utf8(env, item.name.c_str(), item.name.size(), &name);
+        napi_set_named_property(env, format, "name", name);
+
+        napi_value size;
+        napi_create_double(env, static_cast<double>(item.size), &size);
+        napi_set_named_property(env, format, "size", size);
+
+        napi_set_element(env, formats, static_cast<uint32_t>(i), format);
+    }
+    napi_set_named_property(env, result, "formats", formats);
+
+    napi_value owner;
+    napi_create_object(env, &owner);
+    napi_value pid;
+    napi_create_uint32(env, payload.ownerPid, &pid);
+    napi_set_named_property(env, owner, "pid", pid);
+    napi_value app;
+    napi_create_string_utf8(env, payload.ownerApp.c_str(), payload.ownerApp.size(), &app);
+    napi_set_named_property(env, owner, "app", app);
+    napi_value appPath;
+    napi_create_string_utf8(env, payload.ownerAppPath.c_str(), payload.ownerAppPath.size(), &appPath);
+    napi_set_named_property(env, owner, "appPath", appPath);
+    napi_set_named_property(env, result, "owner", owner);
+
+    napi_value hasText;
+    napi_get_boolean(env, payload.hasText, &hasText);
+    napi_set_named_property(env, result, "hasText", hasText);
+
+    napi_value textPreview;
+    napi_create_string_utf8(env, payload.textPreview.c_str(), payload.textPreview.size(), &textPreview);
+    napi_set_named_property(env, result, "textPreview", textPreview);
+
+    napi_value textTruncated;
+    napi_get_boolean(env, payload.textTruncated, &textTruncated);
+    napi_set_named_property(env, result, "textTruncated", textTruncated);
+
+    napi_value fileCount;
+    napi_create_uint32(env, payload.fileCount, &fileCount);
+    napi_set_named_property(env, result, "fileCount", fileCount);
+
+    napi_value historyId;
+    napi_create_double(env, static_cast<double>(payload.historyId), &historyId);
+    napi_set_named_property(env, result, "historyId", historyId);
+
+    if (payload.classified) {
+        const ztools::TextClassification& classification = payload.classification;
+        napi_value classified;
+        napi_create_object(env, &classified);
+
+        napi_value kinds;
+        napi_create_uint32(env, classification.kinds, &kinds);
+        napi_set_named_property(env, classified, "kinds", kinds);
+        napi_value exact;
+        napi_create_uint32(env, classification.exact, &exact);
+        napi_set_named_property(env, classified, "exact", exact);
+
+        napi_value types;
+        napi_create_array(env, &types);
+        uint32_t typeCount = 0;
+        for (uint32_t kind = 1; kind <= ztools::kTextKindCode; kind <<= 1) {
+            if ((classification.kinds & kind) != 0) {
+                napi_value name;
+                napi_create_string_utf8(env, ztools::TextKindName(kind), NAPI_AUTO_LENGTH, &name);
+                napi_set_element(env, types, typeCount++, name);
+            }
+        }
+        napi_set_named_property(env, classified, "types", types);
+
+        napi_value matches;
+        napi_create_array_with_length(env, classification.matches.size(), &matches);
+        for (size_t i = 0; i < classification.matches.size(); i++) {
+            const ztools::TextMatch& match = classification.matches[i];
+            napi_value item;
+            napi_create_object(env, &item);
+            napi_value type;
+            napi_create_string_utf8(env, ztools::TextKindName(match.kind), NAPI_AUTO_LENGTH, &type);
+            napi_set_named_property(env, item, "type", type);
+            napi_value start;
+            napi_create_uint32(env, match.begin, &start);
+            napi_set_named_property(env, item, "start", start);
+            napi_value end;
+            napi_create_uint32(env, match.end, &end);
+            napi_set_named_property(env, item, "end", end);
+            napi_value text;
+            napi_create_string_utf8(env, payload.matchTexts[i].c_str(), payload.matchTexts[i].size(), &text);
+            napi_set_named_property(env, item, "text", text);
+            napi_set_element(env, matches, static_cast<uint32_t>(i), item);
+        }
+        napi_set_named_property(env, classified, "matches", matches);
+
+        napi_value truncated;
+        napi_get_boolean(env, classification.truncated, &truncated);
+        napi_set_named_property(env, classified, "truncated", truncated);
+
+        napi_set_named_property(env, result, "classification", classified);
+    }
+
+    return result;
+}
+
+// 在主线程调用 JS 回调（data 为可选的变化负载）
 void CallJs(napi_env env, napi_value js_callback, void* context, void* data) {
+    ztools::ClipboardChangePayload* payload = static_cast<ztools::ClipboardChangePayload*>(data);
     if (env != nullptr && js_callback != nullptr) {
         napi_value global;
         napi_get_global(env, &global);
-        napi_call_function(env, global, js_callback, 0, nullptr, nullptr);
+        if (payload != nullptr) {
+            napi_value arg = CreateClipboardPayloadObject(env, *payload);
+            napi_call_function(env, global, js_callback, 1, &arg, nullptr);
+        } else {
+            napi_call_function(env, global, js_callback, 0, nullptr, nullptr);
+        }
     }
+    delete payload;
 }
 
 // 启动剪贴板监控
@@ -153,6 +622,61 @@ Napi::Value StartMonitor(const Napi::CallbackInfo& info) {
         return env.Undefined();
     }
 
+    // 可选参数：{ payload?: boolean, previewLength?: number, classify?: boolean,
+    //            coalesce?: { leading?, trailing?, quietMs?, maxWaitMs?, groupByFormats? } }
+    bool payloadEnabled = false;
+    bool classifyEnabled = false;
+    size_t previewBytes = ztools::kDefaultClipboardPreviewBytes;
+    ztools::CoalescerOptions coalesceOptions;
+    coalesceOptions.leading = false;  // 默认只发收尾通知：与旧版防抖一致，一次多格式复制只回调一次
+    bool groupByFormats = false;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (options.Has("payload") && options.Get("payload").IsBoolean()) {
+            payloadEnabled = options.Get("payload").As<Napi::Boolean>().Value();
+        }
+        if (options.Has("classify") && options.Get("classify").IsBoolean()) {
+            classifyEnabled = options.Get("classify").As<Napi::Boolean>().Value();
+        }
+        if (options.Has("previewLength") && options.Get("previewLength").IsNumber()) {
+            int64_t length = options.Get("previewLength").As<Napi::Number>().Int64Value();
+            previewBytes = length > 0 ? static_cast<size_t>(length) : 0;
+        }
+        if (options.Has("coalesce") && options.Get("coalesce").IsObject()) {
+            Napi::Object coalesce = options.Get("coalesce").As<Napi::Object>();
+            if (coalesce.Has("leading") && coalesce.Get("leading").IsBoolean()) {
+                coalesceOptions.leading = coalesce.Get("leading").As<Napi::Boolean>().Value();
+            }
+            if (coalesce.Has("trailing") && coalesce.Get("trailing").IsBoolean()) {
+                coalesceOptions.trailing = coalesce.Get("trailing").As<Napi::Boolean>().Value();
+            }
+            if (coalesce.Has("quietMs") && coalesce.Get("quietMs").IsNumber()) {
+                int64_t quietMs = coalesce.Get("quietMs").As<Napi::Number>().Int64Value();
+                coalesceOptions.quietUs = quietMs > 0 ? static_cast<uint64_t>(quietMs) * 1000 : 0;
+            }
+            if (coalesce.Has("maxWaitMs") && coalesce.Get("maxWaitMs").IsNumber()) {
+                int64_t maxWaitMs = coalesce.Get("maxWaitMs").As<Napi::Number>().Int64Value();
+                coalesceOptions.maxWaitUs = maxWaitMs > 0 ? static_cast<uint64_t>(maxWaitMs) * 1000 : 0;
+            }
+            if (coalesce.Has("groupByFormats") && coalesce.Get("groupByFormats").IsBoolean()) {
+                groupByFormats = coalesce.Get("groupByFormats").As<Napi::Boolean>().Value();
+            }
+            if (!coalesceOptions.leading && !coalesceOptions.trailing) {
+                Napi::TypeError::New(env, "coalesce.leading and coalesce.trailing cannot both be false")
+                    .ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+        }
+    }
+    g_clipboardPayloadEnabled = payloadEnabled;
+    g_clipboardPreviewBytes = previewBytes;
+    g_clipboardClassifyEnabled = payloadEnabled && classifyEnabled;
+    g_clipboardCoalescer.Clear();
+    g_clipboardCoalescer.SetOptions(coalesceOptions);
+    g_clipboardCoalescer.SetKeyMatcher(groupByFormats ? ztools::EventCoalescer::KeyMatcher(ClipboardFormatKeyExtends)
+                                                      : nullptr);
+    g_clipboardGroupByFormats = groupByFormats;
+
     // 创建线程安全函数
     napi_value callback = info[0];
     napi_value resource_name;
@@ -172,6 +696,58 @@ Napi::Value StartMonitor(const Napi::CallbackInfo& info) {
         &g_tsfn
     );
 
+    g_clipboardDetector.Reset();
+    g_clipboardDetector.SetSink([](const ztools::ClipboardChange& change) {
+        if (g_tsfn == nullptr) {
+            return;
+        }
+        ztools::ClipboardChangePayload* payload = nullptr;
+        if (g_clipboardPayloadEnabled) {
+            payload = new ztools::ClipboardChangePayload();
+            payload->sequence = change.sequence;
+            payload->detectedAtUs = change.detectedAtUs;
+        }
+
+        // 负载与历史共用同一次 OpenClipboard 会话
+        if (payload != nullptr || g_clipboardHistoryEnabled) {
+            std::vector<ztools::ClipboardHistoryFormat> historyFormats;
+            std::string classifyText;
+            if (OpenClipboardForMonitor()) {
+                ztools::ClipboardLockTimer lockTimer(g_clipboardLockStats);
+                if (payload != nullptr) {
+                    FillClipboardPayload(*payload, g_clipboardPreviewBytes);
+                    if (g_clipboardClassifyEnabled && IsClipboardFormatAvailable(CF_UNICODETEXT)) {
+                        ReadClipboardGlobalBytes(CF_UNICODETEXT, classifyText);
+                    }
+                }
+                if (g_clipboardHistoryEnabled) {
+                    ReadClipboardHistoryFormats(historyFormats);
+                }
+                CloseClipboard();
+                lockTimer.Stop();
+            }
+            // 分类、哈希与去重在关闭剪贴板之后进行，不延长剪贴板占用时间
+            if (!classifyText.empty()) {
+                ClassifyClipboardText(*payload, classifyText);
+            }
+            if (!historyFormats.empty()) {
+                AddClipboardHistoryThumbnail(historyFormats);
+                uint64_t historyId = AddClipboardHistoryEntry(std::move(historyFormats), change.sequence);
+                if (payload != nullptr) {
+                    payload->historyId = historyId;
+                }
+            }
+        }
+
+        if (napi_call_threadsafe_function(g_tsfn, payload, napi_tsfn_nonblocking) != napi_ok) {
+            delete payload;
+        }
+    });
+    // 合并后的每次触发交给检测核心：暂停时丢弃，同一序列号只分发一次
+    g_clipboardCoalescer.SetSink([](const ztools::CoalescedBurst&) {
+        g_clipboardDetector.Report(ztools::ClipboardSource::Clipboard, GetClipboardSequenceNumber());
+    });
+
     g_isMonitoring = true;
 
     // 启动消息循环线程
@@ -229,7 +805,7 @@ Napi::Value StopMonitor(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
     g_isMonitoring = false;
-    g_isPaused = false;  // 重置暂停状态
+    g_clipboardDetector.SetPaused(false);  // 重置暂停状态
 
     if (g_hwnd != NULL) {
         PostMessageW(g_hwnd, WM_QUIT, 0, 0);
@@ -239,6 +815,9 @@ Napi::Value StopMonitor(const Napi::CallbackInfo& info) {
         g_messageThread.join();
     }
 
+    g_clipboardCoalescer.SetSink(nullptr);
+    g_clipboardDetector.SetSink(nullptr);
+
     if (g_tsfn != nullptr) {
         napi_release_threadsafe_function(g_tsfn, napi_tsfn_release);
         g_tsfn = nullptr;
@@ -250,14 +829,14 @@ Napi::Value StopMonitor(const Napi::CallbackInfo& info) {
 // 暂停剪贴板监控（不触发回调，但保持监控线程运行）
 Napi::Value PauseMonitor(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    g_isPaused = true;
+    g_clipboardDetector.SetPaused(true);
     return env.Undefined();
 }
 
 // 恢复剪贴板监控
 Napi::Value ResumeMonitor(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    g_isPaused = false;
+    g_clipboardDetector.SetPaused(false);
     return env.Undefined();
 }
 
@@ -311,68 +890,25 @@ WindowInfo* GetWindowInfo(HWND hwnd) {
         wTitle.resize(titleLength);
 
         // 转换为 UTF-8
-        int size = WideCharToMultiByte(CP_UTF8, 0, wTitle.c_str(), -1, NULL, 0, NULL, NULL);
-        if (size > 0) {
-            info->title.resize(size - 1);
-            WideCharToMultiByte(CP_UTF8, 0, wTitle.c_str(), -1, &info->title[0], size, NULL, NULL);
-        }
+        info->title = ztools::WideToUtf8(wTitle.c_str());
     }
 
     // 获取窗口类名（CabinetWClass = Explorer 窗口, Progman/WorkerW = 桌面）
     WCHAR classNameBuf[256] = {0};
     int classLen = GetClassNameW(hwnd, classNameBuf, 256);
     if (classLen > 0) {
-        int cnSize = WideCharToMultiByte(CP_UTF8, 0, classNameBuf, -1, NULL, 0, NULL, NULL);
-        if (cnSize > 0) {
-            info->className.resize(cnSize - 1);
-            WideCharToMultiByte(CP_UTF8, 0, classNameBuf, -1, &info->className[0], cnSize, NULL, NULL);
-        }
+        info->className = ztools::WideToUtf8(classNameBuf);
     }
     // 保存窗口句柄，用于后续 COM 查询
     info->hwnd = (uint64_t)hwnd;
 
-    // 获取进程句柄
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, info->processId);
-    if (hProcess) {
-        // 获取可执行文件路径
-        WCHAR path[MAX_PATH] = {0};
-        if (GetModuleFileNameExW(hProcess, NULL, path, MAX_PATH)) {
-            // 保存完整路径到 appPath 字段
-            std::wstring fullPath(path);
-            int pathSize = WideCharToMultiByte(CP_UTF8, 0, fullPath.c_str(), -1, NULL, 0, NULL, NULL);
-            if (pathSize > 0) {
-                info->appPath.resize(pathSize - 1);
-                WideCharToMultiByte(CP_UTF8, 0, fullPath.c_str(), -1, &info->appPath[0], pathSize, NULL, NULL);
-            }
-
-            // 提取文件名（去掉路径）
-            size_t lastSlash = fullPath.find_last_of(L"\\");
-            std::wstring fileNameWithExt = (lastSlash != std::wstring::npos)
-                ? fullPath.substr(lastSlash + 1)
-                : fullPath;
-
-            // 保存完整程序名（包括 .exe）到 app 字段
-            int appSize = WideCharToMultiByte(CP_UTF8, 0, fileNameWithExt.c_str(), -1, NULL, 0, NULL, NULL);
-            if (appSize > 0) {
-                info->app.resize(appSize - 1);
-                WideCharToMultiByte(CP_UTF8, 0, fileNameWithExt.c_str(), -1, &info->app[0], appSize, NULL, NULL);
-            }
-
-            // 去掉 .exe 扩展名用于 appName
-            std::wstring fileName = fileNameWithExt;
-            size_t lastDot = fileName.find_last_of(L".");
-            if (lastDot != std::wstring::npos) {
-                fileName = fileName.substr(0, lastDot);
-            }
-
-            // 转换为 UTF-8
-            int size = WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, NULL, 0, NULL, NULL);
-            if (size > 0) {
-                info->appName.resize(size - 1);
-                WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, &info->appName[0], size, NULL, NULL);
-            }
-        }
-        CloseHandle(hProcess);
+    // 进程路径与程序名（appPath 完整路径，app 含 .exe，appName 不含扩展名）：
+    // 同一进程再次切到前台时直接取缓存
+    auto process = g_processInfoCache.Lookup(info->processId);
+    if (process && !process->appPath.empty()) {
+        info->appPath = process->appPath;
+        info->app = process->app;
+        info->appName = process->appName;
     }
 
     return info;
@@ -464,6 +1000,8 @@ void CALLBACK WinEventProc(
     if (event == EVENT_SYSTEM_FOREGROUND) {
         // 更新当前监控的窗口
         g_lastMonitoredWindow = hwnd;
+        // 定期关闭已退出进程的缓存句柄（不必等到该 pid 再次切到前台）
+        g_processInfoCache.EvictExitedIfDue(GetTickCount64());
 
         // 获取窗口信息
         WindowInfo* info = GetWindowInfo(hwnd);
@@ -693,71 +1231,22 @@ Napi::Value GetActiveWindowInfo(const Napi::CallbackInfo& info) {
         wTitle.resize(titleLength);
 
         // 转换为 UTF-8
-        int size = WideCharToMultiByte(CP_UTF8, 0, wTitle.c_str(), -1, NULL, 0, NULL, NULL);
-        if (size > 0) {
-            std::string titleUtf8(size - 1, 0);
-            WideCharToMultiByte(CP_UTF8, 0, wTitle.c_str(), -1, &titleUtf8[0], size, NULL, NULL);
-            result.Set("title", Napi::String::New(env, titleUtf8));
-        }
-    }
-
-    // 获取进程句柄
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, processId);
-    if (hProcess) {
-        // 获取可执行文件路径
-        WCHAR path[MAX_PATH] = {0};
-        if (GetModuleFileNameExW(hProcess, NULL, path, MAX_PATH)) {
-            // 保存完整路径到 appPath 字段
-            std::wstring fullPath(path);
-            int pathSize = WideCharToMultiByte(CP_UTF8, 0, fullPath.c_str(), -1, NULL, 0, NULL, NULL);
-            if (pathSize > 0) {
-                std::string pathUtf8(pathSize - 1, 0);
-                WideCharToMultiByte(CP_UTF8, 0, fullPath.c_str(), -1, &pathUtf8[0], pathSize, NULL, NULL);
-                result.Set("appPath", Napi::String::New(env, pathUtf8));
-            }
-
-            // 提取文件名（去掉路径）
-            size_t lastSlash = fullPath.find_last_of(L"\\");
-            std::wstring fileNameWithExt = (lastSlash != std::wstring::npos)
-                ? fullPath.substr(lastSlash + 1)
-                : fullPath;
-
-            // 保存完整程序名（包括 .exe）到 app 字段
-            int appSize = WideCharToMultiByte(CP_UTF8, 0, fileNameWithExt.c_str(), -1, NULL, 0, NULL, NULL);
-            if (appSize > 0) {
-                std::string appUtf8(appSize - 1, 0);
-                WideCharToMultiByte(CP_UTF8, 0, fileNameWithExt.c_str(), -1, &appUtf8[0], appSize, NULL, NULL);
-                result.Set("app", Napi::String::New(env, appUtf8));
-            }
-
-            // 去掉 .exe 扩展名用于 appName
-            std::wstring fileName = fileNameWithExt;
-            size_t lastDot = fileName.find_last_of(L".");
-            if (lastDot != std::wstring::npos) {
-                fileName = fileName.substr(0, lastDot);
-            }
+        result.Set("title", Napi::String::New(env, ztools::WideToUtf8(wTitle.c_str())));
+    }
 
-            // 转换为 UTF-8
-            int size = WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, NULL, 0, NULL, NULL);
-            if (size > 0) {
-                std::string appNameUtf8(size - 1, 0);
-                WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, &appNameUtf8[0], size, NULL, NULL);
-                result.Set("appName", Napi::String::New(env, appNameUtf8));
-            }
-        }
-        CloseHandle(hProcess);
+    // 进程路径与程序名（与窗口监控共用缓存）
+    auto process = g_processInfoCache.Lookup(processId);
+    if (process && !process->appPath.empty()) {
+        result.Set("appPath", Napi::String::New(env, process->appPath));
+        result.Set("app", Napi::String::New(env, process->app));
+        result.Set("appName", Napi::String::New(env, process->appName));
     }
 
     // 获取窗口类名（CabinetWClass = Explorer 窗口, Progman/WorkerW = 桌面）
     WCHAR activeClassNameBuf[256] = {0};
     int activeClassLen = GetClassNameW(hwnd, activeClassNameBuf, 256);
     if (activeClassLen > 0) {
-        int cnSize = WideCharToMultiByte(CP_UTF8, 0, activeClassNameBuf, -1, NULL, 0, NULL, NULL);
-        if (cnSize > 0) {
-            std::string classNameUtf8(cnSize - 1, 0);
-            WideCharToMultiByte(CP_UTF8, 0, activeClassNameBuf, -1, &classNameUtf8[0], cnSize, NULL, NULL);
-            result.Set("className", Napi::String::New(env, classNameUtf8));
-        }
+        result.Set("className", Napi::String::New(env, ztools::WideToUtf8(activeClassNameBuf)));
     }
     // 窗口句柄（用于 COM IShellWindows 查询 Explorer 目录路径）
     result.Set("hwnd", Napi::Number::New(env, (double)(uint64_t)hwnd));
@@ -888,7 +1377,8 @@ struct ScreenshotResult {
     int y2;
     int width;
     int height;
-    std::string base64;
+    // 截图图像的延迟渲染提供者（base64 在 JS 首次读取时由 PNG 格式生成，与剪贴板共享编码结果）
+    std::shared_ptr<ztools::ClipboardProvider> image;
 };
 
 // GDI 资源缓存
@@ -957,23 +1447,6 @@ static CaptureContext* g_captureCtx = nullptr;
 // 前向声明（定义在文件后面的应用图标提取部分）
 static int GetPngEncoderClsid(CLSID* pClsid);
 
-// Base64 编码表
-static const char base64_chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-// Base64 编码
-static std::string Base64Encode(const BYTE* data, size_t len) {
-    std::string result;
-    result.reserve(((len + 2) / 3) * 4);
-    for (size_t i = 0; i < len; i += 3) {
-        unsigned int b = (data[i] << 16) | ((i + 1 < len ? data[i + 1] : 0) << 8) | (i + 2 < len ? data[i + 2] : 0);
-        result.push_back(base64_chars[(b >> 18) & 0x3F]);
-        result.push_back(base64_chars[(b >> 12) & 0x3F]);
-        result.push_back(i + 1 < len ? base64_chars[(b >> 6) & 0x3F] : '=');
-        result.push_back(i + 2 < len ? base64_chars[b & 0x3F] : '=');
-    }
-    return result;
-}
-
 // ---- 工具函数 ----
 
 // 获取 DPI 缩放因子
@@ -1425,13 +1898,13 @@ static void DrawWindowHighlight(HDC hdc, const RECT& rect, int vx, int vy, const
     SelectObject(hdc, oldBrush);
 }
 
-// 将 HBITMAP 转换为 PNG base64 字符串
-static std::string BitmapToBase64Png(HBITMAP hBitmap) {
+// 将 HBITMAP 编码为 PNG 字节
+static bool BitmapToPng(HBITMAP hBitmap, std::string& png) {
     Gdiplus::GdiplusStartupInput gdiplusStartupInput;
     ULONG_PTR gdiplusToken;
     Gdiplus::GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
 
-    std::string result;
+    bool ok = false;
     {
         Gdiplus::Bitmap* bmp = Gdiplus::Bitmap::FromHBITMAP(hBitmap, NULL);
         if (bmp) {
@@ -1445,7 +1918,8 @@ static std::string BitmapToBase64Png(HBITMAP hBitmap) {
                     size_t len = GlobalSize(hMem);
                     BYTE* ptr = (BYTE*)GlobalLock(hMem);
                     if (ptr && len > 0) {
-                        result = "data:image/png;base64," + Base64Encode(ptr, len);
+                        png.assign(reinterpret_cast<const char*>(ptr), len);
+                        ok = true;
                     }
                     GlobalUnlock(hMem);
                 }
@@ -1455,22 +1929,249 @@ static std::string BitmapToBase64Png(HBITMAP hBitmap) {
         }
     }
     Gdiplus::GdiplusShutdown(gdiplusToken);
-    return result;
+    return ok;
 }
 
-// 保存位图到剪贴板
-static bool SaveBitmapToClipboard(HBITMAP hBitmap) {
-    if (!OpenClipboard(NULL)) return false;
-    EmptyClipboard();
+// 读取 HBITMAP 像素为自上而下的 BGRA（屏幕位图的 alpha 通道无意义，统一置为不透明）
+static bool BitmapToBgra(HBITMAP hBitmap, ztools::ClipboardWriteImage& image) {
     BITMAP bm;
-    GetObject(hBitmap, sizeof(BITMAP), &bm);
-    HBITMAP hCopy = (HBITMAP)CopyImage(hBitmap, IMAGE_BITMAP, bm.bmWidth, bm.bmHeight, LR_COPYRETURNORG);
-    SetClipboardData(CF_BITMAP, hCopy);
-    CloseClipboard();
+    if (GetObject(hBitmap, sizeof(BITMAP), &bm) == 0 || bm.bmWidth <= 0 || bm.bmHeight <= 0) {
+        return false;
+    }
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = bm.bmWidth;
+    bmi.bmiHeader.biHeight = -bm.bmHeight;  // 自上而下
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    image.width = static_cast<uint32_t>(bm.bmWidth);
+    image.height = static_cast<uint32_t>(bm.bmHeight);
+    image.stride = 0;
+    image.bgra.resize(static_cast<size_t>(image.width) * 4 * image.height);
+    HDC screenDC = GetDC(NULL);
+    int lines = GetDIBits(screenDC, hBitmap, 0, image.height, &image.bgra[0], &bmi, DIB_RGB_COLORS);
+    ReleaseDC(NULL, screenDC);
+    if (lines != bm.bmHeight) {
+        return false;
+    }
+    for (size_t i = 3; i < image.bgra.size(); i += 4) {
+        image.bgra[i] = '\xff';
+    }
     return true;
 }
 
-// 从预截屏位图提取区域，生成 base64 并复制到剪贴板
+// ---- 延迟渲染剪贴板 ----
+//
+// 截图完成时只以 SetClipboardData(format, NULL) 声明 CF_DIBV5 与 PNG，不复制位图也不编码：
+// 消费方真正粘贴时系统向所有者窗口发送 WM_RENDERFORMAT，才由 ClipboardProvider 渲染该格式。
+// 所有者窗口在独立线程中常驻（截图线程结束后仍需响应渲染请求）。CF_DIB/CF_BITMAP 由系统从 CF_DIBV5 合成。
+// 插件卸载或进程退出时由 env 清理钩子销毁窗口：DestroyWindow 触发 WM_RENDERALLFORMATS，
+// 尚未渲染的格式在此时写入剪贴板，截图在进程结束后仍可粘贴。
+
+#define WM_ZTOOLS_PUBLISH_DELAYED (WM_APP + 1)
+
+static std::thread g_renderOwnerThread;
+static std::mutex g_renderOwnerMutex;
+// 当前剪贴板上声明的格式的提供者（仅在所有者窗口线程访问）
+static std::shared_ptr<ztools::ClipboardProvider> g_delayedProvider;
+
+static UINT DelayedFormatId(const std::string& name) {
+    if (name == "CF_DIBV5") {
+        return CF_DIBV5;
+    }
+    std::wstring wide(name.begin(), name.end());  // 注册格式名均为 ASCII
+    return RegisterClipboardFormatW(wide.c_str());
+}
+
+// 渲染一个格式并交给剪贴板（调用方已打开剪贴板）
+static bool RenderDelayedFormat(UINT format) {
+    if (!g_delayedProvider) {
+        return false;
+    }
+    for (const std::string& name : g_delayedProvider->Formats()) {
+        if (DelayedFormatId(name) != format) {
+            continue;
+        }
+        std::shared_ptr<const std::string> data = g_delayedProvider->Render(name);
+        if (!data) {
+            return false;
+        }
+        HGLOBAL hGlobal = GlobalAlloc(GMEM_MOVEABLE, data->size());
+        void* pData = hGlobal != NULL ? GlobalLock(hGlobal) : NULL;
+        if (pData == NULL) {
+            if (hGlobal != NULL) {
+                GlobalFree(hGlobal);
+            }
+            return false;
+        }
+        memcpy(pData, data->data(), data->size());
+        GlobalUnlock(hGlobal);
+        if (SetClipboardData(format, hGlobal) == NULL) {
+            GlobalFree(hGlobal);
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+static LRESULT CALLBACK RenderOwnerWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
+    case WM_ZTOOLS_PUBLISH_DELAYED: {
+        const auto* provider = reinterpret_cast<const std::shared_ptr<ztools::ClipboardProvider>*>(lParam);
+        // 尝试打开剪贴板（带重试机制，解决 Windows 11 剪贴板占用问题）
+        BOOL clipboardOpened = FALSE;
+        for (int i = 0; i < 5 && !clipboardOpened; i++) {
+            clipboardOpened = OpenClipboard(hwnd);
+            if (!clipboardOpened && i < 4) {
+                Sleep(50);
+            }
+        }
+        if (!clipboardOpened) {
+            return FALSE;
+        }
+        {
+            ztools::ClipboardLockTimer lockTimer(g_clipboardLockStats);
+            // EmptyClipboard 会先向上一任所有者（可能就是本窗口）发送 WM_DESTROYCLIPBOARD
+            EmptyClipboard();
+            g_delayedProvider = *provider;
+            for (const std::string& name : g_delayedProvider->Formats()) {
+                SetClipboardData(DelayedFormatId(name), NULL);
+            }
+        }
+        CloseClipboard();
+        return TRUE;
+    }
+
+    case WM_RENDERFORMAT:
+        // 请求方已打开剪贴板，直接 SetClipboardData
+        RenderDelayedFormat(static_cast<UINT>(wParam));
+        return 0;
+
+    case WM_RENDERALLFORMATS:
+        // 所有者窗口销毁前（进程退出）渲染全部格式，内容在进程结束后仍可粘贴
+        if (g_delayedProvider && OpenClipboard(hwnd)) {
+            if (GetClipboardOwner() == hwnd) {
+                for (const std::string& name : g_delayedProvider->Formats()) {
+                    RenderDelayedFormat(DelayedFormatId(name));
+                }
+            }
+            CloseClipboard();
+        }
+        return 0;
+
+    case WM_DESTROYCLIPBOARD:
+        // 剪贴板被清空或被其他程序接管：不再需要渲染，释放对位图的引用（JS 结果可能仍持有提供者）
+        g_delayedProvider.reset();
+        return 0;
+
+    case WM_CLOSE:
+        // 清理钩子投递：在本线程销毁窗口（仍是剪贴板所有者时系统先发送 WM_RENDERALLFORMATS）
+        DestroyWindow(hwnd);
+        return 0;
+
+    case WM_DESTROY:
+        g_delayedProvider.reset();
+        PostQuitMessage(0);
+        return 0;
+    }
+    return DefWindowProc(hwnd, msg, wParam, lParam);
+}
+
+// 首次使用时创建常驻的所有者窗口线程
+static HWND EnsureRenderOwnerWindow() {
+    std::lock_guard<std::mutex> lock(g_renderOwnerMutex);
+    if (g_renderOwnerHwnd != NULL) {
+        return g_renderOwnerHwnd;
+    }
+
+    HANDLE ready = CreateEventW(NULL, TRUE, FALSE, NULL);
+    if (ready == NULL) {
+        return NULL;
+    }
+    g_renderOwnerThread = std::thread([ready]() {
+        WNDCLASSW wc = {0};
+        wc.lpfnWndProc = RenderOwnerWndProc;
+        wc.hInstance = GetModuleHandle(NULL);
+        wc.lpszClassName = L"ZToolsClipboardRenderOwner";
+        RegisterClassW(&wc);
+
+        HWND hwnd = CreateWindowW(
+            L"ZToolsClipboardRenderOwner",
+            L"ZToolsClipboardRenderOwner",
+            0, 0, 0, 0, 0,
+            HWND_MESSAGE,  // 消息窗口
+            NULL, GetModuleHandle(NULL), NULL
+        );
+        g_renderOwnerHwnd = hwnd;
+        SetEvent(ready);
+        if (hwnd == NULL) {
+            return;
+        }
+
+        MSG msg;
+        while (GetMessageW(&msg, NULL, 0, 0) > 0) {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    });
+
+    WaitForSingleObject(ready, INFINITE);
+    CloseHandle(ready);
+    if (g_renderOwnerHwnd == NULL) {
+        g_renderOwnerThread.join();
+    }
+    return g_renderOwnerHwnd;
+}
+
+// env 清理钩子：销毁所有者窗口（渲染尚未渲染的格式）并等待线程结束；之后再次使用时重新创建
+static void ShutdownRenderOwnerWindow(void*) {
+    std::lock_guard<std::mutex> lock(g_renderOwnerMutex);
+    if (g_renderOwnerHwnd != NULL) {
+        PostMessageW(g_renderOwnerHwnd, WM_CLOSE, 0, 0);
+    }
+    if (g_renderOwnerThread.joinable()) {
+        g_renderOwnerThread.join();
+    }
+    g_renderOwnerHwnd = NULL;
+}
+
+// 以延迟渲染方式发布提供者的全部格式
+static bool PublishDelayedClipboard(const std::shared_ptr<ztools::ClipboardProvider>& provider) {
+    HWND owner = EnsureRenderOwnerWindow();
+    if (owner == NULL) {
+        return false;
+    }
+    // 同步发送：在所有者线程内打开剪贴板，EmptyClipboard 才会把所有权交给该窗口
+    return SendMessageW(owner, WM_ZTOOLS_PUBLISH_DELAYED, 0, reinterpret_cast<LPARAM>(&provider)) == TRUE;
+}
+
+// 截图区域位图（渲染函数共享，提供者与 JS 结果都释放后才删除）
+struct CapturedBitmap {
+    HBITMAP bitmap;
+    explicit CapturedBitmap(HBITMAP bmp) : bitmap(bmp) {}
+    ~CapturedBitmap() { DeleteObject(bitmap); }
+    CapturedBitmap(const CapturedBitmap&) = delete;
+    CapturedBitmap& operator=(const CapturedBitmap&) = delete;
+};
+
+// 截图提供者：CF_DIBV5（完整 alpha 掩码，系统可合成 CF_DIB/CF_BITMAP）与 PNG
+static std::shared_ptr<ztools::ClipboardProvider> CreateCaptureProvider(HBITMAP hBitmap) {
+    auto captured = std::make_shared<CapturedBitmap>(hBitmap);
+    auto provider = std::make_shared<ztools::ClipboardProvider>();
+    provider->Add("CF_DIBV5", [captured](std::string& data) {
+        ztools::ClipboardWriteImage image;
+        return BitmapToBgra(captured->bitmap, image) && ztools::BuildDibV5FromBgra(image, data);
+    });
+    provider->Add("PNG", [captured](std::string& data) {
+        return BitmapToPng(captured->bitmap, data);
+    });
+    return provider;
+}
+
+// 从预截屏位图提取区域，以延迟渲染方式发布到剪贴板
 static ScreenshotResult* ExtractRegionResult(HDC memDC, const RECT& rect,
     int vx, int vy, double dpiScale) {
     ScreenshotResult* result = new ScreenshotResult();
@@ -1516,20 +2217,37 @@ static ScreenshotResult* ExtractRegionResult(HDC memDC, const RECT& rect,
         finalDC = scaledDC;
     }
 
-    // 生成 base64
-    result->base64 = BitmapToBase64Png(finalBmp);
-    // 复制到剪贴板
-    result->success = SaveBitmapToClipboard(finalBmp);
-
-    DeleteDC(finalDC);
-    DeleteObject(finalBmp);
+    // 位图交给提供者：剪贴板只声明格式，粘贴或 JS 读取 base64 时才渲染
+    DeleteDC(finalDC);  // 先从 DC 中选出位图，之后可在其他线程读取
     ReleaseDC(NULL, screenDC);
+    result->image = CreateCaptureProvider(finalBmp);
+    result->success = PublishDelayedClipboard(result->image);
 
     return result;
 }
 
 // ---- 窗口过程和线程 ----
 
+// 截图结果 base64 属性的 getter：首次读取时渲染 PNG（若已粘贴过 PNG 则直接复用缓存）
+static napi_value ScreenshotBase64Getter(napi_env env, napi_callback_info info) {
+    void* data = nullptr;
+    napi_get_cb_info(env, info, nullptr, nullptr, nullptr, &data);
+    const auto* image = static_cast<const std::shared_ptr<ztools::ClipboardProvider>*>(data);
+
+    std::string base64;
+    std::shared_ptr<const std::string> png = *image ? (*image)->Render("PNG") : nullptr;
+    if (png) {
+        base64 = ztools::Base64DataUrl("image/png", png->data(), png->size());
+    }
+    napi_value value;
+    napi_create_string_utf8(env, base64.c_str(), base64.size(), &value);
+    return value;
+}
+
+static void ReleaseScreenshotImage(napi_env env, void* data, void* hint) {
+    delete static_cast<std::shared_ptr<ztools::ClipboardProvider>*>(data);
+}
+
 // 在主线程调用 JS 回调（截图完成）
 static void CallScreenshotJs(napi_env env, napi_value js_callback, void* context, void* data) {
     if (env != nullptr && js_callback != nullptr && data != nullptr) {
@@ -1543,7 +2261,7 @@ static void CallScreenshotJs(napi_env env, napi_value js_callback, void* context
         napi_set_named_property(env, resultObj, "success", success);
 
         if (result->success) {
-            napi_value x, y, x2, y2, width, height, base64;
+            napi_value x, y, x2, y2, width, height;
             napi_create_int32(env, result->x, &x);
             napi_set_named_property(env, resultObj, "x", x);
             napi_create_int32(env, result->y, &y);
@@ -1556,8 +2274,13 @@ static void CallScreenshotJs(napi_env env, napi_value js_callback, void* context
             napi_set_named_property(env, resultObj, "width", width);
             napi_create_int32(env, result->height, &height);
             napi_set_named_property(env, resultObj, "height", height);
-            napi_create_string_utf8(env, result->base64.c_str(), result->base64.size(), &base64);
-            napi_set_named_property(env, resultObj, "base64", base64);
+
+            // base64 为惰性属性：不读取就不编码 PNG
+            auto* image = new std::shared_ptr<ztools::ClipboardProvider>(result->image);
+            napi_property_descriptor base64 = {
+                "base64", nullptr, nullptr, ScreenshotBase64Getter, nullptr, nullptr, napi_enumerable, image};
+            napi_define_properties(env, resultObj, 1, &base64);
+            napi_add_finalizer(env, resultObj, image, ReleaseScreenshotImage, nullptr, nullptr);
         }
 
         napi_value global;
@@ -2015,11 +2738,77 @@ Napi::Value StartRegionCapture(const Napi::CallbackInfo& info) {
 
 // ==================== 剪贴板文件功能 ====================
 
-// 获取剪贴板中的文件列表
-Napi::Value GetClipboardFiles(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    Napi::Array result = Napi::Array::New(env);
+// 前向声明（定义在文件后面的应用图标提取部分）
+static bool IsNetworkPath(const std::wstring& path);
+
+// 文件属性并行查询的默认超时（网络共享上 GetFileAttributesW 可能阻塞数秒）
+static const uint64_t kClipboardFileProbeTimeoutMs = 1000;
+
+// 文件属性查询的常驻工作线程（首次查询时启动，卸载时由 ShutdownFileProbePool 回收）
+static ztools::FileProbePool g_fileProbePool;
+
+static void ShutdownFileProbePool(void*) {
+    g_fileProbePool.Shutdown();
+}
+
+// 系统 ANSI 代码页（CF_TEXT、旧式 DROPFILES）→ UTF-16
+static std::wstring AnsiToWide(const char* ansi, int length) {
+    std::wstring wide;
+    if (length <= 0) {
+        return wide;
+    }
+    int wideLen = MultiByteToWideChar(CP_ACP, 0, ansi, length, NULL, 0);
+    if (wideLen > 0) {
+        wide.resize(wideLen);
+        MultiByteToWideChar(CP_ACP, 0, ansi, length, &wide[0], wideLen);
+    }
+    return wide;
+}
 
+// fWide 为 0 的旧式 DROPFILES：路径为 ANSI 代码页，逐个转换为 UTF-8
+static bool ParseAnsiDropFiles(const std::string& dropFiles, ztools::PackedFileList& list) {
+    list.Clear();
+    if (dropFiles.size() < sizeof(DROPFILES)) {
+        return false;
+    }
+    const DROPFILES* header = reinterpret_cast<const DROPFILES*>(dropFiles.data());
+    size_t pos = header->pFiles;
+    while (pos < dropFiles.size() && dropFiles[pos] != '\0') {
+        size_t end = dropFiles.find('\0', pos);
+        if (end == std::string::npos) {
+            return false;
+        }
+        // ANSI → UTF-16 依赖系统代码页，仍由 Win32 完成
+        list.Append(ztools::WideToUtf8(AnsiToWide(dropFiles.data() + pos, static_cast<int>(end - pos))));
+        pos = end + 1;
+    }
+    return true;
+}
+
+// 解析从剪贴板复制出的 CF_HDROP 字节（在关闭剪贴板之后调用）
+static bool ParseClipboardDropFiles(const std::string& dropFiles, ztools::PackedFileList& list) {
+    return ztools::ParseDropFiles(dropFiles.data(), dropFiles.size(), list) ||
+           ParseAnsiDropFiles(dropFiles, list);
+}
+
+// 单个路径的文件标志（在工作线程中调用）；网络路径不查询属性
+static uint8_t ProbeClipboardFile(const std::string& path) {
+    std::wstring widePath = ztools::Utf8ToWide(path);
+    if (IsNetworkPath(widePath)) {
+        return ztools::kFileFlagNetwork | ztools::kFileFlagUnknown;
+    }
+    DWORD fileAttrs = GetFileAttributesW(widePath.c_str());
+    if (fileAttrs == INVALID_FILE_ATTRIBUTES) {
+        return ztools::kFileFlagUnknown;
+    }
+    return (fileAttrs & FILE_ATTRIBUTE_DIRECTORY) ? ztools::kFileFlagDirectory : 0;
+}
+
+// 读取剪贴板中的文件列表（实际打开剪贴板，缓存于 ClipboardSlot::Files）
+// 锁内只复制 DROPFILES 原始字节；解析与并行属性查询都在关闭剪贴板之后进行。
+// 属性查询超时时 *timedOut 为 true（部分条目仍为 kFileFlagUnknown）
+static bool ReadClipboardFileEntries(ztools::PackedFileList& list, uint64_t timeoutMs, bool* timedOut) {
+    *timedOut = false;
     // 尝试打开剪贴板（带重试机制，解决 Windows 11 剪贴板占用问题）
     const int maxRetries = 5;
     const int retryDelayMs = 50;
@@ -2042,70 +2831,117 @@ Napi::Value GetClipboardFiles(const Napi::CallbackInfo& info) {
 
     // 打开剪贴板失败
     if (!clipboardOpened) {
-        // Windows 11: 剪贴板可能被系统或其他程序占用
-        return result;  // 返回空数组
+        // Windows 11: 剪贴板可能被系统或其他程序占用，不缓存失败结果
+        return false;
     }
 
-    // 检查剪贴板中是否有文件
-    if (!IsClipboardFormatAvailable(CF_HDROP)) {
+    std::string dropFiles;
+    {
+        ztools::ClipboardLockTimer lockTimer(g_clipboardLockStats);
+        if (IsClipboardFormatAvailable(CF_HDROP)) {
+            ReadClipboardGlobalBytes(CF_HDROP, dropFiles);
+        }
         CloseClipboard();
-        return result;  // 返回空数组
     }
 
-    // 获取文件句柄
-    HDROP hDrop = (HDROP)GetClipboardData(CF_HDROP);
-    if (hDrop == NULL) {
-        CloseClipboard();
-        return result;  // 返回空数组
+    if (dropFiles.empty() || !ParseClipboardDropFiles(dropFiles, list)) {
+        list.Clear();
+        return true;  // 空列表
     }
 
-    // 获取文件数量
-    UINT fileCount = DragQueryFileW(hDrop, 0xFFFFFFFF, NULL, 0);
-
-    // 遍历所有文件
-    for (UINT i = 0; i < fileCount; i++) {
-        // 获取文件路径长度
-        UINT pathLength = DragQueryFileW(hDrop, i, NULL, 0);
-        if (pathLength == 0) {
-            continue;
-        }
+    ztools::FileProbeOptions options;
+    options.timeoutMs = timeoutMs;
+    *timedOut = g_fileProbePool.Probe(list, ProbeClipboardFile, options).timedOut;
+    return true;
+}
 
-        // 获取文件路径
-        std::wstring wPath(pathLength + 1, L'\0');
-        DragQueryFileW(hDrop, i, &wPath[0], pathLength + 1);
-        wPath.resize(pathLength);
+// 获取剪贴板中的文件列表
+// 参数：options?: { packed?: boolean, timeoutMs?: number }
+// - 默认返回 [{ path, name, isDirectory }]
+// - packed: 返回 { count, paths: Buffer（UTF-8 拼接）, offsets: Uint32Array(count + 1), flags: Uint8Array(count) }
+// - timeoutMs: 文件属性查询的超时，超时的条目 flags 含 unknown，isDirectory 为 false
+Napi::Value GetClipboardFiles(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
 
-        // 转换为 UTF-8
-        int utf8Size = WideCharToMultiByte(CP_UTF8, 0, wPath.c_str(), -1, NULL, 0, NULL, NULL);
-        if (utf8Size <= 0) {
-            continue;
+    bool packed = false;
+    uint64_t timeoutMs = kClipboardFileProbeTimeoutMs;
+    if (info.Length() > 0 && info[0].IsObject()) {
+        Napi::Object options = info[0].As<Napi::Object>();
+        packed = options.Get("packed").ToBoolean().Value();
+        Napi::Value timeout = options.Get("timeoutMs");
+        if (timeout.IsNumber()) {
+            timeoutMs = static_cast<uint64_t>((std::max)(0.0, timeout.As<Napi::Number>().DoubleValue()));
         }
+    }
 
-        std::string utf8Path(utf8Size - 1, 0);
-        WideCharToMultiByte(CP_UTF8, 0, wPath.c_str(), -1, &utf8Path[0], utf8Size, NULL, NULL);
-
-        // 提取文件名
-        size_t lastSlash = utf8Path.find_last_of("\\/");
-        std::string fileName = (lastSlash != std::string::npos)
-            ? utf8Path.substr(lastSlash + 1)
-            : utf8Path;
+    // 剪贴板未变化时直接使用缓存，不再打开剪贴板。
+    // 属性查询超时的结果不完整：照常返回但不写入缓存，下次调用按当时的 timeoutMs 重新查询
+    std::shared_ptr<ztools::PackedFileList> partial;
+    auto list = g_clipboardCache.Read<ztools::PackedFileList>(
+        ztools::ClipboardSlot::Files, ClipboardSequence,
+        [timeoutMs, &partial](ztools::PackedFileList& out) {
+            bool timedOut = false;
+            if (!ReadClipboardFileEntries(out, timeoutMs, &timedOut)) {
+                return false;
+            }
+            if (timedOut) {
+                partial = std::make_shared<ztools::PackedFileList>(std::move(out));
+                return false;
+            }
+            return true;
+        });
+    if (!list && partial) {
+        list = partial;
+    }
+
+    if (packed) {
+        static const ztools::PackedFileList empty;
+        const ztools::PackedFileList& files = list ? *list : empty;
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("count", Napi::Number::New(env, static_cast<double>(files.Count())));
+        result.Set("paths", Napi::Buffer<char>::Copy(env, files.paths.data(), files.paths.size()));
+        Napi::Uint32Array offsets = Napi::Uint32Array::New(env, files.offsets.size());
+        memcpy(offsets.Data(), files.offsets.data(), files.offsets.size() * sizeof(uint32_t));
+        result.Set("offsets", offsets);
+        Napi::Uint8Array flags = Napi::Uint8Array::New(env, files.flags.size());
+        memcpy(flags.Data(), files.flags.data(), files.flags.size());
+        result.Set("flags", flags);
+        return result;
+    }
 
-        // 检查是否是目录
-        DWORD fileAttrs = GetFileAttributesW(wPath.c_str());
-        bool isDirectory = (fileAttrs != INVALID_FILE_ATTRIBUTES) &&
-                          (fileAttrs & FILE_ATTRIBUTE_DIRECTORY);
+    Napi::Array result = Napi::Array::New(env);
+    if (!list) {
+        return result;  // 返回空数组
+    }
+    for (size_t i = 0; i < list->Count(); i++) {
+        const uint32_t begin = list->offsets[i];
+        const uint32_t nameBegin = list->NameOffset(i);
+        const uint32_t end = list->offsets[i + 1];
 
         // 创建文件信息对象
         Napi::Object fileInfo = Napi::Object::New(env);
-        fileInfo.Set("path", Napi::String::New(env, utf8Path));
-        fileInfo.Set("name", Napi::String::New(env, fileName));
-        fileInfo.Set("isDirectory", Napi::Boolean::New(env, isDirectory));
+        fileInfo.Set("path", Napi::String::New(env, list->paths.data() + begin, end - begin));
+        fileInfo.Set("name", Napi::String::New(env, list->paths.data() + nameBegin, end - nameBegin));
+        fileInfo.Set("isDirectory", Napi::Boolean::New(env, (list->flags[i] & ztools::kFileFlagDirectory) != 0));
 
         // 添加到结果数组
-        result.Set(i, fileInfo);
+        result.Set(static_cast<uint32_t>(i), fileInfo);
     }
 
-    CloseClipboard();
+    return result;
+}
+
+// 获取剪贴板缓存统计
+Napi::Value GetClipboardCacheStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ztools::ClipboardCacheStats stats = g_clipboardCache.Stats();
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+    result.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+    result.Set("bypassed", Napi::Number::New(env, static_cast<double>(stats.bypassed)));
+    result.Set("discarded", Napi::Number::New(env, static_cast<double>(stats.discarded)));
+    result.Set("sequence", Napi::Number::New(env, static_cast<double>(ClipboardSequence())));
     return result;
 }
 
@@ -2153,12 +2989,7 @@ Napi::Value SetClipboardFiles(const Napi::CallbackInfo& info) {
         }
 
         // 转换为宽字符
-        int wideSize = MultiByteToWideChar(CP_UTF8, 0, pathStr.c_str(), -1, NULL, 0);
-        if (wideSize > 0) {
-            std::wstring widePath(wideSize - 1, L'\0');
-            MultiByteToWideChar(CP_UTF8, 0, pathStr.c_str(), -1, &widePath[0], wideSize);
-            filePaths.push_back(widePath);
-        }
+        filePaths.push_back(ztools::Utf8ToWide(pathStr));
     }
 
     if (filePaths.empty()) {
@@ -2252,6 +3083,121 @@ Napi::Value SetClipboardFiles(const Napi::CallbackInfo& info) {
     return Napi::Boolean::New(env, true);
 }
 
+// writeClipboard 的写入后端：打开剪贴板之前预先分配好全部 HGLOBAL，
+// 剪贴板打开期间 WriteFormat 只发布对应的句柄，不再分配与复制。未发布（含发布失败）的句柄在析构时释放
+class Win32PreparedWriteBackend : public ztools::ClipboardBackend {
+public:
+    ~Win32PreparedWriteBackend() override {
+        for (const auto& prepared : prepared_) {
+            GlobalFree(prepared.second);
+        }
+    }
+
+    bool Prepare(UINT format, const std::string& data) {
+        HGLOBAL hGlobal = GlobalAlloc(GMEM_MOVEABLE, data.size());
+        void* pData = hGlobal != NULL ? GlobalLock(hGlobal) : NULL;
+        if (pData == NULL) {
+            if (hGlobal != NULL) {
+                GlobalFree(hGlobal);
+            }
+            return false;
+        }
+        memcpy(pData, data.data(), data.size());
+        GlobalUnlock(hGlobal);
+        prepared_.push_back(std::make_pair(format, hGlobal));
+        return true;
+    }
+
+    bool Open() override {
+        // 带重试机制，解决 Windows 11 剪贴板占用问题
+        const int maxRetries = 5;
+        const int retryDelayMs = 50;
+        for (int i = 0; i < maxRetries; i++) {
+            if (OpenClipboard(g_hwnd)) {
+                lockTimer_.reset(new ztools::ClipboardLockTimer(g_clipboardLockStats));
+                return true;
+            }
+            if (i < maxRetries - 1) {
+                Sleep(retryDelayMs);
+            }
+        }
+        return false;
+    }
+
+    void Close() override {
+        CloseClipboard();
+        lockTimer_.reset();
+    }
+
+    std::vector<uint32_t> EnumerateFormats() override {
+        return std::vector<uint32_t>();
+    }
+
+    bool ReadFormat(uint32_t, const Reader&) override {
+        return false;
+    }
+
+    bool Empty() override {
+        return EmptyClipboard() != 0;
+    }
+
+    bool WriteFormat(uint32_t format, const void*, size_t) override {
+        for (auto it = prepared_.begin(); it != prepared_.end(); ++it) {
+            if (it->first != format) {
+                continue;
+            }
+            if (SetClipboardData(format, it->second) == NULL) {
+                return false;  // 句柄仍归本进程所有，析构时释放
+            }
+            // 发布成功后剪贴板接管内存
+            prepared_.erase(it);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    std::vector<std::pair<UINT, HGLOBAL>> prepared_;
+    std::unique_ptr<ztools::ClipboardLockTimer> lockTimer_;
+};
+
+// writeClipboard：在工作线程中编码并分配全部 HGLOBAL，再在一次
+// OpenClipboard/EmptyClipboard/SetClipboardData 事务内发布，监听方只收到一次 WM_CLIPBOARDUPDATE。
+// 任一格式发布失败时再次清空剪贴板（PublishClipboardWrite），不会只留下部分格式
+static bool WriteClipboardRequest(const ztools::ClipboardWriteRequest& request, std::string& error) {
+    static const UINT htmlFormat = RegisterClipboardFormatW(L"HTML Format");
+    static const UINT rtfFormat = RegisterClipboardFormatW(L"Rich Text Format");
+    static const UINT pngFormat = RegisterClipboardFormatW(L"PNG");
+
+    std::vector<ztools::ClipboardWriteBlob> blobs;
+    if (!ztools::BuildClipboardWriteBlobs(request, blobs, &error)) {
+        return false;
+    }
+
+    Win32PreparedWriteBackend backend;
+    std::vector<ztools::ClipboardWriteItem> items;
+    for (const auto& blob : blobs) {
+        UINT format = 0;
+        switch (blob.format) {
+            case ztools::ClipboardWriteFormat::UnicodeText: format = CF_UNICODETEXT; break;
+            case ztools::ClipboardWriteFormat::Html: format = htmlFormat; break;
+            case ztools::ClipboardWriteFormat::Rtf: format = rtfFormat; break;
+            case ztools::ClipboardWriteFormat::Dib: format = CF_DIB; break;
+            case ztools::ClipboardWriteFormat::Png: format = pngFormat; break;
+            case ztools::ClipboardWriteFormat::Files: format = CF_HDROP; break;
+        }
+        if (format == 0) {
+            continue;
+        }
+        if (!backend.Prepare(format, blob.data)) {
+            error = "Failed to allocate memory";
+            return false;
+        }
+        items.push_back(ztools::ClipboardWriteItem{format, &blob.data});
+    }
+    return ztools::PublishClipboardWrite(backend, items, &error);
+}
+
 // ==================== 鼠标监控功能 ====================
 
 // 检查回调返回值中的 shouldBlock 并触发重放
@@ -2727,155 +3673,157 @@ WORD GetVirtualKeyCode(const std::string& key) {
 // UI Automation 接口（延迟加载）
 #include <uiautomation.h>
 #pragma comment(lib, "oleaut32.lib")
-#pragma comment(lib, "crypt32.lib")  // For CryptBinaryToStringA
 
 // ==================== 剪贴板内容读取辅助函数 ====================
 
-// 读取剪贴板文本内容
-std::string GetClipboardTextContent() {
-    std::string result;
-
-    if (!OpenClipboard(NULL)) {
-        return result;
-    }
+// 将位图编码为 PNG 并转为 base64（不访问剪贴板）
+static bool EncodeBitmapToBase64Png(HBITMAP hBitmap, std::string& result) {
+    bool ok = false;
+    Gdiplus::Bitmap* bitmap = Gdiplus::Bitmap::FromHBITMAP(hBitmap, NULL);
+    if (bitmap != NULL) {
+        IStream* pStream = NULL;
+        if (CreateStreamOnHGlobal(NULL, TRUE, &pStream) == S_OK) {
+            CLSID pngClsid;
+            CLSIDFromString(L"{557CF406-1A04-11D3-9A73-0000F81EF32E}", &pngClsid);
 
-    // 尝试读取 Unicode 文本
-    if (IsClipboardFormatAvailable(CF_UNICODETEXT)) {
-        HANDLE hData = GetClipboardData(CF_UNICODETEXT);
-        if (hData != NULL) {
-            wchar_t* pszText = static_cast<wchar_t*>(GlobalLock(hData));
-            if (pszText != NULL) {
-                // 使用 wcslen 获取实际长度，避免越界写入
-                int wideLen = static_cast<int>(wcslen(pszText));
-                int utf8Size = WideCharToMultiByte(CP_UTF8, 0, pszText, wideLen, nullptr, 0, nullptr, nullptr);
-                if (utf8Size > 0) {
-                    result.resize(utf8Size);
-                    WideCharToMultiByte(CP_UTF8, 0, pszText, wideLen, &result[0], utf8Size, nullptr, nullptr);
+            if (bitmap->Save(pStream, &pngClsid, NULL) == Gdiplus::Ok) {
+                HGLOBAL hGlobal = NULL;
+                if (GetHGlobalFromStream(pStream, &hGlobal) == S_OK) {
+                    SIZE_T size = GlobalSize(hGlobal);
+                    void* pData = GlobalLock(hGlobal);
+                    if (pData != NULL) {
+                        // 直接从流的内存编码，不复制 PNG 字节
+                        result = ztools::Base64Encode(pData, size);
+                        ok = size > 0;
+                        GlobalUnlock(hGlobal);
+                    }
                 }
-                GlobalUnlock(hData);
-            }
-        }
-    }
-    // 回退到 ANSI 文本
-    else if (IsClipboardFormatAvailable(CF_TEXT)) {
-        HANDLE hData = GetClipboardData(CF_TEXT);
-        if (hData != NULL) {
-            char* pszText = static_cast<char*>(GlobalLock(hData));
-            if (pszText != NULL) {
-                result = pszText;
-                GlobalUnlock(hData);
             }
+            pStream->Release();
         }
+        delete bitmap;
     }
+    return ok;
+}
 
-    CloseClipboard();
-    return result;
+// 由剪贴板复制出的 CF_DIB 原始字节创建位图
+static HBITMAP CreateBitmapFromDib(const char* dib, size_t size) {
+    size_t pixelOffset = 0;
+    if (!ztools::DibPixelOffset(dib, size, &pixelOffset)) {
+        return NULL;
+    }
+    const BITMAPINFO* pBMI = reinterpret_cast<const BITMAPINFO*>(dib);
+    HDC hDC = GetDC(NULL);
+    HBITMAP hBitmap = CreateDIBitmap(hDC, &pBMI->bmiHeader, CBM_INIT, dib + pixelOffset, pBMI, DIB_RGB_COLORS);
+    ReleaseDC(NULL, hDC);
+    return hBitmap;
 }
 
-// 读取剪贴板图像内容（返回 base64 编码的 PNG）
-std::string GetClipboardImageContent() {
-    std::string result;
+// 将剪贴板复制出的 CF_DIB 原始字节编码为 base64 PNG（在关闭剪贴板之后调用）
+static bool EncodeDibToBase64Png(const char* dib, size_t size, std::string& result) {
+    HBITMAP hBitmap = CreateBitmapFromDib(dib, size);
+    if (hBitmap == NULL) {
+        return false;
+    }
+    bool ok = EncodeBitmapToBase64Png(hBitmap, result);
+    DeleteObject(hBitmap);
+    return ok;
+}
 
-    if (!OpenClipboard(NULL)) {
-        return result;
+// 同上，但返回 PNG 原始字节（readClipboard binary 输出，不做 base64）
+static bool EncodeDibToPng(const std::string& dib, std::string& png) {
+    HBITMAP hBitmap = CreateBitmapFromDib(dib.data(), dib.size());
+    if (hBitmap == NULL) {
+        return false;
     }
+    bool ok = BitmapToPng(hBitmap, png);
+    DeleteObject(hBitmap);
+    return ok;
+}
 
-    HBITMAP hBitmap = NULL;
-    bool mustDeleteBitmap = false; // 标记是否需要删除 hBitmap
-
-    // 尝试获取位图
-    if (IsClipboardFormatAvailable(CF_BITMAP)) {
-        hBitmap = static_cast<HBITMAP>(GetClipboardData(CF_BITMAP));
-    } else if (IsClipboardFormatAvailable(CF_DIB)) {
-        HANDLE hDIB = GetClipboardData(CF_DIB);
-        if (hDIB != NULL) {
-            BITMAPINFO* pBMI = static_cast<BITMAPINFO*>(GlobalLock(hDIB));
-            if (pBMI != NULL) {
-                HDC hDC = GetDC(NULL);
-                void* pBits = reinterpret_cast<BYTE*>(pBMI) + pBMI->bmiHeader.biSize;
-                hBitmap = CreateDIBitmap(hDC, &pBMI->bmiHeader, CBM_INIT, pBits, pBMI, DIB_RGB_COLORS);
-                ReleaseDC(NULL, hDC);
-                GlobalUnlock(hDIB);
-                mustDeleteBitmap = true; // 标记需要删除
-            }
-        }
+// readClipboard：一次打开剪贴板读取 mask 指定的全部格式
+// 锁内只做复制与 UTF-16 → UTF-8 转换，图像 PNG 编码在关闭剪贴板之后进行
+static void ReadClipboardFormats(uint32_t mask, ztools::ClipboardReadResult& result) {
+    static const UINT htmlFormat = RegisterClipboardFormatW(L"HTML Format");
+    static const UINT rtfFormat = RegisterClipboardFormatW(L"Rich Text Format");
+
+    const bool utf16 = (result.output & ztools::kClipboardOutputUtf16) != 0;
+
+    if (!OpenClipboardForMonitor()) {
+        result.sequence = GetClipboardSequenceNumber();
+        return;
     }
+    ztools::ClipboardLockTimer lockTimer(g_clipboardLockStats);
+    result.opened = true;
+    result.sequence = GetClipboardSequenceNumber();
 
-    if (hBitmap != NULL) {
-        // 使用 GDI+ 将位图转换为 PNG base64
-        Gdiplus::Bitmap* bitmap = Gdiplus::Bitmap::FromHBITMAP(hBitmap, NULL);
-        if (bitmap != NULL) {
-            IStream* pStream = NULL;
-            if (CreateStreamOnHGlobal(NULL, TRUE, &pStream) == S_OK) {
-                CLSID pngClsid;
-                CLSIDFromString(L"{557CF406-1A04-11D3-9A73-0000F81EF32E}", &pngClsid);
-
-                if (bitmap->Save(pStream, &pngClsid, NULL) == Gdiplus::Ok) {
-                    HGLOBAL hGlobal = NULL;
-                    if (GetHGlobalFromStream(pStream, &hGlobal) == S_OK) {
-                        SIZE_T size = GlobalSize(hGlobal);
-                        void* pData = GlobalLock(hGlobal);
-                        if (pData != NULL) {
-                            // Base64 编码
-                            DWORD base64Size = 0;
-                            CryptBinaryToStringA(static_cast<BYTE*>(pData), size, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF, NULL, &base64Size);
-                            if (base64Size > 0) {
-                                result.resize(base64Size);
-                                CryptBinaryToStringA(static_cast<BYTE*>(pData), size, CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF, &result[0], &base64Size);
-                                result.resize(base64Size - 1); // 移除 null terminator
-                            }
-                            GlobalUnlock(hGlobal);
-                        }
-                    }
+    if ((mask & ztools::kClipboardReadText) != 0) {
+        if (IsClipboardFormatAvailable(CF_UNICODETEXT)) {
+            HANDLE hData = GetClipboardData(CF_UNICODETEXT);
+            const wchar_t* pszText = hData != NULL ? static_cast<const wchar_t*>(GlobalLock(hData)) : NULL;
+            if (pszText != NULL) {
+                int wideLen = static_cast<int>(wcsnlen(pszText, GlobalSize(hData) / sizeof(wchar_t)));
+                if (utf16) {
+                    // 剪贴板本身就是 UTF-16，原样复制一次，交给 JS 时不再转换
+                    result.text.assign(reinterpret_cast<const char*>(pszText), wideLen * sizeof(wchar_t));
+                } else {
+                    result.text = ztools::WideToUtf8(pszText, wideLen);
                 }
-                pStream->Release();
+                result.hasText = true;
+                GlobalUnlock(hData);
+            }
+        } else if (IsClipboardFormatAvailable(CF_TEXT)) {
+            // CF_TEXT 使用系统 ANSI 代码页：先转 UTF-16，再按输出格式转 UTF-8 或原样保留
+            std::string ansi;
+            result.hasText = ReadClipboardGlobalBytes(CF_TEXT, ansi);
+            const std::wstring wide = AnsiToWide(ansi.data(), static_cast<int>(strnlen(ansi.data(), ansi.size())));
+            if (utf16) {
+                result.text.assign(reinterpret_cast<const char*>(wide.data()), wide.size() * sizeof(wchar_t));
+            } else {
+                result.text = ztools::WideToUtf8(wide);
             }
-            delete bitmap;
         }
+    }
 
-        // 根据标记决定是否删除 hBitmap
-        if (mustDeleteBitmap) {
-            DeleteObject(hBitmap);
-        }
+    if ((mask & ztools::kClipboardReadHtml) != 0 && htmlFormat != 0 && IsClipboardFormatAvailable(htmlFormat)) {
+        result.hasHtml = ReadClipboardGlobalBytes(htmlFormat, result.html);
+        // 去掉 GlobalSize 对齐带来的尾部 NUL
+        result.html.resize(strnlen(result.html.data(), result.html.size()));
     }
 
-    CloseClipboard();
-    return result;
-}
+    if ((mask & ztools::kClipboardReadRtf) != 0 && rtfFormat != 0 && IsClipboardFormatAvailable(rtfFormat)) {
+        result.hasRtf = ReadClipboardGlobalBytes(rtfFormat, result.rtf);
+        result.rtf.resize(strnlen(result.rtf.data(), result.rtf.size()));
+    }
 
-// 读取剪贴板文件列表
-std::vector<std::string> GetClipboardFilesList() {
-    std::vector<std::string> result;
+    std::string dropFiles;
+    if ((mask & ztools::kClipboardReadFiles) != 0 && IsClipboardFormatAvailable(CF_HDROP)) {
+        result.hasFiles = ReadClipboardGlobalBytes(CF_HDROP, dropFiles);
+    }
 
-    if (!OpenClipboard(NULL)) {
-        return result;
+    std::string dib;
+    if ((mask & ztools::kClipboardReadImage) != 0 && IsClipboardFormatAvailable(CF_DIB)) {
+        ReadClipboardGlobalBytes(CF_DIB, dib);
     }
 
-    if (IsClipboardFormatAvailable(CF_HDROP)) {
-        HDROP hDrop = static_cast<HDROP>(GetClipboardData(CF_HDROP));
-        if (hDrop != NULL) {
-            UINT fileCount = DragQueryFileW(hDrop, 0xFFFFFFFF, NULL, 0);
-            for (UINT i = 0; i < fileCount; i++) {
-                UINT pathLen = DragQueryFileW(hDrop, i, NULL, 0);
-                if (pathLen > 0) {
-                    std::wstring wPath(pathLen, L'\0');
-                    DragQueryFileW(hDrop, i, &wPath[0], pathLen + 1);
-
-                    // 使用实际长度进行精确转换，避免越界写入
-                    int wideLen = static_cast<int>(wPath.length());
-                    int utf8Size = WideCharToMultiByte(CP_UTF8, 0, wPath.c_str(), wideLen, nullptr, 0, nullptr, nullptr);
-                    if (utf8Size > 0) {
-                        std::string utf8Path(utf8Size, '\0');
-                        WideCharToMultiByte(CP_UTF8, 0, wPath.c_str(), wideLen, &utf8Path[0], utf8Size, nullptr, nullptr);
-                        result.push_back(utf8Path);
-                    }
-                }
-            }
+    CloseClipboard();
+    result.lockHeldUs = lockTimer.Stop();
+
+    ztools::PackedFileList files;
+    if (!dropFiles.empty() && ParseClipboardDropFiles(dropFiles, files)) {
+        result.files.reserve(files.Count());
+        for (size_t i = 0; i < files.Count(); i++) {
+            result.files.push_back(files.Path(i));
         }
     }
 
-    CloseClipboard();
-    return result;
+    if (!dib.empty()) {
+        if ((result.output & ztools::kClipboardOutputBinary) != 0) {
+            result.hasImage = EncodeDibToPng(dib, result.image);
+        } else {
+            result.hasImage = EncodeDibToBase64Png(dib.data(), dib.size(), result.image);
+        }
+    }
 }
 
 // 模拟复制操作（Ctrl + C）
@@ -2952,14 +3900,11 @@ std::string TryGetSelectedTextViaUIAutomation() {
                 BSTR bstrText = nullptr;
                 hr = pRange->GetText(-1, &bstrText);
                 if (SUCCEEDED(hr) && bstrText) {
-                    // 使用 SysStringLen 获取实际长度，避免越界写入
-                    int wideLen = static_cast<int>(SysStringLen(bstrText));
-                    int utf8Size = WideCharToMultiByte(CP_UTF8, 0, bstrText, wideLen, nullptr, 0, nullptr, nullptr);
-                    if (utf8Size > 0) {
-                        std::string utf8Text(utf8Size, '\0');
-                        WideCharToMultiByte(CP_UTF8, 0, bstrText, wideLen, &utf8Text[0], utf8Size, nullptr, nullptr);
+                    // 使用 SysStringLen 获取实际长度，直接追加到结果末尾
+                    size_t wideLen = SysStringLen(bstrText);
+                    if (wideLen > 0) {
                         if (!selectedText.empty()) selectedText += "\n";
-                        selectedText += utf8Text;
+                        ztools::AppendUtf16AsUtf8(reinterpret_cast<const char16_t*>(bstrText), wideLen, selectedText);
                     }
                     SysFreeString(bstrText);
                 }
@@ -2977,169 +3922,343 @@ std::string TryGetSelectedTextViaUIAutomation() {
     return selectedText;
 }
 
-// 获取选中内容（Windows 实现）
-Napi::Value GetSelectedContent(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
-    Napi::Array result = Napi::Array::New(env);
+// 选中内容（只含原始数据，可在工作线程中生成，再在主线程转换为 JS 数组）
+struct SelectedContent {
+    bool hasText = false;
+    std::string text;
+    bool hasFiles = false;
+    std::vector<std::string> files;
+    bool hasImage = false;
+    std::string image;  // base64 PNG
+    std::string error;  // 无法保存原剪贴板时的错误（此时不模拟复制）
+};
 
-    // 方法1：尝试 UI Automation（适用于标准 Windows 控件）
-    std::string uiaText = TryGetSelectedTextViaUIAutomation();
-    if (!uiaText.empty()) {
-        Napi::Object item = Napi::Object::New(env);
-        item.Set("type", "text");
-        item.Set("data", uiaText);
-        result.Set(uint32_t(0), item);
-        return result;
-    }
+// 同一时间只允许一次模拟复制（同步与异步版本共用），避免相互覆盖剪贴板
+static std::mutex g_selectedContentMutex;
+
+// 以 HGLOBAL 保存数据的剪贴板格式才能按字节复制；
+// 位图/调色板/图元文件等 GDI 句柄格式跳过（CF_BITMAP 等会由系统从 CF_DIB 重新合成）
+static bool IsGlobalMemoryClipboardFormat(UINT format) {
+    switch (format) {
+        case CF_BITMAP:
+        case CF_METAFILEPICT:
+        case CF_PALETTE:
+        case CF_ENHMETAFILE:
+        case CF_OWNERDISPLAY:
+        case CF_DSPBITMAP:
+        case CF_DSPMETAFILEPICT:
+        case CF_DSPENHMETAFILE:
+            return false;
+    }
+    if (format >= CF_PRIVATEFIRST && format <= CF_PRIVATELAST) return false;
+    if (format >= CF_GDIOBJFIRST && format <= CF_GDIOBJLAST) return false;
+    return true;
+}
 
-    // 方法2：回退到剪贴板方法（适用于 Electron/Chromium 应用）
-    // 暂停监控以防止触发自身事件
-    bool wasMonitoring = g_isMonitoring && !g_isPaused;
-    if (wasMonitoring) {
-        g_isPaused = true;
+// Windows 剪贴板后端：原始字节直接在 GlobalLock 的内存上复制，不做任何转换
+class Win32ClipboardBackend : public ztools::ClipboardBackend {
+public:
+    bool Open() override {
+        // 其他程序可能短暂占用剪贴板，重试几次
+        for (int attempt = 0; attempt < 3; attempt++) {
+            if (OpenClipboard(NULL)) {
+                return true;
+            }
+            Sleep(20);
+        }
+        return false;
     }
 
-    // 保存原剪贴板内容
-    std::string originalText = GetClipboardTextContent();
-    std::string originalImage = GetClipboardImageContent();
-    std::vector<std::string> originalFiles = GetClipboardFilesList();
-
-    // 清空剪贴板
-    if (OpenClipboard(NULL)) {
-        EmptyClipboard();
+    void Close() override {
         CloseClipboard();
     }
 
-    // 模拟 Ctrl+C
-    if (SimulateCopyOperation()) {
-        // 等待剪贴板更新
-        Sleep(100);
+    std::vector<uint32_t> EnumerateFormats() override {
+        std::vector<uint32_t> formats;
+        UINT format = 0;
+        while ((format = EnumClipboardFormats(format)) != 0) {
+            formats.push_back(format);
+        }
+        return formats;
+    }
 
-        // 读取新的剪贴板内容
-        std::string newText = GetClipboardTextContent();
-        std::string newImage = GetClipboardImageContent();
-        std::vector<std::string> newFiles = GetClipboardFilesList();
+    bool ReadFormat(uint32_t format, const Reader& reader) override {
+        if (!IsGlobalMemoryClipboardFormat(format)) {
+            return false;
+        }
+        HANDLE hData = GetClipboardData(format);
+        if (hData == NULL) {
+            return false;
+        }
+        SIZE_T size = GlobalSize(hData);
+        void* data = GlobalLock(hData);
+        if (data == NULL) {
+            return false;
+        }
+        reader(data, static_cast<size_t>(size));
+        GlobalUnlock(hData);
+        return true;
+    }
 
-        uint32_t index = 0;
+    bool Empty() override {
+        return EmptyClipboard() != 0;
+    }
 
-        // 检查文本
-        if (!newText.empty() && newText != originalText) {
-            Napi::Object item = Napi::Object::New(env);
-            item.Set("type", "text");
-            item.Set("data", newText);
-            result.Set(index++, item);
+    bool WriteFormat(uint32_t format, const void* data, size_t size) override {
+        HGLOBAL hGlobal = GlobalAlloc(GMEM_MOVEABLE, size > 0 ? size : 1);
+        if (hGlobal == NULL) {
+            return false;
+        }
+        void* dest = GlobalLock(hGlobal);
+        if (dest == NULL) {
+            GlobalFree(hGlobal);
+            return false;
+        }
+        if (size > 0) {
+            memcpy(dest, data, size);
         }
+        GlobalUnlock(hGlobal);
+        if (SetClipboardData(format, hGlobal) == NULL) {
+            GlobalFree(hGlobal); // 失败时释放内存
+            return false;
+        }
+        return true;
+    }
+};
 
-        // 检查文件
-        if (!newFiles.empty()) {
-            bool isDifferent = (newFiles.size() != originalFiles.size());
-            if (!isDifferent) {
-                for (size_t i = 0; i < newFiles.size(); i++) {
-                    if (newFiles[i] != originalFiles[i]) {
-                        isDifferent = true;
-                        break;
-                    }
-                }
-            }
+// CF_UNICODETEXT 原始字节转 UTF-8（截止到第一个空字符）
+static std::string ClipboardUnicodeBytesToUtf8(const char* data, size_t size) {
+    const wchar_t* text = reinterpret_cast<const wchar_t*>(data);
+    int wideLen = static_cast<int>(wcsnlen(text, size / sizeof(wchar_t)));
+    std::string result;
+    result = ztools::WideToUtf8(text, wideLen);
+    return result;
+}
 
-            if (isDifferent) {
-                Napi::Object item = Napi::Object::New(env);
-                item.Set("type", "file");
-                Napi::Array fileArray = Napi::Array::New(env);
-                for (size_t i = 0; i < newFiles.size(); i++) {
-                    fileArray.Set(uint32_t(i), newFiles[i]);
-                }
-                item.Set("data", fileArray);
-                result.Set(index++, item);
-            }
+// 解析 CF_HDROP 原始字节（DROPFILES + 以双空字符结尾的路径列表）
+static std::vector<std::string> ParseDropFilesBytes(const char* data, size_t size) {
+    std::vector<std::string> files;
+    if (size < sizeof(DROPFILES)) {
+        return files;
+    }
+    const DROPFILES* dropFiles = reinterpret_cast<const DROPFILES*>(data);
+    if (dropFiles->pFiles >= size) {
+        return files;
+    }
+
+    const char* p = data + dropFiles->pFiles;
+    const char* end = data + size;
+    if (dropFiles->fWide) {
+        const wchar_t* path = reinterpret_cast<const wchar_t*>(p);
+        const wchar_t* wend = reinterpret_cast<const wchar_t*>(end - (end - p) % sizeof(wchar_t));
+        while (path < wend && *path != L'\0') {
+            size_t wideLen = wcsnlen(path, wend - path);
+            files.push_back(ztools::WideToUtf8(path, wideLen));
+            path += wideLen + 1;
         }
-
-        // 检查图像
-        if (!newImage.empty() && newImage != originalImage) {
-            Napi::Object item = Napi::Object::New(env);
-            item.Set("type", "image");
-            item.Set("data", newImage);
-            item.Set("format", "png");
-            item.Set("encoding", "base64");
-            result.Set(index++, item);
+    } else {
+        // ANSI 路径：先按系统代码页转为宽字符
+        while (p < end && *p != '\0') {
+            int ansiLen = static_cast<int>(strnlen(p, end - p));
+            std::wstring wide = AnsiToWide(p, ansiLen);
+            if (!wide.empty()) {
+                files.push_back(ztools::WideToUtf8(wide));
+            }
+            p += ansiLen + 1;
         }
     }
+    return files;
+}
 
-    // 恢复原剪贴板内容
-    if (OpenClipboard(NULL)) {
-        EmptyClipboard();
+// 获取选中内容：UI Automation 优先，失败时保存剪贴板 → 模拟 Ctrl+C → 等待序列号变化 → 读取 → 恢复
+// 不涉及 N-API，可在工作线程中执行
+static void CaptureSelectedContent(const ztools::SequenceWaitOptions& waitOptions, SelectedContent& content) {
+    std::lock_guard<std::mutex> lock(g_selectedContentMutex);
 
-        // 恢复文本
-        if (!originalText.empty()) {
-            int wideSize = MultiByteToWideChar(CP_UTF8, 0, originalText.c_str(), -1, nullptr, 0);
-            if (wideSize > 0) {
-                HGLOBAL hGlobal = GlobalAlloc(GMEM_MOVEABLE, wideSize * sizeof(wchar_t));
-                if (hGlobal != NULL) {
-                    wchar_t* pData = static_cast<wchar_t*>(GlobalLock(hGlobal));
-                    if (pData != NULL) {
-                        MultiByteToWideChar(CP_UTF8, 0, originalText.c_str(), -1, pData, wideSize);
-                        GlobalUnlock(hGlobal);
-                        if (SetClipboardData(CF_UNICODETEXT, hGlobal) == NULL) {
-                            GlobalFree(hGlobal); // 失败时释放内存
-                        }
-                    } else {
-                        GlobalFree(hGlobal); // GlobalLock 失败时释放内存
-                    }
-                }
-            }
+    // 方法1：尝试 UI Automation（适用于标准 Windows 控件）
+    std::string uiaText = TryGetSelectedTextViaUIAutomation();
+    if (!uiaText.empty()) {
+        content.hasText = true;
+        content.text = std::move(uiaText);
+        return;
+    }
+
+    // 方法2：回退到剪贴板方法（适用于 Electron/Chromium 应用）
+    // 登记自身写入：清空、模拟复制与恢复产生的序列号不会通知 JS，
+    // 恢复完成后用户的下一次复制照常通知（不再暂停监控并延迟恢复）
+    ztools::ClipboardSelfWriteScope selfWrite(g_clipboardDetector, ztools::ClipboardSource::Clipboard,
+                                              []() { return static_cast<uint64_t>(GetClipboardSequenceNumber()); });
+
+    // 用于判断复制是否产生新内容的格式：比较长度 + 原始字节的 64 位哈希，不解码、不编码
+    const std::vector<uint32_t> diffFormats = {CF_UNICODETEXT, CF_HDROP, CF_DIB};
+
+    // 保存原剪贴板：所有格式的原始字节（无法保存时不继续，避免覆盖用户数据后无法恢复）
+    Win32ClipboardBackend backend;
+    ztools::ClipboardSnapshot original;
+    ztools::ClipboardSnapshotOptions originalOptions;
+    originalOptions.hashFormats = diffFormats;
+    if (original.Capture(backend, originalOptions)) {
+        // 清空剪贴板
+        if (backend.Open()) {
+            backend.Empty();
+            backend.Close();
         }
 
-        // 恢复文件列表
-        if (!originalFiles.empty()) {
-            size_t totalSize = sizeof(DROPFILES);
-            for (const auto& file : originalFiles) {
-                int wideSize = MultiByteToWideChar(CP_UTF8, 0, file.c_str(), -1, nullptr, 0);
-                totalSize += wideSize * sizeof(wchar_t);
-            }
-            totalSize += sizeof(wchar_t); // 额外的 null terminator
+        // 模拟 Ctrl+C，等待目标程序写入（序列号变化且写入完成），而不是固定等待
+        DWORD baseline = GetClipboardSequenceNumber();
+        if (SimulateCopyOperation()) {
+            ztools::SequenceWaiter waiter([]() { return static_cast<uint64_t>(GetClipboardSequenceNumber()); });
+            ztools::SequenceWaitResult waited = waiter.Wait(baseline, waitOptions);
+
+            // 位图与原剪贴板相同时只哈希，不同时在同一次读取内完整复制；文本与文件列表很小，直接保存以便解码
+            ztools::ClipboardSnapshot copied;
+            ztools::ClipboardSnapshotOptions copiedOptions;
+            copiedOptions.formats = diffFormats;
+            copiedOptions.hashFormats = diffFormats;
+            copiedOptions.hashOnly = {CF_DIB};
+            copiedOptions.baseline = &original;
+            if (waited.changed && copied.Capture(backend, copiedOptions)) {
+                // 检查文本
+                const ztools::ClipboardSnapshot::Entry* text = copied.Find(CF_UNICODETEXT);
+                if (text != nullptr && !ztools::ClipboardSnapshot::SameContent(text, original.Find(CF_UNICODETEXT))) {
+                    content.text = ClipboardUnicodeBytesToUtf8(text->data, text->size);
+                    content.hasText = !content.text.empty();
+                }
 
-            HGLOBAL hGlobal = GlobalAlloc(GMEM_MOVEABLE, totalSize);
-            if (hGlobal != NULL) {
-                DROPFILES* pDropFiles = static_cast<DROPFILES*>(GlobalLock(hGlobal));
-                if (pDropFiles != NULL) {
-                    pDropFiles->pFiles = sizeof(DROPFILES);
-                    pDropFiles->pt.x = 0;
-                    pDropFiles->pt.y = 0;
-                    pDropFiles->fNC = FALSE;
-                    pDropFiles->fWide = TRUE;
-
-                    wchar_t* pData = reinterpret_cast<wchar_t*>(reinterpret_cast<BYTE*>(pDropFiles) + sizeof(DROPFILES));
-                    size_t remainingChars = (totalSize - sizeof(DROPFILES)) / sizeof(wchar_t);
-                    for (const auto& file : originalFiles) {
-                        int wideSize = MultiByteToWideChar(CP_UTF8, 0, file.c_str(), -1, pData, static_cast<int>(remainingChars));
-                        pData += wideSize;
-                        remainingChars -= wideSize;
-                    }
-                    *pData = L'\0';
+                // 检查文件
+                const ztools::ClipboardSnapshot::Entry* drop = copied.Find(CF_HDROP);
+                if (drop != nullptr && !ztools::ClipboardSnapshot::SameContent(drop, original.Find(CF_HDROP))) {
+                    content.files = ParseDropFilesBytes(drop->data, drop->size);
+                    content.hasFiles = !content.files.empty();
+                }
 
-                    GlobalUnlock(hGlobal);
-                    if (SetClipboardData(CF_HDROP, hGlobal) == NULL) {
-                        GlobalFree(hGlobal); // 失败时释放内存
-                    }
-                } else {
-                    GlobalFree(hGlobal); // GlobalLock 失败时释放内存
+                // 检查图像：只有确实变化的新图像才从已复制的字节编码一次 PNG + base64
+                const ztools::ClipboardSnapshot::Entry* dib = copied.Find(CF_DIB);
+                if (dib != nullptr && dib->data != nullptr &&
+                    !ztools::ClipboardSnapshot::SameContent(dib, original.Find(CF_DIB))) {
+                    content.hasImage = EncodeDibToBase64Png(dib->data, dib->size, content.image);
                 }
             }
         }
 
-        CloseClipboard();
+        // 恢复原剪贴板内容：同一次会话内逐字节写回全部格式
+        original.Restore(backend);
+    } else {
+        // 剪贴板被其他程序占用：不清空、不模拟复制，否则用户数据无法恢复
+        content.error = "Failed to save the clipboard before copying the selection";
+    }
+}
+
+static Napi::Array CreateSelectedContentArray(Napi::Env env, const SelectedContent& content) {
+    Napi::Array result = Napi::Array::New(env);
+    uint32_t index = 0;
+
+    if (content.hasText) {
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("type", "text");
+        item.Set("data", content.text);
+        result.Set(index++, item);
     }
 
-    // 恢复监控状态
-    if (wasMonitoring) {
-        // 延迟恢复，避免立即触发监听
-        Sleep(50);
-        g_isPaused = false;
+    if (content.hasFiles) {
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("type", "file");
+        Napi::Array fileArray = Napi::Array::New(env);
+        for (size_t i = 0; i < content.files.size(); i++) {
+            fileArray.Set(uint32_t(i), content.files[i]);
+        }
+        item.Set("data", fileArray);
+        result.Set(index++, item);
     }
 
+    if (content.hasImage) {
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("type", "image");
+        item.Set("data", content.image);
+        item.Set("format", "png");
+        item.Set("encoding", "base64");
+        result.Set(index++, item);
+    }
     return result;
 }
 
+// 解析 { timeoutMs?: number, settleMs?: number }
+static bool ParseSelectedContentOptions(const Napi::CallbackInfo& info, ztools::SequenceWaitOptions& options) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || info[0].IsUndefined() || info[0].IsNull()) {
+        return true;
+    }
+    if (!info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected an options object").ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Object obj = info[0].As<Napi::Object>();
+    if (obj.Has("timeoutMs") && obj.Get("timeoutMs").IsNumber()) {
+        double timeoutMs = obj.Get("timeoutMs").As<Napi::Number>().DoubleValue();
+        options.timeoutUs = timeoutMs > 0 ? static_cast<uint64_t>(timeoutMs * 1000) : 0;
+    }
+    if (obj.Has("settleMs") && obj.Get("settleMs").IsNumber()) {
+        double settleMs = obj.Get("settleMs").As<Napi::Number>().DoubleValue();
+        options.settleUs = settleMs > 0 ? static_cast<uint64_t>(settleMs * 1000) : 0;
+    }
+    return true;
+}
+
+// 获取选中内容（Windows 实现，同步）
+// 参数：{ timeoutMs?: number, settleMs?: number }（可选）
+Napi::Value GetSelectedContent(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ztools::SequenceWaitOptions options;
+    if (!ParseSelectedContentOptions(info, options)) {
+        return env.Undefined();
+    }
+    SelectedContent content;
+    CaptureSelectedContent(options, content);
+    if (!content.error.empty()) {
+        Napi::Error::New(env, content.error).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    return CreateSelectedContentArray(env, content);
+}
+
+class SelectedContentWorker : public Napi::AsyncWorker {
+    public:
+        SelectedContentWorker(const ztools::SequenceWaitOptions& options, Napi::Env env, Napi::Promise::Deferred deferred)
+            : Napi::AsyncWorker(env), options_(options), deferred_(deferred) {}
+        void Execute() override {
+            CaptureSelectedContent(options_, content_);
+            if (!content_.error.empty()) {
+                SetError(content_.error);
+            }
+        }
+        void OnOK() override {
+            deferred_.Resolve(CreateSelectedContentArray(Env(), content_));
+        }
+        void OnError(const Napi::Error& e) override {
+            deferred_.Reject(e.Value());
+        }
+    private:
+        ztools::SequenceWaitOptions options_;
+        SelectedContent content_;
+        Napi::Promise::Deferred deferred_;
+};
+
+// 获取选中内容（异步）：整个保存/复制/读取/恢复过程在工作线程执行
+// 参数：{ timeoutMs?: number, settleMs?: number }（可选）
+// 返回：Promise<Array>，结果与 getSelectedContent 相同
+Napi::Value GetSelectedContentAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ztools::SequenceWaitOptions options;
+    if (!ParseSelectedContentOptions(info, options)) {
+        return env.Undefined();
+    }
+
+    auto deferred = Napi::Promise::Deferred::New(env);
+    auto* worker = new SelectedContentWorker(options, env, deferred);
+    worker->Queue();
+    return deferred.Promise();
+}
+
 // 模拟粘贴操作（Ctrl + V）
 Napi::Value SimulatePaste(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
@@ -3441,69 +4560,15 @@ Napi::Value SimulateMouseRightClick(const Napi::CallbackInfo& info) {
 
 // ==================== UWP 应用功能 ====================
 
-// 辅助函数：宽字符串转 UTF-8
-static std::string WideToUtf8(const std::wstring& wstr) {
-    if (wstr.empty()) return "";
-    int size = WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, NULL, 0, NULL, NULL);
-    if (size <= 0) return "";
-    std::string utf8(size - 1, 0);
-    WideCharToMultiByte(CP_UTF8, 0, wstr.c_str(), -1, &utf8[0], size, NULL, NULL);
-    return utf8;
-}
-
-// 辅助函数：解码 XML 实体（&amp; &#xHHHH; &#DDD; 等）
+// 辅助函数：解码宽字符串中残留的 XML 实体（ResolveIndirectString 的结果可能仍带实体）
 static std::wstring DecodeXmlEntities(const std::wstring& input) {
-    std::wstring result;
-    result.reserve(input.size());
-    size_t i = 0;
-    while (i < input.size()) {
-        if (input[i] == L'&') {
-            size_t semi = input.find(L';', i + 1);
-            if (semi != std::wstring::npos && semi - i < 12) {
-                std::wstring entity = input.substr(i + 1, semi - i - 1);
-                if (entity == L"amp") {
-                    result += L'&';
-                } else if (entity == L"lt") {
-                    result += L'<';
-                } else if (entity == L"gt") {
-                    result += L'>';
-                } else if (entity == L"quot") {
-                    result += L'"';
-                } else if (entity == L"apos") {
-                    result += L'\'';
-                } else if (entity.size() > 1 && entity[0] == L'#') {
-                    // 数字字符引用
-                    unsigned long codePoint = 0;
-                    if (entity[1] == L'x' || entity[1] == L'X') {
-                        // 十六进制 &#xHHHH;
-                        codePoint = wcstoul(entity.c_str() + 2, nullptr, 16);
-                    } else {
-                        // 十进制 &#DDDD;
-                        codePoint = wcstoul(entity.c_str() + 1, nullptr, 10);
-                    }
-                    if (codePoint > 0 && codePoint <= 0xFFFF) {
-                        result += static_cast<wchar_t>(codePoint);
-                    } else if (codePoint > 0xFFFF && codePoint <= 0x10FFFF) {
-                        // UTF-16 代理对
-                        codePoint -= 0x10000;
-                        result += static_cast<wchar_t>(0xD800 + (codePoint >> 10));
-                        result += static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF));
-                    } else {
-                        // 无效的代码点，保留原样
-                        result += input.substr(i, semi - i + 1);
-                    }
-                } else {
-                    // 未知实体，保留原样
-                    result += input.substr(i, semi - i + 1);
-                }
-                i = semi + 1;
-                continue;
-            }
-        }
-        result += input[i];
-        i++;
+    if (input.find(L'&') == std::wstring::npos) {
+        return input;
     }
-    return result;
+    const std::string utf8 = ztools::WideToUtf8(input);
+    std::string decoded;
+    ztools::AppendXmlDecoded(utf8.data(), utf8.size(), decoded);
+    return ztools::Utf8ToWide(decoded);
 }
 
 // 辅助函数：解析 ms-resource 间接字符串
@@ -3648,58 +4713,26 @@ static std::wstring GetPackageFamilyNameFromFullName(const std::wstring& fullNam
     return name + L"_" + publisherId;
 }
 
-// 辅助函数：简单 XML 属性提取
-static std::wstring GetXmlAttribute(const std::wstring& xml, const std::wstring& tag, const std::wstring& attr) {
-    // 查找 <tag ... attr="value" ...>
-    size_t searchPos = 0;
-    while (searchPos < xml.size()) {
-        size_t tagStart = xml.find(L"<" + tag, searchPos);
-        if (tagStart == std::wstring::npos) break;
-
-        size_t tagEnd = xml.find(L'>', tagStart);
-        if (tagEnd == std::wstring::npos) break;
-
-        std::wstring tagContent = xml.substr(tagStart, tagEnd - tagStart + 1);
-        std::wstring attrSearch = attr + L"=\"";
-        size_t attrPos = tagContent.find(attrSearch);
-        if (attrPos != std::wstring::npos) {
-            size_t valueStart = attrPos + attrSearch.length();
-            size_t valueEnd = tagContent.find(L'"', valueStart);
-            if (valueEnd != std::wstring::npos) {
-                return tagContent.substr(valueStart, valueEnd - valueStart);
-            }
-        }
-        searchPos = tagEnd + 1;
-    }
-    return L"";
-}
-
-// 辅助函数：读取文件内容为宽字符串
-static std::wstring ReadFileToWString(const std::wstring& path) {
+// 辅助函数：读取文件原始字节（AppxManifest 直接按 UTF-8 解析，不再整体转宽字符）
+static bool ReadFileBytes(const std::wstring& path, std::string& out) {
     HANDLE hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
-    if (hFile == INVALID_HANDLE_VALUE) return L"";
+    if (hFile == INVALID_HANDLE_VALUE) return false;
 
     DWORD fileSize = GetFileSize(hFile, NULL);
     if (fileSize == INVALID_FILE_SIZE || fileSize == 0) {
         CloseHandle(hFile);
-        return L"";
+        return false;
     }
 
-    std::vector<char> buffer(fileSize + 1, 0);
+    out.resize(fileSize);
     DWORD bytesRead = 0;
-    if (!ReadFile(hFile, buffer.data(), fileSize, &bytesRead, NULL)) {
-        CloseHandle(hFile);
-        return L"";
-    }
+    BOOL ok = ReadFile(hFile, &out[0], fileSize, &bytesRead, NULL);
     CloseHandle(hFile);
-
-    // 将 UTF-8 转换为宽字符串
-    int wideLen = MultiByteToWideChar(CP_UTF8, 0, buffer.data(), bytesRead, NULL, 0);
-    if (wideLen <= 0) return L"";
-
-    std::wstring result(wideLen, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, buffer.data(), bytesRead, &result[0], wideLen);
-    return result;
+    if (!ok) {
+        return false;
+    }
+    out.resize(bytesRead);
+    return bytesRead > 0;
 }
 
 // 获取 UWP 应用列表
@@ -3723,6 +4756,7 @@ Napi::Value GetUwpApps(const Napi::CallbackInfo& info) {
     RegQueryInfoKeyW(hKeyRepo, NULL, NULL, NULL, &subKeyCount, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
 
     uint32_t appIndex = 0;
+    std::string manifestBytes;  // 跨包复用读取缓冲区
 
     for (DWORD i = 0; i < subKeyCount; i++) {
         WCHAR subKeyName[512] = {0};
@@ -3752,15 +4786,16 @@ Napi::Value GetUwpApps(const Napi::CallbackInfo& info) {
 
         RegCloseKey(hKeyPkg);
 
-        // 读取 AppxManifest.xml
+        // 读取并解析 AppxManifest.xml（单遍扫描，只复制需要的字段）
         std::wstring manifestPath = std::wstring(installLocation) + L"\\AppxManifest.xml";
-        std::wstring manifestContent = ReadFileToWString(manifestPath);
-        if (manifestContent.empty()) {
+        if (!ReadFileBytes(manifestPath, manifestBytes)) {
             continue;
         }
+        ztools::AppxManifest manifest;
+        ztools::ParseAppxManifest(manifestBytes.data(), manifestBytes.size(), manifest);
 
         // 跳过没有 <Applications> 的框架包
-        if (manifestContent.find(L"<Applications>") == std::wstring::npos) {
+        if (!manifest.hasApplications || manifest.framework) {
             continue;
         }
 
@@ -3769,16 +4804,8 @@ Napi::Value GetUwpApps(const Napi::CallbackInfo& info) {
         std::wstring familyName = GetPackageFamilyNameFromFullName(packageFullName);
 
         // 解析 DisplayName
-        // 先尝试从 manifest 中获取 DisplayName 的 ms-resource 用于更好的解析
-        std::wstring manifestDisplayName = GetXmlAttribute(manifestContent, L"Properties", L"");
-        // 从 <DisplayName> 标签中获取值
-        size_t dnStart = manifestContent.find(L"<DisplayName>");
-        size_t dnEnd = manifestContent.find(L"</DisplayName>");
-        std::wstring msResourceName;
-        if (dnStart != std::wstring::npos && dnEnd != std::wstring::npos) {
-            dnStart += 13; // len("<DisplayName>")
-            msResourceName = DecodeXmlEntities(manifestContent.substr(dnStart, dnEnd - dnStart));
-        }
+        // 先用 manifest <Properties><DisplayName> 的 ms-resource 辅助解析（实体已解码）
+        std::wstring msResourceName = ztools::Utf8ToWide(manifest.displayName);
 
         std::wstring resolvedName = ResolveIndirectString(std::wstring(displayName), packageFullName, msResourceName);
         if (resolvedName.empty() && !msResourceName.empty()) {
@@ -3791,55 +4818,25 @@ Napi::Value GetUwpApps(const Napi::CallbackInfo& info) {
         // 解码包级别名称中可能存在的 XML 实体
         resolvedName = DecodeXmlEntities(resolvedName);
 
-        // 从 manifest 中提取所有 Application 条目
-        size_t searchPos = 0;
-        while (searchPos < manifestContent.size()) {
-            size_t appTagStart = manifestContent.find(L"<Application ", searchPos);
-            if (appTagStart == std::wstring::npos) break;
-
-            // 找到这个 Application 标签结束的位置
-            size_t appBlockEnd = manifestContent.find(L"</Application>", appTagStart);
-            if (appBlockEnd == std::wstring::npos) {
-                // 可能是自闭合标签
-                appBlockEnd = manifestContent.find(L"/>", appTagStart);
-                if (appBlockEnd == std::wstring::npos) break;
-                appBlockEnd += 2;
-            } else {
-                appBlockEnd += 14; // len("</Application>")
-            }
-
-            std::wstring appBlock = manifestContent.substr(appTagStart, appBlockEnd - appTagStart);
-
-            // 提取 Application Id
-            std::wstring appId = GetXmlAttribute(appBlock, L"Application", L"Id");
-            if (appId.empty()) {
-                searchPos = appBlockEnd;
+        // 遍历 manifest 中的所有 Application 条目
+        for (const ztools::AppxManifestApplication& app : manifest.applications) {
+            if (app.id.empty()) {
                 continue;
             }
-            std::wstring executableRelPath = GetXmlAttribute(appBlock, L"Application", L"Executable");
-
-            // 检查 AppListEntry 属性，跳过标记为 "none" 的内部入口
-            std::wstring appListEntry = GetXmlAttribute(appBlock, L"uap:VisualElements", L"AppListEntry");
-            if (appListEntry.empty()) {
-                appListEntry = GetXmlAttribute(appBlock, L"VisualElements", L"AppListEntry");
-            }
-            if (appListEntry == L"none") {
-                searchPos = appBlockEnd;
+            // 跳过 AppListEntry="none" 的内部入口
+            if (app.appListEntry == "none") {
                 continue;
             }
+            std::wstring appId = ztools::Utf8ToWide(app.id);
+            std::wstring executableRelPath = ztools::Utf8ToWide(app.executable);
 
             // 构建 AppUserModelID: PackageFamilyName!ApplicationId
             std::wstring aumid = familyName + L"!" + appId;
 
-            // 优先从 Application 的 VisualElements 中读取 DisplayName（每个入口可能不同）
+            // 优先使用 Application 的 VisualElements DisplayName（每个入口可能不同，实体已解码）
             std::wstring appDisplayName;
-            std::wstring veDisplayName = GetXmlAttribute(appBlock, L"uap:VisualElements", L"DisplayName");
-            if (veDisplayName.empty()) {
-                veDisplayName = GetXmlAttribute(appBlock, L"VisualElements", L"DisplayName");
-            }
-            if (!veDisplayName.empty()) {
-                // 先解码 XML 实体（如 &amp; &#x7535; 等）
-                veDisplayName = DecodeXmlEntities(veDisplayName);
+            if (!app.displayName.empty()) {
+                std::wstring veDisplayName = ztools::Utf8ToWide(app.displayName);
                 // 可能是 ms-resource:XXX 格式，需要解析
                 if (veDisplayName.find(L"ms-resource:") == 0) {
                     appDisplayName = ResolveIndirectString(L"", packageFullName, veDisplayName);
@@ -3852,20 +4849,9 @@ Napi::Value GetUwpApps(const Napi::CallbackInfo& info) {
                 appDisplayName = resolvedName;
             }
 
-            // 提取图标路径（从 VisualElements 或 uap:VisualElements）
-            std::wstring logoRelPath;
-            // 先尝试 Square44x44Logo（应用列表图标）
-            logoRelPath = GetXmlAttribute(appBlock, L"uap:VisualElements", L"Square44x44Logo");
-            if (logoRelPath.empty()) {
-                logoRelPath = GetXmlAttribute(appBlock, L"VisualElements", L"Square44x44Logo");
-            }
-            // 如果没有 44x44，尝试 150x150
-            if (logoRelPath.empty()) {
-                logoRelPath = GetXmlAttribute(appBlock, L"uap:VisualElements", L"Square150x150Logo");
-                if (logoRelPath.empty()) {
-                    logoRelPath = GetXmlAttribute(appBlock, L"VisualElements", L"Square150x150Logo");
-                }
-            }
+            // 图标路径：优先 Square44x44Logo（应用列表图标），没有则用 Square150x150Logo
+            std::wstring logoRelPath = ztools::Utf8ToWide(
+                app.square44x44Logo.empty() ? app.square150x150Logo : app.square44x44Logo);
 
             // 查找实际的图标文件
             std::wstring iconFullPath = FindBestLogo(std::wstring(installLocation), logoRelPath);
@@ -3880,20 +4866,17 @@ Napi::Value GetUwpApps(const Napi::CallbackInfo& info) {
 
             // 跳过没有图标的应用（通常是系统基础设施组件，如 Win32WebViewHost）
             if (iconFullPath.empty()) {
-                searchPos = appBlockEnd;
                 continue;
             }
 
             // 创建应用信息对象
             Napi::Object appInfo = Napi::Object::New(env);
-            appInfo.Set("name", Napi::String::New(env, WideToUtf8(appDisplayName)));
-            appInfo.Set("appId", Napi::String::New(env, WideToUtf8(aumid)));
-            appInfo.Set("icon", Napi::String::New(env, WideToUtf8(iconFullPath)));
-            appInfo.Set("installLocation", Napi::String::New(env, WideToUtf8(std::wstring(installLocation))));
+            appInfo.Set("name", Napi::String::New(env, ztools::WideToUtf8(appDisplayName)));
+            appInfo.Set("appId", Napi::String::New(env, ztools::WideToUtf8(aumid)));
+            appInfo.Set("icon", Napi::String::New(env, ztools::WideToUtf8(iconFullPath)));
+            appInfo.Set("installLocation", Napi::String::New(env, ztools::WideToUtf8(installLocation)));
 
             result.Set(appIndex++, appInfo);
-
-            searchPos = appBlockEnd;
         }
     }
 
@@ -3913,12 +4896,7 @@ Napi::Value LaunchUwpApp(const Napi::CallbackInfo& info) {
     std::string appIdUtf8 = info[0].As<Napi::String>().Utf8Value();
 
     // 转换为宽字符
-    int wideSize = MultiByteToWideChar(CP_UTF8, 0, appIdUtf8.c_str(), -1, NULL, 0);
-    if (wideSize <= 0) {
-        return Napi::Boolean::New(env, false);
-    }
-    std::wstring appIdWide(wideSize - 1, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, appIdUtf8.c_str(), -1, &appIdWide[0], wideSize);
+    std::wstring appIdWide = ztools::Utf8ToWide(appIdUtf8);
 
     // 使用 IApplicationActivationManager 启动 UWP 应用
     CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
@@ -4307,9 +5285,7 @@ Napi::Value GetFileIcon(const Napi::CallbackInfo& info) {
     }
 
     std::string path = info[0].As<Napi::String>().Utf8Value();
-    int size = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, NULL, 0);
-    std::wstring wpath(size - 1, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wpath[0], size);
+    std::wstring wpath = ztools::Utf8ToWide(path);
 
     auto deferred = Napi::Promise::Deferred::New(env);
     auto* worker = new IconWorker(wpath, env,deferred);
@@ -4411,22 +5387,10 @@ Napi::Value ResolveMuiStrings(const Napi::CallbackInfo& info) {
 
         std::string refUtf8 = val.As<Napi::String>().Utf8Value();
 
-        // UTF-8 转宽字符
-        int wideSize = MultiByteToWideChar(CP_UTF8, 0, refUtf8.c_str(), -1, NULL, 0);
-        if (wideSize <= 0) continue;
-        std::wstring refWide(wideSize - 1, L'\0');
-        MultiByteToWideChar(CP_UTF8, 0, refUtf8.c_str(), -1, &refWide[0], wideSize);
-
-        std::wstring resolved = ResolveSingleMui(refWide);
+        std::wstring resolved = ResolveSingleMui(ztools::Utf8ToWide(refUtf8));
         if (resolved.empty()) continue;
 
-        // 宽字符转 UTF-8
-        int utf8Size = WideCharToMultiByte(CP_UTF8, 0, resolved.c_str(), -1, NULL, 0, NULL, NULL);
-        if (utf8Size <= 0) continue;
-        std::string resolvedUtf8(utf8Size - 1, 0);
-        WideCharToMultiByte(CP_UTF8, 0, resolved.c_str(), -1, &resolvedUtf8[0], utf8Size, NULL, NULL);
-
-        result.Set(refUtf8, Napi::String::New(env, resolvedUtf8));
+        result.Set(refUtf8, Napi::String::New(env, ztools::WideToUtf8(resolved)));
     }
 
     return result;
@@ -4924,12 +5888,7 @@ Napi::Value UnicodeType(const Napi::CallbackInfo& info) {
     std::string text = info[0].As<Napi::String>().Utf8Value();
 
     // UTF-8 转 UTF-16
-    int wideSize = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, NULL, 0);
-    if (wideSize <= 0) {
-        return Napi::Boolean::New(env, false);
-    }
-    std::wstring wtext(wideSize - 1, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, &wtext[0], wideSize);
+    std::wstring wtext = ztools::Utf8ToWide(text);
 
     std::vector<INPUT> inputs;
     for (wchar_t ch : wtext) {
@@ -5025,14 +5984,7 @@ Napi::Value GetExplorerFolderPath(const Napi::CallbackInfo& info) {
                 hr = browser->get_LocationURL(&url);
                 if (SUCCEEDED(hr) && url) {
                     // 将 BSTR (UTF-16) 转换为 UTF-8 字符串
-                    int len = SysStringLen(url);
-                    if (len > 0) {
-                        int size = WideCharToMultiByte(CP_UTF8, 0, url, len, NULL, 0, NULL, NULL);
-                        if (size > 0) {
-                            result.resize(size);
-                            WideCharToMultiByte(CP_UTF8, 0, url, len, &result[0], size, NULL, NULL);
-                        }
-                    }
+                    result = ztools::WideToUtf8(url, SysStringLen(url));
                     SysFreeString(url);
                 }
                 browser->Release();
@@ -5057,8 +6009,6 @@ Napi::Value GetExplorerFolderPath(const Napi::CallbackInfo& info) {
     return Napi::String::New(env, result);
 }
 
-std::wstring Utf8ToWideString(const std::string& input);
-std::string WideToUtf8String(const std::wstring& input);
 
 static std::string FileUrlToPath(const std::wstring& fileUrl) {
     DWORD pathLength = 32768;
@@ -5068,7 +6018,7 @@ static std::string FileUrlToPath(const std::wstring& fileUrl) {
         return std::string();
     }
     path.resize(pathLength);
-    return WideToUtf8String(path);
+    return ztools::WideToUtf8(path);
 }
 
 /**
@@ -5128,7 +6078,7 @@ Napi::Value GetAllExplorerWindows(const Napi::CallbackInfo& info) {
             hr = browser->get_LocationURL(&url);
             if (SUCCEEDED(hr) && url) {
                 std::wstring urlWide(url, SysStringLen(url));
-                std::string urlStr = WideToUtf8String(urlWide);
+                std::string urlStr = ztools::WideToUtf8(urlWide);
                 if (urlStr.rfind("file://", 0) == 0 && browserHwnd && IsWindow(browserHwnd)) {
                     WCHAR title[512] = {0};
                     WCHAR className[256] = {0};
@@ -5145,8 +6095,8 @@ Napi::Value GetAllExplorerWindows(const Napi::CallbackInfo& info) {
                     if (!pathStr.empty()) {
                         item.Set("path", Napi::String::New(env, pathStr));
                     }
-                    item.Set("title", Napi::String::New(env, WideToUtf8String(title)));
-                    item.Set("className", Napi::String::New(env, WideToUtf8String(className)));
+                    item.Set("title", Napi::String::New(env, ztools::WideToUtf8(title)));
+                    item.Set("className", Napi::String::New(env, ztools::WideToUtf8(className)));
                     item.Set("app", Napi::String::New(env, "explorer.exe"));
                     results.push_back(item);
                 }
@@ -5464,7 +6414,7 @@ Napi::Value SetAddressBar(const Napi::CallbackInfo& info) {
     uint64_t hwndValue = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
     HWND targetHwnd = reinterpret_cast<HWND>(hwndValue);
     std::string addressUtf8 = info[1].As<Napi::String>().Utf8Value();
-    std::wstring address = Utf8ToWideString(addressUtf8);
+    std::wstring address = ztools::Utf8ToWide(addressUtf8);
 
     if (address.empty() || !IsFileLocationWindow(targetHwnd)) {
         return Napi::Boolean::New(env, false);
@@ -5493,36 +6443,6 @@ Napi::Value SetAddressBar(const Napi::CallbackInfo& info) {
 
 // ==================== 浏览器 URL 查询 ====================
 
-std::wstring Utf8ToWideString(const std::string& input) {
-    if (input.empty()) {
-        return std::wstring();
-    }
-
-    int size = MultiByteToWideChar(CP_UTF8, 0, input.c_str(), -1, nullptr, 0);
-    if (size <= 0) {
-        return std::wstring();
-    }
-
-    std::wstring result(size - 1, L'\0');
-    MultiByteToWideChar(CP_UTF8, 0, input.c_str(), -1, &result[0], size);
-    return result;
-}
-
-std::string WideToUtf8String(const std::wstring& input) {
-    if (input.empty()) {
-        return std::string();
-    }
-
-    int size = WideCharToMultiByte(CP_UTF8, 0, input.c_str(), -1, nullptr, 0, nullptr, nullptr);
-    if (size <= 0) {
-        return std::string();
-    }
-
-    std::string result(size - 1, '\0');
-    WideCharToMultiByte(CP_UTF8, 0, input.c_str(), -1, &result[0], size, nullptr, nullptr);
-    return result;
-}
-
 std::wstring ToLowerWideString(std::wstring value) {
     std::transform(value.begin(), value.end(), value.begin(), [](wchar_t ch) {
         return static_cast<wchar_t>(std::towlower(ch));
@@ -5530,67 +6450,24 @@ std::wstring ToLowerWideString(std::wstring value) {
     return value;
 }
 
-bool StartsWithWideString(const std::wstring& value, const std::wstring& prefix) {
-    return value.size() >= prefix.size() &&
-           std::equal(prefix.begin(), prefix.end(), value.begin());
+// URL 前缀与地址栏名称关键字各编译为一个自动机，遍历 UIA 节点时单遍判断、不分配内存。
+// 只在 JS 线程上使用（readBrowserWindowUrl / addBrowserAddressBarKeywords 均为同步调用）。
+ztools::KeywordMatcher& BrowserUrlPrefixes() {
+    static ztools::KeywordMatcher matcher = ztools::MakeBrowserUrlPrefixMatcher();
+    return matcher;
 }
 
-bool LooksLikeBrowserUrl(const std::wstring& value) {
-    if (value.empty()) {
-        return false;
-    }
-
-    std::wstring trimmed = value;
-    trimmed.erase(trimmed.begin(), std::find_if(trimmed.begin(), trimmed.end(), [](wchar_t ch) {
-        return !iswspace(ch);
-    }));
-    trimmed.erase(std::find_if(trimmed.rbegin(), trimmed.rend(), [](wchar_t ch) {
-        return !iswspace(ch);
-    }).base(), trimmed.end());
-
-    if (trimmed.empty()) {
-        return false;
-    }
-
-    const std::wstring lower = ToLowerWideString(trimmed);
-    const std::wstring prefixes[] = {
-        L"http://", L"https://", L"file:///", L"about:", L"chrome://",
-        L"edge://", L"brave://", L"opera://", L"vivaldi://",
-        L"moz-extension://", L"ftp://"
-    };
-
-    for (const auto& prefix : prefixes) {
-        if (StartsWithWideString(lower, prefix)) {
-            return true;
-        }
-    }
+ztools::KeywordMatcher& BrowserAddressBarNames() {
+    static ztools::KeywordMatcher matcher = ztools::MakeBrowserAddressBarNameMatcher();
+    return matcher;
+}
 
-    return false;
+bool LooksLikeBrowserUrl(const std::wstring& value) {
+    return BrowserUrlPrefixes().Matches(value);
 }
 
 bool IsBrowserAddressBarName(const std::wstring& name) {
-    if (name.empty()) {
-        return false;
-    }
-
-    const std::wstring lower = ToLowerWideString(name);
-    const std::wstring keywords[] = {
-        L"address and search bar",
-        L"search or enter address",
-        L"address bar",
-        L"search with google or enter address",
-        L"地址和搜索栏",
-        L"地址栏",
-        L"输入搜索词或网址"
-    };
-
-    for (const auto& keyword : keywords) {
-        if (lower.find(keyword) != std::wstring::npos) {
-            return true;
-        }
-    }
-
-    return false;
+    return BrowserAddressBarNames().Matches(name);
 }
 
 std::wstring ReadElementValuePattern(IUIAutomationElement* element) {
@@ -5793,7 +6670,7 @@ std::string GetShellWindowLocationUrl(HWND targetHwnd) {
             BSTR url = nullptr;
             hr = browser->get_LocationURL(&url);
             if (SUCCEEDED(hr) && url) {
-                result = WideToUtf8String(std::wstring(url, SysStringLen(url)));
+                result = ztools::WideToUtf8(url, SysStringLen(url));
                 SysFreeString(url);
             }
             browser->Release();
@@ -5807,6 +6684,37 @@ std::string GetShellWindowLocationUrl(HWND targetHwnd) {
     return result;
 }
 
+/**
+ * 追加地址栏控件名称关键字（用于新的界面语言），大小写不敏感、按子串匹配。
+ *
+ * 参数：
+ * 1. keywords: string[] - 关键字列表，空串与已存在的关键字忽略
+ *
+ * 返回：实际新增的关键字数量
+ */
+Napi::Value AddBrowserAddressBarKeywords(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsArray()) {
+        Napi::TypeError::New(env, "keywords (string[]) is required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Array keywords = info[0].As<Napi::Array>();
+    ztools::KeywordMatcher& matcher = BrowserAddressBarNames();
+    uint32_t added = 0;
+    for (uint32_t i = 0; i < keywords.Length(); i++) {
+        Napi::Value item = keywords[i];
+        if (item.IsString() && matcher.Add(item.As<Napi::String>().Utf8Value())) {
+            added++;
+        }
+    }
+    if (added > 0) {
+        matcher.Build();
+    }
+    return Napi::Number::New(env, added);
+}
+
 /**
  * 读取指定浏览器窗口当前 URL。
  *
@@ -5825,7 +6733,7 @@ Napi::Value ReadBrowserWindowUrl(const Napi::CallbackInfo& info) {
     }
 
     const std::string browserName = info[0].As<Napi::String>().Utf8Value();
-    const std::string browserNameLower = WideToUtf8String(ToLowerWideString(Utf8ToWideString(browserName)));
+    const std::string browserNameLower = ztools::WideToUtf8(ToLowerWideString(ztools::Utf8ToWide(browserName)));
     const uint64_t hwndValue = static_cast<uint64_t>(info[1].As<Napi::Number>().Int64Value());
     HWND targetHwnd = reinterpret_cast<HWND>(hwndValue);
     Napi::Function callback = info[2].As<Napi::Function>();
@@ -5848,7 +6756,7 @@ Napi::Value ReadBrowserWindowUrl(const Napi::CallbackInfo& info) {
     if (result.empty()) {
         const std::wstring uiaResult = ReadBrowserUrlByUIAutomation(targetHwnd);
         if (!uiaResult.empty()) {
-            result = WideToUtf8String(uiaResult);
+            result = ztools::WideToUtf8(uiaResult);
         }
     }
 
@@ -5879,6 +6787,10 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set("simulateMouseRightClick", Napi::Function::New(env, SimulateMouseRightClick));
     exports.Set("startRegionCapture", Napi::Function::New(env, StartRegionCapture));
     exports.Set("getClipboardFiles", Napi::Function::New(env, GetClipboardFiles));
+    exports.Set("getClipboardCacheStats", Napi::Function::New(env, GetClipboardCacheStats));
+    InitClipboardHistory(env, exports);
+    InitClipboardRead(env, exports);
+    InitClipboardWrite(env, exports);
     exports.Set("setClipboardFiles", Napi::Function::New(env, SetClipboardFiles));
     exports.Set("startMouseMonitor", Napi::Function::New(env, StartMouseMonitor));
     exports.Set("stopMouseMonitor", Napi::Function::New(env, StopMouseMonitor));
@@ -5899,7 +6811,14 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set("isFileLocationWindow", Napi::Function::New(env, IsFileLocationWindowBinding));
     // 读取指定浏览器窗口的当前 URL
     exports.Set("readBrowserWindowUrl", Napi::Function::New(env, ReadBrowserWindowUrl));
+    exports.Set("addBrowserAddressBarKeywords", Napi::Function::New(env, AddBrowserAddressBarKeywords));
     exports.Set("getSelectedContent", Napi::Function::New(env, GetSelectedContent));
+    exports.Set("getSelectedContentAsync", Napi::Function::New(env, GetSelectedContentAsync));
+
+    // 卸载时销毁延迟渲染所有者窗口，使剪贴板上的截图在进程退出后仍然可用
+    napi_add_env_cleanup_hook(env, ShutdownRenderOwnerWindow, nullptr);
+    // 卸载时等待文件属性查询线程结束，不在 DLL 卸载阶段遗留线程
+    napi_add_env_cleanup_hook(env, ShutdownFileProbePool, nullptr);
     return exports;
 }
 
@@ -0,0 +1,326 @@
+// 剪贴板历史 N-API 导出（各平台 binding 共用，仅由 binding_*.cpp 包含一次）
+//
+// 历史由监控线程直接写入（见各平台 StartMonitor），JS 侧只按索引分页读取元数据，
+// 需要内容时再按 id + 格式名读取单个格式的数据。
+// 配置 persistDir 后条目同时追加到内存映射日志（common/history_log.h），重启后仍可分页读取；
+// 此时内存历史只作为最近条目的热缓存，分页以日志为准。日志有自己的容量（persistMaxEntries/persistMaxBytes，
+// 默认与内存历史的 maxEntries/maxBytes 相同），超出时为最旧的条目写入墓碑，失效记录由后台压缩回收。
+// 图片条目在写入前附加 "thumbnail" 格式（common/image_thumbnail.h），界面预览不必读取完整位图。
+#pragma once
+
+#include <napi.h>
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+
+#include "common/clipboard_history.h"
+#include "common/history_log.h"
+#include "common/image_thumbnail.h"
+
+// 全局变量 - 剪贴板历史
+static ztools::ClipboardHistory g_clipboardHistory;
+static std::atomic<bool> g_clipboardHistoryEnabled(false);
+static ztools::HistoryLog g_clipboardHistoryLog;
+// 缩略图长边（0 表示不生成）
+static std::atomic<uint32_t> g_clipboardThumbnailSize(ztools::kDefaultThumbnailSize);
+// 持久化日志容量（0 表示跟随内存历史的 maxEntries/maxBytes）
+static uint64_t g_clipboardPersistMaxEntries = 0;
+static uint64_t g_clipboardPersistMaxBytes = 0;
+
+static ztools::HistoryLogOptions ClipboardHistoryLogOptions() {
+    ztools::ClipboardHistoryOptions historyOptions = g_clipboardHistory.Options();
+    ztools::HistoryLogOptions options;
+    options.maxEntries = g_clipboardPersistMaxEntries > 0 ? g_clipboardPersistMaxEntries : historyOptions.maxEntries;
+    options.maxBytes = g_clipboardPersistMaxBytes > 0 ? g_clipboardPersistMaxBytes : historyOptions.maxBytes;
+    return options;
+}
+
+// 为含 CF_DIB 的条目附加 "thumbnail" 格式（监控线程在关闭剪贴板之后调用）
+static void AddClipboardHistoryThumbnail(std::vector<ztools::ClipboardHistoryFormat>& formats) {
+    ztools::ThumbnailOptions options;
+    options.maxSize = g_clipboardThumbnailSize;
+    if (options.maxSize == 0) {
+        return;
+    }
+    for (const ztools::ClipboardHistoryFormat& format : formats) {
+        if (format.name != "CF_DIB") {
+            continue;
+        }
+        ztools::ThumbnailImage thumbnail;
+        if (ztools::ThumbnailFromDib(format.data.data(), format.data.size(), options, thumbnail)) {
+            ztools::ClipboardHistoryFormat item;
+            item.name = "thumbnail";
+            item.data = ztools::SerializeThumbnail(thumbnail);
+            formats.push_back(std::move(item));
+        }
+        return;
+    }
+}
+
+// 写入历史（监控线程调用）：先进入内存历史，启用持久化时再以相同 id 追加到日志
+static uint64_t AddClipboardHistoryEntry(std::vector<ztools::ClipboardHistoryFormat> formats, uint64_t sequence) {
+    if (!g_clipboardHistoryLog.IsOpen()) {
+        return g_clipboardHistory.Add(std::move(formats), sequence);
+    }
+
+    ztools::HistoryLogRecord record;
+    record.formats = formats;
+    uint64_t id = g_clipboardHistory.Add(std::move(formats), sequence);
+    ztools::ClipboardHistoryEntryInfo entry;
+    if (id == 0 || !g_clipboardHistory.GetInfo(id, entry)) {
+        return id;
+    }
+    record.id = id;
+    record.hash = entry.hash;
+    record.sequence = entry.sequence;
+    record.createdAtMs = entry.createdAtMs;
+    record.lastSeenAtMs = entry.lastSeenAtMs;
+    record.copyCount = entry.copyCount;
+    g_clipboardHistoryLog.Append(record);
+    return id;
+}
+
+// 以字符串形式返回的格式（其余格式返回 Buffer）
+static bool IsTextualHistoryFormat(const std::string& format) {
+    return format == "text" || format == "html" || format == "files";
+}
+
+static Napi::Object CreateHistoryEntryObject(Napi::Env env, const ztools::ClipboardHistoryEntryInfo& entry) {
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("id", Napi::Number::New(env, static_cast<double>(entry.id)));
+
+    // 64 位哈希超出 JS Number 精度，使用 16 位十六进制字符串
+    char hashHex[17];
+    snprintf(hashHex, sizeof(hashHex), "%016llx", static_cast<unsigned long long>(entry.hash));
+    obj.Set("hash", Napi::String::New(env, hashHex));
+
+    obj.Set("sequence", Napi::Number::New(env, static_cast<double>(entry.sequence)));
+    obj.Set("createdAt", Napi::Number::New(env, static_cast<double>(entry.createdAtMs)));
+    obj.Set("lastSeenAt", Napi::Number::New(env, static_cast<double>(entry.lastSeenAtMs)));
+    obj.Set("copyCount", Napi::Number::New(env, entry.copyCount));
+    obj.Set("bytes", Napi::Number::New(env, static_cast<double>(entry.bytes)));
+
+    Napi::Array formats = Napi::Array::New(env, entry.formats.size());
+    for (size_t i = 0; i < entry.formats.size(); i++) {
+        Napi::Object format = Napi::Object::New(env);
+        format.Set("name", Napi::String::New(env, entry.formats[i].name));
+        format.Set("size", Napi::Number::New(env, static_cast<double>(entry.formats[i].size)));
+        formats.Set(static_cast<uint32_t>(i), format);
+    }
+    obj.Set("formats", formats);
+    return obj;
+}
+
+// 配置剪贴板历史
+// 参数：{ enabled?: boolean, maxEntries?: number, maxBytes?: number, persistDir?: string | null,
+//        persistMaxEntries?: number, persistMaxBytes?: number, thumbnailSize?: number }
+// persistDir 为已存在的目录时打开持久化日志，为 null 或空字符串时关闭；
+// persistMaxEntries/persistMaxBytes 为 0 或未设置时与 maxEntries/maxBytes 相同
+Napi::Value ConfigureClipboardHistory(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected an options object").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    Napi::Object options = info[0].As<Napi::Object>();
+    ztools::ClipboardHistoryOptions historyOptions = g_clipboardHistory.Options();
+    if (options.Has("maxEntries") && options.Get("maxEntries").IsNumber()) {
+        int64_t maxEntries = options.Get("maxEntries").As<Napi::Number>().Int64Value();
+        if (maxEntries < 1) {
+            Napi::RangeError::New(env, "maxEntries must be at least 1").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        historyOptions.maxEntries = static_cast<size_t>(maxEntries);
+    }
+    if (options.Has("maxBytes") && options.Get("maxBytes").IsNumber()) {
+        int64_t maxBytes = options.Get("maxBytes").As<Napi::Number>().Int64Value();
+        if (maxBytes < 1) {
+            Napi::RangeError::New(env, "maxBytes must be positive").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        historyOptions.maxBytes = static_cast<size_t>(maxBytes);
+    }
+    if (options.Has("persistMaxEntries") && options.Get("persistMaxEntries").IsNumber()) {
+        int64_t maxEntries = options.Get("persistMaxEntries").As<Napi::Number>().Int64Value();
+        if (maxEntries < 0) {
+            Napi::RangeError::New(env, "persistMaxEntries must not be negative").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        g_clipboardPersistMaxEntries = static_cast<uint64_t>(maxEntries);
+    }
+    if (options.Has("persistMaxBytes") && options.Get("persistMaxBytes").IsNumber()) {
+        int64_t maxBytes = options.Get("persistMaxBytes").As<Napi::Number>().Int64Value();
+        if (maxBytes < 0) {
+            Napi::RangeError::New(env, "persistMaxBytes must not be negative").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        g_clipboardPersistMaxBytes = static_cast<uint64_t>(maxBytes);
+    }
+    if (options.Has("thumbnailSize") && options.Get("thumbnailSize").IsNumber()) {
+        int64_t thumbnailSize = options.Get("thumbnailSize").As<Napi::Number>().Int64Value();
+        if (thumbnailSize < 0 || thumbnailSize > 1024) {
+            Napi::RangeError::New(env, "thumbnailSize must be between 0 and 1024").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        g_clipboardThumbnailSize = static_cast<uint32_t>(thumbnailSize);
+    }
+    g_clipboardHistory.Configure(historyOptions);
+    const ztools::HistoryLogOptions logOptions = ClipboardHistoryLogOptions();
+    g_clipboardHistoryLog.SetLimits(logOptions.maxEntries, logOptions.maxBytes);
+
+    if (options.Has("persistDir")) {
+        Napi::Value persistDir = options.Get("persistDir");
+        std::string directory = persistDir.IsString() ? persistDir.As<Napi::String>().Utf8Value() : std::string();
+        if (directory.empty()) {
+            g_clipboardHistoryLog.Close();
+        } else {
+            if (!g_clipboardHistoryLog.Open(directory, logOptions)) {
+                Napi::Error::New(env, "Failed to open clipboard history log: " + g_clipboardHistoryLog.LastError())
+                    .ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+            // 新 id 接在日志之后，避免与上次运行的条目冲突
+            g_clipboardHistory.ReserveIds(g_clipboardHistoryLog.NextId());
+        }
+    }
+
+    if (options.Has("enabled") && options.Get("enabled").IsBoolean()) {
+        g_clipboardHistoryEnabled = options.Get("enabled").As<Napi::Boolean>().Value();
+    }
+    return env.Undefined();
+}
+
+// 分页读取历史条目元数据（索引 0 为最新）
+// 参数：offset?: number, count?: number
+Napi::Value GetClipboardHistory(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    size_t offset = 0;
+    size_t count = 50;
+    if (info.Length() > 0 && info[0].IsNumber()) {
+        int64_t value = info[0].As<Napi::Number>().Int64Value();
+        offset = value > 0 ? static_cast<size_t>(value) : 0;
+    }
+    if (info.Length() > 1 && info[1].IsNumber()) {
+        int64_t value = info[1].As<Napi::Number>().Int64Value();
+        count = value > 0 ? static_cast<size_t>(value) : 0;
+    }
+
+    std::vector<ztools::ClipboardHistoryEntryInfo> page = g_clipboardHistoryLog.IsOpen()
+                                                              ? g_clipboardHistoryLog.Page(offset, count)
+                                                              : g_clipboardHistory.Page(offset, count);
+    Napi::Array result = Napi::Array::New(env, page.size());
+    for (size_t i = 0; i < page.size(); i++) {
+        result.Set(static_cast<uint32_t>(i), CreateHistoryEntryObject(env, page[i]));
+    }
+    return result;
+}
+
+// 读取某个条目的单个格式数据
+// 参数：id: number, format: string
+// 返回：text/html/files 为字符串，thumbnail 为 { width, height, data: Buffer（预乘 BGRA）}，
+//      其他格式为 Buffer；条目或格式不存在时返回 null
+Napi::Value GetClipboardHistoryData(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsNumber() || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Expected (id: number, format: string)").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    uint64_t id = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+    std::string format = info[1].As<Napi::String>().Utf8Value();
+    // 最近条目优先从内存读取，其余从日志读取
+    std::shared_ptr<const std::string> data = g_clipboardHistory.GetData(id, format);
+    if (!data) {
+        data = g_clipboardHistoryLog.ReadFormat(id, format);
+    }
+    if (!data) {
+        return env.Null();
+    }
+    if (IsTextualHistoryFormat(format)) {
+        return Napi::String::New(env, *data);
+    }
+    if (format == "thumbnail") {
+        ztools::ThumbnailImage thumbnail;
+        if (!ztools::ParseThumbnail(*data, thumbnail)) {
+            return env.Null();
+        }
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("width", Napi::Number::New(env, thumbnail.width));
+        result.Set("height", Napi::Number::New(env, thumbnail.height));
+        result.Set("data", Napi::Buffer<char>::Copy(env, thumbnail.pixels.data(), thumbnail.pixels.size()));
+        return result;
+    }
+    return Napi::Buffer<char>::Copy(env, data->data(), data->size());
+}
+
+// 删除单个条目
+Napi::Value RemoveClipboardHistoryEntry(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected an entry id").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    uint64_t id = static_cast<uint64_t>(info[0].As<Napi::Number>().Int64Value());
+    bool removed = g_clipboardHistory.Remove(id);
+    removed = g_clipboardHistoryLog.Remove(id) || removed;
+    return Napi::Boolean::New(env, removed);
+}
+
+// 清空历史
+Napi::Value ClearClipboardHistory(const Napi::CallbackInfo& info) {
+    g_clipboardHistory.Clear();
+    g_clipboardHistoryLog.Clear();
+    return info.Env().Undefined();
+}
+
+// 获取历史统计
+Napi::Value GetClipboardHistoryStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ztools::ClipboardHistoryStats stats = g_clipboardHistory.Stats();
+    ztools::ClipboardHistoryOptions options = g_clipboardHistory.Options();
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("enabled", Napi::Boolean::New(env, g_clipboardHistoryEnabled));
+    result.Set("entries", Napi::Number::New(env, static_cast<double>(stats.entries)));
+    result.Set("bytes", Napi::Number::New(env, static_cast<double>(stats.bytes)));
+    result.Set("maxEntries", Napi::Number::New(env, static_cast<double>(options.maxEntries)));
+    result.Set("maxBytes", Napi::Number::New(env, static_cast<double>(options.maxBytes)));
+    result.Set("added", Napi::Number::New(env, static_cast<double>(stats.added)));
+    result.Set("duplicates", Napi::Number::New(env, static_cast<double>(stats.duplicates)));
+    result.Set("evicted", Napi::Number::New(env, static_cast<double>(stats.evicted)));
+    result.Set("rejected", Napi::Number::New(env, static_cast<double>(stats.rejected)));
+
+    if (g_clipboardHistoryLog.IsOpen()) {
+        ztools::HistoryLogStats logStats = g_clipboardHistoryLog.Stats();
+        Napi::Object persisted = Napi::Object::New(env);
+        persisted.Set("entries", Napi::Number::New(env, static_cast<double>(logStats.live)));
+        persisted.Set("records", Napi::Number::New(env, static_cast<double>(logStats.records)));
+        persisted.Set("logBytes", Napi::Number::New(env, static_cast<double>(logStats.logBytes)));
+        persisted.Set("deadBytes", Napi::Number::New(env, static_cast<double>(logStats.deadBytes)));
+        persisted.Set("recoveredRecords", Napi::Number::New(env, static_cast<double>(logStats.recoveredRecords)));
+        persisted.Set("truncatedBytes", Napi::Number::New(env, static_cast<double>(logStats.truncatedBytes)));
+        persisted.Set("compactions", Napi::Number::New(env, static_cast<double>(logStats.compactions)));
+        persisted.Set("evicted", Napi::Number::New(env, static_cast<double>(logStats.evicted)));
+        persisted.Set("indexRebuilt", Napi::Boolean::New(env, logStats.indexRebuilt));
+        result.Set("persisted", persisted);
+    } else {
+        result.Set("persisted", env.Null());
+    }
+    return result;
+}
+
+// 注册剪贴板历史相关导出
+static void InitClipboardHistory(Napi::Env env, Napi::Object exports) {
+    exports.Set("configureClipboardHistory", Napi::Function::New(env, ConfigureClipboardHistory));
+    exports.Set("getClipboardHistory", Napi::Function::New(env, GetClipboardHistory));
+    exports.Set("getClipboardHistoryData", Napi::Function::New(env, GetClipboardHistoryData));
+    exports.Set("removeClipboardHistoryEntry", Napi::Function::New(env, RemoveClipboardHistoryEntry));
+    exports.Set("clearClipboardHistory", Napi::Function::New(env, ClearClipboardHistory));
+    exports.Set("getClipboardHistoryStats", Napi::Function::New(env, GetClipboardHistoryStats));
+}
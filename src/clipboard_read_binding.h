@@ -0,0 +1,119 @@
+// readClipboard / 剪贴板持有时长统计 N-API 导出（各平台 binding 共用，仅由 binding_*.cpp 包含一次）
+//
+// 平台 binding 需定义 ReadClipboardFormats：在一次剪贴板会话内读取 mask 指定的全部格式，
+// 并用 ClipboardLockTimer(g_clipboardLockStats) 记录持有时长。
+#pragma once
+
+#include <napi.h>
+
+#include "common/clipboard_read.h"
+#include "external_buffer_binding.h"
+
+// 所有打开剪贴板的路径共用的持有时长统计
+static ztools::ClipboardLockStats g_clipboardLockStats;
+
+// 平台实现（定义在各 binding_*.cpp）
+static void ReadClipboardFormats(uint32_t mask, ztools::ClipboardReadResult& result);
+
+// 持有时长以毫秒（小数）返回给 JS
+static double MicrosToMillis(uint64_t us) {
+    return static_cast<double>(us) / 1000.0;
+}
+
+// 结果中的字节在此之后不再使用，按输出方式移交给 JS（零拷贝）或转为字符串
+static Napi::Object CreateClipboardReadObject(Napi::Env env, ztools::ClipboardReadResult& result) {
+    const bool utf16 = (result.output & ztools::kClipboardOutputUtf16) != 0;
+    const bool binary = (result.output & ztools::kClipboardOutputBinary) != 0;
+
+    Napi::Object obj = Napi::Object::New(env);
+    obj.Set("sequence", Napi::Number::New(env, static_cast<double>(result.sequence)));
+    obj.Set("opened", Napi::Boolean::New(env, result.opened));
+    obj.Set("lockHeldMs", Napi::Number::New(env, MicrosToMillis(result.lockHeldUs)));
+
+    // 只返回请求且存在的格式
+    if (result.hasText) {
+        obj.Set("text", utf16 ? NewExternalUint16Array(env, std::move(result.text))
+                              : Napi::Value(Napi::String::New(env, result.text)));
+    }
+    if (result.hasHtml) {
+        obj.Set("html", binary ? NewExternalBuffer(env, std::move(result.html))
+                               : Napi::Value(Napi::String::New(env, result.html)));
+    }
+    if (result.hasRtf) {
+        obj.Set("rtf", binary ? NewExternalBuffer(env, std::move(result.rtf))
+                              : Napi::Value(Napi::String::New(env, result.rtf)));
+    }
+    if (result.hasImage) {
+        obj.Set("image", binary ? NewExternalBuffer(env, std::move(result.image))
+                                : Napi::Value(Napi::String::New(env, result.image)));
+    }
+    if (result.hasFiles) {
+        Napi::Array files = Napi::Array::New(env, result.files.size());
+        for (size_t i = 0; i < result.files.size(); i++) {
+            files.Set(static_cast<uint32_t>(i), Napi::String::New(env, result.files[i]));
+        }
+        obj.Set("files", files);
+    }
+    return obj;
+}
+
+// 读取剪贴板多种格式
+// 参数：mask?: number（kClipboardRead* 按位或，默认全部），options?: { utf16?: boolean, binary?: boolean }
+// - utf16: text 以 Uint16Array（UTF-16 码元）返回，不经过 UTF-8 与 JS 字符串
+// - binary: image 以 PNG Buffer 返回（不做 base64），html/rtf 以原文 Buffer 返回
+Napi::Value ReadClipboard(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    uint32_t mask = ztools::kClipboardReadAll;
+    if (info.Length() > 0 && !info[0].IsUndefined() && !info[0].IsNull()) {
+        if (!info[0].IsNumber()) {
+            Napi::TypeError::New(env, "Expected a format mask number").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        mask = info[0].As<Napi::Number>().Uint32Value() & ztools::kClipboardReadAll;
+    }
+
+    uint32_t output = 0;
+    if (info.Length() > 1 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (options.Get("utf16").ToBoolean().Value()) {
+            output |= ztools::kClipboardOutputUtf16;
+        }
+        if (options.Get("binary").ToBoolean().Value()) {
+            output |= ztools::kClipboardOutputBinary;
+        }
+    }
+
+    ztools::ClipboardReadResult result;
+    result.mask = mask;
+    result.output = output;
+    if (mask != 0) {
+        ReadClipboardFormats(mask, result);
+    }
+    return CreateClipboardReadObject(env, result);
+}
+
+// 获取剪贴板持有时长统计
+Napi::Value GetClipboardLockStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ztools::ClipboardLockStatsSnapshot stats = g_clipboardLockStats.Snapshot();
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("count", Napi::Number::New(env, static_cast<double>(stats.count)));
+    result.Set("totalMs", Napi::Number::New(env, MicrosToMillis(stats.totalUs)));
+    result.Set("maxMs", Napi::Number::New(env, MicrosToMillis(stats.maxUs)));
+    result.Set("lastMs", Napi::Number::New(env, MicrosToMillis(stats.lastUs)));
+    return result;
+}
+
+Napi::Value ResetClipboardLockStats(const Napi::CallbackInfo& info) {
+    g_clipboardLockStats.Reset();
+    return info.Env().Undefined();
+}
+
+static void InitClipboardRead(Napi::Env env, Napi::Object exports) {
+    exports.Set("readClipboard", Napi::Function::New(env, ReadClipboard));
+    exports.Set("getClipboardLockStats", Napi::Function::New(env, GetClipboardLockStats));
+    exports.Set("resetClipboardLockStats", Napi::Function::New(env, ResetClipboardLockStats));
+    exports.Set("getExternalBufferStats", Napi::Function::New(env, GetExternalBufferStats));
+}
@@ -0,0 +1,175 @@
+// writeClipboard N-API 导出（各平台 binding 共用，仅由 binding_*.cpp 包含一次）
+//
+// 平台 binding 需定义 WriteClipboardRequest：在工作线程中编码全部格式，并在一次剪贴板事务内发布。
+#pragma once
+
+#include <napi.h>
+
+#include "common/base64.h"
+#include "common/clipboard_write.h"
+
+// 平台实现（定义在各 binding_*.cpp，在工作线程调用）
+static bool WriteClipboardRequest(const ztools::ClipboardWriteRequest& request, std::string& error);
+
+// 读取可选字符串字段；字段存在但不是字符串时抛出 TypeError
+static bool ReadWriteStringField(Napi::Object data, const char* name, bool& has, std::string& value) {
+    Napi::Value field = data.Get(name);
+    if (field.IsUndefined() || field.IsNull()) {
+        return true;
+    }
+    if (!field.IsString()) {
+        Napi::TypeError::New(data.Env(), std::string(name) + " must be a string").ThrowAsJavaScriptException();
+        return false;
+    }
+    has = true;
+    value = field.As<Napi::String>().Utf8Value();
+    return true;
+}
+
+// image: { width, height, data: Buffer（BGRA）, stride? }
+static bool ReadWriteImageField(Napi::Object data, ztools::ClipboardWriteRequest& request) {
+    Napi::Env env = data.Env();
+    Napi::Value field = data.Get("image");
+    if (field.IsUndefined() || field.IsNull()) {
+        return true;
+    }
+    if (!field.IsObject()) {
+        Napi::TypeError::New(env, "image must be { width, height, data: Buffer }").ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Object image = field.As<Napi::Object>();
+    Napi::Value width = image.Get("width");
+    Napi::Value height = image.Get("height");
+    Napi::Value stride = image.Get("stride");
+    Napi::Value pixels = image.Get("data");
+    if (!width.IsNumber() || !height.IsNumber() || !pixels.IsBuffer() ||
+        (!stride.IsUndefined() && !stride.IsNumber())) {
+        Napi::TypeError::New(env, "image must be { width, height, data: Buffer }").ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Buffer<char> buffer = pixels.As<Napi::Buffer<char>>();
+    request.hasImage = true;
+    request.image.width = width.As<Napi::Number>().Uint32Value();
+    request.image.height = height.As<Napi::Number>().Uint32Value();
+    request.image.stride = stride.IsNumber() ? stride.As<Napi::Number>().Uint32Value() : 0;
+    // 复制像素：JS 可能在工作线程编码期间修改或回收 Buffer
+    request.image.bgra.assign(buffer.Data(), buffer.Length());
+
+    std::string error;
+    if (!ztools::ValidateClipboardWriteImage(request.image, &error)) {
+        Napi::RangeError::New(env, error).ThrowAsJavaScriptException();
+        return false;
+    }
+    return true;
+}
+
+// png: Buffer（PNG 字节）或 base64 字符串 / "data:image/png;base64,..." data URL
+static bool ReadWritePngField(Napi::Object data, ztools::ClipboardWriteRequest& request) {
+    Napi::Env env = data.Env();
+    Napi::Value field = data.Get("png");
+    if (field.IsUndefined() || field.IsNull()) {
+        return true;
+    }
+    if (field.IsBuffer()) {
+        Napi::Buffer<char> buffer = field.As<Napi::Buffer<char>>();
+        request.png.assign(buffer.Data(), buffer.Length());
+    } else if (field.IsString()) {
+        // 直接解码到请求中，不再经过 JS 侧 Buffer.from(..., 'base64')
+        std::string text = field.As<Napi::String>().Utf8Value();
+        if (!ztools::DecodeBase64DataUrl(text.data(), text.size(), request.png)) {
+            Napi::TypeError::New(env, "png string must be base64 or a base64 data URL").ThrowAsJavaScriptException();
+            return false;
+        }
+    } else {
+        Napi::TypeError::New(env, "png must be a Buffer or a base64 string").ThrowAsJavaScriptException();
+        return false;
+    }
+    request.hasPng = true;
+
+    std::string error;
+    if (!ztools::ValidateClipboardWritePng(request.png, &error)) {
+        Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+        return false;
+    }
+    return true;
+}
+
+// files: Array<string | { path }>（与 setClipboardFiles 相同）
+static bool ReadWriteFilesField(Napi::Object data, ztools::ClipboardWriteRequest& request) {
+    Napi::Value field = data.Get("files");
+    if (field.IsUndefined() || field.IsNull()) {
+        return true;
+    }
+    if (!field.IsArray()) {
+        Napi::TypeError::New(data.Env(), "files must be an array").ThrowAsJavaScriptException();
+        return false;
+    }
+    Napi::Array files = field.As<Napi::Array>();
+    request.hasFiles = true;
+    for (uint32_t i = 0; i < files.Length(); i++) {
+        Napi::Value item = files[i];
+        if (item.IsObject() && !item.IsString()) {
+            item = item.As<Napi::Object>().Get("path");
+        }
+        if (item.IsString()) {
+            request.files.push_back(item.As<Napi::String>().Utf8Value());
+        }
+    }
+    return true;
+}
+
+class ClipboardWriteWorker : public Napi::AsyncWorker {
+    public:
+        ClipboardWriteWorker(ztools::ClipboardWriteRequest&& request, Napi::Env env, Napi::Promise::Deferred deferred)
+            : Napi::AsyncWorker(env), request_(std::move(request)), deferred_(deferred) {}
+        void Execute() override {
+            std::string error;
+            if (!WriteClipboardRequest(request_, error)) {
+                SetError(error);
+            }
+            // 像素可能很大，写入后立即释放
+            request_ = ztools::ClipboardWriteRequest();
+        }
+        void OnOK() override {
+            deferred_.Resolve(Napi::Boolean::New(Env(), true));
+        }
+        void OnError(const Napi::Error& e) override {
+            deferred_.Reject(e.Value());
+        }
+    private:
+        ztools::ClipboardWriteRequest request_;
+        Napi::Promise::Deferred deferred_;
+};
+
+// 原子写入多种格式
+// 参数：{ text?, html?, rtf?, image?: { width, height, data: Buffer, stride? }, png?: Buffer | string, files? }
+// 返回：Promise<boolean>，写入失败时 reject
+Napi::Value WriteClipboard(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected an object with text/html/rtf/image/png/files").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    Napi::Object data = info[0].As<Napi::Object>();
+
+    ztools::ClipboardWriteRequest request;
+    if (!ReadWriteStringField(data, "text", request.hasText, request.text) ||
+        !ReadWriteStringField(data, "html", request.hasHtml, request.html) ||
+        !ReadWriteStringField(data, "rtf", request.hasRtf, request.rtf) || !ReadWriteImageField(data, request) ||
+        !ReadWritePngField(data, request) || !ReadWriteFilesField(data, request)) {
+        return env.Undefined();
+    }
+    if (request.Empty()) {
+        Napi::Error::New(env, "Nothing to write").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto deferred = Napi::Promise::Deferred::New(env);
+    auto* worker = new ClipboardWriteWorker(std::move(request), env, deferred);
+    worker->Queue();
+    return deferred.Promise();
+}
+
+static void InitClipboardWrite(Napi::Env env, Napi::Object exports) {
+    exports.Set("writeClipboard", Napi::Function::New(env, WriteClipboard));
+}
@@ -0,0 +1,386 @@
+#include "appx_manifest.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace ztools {
+
+namespace {
+
+inline bool IsXmlSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool StartsWith(const char* p, const char* end, const char* prefix, size_t length) {
+    return static_cast<size_t>(end - p) >= length && memcmp(p, prefix, length) == 0;
+}
+
+// 在 [p, end) 中查找 needle，返回其起始位置；找不到时返回 nullptr
+const char* FindSequence(const char* p, const char* end, const char* needle, size_t length) {
+    while (static_cast<size_t>(end - p) >= length) {
+        const char* hit = static_cast<const char*>(memchr(p, needle[0], static_cast<size_t>(end - p) - length + 1));
+        if (hit == nullptr) {
+            return nullptr;
+        }
+        if (memcmp(hit, needle, length) == 0) {
+            return hit;
+        }
+        p = hit + 1;
+    }
+    return nullptr;
+}
+
+void AppendUtf8(uint32_t cp, std::string& out) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+// "&" 与 ";" 之间的实体名 → 追加解码结果；无法识别时返回 false
+bool AppendEntity(const char* name, size_t length, std::string& out) {
+    static const struct {
+        const char* name;
+        char value;
+    } kPredefined[] = {{"amp", '&'}, {"lt", '<'}, {"gt", '>'}, {"quot", '"'}, {"apos", '\''}};
+    for (const auto& entity : kPredefined) {
+        if (strlen(entity.name) == length && memcmp(entity.name, name, length) == 0) {
+            out.push_back(entity.value);
+            return true;
+        }
+    }
+    if (length < 2 || name[0] != '#') {
+        return false;
+    }
+    const bool hex = name[1] == 'x' || name[1] == 'X';
+    size_t i = hex ? 2 : 1;
+    if (i == length) {
+        return false;
+    }
+    uint32_t cp = 0;
+    for (; i < length; i++) {
+        const char c = name[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint32_t>(c - '0');
+        } else if (hex && c >= 'a' && c <= 'f') {
+            digit = static_cast<uint32_t>(c - 'a' + 10);
+        } else if (hex && c >= 'A' && c <= 'F') {
+            digit = static_cast<uint32_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        cp = cp * (hex ? 16 : 10) + digit;
+        if (cp > 0x10FFFF) {
+            return false;
+        }
+    }
+    if (cp == 0 || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        return false;
+    }
+    AppendUtf8(cp, out);
+    return true;
+}
+
+void AssignDecoded(const XmlSlice& value, std::string& out) {
+    out.clear();
+    AppendXmlDecoded(value.data, value.size, out);
+}
+
+}  // namespace
+
+bool XmlSlice::Equals(const char* text) const {
+    const size_t length = strlen(text);
+    return length == size && memcmp(data, text, length) == 0;
+}
+
+XmlTokenizer::XmlTokenizer(const char* data, size_t size) : pos_(data), end_(data + size) {}
+
+bool XmlTokenizer::Fail() {
+    failed_ = true;
+    pos_ = end_;
+    return false;
+}
+
+bool XmlTokenizer::Next(XmlToken& token) {
+    while (pos_ < end_) {
+        token.selfClosing = false;
+        token.cdata = false;
+        if (*pos_ != '<') {
+            const char* lt = static_cast<const char*>(memchr(pos_, '<', static_cast<size_t>(end_ - pos_)));
+            if (lt == nullptr) {
+                lt = end_;
+            }
+            token.type = XmlTokenType::Text;
+            token.text = XmlSlice{pos_, static_cast<size_t>(lt - pos_)};
+            pos_ = lt;
+            return true;
+        }
+
+        if (StartsWith(pos_, end_, "<?", 2)) {
+            const char* close = FindSequence(pos_ + 2, end_, "?>", 2);
+            if (close == nullptr) {
+                return Fail();
+            }
+            pos_ = close + 2;
+            continue;
+        }
+        if (StartsWith(pos_, end_, "<!--", 4)) {
+            const char* close = FindSequence(pos_ + 4, end_, "-->", 3);
+            if (close == nullptr) {
+                return Fail();
+            }
+            pos_ = close + 3;
+            continue;
+        }
+        if (StartsWith(pos_, end_, "<![CDATA[", 9)) {
+            const char* close = FindSequence(pos_ + 9, end_, "]]>", 3);
+            if (close == nullptr) {
+                return Fail();
+            }
+            token.type = XmlTokenType::Text;
+            token.text = XmlSlice{pos_ + 9, static_cast<size_t>(close - pos_ - 9)};
+            token.cdata = true;
+            pos_ = close + 3;
+            return true;
+        }
+        if (StartsWith(pos_, end_, "<!", 2)) {
+            // DOCTYPE 等声明：不解析内部子集，跳到 ']>' 或 '>'
+            const char* gt = static_cast<const char*>(memchr(pos_, '>', static_cast<size_t>(end_ - pos_)));
+            const char* bracket = static_cast<const char*>(memchr(pos_, '[', static_cast<size_t>(end_ - pos_)));
+            if (bracket != nullptr && (gt == nullptr || bracket < gt)) {
+                gt = FindSequence(bracket, end_, "]>", 2);
+                gt = gt != nullptr ? gt + 1 : nullptr;
+            }
+            if (gt == nullptr) {
+                return Fail();
+            }
+            pos_ = gt + 1;
+            continue;
+        }
+
+        const bool endTag = StartsWith(pos_, end_, "</", 2);
+        const char* nameBegin = pos_ + (endTag ? 2 : 1);
+        const char* p = nameBegin;
+        while (p < end_ && !IsXmlSpace(*p) && *p != '>' && *p != '/') {
+            p++;
+        }
+        if (p == nameBegin) {
+            return Fail();
+        }
+        token.name = XmlSlice{nameBegin, static_cast<size_t>(p - nameBegin)};
+        const char* nameEnd = p;
+
+        // 找到标签结尾的 '>'，跳过引号内的内容
+        while (p < end_ && *p != '>') {
+            if (*p == '"' || *p == '\'') {
+                p = static_cast<const char*>(memchr(p + 1, *p, static_cast<size_t>(end_ - p - 1)));
+                if (p == nullptr) {
+                    return Fail();
+                }
+            }
+            p++;
+        }
+        if (p >= end_) {
+            return Fail();
+        }
+
+        if (endTag) {
+            token.type = XmlTokenType::EndTag;
+            token.attributes = XmlSlice();
+        } else {
+            token.type = XmlTokenType::StartTag;
+            token.selfClosing = p > nameEnd && p[-1] == '/';
+            const char* attributesEnd = token.selfClosing ? p - 1 : p;
+            token.attributes = XmlSlice{nameEnd, static_cast<size_t>(attributesEnd - nameEnd)};
+        }
+        pos_ = p + 1;
+        return true;
+    }
+    return false;
+}
+
+XmlAttributeReader::XmlAttributeReader(const XmlSlice& attributes)
+    : pos_(attributes.data), end_(attributes.data + attributes.size) {}
+
+bool XmlAttributeReader::Next(XmlSlice& name, XmlSlice& value) {
+    while (pos_ < end_ && IsXmlSpace(*pos_)) {
+        pos_++;
+    }
+    const char* nameBegin = pos_;
+    while (pos_ < end_ && !IsXmlSpace(*pos_) && *pos_ != '=') {
+        pos_++;
+    }
+    if (pos_ == nameBegin) {
+        return false;
+    }
+    name = XmlSlice{nameBegin, static_cast<size_t>(pos_ - nameBegin)};
+    while (pos_ < end_ && IsXmlSpace(*pos_)) {
+        pos_++;
+    }
+    if (pos_ >= end_ || *pos_ != '=') {
+        pos_ = end_;
+        return false;
+    }
+    pos_++;
+    while (pos_ < end_ && IsXmlSpace(*pos_)) {
+        pos_++;
+    }
+    if (pos_ >= end_ || (*pos_ != '"' && *pos_ != '\'')) {
+        pos_ = end_;
+        return false;
+    }
+    const char quote = *pos_++;
+    const char* close = static_cast<const char*>(memchr(pos_, quote, static_cast<size_t>(end_ - pos_)));
+    if (close == nullptr) {
+        pos_ = end_;
+        return false;
+    }
+    value = XmlSlice{pos_, static_cast<size_t>(close - pos_)};
+    pos_ = close + 1;
+    return true;
+}
+
+XmlSlice XmlLocalName(const XmlSlice& name) {
+    const char* colon = static_cast<const char*>(memchr(name.data, ':', name.size));
+    if (colon == nullptr) {
+        return name;
+    }
+    return XmlSlice{colon + 1, static_cast<size_t>(name.data + name.size - colon - 1)};
+}
+
+void AppendXmlDecoded(const char* data, size_t size, std::string& out) {
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        const char* amp = static_cast<const char*>(memchr(p, '&', static_cast<size_t>(end - p)));
+        if (amp == nullptr) {
+            out.append(p, static_cast<size_t>(end - p));
+            return;
+        }
+        out.append(p, static_cast<size_t>(amp - p));
+        // 实体名不超过 10 个字符（&#x10FFFF; 等）
+        const size_t window = static_cast<size_t>(end - amp - 1) < 11 ? static_cast<size_t>(end - amp - 1) : 11;
+        const char* semi = static_cast<const char*>(memchr(amp + 1, ';', window));
+        if (semi != nullptr && AppendEntity(amp + 1, static_cast<size_t>(semi - amp - 1), out)) {
+            p = semi + 1;
+        } else {
+            out.push_back('&');
+            p = amp + 1;
+        }
+    }
+}
+
+bool ParseAppxManifest(const char* data, size_t size, AppxManifest& manifest) {
+    manifest = AppxManifest();
+    if (size >= 3 && memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+        data += 3;
+        size -= 3;
+    }
+
+    XmlTokenizer tokenizer(data, size);
+    XmlToken token;
+    std::vector<XmlSlice> stack;  // 祖先元素的本地名
+    std::string* textTarget = nullptr;
+    std::string framework;
+    bool visualElementsSeen = false;
+
+    while (tokenizer.Next(token)) {
+        if (token.type == XmlTokenType::Text) {
+            if (textTarget != nullptr) {
+                if (token.cdata) {
+                    textTarget->append(token.text.data, token.text.size);
+                } else {
+                    AppendXmlDecoded(token.text.data, token.text.size, *textTarget);
+                }
+            }
+            continue;
+        }
+        if (token.type == XmlTokenType::EndTag) {
+            if (!stack.empty()) {
+                stack.pop_back();
+            }
+            textTarget = nullptr;
+            continue;
+        }
+
+        const XmlSlice local = XmlLocalName(token.name);
+        const XmlSlice parent = stack.empty() ? XmlSlice() : stack.back();
+        XmlAttributeReader attributes(token.attributes);
+        XmlSlice name;
+        XmlSlice value;
+        textTarget = nullptr;
+
+        if (parent.Equals("Package")) {
+            if (local.Equals("Identity")) {
+                while (attributes.Next(name, value)) {
+                    if (name.Equals("Name")) {
+                        AssignDecoded(value, manifest.name);
+                    } else if (name.Equals("Publisher")) {
+                        AssignDecoded(value, manifest.publisher);
+                    } else if (name.Equals("Version")) {
+                        AssignDecoded(value, manifest.version);
+                    }
+                }
+            } else if (local.Equals("Applications")) {
+                manifest.hasApplications = true;
+            }
+        } else if (parent.Equals("Properties")) {
+            if (local.Equals("DisplayName") && !token.selfClosing) {
+                manifest.displayName.clear();
+                textTarget = &manifest.displayName;
+            } else if (local.Equals("Framework") && !token.selfClosing) {
+                framework.clear();
+                textTarget = &framework;
+            }
+        } else if (parent.Equals("Applications") && local.Equals("Application")) {
+            manifest.applications.emplace_back();
+            AppxManifestApplication& app = manifest.applications.back();
+            visualElementsSeen = false;
+            while (attributes.Next(name, value)) {
+                if (name.Equals("Id")) {
+                    AssignDecoded(value, app.id);
+                } else if (name.Equals("Executable")) {
+                    AssignDecoded(value, app.executable);
+                }
+            }
+        } else if (parent.Equals("Application") && local.Equals("VisualElements") && !visualElementsSeen &&
+                   !manifest.applications.empty()) {
+            AppxManifestApplication& app = manifest.applications.back();
+            visualElementsSeen = true;
+            while (attributes.Next(name, value)) {
+                if (name.Equals("DisplayName")) {
+                    AssignDecoded(value, app.displayName);
+                } else if (name.Equals("AppListEntry")) {
+                    AssignDecoded(value, app.appListEntry);
+                } else if (name.Equals("Square44x44Logo")) {
+                    AssignDecoded(value, app.square44x44Logo);
+                } else if (name.Equals("Square150x150Logo")) {
+                    AssignDecoded(value, app.square150x150Logo);
+                }
+            }
+        }
+
+        if (!token.selfClosing) {
+            stack.push_back(local);
+        }
+    }
+
+    const size_t first = framework.find_first_not_of(" \t\r\n");
+    manifest.framework = first != std::string::npos && framework.compare(first, 4, "true") == 0 &&
+                         framework.find_first_not_of(" \t\r\n", first + 4) == std::string::npos;
+    return !tokenizer.Failed();
+}
+
+}  // namespace ztools
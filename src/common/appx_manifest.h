@@ -0,0 +1,103 @@
+// AppxManifest.xml 解析（平台无关，Windows getUwpApps 使用）
+//
+// 原实现先把整个 manifest 转为 UTF-16，再对每个 Application 用 wstring::find 定位块、substr 复制，
+// 每取一个属性都要重新拼接 "<" + tag、复制整段标签文本，uap: 前缀与无前缀各查一遍；
+// 300 多个包时这些字符串复制占了枚举的大部分时间。这里改为在 UTF-8 字节上单遍扫描：
+// - XmlTokenizer 依次给出开始标签 / 结束标签 / 文本，名称与属性都指向输入缓冲区，不复制
+// - ParseAppxManifest 在一次扫描中收集 Identity、Properties、Applications 与 VisualElements，
+//   只有最终需要的属性值才解码实体并复制出来（元素按本地名匹配，uap: 等前缀均可）
+//
+// 只支持 manifest 用到的 XML 子集：不处理 DTD 与自定义实体，注释 / 处理指令 / DOCTYPE 被跳过。
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ztools {
+
+// 指向输入缓冲区的片段（不拥有内存）
+struct XmlSlice {
+    const char* data = nullptr;
+    size_t size = 0;
+
+    bool Empty() const { return size == 0; }
+    bool Equals(const char* text) const;
+    std::string ToString() const { return std::string(data, size); }
+};
+
+enum class XmlTokenType {
+    StartTag,
+    EndTag,
+    Text,
+};
+
+struct XmlToken {
+    XmlTokenType type = XmlTokenType::Text;
+    XmlSlice name;        // 开始 / 结束标签的限定名（含前缀）
+    XmlSlice attributes;  // 开始标签名之后、'>' 或 '/>' 之前的原始属性文本
+    XmlSlice text;        // 文本（未解码实体）；CDATA 段为其内容
+    bool selfClosing = false;
+    bool cdata = false;
+};
+
+class XmlTokenizer {
+public:
+    XmlTokenizer(const char* data, size_t size);
+
+    // 读取下一个记号；到达结尾或遇到格式错误时返回 false（Failed() 区分两者）
+    bool Next(XmlToken& token);
+    bool Failed() const { return failed_; }
+
+private:
+    bool Fail();
+
+    const char* pos_;
+    const char* end_;
+    bool failed_ = false;
+};
+
+// 逐个读取开始标签的属性（值不含引号、未解码实体）
+class XmlAttributeReader {
+public:
+    explicit XmlAttributeReader(const XmlSlice& attributes);
+
+    bool Next(XmlSlice& name, XmlSlice& value);
+
+private:
+    const char* pos_;
+    const char* end_;
+};
+
+// "uap:VisualElements" → "VisualElements"
+XmlSlice XmlLocalName(const XmlSlice& name);
+
+// 解码预定义实体与数字字符引用并追加到 out（UTF-8）；无法识别的实体原样保留
+void AppendXmlDecoded(const char* data, size_t size, std::string& out);
+
+struct AppxManifestApplication {
+    std::string id;
+    std::string executable;
+    // VisualElements 属性（已解码实体；可能为 ms-resource: 引用）
+    std::string displayName;
+    std::string appListEntry;
+    std::string square44x44Logo;
+    std::string square150x150Logo;
+};
+
+struct AppxManifest {
+    // Identity
+    std::string name;
+    std::string publisher;
+    std::string version;
+    // Properties
+    std::string displayName;
+    bool framework = false;
+    bool hasApplications = false;
+    std::vector<AppxManifestApplication> applications;
+};
+
+// 解析 UTF-8 manifest（可带 BOM）；XML 格式错误时返回 false，manifest 保留已解析的部分
+bool ParseAppxManifest(const char* data, size_t size, AppxManifest& manifest);
+
+}  // namespace ztools
@@ -0,0 +1,439 @@
+#include "base64.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZTOOLS_BASE64_SSE2 1
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define ZTOOLS_BASE64_SSSE3 1
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ZTOOLS_BASE64_NEON 1
+#endif
+
+namespace ztools {
+
+namespace {
+
+const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 解码表中的非法标记：四张表按位或后只要有一个字符非法，结果就不小于该值
+const uint32_t kInvalid = 0x01000000;
+
+struct Base64Tables {
+    char pairs[4096 * 2];   // 12 位 → 两个字符
+    uint32_t decode[4][256];  // 第 k 个字符的六位值预先左移 18 - 6k 位
+
+    Base64Tables() {
+        for (int i = 0; i < 4096; i++) {
+            pairs[i * 2] = kAlphabet[i >> 6];
+            pairs[i * 2 + 1] = kAlphabet[i & 0x3F];
+        }
+        for (int k = 0; k < 4; k++) {
+            for (int c = 0; c < 256; c++) {
+                decode[k][c] = kInvalid;
+            }
+            for (int s = 0; s < 64; s++) {
+                decode[k][static_cast<unsigned char>(kAlphabet[s])] = static_cast<uint32_t>(s) << (18 - 6 * k);
+            }
+        }
+    }
+};
+
+const Base64Tables& Tables() {
+    static const Base64Tables tables;
+    return tables;
+}
+
+inline bool IsBase64Space(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline void Store24(char* dst, uint32_t v) {
+    dst[0] = static_cast<char>(v >> 16);
+    dst[1] = static_cast<char>(v >> 8);
+    dst[2] = static_cast<char>(v);
+}
+
+#if defined(ZTOOLS_BASE64_SSE2)
+
+#if defined(ZTOOLS_BASE64_SSSE3)
+
+// 六位值（每字节 0..63）→ 字母表字符：按区间归约为 0..13 后查偏移表
+inline __m128i TranslateSextets(__m128i x) {
+    __m128i index = _mm_subs_epu8(x, _mm_set1_epi8(51));
+    index = _mm_or_si128(index, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), x), _mm_set1_epi8(13)));
+    const __m128i shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(x, _mm_shuffle_epi8(shift, index));
+}
+
+// 每个 32 位通道重排为 b1 | b0 << 8 | b2 << 16 | b1 << 24
+inline __m128i SpreadGroups(__m128i r) {
+    return _mm_shuffle_epi8(r, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+}
+
+#else
+
+// 六位值（每字节 0..63）→ 字母表字符：'A' + x，再按区间修正偏移
+inline __m128i TranslateSextets(__m128i x) {
+    __m128i offset = _mm_set1_epi8('A');
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(25)), _mm_set1_epi8(6)));
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(51)), _mm_set1_epi8(-75)));
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(61)), _mm_set1_epi8(-15)));
+    offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(63)), _mm_set1_epi8(3)));
+    return _mm_add_epi8(x, offset);
+}
+
+// 每个 32 位通道重排为 b1 | b0 << 8 | b2 << 16 | b1 << 24（无 pshufb：先按字节右移 0 / 3 / 6 / 9 取出
+// 各组，再把两个 16 位半字分别字节交换）
+inline __m128i SpreadGroups(__m128i r) {
+    const __m128i l = _mm_unpacklo_epi64(_mm_unpacklo_epi32(r, _mm_srli_si128(r, 3)),
+                                         _mm_unpacklo_epi32(_mm_srli_si128(r, 6), _mm_srli_si128(r, 9)));
+    const __m128i m = _mm_or_si128(_mm_and_si128(l, _mm_set1_epi32(0xFFFF)),
+                                   _mm_and_si128(_mm_slli_epi32(l, 8), _mm_set1_epi32(static_cast<int>(0xFFFF0000))));
+    return _mm_or_si128(_mm_slli_epi16(m, 8), _mm_srli_epi16(m, 8));
+}
+
+#endif
+
+// 每次 12 字节 → 16 个字符（读取 16 字节）；返回已消耗的输入字节数
+size_t EncodeBlocks(const unsigned char* src, size_t size, char* dst) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 12, dst += 16) {
+        const __m128i m = SpreadGroups(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        // 用 16 位乘法把 4 个六位值移到各自字节的低位
+        const __m128i hi = _mm_mulhi_epu16(_mm_and_si128(m, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        const __m128i lo = _mm_mullo_epi16(_mm_and_si128(m, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), TranslateSextets(_mm_or_si128(hi, lo)));
+    }
+    return i;
+}
+
+inline __m128i InRange(__m128i c, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                         _mm_cmplt_epi8(c, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+// 每次 16 个字符 → 12 字节，遇到含非字母表字符的块停止；返回已消耗的字符数，produced 为写入字节数
+size_t DecodeBlocks(const unsigned char* src, size_t size, char* dst, size_t* produced) {
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 16 <= size; i += 16, o += 12) {
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        // 字节按有符号比较：>= 0x80 的字符不落入任何区间
+        const __m128i upper = InRange(c, 'A', 'Z');
+        const __m128i lower = InRange(c, 'a', 'z');
+        const __m128i digit = InRange(c, '0', '9');
+        const __m128i plus = _mm_cmpeq_epi8(c, _mm_set1_epi8('+'));
+        const __m128i slash = _mm_cmpeq_epi8(c, _mm_set1_epi8('/'));
+        const __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash);
+        if (_mm_movemask_epi8(valid) != 0xFFFF) {
+            break;
+        }
+        __m128i x = _mm_and_si128(upper, _mm_sub_epi8(c, _mm_set1_epi8('A')));
+        x = _mm_or_si128(x, _mm_and_si128(lower, _mm_sub_epi8(c, _mm_set1_epi8('a' - 26))));
+        x = _mm_or_si128(x, _mm_and_si128(digit, _mm_add_epi8(c, _mm_set1_epi8(52 - '0'))));
+        x = _mm_or_si128(x, _mm_and_si128(plus, _mm_set1_epi8(62)));
+        x = _mm_or_si128(x, _mm_and_si128(slash, _mm_set1_epi8(63)));
+
+        // 通道内 x0 | x1 << 8 | x2 << 16 | x3 << 24 → x0 << 18 | x1 << 12 | x2 << 6 | x3
+#if defined(ZTOOLS_BASE64_SSSE3)
+        const __m128i pairs = _mm_maddubs_epi16(x, _mm_set1_epi32(0x01400140));
+        const __m128i v = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        // 每个通道取低 3 字节并转为大端，紧凑排列到前 12 字节
+        const __m128i packed =
+            _mm_shuffle_epi8(v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + o), packed);
+        const uint32_t tail = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed, 8)));
+        memcpy(dst + o + 8, &tail, 4);
+#else
+        __m128i v = _mm_slli_epi32(_mm_and_si128(x, _mm_set1_epi32(0x3F)), 18);
+        v = _mm_or_si128(v, _mm_and_si128(_mm_slli_epi32(x, 4), _mm_set1_epi32(0x3F000)));
+        v = _mm_or_si128(v, _mm_and_si128(_mm_srli_epi32(x, 10), _mm_set1_epi32(0xFC0)));
+        v = _mm_or_si128(v, _mm_srli_epi32(x, 24));
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), v);
+        for (int k = 0; k < 4; k++) {
+            Store24(dst + o + k * 3, lanes[k]);
+        }
+#endif
+    }
+    *produced = o;
+    return i;
+}
+
+#elif defined(ZTOOLS_BASE64_NEON)
+
+inline uint8x16_t TranslateSextets(uint8x16_t x) {
+    uint8x16_t offset = vdupq_n_u8('A');
+    offset = vaddq_u8(offset, vandq_u8(vcgtq_u8(x, vdupq_n_u8(25)), vdupq_n_u8(6)));
+    offset = vaddq_u8(offset, vandq_u8(vcgtq_u8(x, vdupq_n_u8(51)), vdupq_n_u8(static_cast<uint8_t>(-75))));
+    offset = vaddq_u8(offset, vandq_u8(vcgtq_u8(x, vdupq_n_u8(61)), vdupq_n_u8(static_cast<uint8_t>(-15))));
+    offset = vaddq_u8(offset, vandq_u8(vceqq_u8(x, vdupq_n_u8(63)), vdupq_n_u8(3)));
+    return vaddq_u8(x, offset);
+}
+
+// vld3 把 48 字节按 3 路解交织，vst4 把 4 路六位值交织写出 64 个字符
+size_t EncodeBlocks(const unsigned char* src, size_t size, char* dst) {
+    size_t i = 0;
+    for (; i + 48 <= size; i += 48, dst += 64) {
+        const uint8x16x3_t in = vld3q_u8(src + i);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vorrq_u8(vshlq_n_u8(vandq_u8(in.val[0], vdupq_n_u8(0x03)), 4), vshrq_n_u8(in.val[1], 4));
+        out.val[2] = vorrq_u8(vshlq_n_u8(vandq_u8(in.val[1], vdupq_n_u8(0x0F)), 2), vshrq_n_u8(in.val[2], 6));
+        out.val[3] = vandq_u8(in.val[2], vdupq_n_u8(0x3F));
+        for (int k = 0; k < 4; k++) {
+            out.val[k] = TranslateSextets(out.val[k]);
+        }
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst), out);
+    }
+    return i;
+}
+
+inline uint8x16_t InRange(uint8x16_t c, uint8_t lo, uint8_t hi) {
+    return vcltq_u8(vsubq_u8(c, vdupq_n_u8(lo)), vdupq_n_u8(static_cast<uint8_t>(hi - lo + 1)));
+}
+
+// 字符 → 六位值，valid 中非字母表字符对应字节为 0
+inline uint8x16_t DecodeSextets(uint8x16_t c, uint8x16_t& valid) {
+    const uint8x16_t upper = InRange(c, 'A', 'Z');
+    const uint8x16_t lower = InRange(c, 'a', 'z');
+    const uint8x16_t digit = InRange(c, '0', '9');
+    const uint8x16_t plus = vceqq_u8(c, vdupq_n_u8('+'));
+    const uint8x16_t slash = vceqq_u8(c, vdupq_n_u8('/'));
+    valid = vandq_u8(valid, vorrq_u8(vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(digit, plus)), slash));
+    uint8x16_t x = vandq_u8(upper, vsubq_u8(c, vdupq_n_u8('A')));
+    x = vorrq_u8(x, vandq_u8(lower, vsubq_u8(c, vdupq_n_u8('a' - 26))));
+    x = vorrq_u8(x, vandq_u8(digit, vaddq_u8(c, vdupq_n_u8(52 - '0'))));
+    x = vorrq_u8(x, vandq_u8(plus, vdupq_n_u8(62)));
+    return vorrq_u8(x, vandq_u8(slash, vdupq_n_u8(63)));
+}
+
+inline bool AllSet(uint8x16_t mask) {
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return vminvq_u8(mask) == 0xFF;
+#else
+    uint8x8_t m = vpmin_u8(vget_low_u8(mask), vget_high_u8(mask));
+    m = vpmin_u8(m, m);
+    m = vpmin_u8(m, m);
+    m = vpmin_u8(m, m);
+    return vget_lane_u8(m, 0) == 0xFF;
+#endif
+}
+
+// 每次 64 个字符 → 48 字节（vld4 / vst3），遇到含非字母表字符的块停止
+size_t DecodeBlocks(const unsigned char* src, size_t size, char* dst, size_t* produced) {
+    size_t i = 0;
+    size_t o = 0;
+    for (; i + 64 <= size; i += 64, o += 48) {
+        const uint8x16x4_t in = vld4q_u8(src + i);
+        uint8x16_t valid = vdupq_n_u8(0xFF);
+        const uint8x16_t x0 = DecodeSextets(in.val[0], valid);
+        const uint8x16_t x1 = DecodeSextets(in.val[1], valid);
+        const uint8x16_t x2 = DecodeSextets(in.val[2], valid);
+        const uint8x16_t x3 = DecodeSextets(in.val[3], valid);
+        if (!AllSet(valid)) {
+            break;
+        }
+        uint8x16x3_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(x0, 2), vshrq_n_u8(x1, 4));
+        out.val[1] = vorrq_u8(vshlq_n_u8(x1, 4), vshrq_n_u8(x2, 2));
+        out.val[2] = vorrq_u8(vshlq_n_u8(x2, 6), x3);
+        vst3q_u8(reinterpret_cast<uint8_t*>(dst + o), out);
+    }
+    *produced = o;
+    return i;
+}
+
+#endif
+
+// 逐 3 字节查表编码（12 位一张表，每次写两个字符）
+size_t EncodeScalar(const unsigned char* src, size_t size, char* dst) {
+    const char* pairs = Tables().pairs;
+    size_t i = 0;
+    char* out = dst;
+    for (; i + 3 <= size; i += 3, out += 4) {
+        const uint32_t v = (static_cast<uint32_t>(src[i]) << 16) | (static_cast<uint32_t>(src[i + 1]) << 8) | src[i + 2];
+        memcpy(out, pairs + (v >> 12) * 2, 2);
+        memcpy(out + 2, pairs + (v & 0xFFF) * 2, 2);
+    }
+    if (i < size) {
+        const uint32_t v = (static_cast<uint32_t>(src[i]) << 16) | (i + 1 < size ? static_cast<uint32_t>(src[i + 1]) << 8 : 0);
+        out[0] = kAlphabet[v >> 18];
+        out[1] = kAlphabet[(v >> 12) & 0x3F];
+        out[2] = i + 1 < size ? kAlphabet[(v >> 6) & 0x3F] : '=';
+        out[3] = '=';
+        out += 4;
+    }
+    return static_cast<size_t>(out - dst);
+}
+
+}  // namespace
+
+size_t EncodeBase64(const void* data, size_t size, char* dst, const Base64Options& options) {
+    const unsigned char* src = static_cast<const unsigned char*>(data);
+    size_t i = 0;
+    char* out = dst;
+#if defined(ZTOOLS_BASE64_SSE2) || defined(ZTOOLS_BASE64_NEON)
+    if (options.vectorized) {
+        i = EncodeBlocks(src, size, out);
+        out += i / 3 * 4;
+    }
+#else
+    (void)options;
+#endif
+    out += EncodeScalar(src + i, size - i, out);
+    return static_cast<size_t>(out - dst);
+}
+
+bool DecodeBase64(const char* data, size_t size, char* dst, size_t* written, const Base64Options& options) {
+    const unsigned char* src = reinterpret_cast<const unsigned char*>(data);
+    const Base64Tables& tables = Tables();
+    size_t i = 0;
+    size_t o = 0;
+    uint32_t acc = 0;
+    int pending = 0;  // 已累积、尚未凑满 4 个的字符数
+#if defined(ZTOOLS_BASE64_SSE2) || defined(ZTOOLS_BASE64_NEON)
+    // 向量块失败（空白、'='）后先逐字符处理一段，避免每个字符都重新试探
+    size_t scalarUntil = options.vectorized ? 0 : size;
+#else
+    (void)options;
+#endif
+
+    while (i < size) {
+#if defined(ZTOOLS_BASE64_SSE2) || defined(ZTOOLS_BASE64_NEON)
+        if (pending == 0 && i >= scalarUntil) {
+            size_t produced = 0;
+            i += DecodeBlocks(src + i, size - i, dst + o, &produced);
+            o += produced;
+            scalarUntil = i + 64;
+            if (i >= size) {
+                break;
+            }
+        }
+#endif
+        if (pending == 0 && i + 4 <= size) {
+            const uint32_t v = tables.decode[0][src[i]] | tables.decode[1][src[i + 1]] |
+                               tables.decode[2][src[i + 2]] | tables.decode[3][src[i + 3]];
+            if (v < kInvalid) {
+                Store24(dst + o, v);
+                o += 3;
+                i += 4;
+                continue;
+            }
+        }
+        const unsigned char c = src[i++];
+        if (IsBase64Space(c)) {
+            continue;
+        }
+        if (c == '=') {
+            i--;
+            break;
+        }
+        const uint32_t s = tables.decode[3][c];
+        if (s >= kInvalid) {
+            return false;
+        }
+        acc = (acc << 6) | s;
+        if (++pending == 4) {
+            Store24(dst + o, acc);
+            o += 3;
+            acc = 0;
+            pending = 0;
+        }
+    }
+
+    // 结尾：最多两个 '='，之后只允许空白
+    int padding = 0;
+    for (; i < size; i++) {
+        if (src[i] == '=') {
+            padding++;
+        } else if (!IsBase64Space(src[i])) {
+            return false;
+        }
+    }
+    if (padding > 2 || pending == 1 || (pending == 0 && padding != 0)) {
+        return false;
+    }
+    if (pending == 2) {
+        dst[o++] = static_cast<char>(acc >> 4);
+    } else if (pending == 3) {
+        dst[o++] = static_cast<char>(acc >> 10);
+        dst[o++] = static_cast<char>(acc >> 2);
+    }
+    *written = o;
+    return true;
+}
+
+void AppendBase64(const void* data, size_t size, std::string& out, const Base64Options& options) {
+    const size_t offset = out.size();
+    out.resize(offset + Base64EncodedSize(size));
+    if (size > 0) {
+        EncodeBase64(data, size, &out[offset], options);
+    }
+}
+
+std::string Base64Encode(const void* data, size_t size, const Base64Options& options) {
+    std::string out;
+    AppendBase64(data, size, out, options);
+    return out;
+}
+
+bool Base64Decode(const char* data, size_t size, std::string& out, const Base64Options& options) {
+    out.resize(Base64DecodedMaxSize(size));
+    size_t written = 0;
+    if (!DecodeBase64(data, size, &out[0], &written, options)) {
+        out.clear();
+        return false;
+    }
+    out.resize(written);
+    return true;
+}
+
+std::string Base64DataUrl(const char* mimeType, const void* data, size_t size) {
+    static const char kScheme[] = "data:";
+    static const char kEncoding[] = ";base64,";
+    const size_t mimeLength = strlen(mimeType);
+    std::string url;
+    url.reserve(sizeof(kScheme) - 1 + mimeLength + sizeof(kEncoding) - 1 + Base64EncodedSize(size));
+    url.append(kScheme, sizeof(kScheme) - 1);
+    url.append(mimeType, mimeLength);
+    url.append(kEncoding, sizeof(kEncoding) - 1);
+    AppendBase64(data, size, url);
+    return url;
+}
+
+bool DecodeBase64DataUrl(const char* data, size_t size, std::string& out, std::string* mimeType) {
+    static const char kScheme[] = "data:";
+    static const char kEncoding[] = ";base64";
+    if (mimeType != nullptr) {
+        mimeType->clear();
+    }
+    if (size < sizeof(kScheme) - 1 || memcmp(data, kScheme, sizeof(kScheme) - 1) != 0) {
+        return Base64Decode(data, size, out);
+    }
+
+    // 头部到第一个 ',' 为止，必须以 ";base64" 结尾（不支持百分号编码的 data URL）
+    const char* begin = data + sizeof(kScheme) - 1;
+    const char* end = data + size;
+    const char* comma = static_cast<const char*>(memchr(begin, ',', static_cast<size_t>(end - begin)));
+    const size_t markerLength = sizeof(kEncoding) - 1;
+    if (comma == nullptr || static_cast<size_t>(comma - begin) < markerLength ||
+        memcmp(comma - markerLength, kEncoding, markerLength) != 0) {
+        out.clear();
+        return false;
+    }
+    if (mimeType != nullptr) {
+        const char* mimeEnd = static_cast<const char*>(memchr(begin, ';', static_cast<size_t>(comma - begin)));
+        mimeType->assign(begin, mimeEnd);
+    }
+    return Base64Decode(comma + 1, static_cast<size_t>(end - comma - 1), out);
+}
+
+}  // namespace ztools
@@ -0,0 +1,56 @@
+// Base64 编解码（平台无关，各绑定共用）
+//
+// 剪贴板图像、截图、选中内容都以 base64 PNG 交给 JS，原来 Windows / macOS 各有一份逐字节
+// push_back 的编码器，截图的 data URL 还要再拼接前缀复制一遍，Windows 读取剪贴板图像时又走
+// CryptBinaryToStringA（求长度、编码两遍）。这里统一为按精确长度一次分配、直接写入目标缓冲区：
+// - 编码：x86 每次把 12 字节展开为 16 个六位值（SSSE3 用 pshufb 重排与查表，仅 SSE2 时用移位与比较），
+//   NEON 用 vld3 / vst4 每次处理 48 字节；其他平台按 12 位查表，每次输出两个字符
+// - 解码：SSE2 / NEON 每次校验并合并 16 / 64 个字符，遇到含非字母表字符（空白、'='）的块退回逐字符
+//   处理；逐字符路径用四张预移位的表把 4 个字符合并为 3 字节
+// SSSE3 路径在编译时按 __SSSE3__ / __AVX__ 选择，不做运行时检测。
+//
+// 解码接受标准字母表，忽略 ASCII 空白，结尾的 '=' 可以省略；其他字符或长度非法时返回 false。
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace ztools {
+
+struct Base64Options {
+    bool vectorized = true;  // false 时使用逐字符 / 查表实现（用于测试与基准对比）
+};
+
+// 编码后的长度（含 '=' 填充）
+inline size_t Base64EncodedSize(size_t size) {
+    return (size + 2) / 3 * 4;
+}
+
+// 解码结果的上限（实际长度由 DecodeBase64 返回）
+inline size_t Base64DecodedMaxSize(size_t size) {
+    return size / 4 * 3 + 2;
+}
+
+// 底层编码：dst 至少 Base64EncodedSize(size) 字节，返回写入字节数
+size_t EncodeBase64(const void* data, size_t size, char* dst, const Base64Options& options = Base64Options());
+
+// 底层解码：dst 至少 Base64DecodedMaxSize(size) 字节；成功时 written 为写入字节数
+bool DecodeBase64(const char* data, size_t size, char* dst, size_t* written,
+                  const Base64Options& options = Base64Options());
+
+// 追加到 out 末尾（原地扩容后直接写入，不经过临时字符串）
+void AppendBase64(const void* data, size_t size, std::string& out, const Base64Options& options = Base64Options());
+
+std::string Base64Encode(const void* data, size_t size, const Base64Options& options = Base64Options());
+
+// 失败时 out 为空
+bool Base64Decode(const char* data, size_t size, std::string& out, const Base64Options& options = Base64Options());
+
+// "data:<mimeType>;base64,<数据>"，一次分配
+std::string Base64DataUrl(const char* mimeType, const void* data, size_t size);
+
+// 解析 base64 data URL（"data:[<mime>][;参数];base64,<数据>"）；不带 "data:" 前缀时按纯 base64 解码。
+// mimeType 可为空指针
+bool DecodeBase64DataUrl(const char* data, size_t size, std::string& out, std::string* mimeType = nullptr);
+
+}  // namespace ztools
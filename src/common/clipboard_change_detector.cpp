@@ -0,0 +1,183 @@
+#include "clipboard_change_detector.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ztools {
+
+namespace {
+
+// 已结束但区间内序列号迟迟未上报的令牌（例如后端丢失了通知）最多保留的数量
+const size_t kMaxClosedSelfWrites = 32;
+
+}  // namespace
+
+ClipboardChangeDetector::ClipboardChangeDetector() : paused_(false), stats_{}, nextToken_(1) {
+    for (int i = 0; i < kClipboardSourceCount; i++) {
+        enabled_[i] = false;
+        lastSequence_[i] = 0;
+    }
+    enabled_[static_cast<int>(ClipboardSource::Clipboard)] = true;
+}
+
+void ClipboardChangeDetector::SetSink(Sink sink) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_ = std::move(sink);
+}
+
+void ClipboardChangeDetector::SetSourceEnabled(ClipboardSource source, bool enabled) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_[static_cast<int>(source)] = enabled;
+}
+
+bool ClipboardChangeDetector::IsSourceEnabled(ClipboardSource source) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return enabled_[static_cast<int>(source)];
+}
+
+void ClipboardChangeDetector::SetPaused(bool paused) {
+    paused_ = paused;
+}
+
+bool ClipboardChangeDetector::IsPaused() const {
+    return paused_;
+}
+
+uint64_t ClipboardChangeDetector::BeginSelfWrite(ClipboardSource source, uint64_t currentSequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SelfWrite write;
+    write.token = nextToken_++;
+    write.source = source;
+    write.after = currentSequence;
+    write.until = 0;
+    write.open = true;
+    selfWrites_.push_back(write);
+    return write.token;
+}
+
+void ClipboardChangeDetector::EndSelfWrite(uint64_t token, uint64_t finalSequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (SelfWrite& write : selfWrites_) {
+        if (write.token == token) {
+            write.open = false;
+            write.until = finalSequence;
+            break;
+        }
+    }
+    PruneSelfWrites();
+}
+
+bool ClipboardChangeDetector::IsSelfWrite(int index, uint64_t sequence) const {
+    for (const SelfWrite& write : selfWrites_) {
+        if (static_cast<int>(write.source) != index) {
+            continue;
+        }
+        if (write.open) {
+            // 序列号为 0 时无法判断先后，进行中的写入一律视为自身写入
+            if (sequence == 0 || sequence > write.after) {
+                return true;
+            }
+        } else if (sequence != 0 && sequence > write.after && sequence <= write.until) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ClipboardChangeDetector::PruneSelfWrites() {
+    // 区间内序列号已全部上报（或写入未产生新序列号）的令牌不再需要
+    selfWrites_.erase(std::remove_if(selfWrites_.begin(), selfWrites_.end(),
+                                     [this](const SelfWrite& write) {
+                                         return !write.open &&
+                                                (write.until <= write.after ||
+                                                 write.until <= lastSequence_[static_cast<int>(write.source)]);
+                                     }),
+                      selfWrites_.end());
+
+    size_t closed = 0;
+    for (const SelfWrite& write : selfWrites_) {
+        closed += write.open ? 0 : 1;
+    }
+    for (auto it = selfWrites_.begin(); closed > kMaxClosedSelfWrites && it != selfWrites_.end();) {
+        if (!it->open) {
+            it = selfWrites_.erase(it);
+            closed--;
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool ClipboardChangeDetector::Report(ClipboardSource source, uint64_t sequence, uint64_t selectionTime) {
+    Sink sink;
+    ClipboardChange change;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const int index = static_cast<int>(source);
+        stats_.reported++;
+
+        // 序列号为 0 表示平台无法提供，不参与去重
+        if (sequence != 0 && sequence == lastSequence_[index]) {
+            stats_.duplicates++;
+            return false;
+        }
+        lastSequence_[index] = sequence;
+
+        if (!enabled_[index]) {
+            stats_.filtered++;
+            return false;
+        }
+        if (!selfWrites_.empty() && IsSelfWrite(index, sequence)) {
+            stats_.suppressed++;
+            PruneSelfWrites();
+            return false;
+        }
+        if (paused_) {
+            stats_.paused++;
+            return false;
+        }
+
+        stats_.dispatched++;
+        sink = sink_;
+        change.source = source;
+        change.sequence = sequence;
+        change.selectionTime = selectionTime;
+        change.detectedAtUs = NowUs();
+    }
+
+    // 在锁外分发，避免 sink 回调中再次访问检测器造成死锁
+    if (sink) {
+        sink(change);
+    }
+    return true;
+}
+
+uint64_t ClipboardChangeDetector::LastSequence(ClipboardSource source) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastSequence_[static_cast<int>(source)];
+}
+
+ClipboardChangeStats ClipboardChangeDetector::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ClipboardChangeDetector::Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < kClipboardSourceCount; i++) {
+        lastSequence_[i] = 0;
+    }
+    stats_ = ClipboardChangeStats{};
+    paused_ = false;
+    // 进行中的自身写入令牌保留：监控重启不应让正在进行的 getSelectedContent 泄漏事件
+    selfWrites_.erase(std::remove_if(selfWrites_.begin(), selfWrites_.end(),
+                                     [](const SelfWrite& write) { return !write.open; }),
+                      selfWrites_.end());
+}
+
+uint64_t ClipboardChangeDetector::NowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+}  // namespace ztools
@@ -0,0 +1,126 @@
+// 剪贴板变化检测核心（平台无关）
+//
+// 各平台后端（Win32 WM_CLIPBOARDUPDATE、macOS changeCount、X11 XFixes）只负责
+// 上报“原始变化信号 + 序列号”，由本模块统一完成：
+// - 按来源过滤（例如 X11 PRIMARY 默认不通知 JS）
+// - 重复序列号去重（同一次变化被上报多次时只分发一次）
+// - 暂停状态处理（JS 调用 pause() 期间不触发回调）
+// - 自身写入抑制：getSelectedContent 等写剪贴板前后登记序列号区间，
+//   恰好丢弃这些序列号对应的变化，不再依赖“暂停 + 延迟恢复”的时间窗口
+// - 统计计数（便于无头环境下测试与基准）
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace ztools {
+
+// 变化来源
+enum class ClipboardSource : uint8_t {
+    Clipboard = 0,  // 系统剪贴板（Win32/macOS 剪贴板、X11 CLIPBOARD 选区）
+    Primary = 1,    // X11 PRIMARY 选区（选中即复制）
+};
+
+static const int kClipboardSourceCount = 2;
+
+// 一次已确认的剪贴板变化
+struct ClipboardChange {
+    ClipboardSource source;
+    uint64_t sequence;      // 平台序列号；0 表示平台无法提供（不参与去重）
+    uint64_t selectionTime; // 平台时间戳（X11 选区时间戳，其他平台为 0）
+    uint64_t detectedAtUs;  // 检测到变化时的单调时钟（微秒）
+};
+
+// 统计计数
+struct ClipboardChangeStats {
+    uint64_t reported;    // 后端上报的原始信号数
+    uint64_t dispatched;  // 实际分发给 sink 的变化数
+    uint64_t duplicates;  // 因序列号重复被丢弃的信号数
+    uint64_t paused;      // 暂停期间被丢弃的信号数
+    uint64_t filtered;    // 因来源未启用被丢弃的信号数
+    uint64_t suppressed;  // 属于自身写入被丢弃的信号数
+};
+
+class ClipboardChangeDetector {
+public:
+    using Sink = std::function<void(const ClipboardChange&)>;
+
+    ClipboardChangeDetector();
+
+    // 设置变化分发目标（应在后端启动前设置）
+    void SetSink(Sink sink);
+
+    // 启用/禁用某个来源（默认仅启用 Clipboard）
+    void SetSourceEnabled(ClipboardSource source, bool enabled);
+    bool IsSourceEnabled(ClipboardSource source) const;
+
+    void SetPaused(bool paused);
+    bool IsPaused() const;
+
+    // 自身写入抑制：写剪贴板前以当前序列号开始，写完后以最终序列号结束。
+    // 进行中时丢弃该来源大于起始序列号的全部变化（序列号为 0 的平台也丢弃）；
+    // 结束后只丢弃 (起始, 最终] 区间内尚未上报的变化，之后的用户复制照常分发。
+    // 返回的令牌传给 EndSelfWrite；令牌在区间内序列号全部上报后自动回收
+    uint64_t BeginSelfWrite(ClipboardSource source, uint64_t currentSequence);
+    void EndSelfWrite(uint64_t token, uint64_t finalSequence);
+
+    // 后端上报一次原始变化信号，返回是否分发给 sink
+    bool Report(ClipboardSource source, uint64_t sequence, uint64_t selectionTime = 0);
+
+    // 最近一次上报的序列号（无论是否分发）
+    uint64_t LastSequence(ClipboardSource source) const;
+
+    ClipboardChangeStats Stats() const;
+
+    // 重置序列号与统计（监控重新启动时调用）
+    void Reset();
+
+    // 单调时钟（微秒）
+    static uint64_t NowUs();
+
+private:
+    struct SelfWrite {
+        uint64_t token;
+        ClipboardSource source;
+        uint64_t after;  // 起始序列号（不含）
+        uint64_t until;  // 最终序列号（含）；进行中为 0
+        bool open;
+    };
+
+    // 调用方需持有 mutex_
+    bool IsSelfWrite(int index, uint64_t sequence) const;
+    void PruneSelfWrites();
+
+    mutable std::mutex mutex_;
+    Sink sink_;
+    std::atomic<bool> paused_;
+    bool enabled_[kClipboardSourceCount];
+    uint64_t lastSequence_[kClipboardSourceCount];
+    ClipboardChangeStats stats_;
+    std::vector<SelfWrite> selfWrites_;
+    uint64_t nextToken_;
+};
+
+// 作用域内的自身写入：构造时以当前序列号开始，析构时以当前序列号结束
+class ClipboardSelfWriteScope {
+public:
+    using SequenceFn = std::function<uint64_t()>;
+
+    ClipboardSelfWriteScope(ClipboardChangeDetector& detector, ClipboardSource source, SequenceFn sequence)
+        : detector_(detector), sequence_(std::move(sequence)),
+          token_(detector.BeginSelfWrite(source, sequence_())) {}
+    ~ClipboardSelfWriteScope() { detector_.EndSelfWrite(token_, sequence_()); }
+
+    ClipboardSelfWriteScope(const ClipboardSelfWriteScope&) = delete;
+    ClipboardSelfWriteScope& operator=(const ClipboardSelfWriteScope&) = delete;
+
+private:
+    ClipboardChangeDetector& detector_;
+    SequenceFn sequence_;
+    uint64_t token_;
+};
+
+}  // namespace ztools
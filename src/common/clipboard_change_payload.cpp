@@ -0,0 +1,48 @@
+#include "clipboard_change_payload.h"
+
+namespace ztools {
+
+std::string TruncateUtf8(const std::string& text, size_t maxBytes, bool* truncated) {
+    if (text.size() <= maxBytes) {
+        if (truncated) *truncated = false;
+        return text;
+    }
+    if (truncated) *truncated = true;
+
+    // 从截断点向前回退到字符起始字节（非 10xxxxxx 续字节）
+    size_t end = maxBytes;
+    while (end > 0 && (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+        end--;
+    }
+    return text.substr(0, end);
+}
+
+const char* StandardClipboardFormatName(uint32_t id) {
+    // 取值与 winuser.h 中的 CF_* 常量一致
+    static const char* const kNames[] = {
+        nullptr,
+        "CF_TEXT",          // 1
+        "CF_BITMAP",        // 2
+        "CF_METAFILEPICT",  // 3
+        "CF_SYLK",          // 4
+        "CF_DIF",           // 5
+        "CF_TIFF",          // 6
+        "CF_OEMTEXT",       // 7
+        "CF_DIB",           // 8
+        "CF_PALETTE",       // 9
+        "CF_PENDATA",       // 10
+        "CF_RIFF",          // 11
+        "CF_WAVE",          // 12
+        "CF_UNICODETEXT",   // 13
+        "CF_ENHMETAFILE",   // 14
+        "CF_HDROP",         // 15
+        "CF_LOCALE",        // 16
+        "CF_DIBV5",         // 17
+    };
+    if (id >= sizeof(kNames) / sizeof(kNames[0])) {
+        return nullptr;
+    }
+    return kNames[id];
+}
+
+}  // namespace ztools
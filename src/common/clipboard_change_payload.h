@@ -0,0 +1,59 @@
+// 剪贴板变化通知负载（可选）
+//
+// 默认情况下变化回调不带参数，JS 收到通知后会立即回调 getClipboardFiles 等接口，
+// 导致防抖定时器刚触发就再次打开剪贴板（此时 Edge/Office 可能仍在写入）。
+// 启用负载模式后，监控线程在同一次 OpenClipboard 会话内读取格式列表、大小、
+// 序列号、所有者进程和文本预览，随通知一并交给 JS。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "text_classifier.h"
+
+namespace ztools {
+
+// 默认文本预览长度（UTF-8 字节）
+static const size_t kDefaultClipboardPreviewBytes = 256;
+
+// 单个剪贴板格式
+struct ClipboardFormatInfo {
+    uint32_t id;       // 平台格式 ID（Windows CF_*/注册格式）
+    std::string name;  // 格式名称（标准格式使用 CF_* 名称）
+    int64_t size;      // 数据字节数；-1 表示未查询（避免触发延迟渲染）
+};
+
+// 一次变化的完整负载
+struct ClipboardChangePayload {
+    uint64_t sequence = 0;      // 平台序列号
+    uint64_t detectedAtUs = 0;  // 检测到变化的单调时钟（微秒）
+    bool opened = false;        // 是否成功打开剪贴板（失败时仅序列号有效）
+
+    std::vector<ClipboardFormatInfo> formats;
+
+    uint32_t ownerPid = 0;      // 剪贴板所有者进程 ID（0 表示未知）
+    std::string ownerApp;       // 所有者程序名（含扩展名）
+    std::string ownerAppPath;   // 所有者程序完整路径
+
+    bool hasText = false;
+    std::string textPreview;    // 文本预览（UTF-8，按字符边界截断）
+    bool textTruncated = false; // 预览是否被截断
+
+    uint32_t fileCount = 0;     // 文件数量（CF_HDROP）
+
+    bool classified = false;               // 是否已对完整文本分类（classify 选项）
+    TextClassification classification;     // 匹配片段偏移为 UTF-16 单元（JS 字符串下标）
+    std::vector<std::string> matchTexts;   // 与 classification.matches 一一对应的片段文本
+
+    uint64_t historyId = 0;     // 写入剪贴板历史后的条目 id（未启用历史时为 0）
+};
+
+// 按 UTF-8 字符边界截断到不超过 maxBytes 字节，不会产生半个字符
+std::string TruncateUtf8(const std::string& text, size_t maxBytes, bool* truncated = nullptr);
+
+// Windows 标准剪贴板格式（CF_TEXT = 1 ... CF_DIBV5 = 17）的名称；非标准格式返回 nullptr
+const char* StandardClipboardFormatName(uint32_t id);
+
+}  // namespace ztools
@@ -0,0 +1,326 @@
+#include "clipboard_history.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+#include "content_hash.h"
+
+namespace ztools {
+
+namespace {
+
+uint64_t NowUnixMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+}  // namespace
+
+ClipboardHistory::ClipboardHistory(const ClipboardHistoryOptions& options)
+    : nextId_(1), totalBytes_(0), stats_{} {
+    options_ = options;
+    if (options_.maxEntries == 0) {
+        options_.maxEntries = 1;
+    }
+    ResizeLocked(options_.maxEntries);
+}
+
+void ClipboardHistory::Configure(const ClipboardHistoryOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+    if (options_.maxEntries == 0) {
+        options_.maxEntries = 1;
+    }
+    ResizeLocked(options_.maxEntries);
+    EvictLocked(0, 0);
+}
+
+ClipboardHistoryOptions ClipboardHistory::Options() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+uint64_t ClipboardHistory::HashFormats(const std::vector<ClipboardHistoryFormat>& formats) {
+    ContentHasher hasher;
+    for (const ClipboardHistoryFormat& format : formats) {
+        // 写入长度前缀，避免 ("ab","c") 与 ("a","bc") 哈希相同
+        uint64_t nameLength = format.name.size();
+        uint64_t dataLength = format.data.size();
+        hasher.Update(&nameLength, sizeof(nameLength));
+        hasher.Update(format.name);
+        hasher.Update(&dataLength, sizeof(dataLength));
+        hasher.Update(format.data);
+    }
+    return hasher.Digest();
+}
+
+bool ClipboardHistory::SameContent(const Entry& entry, const std::vector<ClipboardHistoryFormat>& formats) {
+    if (entry.formats.size() != formats.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < formats.size(); i++) {
+        if (entry.formats[i].first != formats[i].name || *entry.formats[i].second != formats[i].data) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t ClipboardHistory::Add(std::vector<ClipboardHistoryFormat> formats, uint64_t sequence, uint64_t nowMs) {
+    if (formats.empty()) {
+        return 0;
+    }
+    if (nowMs == 0) {
+        nowMs = NowUnixMs();
+    }
+
+    size_t bytes = 0;
+    for (const ClipboardHistoryFormat& format : formats) {
+        bytes += format.data.size();
+    }
+    // 哈希在锁外计算（图片可能有数 MB）
+    const uint64_t hash = HashFormats(formats);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bytes > options_.maxBytes) {
+        stats_.rejected++;
+        return 0;
+    }
+
+    // 去重：哈希命中后再逐字节确认，防止极小概率的哈希碰撞
+    auto range = byHash_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        Entry& entry = slots_[it->second];
+        if (!SameContent(entry, formats)) {
+            continue;
+        }
+        entry.lastSeenAtMs = nowMs;
+        entry.sequence = sequence;
+        entry.copyCount++;
+        // 移动到最新位置
+        UnlinkLocked(it->second);
+        LinkNewestLocked(it->second);
+        stats_.duplicates++;
+        return entry.id;
+    }
+
+    EvictLocked(bytes, 1);
+
+    const uint32_t slot = freeSlots_.back();
+    freeSlots_.pop_back();
+    Entry& entry = slots_[slot];
+    entry.used = true;
+    entry.id = nextId_++;
+    entry.hash = hash;
+    entry.sequence = sequence;
+    entry.createdAtMs = nowMs;
+    entry.lastSeenAtMs = nowMs;
+    entry.copyCount = 1;
+    entry.bytes = bytes;
+    entry.formats.clear();
+    entry.formats.reserve(formats.size());
+    for (ClipboardHistoryFormat& format : formats) {
+        entry.formats.emplace_back(std::move(format.name),
+                                   std::make_shared<const std::string>(std::move(format.data)));
+    }
+
+    LinkNewestLocked(slot);
+    byHash_.emplace(hash, slot);
+    byId_[entry.id] = slot;
+    totalBytes_ += bytes;
+    stats_.added++;
+    return entry.id;
+}
+
+size_t ClipboardHistory::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+ClipboardHistoryEntryInfo ClipboardHistory::InfoLocked(const Entry& entry) const {
+    ClipboardHistoryEntryInfo info;
+    info.id = entry.id;
+    info.hash = entry.hash;
+    info.sequence = entry.sequence;
+    info.createdAtMs = entry.createdAtMs;
+    info.lastSeenAtMs = entry.lastSeenAtMs;
+    info.copyCount = entry.copyCount;
+    info.bytes = entry.bytes;
+    info.formats.reserve(entry.formats.size());
+    for (const auto& format : entry.formats) {
+        info.formats.push_back(ClipboardHistoryFormatInfo{format.first, format.second->size()});
+    }
+    return info;
+}
+
+std::vector<ClipboardHistoryEntryInfo> ClipboardHistory::Page(size_t offset, size_t count) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ClipboardHistoryEntryInfo> result;
+    if (offset >= count_) {
+        return result;
+    }
+    result.reserve(std::min(count, count_ - offset));
+    // 索引 0 对应链表最新端
+    uint32_t slot = newest_;
+    for (size_t i = 0; i < offset; i++) {
+        slot = slots_[slot].older;
+    }
+    for (; slot != kNoSlot && result.size() < count; slot = slots_[slot].older) {
+        result.push_back(InfoLocked(slots_[slot]));
+    }
+    return result;
+}
+
+int ClipboardHistory::FindSlotLocked(uint64_t id) const {
+    auto it = byId_.find(id);
+    return it == byId_.end() ? -1 : static_cast<int>(it->second);
+}
+
+bool ClipboardHistory::GetInfo(uint64_t id, ClipboardHistoryEntryInfo& info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int slot = FindSlotLocked(id);
+    if (slot < 0) {
+        return false;
+    }
+    info = InfoLocked(slots_[slot]);
+    return true;
+}
+
+std::shared_ptr<const std::string> ClipboardHistory::GetData(uint64_t id, const std::string& format) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int slot = FindSlotLocked(id);
+    if (slot < 0) {
+        return nullptr;
+    }
+    for (const auto& item : slots_[slot].formats) {
+        if (item.first == format) {
+            return item.second;
+        }
+    }
+    return nullptr;
+}
+
+void ClipboardHistory::LinkNewestLocked(uint32_t slot) {
+    Entry& entry = slots_[slot];
+    entry.older = newest_;
+    entry.newer = kNoSlot;
+    if (newest_ != kNoSlot) {
+        slots_[newest_].newer = slot;
+    } else {
+        oldest_ = slot;
+    }
+    newest_ = slot;
+    count_++;
+}
+
+void ClipboardHistory::UnlinkLocked(uint32_t slot) {
+    Entry& entry = slots_[slot];
+    if (entry.older != kNoSlot) {
+        slots_[entry.older].newer = entry.newer;
+    } else {
+        oldest_ = entry.newer;
+    }
+    if (entry.newer != kNoSlot) {
+        slots_[entry.newer].older = entry.older;
+    } else {
+        newest_ = entry.older;
+    }
+    entry.older = kNoSlot;
+    entry.newer = kNoSlot;
+    count_--;
+}
+
+// 从链表摘下并归还槽位
+void ClipboardHistory::ReleaseSlotLocked(uint32_t slot) {
+    UnlinkLocked(slot);
+    Entry& entry = slots_[slot];
+    auto range = byHash_.equal_range(entry.hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == slot) {
+            byHash_.erase(it);
+            break;
+        }
+    }
+    byId_.erase(entry.id);
+    totalBytes_ -= entry.bytes;
+    entry = Entry();
+    freeSlots_.push_back(slot);
+}
+
+bool ClipboardHistory::Remove(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int slot = FindSlotLocked(id);
+    if (slot < 0) {
+        return false;
+    }
+    ReleaseSlotLocked(static_cast<uint32_t>(slot));
+    return true;
+}
+
+void ClipboardHistory::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (oldest_ != kNoSlot) {
+        ReleaseSlotLocked(oldest_);
+    }
+}
+
+void ClipboardHistory::ReserveIds(uint64_t nextId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nextId > nextId_) {
+        nextId_ = nextId;
+    }
+}
+
+void ClipboardHistory::EvictLocked(size_t incomingBytes, size_t keepFreeSlots) {
+    // 从链表最旧端淘汰
+    while (oldest_ != kNoSlot &&
+           (totalBytes_ + incomingBytes > options_.maxBytes || freeSlots_.size() < keepFreeSlots)) {
+        ReleaseSlotLocked(oldest_);
+        stats_.evicted++;
+    }
+}
+
+void ClipboardHistory::ResizeLocked(size_t maxEntries) {
+    if (maxEntries == slots_.size()) {
+        return;
+    }
+
+    // 先淘汰超出新容量的旧条目，再把剩余条目从旧到新搬到新的槽位数组（槽位 0 最旧）
+    while (count_ > maxEntries) {
+        ReleaseSlotLocked(oldest_);
+        stats_.evicted++;
+    }
+
+    std::vector<Entry> slots(maxEntries);
+    const uint32_t kept = static_cast<uint32_t>(count_);
+    byHash_.clear();
+    byId_.clear();
+    uint32_t slot = 0;
+    for (uint32_t oldSlot = oldest_; oldSlot != kNoSlot; oldSlot = slots_[oldSlot].newer, slot++) {
+        slots[slot] = std::move(slots_[oldSlot]);
+        slots[slot].older = slot == 0 ? kNoSlot : slot - 1;
+        slots[slot].newer = slot + 1 == kept ? kNoSlot : slot + 1;
+        byHash_.emplace(slots[slot].hash, slot);
+        byId_[slots[slot].id] = slot;
+    }
+
+    slots_ = std::move(slots);
+    oldest_ = kept == 0 ? kNoSlot : 0;
+    newest_ = kept == 0 ? kNoSlot : kept - 1;
+    freeSlots_.clear();
+    for (size_t free = maxEntries; free > kept; free--) {
+        freeSlots_.push_back(static_cast<uint32_t>(free - 1));
+    }
+}
+
+ClipboardHistoryStats ClipboardHistory::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ClipboardHistoryStats stats = stats_;
+    stats.entries = count_;
+    stats.bytes = totalBytes_;
+    return stats;
+}
+
+}  // namespace ztools
@@ -0,0 +1,136 @@
+// 原生剪贴板历史（平台无关）
+//
+// 监控线程在检测到变化时直接把内容写入历史，JS 只需按索引分页读取条目元数据，
+// 需要内容时再按 id 取单个格式的数据，避免每次复制都把完整文本/图片传到 JS 再比较字符串。
+//
+// 结构：
+// - 条目存放在预分配的固定槽位中（最多 maxEntries 个，不随复制次数增长）
+// - 槽位之间以侵入式双向链表按最近使用排序（oldest_ → newest_），索引 0 表示最新条目
+// - 64 位内容哈希 -> 槽位的哈希表，重复内容 O(1) 命中后 O(1) 摘下并挂到最新位置
+// - 总字节数超过 maxBytes 时按 LRU 淘汰最久未使用的条目
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ztools {
+
+// 单个格式的数据（如 "text" 为 UTF-8 文本，"files" 为换行分隔的路径，"CF_DIB" 为原始位图）
+struct ClipboardHistoryFormat {
+    std::string name;
+    std::string data;
+};
+
+struct ClipboardHistoryOptions {
+    size_t maxEntries = 200;              // 槽位数量
+    size_t maxBytes = 64 * 1024 * 1024;   // 所有条目数据总字节上限
+};
+
+// 条目元数据（分页返回给 JS，不含数据本身）
+struct ClipboardHistoryFormatInfo {
+    std::string name;
+    size_t size;
+};
+
+struct ClipboardHistoryEntryInfo {
+    uint64_t id;            // 递增 id（去重命中时保持不变）
+    uint64_t hash;          // 内容哈希
+    uint64_t sequence;      // 最近一次出现时的剪贴板序列号
+    uint64_t createdAtMs;   // 首次出现时间（Unix 毫秒）
+    uint64_t lastSeenAtMs;  // 最近一次出现时间（Unix 毫秒）
+    uint32_t copyCount;     // 出现次数
+    size_t bytes;           // 数据总字节数
+    std::vector<ClipboardHistoryFormatInfo> formats;
+};
+
+struct ClipboardHistoryStats {
+    uint64_t added;        // 新增条目数
+    uint64_t duplicates;   // 去重命中数
+    uint64_t evicted;      // 因容量/字节预算淘汰的条目数
+    uint64_t rejected;     // 单条超过字节预算而被拒绝的次数
+    size_t entries;        // 当前条目数
+    size_t bytes;          // 当前数据总字节数
+};
+
+class ClipboardHistory {
+public:
+    explicit ClipboardHistory(const ClipboardHistoryOptions& options = ClipboardHistoryOptions());
+
+    // 修改容量/预算（超出部分立即按 LRU 淘汰）
+    void Configure(const ClipboardHistoryOptions& options);
+    ClipboardHistoryOptions Options() const;
+
+    // 添加一次剪贴板内容，返回条目 id（重复内容返回已有条目 id）；
+    // formats 为空或超出字节预算时返回 0
+    // nowMs 为 0 时使用当前系统时间
+    uint64_t Add(std::vector<ClipboardHistoryFormat> formats, uint64_t sequence = 0, uint64_t nowMs = 0);
+
+    size_t Size() const;
+
+    // 按索引分页（索引 0 为最新），越界部分被忽略
+    std::vector<ClipboardHistoryEntryInfo> Page(size_t offset, size_t count) const;
+
+    // 按 id 读取条目元数据
+    bool GetInfo(uint64_t id, ClipboardHistoryEntryInfo& info) const;
+
+    // 按 id 读取某个格式的数据；返回的指针在条目被淘汰后仍然有效
+    std::shared_ptr<const std::string> GetData(uint64_t id, const std::string& format) const;
+
+    bool Remove(uint64_t id);
+    void Clear();
+
+    // 之后分配的 id 不小于 nextId（与持久化日志中的 id 衔接）
+    void ReserveIds(uint64_t nextId);
+
+    ClipboardHistoryStats Stats() const;
+
+    // 内容哈希：按格式名 + 数据计算，格式顺序不同视为不同内容
+    static uint64_t HashFormats(const std::vector<ClipboardHistoryFormat>& formats);
+
+private:
+    static const uint32_t kNoSlot = UINT32_MAX;
+
+    struct Entry {
+        bool used = false;
+        uint32_t older = kNoSlot;  // LRU 链表：更旧 / 更新的槽位
+        uint32_t newer = kNoSlot;
+        uint64_t id = 0;
+        uint64_t hash = 0;
+        uint64_t sequence = 0;
+        uint64_t createdAtMs = 0;
+        uint64_t lastSeenAtMs = 0;
+        uint32_t copyCount = 0;
+        size_t bytes = 0;
+        std::vector<std::pair<std::string, std::shared_ptr<const std::string>>> formats;
+    };
+
+    static bool SameContent(const Entry& entry, const std::vector<ClipboardHistoryFormat>& formats);
+
+    ClipboardHistoryEntryInfo InfoLocked(const Entry& entry) const;
+    int FindSlotLocked(uint64_t id) const;
+    void LinkNewestLocked(uint32_t slot);
+    void UnlinkLocked(uint32_t slot);
+    void ReleaseSlotLocked(uint32_t slot);
+    void EvictLocked(size_t incomingBytes, size_t keepFreeSlots);
+    void ResizeLocked(size_t maxEntries);
+
+    mutable std::mutex mutex_;
+    ClipboardHistoryOptions options_;
+    std::vector<Entry> slots_;
+    std::vector<uint32_t> freeSlots_;
+    uint32_t oldest_ = kNoSlot;
+    uint32_t newest_ = kNoSlot;
+    size_t count_ = 0;
+    std::unordered_multimap<uint64_t, uint32_t> byHash_;
+    std::unordered_map<uint64_t, uint32_t> byId_;
+    uint64_t nextId_;
+    size_t totalBytes_;
+    ClipboardHistoryStats stats_;
+};
+
+}  // namespace ztools
@@ -0,0 +1,76 @@
+#include "clipboard_provider.h"
+
+#include <utility>
+
+namespace ztools {
+
+void ClipboardProvider::Add(const std::string& format, Renderer renderer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto slot = std::make_shared<Slot>();
+    slot->renderer = std::move(renderer);
+    if (slots_.find(format) == slots_.end()) {
+        order_.push_back(format);
+    }
+    slots_[format] = slot;
+}
+
+std::vector<std::string> ClipboardProvider::Formats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return order_;
+}
+
+bool ClipboardProvider::Has(const std::string& format) const {
+    return FindSlot(format) != nullptr;
+}
+
+std::shared_ptr<ClipboardProvider::Slot> ClipboardProvider::FindSlot(const std::string& format) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = slots_.find(format);
+    return it == slots_.end() ? nullptr : it->second;
+}
+
+std::shared_ptr<const std::string> ClipboardProvider::Render(const std::string& format) {
+    std::shared_ptr<Slot> slot = FindSlot(format);
+    if (slot == nullptr) {
+        return nullptr;
+    }
+
+    // 渲染可能很慢（PNG 编码），不持有全局锁，其他格式的请求不受影响
+    std::lock_guard<std::mutex> renderLock(slot->renderMutex);
+    if (!slot->rendered) {
+        slot->rendered = true;
+        if (slot->renderer) {
+            auto data = std::make_shared<std::string>();
+            if (slot->renderer(*data)) {
+                slot->data = std::move(data);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            renderCount_++;
+        }
+    }
+    return slot->data;
+}
+
+size_t ClipboardProvider::RenderCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return renderCount_;
+}
+
+void ClipboardProvider::Release() {
+    std::map<std::string, std::shared_ptr<Slot>> slots;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slots.swap(slots_);
+        order_.clear();
+    }
+    // 正在渲染的格式持有 slot 的引用，等其完成后随最后一个引用释放
+    for (auto& entry : slots) {
+        std::lock_guard<std::mutex> renderLock(entry.second->renderMutex);
+        entry.second->renderer = nullptr;
+        entry.second->data.reset();
+    }
+}
+
+}  // namespace ztools
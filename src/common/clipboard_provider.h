@@ -0,0 +1,63 @@
+// 延迟渲染的剪贴板数据提供者
+//
+// 截图完成时原实现立即 CopyImage 复制位图写入剪贴板，同时为 JS 编码 PNG，
+// 即使用户从不粘贴也要付出整幅图像（多显示器时可达上百 MB）的复制与编码开销。
+// ClipboardProvider 只声明可提供的格式，消费方真正请求时才调用对应的渲染函数：
+// - Windows: SetClipboardData(format, NULL) 声明，WM_RENDERFORMAT 时渲染
+// - Linux:   持有 X11 选区（src/linux/x11_clipboard_owner.h），SelectionRequest 时渲染
+// 同一格式只渲染一次，结果在提供者存续期间缓存，可被剪贴板与 JS 共享。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ztools {
+
+class ClipboardProvider {
+public:
+    using Renderer = std::function<bool(std::string& data)>;
+
+    ClipboardProvider() = default;
+    ClipboardProvider(const ClipboardProvider&) = delete;
+    ClipboardProvider& operator=(const ClipboardProvider&) = delete;
+
+    // 声明格式（Windows 为剪贴板格式名，如 CF_DIBV5、PNG；X11 为目标原子名）
+    void Add(const std::string& format, Renderer renderer);
+
+    // 按声明顺序返回格式
+    std::vector<std::string> Formats() const;
+    bool Has(const std::string& format) const;
+
+    // 渲染格式数据：首次请求时调用渲染函数并缓存，并发请求同一格式只渲染一次。
+    // 未声明或渲染失败时返回 nullptr（失败结果也会缓存，不重复尝试）
+    std::shared_ptr<const std::string> Render(const std::string& format);
+
+    // 已执行的渲染次数（不含命中缓存）
+    size_t RenderCount() const;
+
+    // 释放渲染函数与缓存（失去剪贴板所有权后调用，释放其捕获的像素等资源）
+    void Release();
+
+private:
+    struct Slot {
+        Renderer renderer;
+        bool rendered = false;
+        std::shared_ptr<const std::string> data;
+        std::mutex renderMutex;  // 只串行化同一格式的渲染
+    };
+
+    std::shared_ptr<Slot> FindSlot(const std::string& format) const;
+
+    mutable std::mutex mutex_;
+    std::vector<std::string> order_;
+    std::map<std::string, std::shared_ptr<Slot>> slots_;
+    size_t renderCount_ = 0;
+};
+
+}  // namespace ztools
@@ -0,0 +1,128 @@
+#include "clipboard_read.h"
+
+#include <cstring>
+
+namespace ztools {
+
+namespace {
+
+uint32_t LoadU32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t LoadU16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+const uint32_t kBiRgb = 0;
+const uint32_t kBiBitfields = 3;
+const uint32_t kBiAlphaBitfields = 6;
+const uint32_t kBitmapInfoHeaderSize = 40;
+
+}  // namespace
+
+// ==================== ClipboardLockStats ====================
+
+ClipboardLockStats::ClipboardLockStats() : count_(0), totalUs_(0), maxUs_(0), lastUs_(0) {}
+
+void ClipboardLockStats::Record(uint64_t heldUs) {
+    count_.fetch_add(1, std::memory_order_relaxed);
+    totalUs_.fetch_add(heldUs, std::memory_order_relaxed);
+    lastUs_.store(heldUs, std::memory_order_relaxed);
+    uint64_t max = maxUs_.load(std::memory_order_relaxed);
+    while (heldUs > max && !maxUs_.compare_exchange_weak(max, heldUs, std::memory_order_relaxed)) {
+    }
+}
+
+ClipboardLockStatsSnapshot ClipboardLockStats::Snapshot() const {
+    ClipboardLockStatsSnapshot snapshot;
+    snapshot.count = count_.load(std::memory_order_relaxed);
+    snapshot.totalUs = totalUs_.load(std::memory_order_relaxed);
+    snapshot.maxUs = maxUs_.load(std::memory_order_relaxed);
+    snapshot.lastUs = lastUs_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void ClipboardLockStats::Reset() {
+    count_ = 0;
+    totalUs_ = 0;
+    maxUs_ = 0;
+    lastUs_ = 0;
+}
+
+// ==================== ClipboardLockTimer ====================
+
+ClipboardLockTimer::ClipboardLockTimer(ClipboardLockStats& stats)
+    : stats_(stats), start_(std::chrono::steady_clock::now()), stopped_(false), heldUs_(0) {}
+
+ClipboardLockTimer::~ClipboardLockTimer() {
+    Stop();
+}
+
+uint64_t ClipboardLockTimer::Stop() {
+    if (!stopped_) {
+        stopped_ = true;
+        heldUs_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                            std::chrono::steady_clock::now() - start_)
+                                            .count());
+        stats_.Record(heldUs_);
+    }
+    return heldUs_;
+}
+
+// ==================== DIB ====================
+
+bool DibPixelOffset(const void* dib, size_t size, size_t* offset) {
+    if (dib == nullptr || size < kBitmapInfoHeaderSize) {
+        return false;
+    }
+    const unsigned char* p = static_cast<const unsigned char*>(dib);
+    const uint32_t headerSize = LoadU32(p);
+    const int32_t width = static_cast<int32_t>(LoadU32(p + 4));
+    const int32_t height = static_cast<int32_t>(LoadU32(p + 8));
+    const uint16_t bitCount = LoadU16(p + 14);
+    const uint32_t compression = LoadU32(p + 16);
+    const uint32_t sizeImage = LoadU32(p + 20);
+    const uint32_t colorsUsed = LoadU32(p + 32);
+
+    if (headerSize < kBitmapInfoHeaderSize || headerSize > size || width <= 0 || height == 0) {
+        return false;
+    }
+
+    uint64_t pixelOffset = headerSize;
+    // BITMAPINFOHEADER 之后紧跟位掩码；V4/V5 头部已包含位掩码
+    if (headerSize == kBitmapInfoHeaderSize) {
+        if (compression == kBiBitfields) {
+            pixelOffset += 12;
+        } else if (compression == kBiAlphaBitfields) {
+            pixelOffset += 16;
+        }
+    }
+    uint64_t colors = colorsUsed;
+    if (colors == 0 && bitCount > 0 && bitCount <= 8) {
+        colors = 1ull << bitCount;
+    }
+    pixelOffset += colors * 4;
+
+    uint64_t pixelBytes;
+    if (compression == kBiRgb || compression == kBiBitfields || compression == kBiAlphaBitfields) {
+        if (bitCount != 1 && bitCount != 4 && bitCount != 8 && bitCount != 16 && bitCount != 24 && bitCount != 32) {
+            return false;
+        }
+        const uint64_t stride = ((static_cast<uint64_t>(width) * bitCount + 31) / 32) * 4;
+        const uint64_t rows = height < 0 ? static_cast<uint64_t>(-static_cast<int64_t>(height)) : height;
+        pixelBytes = stride * rows;
+    } else {
+        // RLE/JPEG/PNG 压缩：只能依赖 biSizeImage
+        pixelBytes = sizeImage;
+    }
+
+    if (pixelOffset + pixelBytes > size) {
+        return false;
+    }
+    *offset = static_cast<size_t>(pixelOffset);
+    return true;
+}
+
+}  // namespace ztools
@@ -0,0 +1,95 @@
+// 单次会话读取多种剪贴板格式（readClipboard）
+//
+// 原来 JS 需要分别调用 getClipboardText / getClipboardImage / getClipboardFiles，
+// 每次都要打开（锁定）一次全局剪贴板。readClipboard(mask) 在一次打开会话内取出
+// 全部请求的格式；图像只在锁内复制原始 DIB，关闭剪贴板后再编码 PNG。
+// ClipboardLockStats 统计每次持有剪贴板的时长，便于比较各读取路径的锁竞争。
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ztools {
+
+// readClipboard 格式掩码
+static const uint32_t kClipboardReadText = 1u << 0;   // UTF-8 文本
+static const uint32_t kClipboardReadHtml = 1u << 1;   // HTML（Windows 为 CF_HTML 原文，含头部）
+static const uint32_t kClipboardReadRtf = 1u << 2;    // RTF 原文
+static const uint32_t kClipboardReadImage = 1u << 3;  // base64 PNG
+static const uint32_t kClipboardReadFiles = 1u << 4;  // 文件路径列表
+static const uint32_t kClipboardReadAll = (1u << 5) - 1;
+
+// readClipboard 输出方式（默认全部返回 JS 字符串）
+static const uint32_t kClipboardOutputUtf16 = 1u << 0;   // text 为 UTF-16LE 字节，JS 得到零拷贝 Uint16Array
+static const uint32_t kClipboardOutputBinary = 1u << 1;  // image 为 PNG 原始字节，html/rtf 为原文字节，JS 得到零拷贝 Buffer
+
+struct ClipboardReadResult {
+    uint32_t mask = 0;         // 请求的格式
+    uint32_t output = 0;       // kClipboardOutput* 按位或
+    uint64_t sequence = 0;     // 读取时的平台序列号
+    bool opened = false;       // 是否成功打开剪贴板
+    uint64_t lockHeldUs = 0;   // 本次持有剪贴板的时长（微秒）
+
+    bool hasText = false;
+    std::string text;          // UTF-8；output 含 kClipboardOutputUtf16 时为 UTF-16LE 字节
+    bool hasHtml = false;
+    std::string html;
+    bool hasRtf = false;
+    std::string rtf;
+    bool hasImage = false;
+    std::string image;         // base64 PNG；output 含 kClipboardOutputBinary 时为 PNG 原始字节
+    bool hasFiles = false;
+    std::vector<std::string> files;
+};
+
+struct ClipboardLockStatsSnapshot {
+    uint64_t count;    // 持有剪贴板的次数
+    uint64_t totalUs;  // 累计持有时长
+    uint64_t maxUs;    // 单次最长持有时长
+    uint64_t lastUs;   // 最近一次持有时长
+};
+
+// 剪贴板持有时长统计（线程安全，监控线程与 JS 线程都会记录）
+class ClipboardLockStats {
+public:
+    ClipboardLockStats();
+
+    void Record(uint64_t heldUs);
+    ClipboardLockStatsSnapshot Snapshot() const;
+    void Reset();
+
+private:
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> totalUs_;
+    std::atomic<uint64_t> maxUs_;
+    std::atomic<uint64_t> lastUs_;
+};
+
+// 从构造（打开剪贴板成功后）计时到 Stop（关闭剪贴板时），只记录一次；未调用 Stop 时析构记录
+class ClipboardLockTimer {
+public:
+    explicit ClipboardLockTimer(ClipboardLockStats& stats);
+    ~ClipboardLockTimer();
+
+    ClipboardLockTimer(const ClipboardLockTimer&) = delete;
+    ClipboardLockTimer& operator=(const ClipboardLockTimer&) = delete;
+
+    // 返回持有时长（微秒）；重复调用返回第一次的结果
+    uint64_t Stop();
+
+private:
+    ClipboardLockStats& stats_;
+    std::chrono::steady_clock::time_point start_;
+    bool stopped_;
+    uint64_t heldUs_;
+};
+
+// 打包 DIB（BITMAPINFOHEADER 及后续版本 + 颜色表/位掩码 + 像素）中像素数据的起始偏移。
+// 头部无效或数据不足以容纳像素时返回 false。
+bool DibPixelOffset(const void* dib, size_t size, size_t* offset);
+
+}  // namespace ztools
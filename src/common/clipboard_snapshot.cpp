@@ -0,0 +1,216 @@
+#include "clipboard_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "content_hash.h"
+
+namespace ztools {
+
+namespace {
+
+inline size_t Align8(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+inline bool Contains(const std::vector<uint32_t>& formats, uint32_t format) {
+    return std::find(formats.begin(), formats.end(), format) != formats.end();
+}
+
+// 复制与哈希在同一遍内完成：按块复制，哈希读取刚复制、仍在缓存中的数据
+const size_t kCopyChunk = 64 * 1024;
+
+}  // namespace
+
+// ==================== ByteArena ====================
+
+ByteArena::ByteArena(size_t blockSize)
+    : blockSize_(std::max<size_t>(blockSize, 64)), current_(0), used_(0), capacity_(0) {}
+
+char* ByteArena::Allocate(size_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+
+    // 超过块大小一半的数据单独分配，避免浪费常规块的剩余空间
+    if (size > blockSize_ / 2) {
+        Block block{std::unique_ptr<char[]>(new char[size]), size, size};
+        char* data = block.data.get();
+        blocks_.push_back(std::move(block));
+        used_ += size;
+        capacity_ += size;
+        return data;
+    }
+
+    const size_t aligned = Align8(size);
+    if (blocks_.empty() || blocks_[current_].size - blocks_[current_].used < aligned) {
+        Block block{std::unique_ptr<char[]>(new char[blockSize_]), blockSize_, 0};
+        blocks_.push_back(std::move(block));
+        current_ = blocks_.size() - 1;
+        capacity_ += blockSize_;
+    }
+    Block& block = blocks_[current_];
+    char* data = block.data.get() + block.used;
+    block.used += aligned;
+    used_ += size;
+    return data;
+}
+
+void ByteArena::Reset() {
+    // 保留第一个常规大小的块
+    auto firstRegular = std::find_if(blocks_.begin(), blocks_.end(),
+                                     [this](const Block& block) { return block.size == blockSize_; });
+    Block kept;
+    bool keep = firstRegular != blocks_.end();
+    if (keep) {
+        kept = std::move(*firstRegular);
+        kept.used = 0;
+    }
+    blocks_.clear();
+    capacity_ = 0;
+    current_ = 0;
+    used_ = 0;
+    if (keep) {
+        capacity_ = kept.size;
+        blocks_.push_back(std::move(kept));
+    }
+}
+
+// ==================== ClipboardSnapshot ====================
+
+ClipboardSnapshot::ClipboardSnapshot() : bytes_(0), skipped_(0), captured_(false) {}
+
+void ClipboardSnapshot::Clear() {
+    entries_.clear();
+    arena_.Reset();
+    bytes_ = 0;
+    skipped_ = 0;
+    captured_ = false;
+}
+
+bool ClipboardSnapshot::Capture(ClipboardBackend& backend, const ClipboardSnapshotOptions& options) {
+    Clear();
+    if (!backend.Open()) {
+        return false;
+    }
+
+    std::vector<uint32_t> formats = backend.EnumerateFormats();
+    entries_.reserve(formats.size());
+    for (uint32_t format : formats) {
+        if (!options.formats.empty() && !Contains(options.formats, format)) {
+            continue;
+        }
+        const bool hashOnly = Contains(options.hashOnly, format);
+        const bool hash = hashOnly || Contains(options.hashFormats, format);
+        const Entry* reference = options.baseline != nullptr ? options.baseline->Find(format) : nullptr;
+
+        bool stored = false;
+        bool readable = backend.ReadFormat(format, [&](const void* data, size_t size) {
+            uint64_t digest = 0;
+            bool hashed = false;
+            if (hashOnly) {
+                // 与 baseline 大小不同时必然已变化，直接复制；大小相同时先哈希再决定
+                const bool sizeChanged = reference == nullptr || reference->size != size;
+                if (options.baseline == nullptr || !sizeChanged) {
+                    digest = ContentHash64(data, size);
+                    hashed = true;
+                    Entry probe{format, nullptr, size, true, digest};
+                    if (options.baseline == nullptr || SameContent(&probe, reference)) {
+                        entries_.push_back(probe);
+                        stored = true;
+                        return;
+                    }
+                }
+            }
+            if (bytes_ + size > options.maxBytes) {
+                return;
+            }
+            char* copy = arena_.Allocate(size);
+            if (hashed) {
+                if (size > 0) {
+                    memcpy(copy, data, size);
+                }
+            } else if (hash) {
+                ContentHasher hasher;
+                const char* src = static_cast<const char*>(data);
+                for (size_t offset = 0; offset < size; offset += kCopyChunk) {
+                    const size_t chunk = std::min(kCopyChunk, size - offset);
+                    memcpy(copy + offset, src + offset, chunk);
+                    hasher.Update(copy + offset, chunk);
+                }
+                digest = hasher.Digest();
+            } else if (size > 0) {
+                memcpy(copy, data, size);
+            }
+            entries_.push_back(Entry{format, copy, size, hash, digest});
+            bytes_ += size;
+            stored = true;
+        });
+        if (!readable || !stored) {
+            skipped_++;
+        }
+    }
+
+    backend.Close();
+    captured_ = true;
+    return true;
+}
+
+bool ClipboardSnapshot::Restore(ClipboardBackend& backend, size_t* written) const {
+    if (written != nullptr) {
+        *written = 0;
+    }
+    // 未成功保存时不能清空剪贴板，否则用户数据丢失
+    if (!captured_ || !backend.Open()) {
+        return false;
+    }
+
+    bool ok = backend.Empty();
+    size_t count = 0;
+    if (ok) {
+        for (const Entry& entry : entries_) {
+            if (entry.data == nullptr && entry.size > 0) {
+                ok = false;  // 只有哈希，无法恢复
+                continue;
+            }
+            if (backend.WriteFormat(entry.format, entry.data, entry.size)) {
+                count++;
+            } else {
+                ok = false;
+            }
+        }
+    }
+    backend.Close();
+
+    if (written != nullptr) {
+        *written = count;
+    }
+    return ok;
+}
+
+bool ClipboardSnapshot::SameContent(const Entry* a, const Entry* b) {
+    if (a == nullptr || b == nullptr) {
+        return a == b;
+    }
+    if (a->size != b->size) {
+        return false;
+    }
+    if (a->hashed && b->hashed) {
+        return a->hash == b->hash;
+    }
+    if (a->data == nullptr || b->data == nullptr) {
+        return a->size == 0;
+    }
+    return a->size == 0 || memcmp(a->data, b->data, a->size) == 0;
+}
+
+const ClipboardSnapshot::Entry* ClipboardSnapshot::Find(uint32_t format) const {
+    for (const Entry& entry : entries_) {
+        if (entry.format == format) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace ztools
@@ -0,0 +1,123 @@
+// 剪贴板多格式快照（平台无关）
+//
+// getSelectedContent 模拟复制前需要保存用户原有的剪贴板，之后原样恢复。
+// 原实现只保存文本（转 UTF-8）、图像（编码为 PNG base64）和文件列表，恢复时又重新构造
+// CF_UNICODETEXT / DROPFILES，图像与其他格式（HTML、RTF、Office 私有格式等）全部丢失。
+//
+// 这里在一次打开剪贴板的会话内把每个格式的原始字节复制进同一个内存池，
+// 不做任何解码；恢复时同样在一次会话内逐字节写回。
+// 平台差异由 ClipboardBackend 隔离（Windows 见 binding_windows.cpp，测试中使用内存实现）。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ztools {
+
+// 按块分配的字节池：指针在 Reset 之前保持有效，单个格式的数据总是连续存放
+class ByteArena {
+public:
+    explicit ByteArena(size_t blockSize = 64 * 1024);
+
+    ByteArena(const ByteArena&) = delete;
+    ByteArena& operator=(const ByteArena&) = delete;
+
+    // 分配 size 字节（8 字节对齐）；size 为 0 时返回 nullptr
+    char* Allocate(size_t size);
+
+    // 释放所有数据，保留第一个常规块供下次复用
+    void Reset();
+
+    size_t Used() const { return used_; }
+    size_t Capacity() const { return capacity_; }
+    size_t BlockCount() const { return blocks_.size(); }
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+        size_t used;
+    };
+
+    size_t blockSize_;
+    std::vector<Block> blocks_;
+    size_t current_;  // 正在填充的常规块（超大数据使用独立块，不影响该块）
+    size_t used_;
+    size_t capacity_;
+};
+
+// 平台剪贴板访问接口；所有读写都在 Open/Close 之间进行
+class ClipboardBackend {
+public:
+    using Reader = std::function<void(const void* data, size_t size)>;
+
+    virtual ~ClipboardBackend() = default;
+
+    virtual bool Open() = 0;
+    virtual void Close() = 0;
+
+    // 当前存在的格式（按剪贴板枚举顺序）
+    virtual std::vector<uint32_t> EnumerateFormats() = 0;
+
+    // 读取格式原始数据：reader 只在调用期间持有指针；无法以字节形式读取的格式返回 false
+    virtual bool ReadFormat(uint32_t format, const Reader& reader) = 0;
+
+    virtual bool Empty() = 0;
+    virtual bool WriteFormat(uint32_t format, const void* data, size_t size) = 0;
+};
+
+class ClipboardSnapshot;
+
+struct ClipboardSnapshotOptions {
+    std::vector<uint32_t> formats;      // 只保存这些格式；为空表示全部
+    std::vector<uint32_t> hashFormats;  // 复制时顺带计算 64 位内容哈希（XXH64）的格式
+    std::vector<uint32_t> hashOnly;     // 只计算哈希与大小、不复制数据的格式（用于前后比较大图像）
+    // 设置后 hashOnly 格式与 baseline 中的同格式条目不同时仍完整复制（同一次读取内完成），
+    // 相同时只保留哈希：变化的大图像不必再打开剪贴板读取第二次
+    const ClipboardSnapshot* baseline = nullptr;
+    size_t maxBytes = 256u << 20;       // 总字节上限（只计入复制的数据），超出的格式跳过
+};
+
+class ClipboardSnapshot {
+public:
+    struct Entry {
+        uint32_t format;
+        const char* data;  // 指向内部字节池；只计算哈希的格式为 nullptr
+        size_t size;
+        bool hashed;       // 是否计算了 hash
+        uint64_t hash;
+    };
+
+    // 两个条目内容是否相同：优先比较长度 + 哈希，没有哈希时逐字节比较；都不存在视为相同
+    static bool SameContent(const Entry* a, const Entry* b);
+
+    ClipboardSnapshot();
+
+    // 打开剪贴板并复制格式（之前的内容被丢弃）；无法打开剪贴板时返回 false
+    bool Capture(ClipboardBackend& backend, const ClipboardSnapshotOptions& options = ClipboardSnapshotOptions());
+
+    // 清空剪贴板并写回全部格式；written 返回成功写入的格式数
+    bool Restore(ClipboardBackend& backend, size_t* written = nullptr) const;
+
+    void Clear();
+
+    bool Captured() const { return captured_; }
+    bool Empty() const { return entries_.empty(); }
+    const std::vector<Entry>& Entries() const { return entries_; }
+    const Entry* Find(uint32_t format) const;
+
+    size_t Bytes() const { return bytes_; }
+    size_t Skipped() const { return skipped_; }  // 不可读或超出字节上限而跳过的格式数
+
+private:
+    ByteArena arena_;
+    std::vector<Entry> entries_;
+    size_t bytes_;
+    size_t skipped_;
+    bool captured_;
+};
+
+}  // namespace ztools
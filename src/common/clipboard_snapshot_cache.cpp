@@ -0,0 +1,53 @@
+#include "clipboard_snapshot_cache.h"
+
+namespace ztools {
+
+ClipboardSnapshotCache::ClipboardSnapshotCache() : stats_{} {}
+
+std::shared_ptr<const void> ClipboardSnapshotCache::Lookup(ClipboardSlot slot, uint64_t sequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[static_cast<int>(slot)];
+    if (entry.value && entry.sequence == sequence) {
+        stats_.hits++;
+        return entry.value;
+    }
+    stats_.misses++;
+    return nullptr;
+}
+
+void ClipboardSnapshotCache::Store(ClipboardSlot slot, uint64_t sequence, std::shared_ptr<const void> value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = entries_[static_cast<int>(slot)];
+    entry.sequence = sequence;
+    entry.value = std::move(value);
+}
+
+void ClipboardSnapshotCache::CountBypass() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.bypassed++;
+}
+
+void ClipboardSnapshotCache::CountDiscard() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.discarded++;
+}
+
+void ClipboardSnapshotCache::Invalidate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Entry& entry : entries_) {
+        entry.sequence = 0;
+        entry.value.reset();
+    }
+}
+
+ClipboardCacheStats ClipboardSnapshotCache::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ClipboardSnapshotCache::ResetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = ClipboardCacheStats{};
+}
+
+}  // namespace ztools
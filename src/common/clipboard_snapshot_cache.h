@@ -0,0 +1,99 @@
+// 剪贴板快照缓存（按平台序列号失效）
+//
+// 剪贴板内容只有在序列号变化后才可能改变：
+// - Windows: GetClipboardSequenceNumber()
+// - macOS:   NSPasteboard.changeCount
+// - X11:     XFixes 选区变化计数
+// 因此两次变化之间的重复读取可以直接从内存返回，不必重新打开剪贴板、重新解码。
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace ztools {
+
+// 缓存槽位：每种解码结果独立缓存
+enum class ClipboardSlot : uint8_t {
+    Text = 0,    // UTF-8 文本
+    Image,       // base64 PNG
+    FilesList,   // 文件路径列表
+    Files,       // 文件详细信息（路径、文件名、是否目录）
+    Count
+};
+
+struct ClipboardCacheStats {
+    uint64_t hits;       // 命中次数
+    uint64_t misses;     // 未命中（实际读取剪贴板）次数
+    uint64_t bypassed;   // 平台无法提供序列号、直接读取的次数
+    uint64_t discarded;  // 读取期间剪贴板发生变化、结果未写入缓存的次数
+};
+
+class ClipboardSnapshotCache {
+public:
+    using SequenceFn = std::function<uint64_t()>;
+
+    ClipboardSnapshotCache();
+
+    // 读取指定槽位：序列号未变化时直接返回缓存，否则调用 load 读取并缓存。
+    // - sequence 返回 0 表示平台无法提供序列号，此时不缓存
+    // - load 返回 false 表示读取失败（如剪贴板被占用），此时不缓存并返回空指针
+    // - 读取前后序列号不一致时，结果照常返回但不写入缓存
+    template <typename T>
+    std::shared_ptr<const T> Read(ClipboardSlot slot, const SequenceFn& sequence,
+                                  const std::function<bool(T&)>& load);
+
+    // 清空所有槽位（统计保留）
+    void Invalidate();
+
+    ClipboardCacheStats Stats() const;
+    void ResetStats();
+
+private:
+    struct Entry {
+        uint64_t sequence = 0;
+        std::shared_ptr<const void> value;
+    };
+
+    std::shared_ptr<const void> Lookup(ClipboardSlot slot, uint64_t sequence);
+    void Store(ClipboardSlot slot, uint64_t sequence, std::shared_ptr<const void> value);
+    void CountBypass();
+    void CountDiscard();
+
+    mutable std::mutex mutex_;
+    Entry entries_[static_cast<int>(ClipboardSlot::Count)];
+    ClipboardCacheStats stats_;
+};
+
+template <typename T>
+std::shared_ptr<const T> ClipboardSnapshotCache::Read(ClipboardSlot slot, const SequenceFn& sequence,
+                                                      const std::function<bool(T&)>& load) {
+    const uint64_t before = sequence ? sequence() : 0;
+    if (before != 0) {
+        std::shared_ptr<const void> cached = Lookup(slot, before);
+        if (cached) {
+            // 每个槽位只会存放同一种类型（由调用方约定）
+            return std::static_pointer_cast<const T>(cached);
+        }
+    } else {
+        CountBypass();
+    }
+
+    auto value = std::make_shared<T>();
+    if (!load(*value)) {
+        return nullptr;
+    }
+
+    if (before != 0) {
+        const uint64_t after = sequence();
+        if (after == before) {
+            Store(slot, before, value);
+        } else {
+            CountDiscard();
+        }
+    }
+    return value;
+}
+
+}  // namespace ztools
@@ -0,0 +1,407 @@
+#include "clipboard_write.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "utf_transcode.h"
+
+namespace ztools {
+
+namespace {
+
+const char kStartFragment[] = "<!--StartFragment-->";
+const char kEndFragment[] = "<!--EndFragment-->";
+
+// 单张图像像素字节上限（DIB biSizeImage 与 TIFF 偏移均为 32 位）
+const uint64_t kMaxImageBytes = 0x7FFFFFFFull;
+
+void AppendU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+void AppendU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+void SetError(std::string* error, const char* message) {
+    if (error != nullptr) {
+        *error = message;
+    }
+}
+
+uint32_t ImageStride(const ClipboardWriteImage& image) {
+    return image.stride != 0 ? image.stride : image.width * 4;
+}
+
+// TIFF IFD 条目：数据不超过 4 字节时直接存放在 value 中
+void AppendTiffEntry(std::string& out, uint16_t tag, uint16_t type, uint32_t count, uint32_t value) {
+    AppendU16(out, tag);
+    AppendU16(out, type);
+    AppendU32(out, count);
+    if (type == 3 && count == 1) {
+        AppendU16(out, static_cast<uint16_t>(value));
+        AppendU16(out, 0);
+    } else {
+        AppendU32(out, value);
+    }
+}
+
+// 逐行倒序追加像素（去掉行填充）
+void AppendDibPixels(const ClipboardWriteImage& image, std::string& dib) {
+    const size_t rowBytes = static_cast<size_t>(image.width) * 4;
+    const size_t stride = ImageStride(image);
+    for (uint32_t row = image.height; row-- > 0;) {
+        dib.append(image.bgra.data() + row * stride, rowBytes);
+    }
+}
+
+// BITMAPINFOHEADER 部分（BITMAPV5HEADER 的前 40 字节与之相同）
+void AppendInfoHeader(const ClipboardWriteImage& image, uint32_t headerSize, uint32_t compression, std::string& dib) {
+    const uint32_t pixelBytes = image.width * 4 * image.height;
+    AppendU32(dib, headerSize);    // biSize
+    AppendU32(dib, image.width);   // biWidth
+    AppendU32(dib, image.height);  // biHeight（正数：自下而上）
+    AppendU16(dib, 1);             // biPlanes
+    AppendU16(dib, 32);            // biBitCount
+    AppendU32(dib, compression);   // biCompression
+    AppendU32(dib, pixelBytes);    // biSizeImage
+    AppendU32(dib, 0);             // biXPelsPerMeter
+    AppendU32(dib, 0);             // biYPelsPerMeter
+    AppendU32(dib, 0);             // biClrUsed
+    AppendU32(dib, 0);             // biClrImportant
+}
+
+}  // namespace
+
+bool ValidateClipboardWriteImage(const ClipboardWriteImage& image, std::string* error) {
+    if (image.width == 0 || image.height == 0) {
+        SetError(error, "Image width and height must be positive");
+        return false;
+    }
+    const uint64_t rowBytes = static_cast<uint64_t>(image.width) * 4;
+    const uint64_t stride = image.stride != 0 ? image.stride : rowBytes;
+    if (stride < rowBytes) {
+        SetError(error, "Image stride is smaller than width * 4");
+        return false;
+    }
+    if (rowBytes * image.height > kMaxImageBytes) {
+        SetError(error, "Image is too large");
+        return false;
+    }
+    if (stride * (image.height - 1) + rowBytes > image.bgra.size()) {
+        SetError(error, "Image buffer is smaller than stride * height");
+        return false;
+    }
+    return true;
+}
+
+bool ValidateClipboardWritePng(const std::string& png, std::string* error) {
+    static const char kSignature[] = "\x89PNG\r\n\x1a\n";
+    if (png.size() < sizeof(kSignature) - 1 || memcmp(png.data(), kSignature, sizeof(kSignature) - 1) != 0) {
+        SetError(error, "png is not PNG data");
+        return false;
+    }
+    return true;
+}
+
+std::string Utf8ToUtf16Le(const std::string& utf8) {
+    // 直接写入字节缓冲区（支持的平台均为小端）
+    std::string out(utf8.size() * 2, '\0');
+    if (!utf8.empty()) {
+        const size_t units = ConvertUtf8ToUtf16(utf8.data(), utf8.size(), reinterpret_cast<char16_t*>(&out[0]));
+        out.resize(units * 2);
+    }
+    return out;
+}
+
+std::string BuildCfHtml(const std::string& html) {
+    static const char kHeaderFormat[] =
+        "Version:0.9\r\nStartHTML:%010zu\r\nEndHTML:%010zu\r\nStartFragment:%010zu\r\nEndFragment:%010zu\r\n";
+
+    std::string body;
+    size_t fragmentStart = html.find(kStartFragment);
+    size_t fragmentEnd = fragmentStart == std::string::npos ? std::string::npos : html.find(kEndFragment, fragmentStart);
+    if (fragmentEnd != std::string::npos) {
+        body = html;
+        fragmentStart += sizeof(kStartFragment) - 1;
+    } else {
+        body = "<html><body>\r\n";
+        body += kStartFragment;
+        fragmentStart = body.size();
+        body += html;
+        fragmentEnd = body.size();
+        body += kEndFragment;
+        body += "\r\n</body></html>";
+    }
+
+    // 偏移固定为 10 位，头部长度与数值无关
+    char header[160];
+    const size_t headerSize = static_cast<size_t>(snprintf(header, sizeof(header), kHeaderFormat,
+                                                           static_cast<size_t>(0), static_cast<size_t>(0),
+                                                           static_cast<size_t>(0), static_cast<size_t>(0)));
+    snprintf(header, sizeof(header), kHeaderFormat, headerSize, headerSize + body.size(), headerSize + fragmentStart,
+             headerSize + fragmentEnd);
+
+    std::string result(header, headerSize);
+    result += body;
+    return result;
+}
+
+bool BuildDibFromBgra(const ClipboardWriteImage& image, std::string& dib) {
+    if (!ValidateClipboardWriteImage(image, nullptr)) {
+        return false;
+    }
+    dib.clear();
+    dib.reserve(40 + static_cast<size_t>(image.width) * 4 * image.height);
+    AppendInfoHeader(image, 40, 0, dib);  // BI_RGB
+    AppendDibPixels(image, dib);
+    return true;
+}
+
+bool BuildDibV5FromBgra(const ClipboardWriteImage& image, std::string& dib) {
+    if (!ValidateClipboardWriteImage(image, nullptr)) {
+        return false;
+    }
+    dib.clear();
+    dib.reserve(124 + static_cast<size_t>(image.width) * 4 * image.height);
+    AppendInfoHeader(image, 124, 3, dib);  // BI_BITFIELDS
+    AppendU32(dib, 0x00FF0000);            // bV5RedMask
+    AppendU32(dib, 0x0000FF00);            // bV5GreenMask
+    AppendU32(dib, 0x000000FF);            // bV5BlueMask
+    AppendU32(dib, 0xFF000000);            // bV5AlphaMask
+    AppendU32(dib, 0x73524742);            // bV5CSType = LCS_sRGB
+    dib.append(36 + 12, '\0');             // bV5Endpoints + bV5Gamma*（sRGB 时忽略）
+    AppendU32(dib, 4);                     // bV5Intent = LCS_GM_IMAGES
+    AppendU32(dib, 0);                     // bV5ProfileData
+    AppendU32(dib, 0);                     // bV5ProfileSize
+    AppendU32(dib, 0);                     // bV5Reserved
+    AppendDibPixels(image, dib);
+    return true;
+}
+
+bool BuildTiffFromBgra(const ClipboardWriteImage& image, std::string& tiff) {
+    if (!ValidateClipboardWriteImage(image, nullptr)) {
+        return false;
+    }
+    const size_t rowBytes = static_cast<size_t>(image.width) * 4;
+    const size_t stride = ImageStride(image);
+    const uint32_t pixelBytes = static_cast<uint32_t>(rowBytes * image.height);
+
+    const uint16_t kEntryCount = 11;
+    const uint32_t ifdOffset = 8;
+    const uint32_t bitsOffset = ifdOffset + 2 + kEntryCount * 12 + 4;
+    const uint32_t pixelOffset = bitsOffset + 8;
+
+    tiff.clear();
+    tiff.reserve(pixelOffset + pixelBytes);
+    tiff.append("II*\0", 4);
+    AppendU32(tiff, ifdOffset);
+
+    // 条目须按标签升序；3 = SHORT，4 = LONG
+    AppendU16(tiff, kEntryCount);
+    AppendTiffEntry(tiff, 256, 4, 1, image.width);   // ImageWidth
+    AppendTiffEntry(tiff, 257, 4, 1, image.height);  // ImageLength
+    AppendTiffEntry(tiff, 258, 3, 4, bitsOffset);    // BitsPerSample = 8,8,8,8
+    AppendTiffEntry(tiff, 259, 3, 1, 1);             // Compression = none
+    AppendTiffEntry(tiff, 262, 3, 1, 2);             // PhotometricInterpretation = RGB
+    AppendTiffEntry(tiff, 273, 4, 1, pixelOffset);   // StripOffsets
+    AppendTiffEntry(tiff, 277, 3, 1, 4);             // SamplesPerPixel
+    AppendTiffEntry(tiff, 278, 4, 1, image.height);  // RowsPerStrip
+    AppendTiffEntry(tiff, 279, 4, 1, pixelBytes);    // StripByteCounts
+    AppendTiffEntry(tiff, 284, 3, 1, 1);             // PlanarConfiguration = chunky
+    AppendTiffEntry(tiff, 338, 3, 1, 2);             // ExtraSamples = unassociated alpha
+    AppendU32(tiff, 0);                              // 没有下一个 IFD
+    for (int i = 0; i < 4; i++) {
+        AppendU16(tiff, 8);
+    }
+
+    // BGRA → RGBA
+    const size_t pixelStart = tiff.size();
+    tiff.resize(pixelStart + pixelBytes);
+    unsigned char* out = reinterpret_cast<unsigned char*>(&tiff[pixelStart]);
+    for (uint32_t row = 0; row < image.height; row++) {
+        const unsigned char* in = reinterpret_cast<const unsigned char*>(image.bgra.data()) + row * stride;
+        for (uint32_t x = 0; x < image.width; x++) {
+            out[0] = in[2];
+            out[1] = in[1];
+            out[2] = in[0];
+            out[3] = in[3];
+            in += 4;
+            out += 4;
+        }
+    }
+    return true;
+}
+
+std::string BuildDropFiles(const std::vector<std::string>& paths) {
+    std::string result;
+    AppendU32(result, 20);  // pFiles：文件列表紧跟 DROPFILES
+    AppendU32(result, 0);   // pt.x
+    AppendU32(result, 0);   // pt.y
+    AppendU32(result, 0);   // fNC
+    AppendU32(result, 1);   // fWide
+    for (const auto& path : paths) {
+        if (path.empty()) {
+            continue;
+        }
+        result += Utf8ToUtf16Le(path);
+        AppendU16(result, 0);
+    }
+    AppendU16(result, 0);  // 结尾的双 NUL
+    return result;
+}
+
+std::string FileUrlFromPath(const std::string& path) {
+    static const char kHex[] = "0123456789ABCDEF";
+    std::string url = "file://";
+    url.reserve(url.size() + path.size());
+    for (unsigned char c : path) {
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '-' || c == '.' ||
+            c == '_' || c == '~' || c == '/') {
+            url.push_back(static_cast<char>(c));
+        } else {
+            url.push_back('%');
+            url.push_back(kHex[c >> 4]);
+            url.push_back(kHex[c & 0x0F]);
+        }
+    }
+    return url;
+}
+
+bool BuildClipboardWriteBlobs(const ClipboardWriteRequest& request, std::vector<ClipboardWriteBlob>& blobs,
+                              std::string* error) {
+    blobs.clear();
+    if (request.Empty()) {
+        SetError(error, "Nothing to write");
+        return false;
+    }
+    if (request.hasImage && !ValidateClipboardWriteImage(request.image, error)) {
+        return false;
+    }
+    if (request.hasPng && !ValidateClipboardWritePng(request.png, error)) {
+        return false;
+    }
+
+    if (request.hasText) {
+        std::string text = Utf8ToUtf16Le(request.text);
+        AppendU16(text, 0);
+        blobs.push_back(ClipboardWriteBlob{ClipboardWriteFormat::UnicodeText, std::move(text)});
+    }
+    if (request.hasHtml) {
+        std::string html = BuildCfHtml(request.html);
+        html.push_back('\0');
+        blobs.push_back(ClipboardWriteBlob{ClipboardWriteFormat::Html, std::move(html)});
+    }
+    if (request.hasRtf) {
+        std::string rtf = request.rtf;
+        rtf.push_back('\0');
+        blobs.push_back(ClipboardWriteBlob{ClipboardWriteFormat::Rtf, std::move(rtf)});
+    }
+    if (request.hasImage) {
+        std::string dib;
+        BuildDibFromBgra(request.image, dib);
+        blobs.push_back(ClipboardWriteBlob{ClipboardWriteFormat::Dib, std::move(dib)});
+    }
+    if (request.hasPng) {
+        blobs.push_back(ClipboardWriteBlob{ClipboardWriteFormat::Png, request.png});
+    }
+    if (request.hasFiles) {
+        bool anyPath = false;
+        for (const auto& path : request.files) {
+            anyPath = anyPath || !path.empty();
+        }
+        if (!anyPath) {
+            SetError(error, "No valid file paths provided");
+            blobs.clear();
+            return false;
+        }
+        blobs.push_back(ClipboardWriteBlob{ClipboardWriteFormat::Files, BuildDropFiles(request.files)});
+    }
+    return true;
+}
+
+bool PublishClipboardWrite(ClipboardBackend& backend, const std::vector<ClipboardWriteItem>& items,
+                           std::string* error) {
+    if (!backend.Open()) {
+        SetError(error, "Failed to open clipboard after retries");
+        return false;
+    }
+    bool success = backend.Empty();
+    if (!success) {
+        SetError(error, "EmptyClipboard failed");
+    }
+    for (size_t i = 0; success && i < items.size(); i++) {
+        const std::string& data = *items[i].data;
+        if (!backend.WriteFormat(items[i].format, data.data(), data.size())) {
+            SetError(error, "SetClipboardData failed");
+            // 撤销已写入的格式：其他程序读到的要么是完整的新内容，要么是空剪贴板
+            backend.Empty();
+            success = false;
+        }
+    }
+    backend.Close();
+    return success;
+}
+
+bool BuildPasteboardWriteSnapshot(const ClipboardWriteRequest& request, PasteboardSnapshot& snapshot,
+                                  std::string* error) {
+    snapshot.items.clear();
+    if (request.Empty()) {
+        SetError(error, "Nothing to write");
+        return false;
+    }
+    if (request.hasImage && !ValidateClipboardWriteImage(request.image, error)) {
+        return false;
+    }
+    if (request.hasPng && !ValidateClipboardWritePng(request.png, error)) {
+        return false;
+    }
+
+    std::vector<std::string> urls;
+    if (request.hasFiles) {
+        for (const auto& path : request.files) {
+            if (!path.empty()) {
+                urls.push_back(FileUrlFromPath(path));
+            }
+        }
+        if (urls.empty()) {
+            SetError(error, "No valid file paths provided");
+            return false;
+        }
+    }
+
+    PasteboardItem first;
+    if (request.hasText) {
+        first.entries.push_back(PasteboardEntry{"public.utf8-plain-text", request.text});
+    }
+    if (request.hasHtml) {
+        first.entries.push_back(PasteboardEntry{"public.html", request.html});
+    }
+    if (request.hasRtf) {
+        first.entries.push_back(PasteboardEntry{"public.rtf", request.rtf});
+    }
+    if (request.hasImage) {
+        std::string tiff;
+        BuildTiffFromBgra(request.image, tiff);
+        first.entries.push_back(PasteboardEntry{"public.tiff", std::move(tiff)});
+    }
+    if (request.hasPng) {
+        first.entries.push_back(PasteboardEntry{"public.png", request.png});
+    }
+    if (!urls.empty()) {
+        first.entries.push_back(PasteboardEntry{"public.file-url", urls[0]});
+    }
+    snapshot.items.push_back(std::move(first));
+
+    for (size_t i = 1; i < urls.size(); i++) {
+        PasteboardItem item;
+        item.entries.push_back(PasteboardEntry{"public.file-url", urls[i]});
+        snapshot.items.push_back(std::move(item));
+    }
+    return true;
+}
+
+}  // namespace ztools
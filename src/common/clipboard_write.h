@@ -0,0 +1,111 @@
+// 原子写入多种剪贴板格式（writeClipboard）
+//
+// 原来只有 SetClipboardFiles 一个原生写入接口，需要同时写文本/HTML/图像的调用方只能分多次写入，
+// 每次写入都会向整个系统广播一次 WM_CLIPBOARDUPDATE。这里把全部格式在工作线程中预先编码为
+// 平台剪贴板所需的字节，再由平台 binding 在一次 OpenClipboard/EmptyClipboard/SetClipboardData
+// 事务（macOS 为一次 clearContents + writeObjects）中发布，监听方只会看到一次变化。
+// 事务本身（PublishClipboardWrite）通过 ClipboardBackend 完成：任一格式写入失败时再次清空，全有或全无。
+//
+// 编码与平台 API 无关，可直接测试：
+// - Windows: CF_UNICODETEXT（UTF-16LE）、"HTML Format"（CF_HTML 头部 + 片段）、"Rich Text Format"、
+//            CF_DIB（由 BGRA 像素生成）、"PNG"（原样写入）、CF_HDROP（DROPFILES + UTF-16 路径）
+// - macOS:   PasteboardSnapshot（public.utf8-plain-text / public.html / public.rtf / public.tiff /
+//            public.png / public.file-url），通过 pasteboardRestore 一次写入
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "clipboard_snapshot.h"
+#include "pasteboard.h"
+
+namespace ztools {
+
+// 原始 BGRA 像素（每像素 4 字节，自上而下逐行）；stride 为 0 时按 width * 4
+struct ClipboardWriteImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t stride = 0;
+    std::string bgra;
+};
+
+struct ClipboardWriteRequest {
+    bool hasText = false;
+    std::string text;  // UTF-8
+    bool hasHtml = false;
+    std::string html;  // UTF-8 HTML 片段或完整文档
+    bool hasRtf = false;
+    std::string rtf;
+    bool hasImage = false;
+    ClipboardWriteImage image;
+    bool hasPng = false;
+    std::string png;  // PNG 文件字节（JS 传入 base64 / data URL 时已在 binding 中解码）
+    bool hasFiles = false;
+    std::vector<std::string> files;  // UTF-8 绝对路径
+
+    bool Empty() const { return !hasText && !hasHtml && !hasRtf && !hasImage && !hasPng && !hasFiles; }
+};
+
+enum class ClipboardWriteFormat {
+    UnicodeText,  // CF_UNICODETEXT
+    Html,         // "HTML Format"
+    Rtf,          // "Rich Text Format"
+    Dib,          // CF_DIB
+    Png,          // "PNG"
+    Files,        // CF_HDROP
+};
+
+struct ClipboardWriteBlob {
+    ClipboardWriteFormat format;
+    std::string data;  // 直接复制进 HGLOBAL 的字节（含结尾 NUL）
+};
+
+// 检查图像尺寸与缓冲区大小；失败时 error 为原因
+bool ValidateClipboardWriteImage(const ClipboardWriteImage& image, std::string* error);
+
+// 检查 PNG 文件签名；失败时 error 为原因
+bool ValidateClipboardWritePng(const std::string& png, std::string* error);
+
+// UTF-8 → UTF-16LE 字节（无效序列替换为 U+FFFD），不含结尾 NUL
+std::string Utf8ToUtf16Le(const std::string& utf8);
+
+// CF_HTML：已包含 <!--StartFragment--> / <!--EndFragment--> 标记时按原文计算偏移，否则包装为片段
+std::string BuildCfHtml(const std::string& html);
+
+// 32 位 BI_RGB 打包 DIB（BITMAPINFOHEADER + 自下而上的像素）
+bool BuildDibFromBgra(const ClipboardWriteImage& image, std::string& dib);
+
+// CF_DIBV5：BITMAPV5HEADER（BI_BITFIELDS，带 alpha 掩码，sRGB）+ 自下而上的像素
+bool BuildDibV5FromBgra(const ClipboardWriteImage& image, std::string& dib);
+
+// 无压缩 RGBA TIFF（macOS public.tiff）
+bool BuildTiffFromBgra(const ClipboardWriteImage& image, std::string& tiff);
+
+// DROPFILES（fWide）+ 以 NUL 分隔、双 NUL 结尾的 UTF-16 路径
+std::string BuildDropFiles(const std::vector<std::string>& paths);
+
+// 绝对路径 → file:// URL（按 RFC 3986 转义非保留字符以外的字节）
+std::string FileUrlFromPath(const std::string& path);
+
+// Windows：按写入顺序生成各格式字节
+bool BuildClipboardWriteBlobs(const ClipboardWriteRequest& request, std::vector<ClipboardWriteBlob>& blobs,
+                              std::string* error);
+
+// 一个待写入的平台格式（format 为平台格式 id，data 指向 BuildClipboardWriteBlobs 生成的字节）
+struct ClipboardWriteItem {
+    uint32_t format;
+    const std::string* data;
+};
+
+// 在一次打开的会话内清空剪贴板并依次写入全部格式。任一格式写入失败时再次清空后关闭，
+// 剪贴板不会只留下部分格式（也不会残留旧内容）；失败时 error 为原因
+bool PublishClipboardWrite(ClipboardBackend& backend, const std::vector<ClipboardWriteItem>& items,
+                           std::string* error);
+
+// macOS：第一个 item 包含文本/HTML/RTF/图像与第一个文件，其余文件各占一个 item
+bool BuildPasteboardWriteSnapshot(const ClipboardWriteRequest& request, PasteboardSnapshot& snapshot,
+                                  std::string* error);
+
+}  // namespace ztools
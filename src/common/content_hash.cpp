@@ -0,0 +1,147 @@
+#include "content_hash.h"
+
+#include <cstring>
+
+namespace ztools {
+
+namespace {
+
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t Rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// 小端读取（x86/ARM 均为小端，memcpy 避免未对齐访问）
+inline uint64_t Read64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t Read32(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = Rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t val) {
+    acc ^= Round(0, val);
+    return acc * kPrime1 + kPrime4;
+}
+
+// 处理尾部不足 32 字节的数据并完成雪崩
+uint64_t Finalize(uint64_t h, const unsigned char* p, size_t length) {
+    const unsigned char* end = p + length;
+    while (p + 8 <= end) {
+        h ^= Round(0, Read64(p));
+        h = Rotl(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(Read32(p)) * kPrime1;
+        h = Rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * kPrime5;
+        h = Rotl(h, 11) * kPrime1;
+        p++;
+    }
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t MergeAccumulators(const uint64_t acc[4]) {
+    uint64_t h = Rotl(acc[0], 1) + Rotl(acc[1], 7) + Rotl(acc[2], 12) + Rotl(acc[3], 18);
+    h = MergeRound(h, acc[0]);
+    h = MergeRound(h, acc[1]);
+    h = MergeRound(h, acc[2]);
+    h = MergeRound(h, acc[3]);
+    return h;
+}
+
+}  // namespace
+
+uint64_t ContentHash64(const void* data, size_t length, uint64_t seed) {
+    ContentHasher hasher(seed);
+    hasher.Update(data, length);
+    return hasher.Digest();
+}
+
+ContentHasher::ContentHasher(uint64_t seed) : seed_(seed), totalLength_(0), buffered_(0) {
+    acc_[0] = seed + kPrime1 + kPrime2;
+    acc_[1] = seed + kPrime2;
+    acc_[2] = seed;
+    acc_[3] = seed - kPrime1;
+}
+
+void ContentHasher::Update(const void* data, size_t length) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    totalLength_ += length;
+
+    // 先补齐上次剩余的不完整块
+    if (buffered_ > 0) {
+        size_t take = 32 - buffered_;
+        if (take > length) take = length;
+        memcpy(buffer_ + buffered_, p, take);
+        buffered_ += take;
+        p += take;
+        length -= take;
+        if (buffered_ < 32) {
+            return;
+        }
+        acc_[0] = Round(acc_[0], Read64(buffer_));
+        acc_[1] = Round(acc_[1], Read64(buffer_ + 8));
+        acc_[2] = Round(acc_[2], Read64(buffer_ + 16));
+        acc_[3] = Round(acc_[3], Read64(buffer_ + 24));
+        buffered_ = 0;
+    }
+
+    // 主循环：每次 32 字节，4 路独立累加
+    uint64_t a0 = acc_[0], a1 = acc_[1], a2 = acc_[2], a3 = acc_[3];
+    while (length >= 32) {
+        a0 = Round(a0, Read64(p));
+        a1 = Round(a1, Read64(p + 8));
+        a2 = Round(a2, Read64(p + 16));
+        a3 = Round(a3, Read64(p + 24));
+        p += 32;
+        length -= 32;
+    }
+    acc_[0] = a0;
+    acc_[1] = a1;
+    acc_[2] = a2;
+    acc_[3] = a3;
+
+    if (length > 0) {
+        memcpy(buffer_, p, length);
+        buffered_ = length;
+    }
+}
+
+uint64_t ContentHasher::Digest() const {
+    uint64_t h;
+    if (totalLength_ >= 32) {
+        h = MergeAccumulators(acc_);
+    } else {
+        h = seed_ + kPrime5;
+    }
+    h += totalLength_;
+    return Finalize(h, buffer_, buffered_);
+}
+
+}  // namespace ztools
@@ -0,0 +1,35 @@
+// 64 位内容哈希（XXH64 算法，结果与官方 xxHash 实现一致）
+//
+// 用于剪贴板历史去重等场景：每次处理 32 字节，图片等大块数据也只需一次线性扫描。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ztools {
+
+uint64_t ContentHash64(const void* data, size_t length, uint64_t seed = 0);
+
+inline uint64_t ContentHash64(const std::string& data, uint64_t seed = 0) {
+    return ContentHash64(data.data(), data.size(), seed);
+}
+
+// 流式计算：多段数据依次 Update，结果与把各段拼接后一次性计算相同
+class ContentHasher {
+public:
+    explicit ContentHasher(uint64_t seed = 0);
+
+    void Update(const void* data, size_t length);
+    void Update(const std::string& data) { Update(data.data(), data.size()); }
+    uint64_t Digest() const;
+
+private:
+    uint64_t seed_;
+    uint64_t acc_[4];
+    uint64_t totalLength_;
+    unsigned char buffer_[32];
+    size_t buffered_;
+};
+
+}  // namespace ztools
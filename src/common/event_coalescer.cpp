@@ -0,0 +1,244 @@
+#include "event_coalescer.h"
+
+#include <chrono>
+
+namespace ztools {
+
+namespace {
+
+// leading 与 trailing 都关闭时事件只会被计数、永远不会触发：保留收尾回调
+CoalescerOptions Normalize(CoalescerOptions options) {
+    if (!options.leading) {
+        options.trailing = true;
+    }
+    return options;
+}
+
+}  // namespace
+
+EventCoalescer::EventCoalescer(const CoalescerOptions& options, Clock clock)
+    : options_(Normalize(options)), clock_(clock ? std::move(clock) : Clock(SteadyNowUs)), stats_{} {}
+
+void EventCoalescer::SetSink(Sink sink) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sink_ = std::move(sink);
+}
+
+void EventCoalescer::SetOptions(const CoalescerOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = Normalize(options);
+}
+
+void EventCoalescer::SetKeyMatcher(KeyMatcher matcher) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    matcher_ = std::move(matcher);
+}
+
+CoalescerOptions EventCoalescer::Options() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+bool EventCoalescer::Push(uint64_t key) {
+    std::vector<CoalescedBurst> fired;
+    Sink sink;
+    bool leadingFired = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint64_t now = clock_();
+        stats_.events++;
+
+        auto it = groups_.find(key);
+        if (it == groups_.end() && matcher_) {
+            // 并入匹配的进行中分组，沿用该分组本轮开始时的键
+            for (auto candidate = groups_.begin(); candidate != groups_.end(); ++candidate) {
+                if (matcher_(candidate->first, key)) {
+                    it = candidate;
+                    break;
+                }
+            }
+        }
+        if (it != groups_.end()) {
+            // Poll 可能被延迟调用：先结算该分组已到期的部分
+            if (ExpireLocked(key, it->second, now, fired)) {
+                groups_.erase(it);
+                it = groups_.end();
+            }
+        }
+
+        if (it == groups_.end()) {
+            // 新一轮开始
+            Group& g = groups_[key];
+            g.burstStartUs = now;
+            g.lastUs = now;
+            if (options_.leading) {
+                fired.push_back(CoalescedBurst{key, 1, now, now, now, CoalesceReason::Leading});
+                leadingFired = true;
+            } else {
+                g.firstUs = now;
+                g.pending = 1;
+            }
+        } else {
+            Group& g = it->second;
+            if (g.pending == 0) {
+                g.firstUs = now;
+            }
+            g.pending++;
+            g.lastUs = now;
+        }
+
+        for (const CoalescedBurst& burst : fired) {
+            stats_.fired++;
+            if (burst.reason == CoalesceReason::Leading) stats_.leading++;
+            else if (burst.reason == CoalesceReason::Quiet) stats_.quiet++;
+            else if (burst.reason == CoalesceReason::MaxWait) stats_.maxWait++;
+        }
+        sink = sink_;
+    }
+
+    // 在锁外调用 sink，允许 sink 内再次访问合并器
+    if (sink) {
+        for (const CoalescedBurst& burst : fired) {
+            sink(burst);
+        }
+    }
+    return leadingFired;
+}
+
+size_t EventCoalescer::Poll() {
+    std::vector<CoalescedBurst> fired;
+    Sink sink;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (groups_.empty()) {
+            return 0;
+        }
+        const uint64_t now = clock_();
+        for (auto it = groups_.begin(); it != groups_.end();) {
+            if (ExpireLocked(it->first, it->second, now, fired)) {
+                it = groups_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        for (const CoalescedBurst& burst : fired) {
+            stats_.fired++;
+            if (burst.reason == CoalesceReason::Quiet) stats_.quiet++;
+            else stats_.maxWait++;
+        }
+        sink = sink_;
+    }
+
+    if (sink) {
+        for (const CoalescedBurst& burst : fired) {
+            sink(burst);
+        }
+    }
+    return fired.size();
+}
+
+size_t EventCoalescer::Flush() {
+    std::vector<CoalescedBurst> fired;
+    Sink sink;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const uint64_t now = clock_();
+        for (const auto& entry : groups_) {
+            const Group& g = entry.second;
+            if (g.pending > 0) {
+                fired.push_back(CoalescedBurst{entry.first, g.pending, g.firstUs, g.lastUs, now,
+                                               CoalesceReason::Flush});
+            }
+        }
+        groups_.clear();
+        stats_.fired += fired.size();
+        sink = sink_;
+    }
+
+    if (sink) {
+        for (const CoalescedBurst& burst : fired) {
+            sink(burst);
+        }
+    }
+    return fired.size();
+}
+
+void EventCoalescer::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    groups_.clear();
+}
+
+bool EventCoalescer::ExpireLocked(uint64_t key, Group& group, uint64_t now,
+                                  std::vector<CoalescedBurst>& fired) const {
+    const uint64_t quietDeadline = group.lastUs + options_.quietUs;
+    if (now >= quietDeadline) {
+        if (group.pending > 0 && options_.trailing) {
+            fired.push_back(CoalescedBurst{key, group.pending, group.firstUs, group.lastUs, now,
+                                           CoalesceReason::Quiet});
+        }
+        return true;
+    }
+    if (group.pending > 0 && options_.maxWaitUs > 0 && now >= group.burstStartUs + options_.maxWaitUs) {
+        fired.push_back(CoalescedBurst{key, group.pending, group.firstUs, group.lastUs, now,
+                                       CoalesceReason::MaxWait});
+        // 事件仍在持续：从现在开始新一轮最长等待
+        group.burstStartUs = now;
+        group.pending = 0;
+    }
+    return false;
+}
+
+uint64_t EventCoalescer::DeadlineLocked(const Group& group) const {
+    uint64_t deadline = group.lastUs + options_.quietUs;
+    if (group.pending > 0 && options_.maxWaitUs > 0) {
+        const uint64_t maxDeadline = group.burstStartUs + options_.maxWaitUs;
+        if (maxDeadline < deadline) {
+            deadline = maxDeadline;
+        }
+    }
+    return deadline;
+}
+
+uint64_t EventCoalescer::NextDeadlineLocked() const {
+    uint64_t next = kNoDeadline;
+    for (const auto& entry : groups_) {
+        const uint64_t deadline = DeadlineLocked(entry.second);
+        if (deadline < next) {
+            next = deadline;
+        }
+    }
+    return next;
+}
+
+uint64_t EventCoalescer::NextDeadline() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return NextDeadlineLocked();
+}
+
+uint64_t EventCoalescer::TimeUntilNextDeadline() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t next = NextDeadlineLocked();
+    if (next == kNoDeadline) {
+        return kNoDeadline;
+    }
+    const uint64_t now = clock_();
+    return next > now ? next - now : 0;
+}
+
+size_t EventCoalescer::PendingGroups() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return groups_.size();
+}
+
+CoalescerStats EventCoalescer::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+uint64_t EventCoalescer::SteadyNowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+}  // namespace ztools
@@ -0,0 +1,125 @@
+// 事件合并器（平台无关，可注入时钟）
+//
+// 用于把短时间内的一串原始事件合并为少量回调，例如：
+// - Edge/Office 复制时会分多次写入不同格式，每次都触发 WM_CLIPBOARDUPDATE
+// - 窗口标题在页面加载期间连续变化
+//
+// 行为（按分组键独立计算）：
+// - leading：一串事件的第一个立即触发（无额外延迟）
+// - trailing：最后一个事件之后静默 quietUs 再触发一次（仅当首次触发后还有新事件）
+// - maxWaitUs：事件持续不断时，距本轮开始最多等待 maxWaitUs 就强制触发一次
+// - 键匹配（可选）：事件键与进行中分组的键匹配时并入该分组，分组键固定为本轮开始时的值，
+//   例如同一次复制分多次写入、格式集合逐步扩大时不会被拆成多轮
+//
+// 合并器本身不创建定时器：调用方在 Push 之后根据 NextDeadline() 设置定时器，
+// 定时器到期时调用 Poll()。所有时间都来自构造时注入的时钟，便于单元测试与基准。
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace ztools {
+
+struct CoalescerOptions {
+    bool leading = true;      // 首个事件立即触发
+    bool trailing = true;     // 静默期结束后触发收尾回调（与 leading 同时关闭时按开启处理，否则永不触发）
+    uint64_t quietUs = 100000;    // 静默期（微秒）
+    uint64_t maxWaitUs = 500000;  // 最长等待（微秒），0 表示不限制
+};
+
+// 触发原因
+enum class CoalesceReason : uint8_t {
+    Leading = 0,  // 首个事件立即触发
+    Quiet = 1,    // 静默期结束
+    MaxWait = 2,  // 达到最长等待
+    Flush = 3,    // 调用方主动 Flush
+};
+
+// 一次合并后的触发
+struct CoalescedBurst {
+    uint64_t key;          // 分组键
+    uint32_t count;        // 本次触发合并的原始事件数
+    uint64_t firstUs;      // 本次合并的第一个事件时间
+    uint64_t lastUs;       // 本次合并的最后一个事件时间
+    uint64_t firedUs;      // 触发时间
+    CoalesceReason reason;
+};
+
+struct CoalescerStats {
+    uint64_t events;    // Push 次数
+    uint64_t fired;     // 触发次数
+    uint64_t leading;   // 其中首个事件触发次数
+    uint64_t quiet;     // 其中静默期触发次数
+    uint64_t maxWait;   // 其中最长等待触发次数
+};
+
+class EventCoalescer {
+public:
+    using Clock = std::function<uint64_t()>;  // 单调时钟（微秒）
+    using Sink = std::function<void(const CoalescedBurst&)>;
+    // 事件键 key 是否属于键为 burstKey 的进行中分组（在锁内调用，不得访问合并器）
+    using KeyMatcher = std::function<bool(uint64_t burstKey, uint64_t key)>;
+
+    static const uint64_t kNoDeadline = UINT64_MAX;
+
+    explicit EventCoalescer(const CoalescerOptions& options = CoalescerOptions(), Clock clock = nullptr);
+
+    void SetSink(Sink sink);
+
+    // 设置键匹配；为空时只有键完全相同的事件属于同一分组
+    void SetKeyMatcher(KeyMatcher matcher);
+
+    // 修改配置（进行中的分组保留，下一次计算截止时间时生效）
+    void SetOptions(const CoalescerOptions& options);
+    CoalescerOptions Options() const;
+
+    // 记录一个事件；leading 触发时在本调用内同步调用 sink，返回 true
+    bool Push(uint64_t key = 0);
+
+    // 触发所有已到期的分组，返回触发次数
+    size_t Poll();
+
+    // 立即触发所有尚有未触发事件的分组并清空
+    size_t Flush();
+
+    // 丢弃所有进行中的分组（不触发）
+    void Clear();
+
+    // 最近的截止时间（绝对时间，微秒）；无待处理分组时返回 kNoDeadline
+    uint64_t NextDeadline() const;
+
+    // 距最近截止时间的剩余微秒数（已到期返回 0）；无待处理分组时返回 kNoDeadline
+    uint64_t TimeUntilNextDeadline() const;
+
+    size_t PendingGroups() const;
+    CoalescerStats Stats() const;
+
+    // 默认时钟：steady_clock（微秒）
+    static uint64_t SteadyNowUs();
+
+private:
+    struct Group {
+        uint64_t burstStartUs = 0;  // 本轮开始（用于 maxWait）
+        uint64_t firstUs = 0;       // 未触发事件中的第一个
+        uint64_t lastUs = 0;        // 最近一个事件
+        uint32_t pending = 0;       // 未触发的事件数
+    };
+
+    // 结算分组到期：必要时追加一次触发，返回该分组是否应被移除
+    bool ExpireLocked(uint64_t key, Group& group, uint64_t now, std::vector<CoalescedBurst>& fired) const;
+    uint64_t DeadlineLocked(const Group& group) const;
+    uint64_t NextDeadlineLocked() const;
+
+    mutable std::mutex mutex_;
+    CoalescerOptions options_;
+    Clock clock_;
+    Sink sink_;
+    KeyMatcher matcher_;
+    std::unordered_map<uint64_t, Group> groups_;
+    CoalescerStats stats_;
+};
+
+}  // namespace ztools
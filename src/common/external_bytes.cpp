@@ -0,0 +1,43 @@
+#include "external_bytes.h"
+
+#include <atomic>
+#include <utility>
+
+namespace ztools {
+
+namespace {
+
+std::atomic<uint64_t> g_liveCount(0);
+std::atomic<uint64_t> g_liveBytes(0);
+std::atomic<uint64_t> g_adopted(0);
+
+}  // namespace
+
+ExternalBytes::ExternalBytes(std::string&& bytes) : bytes_(std::move(bytes)) {
+    g_liveCount.fetch_add(1, std::memory_order_relaxed);
+    g_liveBytes.fetch_add(bytes_.size(), std::memory_order_relaxed);
+    g_adopted.fetch_add(1, std::memory_order_relaxed);
+}
+
+ExternalBytes::~ExternalBytes() {
+    g_liveCount.fetch_sub(1, std::memory_order_relaxed);
+    g_liveBytes.fetch_sub(bytes_.size(), std::memory_order_relaxed);
+}
+
+ExternalBytes* ExternalBytes::Adopt(std::string&& bytes) {
+    return new ExternalBytes(std::move(bytes));
+}
+
+void ExternalBytes::Release(ExternalBytes* bytes) {
+    delete bytes;
+}
+
+ExternalBytesStats ExternalBytes::Stats() {
+    ExternalBytesStats stats;
+    stats.liveCount = g_liveCount.load(std::memory_order_relaxed);
+    stats.liveBytes = g_liveBytes.load(std::memory_order_relaxed);
+    stats.adopted = g_adopted.load(std::memory_order_relaxed);
+    return stats;
+}
+
+}  // namespace ztools
@@ -0,0 +1,44 @@
+// 移交给 JS 的原生字节缓冲区
+//
+// 原来剪贴板文本要经过 wchar → std::string(UTF-8) → JS 字符串，图像要经过 PNG 字节 → base64
+// std::string → JS 字符串，50 MB 的内容会在内存中同时存在三四份。ExternalBytes 以 move 接管
+// 读取器已有的 std::string（不复制），由 binding 以 napi_create_external_arraybuffer /
+// napi_create_external_buffer 直接作为 JS 缓冲区的存储，GC 回收时经终结器释放。
+// 与 N-API 无关，可直接测试；全局统计当前尚未释放的缓冲区，便于发现泄漏。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ztools {
+
+struct ExternalBytesStats {
+    uint64_t liveCount;  // 尚未释放的缓冲区数
+    uint64_t liveBytes;  // 尚未释放的字节数
+    uint64_t adopted;    // 累计接管的缓冲区数
+};
+
+class ExternalBytes {
+public:
+    // 接管 bytes 的存储（move，不复制数据）；返回的对象必须交给 Release 释放
+    static ExternalBytes* Adopt(std::string&& bytes);
+    // 由 JS 缓冲区的终结器调用
+    static void Release(ExternalBytes* bytes);
+
+    char* Data() { return &bytes_[0]; }
+    size_t Size() const { return bytes_.size(); }
+
+    static ExternalBytesStats Stats();
+
+    ExternalBytes(const ExternalBytes&) = delete;
+    ExternalBytes& operator=(const ExternalBytes&) = delete;
+
+private:
+    explicit ExternalBytes(std::string&& bytes);
+    ~ExternalBytes();
+
+    std::string bytes_;
+};
+
+}  // namespace ztools
@@ -0,0 +1,1024 @@
+#include "history_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "content_hash.h"
+
+namespace ztools {
+
+const char* HistoryLog::kLogFileName = "history.log";
+const char* HistoryLog::kIndexFileName = "history.idx";
+
+namespace {
+
+const char kLogMagic[8] = {'Z', 'T', 'H', 'L', 'O', 'G', '0', '1'};
+const char kIndexMagic[8] = {'Z', 'T', 'H', 'I', 'D', 'X', '0', '1'};
+const uint32_t kVersion = 1;
+const uint64_t kHeaderSize = 64;
+const uint32_t kRecordMagic = 0x4352485A;  // "ZHRC"
+const uint64_t kChecksumStart = 16;        // 校验和覆盖记录第 16 字节之后的内容
+const uint64_t kMinIndexEntries = 1024;
+
+const uint16_t kKindEntry = 1;
+const uint16_t kKindTombstone = 2;
+
+const uint32_t kEntryDead = 1;       // 已删除或被新记录覆盖
+const uint32_t kEntryTombstone = 2;  // 墓碑记录（本身不是条目）
+
+struct LogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t generation;
+    uint8_t reserved[40];
+};
+static_assert(sizeof(LogHeader) == kHeaderSize, "LogHeader must be 64 bytes");
+
+struct RecordHeader {
+    uint32_t magic;
+    uint32_t length;  // 不含对齐填充
+    uint64_t checksum;
+    uint64_t id;
+    uint64_t hash;
+    uint64_t sequence;
+    uint64_t createdAtMs;
+    uint64_t lastSeenAtMs;
+    uint32_t copyCount;
+    uint16_t kind;
+    uint16_t formatCount;
+};
+static_assert(sizeof(RecordHeader) == 64, "RecordHeader must be 64 bytes");
+
+struct FormatHeader {
+    uint16_t nameLength;
+    uint16_t reserved;
+    uint32_t dataLength;
+};
+static_assert(sizeof(FormatHeader) == 8, "FormatHeader must be 8 bytes");
+
+inline uint64_t Align8(uint64_t value) {
+    return (value + 7) & ~static_cast<uint64_t>(7);
+}
+
+// 记录编码后的长度（不含对齐填充）
+uint64_t EncodedRecordSize(const HistoryLogRecord& record) {
+    uint64_t total = sizeof(RecordHeader);
+    for (const ClipboardHistoryFormat& format : record.formats) {
+        total += sizeof(FormatHeader) + format.name.size() + format.data.size();
+    }
+    return total;
+}
+
+uint64_t NowUnixMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+uint64_t NewGeneration() {
+    uint64_t now = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    return now ^ (NowUnixMs() << 20) ^ 0x5A54484C4F473031ULL;
+}
+
+std::string JoinPath(const std::string& directory, const char* name) {
+    if (directory.empty()) return name;
+    char last = directory.back();
+    if (last == '/' || last == '\\') return directory + name;
+    return directory + "/" + name;
+}
+
+}  // namespace
+
+struct HistoryLog::IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t generation;    // 必须与日志文件头一致
+    uint64_t logCommitted;  // 已登记到索引的日志末尾
+    uint64_t count;         // 索引项数量
+    uint64_t live;          // 有效条目数
+    uint64_t deadBytes;     // 失效记录占用字节
+    uint64_t nextId;
+};
+
+struct HistoryLog::IndexEntry {
+    uint64_t offset;
+    uint64_t id;
+    uint64_t hash;
+    uint32_t length;
+    uint32_t flags;
+};
+
+HistoryLog::HistoryLog() : logEnd_(0), evictCursor_(0), lookupBuilt_(false), compacting_(false), stats_{} {
+    static_assert(sizeof(IndexHeader) == kHeaderSize, "IndexHeader must be 64 bytes");
+    static_assert(sizeof(IndexEntry) == 32, "IndexEntry must be 32 bytes");
+}
+
+HistoryLog::~HistoryLog() {
+    Close();
+}
+
+HistoryLog::IndexHeader* HistoryLog::Header() {
+    return reinterpret_cast<IndexHeader*>(index_.Data());
+}
+
+const HistoryLog::IndexHeader* HistoryLog::Header() const {
+    return reinterpret_cast<const IndexHeader*>(index_.Data());
+}
+
+HistoryLog::IndexEntry* HistoryLog::Entries() {
+    return reinterpret_cast<IndexEntry*>(index_.Data() + kHeaderSize);
+}
+
+const HistoryLog::IndexEntry* HistoryLog::Entries() const {
+    return reinterpret_cast<const IndexEntry*>(index_.Data() + kHeaderSize);
+}
+
+void HistoryLog::SetError(const std::string& error) {
+    lastError_ = error;
+}
+
+std::string HistoryLog::LastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastError_;
+}
+
+bool HistoryLog::Open(const std::string& directory, const HistoryLogOptions& options) {
+    Close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_ = directory;
+    options_ = options;
+    stats_ = HistoryLogStats{};
+    if (!OpenLocked()) {
+        log_.Close();
+        index_.Close();
+        return false;
+    }
+    // 容量可能比上次运行时小
+    EnforceLimitsLocked();
+    MaybeCompactLocked();
+    return true;
+}
+
+bool HistoryLog::OpenLocked() {
+    stats_.recoveredRecords = 0;
+    stats_.truncatedBytes = 0;
+    stats_.indexRebuilt = false;
+    evictCursor_ = 0;
+    lookupBuilt_ = false;
+    liveById_.clear();
+    liveByHash_.clear();
+
+    if (!log_.Open(JoinPath(directory_, kLogFileName))) {
+        SetError(log_.LastError());
+        return false;
+    }
+    if (log_.Size() < kHeaderSize) {
+        if (!CreateLogLocked()) {
+            return false;
+        }
+    }
+    LogHeader logHeader;
+    memcpy(&logHeader, log_.Data(), sizeof(logHeader));
+    if (memcmp(logHeader.magic, kLogMagic, sizeof(kLogMagic)) != 0 || logHeader.version != kVersion) {
+        SetError("Invalid history log file");
+        return false;
+    }
+
+    if (!index_.Open(JoinPath(directory_, kIndexFileName))) {
+        SetError(index_.LastError());
+        return false;
+    }
+
+    // O(1) 校验：文件头、代数、以及最后一个索引项指向的记录
+    bool indexValid = index_.Size() >= kHeaderSize;
+    if (indexValid) {
+        const IndexHeader* header = Header();
+        indexValid = memcmp(header->magic, kIndexMagic, sizeof(kIndexMagic)) == 0 &&
+                     header->version == kVersion && header->generation == logHeader.generation &&
+                     header->logCommitted >= kHeaderSize && header->logCommitted <= log_.Size() &&
+                     kHeaderSize + header->count * sizeof(IndexEntry) <= index_.Size();
+        if (indexValid && header->count > 0) {
+            const IndexEntry& last = Entries()[header->count - 1];
+            uint32_t length = 0;
+            indexValid = Align8(last.offset + last.length) == header->logCommitted &&
+                         ValidateRecordLocked(last.offset, header->logCommitted, length) &&
+                         length == last.length;
+        } else if (indexValid) {
+            indexValid = header->logCommitted == kHeaderSize;
+        }
+    }
+
+    if (!indexValid) {
+        return RebuildIndexLocked();
+    }
+    return RecoverTailLocked(Header()->logCommitted);
+}
+
+bool HistoryLog::CreateLogLocked() {
+    if (!log_.Resize(kHeaderSize)) {
+        SetError(log_.LastError());
+        return false;
+    }
+    LogHeader header = {};
+    memcpy(header.magic, kLogMagic, sizeof(kLogMagic));
+    header.version = kVersion;
+    header.headerSize = static_cast<uint32_t>(kHeaderSize);
+    header.generation = NewGeneration();
+    memcpy(log_.Data(), &header, sizeof(header));
+    return true;
+}
+
+bool HistoryLog::RebuildIndexLocked() {
+    stats_.indexRebuilt = true;
+    if (!index_.Resize(0) || !index_.Resize(kHeaderSize + kMinIndexEntries * sizeof(IndexEntry))) {
+        SetError(index_.LastError());
+        return false;
+    }
+    LogHeader logHeader;
+    memcpy(&logHeader, log_.Data(), sizeof(logHeader));
+
+    IndexHeader* header = Header();
+    memcpy(header->magic, kIndexMagic, sizeof(kIndexMagic));
+    header->version = kVersion;
+    header->headerSize = static_cast<uint32_t>(kHeaderSize);
+    header->generation = logHeader.generation;
+    header->logCommitted = kHeaderSize;
+    header->count = 0;
+    header->live = 0;
+    header->deadBytes = 0;
+    header->nextId = 1;
+
+    // 从空索引开始重放整个日志
+    evictCursor_ = 0;
+    lookupBuilt_ = true;
+    liveById_.clear();
+    liveByHash_.clear();
+    return RecoverTailLocked(kHeaderSize);
+}
+
+bool HistoryLog::ValidateRecordLocked(uint64_t offset, uint64_t limit, uint32_t& length) const {
+    if (offset + sizeof(RecordHeader) > limit) {
+        return false;
+    }
+    RecordHeader header;
+    memcpy(&header, log_.Data() + offset, sizeof(header));
+    if (header.magic != kRecordMagic || header.length < sizeof(RecordHeader) || offset + header.length > limit) {
+        return false;
+    }
+    if (header.kind != kKindEntry && header.kind != kKindTombstone) {
+        return false;
+    }
+    const uint64_t checksum = ContentHash64(log_.Data() + offset + kChecksumStart, header.length - kChecksumStart);
+    if (checksum != header.checksum) {
+        return false;
+    }
+    length = header.length;
+    return true;
+}
+
+bool HistoryLog::RecoverTailLocked(uint64_t from) {
+    uint64_t pos = from;
+    uint32_t length = 0;
+    while (ValidateRecordLocked(pos, log_.Size(), length)) {
+        RecordHeader header;
+        memcpy(&header, log_.Data() + pos, sizeof(header));
+        uint32_t flags = header.kind == kKindTombstone ? (kEntryTombstone | kEntryDead) : 0;
+        if (!AppendIndexLocked(pos, header.id, header.hash, length, flags)) {
+            return false;
+        }
+        ApplyRecordLocked(Header()->count - 1);
+        pos += Align8(length);
+        if (!stats_.indexRebuilt) {
+            stats_.recoveredRecords++;
+        }
+    }
+    logEnd_ = pos;
+    Header()->logCommitted = pos;
+
+    // 崩溃后末尾可能残留写了一半的记录；清零以免之后被误认为有效记录
+    if (log_.Size() > pos) {
+        char* data = log_.Data();
+        uint64_t last = log_.Size();
+        while (last > pos && data[last - 1] == 0) {
+            last--;
+        }
+        if (last > pos) {
+            stats_.truncatedBytes = last - pos;
+            memset(data + pos, 0, static_cast<size_t>(last - pos));
+        }
+    }
+    return true;
+}
+
+bool HistoryLog::EnsureIndexCapacityLocked(uint64_t entries) {
+    const uint64_t needed = kHeaderSize + entries * sizeof(IndexEntry);
+    if (needed <= index_.Size()) {
+        return true;
+    }
+    uint64_t size = std::max(needed, index_.Size() + index_.Size() / 2);
+    size = std::max(size, kHeaderSize + kMinIndexEntries * sizeof(IndexEntry));
+    if (!index_.Resize(size)) {
+        SetError(index_.LastError());
+        return false;
+    }
+    return true;
+}
+
+bool HistoryLog::EnsureLogCapacityLocked(uint64_t needed) {
+    if (needed <= log_.Size()) {
+        return true;
+    }
+    uint64_t size = std::max(needed, log_.Size() + std::max(options_.growBytes, log_.Size() / 2));
+    if (!log_.Resize(size)) {
+        SetError(log_.LastError());
+        return false;
+    }
+    return true;
+}
+
+bool HistoryLog::AppendIndexLocked(uint64_t offset, uint64_t id, uint64_t hash, uint32_t length, uint32_t flags) {
+    if (!EnsureIndexCapacityLocked(Header()->count + 1)) {
+        return false;
+    }
+    IndexHeader* header = Header();
+    IndexEntry& entry = Entries()[header->count];
+    entry.offset = offset;
+    entry.id = id;
+    entry.hash = hash;
+    entry.length = length;
+    entry.flags = flags;
+    header->count++;
+    header->logCommitted = Align8(offset + length);
+    return true;
+}
+
+void HistoryLog::EnsureLookupLocked() const {
+    if (lookupBuilt_) {
+        return;
+    }
+    const IndexHeader* header = Header();
+    const IndexEntry* entries = Entries();
+    liveById_.clear();
+    liveByHash_.clear();
+    liveById_.reserve(static_cast<size_t>(header->live));
+    liveByHash_.reserve(static_cast<size_t>(header->live));
+    for (uint64_t i = 0; i < header->count; i++) {
+        if ((entries[i].flags & kEntryDead) == 0) {
+            liveById_[entries[i].id] = i;
+            liveByHash_[entries[i].hash] = i;
+        }
+    }
+    lookupBuilt_ = true;
+}
+
+void HistoryLog::MarkDeadLocked(uint64_t slot) {
+    IndexEntry& entry = Entries()[slot];
+    if (entry.flags & kEntryDead) {
+        return;
+    }
+    entry.flags |= kEntryDead;
+    IndexHeader* header = Header();
+    header->live--;
+    header->deadBytes += Align8(entry.length);
+
+    auto byId = liveById_.find(entry.id);
+    if (byId != liveById_.end() && byId->second == slot) {
+        liveById_.erase(byId);
+    }
+    auto byHash = liveByHash_.find(entry.hash);
+    if (byHash != liveByHash_.end() && byHash->second == slot) {
+        liveByHash_.erase(byHash);
+    }
+}
+
+void HistoryLog::ApplyRecordLocked(uint64_t slot) {
+    EnsureLookupLocked();
+    IndexHeader* header = Header();
+    const IndexEntry entry = Entries()[slot];
+
+    if (entry.id >= header->nextId) {
+        header->nextId = entry.id + 1;
+    }
+
+    if (entry.flags & kEntryTombstone) {
+        header->deadBytes += Align8(entry.length);
+        auto it = liveById_.find(entry.id);
+        if (it != liveById_.end()) {
+            MarkDeadLocked(it->second);
+        }
+        return;
+    }
+
+    // 相同 id 或相同内容的旧记录被新记录覆盖
+    // （查找表可能刚从包含本条的索引构建，需排除自身）
+    auto byId = liveById_.find(entry.id);
+    if (byId != liveById_.end() && byId->second != slot) {
+        MarkDeadLocked(byId->second);
+    }
+    auto byHash = liveByHash_.find(entry.hash);
+    if (byHash != liveByHash_.end() && byHash->second != slot) {
+        MarkDeadLocked(byHash->second);
+    }
+    liveById_[entry.id] = slot;
+    liveByHash_[entry.hash] = slot;
+    header->live++;
+}
+
+uint64_t HistoryLog::WriteRecordLocked(const HistoryLogRecord& record, uint16_t kind, uint32_t& length) {
+    for (const ClipboardHistoryFormat& format : record.formats) {
+        if (format.name.size() > 0xFFFF || format.data.size() > 0xFFFFFFFFull) {
+            SetError("Format too large for history log");
+            return 0;
+        }
+    }
+    const uint64_t total = EncodedRecordSize(record);
+    if (total > 0xFFFFFFFFull || record.formats.size() > 0xFFFF) {
+        SetError("Record too large for history log");
+        return 0;
+    }
+
+    const uint64_t offset = logEnd_;
+    const uint64_t aligned = Align8(total);
+    if (!EnsureLogCapacityLocked(offset + aligned)) {
+        return 0;
+    }
+
+    char* base = log_.Data() + offset;
+    RecordHeader header = {};
+    header.magic = kRecordMagic;
+    header.length = static_cast<uint32_t>(total);
+    header.id = record.id;
+    header.hash = record.hash;
+    header.sequence = record.sequence;
+    header.createdAtMs = record.createdAtMs;
+    header.lastSeenAtMs = record.lastSeenAtMs;
+    header.copyCount = record.copyCount;
+    header.kind = kind;
+    header.formatCount = static_cast<uint16_t>(record.formats.size());
+    memcpy(base, &header, sizeof(header));
+
+    char* p = base + sizeof(RecordHeader);
+    for (const ClipboardHistoryFormat& format : record.formats) {
+        FormatHeader formatHeader = {};
+        formatHeader.nameLength = static_cast<uint16_t>(format.name.size());
+        formatHeader.dataLength = static_cast<uint32_t>(format.data.size());
+        memcpy(p, &formatHeader, sizeof(formatHeader));
+        p += sizeof(formatHeader);
+        memcpy(p, format.name.data(), format.name.size());
+        p += format.name.size();
+        memcpy(p, format.data.data(), format.data.size());
+        p += format.data.size();
+    }
+    memset(p, 0, static_cast<size_t>(aligned - total));
+
+    // 最后写入校验和：崩溃时写了一半的记录无法通过校验
+    header.checksum = ContentHash64(base + kChecksumStart, total - kChecksumStart);
+    memcpy(base + 8, &header.checksum, sizeof(header.checksum));
+
+    if (options_.syncOnAppend) {
+        log_.Sync(offset, aligned);
+    }
+    logEnd_ = offset + aligned;
+    length = static_cast<uint32_t>(total);
+    return offset;
+}
+
+uint64_t HistoryLog::Append(const HistoryLogRecord& input) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!log_.IsOpen()) {
+        return 0;
+    }
+
+    HistoryLogRecord record = input;
+    if (record.id == 0) {
+        record.id = Header()->nextId;
+    }
+    if (record.hash == 0) {
+        record.hash = ClipboardHistory::HashFormats(record.formats);
+    }
+    if (record.createdAtMs == 0) {
+        record.createdAtMs = NowUnixMs();
+    }
+    if (record.lastSeenAtMs == 0) {
+        record.lastSeenAtMs = record.createdAtMs;
+    }
+    if (options_.maxBytes > 0 && Align8(EncodedRecordSize(record)) > options_.maxBytes) {
+        SetError("Record exceeds history log maxBytes");
+        return 0;
+    }
+
+    // 不同 id 的相同内容（如重启后再次复制）：继承首次出现时间并累加次数
+    EnsureLookupLocked();
+    auto byHash = liveByHash_.find(record.hash);
+    if (byHash != liveByHash_.end() && Entries()[byHash->second].id != record.id) {
+        RecordHeader old;
+        memcpy(&old, log_.Data() + Entries()[byHash->second].offset, sizeof(old));
+        record.createdAtMs = std::min(record.createdAtMs, old.createdAtMs);
+        record.copyCount += old.copyCount;
+    }
+
+    uint32_t length = 0;
+    const uint64_t offset = WriteRecordLocked(record, kKindEntry, length);
+    if (offset == 0) {
+        return 0;
+    }
+    if (!AppendIndexLocked(offset, record.id, record.hash, length, 0)) {
+        return 0;
+    }
+    ApplyRecordLocked(Header()->count - 1);
+    EnforceLimitsLocked();
+    MaybeCompactLocked();
+    return record.id;
+}
+
+bool HistoryLog::WriteTombstoneLocked(uint64_t id) {
+    HistoryLogRecord tombstone;
+    tombstone.id = id;
+    tombstone.copyCount = 0;
+    tombstone.createdAtMs = NowUnixMs();
+    tombstone.lastSeenAtMs = tombstone.createdAtMs;
+    uint32_t length = 0;
+    const uint64_t offset = WriteRecordLocked(tombstone, kKindTombstone, length);
+    if (offset == 0 || !AppendIndexLocked(offset, id, 0, length, kEntryTombstone | kEntryDead)) {
+        return false;
+    }
+    ApplyRecordLocked(Header()->count - 1);
+    return true;
+}
+
+// 超出容量时从最旧的有效记录开始写墓碑；最新一条始终保留
+void HistoryLog::EnforceLimitsLocked() {
+    if (options_.maxEntries == 0 && options_.maxBytes == 0) {
+        return;
+    }
+    const IndexEntry* entries = Entries();
+    for (;;) {
+        const IndexHeader* header = Header();
+        // 墓碑的字节计入 deadBytes，有效字节 = 已写入的记录 - 失效部分
+        const uint64_t liveBytes = logEnd_ - kHeaderSize - header->deadBytes;
+        const bool overEntries = options_.maxEntries > 0 && header->live > options_.maxEntries;
+        const bool overBytes = options_.maxBytes > 0 && liveBytes > options_.maxBytes;
+        if (header->live <= 1 || (!overEntries && !overBytes)) {
+            return;
+        }
+        while (evictCursor_ < header->count && (entries[evictCursor_].flags & kEntryDead)) {
+            evictCursor_++;
+        }
+        if (evictCursor_ >= header->count || !WriteTombstoneLocked(entries[evictCursor_].id)) {
+            return;
+        }
+        // 写墓碑可能扩展索引文件并重新映射
+        entries = Entries();
+        stats_.evicted++;
+    }
+}
+
+void HistoryLog::SetLimits(uint64_t maxEntries, uint64_t maxBytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_.maxEntries = maxEntries;
+    options_.maxBytes = maxBytes;
+    if (log_.IsOpen()) {
+        EnforceLimitsLocked();
+        MaybeCompactLocked();
+    }
+}
+
+bool HistoryLog::Remove(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!log_.IsOpen() || FindLiveLocked(id) < 0) {
+        return false;
+    }
+    if (!WriteTombstoneLocked(id)) {
+        return false;
+    }
+    MaybeCompactLocked();
+    return true;
+}
+
+bool HistoryLog::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!log_.IsOpen()) {
+        return false;
+    }
+    const uint64_t nextId = Header()->nextId;
+
+    // 新代数：进行中的后台压缩在替换文件前会发现代数变化并放弃
+    if (!log_.Resize(0) || !CreateLogLocked()) {
+        SetError(log_.LastError());
+        return false;
+    }
+    logEnd_ = kHeaderSize;
+    if (!RebuildIndexLocked()) {
+        return false;
+    }
+    stats_.indexRebuilt = false;
+    Header()->nextId = nextId;
+    return true;
+}
+
+void HistoryLog::Close() {
+    WaitForCompaction();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!log_.IsOpen()) {
+        return;
+    }
+    // 去掉预分配的空白部分，下次打开时无需检查尾部
+    if (index_.IsOpen() && index_.Size() >= kHeaderSize) {
+        log_.Resize(logEnd_);
+        index_.Resize(kHeaderSize + Header()->count * sizeof(IndexEntry));
+    }
+    log_.Close();
+    index_.Close();
+    lookupBuilt_ = false;
+    liveById_.clear();
+    liveByHash_.clear();
+}
+
+bool HistoryLog::IsOpen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_.IsOpen();
+}
+
+size_t HistoryLog::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_.IsOpen() ? static_cast<size_t>(Header()->live) : 0;
+}
+
+uint64_t HistoryLog::NextId() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_.IsOpen() ? Header()->nextId : 1;
+}
+
+int64_t HistoryLog::FindLiveLocked(uint64_t id) const {
+    EnsureLookupLocked();
+    auto it = liveById_.find(id);
+    return it == liveById_.end() ? -1 : static_cast<int64_t>(it->second);
+}
+
+bool HistoryLog::ReadRecordLocked(uint64_t slot, HistoryLogRecord& record, bool withData) const {
+    const IndexEntry& entry = Entries()[slot];
+    const char* base = log_.Data() + entry.offset;
+    RecordHeader header;
+    memcpy(&header, base, sizeof(header));
+
+    record.id = header.id;
+    record.hash = header.hash;
+    record.sequence = header.sequence;
+    record.createdAtMs = header.createdAtMs;
+    record.lastSeenAtMs = header.lastSeenAtMs;
+    record.copyCount = header.copyCount;
+    record.formats.clear();
+    record.formats.reserve(header.formatCount);
+
+    const char* p = base + sizeof(RecordHeader);
+    const char* end = base + header.length;
+    for (uint16_t i = 0; i < header.formatCount; i++) {
+        FormatHeader formatHeader;
+        if (p + sizeof(formatHeader) > end) return false;
+        memcpy(&formatHeader, p, sizeof(formatHeader));
+        p += sizeof(formatHeader);
+        if (p + formatHeader.nameLength + formatHeader.dataLength > end) return false;
+
+        ClipboardHistoryFormat format;
+        format.name.assign(p, formatHeader.nameLength);
+        p += formatHeader.nameLength;
+        if (withData) {
+            format.data.assign(p, formatHeader.dataLength);
+        }
+        p += formatHeader.dataLength;
+        record.formats.push_back(std::move(format));
+    }
+    return true;
+}
+
+std::vector<ClipboardHistoryEntryInfo> HistoryLog::Page(size_t offset, size_t count) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ClipboardHistoryEntryInfo> result;
+    if (!log_.IsOpen() || count == 0) {
+        return result;
+    }
+
+    const IndexHeader* header = Header();
+    const IndexEntry* entries = Entries();
+    size_t skipped = 0;
+    for (uint64_t i = header->count; i > 0 && result.size() < count; i--) {
+        const IndexEntry& entry = entries[i - 1];
+        if (entry.flags & kEntryDead) {
+            continue;
+        }
+        if (skipped < offset) {
+            skipped++;
+            continue;
+        }
+
+        // 直接解析记录头与格式表，数据只计算大小
+        const char* base = log_.Data() + entry.offset;
+        RecordHeader record;
+        memcpy(&record, base, sizeof(record));
+
+        ClipboardHistoryEntryInfo info;
+        info.id = record.id;
+        info.hash = record.hash;
+        info.sequence = record.sequence;
+        info.createdAtMs = record.createdAtMs;
+        info.lastSeenAtMs = record.lastSeenAtMs;
+        info.copyCount = record.copyCount;
+        info.bytes = 0;
+
+        const char* p = base + sizeof(RecordHeader);
+        const char* end = base + record.length;
+        for (uint16_t f = 0; f < record.formatCount && p + sizeof(FormatHeader) <= end; f++) {
+            FormatHeader formatHeader;
+            memcpy(&formatHeader, p, sizeof(formatHeader));
+            p += sizeof(formatHeader);
+            info.formats.push_back(ClipboardHistoryFormatInfo{std::string(p, formatHeader.nameLength),
+                                                              formatHeader.dataLength});
+            info.bytes += formatHeader.dataLength;
+            p += formatHeader.nameLength + formatHeader.dataLength;
+        }
+        result.push_back(std::move(info));
+    }
+    return result;
+}
+
+bool HistoryLog::Read(uint64_t id, HistoryLogRecord& record) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!log_.IsOpen()) {
+        return false;
+    }
+    int64_t slot = FindLiveLocked(id);
+    if (slot < 0) {
+        return false;
+    }
+    return ReadRecordLocked(static_cast<uint64_t>(slot), record, true);
+}
+
+std::shared_ptr<const std::string> HistoryLog::ReadFormat(uint64_t id, const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!log_.IsOpen()) {
+        return nullptr;
+    }
+    int64_t slot = FindLiveLocked(id);
+    if (slot < 0) {
+        return nullptr;
+    }
+
+    const IndexEntry& entry = Entries()[slot];
+    const char* base = log_.Data() + entry.offset;
+    RecordHeader header;
+    memcpy(&header, base, sizeof(header));
+    const char* p = base + sizeof(RecordHeader);
+    const char* end = base + header.length;
+    for (uint16_t i = 0; i < header.formatCount && p + sizeof(FormatHeader) <= end; i++) {
+        FormatHeader formatHeader;
+        memcpy(&formatHeader, p, sizeof(formatHeader));
+        p += sizeof(formatHeader);
+        if (name.size() == formatHeader.nameLength && memcmp(p, name.data(), name.size()) == 0) {
+            p += formatHeader.nameLength;
+            return std::make_shared<const std::string>(p, formatHeader.dataLength);
+        }
+        p += formatHeader.nameLength + formatHeader.dataLength;
+    }
+    return nullptr;
+}
+
+HistoryLogStats HistoryLog::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HistoryLogStats stats = stats_;
+    if (log_.IsOpen()) {
+        const IndexHeader* header = Header();
+        stats.records = header->count;
+        stats.live = header->live;
+        stats.logBytes = logEnd_;
+        stats.deadBytes = header->deadBytes;
+    }
+    return stats;
+}
+
+// ==================== 压缩 ====================
+
+void HistoryLog::MaybeCompactLocked() {
+    if (!options_.autoCompact || compacting_) {
+        return;
+    }
+    const IndexHeader* header = Header();
+    if (logEnd_ < options_.compactMinBytes ||
+        static_cast<double>(header->deadBytes) < options_.compactDeadRatio * static_cast<double>(logEnd_)) {
+        return;
+    }
+    bool expected = false;
+    if (!compacting_.compare_exchange_strong(expected, true)) {
+        return;
+    }
+    // 上一次压缩线程已结束（compacting_ 为 false），可直接回收
+    if (compactThread_.joinable()) {
+        compactThread_.join();
+    }
+    compactThread_ = std::thread([this]() {
+        CompactImpl();
+        compacting_ = false;
+    });
+}
+
+bool HistoryLog::CompactAsync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!log_.IsOpen()) {
+        return false;
+    }
+    bool expected = false;
+    if (!compacting_.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+    if (compactThread_.joinable()) {
+        compactThread_.join();
+    }
+    compactThread_ = std::thread([this]() {
+        CompactImpl();
+        compacting_ = false;
+    });
+    return true;
+}
+
+bool HistoryLog::Compact() {
+    WaitForCompaction();
+    bool expected = false;
+    if (!compacting_.compare_exchange_strong(expected, true)) {
+        return false;
+    }
+    bool ok = CompactImpl();
+    compacting_ = false;
+    return ok;
+}
+
+void HistoryLog::WaitForCompaction() {
+    std::thread thread;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        thread = std::move(compactThread_);
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool HistoryLog::CompactImpl() {
+    struct LiveRecord {
+        uint64_t slot;
+        uint64_t offset;
+        uint32_t length;
+        uint64_t id;
+        uint64_t hash;
+    };
+
+    // 第一阶段（持锁）：记录快照
+    std::vector<LiveRecord> live;
+    uint64_t snapshotCount = 0;
+    uint64_t generation = 0;
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!log_.IsOpen()) {
+            return false;
+        }
+        const IndexHeader* header = Header();
+        const IndexEntry* entries = Entries();
+        snapshotCount = header->count;
+        generation = header->generation;
+        directory = directory_;
+        live.reserve(static_cast<size_t>(header->live));
+        for (uint64_t i = 0; i < snapshotCount; i++) {
+            if ((entries[i].flags & kEntryDead) == 0) {
+                live.push_back(LiveRecord{i, entries[i].offset, entries[i].length, entries[i].id, entries[i].hash});
+            }
+        }
+    }
+
+    // 第二阶段（不持锁）：通过文件句柄读取有效记录，写入新日志
+    const std::string tmpLogPath = JoinPath(directory, kLogFileName) + ".compact";
+    const std::string tmpIndexPath = JoinPath(directory, kIndexFileName) + ".compact";
+    MappedFile::RemoveFile(tmpLogPath);
+    MappedFile::RemoveFile(tmpIndexPath);
+
+    uint64_t liveBytes = 0;
+    for (const LiveRecord& record : live) {
+        liveBytes += Align8(record.length);
+    }
+
+    MappedFile newLog;
+    if (!newLog.Open(tmpLogPath) || !newLog.Resize(kHeaderSize + liveBytes)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        SetError(newLog.LastError());
+        return false;
+    }
+    LogHeader logHeader = {};
+    memcpy(logHeader.magic, kLogMagic, sizeof(kLogMagic));
+    logHeader.version = kVersion;
+    logHeader.headerSize = static_cast<uint32_t>(kHeaderSize);
+    logHeader.generation = generation + 1;
+    memcpy(newLog.Data(), &logHeader, sizeof(logHeader));
+
+    std::vector<IndexEntry> newEntries;
+    newEntries.reserve(live.size());
+    uint64_t pos = kHeaderSize;
+    for (const LiveRecord& record : live) {
+        if (!log_.ReadAt(record.offset, newLog.Data() + pos, Align8(record.length))) {
+            newLog.Close();
+            MappedFile::RemoveFile(tmpLogPath);
+            return false;
+        }
+        newEntries.push_back(IndexEntry{pos, record.id, record.hash, record.length, 0});
+        pos += Align8(record.length);
+    }
+
+    // 第三阶段（持锁）：补上压缩期间的变化并替换文件
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!log_.IsOpen() || Header()->generation != generation) {
+        // 期间被关闭或清空
+        newLog.Close();
+        MappedFile::RemoveFile(tmpLogPath);
+        return false;
+    }
+
+    const IndexHeader* header = Header();
+    const IndexEntry* entries = Entries();
+    uint64_t liveCount = 0;
+    uint64_t deadBytes = 0;
+    for (size_t i = 0; i < live.size(); i++) {
+        if (entries[live[i].slot].flags & kEntryDead) {
+            newEntries[i].flags = kEntryDead;
+            deadBytes += Align8(newEntries[i].length);
+        } else {
+            liveCount++;
+        }
+    }
+    uint64_t tailBytes = 0;
+    for (uint64_t i = snapshotCount; i < header->count; i++) {
+        tailBytes += Align8(entries[i].length);
+    }
+    if (tailBytes > 0) {
+        if (!newLog.Resize(pos + tailBytes)) {
+            SetError(newLog.LastError());
+            newLog.Close();
+            MappedFile::RemoveFile(tmpLogPath);
+            return false;
+        }
+        for (uint64_t i = snapshotCount; i < header->count; i++) {
+            const IndexEntry& entry = entries[i];
+            memcpy(newLog.Data() + pos, log_.Data() + entry.offset, static_cast<size_t>(Align8(entry.length)));
+            newEntries.push_back(IndexEntry{pos, entry.id, entry.hash, entry.length, entry.flags});
+            if (entry.flags & kEntryDead) {
+                deadBytes += Align8(entry.length);
+            } else {
+                liveCount++;
+            }
+            pos += Align8(entry.length);
+        }
+    }
+
+    MappedFile newIndex;
+    const uint64_t indexEntries = std::max<uint64_t>(newEntries.size(), kMinIndexEntries);
+    if (!newIndex.Open(tmpIndexPath) || !newIndex.Resize(kHeaderSize + indexEntries * sizeof(IndexEntry))) {
+        SetError(newIndex.LastError());
+        newLog.Close();
+        MappedFile::RemoveFile(tmpLogPath);
+        return false;
+    }
+    IndexHeader newHeader = {};
+    memcpy(newHeader.magic, kIndexMagic, sizeof(kIndexMagic));
+    newHeader.version = kVersion;
+    newHeader.headerSize = static_cast<uint32_t>(kHeaderSize);
+    newHeader.generation = generation + 1;
+    newHeader.logCommitted = pos;
+    newHeader.count = newEntries.size();
+    newHeader.live = liveCount;
+    newHeader.deadBytes = deadBytes;
+    newHeader.nextId = header->nextId;
+    memcpy(newIndex.Data(), &newHeader, sizeof(newHeader));
+    if (!newEntries.empty()) {
+        memcpy(newIndex.Data() + kHeaderSize, newEntries.data(), newEntries.size() * sizeof(IndexEntry));
+    }
+    newLog.Sync(0, newLog.Size());
+    newIndex.Sync(0, newIndex.Size());
+    newLog.Close();
+    newIndex.Close();
+
+    // 先替换日志再替换索引：两次重命名之间崩溃时代数不一致，下次打开会从新日志重建索引
+    log_.Close();
+    index_.Close();
+    const std::string logPath = JoinPath(directory_, kLogFileName);
+    const std::string indexPath = JoinPath(directory_, kIndexFileName);
+    bool renamed = MappedFile::Rename(tmpLogPath, logPath) && MappedFile::Rename(tmpIndexPath, indexPath);
+    if (!renamed) {
+        SetError("Failed to replace history log during compaction");
+    }
+    HistoryLogStats previous = stats_;
+    bool reopened = OpenLocked();
+    stats_.compactions = previous.compactions + (renamed ? 1 : 0);
+    stats_.evicted = previous.evicted;
+    return renamed && reopened;
+}
+
+}  // namespace ztools
@@ -0,0 +1,159 @@
+// 持久化剪贴板历史日志（内存映射、只追加）
+//
+// 目录下两个文件：
+// - history.log：段文件，文件头 + 紧凑二进制记录（8 字节对齐），只追加不修改
+// - history.idx：偏移索引，文件头 + 定长索引项（每条记录 32 字节）
+//
+// 记录布局（小端）：
+//   RecordHeader（64 字节）| 格式表 [nameLen u16, reserved u16, dataLen u32, name, data]... | 填充到 8 字节
+//   校验和为记录第 16 字节之后全部内容的 XXH64，用于识别写入一半的尾部记录
+//
+// 启动：只映射两个文件并校验索引最后一项（O(1)），再扫描索引之后尚未登记的尾部记录；
+//       尾部遇到无效记录即截断（崩溃恢复）。索引与日志代数不一致或损坏时从日志重建索引。
+// 删除/覆盖：追加墓碑记录，并在索引项上标记失效；重建索引时按日志顺序重放得到相同结果。
+// 容量：设置 maxEntries/maxBytes 后，追加超出预算时为最旧的有效记录写入墓碑（与内存历史的淘汰对应），
+//       失效字节由压缩回收，日志大小因此有界。
+// 压缩：把有效记录复制到新文件后原子替换，可在后台线程进行，期间追加不受阻塞。
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "clipboard_history.h"
+#include "mapped_file.h"
+
+namespace ztools {
+
+// 一条完整的历史记录
+struct HistoryLogRecord {
+    uint64_t id = 0;          // 0 表示由日志分配
+    uint64_t hash = 0;        // 0 表示由日志计算
+    uint64_t sequence = 0;
+    uint64_t createdAtMs = 0;
+    uint64_t lastSeenAtMs = 0;
+    uint32_t copyCount = 1;
+    std::vector<ClipboardHistoryFormat> formats;
+};
+
+struct HistoryLogOptions {
+    uint64_t growBytes = 1 << 20;            // 日志文件每次至少扩展的字节数
+    bool syncOnAppend = false;               // 每次追加后 msync（防断电，代价较高）
+    bool autoCompact = true;                 // 失效字节过多时自动后台压缩
+    double compactDeadRatio = 0.5;           // 失效字节占比阈值
+    uint64_t compactMinBytes = 4 << 20;      // 日志小于该大小时不自动压缩
+    uint64_t maxEntries = 0;                 // 有效条目上限（0 表示不限制）
+    uint64_t maxBytes = 0;                   // 有效记录字节上限（按记录编码大小计，0 表示不限制）
+};
+
+struct HistoryLogStats {
+    uint64_t records;          // 索引中的记录数（含失效记录与墓碑）
+    uint64_t live;             // 有效条目数
+    uint64_t logBytes;         // 日志有效数据长度
+    uint64_t deadBytes;        // 失效记录占用的字节
+    uint64_t recoveredRecords; // 启动时从尾部补登记的记录数
+    uint64_t truncatedBytes;   // 启动时截断的无效尾部字节数
+    uint64_t compactions;      // 完成的压缩次数
+    uint64_t evicted;          // 因超出 maxEntries/maxBytes 写入墓碑的条目数
+    bool indexRebuilt;         // 本次打开是否重建了索引
+};
+
+class HistoryLog {
+public:
+    HistoryLog();
+    ~HistoryLog();
+
+    // 打开（或创建）目录下的日志；目录必须已存在
+    bool Open(const std::string& directory, const HistoryLogOptions& options = HistoryLogOptions());
+    void Close();
+    bool IsOpen() const;
+
+    // 追加一条记录，返回其 id。
+    // 与已有有效记录 id 相同或内容哈希相同时，旧记录失效，新记录继承其 createdAt 并累加 copyCount。
+    // 超出容量时淘汰最旧的记录；单条记录超过 maxBytes 时不写入，返回 0
+    uint64_t Append(const HistoryLogRecord& record);
+
+    // 修改容量（0 表示不限制），超出部分立即淘汰
+    void SetLimits(uint64_t maxEntries, uint64_t maxBytes);
+
+    bool Remove(uint64_t id);
+    bool Clear();
+
+    // 有效条目数
+    size_t Size() const;
+
+    // 按索引分页（索引 0 为最新）；只读取记录头与格式表，不复制数据
+    std::vector<ClipboardHistoryEntryInfo> Page(size_t offset, size_t count) const;
+
+    bool Read(uint64_t id, HistoryLogRecord& record) const;
+    std::shared_ptr<const std::string> ReadFormat(uint64_t id, const std::string& format) const;
+
+    // 下一个待分配的 id（内存历史据此续接 id，避免与持久化记录冲突）
+    uint64_t NextId() const;
+
+    // 同步压缩
+    bool Compact();
+    // 后台压缩（已在进行时返回 false）
+    bool CompactAsync();
+    void WaitForCompaction();
+
+    HistoryLogStats Stats() const;
+    std::string LastError() const;
+
+    static const char* kLogFileName;
+    static const char* kIndexFileName;
+
+private:
+    struct IndexEntry;
+    struct IndexHeader;
+
+    bool OpenLocked();
+    bool CreateLogLocked();
+    bool RebuildIndexLocked();
+    bool RecoverTailLocked(uint64_t from);
+    bool ValidateRecordLocked(uint64_t offset, uint64_t limit, uint32_t& length) const;
+    bool AppendIndexLocked(uint64_t offset, uint64_t id, uint64_t hash, uint32_t length, uint32_t flags);
+    void ApplyRecordLocked(uint64_t indexSlot);
+    void EnsureLookupLocked() const;
+    void MarkDeadLocked(uint64_t indexSlot);
+    bool WriteTombstoneLocked(uint64_t id);
+    void EnforceLimitsLocked();
+    uint64_t WriteRecordLocked(const HistoryLogRecord& record, uint16_t kind, uint32_t& length);
+    bool EnsureLogCapacityLocked(uint64_t needed);
+    bool EnsureIndexCapacityLocked(uint64_t entries);
+    bool ReadRecordLocked(uint64_t indexSlot, HistoryLogRecord& record, bool withData) const;
+    int64_t FindLiveLocked(uint64_t id) const;
+    void MaybeCompactLocked();
+    bool CompactImpl();
+    void SetError(const std::string& error);
+
+    IndexHeader* Header();
+    const IndexHeader* Header() const;
+    IndexEntry* Entries();
+    const IndexEntry* Entries() const;
+
+    mutable std::mutex mutex_;
+    std::string directory_;
+    HistoryLogOptions options_;
+    MappedFile log_;
+    MappedFile index_;
+    uint64_t logEnd_;  // 日志有效数据末尾
+    uint64_t evictCursor_;  // 此前的索引项均已失效（淘汰时从这里查找最旧的有效记录）
+
+    // 懒加载的查找表（首次删除/覆盖时从索引构建，不在打开时构建）
+    mutable bool lookupBuilt_;
+    mutable std::unordered_map<uint64_t, uint64_t> liveById_;
+    mutable std::unordered_map<uint64_t, uint64_t> liveByHash_;
+
+    std::thread compactThread_;
+    std::atomic<bool> compacting_;
+    HistoryLogStats stats_;
+    std::string lastError_;
+};
+
+}  // namespace ztools
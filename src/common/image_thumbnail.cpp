@@ -0,0 +1,355 @@
+#include "image_thumbnail.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "clipboard_read.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZTOOLS_THUMBNAIL_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ZTOOLS_THUMBNAIL_NEON 1
+#endif
+
+namespace ztools {
+
+namespace {
+
+const uint32_t kBitmapInfoHeaderSize = 40;
+const uint32_t kBiRgb = 0;
+const uint32_t kBiBitfields = 3;
+
+// 坐标以 1/256 像素为单位
+const uint32_t kUnit = 256;
+
+inline uint32_t LoadU32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void StoreU32(unsigned char* p, uint32_t v) {
+    p[0] = static_cast<unsigned char>(v);
+    p[1] = static_cast<unsigned char>(v >> 8);
+    p[2] = static_cast<unsigned char>(v >> 16);
+    p[3] = static_cast<unsigned char>(v >> 24);
+}
+
+// x / 255 的整数近似（x <= 255 * 255 时与四舍五入结果一致）
+inline uint32_t Div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// 一个目标像素在某一方向上覆盖的源像素：首尾两个可能只覆盖一部分，中间均为整像素
+struct Span {
+    uint32_t first;
+    uint32_t last;
+    uint32_t firstWeight;
+    uint32_t lastWeight;
+    uint32_t total;  // 覆盖长度（1/256 像素）
+};
+
+inline uint64_t Boundary(uint32_t index, uint32_t src, uint32_t dst) {
+    return static_cast<uint64_t>(index) * src * kUnit / dst;
+}
+
+std::vector<Span> BuildSpans(uint32_t src, uint32_t dst) {
+    std::vector<Span> spans(dst);
+    for (uint32_t x = 0; x < dst; x++) {
+        const uint64_t begin = Boundary(x, src, dst);
+        const uint64_t end = Boundary(x + 1, src, dst);
+        Span& span = spans[x];
+        span.first = static_cast<uint32_t>(begin / kUnit);
+        span.last = static_cast<uint32_t>((end - 1) / kUnit);
+        span.total = static_cast<uint32_t>(end - begin);
+        if (span.first == span.last) {
+            span.firstWeight = span.total;
+            span.lastWeight = 0;
+        } else {
+            span.firstWeight = kUnit - static_cast<uint32_t>(begin % kUnit);
+            span.lastWeight = static_cast<uint32_t>((end - 1) % kUnit) + 1;
+        }
+    }
+    return spans;
+}
+
+// 累加 count 个连续 BGRA 像素的各通道
+void SumPixels(const unsigned char* p, size_t count, uint32_t sum[4], bool vectorized) {
+    size_t i = 0;
+#if defined(ZTOOLS_THUMBNAIL_SSE2)
+    if (vectorized && count >= 4) {
+        // 16 位累加器的 8 个通道对应两个像素槽的 BGRA；每次最多加 2 * 255，128 次后并入 32 位
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc32 = zero;
+        while (count - i >= 4) {
+            const size_t end = i + std::min<size_t>((count - i) / 4, 128) * 4;
+            __m128i acc16 = zero;
+            for (; i < end; i += 4) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i * 4));
+                acc16 = _mm_add_epi16(acc16, _mm_add_epi16(_mm_unpacklo_epi8(v, zero), _mm_unpackhi_epi8(v, zero)));
+            }
+            acc32 = _mm_add_epi32(acc32, _mm_add_epi32(_mm_unpacklo_epi16(acc16, zero), _mm_unpackhi_epi16(acc16, zero)));
+        }
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc32);
+        for (int c = 0; c < 4; c++) sum[c] += lanes[c];
+    }
+#elif defined(ZTOOLS_THUMBNAIL_NEON)
+    if (vectorized && count >= 4) {
+        uint32x4_t acc32 = vdupq_n_u32(0);
+        while (count - i >= 4) {
+            const size_t end = i + std::min<size_t>((count - i) / 4, 128) * 4;
+            uint16x8_t acc16 = vdupq_n_u16(0);
+            for (; i < end; i += 4) {
+                const uint8x16_t v = vld1q_u8(p + i * 4);
+                acc16 = vaddw_u8(acc16, vget_low_u8(v));
+                acc16 = vaddw_u8(acc16, vget_high_u8(v));
+            }
+            acc32 = vaddw_u16(acc32, vget_low_u16(acc16));
+            acc32 = vaddw_u16(acc32, vget_high_u16(acc16));
+        }
+        uint32_t lanes[4];
+        vst1q_u32(lanes, acc32);
+        for (int c = 0; c < 4; c++) sum[c] += lanes[c];
+    }
+#else
+    (void)vectorized;
+#endif
+    for (; i < count; i++) {
+        for (int c = 0; c < 4; c++) sum[c] += p[i * 4 + c];
+    }
+}
+
+// 横向缩放一行：结果为 8.8 定点（0..65280），每个目标像素 4 个通道
+void ScaleRow(const unsigned char* row, const std::vector<Span>& spans, uint16_t* out, bool vectorized) {
+    for (size_t x = 0; x < spans.size(); x++) {
+        const Span& span = spans[x];
+        const unsigned char* first = row + static_cast<size_t>(span.first) * 4;
+        uint64_t acc[4];
+        for (int c = 0; c < 4; c++) acc[c] = static_cast<uint64_t>(first[c]) * span.firstWeight;
+        if (span.last > span.first) {
+            const unsigned char* last = row + static_cast<size_t>(span.last) * 4;
+            uint32_t inner[4] = {0, 0, 0, 0};
+            SumPixels(first + 4, span.last - span.first - 1, inner, vectorized);
+            for (int c = 0; c < 4; c++) {
+                acc[c] += static_cast<uint64_t>(inner[c]) * kUnit + static_cast<uint64_t>(last[c]) * span.lastWeight;
+            }
+        }
+        for (int c = 0; c < 4; c++) {
+            out[x * 4 + c] = static_cast<uint16_t>((acc[c] * 256 + span.total / 2) / span.total);
+        }
+    }
+}
+
+// 逐行读取源图像并缩放；fetchRow(y) 返回第 y 行（自上而下）预乘或不透明的 BGRA 像素
+template <typename FetchRow>
+void Downscale(uint32_t width, uint32_t height, uint32_t dstWidth, uint32_t dstHeight, bool opaque,
+               bool vectorized, FetchRow&& fetchRow, ThumbnailImage& out) {
+    const std::vector<Span> columns = BuildSpans(width, dstWidth);
+    std::vector<uint16_t> scaled(static_cast<size_t>(dstWidth) * 4);
+    std::vector<uint64_t> acc(static_cast<size_t>(dstWidth) * 4, 0);
+
+    out.width = dstWidth;
+    out.height = dstHeight;
+    out.pixels.assign(static_cast<size_t>(dstWidth) * dstHeight * 4, '\0');
+
+    uint32_t y = 0;
+    uint64_t rowBegin = 0;
+    uint64_t rowEnd = Boundary(1, height, dstHeight);
+    for (uint32_t sy = 0; sy < height && y < dstHeight; sy++) {
+        ScaleRow(fetchRow(sy), columns, scaled.data(), vectorized);
+        const uint64_t lo = static_cast<uint64_t>(sy) * kUnit;
+        const uint64_t hi = lo + kUnit;
+        // 源行可能跨越两个目标行：先补足当前目标行，剩余部分计入下一行
+        while (y < dstHeight) {
+            const uint64_t weight = std::min(hi, rowEnd) - std::max(lo, rowBegin);
+            for (size_t i = 0; i < acc.size(); i++) acc[i] += scaled[i] * weight;
+            if (rowEnd > hi) {
+                break;
+            }
+            const uint64_t total = (rowEnd - rowBegin) * 256;
+            unsigned char* dst = reinterpret_cast<unsigned char*>(&out.pixels[static_cast<size_t>(y) * dstWidth * 4]);
+            for (size_t i = 0; i < acc.size(); i++) {
+                dst[i] = static_cast<unsigned char>((acc[i] + total / 2) / total);
+                acc[i] = 0;
+            }
+            if (opaque) {
+                for (uint32_t x = 0; x < dstWidth; x++) dst[x * 4 + 3] = 255;
+            }
+            y++;
+            rowBegin = rowEnd;
+            rowEnd = Boundary(y + 1, height, dstHeight);
+            if (rowBegin == hi) {
+                break;
+            }
+        }
+    }
+}
+
+void ThumbnailSize(uint32_t width, uint32_t height, uint32_t maxSize, uint32_t* dstWidth, uint32_t* dstHeight) {
+    const uint32_t longest = std::max(width, height);
+    if (longest <= maxSize) {
+        *dstWidth = width;
+        *dstHeight = height;
+        return;
+    }
+    *dstWidth = std::max<uint32_t>(1, static_cast<uint32_t>((static_cast<uint64_t>(width) * maxSize + longest / 2) / longest));
+    *dstHeight = std::max<uint32_t>(1, static_cast<uint32_t>((static_cast<uint64_t>(height) * maxSize + longest / 2) / longest));
+}
+
+// 非预乘 -> 预乘；向量化路径与逐像素路径结果一致（同一个除以 255 的近似）
+void PremultiplyRow(const unsigned char* src, uint32_t width, unsigned char* dst, bool vectorized) {
+    uint32_t x = 0;
+#if defined(ZTOOLS_THUMBNAIL_SSE2)
+    if (vectorized) {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i half = _mm_set1_epi16(128);
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; x + 4 <= width; x += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 4));
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+            // 每个像素的 alpha 复制到 4 个通道
+            const __m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF);
+            const __m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF);
+            lo = _mm_add_epi16(_mm_mullo_epi16(lo, alphaLo), half);
+            hi = _mm_add_epi16(_mm_mullo_epi16(hi, alphaHi), half);
+            lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+            const __m128i packed = _mm_packus_epi16(lo, hi);
+            const __m128i result = _mm_or_si128(_mm_andnot_si128(alphaMask, packed), _mm_and_si128(alphaMask, v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), result);
+        }
+    }
+#elif defined(ZTOOLS_THUMBNAIL_NEON)
+    if (vectorized) {
+        for (; x + 8 <= width; x += 8) {
+            uint8x8x4_t v = vld4_u8(src + x * 4);  // 按通道拆分 8 个像素
+            for (int c = 0; c < 3; c++) {
+                const uint16x8_t product = vmull_u8(v.val[c], v.val[3]);
+                v.val[c] = vraddhn_u16(product, vrshrq_n_u16(product, 8));
+            }
+            vst4_u8(dst + x * 4, v);
+        }
+    }
+#else
+    (void)vectorized;
+#endif
+    for (; x < width; x++) {
+        const unsigned char* s = src + x * 4;
+        unsigned char* d = dst + x * 4;
+        const uint32_t a = s[3];
+        d[0] = static_cast<unsigned char>(Div255(s[0] * a));
+        d[1] = static_cast<unsigned char>(Div255(s[1] * a));
+        d[2] = static_cast<unsigned char>(Div255(s[2] * a));
+        d[3] = static_cast<unsigned char>(a);
+    }
+}
+
+}  // namespace
+
+bool DownscaleBgra(const unsigned char* firstRow, uint32_t width, uint32_t height, ptrdiff_t stride, BgraAlpha alpha,
+                   const ThumbnailOptions& options, ThumbnailImage& out) {
+    if (firstRow == nullptr || width == 0 || height == 0 || options.maxSize == 0) {
+        return false;
+    }
+    uint32_t dstWidth, dstHeight;
+    ThumbnailSize(width, height, options.maxSize, &dstWidth, &dstHeight);
+
+    if (alpha == BgraAlpha::Straight) {
+        std::vector<unsigned char> scratch(static_cast<size_t>(width) * 4);
+        Downscale(width, height, dstWidth, dstHeight, false, options.vectorized, [&](uint32_t y) {
+            PremultiplyRow(firstRow + static_cast<ptrdiff_t>(y) * stride, width, scratch.data(), options.vectorized);
+            return static_cast<const unsigned char*>(scratch.data());
+        }, out);
+    } else {
+        Downscale(width, height, dstWidth, dstHeight, alpha == BgraAlpha::Ignore, options.vectorized,
+                  [&](uint32_t y) { return firstRow + static_cast<ptrdiff_t>(y) * stride; }, out);
+    }
+    return true;
+}
+
+bool ThumbnailFromDib(const void* dib, size_t size, const ThumbnailOptions& options, ThumbnailImage& out) {
+    size_t pixelOffset = 0;
+    if (!DibPixelOffset(dib, size, &pixelOffset) || options.maxSize == 0) {
+        return false;
+    }
+    const unsigned char* p = static_cast<const unsigned char*>(dib);
+    const uint32_t headerSize = LoadU32(p);
+    const int32_t width = static_cast<int32_t>(LoadU32(p + 4));
+    const int32_t height = static_cast<int32_t>(LoadU32(p + 8));
+    const uint16_t bitCount = static_cast<uint16_t>(p[14] | (p[15] << 8));
+    const uint32_t compression = LoadU32(p + 16);
+
+    BgraAlpha alpha = BgraAlpha::Ignore;
+    if (bitCount == 32 && compression == kBiBitfields) {
+        // 位掩码紧跟 BITMAPINFOHEADER，或位于 V2 及之后的头部内（同一偏移）
+        if (headerSize != kBitmapInfoHeaderSize && headerSize < kBitmapInfoHeaderSize + 12) {
+            return false;
+        }
+        const unsigned char* masks = p + kBitmapInfoHeaderSize;
+        if (LoadU32(masks) != 0x00FF0000 || LoadU32(masks + 4) != 0x0000FF00 || LoadU32(masks + 8) != 0x000000FF) {
+            return false;
+        }
+        // V4/V5 头部声明了 alpha 掩码时 alpha 有效（非预乘）
+        if (headerSize >= kBitmapInfoHeaderSize + 16 && LoadU32(masks + 12) == 0xFF000000) {
+            alpha = BgraAlpha::Straight;
+        }
+    } else if (!((bitCount == 32 || bitCount == 24) && compression == kBiRgb)) {
+        return false;
+    }
+
+    const uint32_t w = static_cast<uint32_t>(width);
+    const uint32_t h = height < 0 ? static_cast<uint32_t>(-static_cast<int64_t>(height)) : static_cast<uint32_t>(height);
+    const size_t stride = ((static_cast<size_t>(w) * bitCount + 31) / 32) * 4;
+    const unsigned char* pixels = p + pixelOffset;
+    // 正高度为自下而上
+    const unsigned char* firstRow = height < 0 ? pixels : pixels + (h - 1) * stride;
+    const ptrdiff_t rowStep = height < 0 ? static_cast<ptrdiff_t>(stride) : -static_cast<ptrdiff_t>(stride);
+
+    if (bitCount == 32) {
+        return DownscaleBgra(firstRow, w, h, rowStep, alpha, options, out);
+    }
+
+    // 24 位：逐行展开为 BGRA 后缩放
+    uint32_t dstWidth, dstHeight;
+    ThumbnailSize(w, h, options.maxSize, &dstWidth, &dstHeight);
+    std::vector<unsigned char> scratch(static_cast<size_t>(w) * 4, 255);
+    Downscale(w, h, dstWidth, dstHeight, true, options.vectorized, [&](uint32_t y) {
+        const unsigned char* row = firstRow + static_cast<ptrdiff_t>(y) * rowStep;
+        for (uint32_t x = 0; x < w; x++) {
+            memcpy(&scratch[x * 4], row + x * 3, 3);
+        }
+        return static_cast<const unsigned char*>(scratch.data());
+    }, out);
+    return true;
+}
+
+std::string SerializeThumbnail(const ThumbnailImage& image) {
+    std::string data(8, '\0');
+    StoreU32(reinterpret_cast<unsigned char*>(&data[0]), image.width);
+    StoreU32(reinterpret_cast<unsigned char*>(&data[4]), image.height);
+    data += image.pixels;
+    return data;
+}
+
+bool ParseThumbnail(const std::string& data, ThumbnailImage& out) {
+    if (data.size() < 8) {
+        return false;
+    }
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    const uint32_t width = LoadU32(p);
+    const uint32_t height = LoadU32(p + 4);
+    if (static_cast<uint64_t>(width) * height * 4 != data.size() - 8) {
+        return false;
+    }
+    out.width = width;
+    out.height = height;
+    out.pixels.assign(data, 8, std::string::npos);
+    return true;
+}
+
+}  // namespace ztools
@@ -0,0 +1,49 @@
+// 剪贴板图片缩略图（平台无关）
+//
+// 历史界面只显示约 96 px 的预览，以往只能取回完整的 base64 PNG 再在渲染进程解码缩放。
+// 监控线程关闭剪贴板后直接从 CF_DIB 生成预乘 BGRA 缩略图，作为 "thumbnail" 格式与条目一起保存。
+//
+// 缩放为面积平均：每个目标像素取其覆盖的源像素按覆盖面积加权的平均（先预乘再平均，
+// 透明边缘不会发黑）。横向在每个源行内累加，整像素部分每次处理 4 个像素（SSE2 / NEON，
+// 其他平台逐像素）；纵向只保留一行累加器，源图逐行读取一次。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ztools {
+
+static const uint32_t kDefaultThumbnailSize = 96;
+
+struct ThumbnailOptions {
+    uint32_t maxSize = kDefaultThumbnailSize;  // 长边上限（不放大）
+    bool vectorized = true;                    // false 时逐像素累加（用于测试与基准对比）
+};
+
+// 源像素 alpha 的含义
+enum class BgraAlpha {
+    Straight,       // 非预乘，缩放前先预乘
+    Premultiplied,  // 已预乘
+    Ignore,         // 无意义（如 32 位 BI_RGB 位图的保留字节），结果视为不透明
+};
+
+struct ThumbnailImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::string pixels;  // 预乘 BGRA，自上而下，每行 width * 4 字节
+};
+
+// 缩放 32 位 BGRA 图像；firstRow 为显示时的第一行，自下而上的位图传入最后一行的地址和负的 stride
+bool DownscaleBgra(const unsigned char* firstRow, uint32_t width, uint32_t height, ptrdiff_t stride, BgraAlpha alpha,
+                   const ThumbnailOptions& options, ThumbnailImage& out);
+
+// 从打包 DIB（CF_DIB / CF_DIBV5）生成缩略图；支持 24 位与 32 位（BI_RGB / BI_BITFIELDS 标准掩码），
+// 其他格式（调色板、16 位、压缩）返回 false
+bool ThumbnailFromDib(const void* dib, size_t size, const ThumbnailOptions& options, ThumbnailImage& out);
+
+// 历史中 "thumbnail" 格式的存储：8 字节头（宽、高，小端 uint32）+ 像素
+std::string SerializeThumbnail(const ThumbnailImage& image);
+bool ParseThumbnail(const std::string& data, ThumbnailImage& out);
+
+}  // namespace ztools
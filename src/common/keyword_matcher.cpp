@@ -0,0 +1,211 @@
+#include "keyword_matcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+#include "utf_transcode.h"
+
+namespace ztools {
+
+namespace {
+
+// 与 iswspace 一致的 Unicode 空白
+inline bool IsSpace(char16_t ch) {
+    if (ch < 0x80) {
+        return ch == 0x20 || (ch >= 0x09 && ch <= 0x0D);
+    }
+    return ch == 0x85 || ch == 0xA0 || ch == 0x1680 || (ch >= 0x2000 && ch <= 0x200A) ||
+           ch == 0x2028 || ch == 0x2029 || ch == 0x202F || ch == 0x205F || ch == 0x3000;
+}
+
+}  // namespace
+
+char16_t FoldKeywordCase(char16_t ch) {
+    if (ch < 0x80) {
+        return ch >= u'A' && ch <= u'Z' ? static_cast<char16_t>(ch + 32) : ch;
+    }
+    if ((ch >= 0xC0 && ch <= 0xDE && ch != 0xD7) ||   // Latin-1 大写（不含 ×）
+        (ch >= 0x391 && ch <= 0x3A9 && ch != 0x3A2) ||  // 希腊大写
+        (ch >= 0x410 && ch <= 0x42F)) {                 // 西里尔 А-Я
+        return static_cast<char16_t>(ch + 32);
+    }
+    if (ch >= 0x400 && ch <= 0x40F) {                   // 西里尔 Ѐ-Џ
+        return static_cast<char16_t>(ch + 80);
+    }
+    if (ch >= 0x386 && ch <= 0x38F) {                   // 希腊带重音大写
+        switch (ch) {
+            case 0x386: return 0x3AC;
+            case 0x388: case 0x389: case 0x38A: return static_cast<char16_t>(ch + 37);
+            case 0x38C: return 0x3CC;
+            case 0x38E: case 0x38F: return static_cast<char16_t>(ch + 63);
+        }
+    }
+    return ch;
+}
+
+KeywordMatcher::KeywordMatcher(KeywordMatchMode mode) : mode_(mode), asciiClass_() {
+    Build();
+}
+
+KeywordMatcher::KeywordMatcher(KeywordMatchMode mode, std::initializer_list<const char*> keywords)
+    : mode_(mode), asciiClass_() {
+    for (const char* keyword : keywords) {
+        Add(keyword, strlen(keyword));
+    }
+    Build();
+}
+
+bool KeywordMatcher::Add(const char* utf8, size_t size) {
+    std::u16string keyword = Utf8ToUtf16(utf8, size);
+    if (keyword.empty()) {
+        return false;
+    }
+    for (char16_t& ch : keyword) {
+        ch = FoldKeywordCase(ch);
+    }
+    if (std::find(keywords_.begin(), keywords_.end(), keyword) != keywords_.end()) {
+        return false;
+    }
+    keywords_.push_back(std::move(keyword));
+    return true;
+}
+
+void KeywordMatcher::Build() {
+    // 字符类别：只区分关键字中出现过的字符，其余字符统一为类别 0
+    memset(asciiClass_, 0, sizeof(asciiClass_));
+    wideClass_.clear();
+    std::vector<char16_t> alphabet;
+    for (const auto& keyword : keywords_) {
+        alphabet.insert(alphabet.end(), keyword.begin(), keyword.end());
+    }
+    std::sort(alphabet.begin(), alphabet.end());
+    alphabet.erase(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+    classCount_ = 1;
+    for (char16_t ch : alphabet) {
+        if (ch < 0x80) {
+            asciiClass_[ch] = classCount_++;
+        } else {
+            wideClass_.emplace_back(ch, classCount_++);
+        }
+    }
+
+    // 字典树
+    std::vector<std::map<uint32_t, uint32_t>> children(1);
+    std::vector<uint8_t> terminal(1, 0);
+    depth_.assign(1, 0);
+    for (const auto& keyword : keywords_) {
+        uint32_t state = 0;
+        for (char16_t ch : keyword) {
+            const uint32_t cls = ClassOf(ch);
+            auto it = children[state].find(cls);
+            if (it != children[state].end()) {
+                state = it->second;
+                continue;
+            }
+            const uint32_t created = static_cast<uint32_t>(depth_.size());
+            children[state][cls] = created;
+            children.emplace_back();
+            terminal.push_back(0);
+            depth_.push_back(depth_[state] + 1);
+            state = created;
+        }
+        terminal[state] = 1;
+    }
+
+    // 按广度优先计算失败链接并确定化：缺失的转移取失败状态的转移
+    const size_t states = depth_.size();
+    next_.assign(states * classCount_, 0);
+    accept_ = terminal;
+    std::vector<uint32_t> fail(states, 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(states);
+    queue.push_back(0);
+    for (size_t head = 0; head < queue.size(); head++) {
+        const uint32_t state = queue[head];
+        uint32_t* row = &next_[state * classCount_];
+        const uint32_t* failRow = &next_[fail[state] * classCount_];
+        for (uint32_t cls = 0; cls < classCount_; cls++) {
+            row[cls] = state == 0 ? 0 : failRow[cls];
+        }
+        for (const auto& edge : children[state]) {
+            const uint32_t child = edge.second;
+            fail[child] = state == 0 ? 0 : failRow[edge.first];
+            // 子串模式下，后缀是关键字的状态同样命中
+            if (mode_ == KeywordMatchMode::Substring && accept_[fail[child]]) {
+                accept_[child] = 1;
+            }
+            row[edge.first] = child;
+            queue.push_back(child);
+        }
+    }
+}
+
+uint32_t KeywordMatcher::ClassOf(char16_t folded) const {
+    if (folded < 0x80) {
+        return asciiClass_[folded];
+    }
+    auto it = std::lower_bound(wideClass_.begin(), wideClass_.end(), folded,
+                               [](const std::pair<char16_t, uint32_t>& entry, char16_t ch) {
+                                   return entry.first < ch;
+                               });
+    return it != wideClass_.end() && it->first == folded ? it->second : 0;
+}
+
+bool KeywordMatcher::Matches(const char16_t* text, size_t length) const {
+    if (keywords_.empty() || text == nullptr) {
+        return false;
+    }
+    const uint32_t* next = next_.data();
+    const uint32_t classes = classCount_;
+    uint32_t state = 0;
+    size_t i = 0;
+
+    if (mode_ == KeywordMatchMode::Prefix) {
+        while (i < length && IsSpace(text[i])) {
+            i++;
+        }
+        // 只沿字典树前进：深度不增加说明走了失败转移，即前缀已不可能匹配
+        for (; i < length; i++) {
+            const uint32_t target = next[state * classes + ClassOf(FoldKeywordCase(text[i]))];
+            if (depth_[target] != depth_[state] + 1) {
+                return false;
+            }
+            state = target;
+            if (accept_[state]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    for (; i < length; i++) {
+        state = next[state * classes + ClassOf(FoldKeywordCase(text[i]))];
+        if (accept_[state]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+KeywordMatcher MakeBrowserUrlPrefixMatcher() {
+    return KeywordMatcher(KeywordMatchMode::Prefix, {
+        "http://", "https://", "file:///", "about:", "chrome://",
+        "edge://", "brave://", "opera://", "vivaldi://",
+        "moz-extension://", "ftp://",
+    });
+}
+
+KeywordMatcher MakeBrowserAddressBarNameMatcher() {
+    return KeywordMatcher(KeywordMatchMode::Substring, {
+        "address and search bar",
+        "search or enter address",
+        "address bar",
+        "search with google or enter address",
+        "地址和搜索栏",
+        "地址栏",
+        "输入搜索词或网址",
+    });
+}
+
+}  // namespace ztools
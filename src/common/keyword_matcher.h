@@ -0,0 +1,73 @@
+// 多关键字匹配（平台无关，Windows 浏览器地址栏识别使用）
+//
+// 读取浏览器 URL 时 UI Automation 最多遍历 600 个节点，每个节点的名称和值都要判断
+// "是否像地址栏" / "是否像 URL"。原先每次都复制、去空白、转小写，再逐个关键字 find。
+// 这里把关键字预先编译成 Aho-Corasick 自动机（确定化为稠密转移表）：匹配时逐码元
+// 折叠大小写、查字符类别、查转移表，单遍完成且不分配内存。
+//
+// 大小写折叠覆盖 ASCII、Latin-1、希腊字母和西里尔字母的大写区（其他字符原样比较，
+// 中日韩文字无大小写），足以覆盖地址栏名称的各语言本地化。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ztools {
+
+enum class KeywordMatchMode {
+    Substring,  // 文本任意位置包含某个关键字
+    Prefix,     // 跳过开头空白后以某个关键字开头
+};
+
+class KeywordMatcher {
+public:
+    explicit KeywordMatcher(KeywordMatchMode mode = KeywordMatchMode::Substring);
+    KeywordMatcher(KeywordMatchMode mode, std::initializer_list<const char*> keywords);
+
+    // 添加 UTF-8 关键字；空串或（折叠大小写后）重复的关键字忽略，返回是否新增。
+    // 添加后须调用 Build 才会参与匹配。
+    bool Add(const char* utf8, size_t size);
+    bool Add(const std::string& utf8) { return Add(utf8.data(), utf8.size()); }
+
+    // 由当前关键字重建自动机
+    void Build();
+
+    bool Matches(const char16_t* text, size_t length) const;
+    bool Matches(const std::u16string& text) const { return Matches(text.data(), text.size()); }
+#ifdef _WIN32
+    bool Matches(const std::wstring& text) const {
+        return Matches(reinterpret_cast<const char16_t*>(text.data()), text.size());
+    }
+#endif
+
+    KeywordMatchMode Mode() const { return mode_; }
+    // 已折叠大小写的关键字（按添加顺序）
+    const std::vector<std::u16string>& Keywords() const { return keywords_; }
+    size_t StateCount() const { return depth_.size(); }
+
+private:
+    uint32_t ClassOf(char16_t folded) const;
+
+    KeywordMatchMode mode_;
+    std::vector<std::u16string> keywords_;
+
+    uint32_t asciiClass_[128];                       // ASCII 字符 → 字符类别（0 为不出现在关键字中的字符）
+    std::vector<std::pair<char16_t, uint32_t>> wideClass_;  // 非 ASCII 字符 → 字符类别，按字符排序
+    uint32_t classCount_ = 1;
+    std::vector<uint32_t> next_;    // 状态 × 字符类别 → 下一状态
+    std::vector<uint32_t> depth_;   // 状态对应的前缀长度
+    std::vector<uint8_t> accept_;   // 到达该状态即命中
+};
+
+// 大小写折叠（见文件头说明）
+char16_t FoldKeywordCase(char16_t ch);
+
+// 浏览器地址栏识别的默认关键字：URL 前缀（http://、chrome:// 等）与地址栏控件名称
+KeywordMatcher MakeBrowserUrlPrefixMatcher();
+KeywordMatcher MakeBrowserAddressBarNameMatcher();
+
+}  // namespace ztools
@@ -0,0 +1,276 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+#include "utf_transcode.h"
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#endif
+
+namespace ztools {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : file_(INVALID_HANDLE_VALUE), mapping_(NULL), data_(nullptr), size_(0) {}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+void MappedFile::SetError(const std::string& what) {
+    lastError_ = what + " (error " + std::to_string(GetLastError()) + ")";
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+    HANDLE file = CreateFileW(Utf8ToWide(path).c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        SetError("CreateFileW failed: " + path);
+        return false;
+    }
+    file_ = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        SetError("GetFileSizeEx failed");
+        Close();
+        return false;
+    }
+    size_ = static_cast<uint64_t>(size.QuadPart);
+    if (!Map()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::Map() {
+    if (size_ == 0) {
+        return true;  // 空文件无法映射
+    }
+    HANDLE mapping = CreateFileMappingW(static_cast<HANDLE>(file_), NULL, PAGE_READWRITE,
+                                        static_cast<DWORD>(size_ >> 32), static_cast<DWORD>(size_), NULL);
+    if (mapping == NULL) {
+        SetError("CreateFileMappingW failed");
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, static_cast<SIZE_T>(size_));
+    if (view == NULL) {
+        SetError("MapViewOfFile failed");
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_ = mapping;
+    data_ = static_cast<char*>(view);
+    return true;
+}
+
+void MappedFile::Unmap() {
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+    }
+    if (mapping_ != NULL) {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+        mapping_ = NULL;
+    }
+}
+
+void MappedFile::Close() {
+    Unmap();
+    if (file_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(static_cast<HANDLE>(file_));
+        file_ = INVALID_HANDLE_VALUE;
+    }
+    size_ = 0;
+}
+
+bool MappedFile::IsOpen() const {
+    return file_ != INVALID_HANDLE_VALUE;
+}
+
+bool MappedFile::Resize(uint64_t size) {
+    if (!IsOpen()) return false;
+    Unmap();
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(static_cast<HANDLE>(file_), position, NULL, FILE_BEGIN) ||
+        !SetEndOfFile(static_cast<HANDLE>(file_))) {
+        SetError("SetEndOfFile failed");
+        Map();
+        return false;
+    }
+    size_ = size;
+    return Map();
+}
+
+bool MappedFile::Sync(uint64_t offset, uint64_t length) {
+    if (data_ == nullptr || length == 0) return true;
+    if (!FlushViewOfFile(data_ + offset, static_cast<SIZE_T>(length))) {
+        SetError("FlushViewOfFile failed");
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::ReadAt(uint64_t offset, void* buffer, size_t length) const {
+    char* out = static_cast<char*>(buffer);
+    while (length > 0) {
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD chunk = length > 0x40000000 ? 0x40000000 : static_cast<DWORD>(length);
+        DWORD read = 0;
+        if (!ReadFile(static_cast<HANDLE>(file_), out, chunk, &read, &overlapped) || read == 0) {
+            return false;
+        }
+        out += read;
+        offset += read;
+        length -= read;
+    }
+    return true;
+}
+
+bool MappedFile::Exists(const std::string& path) {
+    return GetFileAttributesW(Utf8ToWide(path).c_str()) != INVALID_FILE_ATTRIBUTES;
+}
+
+bool MappedFile::RemoveFile(const std::string& path) {
+    return DeleteFileW(Utf8ToWide(path).c_str()) != 0;
+}
+
+bool MappedFile::Rename(const std::string& from, const std::string& to) {
+    return MoveFileExW(Utf8ToWide(from).c_str(), Utf8ToWide(to).c_str(),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+#else  // POSIX
+
+MappedFile::MappedFile() : fd_(-1), data_(nullptr), size_(0) {}
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+void MappedFile::SetError(const std::string& what) {
+    lastError_ = what + ": " + strerror(errno);
+}
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        SetError("open failed: " + path);
+        return false;
+    }
+    fd_ = fd;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        SetError("fstat failed");
+        Close();
+        return false;
+    }
+    size_ = static_cast<uint64_t>(st.st_size);
+    if (!Map()) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::Map() {
+    if (size_ == 0) {
+        return true;  // 空文件无法映射
+    }
+    void* addr = mmap(nullptr, static_cast<size_t>(size_), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        SetError("mmap failed");
+        return false;
+    }
+    data_ = static_cast<char*>(addr);
+    return true;
+}
+
+void MappedFile::Unmap() {
+    if (data_ != nullptr) {
+        munmap(data_, static_cast<size_t>(size_));
+        data_ = nullptr;
+    }
+}
+
+void MappedFile::Close() {
+    Unmap();
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+}
+
+bool MappedFile::IsOpen() const {
+    return fd_ >= 0;
+}
+
+bool MappedFile::Resize(uint64_t size) {
+    if (!IsOpen()) return false;
+    Unmap();
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        SetError("ftruncate failed");
+        Map();
+        return false;
+    }
+    size_ = size;
+    return Map();
+}
+
+bool MappedFile::Sync(uint64_t offset, uint64_t length) {
+    if (data_ == nullptr || length == 0) return true;
+    // msync 要求起始地址按页对齐
+    const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t start = offset / page * page;
+    if (msync(data_ + start, static_cast<size_t>(offset + length - start), MS_SYNC) != 0) {
+        SetError("msync failed");
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::ReadAt(uint64_t offset, void* buffer, size_t length) const {
+    char* out = static_cast<char*>(buffer);
+    while (length > 0) {
+        ssize_t n = pread(fd_, out, length, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        out += n;
+        offset += static_cast<uint64_t>(n);
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool MappedFile::Exists(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+bool MappedFile::RemoveFile(const std::string& path) {
+    return unlink(path.c_str()) == 0;
+}
+
+bool MappedFile::Rename(const std::string& from, const std::string& to) {
+    return rename(from.c_str(), to.c_str()) == 0;
+}
+
+#endif
+
+}  // namespace ztools
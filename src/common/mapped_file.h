@@ -0,0 +1,63 @@
+// 可读写的内存映射文件（POSIX mmap / Win32 文件映射）
+//
+// 文件大小即映射大小：Resize 会调整文件长度并重新映射，之前取得的 Data() 指针随之失效。
+// ReadAt 通过文件句柄读取，不依赖映射，可在其他线程重新映射期间安全使用。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ztools {
+
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 以读写方式打开（不存在时创建）并映射整个文件
+    bool Open(const std::string& path);
+    void Close();
+    bool IsOpen() const;
+
+    uint64_t Size() const { return size_; }
+    char* Data() { return data_; }
+    const char* Data() const { return data_; }
+
+    // 调整文件大小并重新映射（新增部分填 0）
+    bool Resize(uint64_t size);
+
+    // 把映射区间写回磁盘
+    bool Sync(uint64_t offset, uint64_t length);
+
+    // 通过文件句柄读取（不经过映射）
+    bool ReadAt(uint64_t offset, void* buffer, size_t length) const;
+
+    const std::string& LastError() const { return lastError_; }
+
+    // 文件系统辅助函数（路径均为 UTF-8）
+    static bool Exists(const std::string& path);
+    static bool RemoveFile(const std::string& path);
+    // 原子替换：to 已存在时直接覆盖
+    static bool Rename(const std::string& from, const std::string& to);
+
+private:
+    bool Map();
+    void Unmap();
+    void SetError(const std::string& what);
+
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#else
+    int fd_;
+#endif
+    char* data_;
+    uint64_t size_;
+    std::string lastError_;
+};
+
+}  // namespace ztools
@@ -0,0 +1,176 @@
+#include "native_event.h"
+
+#include <cstring>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "NativeEvent ABI assumes a little-endian host"
+#endif
+
+namespace ztools {
+
+NativeString NativeEventWriter::AddString(const char* data, size_t size) {
+    NativeString ref{static_cast<uint32_t>(strings_.size()), static_cast<uint32_t>(size)};
+    strings_.append(data, size);
+    return ref;
+}
+
+std::string NativeEventWriter::Finish(NativeEventKind kind, const void* record, size_t recordSize) {
+    NativeEventHeader header;
+    header.magic = kNativeEventMagic;
+    header.version = kNativeEventVersion;
+    header.kind = static_cast<uint16_t>(kind);
+    header.recordSize = static_cast<uint32_t>(recordSize);
+    header.stringsSize = static_cast<uint32_t>(strings_.size());
+
+    std::string out;
+    out.reserve(sizeof(header) + recordSize + strings_.size());
+    out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.append(static_cast<const char*>(record), recordSize);
+    out += strings_;
+    strings_.clear();
+    return out;
+}
+
+bool NativeEventReader::Open(const void* data, size_t size) {
+    record_ = nullptr;
+    recordSize_ = 0;
+    strings_ = nullptr;
+    stringsSize_ = 0;
+    if (data == nullptr || size < sizeof(NativeEventHeader)) {
+        return false;
+    }
+    NativeEventHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != kNativeEventMagic || header.version != kNativeEventVersion) {
+        return false;
+    }
+    const uint64_t total = sizeof(header) + static_cast<uint64_t>(header.recordSize) + header.stringsSize;
+    if (total != size) {
+        return false;
+    }
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    kind_ = static_cast<NativeEventKind>(header.kind);
+    record_ = bytes + sizeof(header);
+    recordSize_ = header.recordSize;
+    strings_ = reinterpret_cast<const char*>(record_ + recordSize_);
+    stringsSize_ = header.stringsSize;
+    return true;
+}
+
+bool NativeEventReader::ReadRecord(NativeEventKind kind, void* record, size_t size, size_t stringsBegin) const {
+    if (record_ == nullptr || kind_ != kind) {
+        return false;
+    }
+    const size_t copied = recordSize_ < size ? recordSize_ : size;
+    char* out = static_cast<char*>(record);
+    memcpy(out, record_, copied);
+    memset(out + copied, 0, size - copied);
+    // 未完整复制的字符串字段视为缺失，而不是 {0, 0} 空串
+    const NativeString absent{kNativeStringAbsent, 0};
+    for (size_t at = stringsBegin; at + sizeof(NativeString) <= size; at += sizeof(NativeString)) {
+        if (at + sizeof(NativeString) > copied) {
+            memcpy(out + at, &absent, sizeof(absent));
+        }
+    }
+    return true;
+}
+
+bool NativeEventReader::String(const NativeString& ref, const char** data, size_t* size) const {
+    if (ref.offset == kNativeStringAbsent || ref.offset > stringsSize_ || ref.length > stringsSize_ - ref.offset) {
+        return false;
+    }
+    *data = strings_ + ref.offset;
+    *size = ref.length;
+    return true;
+}
+
+namespace {
+
+// 必有字段：引用非法视为数据损坏
+bool VisitString(const NativeEventReader& reader, const char* name, const NativeString& ref,
+                 NativeEventFieldVisitor& visitor) {
+    const char* data;
+    size_t size;
+    if (!reader.String(ref, &data, &size)) {
+        return false;
+    }
+    visitor.String(name, data, size);
+    return true;
+}
+
+// 可缺失字段：缺失时不产生属性（与原 JSON 省略该键一致）
+bool VisitOptionalString(const NativeEventReader& reader, const char* name, const NativeString& ref,
+                         NativeEventFieldVisitor& visitor) {
+    if (ref.offset == kNativeStringAbsent) {
+        return true;
+    }
+    return VisitString(reader, name, ref, visitor);
+}
+
+bool VisitWindow(const NativeEventReader& reader, NativeEventFieldVisitor& visitor) {
+    WindowEventRecord record;
+    if (!reader.Read(record)) {
+        return false;
+    }
+    if (!VisitString(reader, "appName", record.appName, visitor) ||
+        !VisitString(reader, "bundleId", record.bundleId, visitor) ||
+        !VisitString(reader, "title", record.title, visitor) ||
+        !VisitString(reader, "app", record.app, visitor)) {
+        return false;
+    }
+    visitor.Number("x", record.x);
+    visitor.Number("y", record.y);
+    visitor.Number("width", record.width);
+    visitor.Number("height", record.height);
+    if (!VisitString(reader, "appPath", record.appPath, visitor)) {
+        return false;
+    }
+    visitor.Number("pid", record.pid);
+    visitor.Number("windowId", record.windowId);
+    if (!VisitString(reader, "axRole", record.axRole, visitor) ||
+        !VisitString(reader, "axSubrole", record.axSubrole, visitor)) {
+        return false;
+    }
+    visitor.Boolean("preciseTarget", (record.flags & kWindowEventPreciseTarget) != 0);
+    if (record.flags & kWindowEventHasFinderId) {
+        visitor.Number("finderId", static_cast<double>(record.finderId));
+    }
+    return VisitOptionalString(reader, "path", record.path, visitor) &&
+           VisitOptionalString(reader, "url", record.url, visitor) &&
+           VisitOptionalString(reader, "kind", record.kind, visitor);
+}
+
+bool VisitMouse(const NativeEventReader& reader, NativeEventFieldVisitor& visitor) {
+    MouseEventRecord record;
+    return reader.Read(record) && VisitString(reader, "type", record.type, visitor);
+}
+
+bool VisitColorPicker(const NativeEventReader& reader, NativeEventFieldVisitor& visitor) {
+    ColorPickerEventRecord record;
+    if (!reader.Read(record)) {
+        return false;
+    }
+    visitor.Boolean("success", record.success != 0);
+    if (record.hex.offset == kNativeStringAbsent) {
+        visitor.Null("hex");
+        return true;
+    }
+    return VisitString(reader, "hex", record.hex, visitor);
+}
+
+}  // namespace
+
+bool VisitNativeEvent(const void* data, size_t size, NativeEventFieldVisitor& visitor) {
+    NativeEventReader reader;
+    if (!reader.Open(data, size)) {
+        return false;
+    }
+    switch (reader.Kind()) {
+        case NativeEventKind::Window: return VisitWindow(reader, visitor);
+        case NativeEventKind::Mouse: return VisitMouse(reader, visitor);
+        case NativeEventKind::ColorPicker: return VisitColorPicker(reader, visitor);
+    }
+    return false;
+}
+
+}  // namespace ztools
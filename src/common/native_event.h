@@ -0,0 +1,150 @@
+// Swift 库 → C++ 桥接的事件 ABI（窗口、鼠标、取色器）
+//
+// 原实现中 Swift 为每个窗口事件拼接 JSON 字符串，桥接层 strdup 一份交给 JS 线程，
+// 再调用全局 JSON.parse 解析；取色器结果则逐个 find 键名。这里改为定长记录 + 字符串表：
+// 数值字段直接按偏移读取，字符串以 (偏移, 长度) 引用字符串表中的 UTF-8 字节，
+// JS 线程按字段表直接创建属性，不再经过文本格式。
+//
+// 布局（小端）：
+//   NativeEventHeader | 记录（recordSize 字节）| 字符串表
+// 版本：Swift 库与绑定随同一个包发布，LoadSwiftLibrary 要求 nativeEventAbiVersion() 与
+// kNativeEventVersion 完全相同，读取方也拒绝 magic 或版本不符的事件；改动任何记录布局都要提升版本。
+// recordSize 仍随事件携带，读取方只复制两者中较短的前缀：记录尾部缺失的数值字段为 0，
+// 字符串字段为缺失（kNativeStringAbsent），不会被当成空串。
+// Swift 侧按相同顺序逐字段写出（src/ZToolsNative.swift 中的 NativeEventWriter）。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ztools {
+
+static const uint32_t kNativeEventMagic = 0x3156455A;  // "ZEV1"
+static const uint16_t kNativeEventVersion = 1;
+static const uint32_t kNativeStringAbsent = 0xFFFFFFFFu;  // NativeString.offset：字段不存在（JS 中省略或为 null）
+
+enum class NativeEventKind : uint16_t {
+    Window = 1,
+    Mouse = 2,
+    ColorPicker = 3,
+};
+
+struct NativeEventHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t kind;        // NativeEventKind
+    uint32_t recordSize;  // 记录字节数，紧跟在头部之后
+    uint32_t stringsSize; // 字符串表字节数，紧跟在记录之后
+};
+
+// 字符串表中的 UTF-8 片段（不以 NUL 结尾）
+struct NativeString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+static const uint32_t kWindowEventPreciseTarget = 1u << 0;
+static const uint32_t kWindowEventHasFinderId = 1u << 1;
+
+struct WindowEventRecord {
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    int32_t pid;
+    uint32_t windowId;
+    int64_t finderId;  // flags 含 kWindowEventHasFinderId 时有效
+    uint32_t flags;
+    uint32_t reserved;
+    NativeString appName;
+    NativeString bundleId;
+    NativeString title;
+    NativeString app;
+    NativeString appPath;
+    NativeString axRole;
+    NativeString axSubrole;
+    NativeString path;  // 以下可缺失
+    NativeString url;
+    NativeString kind;
+};
+// 各记录的字符串字段都连续排在末尾，读取较短记录时据此把缺失部分标为 kNativeStringAbsent
+
+struct MouseEventRecord {
+    NativeString type;  // 如 "middleClick"、"backLongPress"
+};
+
+struct ColorPickerEventRecord {
+    uint32_t success;   // 0 表示取消
+    uint32_t reserved;
+    NativeString hex;   // "#RRGGBB"，取消时缺失
+};
+
+static_assert(sizeof(NativeEventHeader) == 16, "NativeEventHeader layout is part of the Swift ABI");
+static_assert(sizeof(WindowEventRecord) == 120, "WindowEventRecord layout is part of the Swift ABI");
+static_assert(sizeof(MouseEventRecord) == 8, "MouseEventRecord layout is part of the Swift ABI");
+static_assert(sizeof(ColorPickerEventRecord) == 16, "ColorPickerEventRecord layout is part of the Swift ABI");
+static_assert(offsetof(WindowEventRecord, appName) == 40 && (sizeof(WindowEventRecord) - 40) % sizeof(NativeString) == 0,
+              "WindowEventRecord strings must be trailing");
+static_assert(offsetof(ColorPickerEventRecord, hex) == 8, "ColorPickerEventRecord strings must be trailing");
+
+// 编码（Swift 侧的等价实现；测试与基准用）
+class NativeEventWriter {
+public:
+    NativeString AddString(const char* data, size_t size);
+    NativeString AddString(const std::string& text) { return AddString(text.data(), text.size()); }
+    static NativeString Absent() { return NativeString{kNativeStringAbsent, 0}; }
+
+    // 输出 头部 | 记录 | 字符串表，并清空字符串表以便复用
+    std::string Finish(NativeEventKind kind, const void* record, size_t recordSize);
+
+private:
+    std::string strings_;
+};
+
+// 解码：Open 校验头部与长度后，按记录类型读取定长前缀，字符串以指针 + 长度返回（不复制）
+class NativeEventReader {
+public:
+    bool Open(const void* data, size_t size);
+
+    NativeEventKind Kind() const { return kind_; }
+
+    // 复制记录前缀，较短记录缺失的数值字段置 0、字符串字段置为缺失；kind 不匹配返回 false
+    bool Read(WindowEventRecord& record) const {
+        return ReadRecord(NativeEventKind::Window, &record, sizeof(record), offsetof(WindowEventRecord, appName));
+    }
+    bool Read(MouseEventRecord& record) const {
+        return ReadRecord(NativeEventKind::Mouse, &record, sizeof(record), offsetof(MouseEventRecord, type));
+    }
+    bool Read(ColorPickerEventRecord& record) const {
+        return ReadRecord(NativeEventKind::ColorPicker, &record, sizeof(record), offsetof(ColorPickerEventRecord, hex));
+    }
+
+    // 字段缺失或引用越出字符串表时返回 false
+    bool String(const NativeString& ref, const char** data, size_t* size) const;
+
+private:
+    // stringsBegin：记录中第一个字符串字段的偏移（其后全部是 NativeString）
+    bool ReadRecord(NativeEventKind kind, void* record, size_t size, size_t stringsBegin) const;
+
+    const unsigned char* record_ = nullptr;
+    size_t recordSize_ = 0;
+    const char* strings_ = nullptr;
+    size_t stringsSize_ = 0;
+    NativeEventKind kind_ = NativeEventKind::Window;
+};
+
+// JS 对象构建：按原 JSON 的字段名与顺序回调，绑定层据此直接创建属性
+class NativeEventFieldVisitor {
+public:
+    virtual ~NativeEventFieldVisitor() = default;
+    virtual void String(const char* name, const char* data, size_t size) = 0;
+    virtual void Number(const char* name, double value) = 0;
+    virtual void Boolean(const char* name, bool value) = 0;
+    virtual void Null(const char* name) = 0;
+};
+
+// 解码并逐字段回调；数据损坏返回 false（此时可能已回调部分字段）
+bool VisitNativeEvent(const void* data, size_t size, NativeEventFieldVisitor& visitor);
+
+}  // namespace ztools
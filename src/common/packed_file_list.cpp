@@ -0,0 +1,252 @@
+#include "packed_file_list.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace ztools {
+
+namespace {
+
+uint32_t LoadU32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint16_t LoadU16(const unsigned char* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// 追加一个码点的 UTF-8 编码
+void AppendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+const size_t kDropFilesHeaderSize = 20;
+
+}  // namespace
+
+// ==================== PackedFileList ====================
+
+void PackedFileList::Clear() {
+    paths.clear();
+    offsets.assign(1, 0);
+    flags.clear();
+}
+
+void PackedFileList::Reserve(size_t count, size_t pathBytes) {
+    paths.reserve(pathBytes);
+    offsets.reserve(count + 1);
+    flags.reserve(count);
+}
+
+void PackedFileList::Append(const char* utf8, size_t length, uint8_t entryFlags) {
+    paths.append(utf8, length);
+    offsets.push_back(static_cast<uint32_t>(paths.size()));
+    flags.push_back(entryFlags);
+}
+
+std::string PackedFileList::Path(size_t index) const {
+    return paths.substr(offsets[index], offsets[index + 1] - offsets[index]);
+}
+
+uint32_t PackedFileList::NameOffset(size_t index) const {
+    for (uint32_t i = offsets[index + 1]; i > offsets[index]; i--) {
+        if (paths[i - 1] == '\\' || paths[i - 1] == '/') {
+            return i;
+        }
+    }
+    return offsets[index];
+}
+
+std::string PackedFileList::Name(size_t index) const {
+    const uint32_t start = NameOffset(index);
+    return paths.substr(start, offsets[index + 1] - start);
+}
+
+// ==================== DROPFILES ====================
+
+bool ParseDropFiles(const void* data, size_t size, PackedFileList& list) {
+    list.Clear();
+    if (data == nullptr || size < kDropFilesHeaderSize) {
+        return false;
+    }
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const uint32_t pFiles = LoadU32(p);
+    const uint32_t fWide = LoadU32(p + 16);
+    if (fWide == 0 || pFiles < kDropFilesHeaderSize || pFiles > size) {
+        return false;
+    }
+
+    const size_t units = (size - pFiles) / 2;
+    const unsigned char* u = p + pFiles;
+    // UTF-8 最多为 UTF-16 字节数的 1.5 倍，路径多为 ASCII，按码元数预留
+    list.Reserve(0, units);
+
+    // 直接编码进 list.paths，遇到 NUL 即结束一个路径；空字符串表示列表结尾
+    std::string& out = list.paths;
+    bool terminated = false;
+    size_t pathStart = 0;
+    for (size_t i = 0; i < units; i++) {
+        uint32_t cp = LoadU16(u + i * 2);
+        if (cp == 0) {
+            if (i == pathStart) {
+                terminated = true;
+                break;
+            }
+            list.offsets.push_back(static_cast<uint32_t>(out.size()));
+            list.flags.push_back(kFileFlagUnknown);
+            pathStart = i + 1;
+            continue;
+        }
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+            continue;
+        }
+        if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < units) {
+            const uint32_t low = LoadU16(u + (i + 1) * 2);
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            } else {
+                cp = 0xFFFD;
+            }
+        } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+            cp = 0xFFFD;  // 孤立代理项
+        }
+        AppendUtf8(out, cp);
+    }
+    if (!terminated) {
+        list.Clear();
+        return false;
+    }
+    return true;
+}
+
+// ==================== FileProbePool ====================
+
+// 一次查询；除 probe 外的字段都由线程池的 mutex_ 保护
+struct FileProbePool::Job {
+    PackedFileList list;  // 路径与结果的副本（调用方的 list 可能在超时后被释放）
+    FileProbe probe;
+    size_t next = 0;
+    size_t completed = 0;
+    bool cancelled = false;
+    std::vector<uint8_t> resolved;  // 每个条目是否已完成
+    std::condition_variable done;
+};
+
+FileProbePool::FileProbePool(unsigned threads) : threads_(threads > 0 ? threads : 1), stopping_(false) {}
+
+FileProbePool::~FileProbePool() {
+    Shutdown();
+}
+
+void FileProbePool::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        std::shared_ptr<Job> job = jobs_.front();
+        if (job->cancelled || job->next >= job->list.Count()) {
+            // 已超时或条目都已被领取
+            jobs_.pop_front();
+            continue;
+        }
+        const size_t index = job->next++;
+        const std::string path = job->list.Path(index);
+
+        lock.unlock();
+        const uint8_t flags = job->probe(path);
+        lock.lock();
+
+        job->list.flags[index] = flags;
+        job->resolved[index] = 1;
+        if (++job->completed == job->list.Count()) {
+            job->done.notify_all();
+        }
+    }
+}
+
+FileProbeStats FileProbePool::Probe(PackedFileList& list, FileProbe probe, const FileProbeOptions& options) {
+    FileProbeStats stats;
+    const size_t count = list.Count();
+    if (count == 0) {
+        return stats;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->list = list;
+    job->probe = std::move(probe);
+    job->resolved.assign(count, 0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (stopping_) {
+        stats.pending = count;
+        stats.timedOut = true;
+        return stats;
+    }
+    if (workers_.empty()) {
+        workers_.reserve(threads_);
+        for (unsigned i = 0; i < threads_; i++) {
+            workers_.emplace_back(&FileProbePool::WorkerLoop, this);
+        }
+    }
+    jobs_.push_back(job);
+    wake_.notify_all();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(options.timeoutMs);
+    stats.timedOut = !job->done.wait_until(lock, deadline, [this, &job, count]() {
+        return stopping_ || job->completed == count;
+    }) || job->completed != count;
+    job->cancelled = true;
+    auto queued = std::find(jobs_.begin(), jobs_.end(), job);
+    if (queued != jobs_.end()) {
+        jobs_.erase(queued);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (job->resolved[i]) {
+            list.flags[i] = job->list.flags[i];
+            stats.resolved++;
+        }
+    }
+    stats.pending = count - stats.resolved;
+    return stats;
+}
+
+void FileProbePool::Shutdown() {
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        for (const std::shared_ptr<Job>& job : jobs_) {
+            job->cancelled = true;
+            job->done.notify_all();
+        }
+        jobs_.clear();
+        workers.swap(workers_);
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+}  // namespace ztools
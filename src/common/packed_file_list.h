@@ -0,0 +1,101 @@
+// 大量剪贴板文件的紧凑表示与并行属性查询
+//
+// 原来 GetClipboardFiles 为每个文件创建一个带三个属性的 JS 对象，对每个条目调用两次
+// DragQueryFileW，并在 JS 线程上同步调用 GetFileAttributesW（网络共享上可能阻塞数秒）。
+// 在资源管理器中选中 20,000 个文件时主线程会卡住。
+//
+// PackedFileList 把全部路径拼接为一个 UTF-8 缓冲区，另存 count+1 个偏移与每个文件一个标志字节，
+// JS 侧只需三个类型化数组。CF_HDROP 的 DROPFILES 原始字节在锁外直接解析，
+// 文件属性由 FileProbePool 的常驻工作线程并行查询，超时后未完成的条目保持 kFileFlagUnknown。
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ztools {
+
+static const uint8_t kFileFlagDirectory = 1u << 0;  // 目录
+static const uint8_t kFileFlagUnknown = 1u << 1;    // 属性未知（不存在、超时或被跳过）
+static const uint8_t kFileFlagNetwork = 1u << 2;    // 网络路径，未查询属性
+
+struct PackedFileList {
+    std::string paths;               // 全部路径的 UTF-8 拼接（无分隔符）
+    std::vector<uint32_t> offsets;   // Count() + 1 个，路径 i 为 [offsets[i], offsets[i + 1])
+    std::vector<uint8_t> flags;      // Count() 个 kFileFlag* 按位或
+
+    PackedFileList() : offsets(1, 0) {}
+
+    size_t Count() const { return flags.size(); }
+    void Clear();
+    void Reserve(size_t count, size_t pathBytes);
+
+    // 追加一个路径，标志初始为 kFileFlagUnknown
+    void Append(const char* utf8, size_t length, uint8_t flags = kFileFlagUnknown);
+    void Append(const std::string& utf8) { Append(utf8.data(), utf8.size()); }
+
+    std::string Path(size_t index) const;
+    // 文件名在 paths 中的起始偏移（最后一个 '\\' 或 '/' 之后）
+    uint32_t NameOffset(size_t index) const;
+    std::string Name(size_t index) const;
+};
+
+// 解析 CF_HDROP 的 DROPFILES（fWide 为 1，UTF-16 路径以 NUL 分隔、双 NUL 结尾）。
+// 非宽字符（ANSI 代码页）或数据损坏时返回 false，由调用方回退到 DragQueryFile
+bool ParseDropFiles(const void* data, size_t size, PackedFileList& list);
+
+struct FileProbeOptions {
+    uint64_t timeoutMs = 1000;  // 整体超时；0 表示不等待任何结果
+};
+
+struct FileProbeStats {
+    size_t resolved = 0;  // 在超时前完成的条目
+    size_t pending = 0;   // 超时时仍未完成（标志保持 kFileFlagUnknown）
+    bool timedOut = false;
+};
+
+// 返回单个路径的标志；在工作线程中调用，不能引用调用方栈上的数据
+using FileProbe = std::function<uint8_t(const std::string& path)>;
+
+// 固定数量的常驻工作线程（首次查询时启动），由模块持有并在清理时 Shutdown。
+// 每次查询作为一个任务排队，工作线程按条目领取；结果只写入任务自身（线程池持有）的标志副本，
+// 调用方超时返回后，仍阻塞在系统调用中的查询完成时不会触及调用方的 list。
+// 线程全部阻塞在慢速共享上时，后续查询只会等到各自超时（所有条目保持 kFileFlagUnknown），不会再创建线程
+class FileProbePool {
+public:
+    explicit FileProbePool(unsigned threads = 8);
+    ~FileProbePool();
+
+    FileProbePool(const FileProbePool&) = delete;
+    FileProbePool& operator=(const FileProbePool&) = delete;
+
+    // 并行查询全部条目的标志并写回 list.flags。超时后立即返回，未领取的条目不再查询
+    FileProbeStats Probe(PackedFileList& list, FileProbe probe, const FileProbeOptions& options);
+
+    // 取消排队的任务并等待工作线程退出（正在进行的单个查询完成后才返回）。
+    // 之后 Probe 不再查询，直接返回全部未知
+    void Shutdown();
+
+    unsigned Threads() const { return threads_; }
+
+private:
+    struct Job;
+
+    void WorkerLoop();
+
+    const unsigned threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::shared_ptr<Job>> jobs_;
+    std::vector<std::thread> workers_;
+    bool stopping_;
+};
+
+}  // namespace ztools
@@ -0,0 +1,188 @@
+#include "pasteboard.h"
+
+#include <cstring>
+
+namespace ztools {
+
+namespace {
+
+const char kSnapshotMagic[4] = {'Z', 'P', 'B', '1'};
+
+void PutU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+void PutU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+// 顺序读取器：越界时置 failed，后续读取全部失败
+struct Cursor {
+    const unsigned char* data;
+    size_t size;
+    size_t offset;
+    bool failed;
+
+    bool Has(uint64_t length) {
+        if (failed || length > size - offset) {
+            failed = true;
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t Get(int bytes) {
+        if (!Has(bytes)) return 0;
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; i++) value |= static_cast<uint64_t>(data[offset + i]) << (i * 8);
+        offset += bytes;
+        return value;
+    }
+
+    bool Take(uint64_t length, std::string& out) {
+        if (!Has(length)) return false;
+        out.assign(reinterpret_cast<const char*>(data + offset), static_cast<size_t>(length));
+        offset += static_cast<size_t>(length);
+        return true;
+    }
+};
+
+int HexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+std::string PercentDecode(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '%' && i + 2 < text.size()) {
+            int high = HexValue(text[i + 1]);
+            int low = HexValue(text[i + 2]);
+            if (high >= 0 && low >= 0) {
+                result.push_back(static_cast<char>((high << 4) | low));
+                i += 2;
+                continue;
+            }
+        }
+        result.push_back(text[i]);
+    }
+    return result;
+}
+
+}  // namespace
+
+size_t PasteboardSnapshot::Bytes() const {
+    size_t total = 0;
+    for (const PasteboardItem& item : items) {
+        for (const PasteboardEntry& entry : item.entries) total += entry.data.size();
+    }
+    return total;
+}
+
+std::string EncodePasteboardSnapshot(const PasteboardSnapshot& snapshot) {
+    size_t reserve = 8;
+    for (const PasteboardItem& item : snapshot.items) {
+        reserve += 4;
+        for (const PasteboardEntry& entry : item.entries) reserve += 12 + entry.type.size() + entry.data.size();
+    }
+
+    std::string out;
+    out.reserve(reserve);
+    out.append(kSnapshotMagic, sizeof(kSnapshotMagic));
+    PutU32(out, static_cast<uint32_t>(snapshot.items.size()));
+    for (const PasteboardItem& item : snapshot.items) {
+        PutU32(out, static_cast<uint32_t>(item.entries.size()));
+        for (const PasteboardEntry& entry : item.entries) {
+            PutU32(out, static_cast<uint32_t>(entry.type.size()));
+            out.append(entry.type);
+            PutU64(out, entry.data.size());
+            out.append(entry.data);
+        }
+    }
+    return out;
+}
+
+bool DecodePasteboardSnapshot(const void* data, size_t size, PasteboardSnapshot& snapshot) {
+    snapshot.items.clear();
+    if (data == nullptr || size < 8 || memcmp(data, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        return false;
+    }
+
+    Cursor cursor{static_cast<const unsigned char*>(data), size, sizeof(kSnapshotMagic), false};
+    uint32_t itemCount = static_cast<uint32_t>(cursor.Get(4));
+    for (uint32_t i = 0; i < itemCount && !cursor.failed; i++) {
+        PasteboardItem item;
+        uint32_t entryCount = static_cast<uint32_t>(cursor.Get(4));
+        for (uint32_t j = 0; j < entryCount && !cursor.failed; j++) {
+            PasteboardEntry entry;
+            cursor.Take(cursor.Get(4), entry.type);
+            cursor.Take(cursor.Get(8), entry.data);
+            item.entries.push_back(std::move(entry));
+        }
+        snapshot.items.push_back(std::move(item));
+    }
+
+    // 截断或末尾有多余数据都视为损坏
+    if (cursor.failed || cursor.offset != size) {
+        snapshot.items.clear();
+        return false;
+    }
+    return true;
+}
+
+bool SamePasteboardType(const PasteboardSnapshot& a, const PasteboardSnapshot& b, const std::string& type) {
+    std::vector<const std::string*> left;
+    std::vector<const std::string*> right;
+    for (const PasteboardItem& item : a.items) {
+        for (const PasteboardEntry& entry : item.entries) {
+            if (entry.type == type) left.push_back(&entry.data);
+        }
+    }
+    for (const PasteboardItem& item : b.items) {
+        for (const PasteboardEntry& entry : item.entries) {
+            if (entry.type == type) right.push_back(&entry.data);
+        }
+    }
+    if (left.size() != right.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < left.size(); i++) {
+        if (*left[i] != *right[i]) return false;
+    }
+    return true;
+}
+
+std::vector<std::string> ParseUriList(const std::string& uriList) {
+    std::vector<std::string> paths;
+    size_t start = 0;
+    while (start < uriList.size()) {
+        size_t end = uriList.find('\n', start);
+        if (end == std::string::npos) end = uriList.size();
+        std::string line = uriList.substr(start, end - start);
+        start = end + 1;
+
+        while (!line.empty() && (line.back() == '\r' || line.back() == '\0')) line.pop_back();
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line.compare(0, 7, "file://") != 0) {
+            continue;
+        }
+
+        // file:///path 或 file://localhost/path；其他主机名无法映射为本地路径
+        std::string rest = line.substr(7);
+        if (rest.compare(0, 9, "localhost") == 0) {
+            rest.erase(0, 9);
+        }
+        if (rest.empty() || rest[0] != '/') {
+            continue;
+        }
+        paths.push_back(PercentDecode(rest));
+    }
+    return paths;
+}
+
+}  // namespace ztools
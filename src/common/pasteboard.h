@@ -0,0 +1,65 @@
+// 进程内剪贴板（pasteboard）访问接口
+//
+// macOS 原实现通过 popen("pbpaste")、多次 osascript 与 system("... | pbcopy") 读写剪贴板，
+// 一次 getSelectedContent 约需启动七个子进程，图像还要经过 /tmp 下的临时 PNG 文件。
+// 这里把剪贴板访问抽象为进程内接口：
+// - macOS: NSPasteboard（Swift 库导出，见 binding_mac.cpp 中的 SwiftPasteboard）
+// - Linux: X11 选区转换（src/linux/x11_pasteboard.h），可在 Xvfb 下无头测试与基准
+//
+// 快照（PasteboardSnapshot）按 item → 类型 → 原始字节保存全部内容，不做解码，
+// 在 C++ 与 Swift 之间以 EncodePasteboardSnapshot 定义的二进制布局传递。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ztools {
+
+struct PasteboardEntry {
+    std::string type;  // macOS: UTI（如 public.utf8-plain-text）；X11: 目标原子名（如 UTF8_STRING）
+    std::string data;
+};
+
+struct PasteboardItem {
+    std::vector<PasteboardEntry> entries;
+};
+
+struct PasteboardSnapshot {
+    std::vector<PasteboardItem> items;
+
+    bool Empty() const { return items.empty(); }
+    size_t Bytes() const;
+};
+
+class Pasteboard {
+public:
+    virtual ~Pasteboard() = default;
+
+    // 变化计数：内容每次被替换后改变；平台无法提供时返回 0
+    virtual uint64_t ChangeCount() = 0;
+
+    // 以下读取函数：剪贴板没有对应内容时返回 true 且结果为空；无法访问剪贴板时返回 false
+    virtual bool ReadText(std::string& text) = 0;                 // UTF-8
+    virtual bool ReadFiles(std::vector<std::string>& paths) = 0;  // 绝对路径
+    virtual bool ReadImagePng(std::string& png) = 0;              // PNG 原始字节（非 PNG 图像由实现转换）
+
+    // 保存全部 item 的全部类型；Restore 清空后原样写回
+    virtual bool Save(PasteboardSnapshot& snapshot) = 0;
+    virtual bool Restore(const PasteboardSnapshot& snapshot) = 0;
+    virtual bool Clear() = 0;
+};
+
+// 快照二进制布局（小端）：
+//   "ZPB1" | u32 itemCount | { u32 entryCount | { u32 typeLength | type | u64 dataLength | data }* }*
+std::string EncodePasteboardSnapshot(const PasteboardSnapshot& snapshot);
+bool DecodePasteboardSnapshot(const void* data, size_t size, PasteboardSnapshot& snapshot);
+
+// 两个快照中某个类型的数据是否相同（按 item 顺序比较该类型的全部数据；都不存在视为相同）
+bool SamePasteboardType(const PasteboardSnapshot& a, const PasteboardSnapshot& b, const std::string& type);
+
+// 解析 text/uri-list（RFC 2483）：跳过注释与非 file:// URI，解码百分号转义
+std::vector<std::string> ParseUriList(const std::string& uriList);
+
+}  // namespace ztools
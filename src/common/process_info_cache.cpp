@@ -0,0 +1,150 @@
+#include "process_info_cache.h"
+
+namespace ztools {
+
+ProcessInfoCache::ProcessInfoCache(ProcessInfoSource& source, size_t capacity)
+    : source_(source), capacity_(capacity > 0 ? capacity : 1), stats_{} {}
+
+ProcessInfoCache::~ProcessInfoCache() {
+    Clear();
+}
+
+ProcessInfoCache::EntryMap::iterator ProcessInfoCache::Erase(EntryMap::iterator it) {
+    if (it->second.handle != 0) {
+        source_.Close(it->second.handle);
+    }
+    stats_.evicted++;
+    return entries_.erase(it);
+}
+
+std::shared_ptr<const ProcessInfo> ProcessInfoCache::Lookup(uint32_t pid) {
+    if (pid == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(pid);
+    if (it != entries_.end()) {
+        Entry& entry = it->second;
+        if (source_.IsAlive(pid, entry.handle, entry.info->startTime)) {
+            stats_.hits++;
+            entry.lastUsed = ++clock_;
+            return entry.info;
+        }
+        // 进程已退出，或 pid 已属于另一个进程
+        Erase(it);
+    }
+
+    stats_.misses++;
+    uintptr_t handle = 0;
+    uint64_t startTime = 0;
+    if (!source_.Open(pid, &handle, &startTime)) {
+        return nullptr;
+    }
+    auto info = std::make_shared<ProcessInfo>();
+    info->pid = pid;
+    info->startTime = startTime;
+    if (source_.ExecutablePath(pid, handle, &info->appPath)) {
+        SplitExecutableName(info->appPath, &info->app, &info->appName);
+    } else {
+        info->appPath.clear();
+    }
+
+    MakeRoomLocked();
+    Entry& entry = entries_[pid];
+    entry.handle = handle;
+    entry.lastUsed = ++clock_;
+    entry.info = info;
+    return info;
+}
+
+bool ProcessInfoCache::SetIconKey(uint32_t pid, uint64_t startTime, const std::string& iconKey) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(pid);
+    if (it == entries_.end() || it->second.info->startTime != startTime) {
+        return false;
+    }
+    // 快照可能仍被调用方持有：复制后替换，不修改已返回的对象
+    auto info = std::make_shared<ProcessInfo>(*it->second.info);
+    info->iconKey = iconKey;
+    it->second.info = std::move(info);
+    return true;
+}
+
+size_t ProcessInfoCache::EvictExitedLocked() {
+    size_t removed = 0;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (source_.IsAlive(it->first, it->second.handle, it->second.info->startTime)) {
+            ++it;
+        } else {
+            it = Erase(it);
+            removed++;
+        }
+    }
+    return removed;
+}
+
+size_t ProcessInfoCache::EvictExited() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return EvictExitedLocked();
+}
+
+size_t ProcessInfoCache::EvictExitedIfDue(uint64_t nowMs, uint64_t intervalMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nowMs - lastSweepMs_ < intervalMs) {
+        return 0;
+    }
+    lastSweepMs_ = nowMs;
+    return EvictExitedLocked();
+}
+
+// 插入前调用：先移除已退出的进程，仍然满时淘汰最久未使用的条目
+void ProcessInfoCache::MakeRoomLocked() {
+    if (entries_.size() < capacity_) {
+        return;
+    }
+    EvictExitedLocked();
+    while (entries_.size() >= capacity_) {
+        auto oldest = entries_.begin();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+            if (it->second.lastUsed < oldest->second.lastUsed) {
+                oldest = it;
+            }
+        }
+        Erase(oldest);
+    }
+}
+
+void ProcessInfoCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& item : entries_) {
+        if (item.second.handle != 0) {
+            source_.Close(item.second.handle);
+        }
+    }
+    entries_.clear();
+}
+
+size_t ProcessInfoCache::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+ProcessInfoCacheStats ProcessInfoCache::Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SplitExecutableName(const std::string& path, std::string* app, std::string* appName) {
+    const size_t slash = path.find_last_of("\\/");
+    const size_t nameStart = slash == std::string::npos ? 0 : slash + 1;
+    app->assign(path, nameStart, std::string::npos);
+    const size_t dot = app->find_last_of('.');
+    // 以点开头的文件名（如 ".hidden"）没有扩展名
+    if (dot == std::string::npos || dot == 0) {
+        *appName = *app;
+    } else {
+        appName->assign(*app, 0, dot);
+    }
+}
+
+}  // namespace ztools
@@ -0,0 +1,104 @@
+// 进程元数据缓存（可执行文件路径、程序名、图标键）
+//
+// 前台窗口每次切换（以及标题变化、getActiveWindow、剪贴板来源）都需要 pid → 路径 / 程序名。
+// 原实现每次 OpenProcess + GetModuleFileNameExW 并做三次 UTF-8 转换。这里按 (pid, 启动时间)
+// 缓存结果，同一进程再次出现时只需确认它仍在运行；pid 被复用时启动时间不同，不会误命中。
+//
+// 平台相关部分由 ProcessInfoSource 提供，条目可以持有一个平台句柄用于廉价的存活检查：
+// - Windows: 进程句柄，WaitForSingleObject(0) 判断是否退出（句柄未关闭前 pid 不会被复用）
+// - Linux:   pidfd，poll 判断是否退出；/proc/<pid>/stat 提供启动时间，/proc/<pid>/exe 提供路径
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace ztools {
+
+struct ProcessInfo {
+    uint32_t pid = 0;
+    uint64_t startTime = 0;  // 平台定义（Windows 为创建时间 FILETIME，Linux 为开机后的时钟节拍数）
+    std::string appPath;     // 可执行文件完整路径（UTF-8），读取失败时为空
+    std::string app;         // 文件名（含扩展名）
+    std::string appName;     // 文件名（去掉扩展名）
+    std::string iconKey;     // 图标缓存键，由调用方提取图标后通过 SetIconKey 记录
+};
+
+// 平台进程查询。handle 由实现定义，0 表示无句柄；缓存移除条目时调用 Close
+class ProcessInfoSource {
+public:
+    virtual ~ProcessInfoSource() = default;
+
+    // 打开进程并读取启动时间；进程不存在或无权访问返回 false
+    virtual bool Open(uint32_t pid, uintptr_t* handle, uint64_t* startTime) = 0;
+    // 已缓存的进程是否仍在运行（已退出或 pid 已被复用返回 false）
+    virtual bool IsAlive(uint32_t pid, uintptr_t handle, uint64_t startTime) = 0;
+    // 可执行文件完整路径（UTF-8）
+    virtual bool ExecutablePath(uint32_t pid, uintptr_t handle, std::string* path) = 0;
+    virtual void Close(uintptr_t handle) = 0;
+};
+
+struct ProcessInfoCacheStats {
+    uint64_t hits;     // 命中（只做存活检查）次数
+    uint64_t misses;   // 未命中（打开进程并读取路径）次数
+    uint64_t evicted;  // 因进程退出、pid 复用或容量不足而移除的条目数
+};
+
+class ProcessInfoCache {
+public:
+    static const uint64_t kDefaultSweepIntervalMs = 5000;
+
+    explicit ProcessInfoCache(ProcessInfoSource& source, size_t capacity = 128);
+    ~ProcessInfoCache();
+
+    ProcessInfoCache(const ProcessInfoCache&) = delete;
+    ProcessInfoCache& operator=(const ProcessInfoCache&) = delete;
+
+    // 返回进程信息快照；进程不存在或无法打开时返回空指针（不缓存）。
+    // 路径读取失败的进程照常缓存（appPath 为空），避免每次切换都重试
+    std::shared_ptr<const ProcessInfo> Lookup(uint32_t pid);
+
+    // 为缓存中的进程记录图标键；进程不在缓存中（或已是另一个同 pid 进程）返回 false
+    bool SetIconKey(uint32_t pid, uint64_t startTime, const std::string& iconKey);
+
+    // 移除所有已退出的进程并关闭其句柄，返回移除数量。容量不足时自动调用
+    size_t EvictExited();
+
+    // 距上次清理已超过 intervalMs 时调用 EvictExited，否则直接返回 0。
+    // 供前台切换等高频路径调用：已退出进程的句柄不会一直保留到 pid 再次被查询
+    size_t EvictExitedIfDue(uint64_t nowMs, uint64_t intervalMs = kDefaultSweepIntervalMs);
+
+    void Clear();
+    size_t Size() const;
+    size_t Capacity() const { return capacity_; }
+    ProcessInfoCacheStats Stats() const;
+
+private:
+    struct Entry {
+        uintptr_t handle = 0;
+        uint64_t lastUsed = 0;
+        std::shared_ptr<const ProcessInfo> info;
+    };
+    typedef std::unordered_map<uint32_t, Entry> EntryMap;
+
+    EntryMap::iterator Erase(EntryMap::iterator it);
+    size_t EvictExitedLocked();
+    void MakeRoomLocked();
+
+    ProcessInfoSource& source_;
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    EntryMap entries_;
+    uint64_t clock_ = 0;
+    uint64_t lastSweepMs_ = 0;
+    ProcessInfoCacheStats stats_;
+};
+
+// 由可执行文件路径得到 app（文件名，含扩展名）与 appName（去掉最后一个扩展名），
+// 同时识别 '\\' 与 '/' 分隔符
+void SplitExecutableName(const std::string& path, std::string* app, std::string* appName);
+
+}  // namespace ztools
@@ -0,0 +1,69 @@
+#include "sequence_waiter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace ztools {
+
+namespace {
+
+uint64_t SteadyNowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+void SleepUs(uint64_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+}  // namespace
+
+SequenceWaiter::SequenceWaiter(SequenceFn sequence, Clock clock, SleepFn sleep)
+    : sequence_(std::move(sequence)),
+      clock_(clock ? std::move(clock) : Clock(SteadyNowUs)),
+      sleep_(sleep ? std::move(sleep) : SleepFn(SleepUs)) {}
+
+SequenceWaitResult SequenceWaiter::Wait(uint64_t baseline, const SequenceWaitOptions& options) const {
+    SequenceWaitResult result;
+    const uint64_t start = clock_();
+    const uint64_t pollUs = std::max<uint64_t>(options.pollUs, 1);
+
+    uint64_t changedAt = 0;   // 最近一次观察到序列号变化的时间
+    uint64_t last = baseline;
+    for (;;) {
+        const uint64_t sequence = sequence_();
+        const uint64_t now = clock_();
+        result.polls++;
+
+        if (sequence != last) {
+            // 首次变化或写入过程中再次变化：重新计算稳定期
+            last = sequence;
+            changedAt = now;
+            result.changed = true;
+        }
+        result.sequence = sequence;
+        result.waitedUs = now - start;
+
+        if (result.changed) {
+            if (now - changedAt >= options.settleUs) {
+                return result;
+            }
+            // 稳定期同样受超时约束：序列号持续变化时不无限等待
+            if (now - start >= options.timeoutUs + options.settleUs) {
+                return result;
+            }
+        } else if (now - start >= options.timeoutUs) {
+            return result;
+        }
+
+        uint64_t deadline = result.changed
+                                ? std::min(changedAt + options.settleUs, start + options.timeoutUs + options.settleUs)
+                                : start + options.timeoutUs;
+        uint64_t sleepUs = deadline > now ? std::min(pollUs, deadline - now) : pollUs;
+        sleep_(sleepUs);
+    }
+}
+
+}  // namespace ztools
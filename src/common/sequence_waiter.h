@@ -0,0 +1,48 @@
+// 等待剪贴板序列号变化（平台无关，可注入时钟与休眠）
+//
+// 模拟复制后原实现固定 Sleep(100)/usleep(100000) 再读取：目标程序响应快时白白等待，
+// 响应慢（Electron/Office）时又可能读到空剪贴板。这里改为轮询平台序列号
+// （GetClipboardSequenceNumber / NSPasteboard changeCount），
+// 一旦变化并在 settleUs 内保持稳定就立即返回，超过 timeoutUs 仍未变化则放弃。
+//
+// settleUs 用于覆盖"先 EmptyClipboard 再逐个 SetClipboardData"的写入过程：
+// 序列号第一次变化时目标程序可能仍占用剪贴板。
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace ztools {
+
+struct SequenceWaitOptions {
+    uint64_t timeoutUs = 500000;  // 最长等待序列号变化的时间
+    uint64_t pollUs = 2000;       // 轮询间隔
+    uint64_t settleUs = 15000;    // 变化后需保持稳定的时间，0 表示首次变化立即返回
+};
+
+struct SequenceWaitResult {
+    bool changed = false;    // 序列号是否在超时前变化
+    uint64_t sequence = 0;   // 返回时的序列号
+    uint64_t waitedUs = 0;   // 实际等待时间
+    uint32_t polls = 0;      // 读取序列号的次数
+};
+
+class SequenceWaiter {
+public:
+    using SequenceFn = std::function<uint64_t()>;
+    using Clock = std::function<uint64_t()>;            // 单调时钟（微秒）
+    using SleepFn = std::function<void(uint64_t us)>;
+
+    // clock / sleep 为空时使用 steady_clock 与 std::this_thread::sleep_for
+    explicit SequenceWaiter(SequenceFn sequence, Clock clock = nullptr, SleepFn sleep = nullptr);
+
+    // 等待序列号不同于 baseline
+    SequenceWaitResult Wait(uint64_t baseline, const SequenceWaitOptions& options = SequenceWaitOptions()) const;
+
+private:
+    SequenceFn sequence_;
+    Clock clock_;
+    SleepFn sleep_;
+};
+
+}  // namespace ztools
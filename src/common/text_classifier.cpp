@@ -0,0 +1,647 @@
+#include "text_classifier.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZTOOLS_CLASSIFIER_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ZTOOLS_CLASSIFIER_NEON 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ztools {
+
+namespace {
+
+// 字符类别位
+const uint8_t kBaseTrigger = 1 << 0;  // 所有文本都需要检查的触发字符
+const uint8_t kJsonTrigger = 1 << 1;  // 仅 JSON 候选需要检查的结构字符
+const uint8_t kJsonBare = 1 << 2;     // JSON 字符串之外允许出现的字符（数字、true/false/null、分隔符）
+
+struct CharTable {
+    uint8_t flags[256];
+
+    CharTable() : flags() {
+        for (const char* p = "\n#(/:@\\"; *p; p++) flags[static_cast<unsigned char>(*p)] |= kBaseTrigger;
+        for (const char* p = "\"[]{}\\"; *p; p++) flags[static_cast<unsigned char>(*p)] |= kJsonTrigger;
+        for (const char* p = " \t\r\n0123456789,:-+.eEaflnrstu"; *p; p++) {
+            flags[static_cast<unsigned char>(*p)] |= kJsonBare;
+        }
+    }
+};
+
+const CharTable& Chars() {
+    static const CharTable table;
+    return table;
+}
+
+inline unsigned CountTrailingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+    _BitScanForward64(&index, value);
+#else
+    if (!_BitScanForward(&index, static_cast<unsigned long>(value))) {
+        _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+        index += 32;
+    }
+#endif
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+#if defined(ZTOOLS_CLASSIFIER_SSE2)
+
+// 每字节 1 位（_mm_movemask_epi8）
+const unsigned kMaskBitsPerByte = 1;
+const uint64_t kMaskByteBits = 0x1;
+
+template <bool kJson>
+inline uint64_t TriggerMask16(const unsigned char* p) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i m = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('#')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('(')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('/')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8(':')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('@')));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    if (kJson) {
+        // '[' | 0x20 == '{'，']' | 0x20 == '}'：两次比较覆盖四个括号
+        const __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(folded, _mm_set1_epi8('{')));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+    }
+    return static_cast<uint32_t>(_mm_movemask_epi8(m));
+}
+
+#elif defined(ZTOOLS_CLASSIFIER_NEON)
+
+// 每字节 4 位（vshrn 把 16 个比较结果压缩为 64 位）
+const unsigned kMaskBitsPerByte = 4;
+const uint64_t kMaskByteBits = 0xF;
+
+template <bool kJson>
+inline uint64_t TriggerMask16(const unsigned char* p) {
+    const uint8x16_t v = vld1q_u8(p);
+    uint8x16_t m = vceqq_u8(v, vdupq_n_u8('\n'));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('#')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('(')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('/')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8(':')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('@')));
+    m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('\\')));
+    if (kJson) {
+        const uint8x16_t folded = vorrq_u8(v, vdupq_n_u8(0x20));
+        m = vorrq_u8(m, vceqq_u8(v, vdupq_n_u8('"')));
+        m = vorrq_u8(m, vceqq_u8(folded, vdupq_n_u8('{')));
+        m = vorrq_u8(m, vceqq_u8(folded, vdupq_n_u8('}')));
+    }
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(m), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+}
+
+#endif
+
+// 依次对每个触发字符调用 onTrigger(index)
+template <bool kJson, typename Fn>
+void ForEachTrigger(const unsigned char* s, size_t n, bool vectorized, Fn&& onTrigger) {
+    size_t i = 0;
+#if defined(ZTOOLS_CLASSIFIER_SSE2) || defined(ZTOOLS_CLASSIFIER_NEON)
+    if (vectorized) {
+        for (; i + 16 <= n; i += 16) {
+            uint64_t mask = TriggerMask16<kJson>(s + i);
+            while (mask != 0) {
+                const unsigned bit = CountTrailingZeros(mask);
+                onTrigger(i + bit / kMaskBitsPerByte);
+                mask &= ~(kMaskByteBits << (bit - bit % kMaskBitsPerByte));
+            }
+        }
+    }
+#else
+    (void)vectorized;
+#endif
+    const uint8_t wanted = kJson ? (kBaseTrigger | kJsonTrigger) : kBaseTrigger;
+    const CharTable& chars = Chars();
+    for (; i < n; i++) {
+        if ((chars.flags[s[i]] & wanted) != 0) {
+            onTrigger(i);
+        }
+    }
+}
+
+inline bool IsSpace(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool IsAlpha(unsigned char c) {
+    return (c | 0x20) >= 'a' && (c | 0x20) <= 'z';
+}
+
+inline bool IsDigit(unsigned char c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool IsAlnum(unsigned char c) {
+    return IsAlpha(c) || IsDigit(c);
+}
+
+inline bool IsHex(unsigned char c) {
+    return IsDigit(c) || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+}
+
+// 单词字符（非 ASCII 字节视为单词的一部分）
+inline bool IsWordByte(unsigned char c) {
+    return IsAlnum(c) || c == '_' || c >= 0x80;
+}
+
+inline bool IsSchemeByte(unsigned char c) {
+    return IsAlnum(c) || c == '+' || c == '-' || c == '.';
+}
+
+// URL 只接受可打印 ASCII（中文文本中 URL 后通常紧跟全角标点）
+inline bool IsUrlByte(unsigned char c) {
+    return c > 0x20 && c < 0x7F && c != '<' && c != '>' && c != '"' && c != '\'' && c != '`' && c != '\\' &&
+           c != '^' && c != '{' && c != '}';
+}
+
+inline bool IsEmailLocalByte(unsigned char c) {
+    return IsAlnum(c) || c == '.' || c == '_' || c == '%' || c == '+' || c == '-';
+}
+
+// 路径允许非 ASCII（中文文件名），不允许 Windows 文件名中的非法字符
+inline bool IsPathByte(unsigned char c) {
+    return c > 0x20 && c != 0x7F && c != '"' && c != '<' && c != '>' && c != '|' && c != '*' && c != '?' &&
+           c != '\'' && c != '`';
+}
+
+// 路径起始位置之前允许的字符
+inline bool IsPathOpen(unsigned char c) {
+    return IsSpace(c) || c == '"' || c == '\'' || c == '(' || c == '[' || c == '<' || c == '=' || c == '`';
+}
+
+// 全角标点与全角空格（UTF-8 三字节）：，。、；：！？） 与 U+3000
+inline bool IsCjkPunct(const unsigned char* p, size_t remaining) {
+    if (remaining < 3) {
+        return false;
+    }
+    if (p[0] == 0xE3 && p[1] == 0x80) {
+        return p[2] == 0x80 || p[2] == 0x81 || p[2] == 0x82;
+    }
+    if (p[0] == 0xEF && p[1] == 0xBC) {
+        return p[2] == 0x8C || p[2] == 0x9B || p[2] == 0x9A || p[2] == 0x81 || p[2] == 0x9F || p[2] == 0x89;
+    }
+    return false;
+}
+
+// 去掉片段末尾的句读；右括号只在片段内不配对时去掉
+size_t TrimTrailingPunct(const unsigned char* s, size_t begin, size_t end) {
+    int parens = 0;
+    int brackets = 0;
+    for (size_t k = begin; k < end; k++) {
+        if (s[k] == '(') parens++;
+        else if (s[k] == ')') parens--;
+        else if (s[k] == '[') brackets++;
+        else if (s[k] == ']') brackets--;
+    }
+    while (end > begin) {
+        const unsigned char c = s[end - 1];
+        if (c == '.' || c == ',' || c == ';' || c == ':' || c == '!' || c == '?') {
+            end--;
+        } else if (c == ')' && parens < 0) {
+            parens++;
+            end--;
+        } else if (c == ']' && brackets < 0) {
+            brackets++;
+            end--;
+        } else {
+            break;
+        }
+    }
+    return end;
+}
+
+class Classifier {
+public:
+    Classifier(const unsigned char* s, size_t n, bool json, const TextClassifyOptions& options,
+               TextClassification& out)
+        : s_(s), n_(n), json_(json), options_(options), out_(out) {}
+
+    void OnTrigger(size_t i) {
+        const unsigned char c = s_[i];
+        if (json_) {
+            JsonStep(i, c);
+        }
+        if (c == '\n') {
+            EndLine(i);
+            return;
+        }
+        if (i < lastEnd_) {
+            return;  // 位于上一个匹配片段内
+        }
+        switch (c) {
+            case ':':
+                DetectUrl(i);
+                break;
+            case '@':
+                DetectEmail(i);
+                break;
+            case '#':
+                DetectHexColor(i);
+                break;
+            case '(':
+                DetectColorFunction(i);
+                break;
+            case '/':
+            case '\\':
+                DetectPath(i);
+                break;
+            default:
+                break;  // 仅用于 JSON 结构校验的字符
+        }
+    }
+
+    // 扫描结束：收尾最后一行并作整体判定；trimBegin/trimEnd 为去掉首尾空白后的范围
+    void Finish(size_t trimBegin, size_t trimEnd, bool complete) {
+        if (lineStart_ < n_) {
+            EndLine(n_);
+        }
+        if (json_ && jsonOk_ && !inString_ && closed_ && ValidJsonSegment(segmentStart_, n_)) {
+            out_.kinds |= kTextKindJson;
+            out_.exact |= kTextKindJson;
+        } else if (out_.lines >= 2 && codeLines_ > 0 &&
+                   (codeLines_ * 3 >= out_.lines || indentedLines_ * 2 >= out_.lines)) {
+            out_.kinds |= kTextKindCode;
+        }
+        if (complete && matchCount_ == 1 && !out_.matches.empty() && out_.matches[0].begin == trimBegin &&
+            out_.matches[0].end == trimEnd) {
+            out_.exact |= out_.matches[0].kind;
+        }
+    }
+
+private:
+    void Add(uint32_t kind, size_t begin, size_t end) {
+        out_.kinds |= kind;
+        lastEnd_ = end;
+        matchCount_++;
+        if (out_.matches.size() < options_.maxMatches) {
+            out_.matches.push_back({kind, static_cast<uint32_t>(begin), static_cast<uint32_t>(end)});
+        } else {
+            out_.truncated = true;
+        }
+    }
+
+    // scheme://...
+    void DetectUrl(size_t i) {
+        if (i + 3 >= n_ || s_[i + 1] != '/' || s_[i + 2] != '/') {
+            return;
+        }
+        size_t begin = i;
+        while (begin > lastEnd_ && i - begin < 32 && IsSchemeByte(s_[begin - 1])) {
+            begin--;
+        }
+        while (begin < i && !IsAlpha(s_[begin])) {
+            begin++;
+        }
+        if (begin == i) {
+            return;
+        }
+        size_t end = i + 3;
+        while (end < n_ && IsUrlByte(s_[end])) {
+            end++;
+        }
+        end = TrimTrailingPunct(s_, begin, end);
+        if (end <= i + 3) {
+            return;
+        }
+        Add(kTextKindUrl, begin, end);
+    }
+
+    // local@domain.tld（顶级域名至少两个字母）
+    void DetectEmail(size_t i) {
+        size_t begin = i;
+        while (begin > lastEnd_ && IsEmailLocalByte(s_[begin - 1])) {
+            begin--;
+        }
+        while (begin < i && s_[begin] == '.') {
+            begin++;
+        }
+        if (begin == i || i + 1 >= n_ || !IsAlnum(s_[i + 1])) {
+            return;
+        }
+        size_t end = i + 1;
+        while (end < n_ && (IsAlnum(s_[end]) || s_[end] == '-' || s_[end] == '.')) {
+            end++;
+        }
+        while (end > i + 1 && (s_[end - 1] == '.' || s_[end - 1] == '-')) {
+            end--;
+        }
+        size_t lastDot = 0;
+        for (size_t k = i + 1; k < end; k++) {
+            if (s_[k] == '.') {
+                if (s_[k - 1] == '.') {
+                    return;
+                }
+                lastDot = k;
+            }
+        }
+        if (lastDot == 0 || end - lastDot - 1 < 2) {
+            return;
+        }
+        for (size_t k = lastDot + 1; k < end; k++) {
+            if (!IsAlpha(s_[k])) {
+                return;
+            }
+        }
+        Add(kTextKindEmail, begin, end);
+    }
+
+    // #rgb / #rgba / #rrggbb / #rrggbbaa
+    void DetectHexColor(size_t i) {
+        if (i > 0 && (IsWordByte(s_[i - 1]) || s_[i - 1] == '&')) {
+            return;  // 单词中间或 HTML 实体 &#123;
+        }
+        size_t end = i + 1;
+        while (end < n_ && end - i <= 8 && IsHex(s_[end])) {
+            end++;
+        }
+        const size_t digits = end - i - 1;
+        if (end < n_ && IsWordByte(s_[end])) {
+            return;
+        }
+        if (digits != 3 && digits != 4 && digits != 6 && digits != 8) {
+            return;
+        }
+        Add(kTextKindColor, i, end);
+    }
+
+    // rgb(...) / rgba(...) / hsl(...) / hsla(...)
+    void DetectColorFunction(size_t i) {
+        size_t begin = i;
+        while (begin > lastEnd_ && i - begin < 4 && IsAlpha(s_[begin - 1])) {
+            begin--;
+        }
+        if (begin > 0 && IsWordByte(s_[begin - 1])) {
+            return;
+        }
+        char name[5] = {0};
+        const size_t nameLen = i - begin;
+        if (nameLen < 3) {
+            return;
+        }
+        for (size_t k = 0; k < nameLen; k++) {
+            name[k] = static_cast<char>(s_[begin + k] | 0x20);
+        }
+        if (strcmp(name, "rgb") != 0 && strcmp(name, "rgba") != 0 && strcmp(name, "hsl") != 0 &&
+            strcmp(name, "hsla") != 0) {
+            return;
+        }
+        size_t end = i + 1;
+        bool hasDigit = false;
+        for (; end < n_ && end - i < 64 && s_[end] != ')'; end++) {
+            const unsigned char c = s_[end];
+            if (IsDigit(c)) {
+                hasDigit = true;
+            } else if (c != ' ' && c != ',' && c != '.' && c != '%' && c != '/' && c != '-' && c != '+') {
+                return;
+            }
+        }
+        if (end >= n_ || s_[end] != ')' || !hasDigit) {
+            return;
+        }
+        Add(kTextKindColor, begin, end + 1);
+    }
+
+    // C:\...、C:/...、\\server\share、/usr/...、~/...；引号内的路径可以包含空格
+    void DetectPath(size_t i) {
+        const unsigned char c = s_[i];
+        size_t begin;
+        bool unix = false;
+        if (i >= 2 && s_[i - 1] == ':' && IsAlpha(s_[i - 2]) && i - 2 >= lastEnd_ && (i == 2 || !IsWordByte(s_[i - 3]))) {
+            begin = i - 2;
+        } else if (c == '\\' && i + 2 < n_ && s_[i + 1] == '\\' && IsWordByte(s_[i + 2]) &&
+                   (i == 0 || IsPathOpen(s_[i - 1]))) {
+            begin = i;
+        } else if (c == '/' && i + 1 < n_ && s_[i + 1] != '/' && IsPathByte(s_[i + 1])) {
+            begin = (i > lastEnd_ && s_[i - 1] == '~') ? i - 1 : i;
+            if (begin > 0 && !IsPathOpen(s_[begin - 1])) {
+                return;
+            }
+            unix = true;
+        } else {
+            return;
+        }
+
+        size_t end = i + 1;
+        bool quoted = begin > 0 && s_[begin - 1] == '"';
+        if (quoted) {
+            while (end < n_ && s_[end] != '"' && s_[end] != '\n' && s_[end] != '\r') {
+                end++;
+            }
+            quoted = end < n_ && s_[end] == '"';
+        }
+        if (!quoted) {
+            end = i + 1;
+            while (end < n_ && IsPathByte(s_[end]) && !IsCjkPunct(s_ + end, n_ - end)) {
+                end++;
+            }
+            end = TrimTrailingPunct(s_, begin, end);
+        }
+        if (unix && s_[begin] != '~') {
+            // 单级的 /word 在普通文字中过于常见（如 and /or），至少要求两级
+            const void* slash = memchr(s_ + i + 1, '/', end - i - 1);
+            if (slash == nullptr || static_cast<const unsigned char*>(slash) == s_ + end - 1) {
+                return;
+            }
+        }
+        if (end - begin < 3) {
+            return;
+        }
+        Add(kTextKindPath, begin, end);
+    }
+
+    void EndLine(size_t i) {
+        size_t begin = lineStart_;
+        size_t end = i;
+        lineStart_ = i + 1;
+        while (end > begin && IsSpace(s_[end - 1])) {
+            end--;
+        }
+        if (end == begin) {
+            return;
+        }
+        out_.lines++;
+        if (s_[begin] == ' ' || s_[begin] == '\t') {
+            indentedLines_++;
+        }
+        const unsigned char last = s_[end - 1];
+        if (last == ';' || last == '{' || last == '}') {
+            codeLines_++;
+        }
+    }
+
+    bool ValidJsonSegment(size_t begin, size_t end) const {
+        const CharTable& chars = Chars();
+        for (size_t k = begin; k < end; k++) {
+            if ((chars.flags[s_[k]] & kJsonBare) == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 结构校验：字符串 / 括号配对 / 字符串之外只允许数字与字面量；不校验逗号与冒号的位置
+    void JsonStep(size_t i, unsigned char c) {
+        if (!jsonOk_) {
+            return;
+        }
+        if (inString_) {
+            if (i < escapedUntil_) {
+                return;
+            }
+            if (c == '\\') {
+                escapedUntil_ = i + 2;
+            } else if (c == '"') {
+                inString_ = false;
+                segmentStart_ = i + 1;
+            } else if (c == '\n') {
+                jsonOk_ = false;  // 字符串中不允许未转义的换行
+            }
+            return;
+        }
+        if (c != '"' && c != '{' && c != '[' && c != '}' && c != ']') {
+            return;  // 其他触发字符留在片段中一并校验
+        }
+        if (closed_ || !ValidJsonSegment(segmentStart_, i)) {
+            jsonOk_ = false;
+            return;
+        }
+        segmentStart_ = i + 1;
+        if (c == '"') {
+            inString_ = true;
+            return;
+        }
+        if (c == '{' || c == '[') {
+            stack_.push_back(c);
+            if (c == '{') {
+                size_t k = i + 1;
+                while (k < n_ && IsSpace(s_[k])) {
+                    k++;
+                }
+                if (k >= n_ || (s_[k] != '"' && s_[k] != '}')) {
+                    jsonOk_ = false;
+                }
+            }
+            return;
+        }
+        if (stack_.empty() || stack_.back() != (c == '}' ? '{' : '[')) {
+            jsonOk_ = false;
+            return;
+        }
+        stack_.pop_back();
+        closed_ = stack_.empty();
+    }
+
+    const unsigned char* s_;
+    size_t n_;
+    bool json_;
+    const TextClassifyOptions& options_;
+    TextClassification& out_;
+
+    size_t lastEnd_ = 0;
+    size_t matchCount_ = 0;
+
+    size_t lineStart_ = 0;
+    uint32_t codeLines_ = 0;
+    uint32_t indentedLines_ = 0;
+
+    bool jsonOk_ = true;
+    bool inString_ = false;
+    bool closed_ = false;
+    size_t escapedUntil_ = 0;
+    size_t segmentStart_ = 0;
+    std::vector<unsigned char> stack_;
+};
+
+}  // namespace
+
+TextClassification ClassifyText(const char* data, size_t size, const TextClassifyOptions& options) {
+    TextClassification result;
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(data);
+    size_t n = size;
+    if (n > options.maxBytes) {
+        n = options.maxBytes;
+        while (n > 0 && (s[n] & 0xC0) == 0x80) {
+            n--;  // 不截断 UTF-8 字符
+        }
+        result.truncated = true;
+    }
+    const bool complete = n == size;
+
+    size_t trimBegin = 0;
+    size_t trimEnd = n;
+    while (trimBegin < trimEnd && IsSpace(s[trimBegin])) {
+        trimBegin++;
+    }
+    while (trimEnd > trimBegin && IsSpace(s[trimEnd - 1])) {
+        trimEnd--;
+    }
+    const bool json = complete && trimEnd - trimBegin >= 2 &&
+                      ((s[trimBegin] == '{' && s[trimEnd - 1] == '}') || (s[trimBegin] == '[' && s[trimEnd - 1] == ']'));
+
+    Classifier classifier(s, n, json, options, result);
+    if (json) {
+        ForEachTrigger<true>(s, n, options.vectorized, [&](size_t i) { classifier.OnTrigger(i); });
+    } else {
+        ForEachTrigger<false>(s, n, options.vectorized, [&](size_t i) { classifier.OnTrigger(i); });
+    }
+    classifier.Finish(trimBegin, trimEnd, complete);
+    return result;
+}
+
+const char* TextKindName(uint32_t kind) {
+    switch (kind) {
+        case kTextKindUrl:
+            return "url";
+        case kTextKindEmail:
+            return "email";
+        case kTextKindPath:
+            return "path";
+        case kTextKindColor:
+            return "color";
+        case kTextKindJson:
+            return "json";
+        case kTextKindCode:
+            return "code";
+        default:
+            return "";
+    }
+}
+
+void ConvertTextMatchesToUtf16(const char* data, size_t size, std::vector<TextMatch>& matches) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(data);
+    size_t pos = 0;
+    uint32_t units = 0;
+    auto advance = [&](size_t target) {
+        for (; pos < target && pos < size; pos++) {
+            if ((s[pos] & 0xC0) != 0x80) {
+                units += s[pos] >= 0xF0 ? 2 : 1;  // 四字节字符对应代理对
+            }
+        }
+        return units;
+    };
+    for (TextMatch& match : matches) {
+        match.begin = advance(match.begin);
+        match.end = advance(match.end);
+    }
+}
+
+}  // namespace ztools
@@ -0,0 +1,58 @@
+// 剪贴板文本分类（URL / 邮箱 / 文件路径 / 颜色值 / JSON / 代码片段）
+//
+// 监控线程在读取文本后直接分类，变化通知只携带类型位和少量匹配片段，
+// 大段文本不必为了"建议操作"而整体传入 JS。
+// 扫描时以 16 字节为一组（SSE2 / NEON，其他平台逐字节查表）查找触发字符
+// （: @ # / \ ( 换行，JSON 候选额外包括引号和括号），只在触发字符附近做局部校验，
+// 普通文字不逐字节进入判定逻辑。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ztools {
+
+// 类型位（与 index.js 中 ClipboardMonitor.TextKind 一致）
+static const uint32_t kTextKindUrl = 1u << 0;
+static const uint32_t kTextKindEmail = 1u << 1;
+static const uint32_t kTextKindPath = 1u << 2;
+static const uint32_t kTextKindColor = 1u << 3;
+static const uint32_t kTextKindJson = 1u << 4;   // 仅整体判定，不产生匹配片段
+static const uint32_t kTextKindCode = 1u << 5;   // 仅整体判定，不产生匹配片段
+
+// 匹配片段，[begin, end) 为 UTF-8 字节偏移（ConvertTextMatchesToUtf16 后为 UTF-16 单元偏移）
+struct TextMatch {
+    uint32_t kind;
+    uint32_t begin;
+    uint32_t end;
+};
+
+struct TextClassifyOptions {
+    size_t maxMatches = 16;         // 最多记录的片段数（类型位不受限制）
+    size_t maxBytes = 16u << 20;    // 最多扫描的字节数；超出部分不参与分类
+    bool vectorized = true;         // false 时逐字节查表（用于测试与基准对比）
+};
+
+struct TextClassification {
+    uint32_t kinds = 0;             // 出现过的类型
+    uint32_t exact = 0;             // 去掉首尾空白后整段恰好是该类型（如整段是一个 URL）
+    std::vector<TextMatch> matches; // 按位置排序、互不重叠
+    bool truncated = false;         // 片段数或扫描长度达到上限
+    uint32_t lines = 0;             // 非空行数
+};
+
+TextClassification ClassifyText(const char* data, size_t size, const TextClassifyOptions& options = TextClassifyOptions());
+
+inline TextClassification ClassifyText(const std::string& text, const TextClassifyOptions& options = TextClassifyOptions()) {
+    return ClassifyText(text.data(), text.size(), options);
+}
+
+// 类型名（"url"、"email"、"path"、"color"、"json"、"code"）；kind 须为单个类型位
+const char* TextKindName(uint32_t kind);
+
+// 将匹配片段的 UTF-8 字节偏移换算为 UTF-16 单元偏移（JS 字符串下标），只遍历一次文本
+void ConvertTextMatchesToUtf16(const char* data, size_t size, std::vector<TextMatch>& matches);
+
+}  // namespace ztools
@@ -0,0 +1,320 @@
+#include "utf_transcode.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZTOOLS_TRANSCODE_SSE2 1
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ZTOOLS_TRANSCODE_AVX2 1
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ZTOOLS_TRANSCODE_NEON 1
+#endif
+
+namespace ztools {
+
+namespace {
+
+// 向量路径遇到非 ASCII 后逐码元处理的数量：连续失败时加倍（中文等非 ASCII 文本不再反复试探），
+// 成功复制后恢复
+const size_t kMinScalarRun = 16;
+const size_t kMaxScalarRun = 512;
+
+inline size_t NextScalarRun(size_t run, size_t copied) {
+    if (copied != 0) {
+        return kMinScalarRun;
+    }
+    return run < kMaxScalarRun ? run * 2 : kMaxScalarRun;
+}
+
+inline size_t EncodeUtf8(uint32_t cp, char* dst) {
+    if (cp < 0x80) {
+        dst[0] = static_cast<char>(cp);
+        return 1;
+    }
+    if (cp < 0x800) {
+        dst[0] = static_cast<char>(0xC0 | (cp >> 6));
+        dst[1] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000) {
+        dst[0] = static_cast<char>(0xE0 | (cp >> 12));
+        dst[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        dst[2] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+    dst[0] = static_cast<char>(0xF0 | (cp >> 18));
+    dst[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    dst[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    dst[3] = static_cast<char>(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+// 从 src[i] 读取一个码点（代理对消耗两个码元），孤立代理项返回 U+FFFD
+inline uint32_t DecodeUtf16(const char16_t* src, size_t length, size_t& i) {
+    uint32_t cp = src[i++];
+    if (cp >= 0xD800 && cp <= 0xDFFF) {
+        if (cp <= 0xDBFF && i < length && src[i] >= 0xDC00 && src[i] <= 0xDFFF) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (src[i] - 0xDC00);
+            i++;
+        } else {
+            cp = 0xFFFD;
+        }
+    }
+    return cp;
+}
+
+// 从 src[i] 读取一个码点；无效序列只消耗首字节并返回 U+FFFD
+inline uint32_t DecodeUtf8(const unsigned char* src, size_t size, size_t& i) {
+    const unsigned char c = src[i];
+    size_t length;
+    uint32_t cp;
+    uint32_t min;
+    if (c < 0x80) {
+        i++;
+        return c;
+    } else if ((c & 0xE0) == 0xC0) {
+        length = 2;
+        cp = c & 0x1F;
+        min = 0x80;
+    } else if ((c & 0xF0) == 0xE0) {
+        length = 3;
+        cp = c & 0x0F;
+        min = 0x800;
+    } else if ((c & 0xF8) == 0xF0) {
+        length = 4;
+        cp = c & 0x07;
+        min = 0x10000;
+    } else {
+        i++;
+        return 0xFFFD;
+    }
+    if (size - i < length) {
+        i++;
+        return 0xFFFD;
+    }
+    for (size_t k = 1; k < length; k++) {
+        const unsigned char next = src[i + k];
+        if ((next & 0xC0) != 0x80) {
+            i++;
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+        i++;
+        return 0xFFFD;
+    }
+    i += length;
+    return cp;
+}
+
+// 复制开头全为 ASCII 的整组码元（窄化为字节），返回处理的码元数
+size_t CopyAsciiUtf16(const char16_t* src, size_t length, char* dst) {
+    size_t i = 0;
+#if defined(ZTOOLS_TRANSCODE_AVX2)
+    const __m256i high256 = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    while (length - i >= 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), high256)) {
+            break;
+        }
+        // packus 按 128 位通道交错，重排 64 位块恢复顺序
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+        i += 32;
+    }
+#endif
+#if defined(ZTOOLS_TRANSCODE_SSE2)
+    const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    while (length - i >= 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+        const __m128i any = _mm_and_si128(_mm_or_si128(a, b), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(any, zero)) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(a, b));
+        i += 16;
+    }
+#elif defined(ZTOOLS_TRANSCODE_NEON)
+    const uint16x8_t high = vdupq_n_u16(0xFF80);
+    while (length - i >= 16) {
+        const uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+        const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(src + i + 8));
+        const uint64x2_t any = vreinterpretq_u64_u16(vandq_u16(vorrq_u16(a, b), high));
+        if ((vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) != 0) {
+            break;
+        }
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+        i += 16;
+    }
+#else
+    (void)src;
+    (void)length;
+    (void)dst;
+#endif
+    return i;
+}
+
+// 复制开头全为 ASCII 的整组字节（展开为码元），返回处理的字节数
+size_t CopyAsciiUtf8(const unsigned char* src, size_t size, char16_t* dst) {
+    size_t i = 0;
+#if defined(ZTOOLS_TRANSCODE_AVX2)
+    while (size - i >= 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        if (_mm256_movemask_epi8(v) != 0) {
+            break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                            _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i + 16),
+                            _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+        i += 32;
+    }
+#endif
+#if defined(ZTOOLS_TRANSCODE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    while (size - i >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+        i += 16;
+    }
+#elif defined(ZTOOLS_TRANSCODE_NEON)
+    const uint8x16_t high = vdupq_n_u8(0x80);
+    while (size - i >= 16) {
+        const uint8x16_t v = vld1q_u8(src + i);
+        const uint64x2_t any = vreinterpretq_u64_u8(vandq_u8(v, high));
+        if ((vgetq_lane_u64(any, 0) | vgetq_lane_u64(any, 1)) != 0) {
+            break;
+        }
+        vst1q_u16(reinterpret_cast<uint16_t*>(dst + i), vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(dst + i + 8), vmovl_u8(vget_high_u8(v)));
+        i += 16;
+    }
+#else
+    (void)src;
+    (void)size;
+    (void)dst;
+#endif
+    return i;
+}
+
+}  // namespace
+
+size_t ConvertUtf16ToUtf8(const char16_t* src, size_t length, char* dst, const TranscodeOptions& options) {
+    size_t i = 0;
+    size_t o = 0;
+    size_t run = kMinScalarRun / 2;
+    while (i < length) {
+        size_t stop = length;
+        if (options.vectorized) {
+            const size_t copied = CopyAsciiUtf16(src + i, length - i, dst + o);
+            i += copied;
+            o += copied;
+            run = NextScalarRun(run, copied);
+            if (length - i > run) {
+                stop = i + run;
+            }
+        }
+        while (i < stop) {
+            if (src[i] < 0x80) {
+                dst[o++] = static_cast<char>(src[i++]);
+                continue;
+            }
+            o += EncodeUtf8(DecodeUtf16(src, length, i), dst + o);
+        }
+    }
+    return o;
+}
+
+size_t ConvertUtf8ToUtf16(const char* src, size_t size, char16_t* dst, const TranscodeOptions& options) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(src);
+    size_t i = 0;
+    size_t o = 0;
+    size_t run = kMinScalarRun / 2;
+    while (i < size) {
+        size_t stop = size;
+        if (options.vectorized) {
+            const size_t copied = CopyAsciiUtf8(bytes + i, size - i, dst + o);
+            i += copied;
+            o += copied;
+            run = NextScalarRun(run, copied);
+            if (size - i > run) {
+                stop = i + run;
+            }
+        }
+        while (i < stop) {
+            if (bytes[i] < 0x80) {
+                dst[o++] = bytes[i++];
+                continue;
+            }
+            uint32_t cp = DecodeUtf8(bytes, size, i);
+            if (cp >= 0x10000) {
+                cp -= 0x10000;
+                dst[o++] = static_cast<char16_t>(0xD800 + (cp >> 10));
+                dst[o++] = static_cast<char16_t>(0xDC00 + (cp & 0x3FF));
+            } else {
+                dst[o++] = static_cast<char16_t>(cp);
+            }
+        }
+    }
+    return o;
+}
+
+size_t AppendUtf16AsUtf8(const char16_t* data, size_t length, std::string& out, const TranscodeOptions& options) {
+    const size_t base = out.size();
+    if (length == 0) {
+        return 0;
+    }
+    out.resize(base + length * kMaxUtf8BytesPerUtf16);
+    const size_t written = ConvertUtf16ToUtf8(data, length, &out[base], options);
+    out.resize(base + written);
+    return written;
+}
+
+size_t AppendUtf8AsUtf16(const char* data, size_t size, std::u16string& out, const TranscodeOptions& options) {
+    const size_t base = out.size();
+    if (size == 0) {
+        return 0;
+    }
+    out.resize(base + size);
+    const size_t written = ConvertUtf8ToUtf16(data, size, &out[base], options);
+    out.resize(base + written);
+    return written;
+}
+
+std::string Utf16ToUtf8(const char16_t* data, size_t length, const TranscodeOptions& options) {
+    std::string out;
+    AppendUtf16AsUtf8(data, length, out, options);
+    // 按上限分配的大文本（如剪贴板历史）多数为 ASCII，闲置容量明显时归还
+    if (out.capacity() - out.size() > 64 * 1024) {
+        out.shrink_to_fit();
+    }
+    return out;
+}
+
+std::u16string Utf8ToUtf16(const char* data, size_t size, const TranscodeOptions& options) {
+    std::u16string out;
+    AppendUtf8AsUtf16(data, size, out, options);
+    return out;
+}
+
+size_t Utf8LengthOfUtf16(const char16_t* data, size_t length) {
+    size_t bytes = 0;
+    size_t i = 0;
+    while (i < length) {
+        const uint32_t cp = DecodeUtf16(data, length, i);
+        bytes += cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4;
+    }
+    return bytes;
+}
+
+}  // namespace ztools
@@ -0,0 +1,80 @@
+// UTF-8 / UTF-16 转码（平台无关，各绑定共用）
+//
+// Windows 绑定原先到处是 WideCharToMultiByte / MultiByteToWideChar 成对调用：第一次求长度、
+// 第二次转换，同一段文本要完整扫描两遍。这里改为按上限一次分配、单遍转换后截断：
+// UTF-16 → UTF-8 每个码元最多 3 字节，UTF-8 → UTF-16 每个字节最多 1 个码元。
+//
+// 剪贴板文本、路径、窗口标题大多是 ASCII：每次以 16 个码元（AVX2 为 32 个）为一组判断是否全为
+// ASCII，是则直接窄化/展开写出（SSE2 / AVX2 / NEON，其他平台逐码元），遇到非 ASCII 时逐个码元
+// 处理一小段再回到向量路径。
+//
+// 非法输入与 Win32 默认行为一致地替换为 U+FFFD：孤立代理项替换为一个 U+FFFD；
+// 无效的 UTF-8 序列（截断、过长编码、编码的代理项、超过 U+10FFFF）每个首字节替换为一个 U+FFFD。
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#include <cwchar>
+#endif
+
+namespace ztools {
+
+struct TranscodeOptions {
+    bool vectorized = true;  // false 时逐码元转换（用于测试与基准对比）
+};
+
+// 一个 UTF-16 码元最多对应的 UTF-8 字节数
+static const size_t kMaxUtf8BytesPerUtf16 = 3;
+
+// 底层转换：dst 至少 kMaxUtf8BytesPerUtf16 * length 字节 / size 个码元，返回写入数量
+size_t ConvertUtf16ToUtf8(const char16_t* src, size_t length, char* dst,
+                          const TranscodeOptions& options = TranscodeOptions());
+size_t ConvertUtf8ToUtf16(const char* src, size_t size, char16_t* dst,
+                          const TranscodeOptions& options = TranscodeOptions());
+
+// 追加到 out 末尾，返回追加的字节数 / 码元数
+size_t AppendUtf16AsUtf8(const char16_t* data, size_t length, std::string& out,
+                         const TranscodeOptions& options = TranscodeOptions());
+size_t AppendUtf8AsUtf16(const char* data, size_t size, std::u16string& out,
+                         const TranscodeOptions& options = TranscodeOptions());
+
+std::string Utf16ToUtf8(const char16_t* data, size_t length, const TranscodeOptions& options = TranscodeOptions());
+std::u16string Utf8ToUtf16(const char* data, size_t size, const TranscodeOptions& options = TranscodeOptions());
+
+// 由 ConvertUtf16ToUtf8 写出的 UTF-8 长度（不转换，供需要精确预分配的调用方使用）
+size_t Utf8LengthOfUtf16(const char16_t* data, size_t length);
+
+#ifdef _WIN32
+// Windows 的 wchar_t 即 UTF-16 码元
+static_assert(sizeof(wchar_t) == sizeof(char16_t), "wchar_t must be UTF-16 on Windows");
+
+inline std::string WideToUtf8(const wchar_t* data, size_t length) {
+    return Utf16ToUtf8(reinterpret_cast<const char16_t*>(data), length);
+}
+
+// NUL 结尾的宽字符串
+inline std::string WideToUtf8(const wchar_t* data) {
+    return data == nullptr ? std::string() : WideToUtf8(data, wcslen(data));
+}
+
+inline std::string WideToUtf8(const std::wstring& wide) {
+    return WideToUtf8(wide.data(), wide.size());
+}
+
+inline std::wstring Utf8ToWide(const char* data, size_t size) {
+    std::wstring wide(size, L'\0');
+    if (size > 0) {
+        wide.resize(ConvertUtf8ToUtf16(data, size, reinterpret_cast<char16_t*>(&wide[0])));
+    }
+    return wide;
+}
+
+inline std::wstring Utf8ToWide(const std::string& utf8) {
+    return Utf8ToWide(utf8.data(), utf8.size());
+}
+#endif
+
+}  // namespace ztools
@@ -0,0 +1,60 @@
+// 零拷贝 JS 缓冲区（各平台 binding 共用，仅由 binding_*.cpp 包含一次）
+//
+// 原生读取结果以 ExternalBytes 接管后直接作为 Buffer / ArrayBuffer 的存储，终结器中释放。
+// Electron 开启 V8 沙箱时不允许外部缓冲区（napi_no_external_buffers_allowed），此时回退为复制一次。
+#pragma once
+
+#include <napi.h>
+
+#include <cstring>
+#include <utility>
+
+#include "common/external_bytes.h"
+
+static void FinalizeExternalBytes(napi_env env, void* data, void* hint) {
+    ztools::ExternalBytes::Release(static_cast<ztools::ExternalBytes*>(hint));
+}
+
+// Node Buffer，存储为 bytes 原有的分配
+static Napi::Value NewExternalBuffer(Napi::Env env, std::string&& bytes) {
+    ztools::ExternalBytes* external = ztools::ExternalBytes::Adopt(std::move(bytes));
+    napi_value value = nullptr;
+    napi_status status = napi_create_external_buffer(env, external->Size(), external->Data(), FinalizeExternalBytes,
+                                                     external, &value);
+    if (status == napi_ok) {
+        return Napi::Value(env, value);
+    }
+    Napi::Buffer<char> copy = Napi::Buffer<char>::Copy(env, external->Data(), external->Size());
+    ztools::ExternalBytes::Release(external);
+    return copy;
+}
+
+// UTF-16LE 字节 → Uint16Array 视图（长度为码元数）
+static Napi::Value NewExternalUint16Array(Napi::Env env, std::string&& utf16le) {
+    const size_t units = utf16le.size() / 2;
+    utf16le.resize(units * 2);
+    ztools::ExternalBytes* external = ztools::ExternalBytes::Adopt(std::move(utf16le));
+    napi_value arrayBuffer = nullptr;
+    napi_status status = napi_create_external_arraybuffer(env, external->Data(), external->Size(),
+                                                          FinalizeExternalBytes, external, &arrayBuffer);
+    Napi::ArrayBuffer buffer;
+    if (status == napi_ok) {
+        buffer = Napi::ArrayBuffer(env, arrayBuffer);
+    } else {
+        buffer = Napi::ArrayBuffer::New(env, external->Size());
+        memcpy(buffer.Data(), external->Data(), external->Size());
+        ztools::ExternalBytes::Release(external);
+    }
+    return Napi::Uint16Array::New(env, units, buffer, 0);
+}
+
+// 尚未被 GC 回收的外部缓冲区统计
+Napi::Value GetExternalBufferStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    ztools::ExternalBytesStats stats = ztools::ExternalBytes::Stats();
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("liveCount", Napi::Number::New(env, static_cast<double>(stats.liveCount)));
+    result.Set("liveBytes", Napi::Number::New(env, static_cast<double>(stats.liveBytes)));
+    result.Set("adopted", Napi::Number::New(env, static_cast<double>(stats.adopted)));
+    return result;
+}
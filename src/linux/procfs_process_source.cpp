@@ -0,0 +1,122 @@
+#include "procfs_process_source.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace ztools {
+
+namespace {
+
+// handle 为 pidfd + 1（0 表示没有 pidfd）
+inline int HandleToFd(uintptr_t handle) {
+    return static_cast<int>(handle) - 1;
+}
+
+int OpenPidFd(uint32_t pid) {
+#ifdef SYS_pidfd_open
+    return static_cast<int>(syscall(SYS_pidfd_open, static_cast<pid_t>(pid), 0));
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+// pidfd 在进程退出（含成为僵尸）时变为可读
+bool PidFdAlive(int fd) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, 0) == 0;
+}
+
+}  // namespace
+
+bool ReadProcessStartTime(uint32_t pid, uint64_t* startTime) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%u/stat", pid);
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char buffer[1024];
+    const ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (size <= 0) {
+        return false;
+    }
+    buffer[size] = '\0';
+
+    // 第 2 字段 comm 可含空格和括号，从最后一个 ')' 之后开始数：state 为第 3 字段
+    const char* cursor = strrchr(buffer, ')');
+    if (cursor == nullptr || cursor[1] != ' ') {
+        return false;
+    }
+    cursor += 2;
+    if (*cursor == 'Z' || *cursor == 'X') {
+        return false;
+    }
+    for (int field = 3; field < 22; field++) {
+        cursor = strchr(cursor, ' ');
+        if (cursor == nullptr) {
+            return false;
+        }
+        cursor++;
+    }
+    char* end;
+    const unsigned long long value = strtoull(cursor, &end, 10);
+    if (end == cursor) {
+        return false;
+    }
+    *startTime = value;
+    return true;
+}
+
+bool ProcfsProcessSource::Open(uint32_t pid, uintptr_t* handle, uint64_t* startTime) {
+    // 先取 pidfd 再读 stat：读完后 pidfd 仍存活，说明 stat 属于同一个进程
+    const int fd = OpenPidFd(pid);
+    if (!ReadProcessStartTime(pid, startTime) || (fd >= 0 && !PidFdAlive(fd))) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    *handle = fd >= 0 ? static_cast<uintptr_t>(fd) + 1 : 0;
+    return true;
+}
+
+bool ProcfsProcessSource::IsAlive(uint32_t pid, uintptr_t handle, uint64_t startTime) {
+    if (handle != 0) {
+        return PidFdAlive(HandleToFd(handle));
+    }
+    uint64_t current;
+    return ReadProcessStartTime(pid, &current) && current == startTime;
+}
+
+bool ProcfsProcessSource::ExecutablePath(uint32_t pid, uintptr_t handle, std::string* path) {
+    (void)handle;
+    char link[32];
+    snprintf(link, sizeof(link), "/proc/%u/exe", pid);
+    char buffer[4096];
+    const ssize_t size = readlink(link, buffer, sizeof(buffer));
+    // 内核线程没有 exe；超长路径会被截断，视为失败
+    if (size <= 0 || static_cast<size_t>(size) >= sizeof(buffer)) {
+        return false;
+    }
+    path->assign(buffer, static_cast<size_t>(size));
+    return true;
+}
+
+void ProcfsProcessSource::Close(uintptr_t handle) {
+    if (handle != 0) {
+        close(HandleToFd(handle));
+    }
+}
+
+}  // namespace ztools
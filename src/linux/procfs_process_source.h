@@ -0,0 +1,27 @@
+// /proc 进程信息源（ProcessInfoCache 的 Linux 实现）
+//
+// 启动时间取 /proc/<pid>/stat 第 22 字段（starttime，开机后的时钟节拍数），路径取
+// /proc/<pid>/exe 链接目标。内核支持 pidfd_open（5.3+）时条目持有 pidfd，存活检查只需一次
+// poll，且 pidfd 始终指向打开时的那个进程；否则回退为重新读取 stat 比较启动时间。
+// 僵尸进程（已退出、未被回收）视为已退出。
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "../common/process_info_cache.h"
+
+namespace ztools {
+
+class ProcfsProcessSource : public ProcessInfoSource {
+public:
+    bool Open(uint32_t pid, uintptr_t* handle, uint64_t* startTime) override;
+    bool IsAlive(uint32_t pid, uintptr_t handle, uint64_t startTime) override;
+    bool ExecutablePath(uint32_t pid, uintptr_t handle, std::string* path) override;
+    void Close(uintptr_t handle) override;
+};
+
+// 读取 /proc/<pid>/stat 中的启动时间；进程不存在或为僵尸进程返回 false
+bool ReadProcessStartTime(uint32_t pid, uint64_t* startTime);
+
+}  // namespace ztools
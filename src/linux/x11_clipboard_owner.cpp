@@ -0,0 +1,372 @@
+#include "x11_clipboard_owner.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/Xproto.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+namespace ztools {
+
+namespace {
+
+inline Display* AsDisplay(void* display) {
+    return static_cast<Display*>(display);
+}
+
+// 请求方窗口可能在传输途中被销毁，此时写属性/发事件会产生 BadWindow。
+// Xlib 默认的错误处理会直接结束进程，这里只忽略这几类请求上的 BadWindow，其余交给原处理函数
+XErrorHandler g_previousErrorHandler = nullptr;
+
+int IgnoreVanishedRequestor(Display* display, XErrorEvent* error) {
+    if (error->error_code == BadWindow &&
+        (error->request_code == X_ChangeProperty || error->request_code == X_ChangeWindowAttributes ||
+         error->request_code == X_SendEvent)) {
+        return 0;
+    }
+    return g_previousErrorHandler != nullptr ? g_previousErrorHandler(display, error) : 0;
+}
+
+void InstallErrorHandler() {
+    static std::once_flag once;
+    std::call_once(once, []() { g_previousErrorHandler = XSetErrorHandler(IgnoreVanishedRequestor); });
+}
+
+}  // namespace
+
+struct X11ClipboardOwner::Transfer {
+    Window requestor = 0;
+    Atom property = 0;
+    Atom type = 0;
+    std::shared_ptr<const std::string> data;  // 渲染结果，提供者释放后仍保持有效
+    size_t offset = 0;
+};
+
+X11ClipboardOwner::X11ClipboardOwner(ClipboardSource source)
+    : source_(source),
+      display_(nullptr),
+      window_(0),
+      selection_(0),
+      targetsAtom_(0),
+      timestampAtom_(0),
+      multipleAtom_(0),
+      incrAtom_(0),
+      ownedSince_(0),
+      incrChunk_(0),
+      running_(false),
+      owns_(false),
+      requests_(0) {
+    wakeFds_[0] = -1;
+    wakeFds_[1] = -1;
+}
+
+X11ClipboardOwner::~X11ClipboardOwner() {
+    Stop();
+}
+
+bool X11ClipboardOwner::Start(const char* displayName) {
+    if (running_ || thread_.joinable()) {
+        SetError("X11 clipboard owner already started");
+        return false;
+    }
+
+    InstallErrorHandler();
+    Display* display = XOpenDisplay(displayName);
+    if (display == nullptr) {
+        SetError("Failed to open X display");
+        return false;
+    }
+    if (pipe(wakeFds_) != 0) {
+        XCloseDisplay(display);
+        SetError("Failed to create wake pipe");
+        return false;
+    }
+    fcntl(wakeFds_[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakeFds_[1], F_SETFL, O_NONBLOCK);
+
+    // 选区所有者窗口；PropertyChangeMask 用于获取服务器时间戳
+    Window window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 1, 1, 0, 0, 0);
+    XSelectInput(display, window, PropertyChangeMask);
+
+    display_ = display;
+    window_ = window;
+    selection_ = source_ == ClipboardSource::Primary ? XA_PRIMARY : XInternAtom(display, "CLIPBOARD", False);
+    targetsAtom_ = XInternAtom(display, "TARGETS", False);
+    timestampAtom_ = XInternAtom(display, "TIMESTAMP", False);
+    multipleAtom_ = XInternAtom(display, "MULTIPLE", False);
+    incrAtom_ = XInternAtom(display, "INCR", False);
+    if (incrChunk_ == 0) {
+        // 单次 ChangeProperty 不能超过服务器最大请求长度（以 4 字节为单位），预留请求头
+        incrChunk_ = static_cast<size_t>(XMaxRequestSize(display)) * 4 - 64;
+    }
+    XSync(display, False);
+
+    running_ = true;
+    thread_ = std::thread(&X11ClipboardOwner::Run, this);
+    return true;
+}
+
+void X11ClipboardOwner::Stop() {
+    running_ = false;
+    Wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    for (int i = 0; i < 2; i++) {
+        if (wakeFds_[i] >= 0) {
+            close(wakeFds_[i]);
+            wakeFds_[i] = -1;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (display_ != nullptr) {
+        // 销毁窗口即放弃选区所有权
+        XDestroyWindow(AsDisplay(display_), window_);
+        XCloseDisplay(AsDisplay(display_));
+        display_ = nullptr;
+        window_ = 0;
+    }
+    transfers_.clear();
+    provider_.reset();
+    owns_ = false;
+}
+
+bool X11ClipboardOwner::Own(std::shared_ptr<ClipboardProvider> provider) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (display_ == nullptr) {
+            SetError("X11 clipboard owner is not started");
+            return false;
+        }
+        Display* display = AsDisplay(display_);
+
+        // ICCCM 要求以真实的服务器时间取得所有权，不能使用 CurrentTime
+        const Time time = ServerTime();
+        XSetSelectionOwner(display, selection_, window_, time);
+        if (XGetSelectionOwner(display, selection_) != window_) {
+            SetError("Failed to acquire X selection ownership");
+            return false;
+        }
+        provider_ = std::move(provider);
+        ownedSince_ = time;
+        owns_ = true;
+        XFlush(display);
+    }
+    // ServerTime 可能把其他事件读入 Xlib 队列，唤醒事件线程处理
+    Wake();
+    return true;
+}
+
+std::string X11ClipboardOwner::LastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+void X11ClipboardOwner::SetError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    lastError_ = error;
+}
+
+void X11ClipboardOwner::Wake() {
+    if (wakeFds_[1] >= 0) {
+        char byte = 1;
+        ssize_t written = write(wakeFds_[1], &byte, 1);
+        (void)written;
+    }
+}
+
+// 向自身窗口追加零长度属性，由 PropertyNotify 得到当前服务器时间
+unsigned long X11ClipboardOwner::ServerTime() {
+    Display* display = AsDisplay(display_);
+    Atom stamp = XInternAtom(display, "ZTOOLS_TIMESTAMP", False);
+    XChangeProperty(display, window_, stamp, XA_INTEGER, 8, PropModeAppend, nullptr, 0);
+
+    struct Match {
+        Window window;
+        Atom atom;
+    } match = {window_, stamp};
+    XEvent event;
+    XIfEvent(
+        display, &event,
+        [](Display*, XEvent* e, XPointer arg) -> Bool {
+            const Match* m = reinterpret_cast<const Match*>(arg);
+            return e->type == PropertyNotify && e->xproperty.window == m->window && e->xproperty.atom == m->atom;
+        },
+        reinterpret_cast<XPointer>(&match));
+    return event.xproperty.time;
+}
+
+void X11ClipboardOwner::Run() {
+    const int xfd = ConnectionNumber(AsDisplay(display_));
+    while (running_) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Display* display = AsDisplay(display_);
+            while (XPending(display) > 0) {
+                XEvent event;
+                XNextEvent(display, &event);
+                HandleEvent(&event);
+            }
+        }
+
+        if (!running_) {
+            break;
+        }
+
+        pollfd fds[2];
+        fds[0].fd = xfd;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = wakeFds_[0];
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+
+        int ready = poll(fds, 2, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents != 0) {
+            char buffer[16];
+            while (read(wakeFds_[0], buffer, sizeof(buffer)) > 0) {
+            }
+        }
+        if (fds[0].revents & (POLLERR | POLLHUP)) {
+            break;
+        }
+    }
+    running_ = false;
+}
+
+void X11ClipboardOwner::HandleEvent(void* event) {
+    XEvent* xevent = static_cast<XEvent*>(event);
+    Display* display = AsDisplay(display_);
+
+    if (xevent->type == SelectionRequest) {
+        HandleRequest(&xevent->xselectionrequest);
+    } else if (xevent->type == SelectionClear && xevent->xselectionclear.selection == selection_) {
+        // 其他客户端取得所有权：不再需要渲染任何格式
+        owns_ = false;
+        provider_.reset();
+    } else if (xevent->type == PropertyNotify && xevent->xproperty.state == PropertyDelete) {
+        // INCR：请求方删除属性表示已读取上一段
+        for (auto it = transfers_.begin(); it != transfers_.end(); ++it) {
+            Transfer& transfer = **it;
+            if (transfer.requestor != xevent->xproperty.window || transfer.property != xevent->xproperty.atom) {
+                continue;
+            }
+            const bool finished = transfer.offset == transfer.data->size();
+            SendChunk(transfer);
+            if (finished) {
+                const Window requestor = transfer.requestor;
+                transfers_.erase(it);
+                bool busy = std::any_of(transfers_.begin(), transfers_.end(),
+                                        [requestor](const std::unique_ptr<Transfer>& t) {
+                                            return t->requestor == requestor;
+                                        });
+                if (!busy) {
+                    XSelectInput(display, requestor, NoEventMask);
+                }
+                XFlush(display);
+            }
+            break;
+        }
+    }
+}
+
+void X11ClipboardOwner::HandleRequest(const void* request) {
+    const XSelectionRequestEvent* req = static_cast<const XSelectionRequestEvent*>(request);
+    Display* display = AsDisplay(display_);
+    requests_++;
+
+    // 旧式客户端可能不指定属性，按 ICCCM 使用目标原子
+    const Atom property = req->property != None ? req->property : req->target;
+
+    XSelectionEvent reply = {};
+    reply.type = SelectionNotify;
+    reply.display = display;
+    reply.requestor = req->requestor;
+    reply.selection = req->selection;
+    reply.target = req->target;
+    reply.time = req->time;
+    reply.property = property;
+
+    const bool valid = provider_ != nullptr && req->selection == selection_ &&
+                       (req->time == CurrentTime || req->time >= ownedSince_);
+    if (!valid) {
+        reply.property = None;
+    } else if (req->target == targetsAtom_) {
+        std::vector<Atom> atoms = {targetsAtom_, timestampAtom_};
+        for (const std::string& format : provider_->Formats()) {
+            atoms.push_back(XInternAtom(display, format.c_str(), False));
+        }
+        XChangeProperty(display, req->requestor, property, XA_ATOM, 32, PropModeReplace,
+                        reinterpret_cast<const unsigned char*>(atoms.data()), static_cast<int>(atoms.size()));
+    } else if (req->target == timestampAtom_) {
+        long time = static_cast<long>(ownedSince_);
+        XChangeProperty(display, req->requestor, property, XA_INTEGER, 32, PropModeReplace,
+                        reinterpret_cast<const unsigned char*>(&time), 1);
+    } else if (req->target == multipleAtom_ || !ServeTarget(req->requestor, property, req->target)) {
+        // MULTIPLE 暂不支持，请求方会逐个目标重试
+        reply.property = None;
+    }
+
+    XSendEvent(display, req->requestor, False, NoEventMask, reinterpret_cast<XEvent*>(&reply));
+    XFlush(display);
+}
+
+// 渲染在事件线程内同步进行：X 协议要求在应答前准备好数据，请求方本就在等待
+bool X11ClipboardOwner::ServeTarget(unsigned long requestor, unsigned long property, unsigned long target) {
+    Display* display = AsDisplay(display_);
+    char* name = XGetAtomName(display, target);
+    if (name == nullptr) {
+        return false;
+    }
+    std::string format(name);
+    XFree(name);
+
+    std::shared_ptr<const std::string> data = provider_->Render(format);
+    if (data == nullptr) {
+        return false;
+    }
+
+    if (data->size() <= incrChunk_) {
+        XChangeProperty(display, requestor, property, target, 8, PropModeReplace,
+                        reinterpret_cast<const unsigned char*>(data->data()), static_cast<int>(data->size()));
+        return true;
+    }
+
+    // INCR：先告知总大小，之后每次请求方删除属性时发送一段，最后发送长度为 0 的段
+    std::unique_ptr<Transfer> transfer(new Transfer());
+    transfer->requestor = requestor;
+    transfer->property = property;
+    transfer->type = target;
+    transfer->data = std::move(data);
+    XSelectInput(display, requestor, PropertyChangeMask);
+    long size = static_cast<long>(transfer->data->size());
+    XChangeProperty(display, requestor, property, incrAtom_, 32, PropModeReplace,
+                    reinterpret_cast<const unsigned char*>(&size), 1);
+    transfers_.push_back(std::move(transfer));
+    return true;
+}
+
+void X11ClipboardOwner::SendChunk(Transfer& transfer) {
+    Display* display = AsDisplay(display_);
+    const size_t remaining = transfer.data->size() - transfer.offset;
+    const size_t chunk = std::min(remaining, incrChunk_);
+    XChangeProperty(display, transfer.requestor, transfer.property, transfer.type, 8, PropModeReplace,
+                    reinterpret_cast<const unsigned char*>(transfer.data->data() + transfer.offset),
+                    static_cast<int>(chunk));
+    transfer.offset += chunk;
+    XFlush(display);
+}
+
+}  // namespace ztools
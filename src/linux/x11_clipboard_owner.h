@@ -0,0 +1,88 @@
+// X11 选区所有者（ClipboardProvider 的 Linux 发布端）
+//
+// 持有 CLIPBOARD/PRIMARY 选区，只在 TARGETS 中声明提供者的格式；其他客户端发出
+// SelectionRequest 时才调用提供者渲染对应目标，超过单次请求上限的数据以 INCR 分段发送。
+// 在独立线程中以 poll() 阻塞等待 X 连接与唤醒管道。失去所有权（SelectionClear）后
+// 释放对提供者的引用，已开始的 INCR 传输仍会完成。
+// 不依赖 N-API，可在 Xvfb 下直接测试。
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common/clipboard_change_detector.h"
+#include "../common/clipboard_provider.h"
+
+namespace ztools {
+
+class X11ClipboardOwner {
+public:
+    explicit X11ClipboardOwner(ClipboardSource source = ClipboardSource::Clipboard);
+    ~X11ClipboardOwner();
+
+    X11ClipboardOwner(const X11ClipboardOwner&) = delete;
+    X11ClipboardOwner& operator=(const X11ClipboardOwner&) = delete;
+
+    // 连接 X 服务器并启动事件线程；displayName 为空时使用 $DISPLAY
+    bool Start(const char* displayName = nullptr);
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // 取得选区所有权并以 provider 的格式名作为目标原子名；此时不渲染任何数据
+    bool Own(std::shared_ptr<ClipboardProvider> provider);
+    // 是否仍持有选区（其他客户端取得所有权后变为 false）
+    bool Owns() const { return owns_; }
+
+    // 已应答的 SelectionRequest 数（含 TARGETS）
+    uint64_t Requests() const { return requests_; }
+
+    // INCR 单段大小（默认按服务器最大请求长度计算）
+    void SetIncrChunk(size_t bytes) { incrChunk_ = bytes; }
+
+    std::string LastError() const;
+
+private:
+    struct Transfer;
+
+    void Run();
+    void Wake();
+    // 以下函数在 mutex_ 内调用
+    void HandleEvent(void* event);  // XEvent*
+    void HandleRequest(const void* request);  // XSelectionRequestEvent*
+    bool ServeTarget(unsigned long requestor, unsigned long property, unsigned long target);
+    void SendChunk(Transfer& transfer);
+    unsigned long ServerTime();
+    void SetError(const std::string& error);
+
+    ClipboardSource source_;
+    void* display_;  // Display*
+    unsigned long window_;
+    unsigned long selection_;
+    unsigned long targetsAtom_;
+    unsigned long timestampAtom_;
+    unsigned long multipleAtom_;
+    unsigned long incrAtom_;
+    unsigned long ownedSince_;
+    size_t incrChunk_;
+    int wakeFds_[2];
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> owns_;
+    std::atomic<uint64_t> requests_;
+
+    std::mutex mutex_;  // 两个线程共用同一连接，所有 Xlib 调用都在锁内进行
+    std::shared_ptr<ClipboardProvider> provider_;
+    std::vector<std::unique_ptr<Transfer>> transfers_;
+
+    mutable std::mutex errorMutex_;
+    std::string lastError_;
+};
+
+}  // namespace ztools
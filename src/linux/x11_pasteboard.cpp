@@ -0,0 +1,431 @@
+#include "x11_pasteboard.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/extensions/Xfixes.h>
+#include <poll.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace ztools {
+
+namespace {
+
+int64_t SteadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+inline Display* AsDisplay(void* display) {
+    return static_cast<Display*>(display);
+}
+
+// 只描述选区本身、不携带内容的目标
+bool IsMetaTarget(const char* name) {
+    static const char* const kMeta[] = {"TARGETS", "MULTIPLE", "TIMESTAMP", "SAVE_TARGETS", "DELETE", "INCR"};
+    for (const char* meta : kMeta) {
+        if (strcmp(name, meta) == 0) return true;
+    }
+    return false;
+}
+
+// ISO-8859-1（STRING 目标）转 UTF-8
+std::string Latin1ToUtf8(const std::string& latin1) {
+    std::string result;
+    result.reserve(latin1.size());
+    for (unsigned char c : latin1) {
+        if (c < 0x80) {
+            result.push_back(static_cast<char>(c));
+        } else {
+            result.push_back(static_cast<char>(0xC0 | (c >> 6)));
+            result.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+    return result;
+}
+
+}  // namespace
+
+X11Pasteboard::X11Pasteboard(ClipboardSource source)
+    : source_(source),
+      display_(nullptr),
+      window_(0),
+      selection_(0),
+      property_(0),
+      xfixesEventBase_(-1),
+      timeoutMs_(1000),
+      changes_(0) {}
+
+X11Pasteboard::~X11Pasteboard() {
+    Close();
+}
+
+bool X11Pasteboard::Open(const char* displayName) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (display_ != nullptr) {
+        return true;
+    }
+
+    Display* display = XOpenDisplay(displayName);
+    if (display == nullptr) {
+        SetError("Failed to open X display");
+        return false;
+    }
+
+    // 仅用于接收选区数据的不可见窗口；INCR 传输依赖属性变化事件
+    Window window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 1, 1, 0, 0, 0);
+    XSelectInput(display, window, PropertyChangeMask);
+
+    display_ = display;
+    window_ = window;
+    selection_ = source_ == ClipboardSource::Primary ? XA_PRIMARY : XInternAtom(display, "CLIPBOARD", False);
+    property_ = XInternAtom(display, "ZTOOLS_SELECTION", False);
+    changes_ = 0;
+
+    // XFixes 可选：不可用时 ChangeCount 返回 0，调用方绕过按序列号的缓存
+    int errorBase = 0;
+    xfixesEventBase_ = -1;
+    if (XFixesQueryExtension(display, &xfixesEventBase_, &errorBase)) {
+        XFixesSelectSelectionInput(display, window, selection_,
+                                   XFixesSetSelectionOwnerNotifyMask |
+                                       XFixesSelectionWindowDestroyNotifyMask |
+                                       XFixesSelectionClientCloseNotifyMask);
+    } else {
+        xfixesEventBase_ = -1;
+    }
+    XSync(display, False);
+    return true;
+}
+
+void X11Pasteboard::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (display_ == nullptr) {
+        return;
+    }
+    XDestroyWindow(AsDisplay(display_), window_);
+    XCloseDisplay(AsDisplay(display_));
+    display_ = nullptr;
+    window_ = 0;
+}
+
+std::string X11Pasteboard::LastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+void X11Pasteboard::SetError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    lastError_ = error;
+}
+
+unsigned long X11Pasteboard::Intern(const char* name) {
+    return XInternAtom(AsDisplay(display_), name, False);
+}
+
+// 处理一个与当前转换无关的事件：只统计选区所有者变化
+bool X11Pasteboard::CountChange(const void* event) {
+    const XEvent* xevent = static_cast<const XEvent*>(event);
+    if (xfixesEventBase_ >= 0 && xevent->type == xfixesEventBase_ + XFixesSelectionNotify) {
+        changes_++;
+        return true;
+    }
+    return false;
+}
+
+void X11Pasteboard::DrainEvents() {
+    Display* display = AsDisplay(display_);
+    while (XPending(display) > 0) {
+        XEvent event;
+        XNextEvent(display, &event);
+        CountChange(&event);
+    }
+}
+
+bool X11Pasteboard::WaitForEvent(int type, int64_t deadlineMs, void* out) {
+    Display* display = AsDisplay(display_);
+    XEvent* event = static_cast<XEvent*>(out);
+    for (;;) {
+        // 先处理 Xlib 已缓冲的事件，再阻塞等待连接上的新数据
+        while (XPending(display) > 0) {
+            XNextEvent(display, event);
+            if (CountChange(event)) {
+                continue;
+            }
+            if (event->type != type || event->xany.window != window_) {
+                continue;
+            }
+            if (type == PropertyNotify &&
+                (event->xproperty.atom != property_ || event->xproperty.state != PropertyNewValue)) {
+                continue;
+            }
+            return true;
+        }
+
+        int64_t remaining = deadlineMs - SteadyNowMs();
+        if (remaining <= 0) {
+            return false;
+        }
+        pollfd fd;
+        fd.fd = ConnectionNumber(display);
+        fd.events = POLLIN;
+        fd.revents = 0;
+        int ready = poll(&fd, 1, static_cast<int>(remaining));
+        if (ready < 0 && errno != EINTR) {
+            return false;
+        }
+        if (fd.revents & (POLLERR | POLLHUP)) {
+            return false;
+        }
+    }
+}
+
+bool X11Pasteboard::ReadPropertyLocked(std::string& data, unsigned long* actualType, bool* incr) {
+    Display* display = AsDisplay(display_);
+    Atom type = None;
+    int format = 0;
+    unsigned long items = 0;
+    unsigned long bytesAfter = 0;
+    unsigned char* value = nullptr;
+
+    // 先取长度，再一次性读出并删除属性（删除也是 INCR 协议中请求下一段的信号）
+    if (XGetWindowProperty(display, window_, property_, 0, 0, False, AnyPropertyType, &type, &format, &items,
+                           &bytesAfter, &value) != Success) {
+        return false;
+    }
+    if (value != nullptr) {
+        XFree(value);
+        value = nullptr;
+    }
+    if (type == None) {
+        return false;
+    }
+
+    const long length = static_cast<long>((bytesAfter + 3) / 4);
+    if (XGetWindowProperty(display, window_, property_, 0, length, True, AnyPropertyType, &type, &format, &items,
+                           &bytesAfter, &value) != Success) {
+        return false;
+    }
+
+    if (actualType != nullptr) {
+        *actualType = type;
+    }
+    *incr = type == Intern("INCR");
+    if (!*incr && value != nullptr) {
+        if (format == 32) {
+            // 32 位格式在客户端内存中以 long 存放
+            const unsigned long* longs = reinterpret_cast<const unsigned long*>(value);
+            for (unsigned long i = 0; i < items; i++) {
+                uint32_t item = static_cast<uint32_t>(longs[i]);
+                data.append(reinterpret_cast<const char*>(&item), sizeof(item));
+            }
+        } else {
+            data.append(reinterpret_cast<const char*>(value), items * (format / 8));
+        }
+    }
+    if (value != nullptr) {
+        XFree(value);
+    }
+    return true;
+}
+
+bool X11Pasteboard::ConvertLocked(unsigned long target, std::string& data, unsigned long* actualType,
+                                  bool* supported) {
+    *supported = false;
+    data.clear();
+    if (display_ == nullptr) {
+        SetError("X11 pasteboard is not open");
+        return false;
+    }
+
+    Display* display = AsDisplay(display_);
+    const int64_t deadline = SteadyNowMs() + timeoutMs_;
+    XDeleteProperty(display, window_, property_);
+    XConvertSelection(display, selection_, target, property_, window_, CurrentTime);
+    XFlush(display);
+
+    XEvent event;
+    if (!WaitForEvent(SelectionNotify, deadline, &event)) {
+        SetError("Timed out waiting for selection owner");
+        return false;
+    }
+    // 没有所有者或所有者不支持该目标
+    if (event.xselection.property == None) {
+        return true;
+    }
+
+    bool incr = false;
+    if (!ReadPropertyLocked(data, actualType, &incr)) {
+        return true;
+    }
+    if (incr) {
+        // INCR：每删除一次属性，所有者写入下一段；长度为 0 的段表示结束
+        for (;;) {
+            XFlush(display);
+            if (!WaitForEvent(PropertyNotify, deadline, &event)) {
+                data.clear();
+                SetError("Timed out during INCR transfer");
+                return false;
+            }
+            const size_t before = data.size();
+            bool nested = false;
+            if (!ReadPropertyLocked(data, actualType, &nested)) {
+                continue;
+            }
+            if (data.size() == before) {
+                break;
+            }
+        }
+    }
+    *supported = true;
+    return true;
+}
+
+bool X11Pasteboard::ReadTargetsLocked(std::vector<unsigned long>& targets) {
+    targets.clear();
+    std::string data;
+    bool supported = false;
+    if (!ConvertLocked(Intern("TARGETS"), data, nullptr, &supported)) {
+        return false;
+    }
+    const uint32_t* atoms = reinterpret_cast<const uint32_t*>(data.data());
+    for (size_t i = 0; i < data.size() / sizeof(uint32_t); i++) {
+        targets.push_back(atoms[i]);
+    }
+    return true;
+}
+
+bool X11Pasteboard::ReadTargets(std::vector<std::string>& targets) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    targets.clear();
+    std::vector<unsigned long> atoms;
+    if (!ReadTargetsLocked(atoms)) {
+        return false;
+    }
+    for (unsigned long atom : atoms) {
+        char* name = XGetAtomName(AsDisplay(display_), atom);
+        if (name == nullptr) {
+            continue;
+        }
+        if (!IsMetaTarget(name)) {
+            targets.push_back(name);
+        }
+        XFree(name);
+    }
+    return true;
+}
+
+bool X11Pasteboard::ReadTarget(const std::string& target, std::string& data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (display_ == nullptr) {
+        SetError("X11 pasteboard is not open");
+        return false;
+    }
+    bool supported = false;
+    return ConvertLocked(Intern(target.c_str()), data, nullptr, &supported) && supported;
+}
+
+uint64_t X11Pasteboard::ChangeCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (display_ == nullptr || xfixesEventBase_ < 0) {
+        return 0;
+    }
+    DrainEvents();
+    // 变化计数从 0 开始，偏移后保证非 0
+    return changes_ + 1;
+}
+
+bool X11Pasteboard::ReadText(std::string& text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    text.clear();
+    if (display_ == nullptr) {
+        SetError("X11 pasteboard is not open");
+        return false;
+    }
+
+    // 按偏好依次尝试；多数所有者直接支持 UTF8_STRING，只需一次往返
+    static const char* const kUtf8Targets[] = {"UTF8_STRING", "text/plain;charset=utf-8"};
+    bool supported = false;
+    for (const char* target : kUtf8Targets) {
+        if (!ConvertLocked(Intern(target), text, nullptr, &supported)) {
+            return false;
+        }
+        if (supported) {
+            return true;
+        }
+    }
+    std::string latin1;
+    if (!ConvertLocked(XA_STRING, latin1, nullptr, &supported)) {
+        return false;
+    }
+    text = Latin1ToUtf8(latin1);
+    return true;
+}
+
+bool X11Pasteboard::ReadFiles(std::vector<std::string>& paths) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    paths.clear();
+    std::string uriList;
+    bool supported = false;
+    if (!ConvertLocked(Intern("text/uri-list"), uriList, nullptr, &supported)) {
+        return false;
+    }
+    paths = ParseUriList(uriList);
+    return true;
+}
+
+bool X11Pasteboard::ReadImagePng(std::string& png) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool supported = false;
+    return ConvertLocked(Intern("image/png"), png, nullptr, &supported);
+}
+
+bool X11Pasteboard::Save(PasteboardSnapshot& snapshot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot.items.clear();
+    std::vector<unsigned long> targets;
+    if (!ReadTargetsLocked(targets)) {
+        return false;
+    }
+
+    // X11 选区没有多 item 概念，全部目标放在同一个 item 中
+    PasteboardItem item;
+    for (unsigned long target : targets) {
+        char* name = XGetAtomName(AsDisplay(display_), target);
+        if (name == nullptr) {
+            continue;
+        }
+        std::string type(name);
+        XFree(name);
+        if (IsMetaTarget(type.c_str())) {
+            continue;
+        }
+        PasteboardEntry entry;
+        entry.type = std::move(type);
+        bool supported = false;
+        if (!ConvertLocked(target, entry.data, nullptr, &supported)) {
+            return false;
+        }
+        if (supported) {
+            item.entries.push_back(std::move(entry));
+        }
+    }
+    if (!item.entries.empty()) {
+        snapshot.items.push_back(std::move(item));
+    }
+    return true;
+}
+
+bool X11Pasteboard::Restore(const PasteboardSnapshot&) {
+    SetError("Writing X11 selections requires owning the selection");
+    return false;
+}
+
+bool X11Pasteboard::Clear() {
+    SetError("Writing X11 selections requires owning the selection");
+    return false;
+}
+
+}  // namespace ztools
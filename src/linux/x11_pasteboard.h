@@ -0,0 +1,75 @@
+// X11 选区读取（Pasteboard 接口的 Linux 实现）
+//
+// 在私有窗口上以 XConvertSelection 向选区所有者请求数据，支持 INCR 分段传输，
+// 不启动 xclip/xsel 等外部进程。变化计数来自 XFixes 所有者变化事件。
+// 写入需要持有选区并响应 SelectionRequest，暂不支持（Restore/Clear 返回 false）。
+// 不依赖 N-API，可在 Xvfb 下直接测试与基准。
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../common/clipboard_change_detector.h"
+#include "../common/pasteboard.h"
+
+namespace ztools {
+
+class X11Pasteboard : public Pasteboard {
+public:
+    explicit X11Pasteboard(ClipboardSource source = ClipboardSource::Clipboard);
+    ~X11Pasteboard() override;
+
+    X11Pasteboard(const X11Pasteboard&) = delete;
+    X11Pasteboard& operator=(const X11Pasteboard&) = delete;
+
+    // 连接 X 服务器并创建接收数据的窗口；displayName 为空时使用 $DISPLAY
+    bool Open(const char* displayName = nullptr);
+    void Close();
+    bool IsOpen() const { return display_ != nullptr; }
+
+    // 单次选区转换（含 INCR 全部分段）的超时
+    void SetTimeoutMs(int timeoutMs) { timeoutMs_ = timeoutMs; }
+
+    // 当前所有者提供的目标（已排除 TARGETS/MULTIPLE/TIMESTAMP 等元目标）
+    bool ReadTargets(std::vector<std::string>& targets);
+    // 按目标名读取原始数据；所有者不支持该目标时返回 false
+    bool ReadTarget(const std::string& target, std::string& data);
+
+    uint64_t ChangeCount() override;
+    bool ReadText(std::string& text) override;
+    bool ReadFiles(std::vector<std::string>& paths) override;
+    bool ReadImagePng(std::string& png) override;
+    bool Save(PasteboardSnapshot& snapshot) override;
+    bool Restore(const PasteboardSnapshot& snapshot) override;
+    bool Clear() override;
+
+    std::string LastError() const;
+
+private:
+    unsigned long Intern(const char* name);
+    bool CountChange(const void* event);  // XEvent*
+    void DrainEvents();
+    bool WaitForEvent(int type, int64_t deadlineMs, void* out);  // out: XEvent*
+    // supported 为 false 表示没有所有者或所有者不支持该目标；超时等错误返回 false
+    bool ConvertLocked(unsigned long target, std::string& data, unsigned long* actualType, bool* supported);
+    bool ReadPropertyLocked(std::string& data, unsigned long* actualType, bool* incr);
+    bool ReadTargetsLocked(std::vector<unsigned long>& targets);
+    void SetError(const std::string& error);
+
+    ClipboardSource source_;
+    void* display_;  // Display*
+    unsigned long window_;
+    unsigned long selection_;
+    unsigned long property_;
+    int xfixesEventBase_;
+    int timeoutMs_;
+    uint64_t changes_;
+
+    std::mutex mutex_;  // 同一连接上的转换必须串行
+    mutable std::mutex errorMutex_;
+    std::string lastError_;
+};
+
+}  // namespace ztools
@@ -0,0 +1,81 @@
+#include "x11_selected_content.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace ztools {
+
+namespace {
+
+int64_t SteadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+bool HasTarget(const std::vector<std::string>& targets, const char* name) {
+    return std::find(targets.begin(), targets.end(), name) != targets.end();
+}
+
+// 把剩余时间设为下一次转换的超时；已超时返回 false
+bool ArmTimeout(X11Pasteboard& primary, int64_t deadlineMs) {
+    const int64_t remaining = deadlineMs - SteadyNowMs();
+    if (remaining <= 0) {
+        return false;
+    }
+    primary.SetTimeoutMs(static_cast<int>(remaining));
+    return true;
+}
+
+}  // namespace
+
+bool ReadSelectedContent(X11Pasteboard& primary, int timeoutMs, X11SelectedContent& out) {
+    out = X11SelectedContent();
+    const int64_t deadline = SteadyNowMs() + std::max(timeoutMs, 1);
+
+    std::vector<std::string> targets;
+    if (!ArmTimeout(primary, deadline) || !primary.ReadTargets(targets)) {
+        return false;
+    }
+
+    // 只转换所有者声明的目标，UTF-8 目标直接读取，避免逐个试探的往返
+    std::string text;
+    bool readText = false;
+    if (HasTarget(targets, "UTF8_STRING") || HasTarget(targets, "text/plain;charset=utf-8")) {
+        const char* target = HasTarget(targets, "UTF8_STRING") ? "UTF8_STRING" : "text/plain;charset=utf-8";
+        if (!ArmTimeout(primary, deadline)) {
+            return false;
+        }
+        readText = primary.ReadTarget(target, text);
+    } else if (targets.empty() || HasTarget(targets, "STRING") || HasTarget(targets, "TEXT")) {
+        // 未实现 TARGETS 的旧程序也会得到空列表，按 Latin-1 STRING 回退读取
+        if (!ArmTimeout(primary, deadline)) {
+            return false;
+        }
+        readText = primary.ReadText(text);
+    }
+    // ReadTarget 对不支持的目标与超时都返回 false，以截止时间区分
+    if (!readText && SteadyNowMs() >= deadline) {
+        return false;
+    }
+    if (readText && !text.empty()) {
+        out.hasText = true;
+        out.text = std::move(text);
+    }
+
+    if (HasTarget(targets, "text/uri-list")) {
+        std::string uriList;
+        if (!ArmTimeout(primary, deadline)) {
+            return false;
+        }
+        if (primary.ReadTarget("text/uri-list", uriList)) {
+            out.files = ParseUriList(uriList);
+            out.hasFiles = !out.files.empty();
+        } else if (SteadyNowMs() >= deadline) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace ztools
@@ -0,0 +1,30 @@
+// X11 选中内容读取（getSelectedContent 的 Linux 后端）
+//
+// X11 下选中文本即成为 PRIMARY 选区，无需像 Windows/macOS 那样模拟复制并保存/恢复剪贴板：
+// 一次 TARGETS 往返确定所有者提供的目标，再只转换需要的文本与 text/uri-list。
+// 全程不触碰 CLIPBOARD，剪贴板监控与历史看不到任何变化，也没有恢复失败丢失用户数据的风险。
+// 不依赖 N-API，可在 Xvfb 下直接测试与基准。
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "x11_pasteboard.h"
+
+namespace ztools {
+
+// 选区所有者通常在同一台机器上，正常往返在 1ms 以内；超时只用于防止所有者无响应时卡住调用方
+static const int kDefaultSelectedContentTimeoutMs = 100;
+
+struct X11SelectedContent {
+    bool hasText = false;
+    std::string text;  // UTF-8
+    bool hasFiles = false;
+    std::vector<std::string> files;
+};
+
+// 从 PRIMARY 选区读取选中内容；primary 需以 ClipboardSource::Primary 打开，
+// timeoutMs 为全部转换的总时长上限。没有选区所有者时返回 true 且内容为空，超时或连接错误返回 false
+bool ReadSelectedContent(X11Pasteboard& primary, int timeoutMs, X11SelectedContent& out);
+
+}  // namespace ztools
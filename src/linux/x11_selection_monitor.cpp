@@ -0,0 +1,207 @@
+#include "x11_selection_monitor.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <X11/extensions/Xfixes.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+namespace ztools {
+
+X11SelectionMonitor::X11SelectionMonitor()
+    : running_(false), startDone_(false), startOk_(false) {
+    wakeFds_[0] = -1;
+    wakeFds_[1] = -1;
+    for (int i = 0; i < kClipboardSourceCount; i++) {
+        sequence_[i] = 0;
+        selectionTime_[i] = 0;
+    }
+}
+
+X11SelectionMonitor::~X11SelectionMonitor() {
+    Stop();
+}
+
+bool X11SelectionMonitor::Start(Callback callback, const char* displayName) {
+    if (running_ || thread_.joinable()) {
+        FinishStart(false, "X11 selection monitor already started");
+        return false;
+    }
+
+    if (pipe(wakeFds_) != 0) {
+        FinishStart(false, "Failed to create wake pipe");
+        return false;
+    }
+    fcntl(wakeFds_[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakeFds_[1], F_SETFL, O_NONBLOCK);
+
+    for (int i = 0; i < kClipboardSourceCount; i++) {
+        sequence_[i] = 0;
+        selectionTime_[i] = 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(startMutex_);
+        startDone_ = false;
+        startOk_ = false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&X11SelectionMonitor::Run, this, std::move(callback),
+                          std::string(displayName != nullptr ? displayName : ""));
+
+    // 等待线程完成 X 连接与订阅，保证 Start 返回后不会漏掉任何变化
+    bool ok;
+    {
+        std::unique_lock<std::mutex> lock(startMutex_);
+        startCv_.wait(lock, [this]() { return startDone_; });
+        ok = startOk_;
+    }
+
+    if (!ok) {
+        Stop();
+    }
+    return ok;
+}
+
+void X11SelectionMonitor::Stop() {
+    running_ = false;
+
+    if (wakeFds_[1] >= 0) {
+        char byte = 1;
+        ssize_t written = write(wakeFds_[1], &byte, 1);
+        (void)written;
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    for (int i = 0; i < 2; i++) {
+        if (wakeFds_[i] >= 0) {
+            close(wakeFds_[i]);
+            wakeFds_[i] = -1;
+        }
+    }
+}
+
+uint64_t X11SelectionMonitor::Sequence(ClipboardSource source) const {
+    return sequence_[static_cast<int>(source)];
+}
+
+uint64_t X11SelectionMonitor::SelectionTime(ClipboardSource source) const {
+    return selectionTime_[static_cast<int>(source)];
+}
+
+std::string X11SelectionMonitor::LastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return lastError_;
+}
+
+void X11SelectionMonitor::FinishStart(bool ok, const std::string& error) {
+    if (!ok) {
+        std::lock_guard<std::mutex> lock(errorMutex_);
+        lastError_ = error;
+    }
+    {
+        std::lock_guard<std::mutex> lock(startMutex_);
+        startDone_ = true;
+        startOk_ = ok;
+    }
+    startCv_.notify_all();
+}
+
+void X11SelectionMonitor::Run(Callback callback, std::string displayName) {
+    Display* display = XOpenDisplay(displayName.empty() ? nullptr : displayName.c_str());
+    if (display == nullptr) {
+        running_ = false;
+        FinishStart(false, "Failed to open X display");
+        return;
+    }
+
+    int eventBase = 0;
+    int errorBase = 0;
+    if (!XFixesQueryExtension(display, &eventBase, &errorBase)) {
+        XCloseDisplay(display);
+        running_ = false;
+        FinishStart(false, "XFixes extension is not available");
+        return;
+    }
+
+    // 仅用于接收事件的不可见窗口
+    Window window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 1, 1, 0, 0, 0);
+
+    Atom clipboardAtom = XInternAtom(display, "CLIPBOARD", False);
+    const Atom selections[kClipboardSourceCount] = {clipboardAtom, XA_PRIMARY};
+    const unsigned long mask = XFixesSetSelectionOwnerNotifyMask |
+                               XFixesSelectionWindowDestroyNotifyMask |
+                               XFixesSelectionClientCloseNotifyMask;
+    for (int i = 0; i < kClipboardSourceCount; i++) {
+        XFixesSelectSelectionInput(display, window, selections[i], mask);
+    }
+    XSync(display, False);
+
+    FinishStart(true, "");
+
+    const int xfd = ConnectionNumber(display);
+    while (running_) {
+        // 先处理已缓冲的事件，再阻塞等待新数据，避免事件滞留在 Xlib 队列中
+        while (XPending(display) > 0) {
+            XEvent event;
+            XNextEvent(display, &event);
+            if (event.type != eventBase + XFixesSelectionNotify) {
+                continue;
+            }
+
+            const XFixesSelectionNotifyEvent* notify =
+                reinterpret_cast<const XFixesSelectionNotifyEvent*>(&event);
+            for (int i = 0; i < kClipboardSourceCount; i++) {
+                if (notify->selection != selections[i]) {
+                    continue;
+                }
+                // 同一毫秒内可能发生多次所有者变化，序列号使用单调计数而非时间戳
+                const uint64_t sequence = ++sequence_[i];
+                selectionTime_[i] = notify->selection_timestamp;
+                if (callback) {
+                    callback(static_cast<ClipboardSource>(i), sequence, notify->selection_timestamp);
+                }
+                break;
+            }
+        }
+
+        if (!running_) {
+            break;
+        }
+
+        pollfd fds[2];
+        fds[0].fd = xfd;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = wakeFds_[0];
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+
+        int ready = poll(fds, 2, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (fds[1].revents != 0) {
+            break;
+        }
+        if (fds[0].revents & (POLLERR | POLLHUP)) {
+            break;
+        }
+    }
+
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+    running_ = false;
+}
+
+}  // namespace ztools
@@ -0,0 +1,65 @@
+// X11 选区变化监控（XFixes 事件驱动）
+//
+// 通过 XFixesSelectSelectionInput 订阅 CLIPBOARD/PRIMARY 的所有者变化，
+// 在独立线程中以 poll() 阻塞等待 X 连接与唤醒管道，无任何轮询唤醒。
+// 不依赖 N-API，可在 Xvfb 下直接测试与基准。
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../common/clipboard_change_detector.h"
+
+namespace ztools {
+
+class X11SelectionMonitor {
+public:
+    // source: 变化的选区；sequence: 该选区的单调变化计数；selectionTime: X 服务器选区时间戳
+    using Callback = std::function<void(ClipboardSource source, uint64_t sequence, uint64_t selectionTime)>;
+
+    X11SelectionMonitor();
+    ~X11SelectionMonitor();
+
+    X11SelectionMonitor(const X11SelectionMonitor&) = delete;
+    X11SelectionMonitor& operator=(const X11SelectionMonitor&) = delete;
+
+    // 启动监控线程；displayName 为空时使用 $DISPLAY。
+    // 在 X 连接与 XFixes 订阅完成后才返回，失败时返回 false 并可通过 LastError 获取原因
+    bool Start(Callback callback, const char* displayName = nullptr);
+    void Stop();
+    bool IsRunning() const { return running_; }
+
+    // 某个选区最近一次的变化计数（监控未运行时为 0）
+    uint64_t Sequence(ClipboardSource source) const;
+
+    // 某个选区最近一次变化的 X 服务器时间戳
+    uint64_t SelectionTime(ClipboardSource source) const;
+
+    std::string LastError() const;
+
+private:
+    void Run(Callback callback, std::string displayName);
+    void FinishStart(bool ok, const std::string& error);
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> sequence_[kClipboardSourceCount];
+    std::atomic<uint64_t> selectionTime_[kClipboardSourceCount];
+    int wakeFds_[2];
+
+    // 启动握手：线程完成初始化后通知 Start 返回
+    std::mutex startMutex_;
+    std::condition_variable startCv_;
+    bool startDone_;
+    bool startOk_;
+
+    mutable std::mutex errorMutex_;
+    std::string lastError_;
+};
+
+}  // namespace ztools
@@ -0,0 +1,177 @@
+// AppxManifest 解析基准：模拟 getUwpApps 枚举 300 个包
+//
+// 旧：manifest 整体转为 UTF-16，每个 Application 用 find + substr 复制出块，再为每个属性
+//     拼接 "<" + tag、复制整段标签，uap: 前缀与无前缀各查一遍，最后解码实体。
+// 新：在 UTF-8 字节上单遍扫描，只复制最终需要的属性值。
+#include "test-util.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "common/appx_manifest.h"
+#include "common/utf_transcode.h"
+
+namespace {
+
+std::string ReadFixture(const char* name) {
+    std::string path = __FILE__;
+    path = path.substr(0, path.find_last_of('/') + 1) + "fixtures/appx/" + name;
+    std::string data;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return data;
+    }
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, n);
+    }
+    fclose(file);
+    return data;
+}
+
+// 以下为原 binding_windows.cpp 的实现（wstring 换成 u16string 以便在 Linux 上编译）
+typedef std::u16string WString;
+
+WString W(const char* ascii) {
+    WString s;
+    while (*ascii) s.push_back(static_cast<char16_t>(*ascii++));
+    return s;
+}
+
+WString OldDecodeXmlEntities(const WString& input) {
+    WString result;
+    result.reserve(input.size());
+    size_t i = 0;
+    while (i < input.size()) {
+        if (input[i] == u'&') {
+            size_t semi = input.find(u';', i + 1);
+            if (semi != WString::npos && semi - i < 12) {
+                WString entity = input.substr(i + 1, semi - i - 1);
+                if (entity == u"amp") {
+                    result += u'&';
+                } else if (entity == u"lt") {
+                    result += u'<';
+                } else if (entity == u"gt") {
+                    result += u'>';
+                } else if (entity == u"quot") {
+                    result += u'"';
+                } else if (entity.size() > 1 && entity[0] == u'#') {
+                    std::string digits(entity.begin() + 1, entity.end());
+                    unsigned long cp = digits[0] == 'x' ? strtoul(digits.c_str() + 1, nullptr, 16)
+                                                        : strtoul(digits.c_str(), nullptr, 10);
+                    result += static_cast<char16_t>(cp);
+                } else {
+                    result += input.substr(i, semi - i + 1);
+                }
+                i = semi + 1;
+                continue;
+            }
+        }
+        result += input[i];
+        i++;
+    }
+    return result;
+}
+
+WString OldGetXmlAttribute(const WString& xml, const WString& tag, const WString& attr) {
+    size_t searchPos = 0;
+    while (searchPos < xml.size()) {
+        size_t tagStart = xml.find(u"<" + tag, searchPos);
+        if (tagStart == WString::npos) break;
+        size_t tagEnd = xml.find(u'>', tagStart);
+        if (tagEnd == WString::npos) break;
+        WString tagContent = xml.substr(tagStart, tagEnd - tagStart + 1);
+        WString attrSearch = attr + u"=\"";
+        size_t attrPos = tagContent.find(attrSearch);
+        if (attrPos != WString::npos) {
+            size_t valueStart = attrPos + attrSearch.length();
+            size_t valueEnd = tagContent.find(u'"', valueStart);
+            if (valueEnd != WString::npos) {
+                return tagContent.substr(valueStart, valueEnd - valueStart);
+            }
+        }
+        searchPos = tagEnd + 1;
+    }
+    return WString();
+}
+
+size_t OldParse(const std::string& bytes) {
+    const WString manifest = ztools::Utf8ToUtf16(bytes.data(), bytes.size());
+    if (manifest.find(u"<Applications>") == WString::npos) {
+        return 0;
+    }
+    size_t found = 0;
+    OldGetXmlAttribute(manifest, W("Properties"), WString());
+    size_t dnStart = manifest.find(u"<DisplayName>");
+    size_t dnEnd = manifest.find(u"</DisplayName>");
+    if (dnStart != WString::npos && dnEnd != WString::npos) {
+        found += OldDecodeXmlEntities(manifest.substr(dnStart + 13, dnEnd - dnStart - 13)).size();
+    }
+    size_t searchPos = 0;
+    while (searchPos < manifest.size()) {
+        size_t appTagStart = manifest.find(u"<Application ", searchPos);
+        if (appTagStart == WString::npos) break;
+        size_t appBlockEnd = manifest.find(u"</Application>", appTagStart);
+        if (appBlockEnd == WString::npos) {
+            appBlockEnd = manifest.find(u"/>", appTagStart);
+            if (appBlockEnd == WString::npos) break;
+            appBlockEnd += 2;
+        } else {
+            appBlockEnd += 14;
+        }
+        WString appBlock = manifest.substr(appTagStart, appBlockEnd - appTagStart);
+        WString appId = OldGetXmlAttribute(appBlock, W("Application"), W("Id"));
+        WString exe = OldGetXmlAttribute(appBlock, W("Application"), W("Executable"));
+        WString entry = OldGetXmlAttribute(appBlock, W("uap:VisualElements"), W("AppListEntry"));
+        if (entry.empty()) entry = OldGetXmlAttribute(appBlock, W("VisualElements"), W("AppListEntry"));
+        WString name = OldGetXmlAttribute(appBlock, W("uap:VisualElements"), W("DisplayName"));
+        if (name.empty()) name = OldGetXmlAttribute(appBlock, W("VisualElements"), W("DisplayName"));
+        name = OldDecodeXmlEntities(name);
+        WString logo = OldGetXmlAttribute(appBlock, W("uap:VisualElements"), W("Square44x44Logo"));
+        if (logo.empty()) logo = OldGetXmlAttribute(appBlock, W("VisualElements"), W("Square44x44Logo"));
+        if (logo.empty()) {
+            logo = OldGetXmlAttribute(appBlock, W("uap:VisualElements"), W("Square150x150Logo"));
+            if (logo.empty()) logo = OldGetXmlAttribute(appBlock, W("VisualElements"), W("Square150x150Logo"));
+        }
+        found += appId.size() + exe.size() + entry.size() + name.size() + logo.size();
+        searchPos = appBlockEnd;
+    }
+    return found;
+}
+
+}  // namespace
+
+int main() {
+    printf("【AppxManifest 基准】\n");
+    const char* names[] = {"calculator.xml", "photos.xml", "vclibs-framework.xml"};
+    std::vector<std::string> packages;
+    size_t bytes = 0;
+    // 300 个包：按真实比例混合应用包与框架包
+    for (int i = 0; i < 300; i++) {
+        packages.push_back(ReadFixture(names[i % 3]));
+        bytes += packages.back().size();
+    }
+    printf("  300 个 manifest，共 %.1f KB\n", bytes / 1024.0);
+
+    double seconds = ztest::TimeIt([&]() {
+        size_t found = 0;
+        for (const auto& xml : packages) found += OldParse(xml);
+        ztest::DoNotOptimize(found);
+    });
+    ztest::Report("UTF-16 + find/substr（每属性复制标签）", seconds, bytes);
+
+    seconds = ztest::TimeIt([&]() {
+        size_t found = 0;
+        for (const auto& xml : packages) {
+            ztools::AppxManifest manifest;
+            ztools::ParseAppxManifest(xml.data(), xml.size(), manifest);
+            found += manifest.applications.size();
+        }
+        ztest::DoNotOptimize(found);
+    });
+    ztest::Report("UTF-8 单遍记号化", seconds, bytes);
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Base64 基准：编码 / 解码 1 MB 与 8 MB PNG 大小的数据
+//
+// 旧：binding 中逐字节 push_back 编码（预留空间），截图 data URL 再拼接前缀复制一遍；
+//     解码为常见的逐字符查找实现。
+// 新：按精确长度一次分配，12 位查表 / SSE2 / NEON 直接写入目标缓冲区。
+#include "test-util.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "common/base64.h"
+
+namespace {
+
+const char kChars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+std::string OldBase64Encode(const unsigned char* data, size_t len) {
+    std::string result;
+    result.reserve(((len + 2) / 3) * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        unsigned int b = (data[i] << 16) | ((i + 1 < len ? data[i + 1] : 0) << 8) | (i + 2 < len ? data[i + 2] : 0);
+        result.push_back(kChars[(b >> 18) & 0x3F]);
+        result.push_back(kChars[(b >> 12) & 0x3F]);
+        result.push_back(i + 1 < len ? kChars[(b >> 6) & 0x3F] : '=');
+        result.push_back(i + 2 < len ? kChars[b & 0x3F] : '=');
+    }
+    return result;
+}
+
+std::string OldBase64Decode(const std::string& text) {
+    std::string out;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (char c : text) {
+        const char* p = strchr(kChars, c);
+        if (c == '=' || c == '\0' || p == nullptr) {
+            continue;
+        }
+        acc = (acc << 6) | static_cast<uint32_t>(p - kChars);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<char>(acc >> bits));
+        }
+    }
+    return out;
+}
+
+void RunCase(const char* name, size_t size) {
+    std::string bytes(size, '\0');
+    srand(3);
+    for (char& c : bytes) c = static_cast<char>(rand() & 0xFF);
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(bytes.data());
+
+    printf("  -- %s\n", name);
+    double seconds = ztest::TimeIt([&]() {
+        std::string url = "data:image/png;base64," + OldBase64Encode(data, size);
+        ztest::DoNotOptimize(url);
+    });
+    ztest::Report("编码：旧 push_back + 拼接前缀", seconds, size);
+
+    ztools::Base64Options scalar;
+    scalar.vectorized = false;
+    seconds = ztest::TimeIt([&]() {
+        std::string encoded = ztools::Base64Encode(data, size, scalar);
+        ztest::DoNotOptimize(encoded);
+    });
+    ztest::Report("编码：12 位查表", seconds, size);
+
+    seconds = ztest::TimeIt([&]() {
+        std::string url = ztools::Base64DataUrl("image/png", data, size);
+        ztest::DoNotOptimize(url);
+    });
+    ztest::Report("编码：向量化 data URL（一次分配）", seconds, size);
+
+    const std::string encoded = ztools::Base64Encode(data, size);
+    seconds = ztest::TimeIt([&]() {
+        std::string decoded = OldBase64Decode(encoded);
+        ztest::DoNotOptimize(decoded);
+    });
+    ztest::Report("解码：逐字符查找", seconds, encoded.size());
+
+    seconds = ztest::TimeIt([&]() {
+        std::string decoded;
+        ztools::Base64Decode(encoded.data(), encoded.size(), decoded, scalar);
+        ztest::DoNotOptimize(decoded);
+    });
+    ztest::Report("解码：四表合并", seconds, encoded.size());
+
+    seconds = ztest::TimeIt([&]() {
+        std::string decoded;
+        ztools::Base64Decode(encoded.data(), encoded.size(), decoded);
+        ztest::DoNotOptimize(decoded);
+    });
+    ztest::Report("解码：向量化", seconds, encoded.size());
+}
+
+}  // namespace
+
+int main() {
+    printf("【Base64 基准】\n");
+    RunCase("1 MB（1080p 截图 PNG）", 1 << 20);
+    RunCase("8 MB（4K 截图 PNG）", 8 << 20);
+    return 0;
+}
@@ -0,0 +1,118 @@
+// 选中内容前后比较基准：4K 截图（CF_DIB，3840x2160x32bpp）在模拟复制前后的比较开销
+//
+// 旧实现：前后两次都把位图编码为 base64（Windows 上还要先编码 PNG，这里不计入）再比较字符串。
+// 新实现：原剪贴板快照复制时顺带计算哈希，复制后的快照只计算哈希，按长度 + 哈希比较。
+#include "test-util.h"
+
+#include <string>
+
+#include "common/clipboard_snapshot.h"
+
+using ztools::ClipboardBackend;
+using ztools::ClipboardSnapshot;
+using ztools::ClipboardSnapshotOptions;
+
+namespace {
+
+const uint32_t kUnicodeText = 13;
+const uint32_t kDib = 8;
+const uint32_t kHdrop = 15;
+
+class MemoryClipboard : public ClipboardBackend {
+public:
+    std::vector<std::pair<uint32_t, std::string>> formats;
+
+    bool Open() override { return true; }
+    void Close() override {}
+    std::vector<uint32_t> EnumerateFormats() override {
+        std::vector<uint32_t> ids;
+        for (const auto& f : formats) ids.push_back(f.first);
+        return ids;
+    }
+    bool ReadFormat(uint32_t format, const Reader& reader) override {
+        for (const auto& f : formats) {
+            if (f.first == format) {
+                reader(f.second.data(), f.second.size());
+                return true;
+            }
+        }
+        return false;
+    }
+    bool Empty() override { return true; }
+    bool WriteFormat(uint32_t, const void*, size_t) override { return true; }
+};
+
+const char kBase64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 与 binding_windows.cpp 中 Base64Encode 相同的逐字节实现
+std::string Base64Encode(const unsigned char* data, size_t len) {
+    std::string result;
+    result.reserve(((len + 2) / 3) * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        unsigned int b = (data[i] << 16) | ((i + 1 < len ? data[i + 1] : 0) << 8) | (i + 2 < len ? data[i + 2] : 0);
+        result.push_back(kBase64Chars[(b >> 18) & 0x3F]);
+        result.push_back(kBase64Chars[(b >> 12) & 0x3F]);
+        result.push_back(i + 1 < len ? kBase64Chars[(b >> 6) & 0x3F] : '=');
+        result.push_back(i + 2 < len ? kBase64Chars[b & 0x3F] : '=');
+    }
+    return result;
+}
+
+std::string Screenshot(unsigned seed) {
+    const size_t size = 40 + 3840u * 2160u * 4u;  // BITMAPINFOHEADER + 像素
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; i++) data[i] = static_cast<char>((i * 2654435761u + seed) >> 13);
+    return data;
+}
+
+}  // namespace
+
+int main() {
+    printf("【选中内容比较基准】（4K 截图，%.1f MB）\n", (40 + 3840.0 * 2160 * 4) / (1024 * 1024));
+
+    MemoryClipboard before;
+    before.formats = {{kUnicodeText, std::string("o\0l\0d\0\0\0", 8)}, {kDib, Screenshot(1)}};
+    MemoryClipboard after;
+    after.formats = {{kUnicodeText, std::string("n\0e\0w\0\0\0", 8)}, {kDib, Screenshot(1)}};
+    const size_t dibBytes = before.formats[1].second.size();
+
+    double oldSeconds = ztest::TimeIt([&]() {
+        const std::string& a = before.formats[1].second;
+        const std::string& b = after.formats[1].second;
+        std::string oldImage = Base64Encode(reinterpret_cast<const unsigned char*>(a.data()), a.size());
+        std::string newImage = Base64Encode(reinterpret_cast<const unsigned char*>(b.data()), b.size());
+        bool same = oldImage == newImage;
+        ztest::DoNotOptimize(same);
+    });
+    ztest::Report("旧：两次 base64 + 字符串比较", oldSeconds, dibBytes * 2);
+
+    const std::vector<uint32_t> diffFormats = {kUnicodeText, kHdrop, kDib};
+    ClipboardSnapshot original;
+    ClipboardSnapshot copied;
+
+    // 原剪贴板本来就要完整复制（用于恢复），哈希只是额外开销
+    ClipboardSnapshotOptions plain;
+    double copySeconds = ztest::TimeIt([&]() { original.Capture(before, plain); });
+    ztest::Report("原快照：仅复制", copySeconds, dibBytes);
+
+    ClipboardSnapshotOptions originalOptions;
+    originalOptions.hashFormats = diffFormats;
+    double hashCopySeconds = ztest::TimeIt([&]() { original.Capture(before, originalOptions); });
+    ztest::Report("原快照：复制 + 哈希（单遍）", hashCopySeconds, dibBytes);
+
+    ClipboardSnapshotOptions copiedOptions;
+    copiedOptions.formats = diffFormats;
+    copiedOptions.hashFormats = diffFormats;
+    copiedOptions.hashOnly = {kDib};
+    double newSeconds = ztest::TimeIt([&]() {
+        copied.Capture(after, copiedOptions);
+        bool same = ClipboardSnapshot::SameContent(original.Find(kDib), copied.Find(kDib));
+        ztest::DoNotOptimize(same);
+    });
+    ztest::Report("新：复制后快照只哈希 + 比较", newSeconds, dibBytes);
+
+    printf("  比较开销（新增部分）: 旧 %.2f ms，新 %.2f ms（%.1fx）\n", oldSeconds * 1000,
+           (newSeconds + hashCopySeconds - copySeconds) * 1000,
+           oldSeconds / (newSeconds + hashCopySeconds - copySeconds));
+    return 0;
+}
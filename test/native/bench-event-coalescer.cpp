@@ -0,0 +1,110 @@
+// 事件合并器基准：模拟 Edge/Office 复制时的连续写入
+#include "test-util.h"
+
+#include <algorithm>
+#include <random>
+
+#include "common/event_coalescer.h"
+
+using ztools::CoalescedBurst;
+using ztools::CoalescerOptions;
+using ztools::EventCoalescer;
+
+namespace {
+
+struct Result {
+    uint64_t callbacks = 0;
+    double firstLatencyMs = 0;  // 平均首次回调延迟
+    double finalLatencyMs = 0;  // 平均最终状态回调延迟
+};
+
+// 每次复制产生 burstSize 个事件，间隔 0~gapMs 随机；复制之间相隔 1 秒
+Result Simulate(const CoalescerOptions& options, int copies, int burstSize, int gapMs) {
+    uint64_t now = 0;
+    EventCoalescer coalescer(options, [&]() { return now; });
+
+    Result result;
+    uint64_t copyStart = 0;
+    uint64_t lastEvent = 0;
+    bool gotFirst = false;
+    double firstSum = 0;
+    double finalSum = 0;
+    coalescer.SetSink([&](const CoalescedBurst&) {
+        result.callbacks++;
+        if (!gotFirst) {
+            firstSum += (now - copyStart) / 1000.0;
+            gotFirst = true;
+        }
+        if (now >= lastEvent) {
+            finalSum += (now - lastEvent) / 1000.0;
+        }
+    });
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> gap(0, gapMs * 1000);
+    for (int c = 0; c < copies; c++) {
+        copyStart = now;
+        gotFirst = false;
+        std::vector<uint64_t> events;
+        uint64_t t = now;
+        for (int i = 0; i < burstSize; i++) {
+            events.push_back(t);
+            t += gap(rng);
+        }
+        lastEvent = events.back();
+
+        // 以 1ms 粒度推进时钟，模拟消息循环
+        size_t next = 0;
+        uint64_t end = now + 1000000;
+        for (; now < end; now += 1000) {
+            while (next < events.size() && events[next] <= now) {
+                coalescer.Push();
+                next++;
+            }
+            coalescer.Poll();
+        }
+    }
+    result.firstLatencyMs = firstSum / copies;
+    result.finalLatencyMs = finalSum / copies;
+    return result;
+}
+
+void PrintScenario(const char* name, const CoalescerOptions& options) {
+    for (int burst : {1, 4}) {
+        Result r = Simulate(options, 200, burst, 30);
+        printf("  %-28s 每次复制 %d 个事件: 回调 %.2f 次/复制, 首次回调 %.1f ms, 最终回调 %.1f ms\n",
+               name, burst, r.callbacks / 200.0, r.firstLatencyMs, r.finalLatencyMs);
+    }
+}
+
+}  // namespace
+
+int main() {
+    printf("【EventCoalescer 基准】\n");
+
+    CoalescerOptions fixed;
+    fixed.leading = false;
+    fixed.quietUs = 100000;
+    fixed.maxWaitUs = 0;
+    PrintScenario("固定 100ms 防抖（原实现）", fixed);
+
+    CoalescerOptions leading;
+    leading.leading = true;
+    leading.quietUs = 100000;
+    leading.maxWaitUs = 500000;
+    PrintScenario("leading + 100ms 静默", leading);
+
+    // 热路径开销：Push + Poll
+    uint64_t now = 0;
+    EventCoalescer coalescer(leading, [&]() { return now; });
+    uint64_t fired = 0;
+    coalescer.SetSink([&](const CoalescedBurst&) { fired++; });
+    double seconds = ztest::TimeIt([&]() {
+        now += 7000;
+        coalescer.Push(now % 4);
+        coalescer.Poll();
+    });
+    ztest::Report("Push + Poll", seconds, 0);
+    ztest::DoNotOptimize(fired);
+    return 0;
+}
@@ -0,0 +1,182 @@
+// 零拷贝剪贴板输出基准（Linux）：1 / 10 / 100 MB 内容交给 JS 时的耗时与峰值内存增量
+//
+// 旧路径：文本 UTF-16 → UTF-8 std::string → JS 字符串（V8 再解码为双字节字符串）；
+//         图像 PNG → base64 std::string → JS 字符串（单字节字符串）。
+// 新路径：从剪贴板复制出的一份字节以 ExternalBytes 接管，直接作为 Uint16Array / Buffer 的存储。
+// JS 字符串以等量的堆分配模拟。每个用例在独立子进程中运行，峰值取自 getrusage 的 ru_maxrss，
+// 剪贴板源数据在测量基线之前分配，不计入增量。
+#include "test-util.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+
+#include "common/clipboard_write.h"
+#include "common/external_bytes.h"
+
+using ztools::ExternalBytes;
+
+namespace {
+
+const char kBase64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 与 binding_mac.cpp / binding_windows.cpp 中 Base64Encode 相同的逐字节实现
+std::string Base64Encode(const unsigned char* data, size_t len) {
+    std::string result;
+    result.reserve(((len + 2) / 3) * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        unsigned int b = (data[i] << 16) | ((i + 1 < len ? data[i + 1] : 0) << 8) | (i + 2 < len ? data[i + 2] : 0);
+        result.push_back(kBase64Chars[(b >> 18) & 0x3F]);
+        result.push_back(kBase64Chars[(b >> 12) & 0x3F]);
+        result.push_back(i + 1 < len ? kBase64Chars[(b >> 6) & 0x3F] : '=');
+        result.push_back(i + 2 < len ? kBase64Chars[b & 0x3F] : '=');
+    }
+    return result;
+}
+
+// UTF-16LE → UTF-8（WideCharToMultiByte 的等价实现，输入不含代理对）
+std::string Utf16LeToUtf8(const std::string& utf16) {
+    std::string utf8;
+    utf8.reserve(utf16.size() * 3 / 2);
+    for (size_t i = 0; i + 1 < utf16.size(); i += 2) {
+        unsigned int c = static_cast<unsigned char>(utf16[i]) | (static_cast<unsigned char>(utf16[i + 1]) << 8);
+        if (c < 0x80) {
+            utf8.push_back(static_cast<char>(c));
+        } else if (c < 0x800) {
+            utf8.push_back(static_cast<char>(0xC0 | (c >> 6)));
+            utf8.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        } else {
+            utf8.push_back(static_cast<char>(0xE0 | (c >> 12)));
+            utf8.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            utf8.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+    return utf8;
+}
+
+// 中英混合文本（每 8 个码元含 1 个汉字），V8 需要双字节字符串
+std::string MakeUtf16Text(size_t bytes) {
+    std::string text(bytes & ~size_t(1), '\0');
+    for (size_t i = 0; i < text.size(); i += 2) {
+        unsigned int c = (i / 2) % 8 == 7 ? 0x4E2D : 'a' + (i / 2) % 26;
+        text[i] = static_cast<char>(c & 0xFF);
+        text[i + 1] = static_cast<char>(c >> 8);
+    }
+    return text;
+}
+
+std::string MakePng(size_t bytes) {
+    std::string png(bytes, '\0');
+    uint32_t x = 2463534242u;
+    for (size_t i = 0; i < png.size(); i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        png[i] = static_cast<char>(x);
+    }
+    return png;
+}
+
+long PeakRssKb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// 模拟 V8 以结果字节创建 JS 值：字符串会复制，外部缓冲区只记录指针
+struct JsHeap {
+    std::string strings;
+    ExternalBytes* external = nullptr;
+
+    ~JsHeap() {
+        if (external != nullptr) ExternalBytes::Release(external);
+    }
+};
+
+enum class Path { OldText, NewText, OldImage, NewImage };
+
+// 一次读取：source 为剪贴板持有的数据，读取器先复制一份（两条路径相同），再交给 JS
+void RunOnce(Path path, const std::string& source, JsHeap& js) {
+    std::string copied = source;
+    switch (path) {
+        case Path::OldText: {
+            std::string utf8 = Utf16LeToUtf8(copied);
+            copied.clear();
+            copied.shrink_to_fit();
+            js.strings = ztools::Utf8ToUtf16Le(utf8);  // V8 解码为双字节字符串
+            break;
+        }
+        case Path::OldImage: {
+            std::string base64 = Base64Encode(reinterpret_cast<const unsigned char*>(copied.data()), copied.size());
+            js.strings = base64;  // 单字节字符串复制
+            break;
+        }
+        case Path::NewText:
+        case Path::NewImage:
+            js.external = ExternalBytes::Adopt(std::move(copied));
+            break;
+    }
+}
+
+struct Sample {
+    double secondsPerOp;
+    long peakDeltaKb;
+};
+
+// 在子进程中运行，避免 ru_maxrss 被前一个用例抬高
+Sample Measure(Path path, size_t bytes) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return {0, 0};
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        const bool text = path == Path::OldText || path == Path::NewText;
+        std::string source = text ? MakeUtf16Text(bytes) : MakePng(bytes);
+        const int repeats = bytes >= (64u << 20) ? 1 : bytes >= (8u << 20) ? 4 : 16;
+
+        long baseline = PeakRssKb();
+        double start = ztest::NowSeconds();
+        for (int i = 0; i < repeats; i++) {
+            JsHeap js;  // 模拟 JS 持有结果直到下一次读取前被回收
+            RunOnce(path, source, js);
+            ztest::DoNotOptimize(js);
+        }
+        Sample sample = {(ztest::NowSeconds() - start) / repeats, PeakRssKb() - baseline};
+        ssize_t written = write(fds[1], &sample, sizeof(sample));
+        (void)written;
+        _exit(0);
+    }
+    close(fds[1]);
+    Sample sample = {0, 0};
+    ssize_t got = read(fds[0], &sample, sizeof(sample));
+    (void)got;
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return sample;
+}
+
+void Print(const char* name, size_t bytes, const Sample& sample) {
+    ztest::Report(name, sample.secondsPerOp, bytes);
+    printf("  %-44s %12.1f MB 峰值增量（%.2fx 内容大小）\n", "", sample.peakDeltaKb / 1024.0,
+           sample.peakDeltaKb * 1024.0 / bytes);
+}
+
+}  // namespace
+
+int main() {
+    printf("【ExternalBytes 基准】\n");
+    for (size_t mb : {1u, 10u, 100u}) {
+        const size_t bytes = mb << 20;
+        printf(" %zu MB\n", mb);
+        Print("旧：文本 UTF-16 → UTF-8 → JS 字符串", bytes, Measure(Path::OldText, bytes));
+        Print("新：文本 UTF-16 → Uint16Array（零拷贝）", bytes, Measure(Path::NewText, bytes));
+        Print("旧：图像 PNG → base64 → JS 字符串", bytes, Measure(Path::OldImage, bytes));
+        Print("新：图像 PNG → Buffer（零拷贝）", bytes, Measure(Path::NewImage, bytes));
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+// 持久化历史日志基准：追加吞吐、分页扫描、打开耗时
+#include "test-util.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "common/history_log.h"
+
+using ztools::ClipboardHistoryFormat;
+using ztools::HistoryLog;
+using ztools::HistoryLogOptions;
+using ztools::HistoryLogRecord;
+
+namespace {
+
+const int kEntries = 50000;
+
+std::string MakeDir() {
+    char tmpl[] = "/tmp/ztools-history-bench-XXXXXX";
+    return mkdtemp(tmpl);
+}
+
+void RemoveDir(const std::string& dir) {
+    for (const char* name : {HistoryLog::kLogFileName, HistoryLog::kIndexFileName}) {
+        unlink((dir + "/" + name).c_str());
+        unlink((dir + "/" + name + ".compact").c_str());
+    }
+    rmdir(dir.c_str());
+}
+
+HistoryLogRecord Entry(int i, size_t textBytes) {
+    HistoryLogRecord record;
+    std::string text = "entry " + std::to_string(i) + " ";
+    text.resize(textBytes, 'x');
+    record.formats = {ClipboardHistoryFormat{"text", text}};
+    return record;
+}
+
+}  // namespace
+
+int main() {
+    printf("【HistoryLog 基准】（%d 条记录）\n", kEntries);
+    HistoryLogOptions options;
+    options.autoCompact = false;
+
+    for (size_t textBytes : {64u, 1024u}) {
+        std::string dir = MakeDir();
+        {
+            HistoryLog log;
+            log.Open(dir, options);
+            double start = ztest::NowSeconds();
+            for (int i = 0; i < kEntries; i++) {
+                log.Append(Entry(i, textBytes));
+            }
+            double seconds = ztest::NowSeconds() - start;
+            char name[64];
+            snprintf(name, sizeof(name), "Append（%zu 字节文本）", textBytes);
+            ztest::Report(name, seconds / kEntries, textBytes);
+        }
+
+        // 重新打开：只校验索引最后一项，与记录数无关
+        HistoryLog log;
+        double start = ztest::NowSeconds();
+        log.Open(dir, options);
+        double openSeconds = ztest::NowSeconds() - start;
+        printf("  %-36s %.3f ms（%zu 条有效记录，重建索引: %s）\n", "Open", openSeconds * 1000, log.Size(),
+               log.Stats().indexRebuilt ? "是" : "否");
+
+        // 分页：JS 侧每次取 50 条
+        size_t offset = 0;
+        double pageSeconds = ztest::TimeIt([&]() {
+            auto page = log.Page(offset, 50);
+            ztest::DoNotOptimize(page);
+            offset = (offset + 50) % kEntries;
+        });
+        ztest::Report("Page(offset, 50)", pageSeconds, 0);
+
+        // 全量扫描：读出全部记录数据
+        start = ztest::NowSeconds();
+        uint64_t bytes = 0;
+        for (const auto& info : log.Page(0, kEntries)) {
+            auto data = log.ReadFormat(info.id, "text");
+            bytes += data ? data->size() : 0;
+        }
+        double scanSeconds = ztest::NowSeconds() - start;
+        printf("  %-36s %.1f ms，%.1f MB/s\n", "全量扫描（Page + ReadFormat）", scanSeconds * 1000,
+               bytes / scanSeconds / (1 << 20));
+
+        // 删除一半后压缩
+        auto all = log.Page(0, kEntries);
+        for (size_t i = 0; i < all.size(); i += 2) {
+            log.Remove(all[i].id);
+        }
+        double beforeMb = log.Stats().logBytes / 1048576.0;
+        start = ztest::NowSeconds();
+        log.Compact();
+        printf("  %-36s %.1f ms（%.1f MB → %.1f MB）\n", "Compact（删除一半后）",
+               (ztest::NowSeconds() - start) * 1000, beforeMb, log.Stats().logBytes / 1048576.0);
+        log.Close();
+        RemoveDir(dir);
+    }
+    return 0;
+}
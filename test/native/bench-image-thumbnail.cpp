@@ -0,0 +1,79 @@
+// 剪贴板图片缩略图基准（Linux）：从 CF_DIB 生成 96 px 预乘 BGRA 缩略图
+//
+// 旧：历史界面取回完整 base64 PNG（屏幕截图约为原始像素的 1/3 ~ 1/2，再膨胀 4/3），
+//     渲染进程解码为完整 RGBA 后再缩放，每个预览都要占用完整位图的内存。
+// 新：捕获时生成缩略图，界面只读取几十 KB 的像素。
+#include "test-util.h"
+
+#include <cstdlib>
+#include <string>
+
+#include "common/clipboard_write.h"
+#include "common/image_thumbnail.h"
+
+namespace {
+
+// 类似截图的内容：大块纯色区域 + 文字般的细节
+std::string ScreenLikeImage(uint32_t width, uint32_t height, bool alpha) {
+    std::string pixels(static_cast<size_t>(width) * height * 4, '\0');
+    unsigned seed = 1;
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            unsigned char* p = reinterpret_cast<unsigned char*>(&pixels[(static_cast<size_t>(y) * width + x) * 4]);
+            seed = seed * 1103515245 + 12345;
+            const bool detail = ((x / 8 + y / 16) % 5 == 0) && (seed >> 16) % 3 == 0;
+            p[0] = detail ? 20 : static_cast<unsigned char>(200 + (y * 40 / height));
+            p[1] = detail ? 20 : static_cast<unsigned char>(220 - (x * 60 / width));
+            p[2] = detail ? 20 : 240;
+            p[3] = alpha ? static_cast<unsigned char>(255 - (x * 255 / width)) : 0;
+        }
+    }
+    return pixels;
+}
+
+void RunCase(const char* name, uint32_t width, uint32_t height, bool alpha) {
+    ztools::ClipboardWriteImage image;
+    image.width = width;
+    image.height = height;
+    image.bgra = ScreenLikeImage(width, height, alpha);
+    std::string dib;
+    if (alpha) {
+        ztools::BuildDibV5FromBgra(image, dib);
+    } else {
+        ztools::BuildDibFromBgra(image, dib);
+    }
+
+    printf("  -- %s（%ux%u，DIB %.1f MB）\n", name, width, height, dib.size() / (1024.0 * 1024.0));
+    ztools::ThumbnailOptions scalar;
+    scalar.vectorized = false;
+    double scalarSeconds = ztest::TimeIt([&]() {
+        ztools::ThumbnailImage thumb;
+        ztools::ThumbnailFromDib(dib.data(), dib.size(), scalar, thumb);
+        ztest::DoNotOptimize(thumb);
+    });
+    ztest::Report("逐像素累加", scalarSeconds, dib.size());
+
+    ztools::ThumbnailOptions vectorized;
+    double vectorizedSeconds = ztest::TimeIt([&]() {
+        ztools::ThumbnailImage thumb;
+        ztools::ThumbnailFromDib(dib.data(), dib.size(), vectorized, thumb);
+        ztest::DoNotOptimize(thumb);
+    });
+    ztest::Report("4 像素一组向量化", vectorizedSeconds, dib.size());
+
+    ztools::ThumbnailImage thumb;
+    ztools::ThumbnailFromDib(dib.data(), dib.size(), vectorized, thumb);
+    const size_t decoded = static_cast<size_t>(width) * height * 4;
+    printf("  %-44s %ux%u，%zu 字节（完整解码位图 %zu 字节，%.0f 倍）\n", "缩略图", thumb.width, thumb.height,
+           thumb.pixels.size(), decoded, static_cast<double>(decoded) / thumb.pixels.size());
+}
+
+}  // namespace
+
+int main() {
+    printf("【ImageThumbnail 基准】\n");
+    RunCase("1080p 截图（32 位 BI_RGB）", 1920, 1080, false);
+    RunCase("4K 截图（32 位 BI_RGB）", 3840, 2160, false);
+    RunCase("4K 带透明度（V5 非预乘）", 3840, 2160, true);
+    return 0;
+}
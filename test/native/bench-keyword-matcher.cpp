@@ -0,0 +1,133 @@
+// 浏览器地址栏识别基准：模拟 UI Automation 遍历 600 个节点
+//
+// 旧：每个节点的名称转小写后逐个 find 7 个地址栏关键字；值复制、去首尾空白、转小写后
+//     逐个比较 11 个 URL 前缀（原 binding_windows.cpp 的实现，wstring 换成 u16string）。
+// 新：预编译的自动机单遍判断，不分配内存。
+#include "test-util.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cwctype>
+#include <string>
+#include <vector>
+
+#include "common/keyword_matcher.h"
+#include "common/utf_transcode.h"
+
+namespace {
+
+typedef std::u16string WString;
+
+WString U(const char* utf8) {
+    return ztools::Utf8ToUtf16(utf8, std::char_traits<char>::length(utf8));
+}
+
+WString ToLower(WString value) {
+    std::transform(value.begin(), value.end(), value.begin(), [](char16_t ch) {
+        return static_cast<char16_t>(std::towlower(ch));
+    });
+    return value;
+}
+
+bool OldLooksLikeBrowserUrl(const WString& value) {
+    if (value.empty()) {
+        return false;
+    }
+    WString trimmed = value;
+    trimmed.erase(trimmed.begin(), std::find_if(trimmed.begin(), trimmed.end(), [](char16_t ch) {
+        return !iswspace(ch);
+    }));
+    trimmed.erase(std::find_if(trimmed.rbegin(), trimmed.rend(), [](char16_t ch) {
+        return !iswspace(ch);
+    }).base(), trimmed.end());
+    if (trimmed.empty()) {
+        return false;
+    }
+    const WString lower = ToLower(trimmed);
+    const WString prefixes[] = {
+        u"http://", u"https://", u"file:///", u"about:", u"chrome://",
+        u"edge://", u"brave://", u"opera://", u"vivaldi://",
+        u"moz-extension://", u"ftp://"
+    };
+    for (const auto& prefix : prefixes) {
+        if (lower.size() >= prefix.size() && std::equal(prefix.begin(), prefix.end(), lower.begin())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OldIsBrowserAddressBarName(const WString& name) {
+    if (name.empty()) {
+        return false;
+    }
+    const WString lower = ToLower(name);
+    const WString keywords[] = {
+        u"address and search bar", u"search or enter address", u"address bar",
+        u"search with google or enter address", U("地址和搜索栏"), U("地址栏"), U("输入搜索词或网址")
+    };
+    for (const auto& keyword : keywords) {
+        if (lower.find(keyword) != WString::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct Node {
+    WString name;
+    WString value;
+};
+
+}  // namespace
+
+int main() {
+    printf("【浏览器地址栏识别基准】\n");
+    // 典型 Chromium 窗口的节点名称/值：大多数是按钮、标签页、网页正文
+    const char* names[] = {
+        "Minimize", "Maximize", "Close", "New Tab", "Reload", "Back", "Forward",
+        "Bookmarks", "Extensions", "Google Chrome", "Tab search",
+        "Example Domain - A very long page title that keeps going on", "搜索标签页",
+        "下载内容", "个人资料", "This domain is for use in illustrative examples in documents.",
+        "Address and search bar",
+    };
+    const char* values[] = {
+        "", "", "", "Example Domain", "  plain text value  ", "42",
+        "https://www.example.com/path/to/resource?query=value#section",
+    };
+    std::vector<Node> nodes;
+    size_t bytes = 0;
+    for (int i = 0; i < 600; i++) {
+        // 地址栏位于遍历末尾，前面的节点都不命中
+        const bool last = i == 599;
+        Node node{U(last ? names[16] : names[i % 16]), U(last ? values[6] : values[i % 6])};
+        bytes += (node.name.size() + node.value.size()) * sizeof(char16_t);
+        nodes.push_back(node);
+    }
+    printf("  600 个节点\n");
+
+    double seconds = ztest::TimeIt([&]() {
+        size_t hits = 0;
+        for (const auto& node : nodes) {
+            if (OldIsBrowserAddressBarName(node.name)) hits++;
+            if (OldLooksLikeBrowserUrl(node.value)) hits++;
+            if (OldLooksLikeBrowserUrl(node.name)) hits++;
+        }
+        ztest::DoNotOptimize(hits);
+    });
+    ztest::Report("转小写 + 逐关键字 find", seconds, bytes);
+
+    const ztools::KeywordMatcher urls = ztools::MakeBrowserUrlPrefixMatcher();
+    const ztools::KeywordMatcher addressBars = ztools::MakeBrowserAddressBarNameMatcher();
+    seconds = ztest::TimeIt([&]() {
+        size_t hits = 0;
+        for (const auto& node : nodes) {
+            if (addressBars.Matches(node.name)) hits++;
+            if (urls.Matches(node.value)) hits++;
+            if (urls.Matches(node.name)) hits++;
+        }
+        ztest::DoNotOptimize(hits);
+    });
+    ztest::Report("预编译自动机", seconds, bytes);
+    return 0;
+}
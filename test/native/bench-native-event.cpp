@@ -0,0 +1,182 @@
+// Swift → C++ 事件传递基准：窗口事件的编码、跨线程复制与 JS 线程解码
+//
+// 旧：Swift 拼接 JSON（逐字段转义）→ 桥接层 strdup → JS 线程复制为 std::string →
+//     JSON.parse（这里以一个最小 JSON 对象解析器近似，字段值同样逐个创建字符串）。
+// 新：定长记录 + 字符串表 → 一次 memcpy → 按偏移读取并逐字段回调。
+// 两侧都为每个字段创建一个 std::string / double，代替 JS 属性值的创建。
+#include "test-util.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/native_event.h"
+
+namespace {
+
+struct WindowInfo {
+    std::string appName = "Visual Studio Code";
+    std::string bundleId = "com.microsoft.VSCode";
+    std::string title = "native_event.h — ztools-native \"main\"";
+    std::string app = "Code.app";
+    std::string appPath = "/Applications/Visual Studio Code.app";
+    std::string axRole = "AXWindow";
+    std::string axSubrole = "AXStandardWindow";
+    std::string path = "/Users/dev/src/ztools-native";
+    std::string url = "file:///Users/dev/src/ztools-native/";
+    int x = 0, y = 25, width = 1728, height = 1079, pid = 1234, windowId = 5678;
+};
+
+std::string EscapeJson(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// Swift jsonForWindowMetadata 的等价实现
+std::string JsonForWindow(const WindowInfo& info) {
+    std::vector<std::string> fields;
+    fields.push_back("\"appName\":\"" + EscapeJson(info.appName) + "\"");
+    fields.push_back("\"bundleId\":\"" + EscapeJson(info.bundleId) + "\"");
+    fields.push_back("\"title\":\"" + EscapeJson(info.title) + "\"");
+    fields.push_back("\"app\":\"" + EscapeJson(info.app) + "\"");
+    fields.push_back("\"x\":" + std::to_string(info.x));
+    fields.push_back("\"y\":" + std::to_string(info.y));
+    fields.push_back("\"width\":" + std::to_string(info.width));
+    fields.push_back("\"height\":" + std::to_string(info.height));
+    fields.push_back("\"appPath\":\"" + EscapeJson(info.appPath) + "\"");
+    fields.push_back("\"pid\":" + std::to_string(info.pid));
+    fields.push_back("\"windowId\":" + std::to_string(info.windowId));
+    fields.push_back("\"axRole\":\"" + EscapeJson(info.axRole) + "\"");
+    fields.push_back("\"axSubrole\":\"" + EscapeJson(info.axSubrole) + "\"");
+    fields.push_back("\"preciseTarget\":true");
+    fields.push_back("\"path\":\"" + EscapeJson(info.path) + "\"");
+    fields.push_back("\"url\":\"" + EscapeJson(info.url) + "\"");
+    std::string json = "{";
+    for (size_t i = 0; i < fields.size(); i++) {
+        if (i > 0) json += ',';
+        json += fields[i];
+    }
+    return json + "}";
+}
+
+struct Fields {
+    std::vector<std::pair<std::string, std::string>> strings;
+    std::vector<std::pair<std::string, double>> numbers;
+};
+
+// 扁平 JSON 对象解析（字符串、数字、布尔）
+void ParseFlatJson(const std::string& json, Fields& out) {
+    size_t i = 1;
+    while (i < json.size() && json[i] != '}') {
+        const size_t keyEnd = json.find('"', i + 1);
+        std::string key = json.substr(i + 1, keyEnd - i - 1);
+        i = keyEnd + 2;
+        if (json[i] == '"') {
+            std::string value;
+            for (i++; json[i] != '"'; i++) {
+                if (json[i] == '\\') i++;
+                value += json[i];
+            }
+            out.strings.emplace_back(std::move(key), std::move(value));
+            i++;
+        } else {
+            char* end;
+            double number = strtod(json.c_str() + i, &end);
+            if (end == json.c_str() + i) {  // true / false
+                number = json[i] == 't';
+                while (json[i] != ',' && json[i] != '}') i++;
+            } else {
+                i = end - json.c_str();
+            }
+            out.numbers.emplace_back(std::move(key), number);
+        }
+        if (json[i] == ',') i++;
+    }
+}
+
+class FieldsVisitor : public ztools::NativeEventFieldVisitor {
+public:
+    explicit FieldsVisitor(Fields& out) : out_(out) {}
+    void String(const char* name, const char* data, size_t size) override {
+        out_.strings.emplace_back(name, std::string(data, size));
+    }
+    void Number(const char* name, double value) override { out_.numbers.emplace_back(name, value); }
+    void Boolean(const char* name, bool value) override { out_.numbers.emplace_back(name, value); }
+    void Null(const char* name) override { out_.numbers.emplace_back(name, 0); }
+
+private:
+    Fields& out_;
+};
+
+std::string EncodeWindow(const WindowInfo& info, ztools::NativeEventWriter& writer) {
+    ztools::WindowEventRecord record;
+    memset(&record, 0, sizeof(record));
+    record.x = info.x;
+    record.y = info.y;
+    record.width = info.width;
+    record.height = info.height;
+    record.pid = info.pid;
+    record.windowId = static_cast<uint32_t>(info.windowId);
+    record.flags = ztools::kWindowEventPreciseTarget;
+    record.appName = writer.AddString(info.appName);
+    record.bundleId = writer.AddString(info.bundleId);
+    record.title = writer.AddString(info.title);
+    record.app = writer.AddString(info.app);
+    record.appPath = writer.AddString(info.appPath);
+    record.axRole = writer.AddString(info.axRole);
+    record.axSubrole = writer.AddString(info.axSubrole);
+    record.path = writer.AddString(info.path);
+    record.url = writer.AddString(info.url);
+    record.kind = ztools::NativeEventWriter::Absent();
+    return writer.Finish(ztools::NativeEventKind::Window, &record, sizeof(record));
+}
+
+}  // namespace
+
+int main() {
+    printf("【原生事件传递基准】\n");
+    const WindowInfo info;
+    const int kEvents = 1000;
+    const size_t jsonBytes = JsonForWindow(info).size();
+    ztools::NativeEventWriter probe;
+    const size_t binaryBytes = EncodeWindow(info, probe).size();
+    printf("  单个窗口事件：JSON %zu 字节，二进制 %zu 字节\n", jsonBytes, binaryBytes);
+
+    double seconds = ztest::TimeIt([&]() {
+        size_t fields = 0;
+        for (int i = 0; i < kEvents; i++) {
+            const std::string json = JsonForWindow(info);
+            char* copy = strdup(json.c_str());  // OnWindowChanged
+            std::string received(copy);         // CallWindowJs
+            free(copy);
+            Fields parsed;
+            ParseFlatJson(received, parsed);
+            fields += parsed.strings.size() + parsed.numbers.size();
+        }
+        ztest::DoNotOptimize(fields);
+    });
+    ztest::Report("JSON 拼接 + strdup + 解析（1000 个事件）", seconds, jsonBytes * kEvents);
+
+    seconds = ztest::TimeIt([&]() {
+        size_t fields = 0;
+        ztools::NativeEventWriter writer;
+        for (int i = 0; i < kEvents; i++) {
+            const std::string encoded = EncodeWindow(info, writer);
+            void* copy = malloc(encoded.size());
+            memcpy(copy, encoded.data(), encoded.size());
+            Fields parsed;
+            FieldsVisitor visitor(parsed);
+            ztools::VisitNativeEvent(copy, encoded.size(), visitor);
+            free(copy);
+            fields += parsed.strings.size() + parsed.numbers.size();
+        }
+        ztest::DoNotOptimize(fields);
+    });
+    ztest::Report("定长记录 + 字符串表（1000 个事件）", seconds, binaryBytes * kEvents);
+    return 0;
+}
@@ -0,0 +1,156 @@
+// 大量剪贴板文件基准（Linux）：20,000 个合成路径的解析与属性查询
+//
+// 解析：旧实现逐个 DragQueryFileW（两次）+ wstring + UTF-8 + 文件名子串，每个文件三个独立字符串；
+//       新实现直接解析 DROPFILES 字节为一个 UTF-8 缓冲区 + 偏移 + 标志。
+// 属性：旧实现在 JS 线程逐个同步查询；新实现并行查询并带超时。
+//       真实 stat() 针对临时目录中的文件；"慢速共享"以每次 2 ms 的等待模拟网络路径。
+#include "test-util.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/clipboard_write.h"
+#include "common/packed_file_list.h"
+
+using ztools::FileProbeOptions;
+using ztools::FileProbeStats;
+using ztools::PackedFileList;
+
+namespace {
+
+const int kFiles = 20000;
+
+struct LegacyEntry {
+    std::string path;
+    std::string name;
+    bool isDirectory;
+};
+
+uint16_t LoadU16(const char* p) {
+    return static_cast<uint16_t>(static_cast<unsigned char>(p[0]) | (static_cast<unsigned char>(p[1]) << 8));
+}
+
+// 旧实现的等价：每个文件先查询长度、再复制 UTF-16（两次遍历），转 UTF-8 并截取文件名
+std::vector<LegacyEntry> LegacyParse(const std::string& dropFiles) {
+    std::vector<LegacyEntry> entries;
+    std::vector<size_t> starts;
+    for (size_t i = 20, start = 20; i + 1 < dropFiles.size(); i += 2) {
+        if (LoadU16(dropFiles.data() + i) == 0) {
+            if (i == start) break;
+            starts.push_back(start);
+            start = i + 2;
+        }
+    }
+    for (size_t start : starts) {
+        size_t length = 0;  // DragQueryFileW(hDrop, i, NULL, 0)
+        while (LoadU16(dropFiles.data() + start + length * 2) != 0) length++;
+        std::u16string wide(length, u'\0');  // DragQueryFileW(hDrop, i, buffer, length + 1)
+        for (size_t k = 0; k < length; k++) wide[k] = LoadU16(dropFiles.data() + start + k * 2);
+        std::string utf8;
+        for (char16_t c : wide) {
+            if (c < 0x80) {
+                utf8.push_back(static_cast<char>(c));
+            } else {
+                utf8.push_back(static_cast<char>(0xE0 | (c >> 12)));
+                utf8.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                utf8.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+            }
+        }
+        size_t slash = utf8.find_last_of("\\/");
+        std::string name = slash != std::string::npos ? utf8.substr(slash + 1) : utf8;
+        entries.push_back({utf8, name, false});
+    }
+    return entries;
+}
+
+uint8_t StatProbe(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return ztools::kFileFlagUnknown;
+    return S_ISDIR(st.st_mode) ? ztools::kFileFlagDirectory : 0;
+}
+
+uint8_t SlowShareProbe(const std::string&) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return 0;
+}
+
+}  // namespace
+
+int main() {
+    printf("【PackedFileList 基准】（%d 个文件）\n", kFiles);
+
+    std::vector<std::string> paths;
+    for (int i = 0; i < kFiles; i++) {
+        paths.push_back("C:\\Users\\dev\\Documents\\项目-" + std::to_string(i / 100) + "\\file-" + std::to_string(i) +
+                        ".txt");
+    }
+    const std::string dropFiles = ztools::BuildDropFiles(paths);
+
+    double legacySeconds = ztest::TimeIt([&]() { ztest::DoNotOptimize(LegacyParse(dropFiles)); });
+    ztest::Report("旧：逐个 DragQueryFileW + 三个字符串", legacySeconds, dropFiles.size());
+    double packedSeconds = ztest::TimeIt([&]() {
+        PackedFileList list;
+        ztools::ParseDropFiles(dropFiles.data(), dropFiles.size(), list);
+        ztest::DoNotOptimize(list);
+    });
+    ztest::Report("新：解析 DROPFILES 为紧凑表示", packedSeconds, dropFiles.size());
+
+    // 真实 stat()：临时目录中的 kFiles 个条目（每 10 个一个目录）
+    char tmpl[] = "/tmp/ztools-files-bench-XXXXXX";
+    std::string dir = mkdtemp(tmpl);
+    PackedFileList local;
+    for (int i = 0; i < kFiles; i++) {
+        std::string path = dir + "/entry-" + std::to_string(i);
+        if (i % 10 == 0) {
+            mkdir(path.c_str(), 0700);
+        } else {
+            FILE* f = fopen(path.c_str(), "w");
+            if (f != nullptr) fclose(f);
+        }
+        local.Append(path);
+    }
+    double serialStat = ztest::TimeIt([&]() {
+        for (size_t i = 0; i < local.Count(); i++) local.flags[i] = StatProbe(local.Path(i));
+    });
+    ztest::Report("旧：JS 线程逐个 stat", serialStat);
+    for (unsigned threads : {4u, 8u, 16u}) {
+        ztools::FileProbePool pool(threads);
+        FileProbeOptions options;
+        options.timeoutMs = 10000;
+        double parallelStat = ztest::TimeIt([&]() { pool.Probe(local, StatProbe, options); });
+        ztest::Report("新：并行 stat（" + std::to_string(threads) + " 线程）", parallelStat);
+    }
+    for (int i = 0; i < kFiles; i++) {
+        std::string path = local.Path(i);
+        if (i % 10 == 0) rmdir(path.c_str());
+        else unlink(path.c_str());
+    }
+    rmdir(dir.c_str());
+
+    // 慢速共享：500 个条目、每个 2 ms
+    PackedFileList share;
+    for (int i = 0; i < 500; i++) share.Append("\\\\nas\\share\\f" + std::to_string(i));
+    double start = ztest::NowSeconds();
+    for (size_t i = 0; i < share.Count(); i++) share.flags[i] = SlowShareProbe(share.Path(i));
+    ztest::Report("旧：慢速共享逐个查询（500 个）", ztest::NowSeconds() - start);
+
+    ztools::FileProbePool pool(16);
+    FileProbeOptions options;
+    options.timeoutMs = 10000;
+    start = ztest::NowSeconds();
+    pool.Probe(share, SlowShareProbe, options);
+    ztest::Report("新：慢速共享并行查询（16 线程）", ztest::NowSeconds() - start);
+
+    options.timeoutMs = 20;
+    start = ztest::NowSeconds();
+    FileProbeStats stats = pool.Probe(share, SlowShareProbe, options);
+    ztest::Report("新：慢速共享 20 ms 超时", ztest::NowSeconds() - start);
+    printf("  %-44s %zu 个完成，%zu 个未知\n", "", stats.resolved, stats.pending);
+    return 0;  // pool 析构时等待仍在进行的查询结束
+}
@@ -0,0 +1,101 @@
+// 前台切换时的进程元数据查询基准：同一组 8 个进程之间来回切换 1000 次
+//
+// 旧：每次切换都打开进程读取路径（Linux 上为 stat + readlink /proc/<pid>/exe，对应 Windows 的
+//     OpenProcess + GetModuleFileNameExW），再拆分出 app / appName。
+// 新：ProcessInfoCache 命中时只对 pidfd 做一次 poll 确认进程仍在运行。
+// 两侧都把三个字段复制到事件结构中（对应 WindowInfo）。
+#include "test-util.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "common/process_info_cache.h"
+#include "linux/procfs_process_source.h"
+
+namespace {
+
+struct WindowProcessFields {
+    std::string appPath;
+    std::string app;
+    std::string appName;
+};
+
+bool ReadUncached(uint32_t pid, WindowProcessFields& out) {
+    uint64_t startTime;
+    if (!ztools::ReadProcessStartTime(pid, &startTime)) {
+        return false;
+    }
+    char link[32];
+    snprintf(link, sizeof(link), "/proc/%u/exe", pid);
+    char buffer[4096];
+    const ssize_t size = readlink(link, buffer, sizeof(buffer));
+    if (size <= 0) {
+        return false;
+    }
+    out.appPath.assign(buffer, static_cast<size_t>(size));
+    ztools::SplitExecutableName(out.appPath, &out.app, &out.appName);
+    return true;
+}
+
+}  // namespace
+
+int main() {
+    printf("【进程元数据缓存基准】\n");
+    std::vector<pid_t> children;
+    for (int i = 0; i < 7; i++) {
+        const pid_t child = fork();
+        if (child == 0) {
+            pause();
+            _exit(0);
+        }
+        children.push_back(child);
+    }
+    std::vector<uint32_t> pids{static_cast<uint32_t>(getpid())};
+    for (pid_t child : children) {
+        pids.push_back(static_cast<uint32_t>(child));
+    }
+    const int kSwitches = 1000;
+    printf("  %zu 个进程，%d 次前台切换\n", pids.size(), kSwitches);
+
+    double seconds = ztest::TimeIt([&]() {
+        size_t found = 0;
+        WindowProcessFields fields;
+        for (int i = 0; i < kSwitches; i++) {
+            if (ReadUncached(pids[i % pids.size()], fields)) found += fields.appName.size();
+        }
+        ztest::DoNotOptimize(found);
+    });
+    ztest::Report("每次读取 /proc", seconds);
+
+    ztools::ProcfsProcessSource source;
+    ztools::ProcessInfoCache cache(source);
+    seconds = ztest::TimeIt([&]() {
+        size_t found = 0;
+        WindowProcessFields fields;
+        for (int i = 0; i < kSwitches; i++) {
+            auto info = cache.Lookup(pids[i % pids.size()]);
+            if (info) {
+                fields.appPath = info->appPath;
+                fields.app = info->app;
+                fields.appName = info->appName;
+                found += fields.appName.size();
+            }
+        }
+        ztest::DoNotOptimize(found);
+    });
+    ztest::Report("ProcessInfoCache（pidfd 存活检查）", seconds);
+    const ztools::ProcessInfoCacheStats stats = cache.Stats();
+    printf("  命中 %llu 次，未命中 %llu 次\n", static_cast<unsigned long long>(stats.hits),
+           static_cast<unsigned long long>(stats.misses));
+
+    for (pid_t child : children) {
+        kill(child, SIGKILL);
+        waitpid(child, nullptr, 0);
+    }
+    return 0;
+}
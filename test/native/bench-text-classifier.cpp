@@ -0,0 +1,113 @@
+// 剪贴板文本分类基准（Linux）：不同内容下的扫描吞吐
+//
+// 旧：JS 收到变化通知后取回完整文本，再逐个正则判断类型（这里以 std::regex 近似，
+//     只测 64 KB，另外还要加上文本跨入 JS 的转码与复制）。
+// 新：监控线程内一次扫描，逐字节查表与 16 字节向量化两种路径对比。
+#include "test-util.h"
+
+#include <regex>
+#include <string>
+
+#include "common/text_classifier.h"
+
+namespace {
+
+const size_t kCorpusBytes = 4u << 20;
+
+std::string Repeat(const std::string& unit, size_t bytes) {
+    std::string text;
+    text.reserve(bytes + unit.size());
+    while (text.size() < bytes) {
+        text += unit;
+    }
+    return text;
+}
+
+std::string ProseCorpus() {
+    return Repeat(
+        "剪贴板里通常是一段普通文字，偶尔夹杂一个链接 https://example.com/docs/page?id=42 或者邮箱 "
+        "someone@example.org。The quick brown fox jumps over the lazy dog, and then rests for a while.\n",
+        kCorpusBytes);
+}
+
+std::string CodeCorpus() {
+    return Repeat(
+        "static int Compute(const std::vector<int>& values) {\n"
+        "    int total = 0;  // see https://en.cppreference.com/w/cpp/container/vector\n"
+        "    for (size_t i = 0; i < values.size(); i++) {\n"
+        "        total += values[i] * 2 / (i + 1);\n"
+        "    }\n"
+        "    return total;\n"
+        "}\n",
+        kCorpusBytes);
+}
+
+std::string JsonCorpus() {
+    std::string json = "[\n";
+    for (int i = 0; json.size() < kCorpusBytes; i++) {
+        json += "  {\"id\": " + std::to_string(i) +
+                ", \"name\": \"item-" + std::to_string(i) +
+                "\", \"url\": \"https://cdn.example.com/a/" + std::to_string(i) +
+                ".png\", \"color\": \"#ffcc00\", \"tags\": [\"x\", \"y\"], \"ok\": true},\n";
+    }
+    json += "  {}\n]\n";
+    return json;
+}
+
+std::string LogCorpus() {
+    return Repeat(
+        "2024-05-01 12:00:01 GET /api/v1/items/42 from 10.0.0.1 -> C:\\srv\\logs\\app.log user=a@b.io\n",
+        kCorpusBytes);
+}
+
+// 近似旧流程：逐个类型执行一次正则搜索
+uint32_t RegexClassify(const std::string& text) {
+    static const std::regex url(R"([A-Za-z][A-Za-z0-9+.-]*://[^\s<>"']+)");
+    static const std::regex email(R"([A-Za-z0-9._%+-]+@[A-Za-z0-9.-]+\.[A-Za-z]{2,})");
+    static const std::regex path(R"((^|\s)([A-Za-z]:\\|/)[^\s]+)");
+    static const std::regex color(R"(#[0-9A-Fa-f]{3,8}\b)");
+    uint32_t kinds = 0;
+    if (std::regex_search(text, url)) kinds |= ztools::kTextKindUrl;
+    if (std::regex_search(text, email)) kinds |= ztools::kTextKindEmail;
+    if (std::regex_search(text, path)) kinds |= ztools::kTextKindPath;
+    if (std::regex_search(text, color)) kinds |= ztools::kTextKindColor;
+    return kinds;
+}
+
+void RunCorpus(const char* name, const std::string& text) {
+    printf("  -- %s（%.1f MB）\n", name, text.size() / (1024.0 * 1024.0));
+
+    ztools::TextClassifyOptions scalarOptions;
+    scalarOptions.vectorized = false;
+    double scalar = ztest::TimeIt([&]() { ztest::DoNotOptimize(ztools::ClassifyText(text, scalarOptions)); });
+    ztest::Report("逐字节查表", scalar, text.size());
+
+    double vectorized = ztest::TimeIt([&]() { ztest::DoNotOptimize(ztools::ClassifyText(text)); });
+    ztest::Report("16 字节向量化", vectorized, text.size());
+
+    ztools::TextClassification result = ztools::ClassifyText(text);
+    std::string kinds;
+    for (uint32_t kind = 1; kind <= ztools::kTextKindCode; kind <<= 1) {
+        if (result.kinds & kind) {
+            kinds += std::string(kinds.empty() ? "" : ",") + ztools::TextKindName(kind);
+        }
+    }
+    printf("  %-44s %s\n", "类型", kinds.c_str());
+}
+
+}  // namespace
+
+int main() {
+    printf("【TextClassifier 基准】\n");
+
+    const std::string prose = ProseCorpus();
+    const std::string slice = prose.substr(0, 64 * 1024);
+    double regex = ztest::TimeIt([&]() { ztest::DoNotOptimize(RegexClassify(slice)); });
+    ztest::Report("旧：std::regex 逐类搜索（64 KB 文字）", regex, slice.size());
+
+    RunCorpus("中英文混排文字", prose);
+    RunCorpus("代码", CodeCorpus());
+    RunCorpus("JSON 数组", JsonCorpus());
+    RunCorpus("日志（路径/邮箱密集）", LogCorpus());
+    return 0;
+}
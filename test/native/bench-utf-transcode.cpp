@@ -0,0 +1,72 @@
+// UTF-8 / UTF-16 转码基准（Linux）
+//
+// 旧：WideCharToMultiByte / MultiByteToWideChar 成对调用，先求长度再转换，文本扫描两遍
+//     （这里以逐码元转换执行两遍近似）。
+// 新：按上限一次分配、单遍转换；逐码元与向量化（SSE2 / AVX2 / NEON）两种路径对比。
+#include "test-util.h"
+
+#include <string>
+
+#include "common/utf_transcode.h"
+
+namespace {
+
+const size_t kCorpusBytes = 4u << 20;
+
+std::string Repeat(const std::string& unit) {
+    std::string text;
+    text.reserve(kCorpusBytes + unit.size());
+    while (text.size() < kCorpusBytes) {
+        text += unit;
+    }
+    return text;
+}
+
+void RunCorpus(const char* name, const std::string& utf8) {
+    const std::u16string utf16 = ztools::Utf8ToUtf16(utf8.data(), utf8.size());
+    const size_t wideBytes = utf16.size() * 2;
+    printf("  -- %s（UTF-8 %.1f MB，UTF-16 %.1f MB）\n", name, utf8.size() / (1024.0 * 1024.0),
+           wideBytes / (1024.0 * 1024.0));
+
+    ztools::TranscodeOptions scalar;
+    scalar.vectorized = false;
+    ztools::TranscodeOptions vectorized;
+
+    ztest::Report("UTF-16→8 旧：求长度 + 转换（两遍）", ztest::TimeIt([&]() {
+        std::string out(ztools::Utf8LengthOfUtf16(utf16.data(), utf16.size()), '\0');
+        ztools::ConvertUtf16ToUtf8(utf16.data(), utf16.size(), &out[0], scalar);
+        ztest::DoNotOptimize(out);
+    }), wideBytes);
+    ztest::Report("UTF-16→8 单遍逐码元", ztest::TimeIt([&]() {
+        ztest::DoNotOptimize(ztools::Utf16ToUtf8(utf16.data(), utf16.size(), scalar));
+    }), wideBytes);
+    ztest::Report("UTF-16→8 单遍向量化", ztest::TimeIt([&]() {
+        ztest::DoNotOptimize(ztools::Utf16ToUtf8(utf16.data(), utf16.size(), vectorized));
+    }), wideBytes);
+
+    ztest::Report("UTF-8→16 旧：转换两遍", ztest::TimeIt([&]() {
+        std::u16string out(utf8.size(), u'\0');
+        ztools::ConvertUtf8ToUtf16(utf8.data(), utf8.size(), &out[0], scalar);
+        out.resize(ztools::ConvertUtf8ToUtf16(utf8.data(), utf8.size(), &out[0], scalar));
+        ztest::DoNotOptimize(out);
+    }), utf8.size());
+    ztest::Report("UTF-8→16 单遍逐字节", ztest::TimeIt([&]() {
+        ztest::DoNotOptimize(ztools::Utf8ToUtf16(utf8.data(), utf8.size(), scalar));
+    }), utf8.size());
+    ztest::Report("UTF-8→16 单遍向量化", ztest::TimeIt([&]() {
+        ztest::DoNotOptimize(ztools::Utf8ToUtf16(utf8.data(), utf8.size(), vectorized));
+    }), utf8.size());
+}
+
+}  // namespace
+
+int main() {
+    printf("【UtfTranscode 基准】\n");
+    RunCorpus("路径/日志（纯 ASCII）",
+              Repeat("C:\\Users\\someone\\AppData\\Local\\Programs\\Microsoft VS Code\\Code.exe 2024-05-01 12:00:01\r\n"));
+    RunCorpus("英文为主夹杂中文",
+              Repeat("The quick brown fox jumps over the lazy dog. 偶尔一个词 and then some more English text.\n"));
+    RunCorpus("中文为主", Repeat("剪贴板里通常是一段普通文字，偶尔夹杂 ASCII 单词与标点。\n"));
+    RunCorpus("表情符号（代理对）", Repeat("ok \xF0\x9F\x98\x80\xF0\x9F\x91\x8D\xF0\x9F\x8E\x89 done\n"));
+    return 0;
+}
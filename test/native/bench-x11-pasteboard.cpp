@@ -0,0 +1,61 @@
+// 进程内剪贴板读取基准：X11 选区转换 vs 启动外部进程（原 macOS 实现每次读取都 popen/system）
+//
+// 进程启动开销在无 X 服务器时也会测量；选区读取部分需要 X 服务器（无头环境可使用 Xvfb）。
+#include "test-util.h"
+#include "x11-selection-owner.h"
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "linux/x11_pasteboard.h"
+
+using ztest::SelectionOwner;
+using ztools::PasteboardSnapshot;
+using ztools::X11Pasteboard;
+
+int main() {
+    printf("【Pasteboard 基准】\n");
+
+    // 原实现一次 getSelectedContent 约启动七个进程（pbpaste、osascript×4、pbcopy×2）
+    double spawnSeconds = ztest::TimeIt([]() {
+        FILE* pipe = popen("true", "r");
+        if (pipe != nullptr) pclose(pipe);
+    });
+    ztest::Report("popen(\"true\")（单次进程启动）", spawnSeconds);
+    ztest::Report("× 7（原 getSelectedContent 的进程数）", spawnSeconds * 7);
+
+    Display* probe = XOpenDisplay(nullptr);
+    if (probe == nullptr) {
+        return ztest::Skip("X11Pasteboard 基准", "无法连接 X 服务器（未设置 DISPLAY）");
+    }
+    XCloseDisplay(probe);
+
+    SelectionOwner owner;
+    std::string text(1024, 't');
+    std::string uriList;
+    for (int i = 0; i < 100; i++) uriList += "file:///home/user/file-" + std::to_string(i) + ".txt\r\n";
+    std::string image(8u << 20, '\0');  // 8MB，经 INCR 分段传输
+    for (size_t i = 0; i < image.size(); i++) image[i] = static_cast<char>(i * 131);
+    owner.Offer({{"UTF8_STRING", text}, {"text/uri-list", uriList}, {"image/png", image}});
+
+    X11Pasteboard pasteboard;
+    if (!pasteboard.Open()) {
+        printf("❌ %s\n", pasteboard.LastError().c_str());
+        return 1;
+    }
+
+    std::string out;
+    std::vector<std::string> files;
+    ztest::Report("ChangeCount", ztest::TimeIt([&]() { ztest::DoNotOptimize(pasteboard.ChangeCount()); }));
+    ztest::Report("ReadText（1KB）", ztest::TimeIt([&]() { pasteboard.ReadText(out); }), text.size());
+    ztest::Report("ReadFiles（100 个路径）", ztest::TimeIt([&]() { pasteboard.ReadFiles(files); }), uriList.size());
+    ztest::Report("ReadImagePng（8MB，INCR）", ztest::TimeIt([&]() { pasteboard.ReadImagePng(out); }),
+                  image.size());
+
+    PasteboardSnapshot snapshot;
+    double saveSeconds = ztest::TimeIt([&]() { pasteboard.Save(snapshot); });
+    ztest::Report("Save（全部目标）", saveSeconds, snapshot.Bytes());
+    return 0;
+}
@@ -0,0 +1,87 @@
+// 选中内容读取基准：PRIMARY 直接读取 vs 模拟复制路径（需要 X 服务器，无头环境可使用 Xvfb）
+//
+// 复制路径按 Windows/macOS 的流程在 CLIPBOARD 上模拟：保存全部目标 → 目标程序写入（此处由测试所有者
+// 直接 Offer，不含按键注入与目标程序响应的时间）→ 等待序列号变化并稳定 → 读取文本 → 持有选区恢复原内容。
+// PRIMARY 路径只有一次 TARGETS 往返加所需目标的转换。
+#include "test-util.h"
+#include "x11-selection-owner.h"
+
+#include <memory>
+#include <string>
+
+#include "common/clipboard_provider.h"
+#include "common/sequence_waiter.h"
+#include "linux/x11_clipboard_owner.h"
+#include "linux/x11_selected_content.h"
+
+using ztest::SelectionOwner;
+using ztools::ClipboardSource;
+using ztools::PasteboardSnapshot;
+using ztools::X11Pasteboard;
+
+int main() {
+    Display* probe = XOpenDisplay(nullptr);
+    if (probe == nullptr) {
+        return ztest::Skip("X11SelectedContent 基准", "无法连接 X 服务器（未设置 DISPLAY）");
+    }
+    XCloseDisplay(probe);
+
+    printf("【X11SelectedContent 基准】\n");
+
+    const std::string selected(200, 's');
+    std::string image(2u << 20, '\0');  // 剪贴板里原有一张 2MB 图片，复制路径需要保存并恢复
+    for (size_t i = 0; i < image.size(); i++) image[i] = static_cast<char>(i * 131);
+
+    SelectionOwner primaryOwner("PRIMARY");
+    primaryOwner.Offer({{"UTF8_STRING", selected}, {"STRING", selected}});
+    SelectionOwner app;  // 目标程序：响应 Ctrl+C 时取得 CLIPBOARD
+    app.Offer({{"UTF8_STRING", "原剪贴板文本"}, {"image/png", image}});
+
+    X11Pasteboard primary(ClipboardSource::Primary);
+    X11Pasteboard clipboard;
+    ztools::X11ClipboardOwner restorer;
+    if (!primary.Open() || !clipboard.Open() || !restorer.Start()) {
+        printf("❌ 无法打开 X11 连接\n");
+        return 1;
+    }
+
+    ztools::X11SelectedContent content;
+    double primarySeconds = ztest::TimeIt([&]() {
+        ztools::ReadSelectedContent(primary, ztools::kDefaultSelectedContentTimeoutMs, content);
+        ztest::DoNotOptimize(content);
+    });
+    ztest::Report("PRIMARY 直接读取（TARGETS + UTF8_STRING）", primarySeconds);
+
+    ztools::SequenceWaiter waiter([&]() { return clipboard.ChangeCount(); });
+    auto copyPath = [&](const ztools::SequenceWaitOptions& options) {
+        PasteboardSnapshot original;
+        clipboard.Save(original);
+        const uint64_t baseline = clipboard.ChangeCount();
+        app.Offer({{"UTF8_STRING", selected}});
+        waiter.Wait(baseline, options);
+        std::string text;
+        clipboard.ReadText(text);
+        ztest::DoNotOptimize(text);
+
+        auto provider = std::make_shared<ztools::ClipboardProvider>();
+        for (const auto& item : original.items) {
+            for (const auto& entry : item.entries) {
+                const std::string data = entry.data;
+                provider->Add(entry.type, [data](std::string& out) {
+                    out = data;
+                    return true;
+                });
+            }
+        }
+        restorer.Own(provider);
+    };
+
+    ztools::SequenceWaitOptions settled;
+    ztest::Report("模拟复制路径（保存 2MB + 等待稳定 15ms + 恢复）", ztest::TimeIt([&]() { copyPath(settled); }));
+    ztools::SequenceWaitOptions immediate;
+    immediate.settleUs = 0;
+    double copySeconds = ztest::TimeIt([&]() { copyPath(immediate); });
+    ztest::Report("模拟复制路径（不等待稳定）", copySeconds);
+    printf("  %-44s %.0f 倍（未计入按键注入与目标程序响应）\n", "PRIMARY 相对复制路径", copySeconds / primarySeconds);
+    return 0;
+}
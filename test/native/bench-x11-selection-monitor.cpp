@@ -0,0 +1,68 @@
+// X11 选区监控通知延迟基准（需要 X 服务器，无头环境可使用 Xvfb）
+#include "test-util.h"
+
+#include <X11/Xlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include "linux/x11_selection_monitor.h"
+
+using ztools::ClipboardSource;
+using ztools::X11SelectionMonitor;
+
+int main() {
+    Display* display = XOpenDisplay(nullptr);
+    if (display == nullptr) {
+        return ztest::Skip("X11SelectionMonitor 基准", "无法连接 X 服务器（未设置 DISPLAY）");
+    }
+    Window window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 1, 1, 0, 0, 0);
+    Atom clipboard = XInternAtom(display, "CLIPBOARD", False);
+
+    std::atomic<uint64_t> received(0);
+    std::atomic<double> receivedAt(0);
+    X11SelectionMonitor monitor;
+    if (!monitor.Start([&](ClipboardSource source, uint64_t, uint64_t) {
+            if (source != ClipboardSource::Clipboard) return;
+            receivedAt = ztest::NowSeconds();
+            received++;
+        })) {
+        printf("❌ %s\n", monitor.LastError().c_str());
+        return 1;
+    }
+
+    printf("【X11SelectionMonitor 基准】\n");
+
+    const int rounds = 1000;
+    std::vector<double> latencies;
+    latencies.reserve(rounds);
+    for (int i = 0; i < rounds; i++) {
+        uint64_t before = received;
+        double sentAt = ztest::NowSeconds();
+        XSetSelectionOwner(display, clipboard, window, CurrentTime);
+        XFlush(display);
+        while (received == before && ztest::NowSeconds() - sentAt < 1.0) {
+            std::this_thread::yield();
+        }
+        latencies.push_back(receivedAt - sentAt);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for (double l : latencies) sum += l;
+    printf("  所有者变化 %d 次\n", rounds);
+    printf("  平均延迟 %.3f ms, p50 %.3f ms, p99 %.3f ms, 最大 %.3f ms\n",
+           sum / rounds * 1000, latencies[rounds / 2] * 1000,
+           latencies[rounds * 99 / 100] * 1000, latencies.back() * 1000);
+
+    // 空闲期间不应有任何回调（事件驱动，无轮询唤醒）
+    uint64_t idleBefore = received;
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    printf("  空闲 500 ms 内回调次数: %llu\n", (unsigned long long)(received - idleBefore));
+
+    monitor.Stop();
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "test-util.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/appx_manifest.h"
+
+using ztools::AppxManifest;
+using ztools::XmlSlice;
+using ztools::XmlToken;
+using ztools::XmlTokenizer;
+using ztools::XmlTokenType;
+
+namespace {
+
+// test/native/fixtures/appx 下的 manifest（按本文件路径定位，与运行目录无关）
+std::string ReadFixture(const char* name) {
+    std::string path = __FILE__;
+    path = path.substr(0, path.find_last_of('/') + 1) + "fixtures/appx/" + name;
+    std::string data;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return data;
+    }
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.append(buffer, n);
+    }
+    fclose(file);
+    return data;
+}
+
+bool Parse(const std::string& xml, AppxManifest& manifest) {
+    return ztools::ParseAppxManifest(xml.data(), xml.size(), manifest);
+}
+
+std::string Decode(const std::string& text) {
+    std::string out;
+    ztools::AppendXmlDecoded(text.data(), text.size(), out);
+    return out;
+}
+
+}  // namespace
+
+TEST(TokenizerYieldsTagsTextAndAttributesWithoutCopying) {
+    const std::string xml =
+        "<?xml version=\"1.0\"?><!-- c --><a x=\"1 > 2\" y='v'><b/>t&amp;<![CDATA[<raw>]]></a>";
+    XmlTokenizer tokenizer(xml.data(), xml.size());
+    XmlToken token;
+    std::vector<std::string> seen;
+    while (tokenizer.Next(token)) {
+        // 所有片段都指向输入缓冲区
+        const XmlSlice& slice = token.type == XmlTokenType::Text ? token.text : token.name;
+        CHECK(slice.data >= xml.data() && slice.data + slice.size <= xml.data() + xml.size());
+        switch (token.type) {
+            case XmlTokenType::StartTag:
+                seen.push_back("<" + token.name.ToString() + (token.selfClosing ? "/>" : ">"));
+                break;
+            case XmlTokenType::EndTag: seen.push_back("</" + token.name.ToString() + ">"); break;
+            case XmlTokenType::Text: seen.push_back((token.cdata ? "cdata:" : "text:") + token.text.ToString()); break;
+        }
+        if (token.type == XmlTokenType::StartTag && token.name.Equals("a")) {
+            ztools::XmlAttributeReader attributes(token.attributes);
+            XmlSlice name, value;
+            CHECK(attributes.Next(name, value));
+            CHECK(name.Equals("x"));
+            CHECK(value.Equals("1 > 2"));
+            CHECK(attributes.Next(name, value));
+            CHECK(name.Equals("y"));
+            CHECK(value.Equals("v"));
+            CHECK(!attributes.Next(name, value));
+        }
+    }
+    CHECK(!tokenizer.Failed());
+    const std::vector<std::string> expected = {"<a>", "<b/>", "text:t&amp;", "cdata:<raw>", "</a>"};
+    CHECK(seen == expected);
+
+    for (const char* bad : {"<a", "<a x=\"1>", "<!-- open", "< a>"}) {
+        XmlTokenizer broken(bad, strlen(bad));
+        while (broken.Next(token)) {
+        }
+        CHECK(broken.Failed());
+    }
+}
+
+TEST(DecodesEntitiesToUtf8) {
+    CHECK_EQ(Decode("a &amp; b &lt;c&gt; &quot;d&quot; &apos;e&apos;"), std::string("a & b <c> \"d\" 'e'"));
+    CHECK_EQ(Decode("&#x7535;&#33041;"), std::string("\xE7\x94\xB5\xE8\x84\x91"));  // 电脑
+    CHECK_EQ(Decode("&#x1F600;"), std::string("\xF0\x9F\x98\x80"));
+    // 无法识别或越界的引用原样保留
+    CHECK_EQ(Decode("&nbsp; &#xD800; &#x110000; & ;"), std::string("&nbsp; &#xD800; &#x110000; & ;"));
+    CHECK_EQ(Decode("tail &am"), std::string("tail &am"));
+}
+
+TEST(ParsesCalculatorManifest) {
+    const std::string xml = ReadFixture("calculator.xml");
+    CHECK(!xml.empty());
+    AppxManifest manifest;
+    CHECK(Parse(xml, manifest));
+    CHECK_EQ(manifest.name, std::string("Microsoft.WindowsCalculator"));
+    CHECK_EQ(manifest.version, std::string("11.2307.4.0"));
+    CHECK_EQ(manifest.publisher.substr(0, 24), std::string("CN=Microsoft Corporation"));
+    CHECK_EQ(manifest.displayName, std::string("ms-resource:AppStoreName"));
+    CHECK(!manifest.framework);
+    CHECK(manifest.hasApplications);
+    CHECK_EQ(manifest.applications.size(), 1u);
+    const auto& app = manifest.applications[0];
+    CHECK_EQ(app.id, std::string("App"));
+    CHECK_EQ(app.executable, std::string("CalculatorApp.exe"));
+    CHECK_EQ(app.displayName, std::string("ms-resource:AppName"));
+    CHECK_EQ(app.square44x44Logo, std::string("Assets\\CalculatorAppList.png"));
+    CHECK_EQ(app.square150x150Logo, std::string("Assets\\CalculatorMedTile.png"));
+    CHECK(app.appListEntry.empty());
+}
+
+TEST(ParsesMultipleApplicationsAndPrefixes) {
+    AppxManifest manifest;
+    CHECK(Parse(ReadFixture("photos.xml"), manifest));
+    CHECK_EQ(manifest.displayName, std::string("Microsoft Photos & Video Editor"));
+    CHECK_EQ(manifest.applications.size(), 4u);
+    // 实体在属性值中解码；Extensions 中的 uap:DisplayName 不影响包级名称
+    CHECK_EQ(manifest.applications[0].displayName, std::string("\xE7\x85\xA7\xE7\x89\x87 \"Photos\""));
+    CHECK_EQ(manifest.applications[1].id, std::string("SecondaryEntry"));
+    CHECK_EQ(manifest.applications[1].displayName, std::string("Video Editor"));
+    CHECK_EQ(manifest.applications[2].appListEntry, std::string("none"));
+    // 无前缀的 VisualElements；没有 Square44x44Logo 时为空
+    CHECK_EQ(manifest.applications[3].displayName, std::string("Photo Viewer"));
+    CHECK_EQ(manifest.applications[3].executable, std::string("Viewer\\PhotoViewer.exe"));
+    CHECK(manifest.applications[3].square44x44Logo.empty());
+    CHECK_EQ(manifest.applications[3].square150x150Logo, std::string("Assets\\ViewerMedTile.png"));
+}
+
+TEST(DetectsFrameworkPackages) {
+    AppxManifest manifest;
+    CHECK(Parse(ReadFixture("vclibs-framework.xml"), manifest));
+    CHECK(manifest.framework);
+    CHECK(!manifest.hasApplications);
+    CHECK(manifest.applications.empty());
+    CHECK_EQ(manifest.name, std::string("Microsoft.VCLibs.140.00.UWPDesktop"));
+
+    // 截断的 manifest：返回 false，已解析的部分保留
+    std::string truncated = ReadFixture("photos.xml");
+    truncated.resize(truncated.find("SecondaryEntry") + 20);
+    CHECK(!Parse(truncated, manifest));
+    CHECK_EQ(manifest.applications.size(), 1u);
+}
+
+int main() {
+    return ztest::RunAll("AppxManifest");
+}
@@ -0,0 +1,136 @@
+#include "test-util.h"
+
+#include <cstdlib>
+#include <string>
+
+#include "common/base64.h"
+
+using ztools::Base64Options;
+
+namespace {
+
+std::string RandomBytes(size_t size) {
+    std::string bytes(size, '\0');
+    for (char& c : bytes) c = static_cast<char>(rand() & 0xFF);
+    return bytes;
+}
+
+// 原 binding 中逐字节 push_back 的实现，作为对照
+std::string ReferenceEncode(const std::string& input) {
+    static const char kChars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(input.data());
+    const size_t len = input.size();
+    std::string result;
+    for (size_t i = 0; i < len; i += 3) {
+        unsigned int b = (data[i] << 16) | ((i + 1 < len ? data[i + 1] : 0) << 8) | (i + 2 < len ? data[i + 2] : 0);
+        result.push_back(kChars[(b >> 18) & 0x3F]);
+        result.push_back(kChars[(b >> 12) & 0x3F]);
+        result.push_back(i + 1 < len ? kChars[(b >> 6) & 0x3F] : '=');
+        result.push_back(i + 2 < len ? kChars[b & 0x3F] : '=');
+    }
+    return result;
+}
+
+std::string Decode(const std::string& text, bool vectorized = true) {
+    Base64Options options;
+    options.vectorized = vectorized;
+    std::string out;
+    return ztools::Base64Decode(text.data(), text.size(), out, options) ? out : std::string("<invalid>");
+}
+
+}  // namespace
+
+TEST(EncodesRfc4648Vectors) {
+    CHECK_EQ(ztools::Base64Encode("", 0), std::string());
+    CHECK_EQ(ztools::Base64Encode("f", 1), std::string("Zg=="));
+    CHECK_EQ(ztools::Base64Encode("fo", 2), std::string("Zm8="));
+    CHECK_EQ(ztools::Base64Encode("foo", 3), std::string("Zm9v"));
+    CHECK_EQ(ztools::Base64Encode("foobar", 6), std::string("Zm9vYmFy"));
+    CHECK_EQ(Decode("Zm9vYmFy"), std::string("foobar"));
+    CHECK_EQ(Decode("Zm8="), std::string("fo"));
+    CHECK_EQ(Decode("Zg=="), std::string("f"));
+    CHECK_EQ(Decode(""), std::string());
+}
+
+TEST(VectorizedMatchesReference) {
+    srand(11);
+    Base64Options scalar;
+    scalar.vectorized = false;
+    for (size_t size = 0; size < 300; size++) {
+        const std::string bytes = RandomBytes(size);
+        const std::string expected = ReferenceEncode(bytes);
+        CHECK_EQ(ztools::Base64Encode(bytes.data(), bytes.size()), expected);
+        CHECK_EQ(ztools::Base64Encode(bytes.data(), bytes.size(), scalar), expected);
+        CHECK_EQ(Decode(expected, true), bytes);
+        CHECK_EQ(Decode(expected, false), bytes);
+    }
+    // 全部 256 种字节值，覆盖字母表每个字符
+    std::string all;
+    for (int i = 0; i < 256 * 3; i++) all.push_back(static_cast<char>(i * 7));
+    CHECK_EQ(ztools::Base64Encode(all.data(), all.size()), ReferenceEncode(all));
+    CHECK_EQ(Decode(ReferenceEncode(all)), all);
+}
+
+TEST(DecodeToleratesWhitespaceAndMissingPadding) {
+    srand(12);
+    const std::string bytes = RandomBytes(1000);
+    const std::string encoded = ReferenceEncode(bytes);
+    // MIME 风格：每 76 个字符换行
+    std::string wrapped;
+    for (size_t i = 0; i < encoded.size(); i += 76) {
+        wrapped += encoded.substr(i, 76) + "\r\n";
+    }
+    CHECK_EQ(Decode(wrapped), bytes);
+    CHECK_EQ(Decode(wrapped, false), bytes);
+    CHECK_EQ(Decode("Zm8"), std::string("fo"));
+    CHECK_EQ(Decode("Zg"), std::string("f"));
+    CHECK_EQ(Decode(" Zm9v YmFy \n"), std::string("foobar"));
+    CHECK_EQ(Decode("Zg= =\n"), std::string("f"));
+}
+
+TEST(DecodeRejectsInvalidInput) {
+    CHECK_EQ(Decode("Zm9v!mFy"), std::string("<invalid>"));
+    CHECK_EQ(Decode("Z"), std::string("<invalid>"));
+    CHECK_EQ(Decode("Zm9v="), std::string("<invalid>"));
+    CHECK_EQ(Decode("Zg==="), std::string("<invalid>"));
+    CHECK_EQ(Decode("Zg==Zg=="), std::string("<invalid>"));
+    CHECK_EQ(Decode("Zm9v-_8="), std::string("<invalid>"));  // URL 安全字母表不接受
+
+    // 向量块中的非法字符（包括 >= 0x80 的字节）
+    std::string block(64, 'A');
+    block[37] = '\xC3';
+    CHECK_EQ(Decode(block), std::string("<invalid>"));
+    block[37] = '*';
+    CHECK_EQ(Decode(block, false), std::string("<invalid>"));
+}
+
+TEST(DataUrls) {
+    const std::string png("\x89PNG\r\n\x1a\n\x00\x01", 10);
+    const std::string url = ztools::Base64DataUrl("image/png", png.data(), png.size());
+    CHECK_EQ(url, "data:image/png;base64," + ReferenceEncode(png));
+
+    std::string out;
+    std::string mime;
+    CHECK(ztools::DecodeBase64DataUrl(url.data(), url.size(), out, &mime));
+    CHECK(out == png);
+    CHECK_EQ(mime, std::string("image/png"));
+
+    const std::string withParams = "data:image/png;name=a.png;base64,Zm9v";
+    CHECK(ztools::DecodeBase64DataUrl(withParams.data(), withParams.size(), out, &mime));
+    CHECK_EQ(out, std::string("foo"));
+    CHECK_EQ(mime, std::string("image/png"));
+
+    // 不带前缀时按纯 base64
+    CHECK(ztools::DecodeBase64DataUrl("Zm9v", 4, out, &mime));
+    CHECK_EQ(out, std::string("foo"));
+    CHECK(mime.empty());
+
+    const std::string percent = "data:text/plain,foo%20bar";
+    CHECK(!ztools::DecodeBase64DataUrl(percent.data(), percent.size(), out));
+    const std::string noComma = "data:image/png;base64";
+    CHECK(!ztools::DecodeBase64DataUrl(noComma.data(), noComma.size(), out));
+}
+
+int main() {
+    return ztest::RunAll("Base64");
+}
@@ -0,0 +1,184 @@
+#include "test-util.h"
+
+#include "common/clipboard_change_detector.h"
+
+using ztools::ClipboardChange;
+using ztools::ClipboardChangeDetector;
+using ztools::ClipboardSource;
+
+TEST(DispatchesNewSequence) {
+    ClipboardChangeDetector detector;
+    std::vector<ClipboardChange> changes;
+    detector.SetSink([&](const ClipboardChange& c) { changes.push_back(c); });
+
+    CHECK(detector.Report(ClipboardSource::Clipboard, 10));
+    CHECK(detector.Report(ClipboardSource::Clipboard, 11));
+    CHECK_EQ(changes.size(), 2u);
+    CHECK_EQ(changes[1].sequence, 11u);
+    CHECK_EQ(detector.LastSequence(ClipboardSource::Clipboard), 11u);
+}
+
+TEST(DropsDuplicateSequence) {
+    ClipboardChangeDetector detector;
+    int count = 0;
+    detector.SetSink([&](const ClipboardChange&) { count++; });
+
+    CHECK(detector.Report(ClipboardSource::Clipboard, 5));
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 5));
+    CHECK_EQ(count, 1);
+    CHECK_EQ(detector.Stats().duplicates, 1u);
+}
+
+TEST(ZeroSequenceIsNeverDeduplicated) {
+    ClipboardChangeDetector detector;
+    int count = 0;
+    detector.SetSink([&](const ClipboardChange&) { count++; });
+
+    CHECK(detector.Report(ClipboardSource::Clipboard, 0));
+    CHECK(detector.Report(ClipboardSource::Clipboard, 0));
+    CHECK_EQ(count, 2);
+}
+
+TEST(PausedSignalsAreDroppedButTracked) {
+    ClipboardChangeDetector detector;
+    int count = 0;
+    detector.SetSink([&](const ClipboardChange&) { count++; });
+
+    detector.SetPaused(true);
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 1));
+    CHECK_EQ(detector.LastSequence(ClipboardSource::Clipboard), 1u);
+    detector.SetPaused(false);
+
+    // 恢复后同一序列号不应再次分发
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 1));
+    CHECK(detector.Report(ClipboardSource::Clipboard, 2));
+    CHECK_EQ(count, 1);
+    CHECK_EQ(detector.Stats().paused, 1u);
+}
+
+TEST(PrimaryIsFilteredByDefault) {
+    ClipboardChangeDetector detector;
+    int count = 0;
+    detector.SetSink([&](const ClipboardChange&) { count++; });
+
+    CHECK(!detector.Report(ClipboardSource::Primary, 1));
+    detector.SetSourceEnabled(ClipboardSource::Primary, true);
+    CHECK(detector.Report(ClipboardSource::Primary, 2));
+    CHECK_EQ(count, 1);
+    CHECK_EQ(detector.Stats().filtered, 1u);
+}
+
+TEST(SourcesHaveIndependentSequences) {
+    ClipboardChangeDetector detector;
+    detector.SetSourceEnabled(ClipboardSource::Primary, true);
+
+    CHECK(detector.Report(ClipboardSource::Clipboard, 7));
+    CHECK(detector.Report(ClipboardSource::Primary, 7));
+    CHECK_EQ(detector.Stats().dispatched, 2u);
+}
+
+TEST(ResetClearsState) {
+    ClipboardChangeDetector detector;
+    detector.Report(ClipboardSource::Clipboard, 3);
+    detector.SetPaused(true);
+    detector.Reset();
+
+    CHECK(!detector.IsPaused());
+    CHECK_EQ(detector.LastSequence(ClipboardSource::Clipboard), 0u);
+    CHECK_EQ(detector.Stats().reported, 0u);
+    CHECK(detector.Report(ClipboardSource::Clipboard, 3));
+}
+
+TEST(OpenSelfWriteSuppressesNewerSequences) {
+    ClipboardChangeDetector detector;
+    int count = 0;
+    detector.SetSink([&](const ClipboardChange&) { count++; });
+
+    CHECK(detector.Report(ClipboardSource::Clipboard, 10));
+    uint64_t token = detector.BeginSelfWrite(ClipboardSource::Clipboard, 10);
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 11));  // 清空
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 12));  // 模拟复制
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 13));  // 恢复
+    detector.EndSelfWrite(token, 13);
+
+    // 结束后紧接着的用户复制照常分发，没有时间窗口
+    CHECK(detector.Report(ClipboardSource::Clipboard, 14));
+    CHECK_EQ(count, 2);
+    CHECK_EQ(detector.Stats().suppressed, 3u);
+}
+
+TEST(ClosedSelfWriteSuppressesLateNotifications) {
+    ClipboardChangeDetector detector;
+    int count = 0;
+    detector.SetSink([&](const ClipboardChange&) { count++; });
+
+    // 写入期间后端一次都没来得及上报（通知被合并或延迟）
+    uint64_t token = detector.BeginSelfWrite(ClipboardSource::Clipboard, 20);
+    detector.EndSelfWrite(token, 23);
+
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 22));
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 23));
+    CHECK(detector.Report(ClipboardSource::Clipboard, 24));
+    CHECK_EQ(count, 1);
+    CHECK_EQ(detector.Stats().suppressed, 2u);
+
+    // 区间已全部上报，令牌回收后序列号回绕也不会误伤
+    detector.Reset();
+    CHECK(detector.Report(ClipboardSource::Clipboard, 21));
+}
+
+TEST(SelfWriteWithoutSequenceOnlyCoversOpenWindow) {
+    ClipboardChangeDetector detector;
+    int count = 0;
+    detector.SetSink([&](const ClipboardChange&) { count++; });
+
+    uint64_t token = detector.BeginSelfWrite(ClipboardSource::Clipboard, 0);
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 0));
+    detector.EndSelfWrite(token, 0);
+    CHECK(detector.Report(ClipboardSource::Clipboard, 0));
+    CHECK_EQ(count, 1);
+}
+
+TEST(SelfWriteIsPerSourceAndNoOpWriteIsReleased) {
+    ClipboardChangeDetector detector;
+    detector.SetSourceEnabled(ClipboardSource::Primary, true);
+    int count = 0;
+    detector.SetSink([&](const ClipboardChange&) { count++; });
+
+    uint64_t token = detector.BeginSelfWrite(ClipboardSource::Clipboard, 5);
+    CHECK(detector.Report(ClipboardSource::Primary, 6));
+    // 写入失败、序列号未变化：令牌立即回收
+    detector.EndSelfWrite(token, 5);
+    CHECK(detector.Report(ClipboardSource::Clipboard, 6));
+    CHECK_EQ(count, 2);
+    CHECK_EQ(detector.Stats().suppressed, 0u);
+}
+
+TEST(SelfWriteScopeUsesCurrentSequence) {
+    ClipboardChangeDetector detector;
+    int count = 0;
+    detector.SetSink([&](const ClipboardChange&) { count++; });
+
+    uint64_t sequence = 100;
+    {
+        ztools::ClipboardSelfWriteScope scope(detector, ClipboardSource::Clipboard, [&]() { return sequence; });
+        sequence += 2;
+    }
+    CHECK(!detector.Report(ClipboardSource::Clipboard, 102));
+    CHECK(detector.Report(ClipboardSource::Clipboard, 103));
+    CHECK_EQ(count, 1);
+}
+
+TEST(SinkMayQueryDetector) {
+    ClipboardChangeDetector detector;
+    uint64_t seen = 0;
+    detector.SetSink([&](const ClipboardChange&) {
+        seen = detector.LastSequence(ClipboardSource::Clipboard);
+    });
+    detector.Report(ClipboardSource::Clipboard, 42);
+    CHECK_EQ(seen, 42u);
+}
+
+int main() {
+    return ztest::RunAll("ClipboardChangeDetector");
+}
@@ -0,0 +1,58 @@
+#include "test-util.h"
+
+#include <string>
+
+#include "common/clipboard_change_payload.h"
+
+using ztools::StandardClipboardFormatName;
+using ztools::TruncateUtf8;
+
+TEST(ShortTextIsUnchanged) {
+    bool truncated = true;
+    CHECK_EQ(TruncateUtf8("hello", 16, &truncated), "hello");
+    CHECK(!truncated);
+    CHECK_EQ(TruncateUtf8("hello", 5), "hello");
+}
+
+TEST(AsciiIsCutExactly) {
+    bool truncated = false;
+    CHECK_EQ(TruncateUtf8("hello world", 5, &truncated), "hello");
+    CHECK(truncated);
+}
+
+TEST(MultiByteCharIsNotSplit) {
+    // "你好" 每个字符 3 字节
+    const std::string text = "\xE4\xBD\xA0\xE5\xA5\xBD";
+    CHECK_EQ(TruncateUtf8(text, 5), "\xE4\xBD\xA0");
+    CHECK_EQ(TruncateUtf8(text, 3), "\xE4\xBD\xA0");
+    CHECK_EQ(TruncateUtf8(text, 2), "");
+}
+
+TEST(FourByteCharIsNotSplit) {
+    // "a😀b"：表情符号 4 字节
+    const std::string text = "a\xF0\x9F\x98\x80" "b";
+    CHECK_EQ(TruncateUtf8(text, 4), "a");
+    CHECK_EQ(TruncateUtf8(text, 5), "a\xF0\x9F\x98\x80");
+}
+
+TEST(ZeroBudget) {
+    bool truncated = false;
+    CHECK_EQ(TruncateUtf8("abc", 0, &truncated), "");
+    CHECK(truncated);
+    CHECK_EQ(TruncateUtf8("", 0, &truncated), "");
+    CHECK(!truncated);
+}
+
+TEST(StandardFormatNames) {
+    CHECK_EQ(std::string(StandardClipboardFormatName(1)), "CF_TEXT");
+    CHECK_EQ(std::string(StandardClipboardFormatName(13)), "CF_UNICODETEXT");
+    CHECK_EQ(std::string(StandardClipboardFormatName(15)), "CF_HDROP");
+    CHECK_EQ(std::string(StandardClipboardFormatName(17)), "CF_DIBV5");
+    CHECK(StandardClipboardFormatName(0) == nullptr);
+    CHECK(StandardClipboardFormatName(18) == nullptr);
+    CHECK(StandardClipboardFormatName(0xC000) == nullptr);
+}
+
+int main() {
+    return ztest::RunAll("ClipboardChangePayload");
+}
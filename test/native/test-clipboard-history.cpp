@@ -0,0 +1,208 @@
+#include "test-util.h"
+
+#include <string>
+#include <vector>
+
+#include "common/clipboard_history.h"
+#include "common/content_hash.h"
+
+using ztools::ClipboardHistory;
+using ztools::ClipboardHistoryFormat;
+using ztools::ClipboardHistoryOptions;
+using ztools::ContentHash64;
+using ztools::ContentHasher;
+
+namespace {
+
+std::vector<ClipboardHistoryFormat> Text(const std::string& text) {
+    return {{"text", text}};
+}
+
+ClipboardHistoryOptions Options(size_t maxEntries, size_t maxBytes) {
+    ClipboardHistoryOptions options;
+    options.maxEntries = maxEntries;
+    options.maxBytes = maxBytes;
+    return options;
+}
+
+}  // namespace
+
+TEST(HashMatchesXxh64Vectors) {
+    CHECK_EQ(ContentHash64("", 0), 0xEF46DB3751D8E999ULL);
+    CHECK_EQ(ContentHash64("a", 1), 0xD24EC4F1A98C6E5BULL);
+    CHECK_EQ(ContentHash64("abc", 3), 0x44BC2CF5AD770999ULL);
+    CHECK_EQ(ContentHash64(std::string("Nobody inspects the spammish repetition")), 0xFBCEA83C8A378BF1ULL);
+}
+
+TEST(StreamingHashMatchesOneShot) {
+    std::string data;
+    for (int i = 0; i < 1000; i++) data.push_back(static_cast<char>(i * 31));
+    for (size_t split : {0u, 1u, 7u, 31u, 32u, 33u, 500u, 1000u}) {
+        ContentHasher hasher;
+        hasher.Update(data.data(), split);
+        hasher.Update(data.data() + split, data.size() - split);
+        CHECK_EQ(hasher.Digest(), ContentHash64(data));
+    }
+}
+
+TEST(NewestEntryIsIndexZero) {
+    ClipboardHistory history;
+    history.Add(Text("first"), 1, 1000);
+    history.Add(Text("second"), 2, 2000);
+    history.Add(Text("third"), 3, 3000);
+
+    auto page = history.Page(0, 10);
+    CHECK_EQ(page.size(), 3u);
+    CHECK_EQ(*history.GetData(page[0].id, "text"), "third");
+    CHECK_EQ(*history.GetData(page[2].id, "text"), "first");
+    CHECK_EQ(page[0].sequence, 3u);
+
+    auto second = history.Page(1, 1);
+    CHECK_EQ(second.size(), 1u);
+    CHECK_EQ(*history.GetData(second[0].id, "text"), "second");
+    CHECK_EQ(history.Page(3, 10).size(), 0u);
+}
+
+TEST(DuplicateMovesToFront) {
+    ClipboardHistory history;
+    uint64_t a = history.Add(Text("a"), 1, 1000);
+    history.Add(Text("b"), 2, 2000);
+    uint64_t again = history.Add(Text("a"), 3, 5000);
+
+    CHECK_EQ(again, a);
+    CHECK_EQ(history.Size(), 2u);
+    auto page = history.Page(0, 2);
+    CHECK_EQ(page[0].id, a);
+    CHECK_EQ(page[0].copyCount, 2u);
+    CHECK_EQ(page[0].createdAtMs, 1000u);
+    CHECK_EQ(page[0].lastSeenAtMs, 5000u);
+    CHECK_EQ(history.Stats().duplicates, 1u);
+}
+
+TEST(FormatsArePartOfIdentity) {
+    ClipboardHistory history;
+    uint64_t plain = history.Add(Text("x"));
+    uint64_t rich = history.Add({{"text", "x"}, {"html", "<b>x</b>"}});
+    CHECK(plain != rich);
+
+    ztools::ClipboardHistoryEntryInfo info;
+    CHECK(history.GetInfo(rich, info));
+    CHECK_EQ(info.formats.size(), 2u);
+    CHECK_EQ(info.formats[1].name, "html");
+    CHECK_EQ(info.formats[1].size, 8u);
+    CHECK_EQ(info.bytes, 9u);
+    CHECK(history.GetData(rich, "CF_DIB") == nullptr);
+}
+
+TEST(EntryCapacityEvictsLeastRecentlyUsed) {
+    ClipboardHistory history(Options(3, 1 << 20));
+    uint64_t a = history.Add(Text("a"));
+    uint64_t b = history.Add(Text("b"));
+    history.Add(Text("c"));
+    history.Add(Text("a"));  // a 变为最新，b 成为最久未使用
+    history.Add(Text("d"));
+
+    CHECK_EQ(history.Size(), 3u);
+    ztools::ClipboardHistoryEntryInfo info;
+    CHECK(!history.GetInfo(b, info));
+    CHECK(history.GetInfo(a, info));
+    CHECK_EQ(history.Stats().evicted, 1u);
+}
+
+TEST(ByteBudgetEvictsAndRejects) {
+    ClipboardHistory history(Options(100, 10));
+    uint64_t first = history.Add(Text("12345"));
+    history.Add(Text("abcde"));
+    CHECK_EQ(history.Stats().bytes, 10u);
+
+    history.Add(Text("xyz"));
+    ztools::ClipboardHistoryEntryInfo info;
+    CHECK(!history.GetInfo(first, info));
+    CHECK_EQ(history.Stats().bytes, 8u);
+
+    // 单条超过预算：拒绝，不影响已有条目
+    CHECK_EQ(history.Add(Text("this is too large")), 0u);
+    CHECK_EQ(history.Stats().rejected, 1u);
+    CHECK_EQ(history.Size(), 2u);
+}
+
+TEST(DataOutlivesEviction) {
+    ClipboardHistory history(Options(1, 1 << 20));
+    uint64_t id = history.Add(Text("keep me"));
+    auto data = history.GetData(id, "text");
+    history.Add(Text("replacement"));
+    CHECK(history.GetData(id, "text") == nullptr);
+    CHECK_EQ(*data, "keep me");
+}
+
+TEST(RemoveAndClear) {
+    ClipboardHistory history;
+    uint64_t a = history.Add(Text("a"));
+    history.Add(Text("b"));
+    CHECK(history.Remove(a));
+    CHECK(!history.Remove(a));
+    CHECK_EQ(history.Size(), 1u);
+
+    // 删除后同样的内容作为新条目加入
+    uint64_t readded = history.Add(Text("a"));
+    CHECK(readded != a);
+
+    history.Clear();
+    CHECK_EQ(history.Size(), 0u);
+    CHECK_EQ(history.Stats().bytes, 0u);
+    history.Add(Text("after clear"));
+    CHECK_EQ(history.Size(), 1u);
+}
+
+TEST(RemoveFromMiddleKeepsOrderAndPaging) {
+    ClipboardHistory history(Options(4, 1 << 20));
+    history.Add(Text("a"));
+    uint64_t b = history.Add(Text("b"));
+    history.Add(Text("c"));
+    history.Add(Text("d"));
+    CHECK(history.Remove(b));
+    history.Add(Text("a"));  // 最旧的条目移到最新端
+    history.Add(Text("e"));
+    history.Add(Text("f"));  // 槽位已满，淘汰最久未使用的 c
+
+    auto page = history.Page(0, 10);
+    CHECK_EQ(page.size(), 4u);
+    const char* expected[] = {"f", "e", "a", "d"};
+    for (size_t i = 0; i < page.size(); i++) {
+        CHECK_EQ(*history.GetData(page[i].id, "text"), expected[i]);
+    }
+    auto tail = history.Page(2, 10);
+    CHECK_EQ(tail.size(), 2u);
+    CHECK_EQ(tail[0].id, page[2].id);
+    CHECK_EQ(tail[1].id, page[3].id);
+    CHECK_EQ(history.Page(4, 10).size(), 0u);
+}
+
+TEST(ConfigureShrinksAndGrows) {
+    ClipboardHistory history(Options(5, 1 << 20));
+    for (int i = 0; i < 5; i++) {
+        history.Add(Text("entry" + std::to_string(i)));
+    }
+    history.Configure(Options(2, 1 << 20));
+    CHECK_EQ(history.Size(), 2u);
+    auto page = history.Page(0, 5);
+    CHECK_EQ(*history.GetData(page[0].id, "text"), "entry4");
+    CHECK_EQ(*history.GetData(page[1].id, "text"), "entry3");
+
+    // 扩容后保留原有条目与去重索引
+    history.Configure(Options(4, 1 << 20));
+    CHECK_EQ(history.Add(Text("entry3")), page[1].id);
+    history.Add(Text("new1"));
+    history.Add(Text("new2"));
+    CHECK_EQ(history.Size(), 4u);
+}
+
+TEST(EmptyFormatsAreIgnored) {
+    ClipboardHistory history;
+    CHECK_EQ(history.Add({}), 0u);
+    CHECK_EQ(history.Size(), 0u);
+}
+
+int main() {
+    return ztest::RunAll("ClipboardHistory");
+}
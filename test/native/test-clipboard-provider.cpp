@@ -0,0 +1,126 @@
+#include "test-util.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/clipboard_provider.h"
+
+using ztools::ClipboardProvider;
+
+TEST(FormatsAreAdvertisedWithoutRendering) {
+    std::atomic<int> calls(0);
+    ClipboardProvider provider;
+    provider.Add("CF_DIBV5", [&calls](std::string& data) {
+        calls++;
+        data = "dib";
+        return true;
+    });
+    provider.Add("PNG", [&calls](std::string& data) {
+        calls++;
+        data = "png";
+        return true;
+    });
+
+    std::vector<std::string> formats = provider.Formats();
+    CHECK_EQ(formats.size(), 2u);
+    CHECK_EQ(formats[0], "CF_DIBV5");
+    CHECK_EQ(formats[1], "PNG");
+    CHECK(provider.Has("PNG"));
+    CHECK(!provider.Has("CF_BITMAP"));
+    CHECK_EQ(calls.load(), 0);
+    CHECK_EQ(provider.RenderCount(), 0u);
+}
+
+TEST(EachFormatRendersOnce) {
+    int calls = 0;
+    ClipboardProvider provider;
+    provider.Add("PNG", [&calls](std::string& data) {
+        calls++;
+        data = "png";
+        return true;
+    });
+
+    auto first = provider.Render("PNG");
+    auto second = provider.Render("PNG");
+    CHECK(first != nullptr);
+    CHECK(first == second);  // 剪贴板与 JS 共享同一份结果
+    CHECK_EQ(*first, "png");
+    CHECK_EQ(calls, 1);
+    CHECK_EQ(provider.RenderCount(), 1u);
+    CHECK(provider.Render("CF_DIBV5") == nullptr);
+}
+
+TEST(FailedRenderIsNotRetried) {
+    int calls = 0;
+    ClipboardProvider provider;
+    provider.Add("PNG", [&calls](std::string&) {
+        calls++;
+        return false;
+    });
+    CHECK(provider.Render("PNG") == nullptr);
+    CHECK(provider.Render("PNG") == nullptr);
+    CHECK_EQ(calls, 1);
+}
+
+TEST(ConcurrentRequestsShareOneRender) {
+    std::atomic<int> calls(0);
+    ClipboardProvider provider;
+    provider.Add("PNG", [&calls](std::string& data) {
+        calls++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        data.assign(1 << 20, 'x');
+        return true;
+    });
+
+    std::vector<std::thread> threads;
+    std::vector<std::shared_ptr<const std::string>> results(8);
+    for (size_t i = 0; i < results.size(); i++) {
+        threads.emplace_back([&provider, &results, i]() { results[i] = provider.Render("PNG"); });
+    }
+    for (auto& thread : threads) thread.join();
+
+    CHECK_EQ(calls.load(), 1);
+    for (const auto& result : results) {
+        CHECK(result != nullptr && result == results[0]);
+    }
+}
+
+TEST(ReleaseDropsCapturedResources) {
+    auto pixels = std::make_shared<std::string>(4096, 'p');
+    ClipboardProvider provider;
+    provider.Add("PNG", [pixels](std::string& data) {
+        data = *pixels;
+        return true;
+    });
+    auto rendered = provider.Render("PNG");
+    CHECK_EQ(pixels.use_count(), 2);
+
+    provider.Release();
+    CHECK_EQ(pixels.use_count(), 1);
+    CHECK(provider.Formats().empty());
+    CHECK(provider.Render("PNG") == nullptr);
+    // 已交出的渲染结果不受影响
+    CHECK(rendered != nullptr && rendered->size() == 4096u);
+}
+
+TEST(AddingAgainReplacesRenderer) {
+    ClipboardProvider provider;
+    provider.Add("PNG", [](std::string& data) {
+        data = "old";
+        return true;
+    });
+    provider.Add("PNG", [](std::string& data) {
+        data = "new";
+        return true;
+    });
+    CHECK_EQ(provider.Formats().size(), 1u);
+    CHECK_EQ(*provider.Render("PNG"), "new");
+}
+
+int main() {
+    return ztest::RunAll("ClipboardProvider");
+}
@@ -0,0 +1,126 @@
+#include "test-util.h"
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/clipboard_read.h"
+
+using ztools::ClipboardLockStats;
+using ztools::ClipboardLockStatsSnapshot;
+using ztools::ClipboardLockTimer;
+using ztools::DibPixelOffset;
+
+namespace {
+
+// 构造 BITMAPINFOHEADER（+ 额外字节）
+std::string Dib(int32_t width, int32_t height, uint16_t bitCount, uint32_t compression, uint32_t colorsUsed,
+                size_t extra, uint32_t headerSize = 40) {
+    std::string dib(headerSize + extra, '\0');
+    auto put32 = [&](size_t at, uint32_t v) { memcpy(&dib[at], &v, 4); };
+    put32(0, headerSize);
+    put32(4, static_cast<uint32_t>(width));
+    put32(8, static_cast<uint32_t>(height));
+    uint16_t planes = 1;
+    memcpy(&dib[12], &planes, 2);
+    memcpy(&dib[14], &bitCount, 2);
+    put32(16, compression);
+    put32(32, colorsUsed);
+    return dib;
+}
+
+}  // namespace
+
+TEST(LockStatsAccumulate) {
+    ClipboardLockStats stats;
+    stats.Record(100);
+    stats.Record(300);
+    stats.Record(200);
+    ClipboardLockStatsSnapshot s = stats.Snapshot();
+    CHECK_EQ(s.count, 3u);
+    CHECK_EQ(s.totalUs, 600u);
+    CHECK_EQ(s.maxUs, 300u);
+    CHECK_EQ(s.lastUs, 200u);
+
+    stats.Reset();
+    s = stats.Snapshot();
+    CHECK_EQ(s.count, 0u);
+    CHECK_EQ(s.maxUs, 0u);
+}
+
+TEST(TimerRecordsOnce) {
+    ClipboardLockStats stats;
+    {
+        ClipboardLockTimer timer(stats);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        uint64_t held = timer.Stop();
+        CHECK(held >= 4000u);
+        CHECK_EQ(timer.Stop(), held);
+    }
+    CHECK_EQ(stats.Snapshot().count, 1u);
+
+    // 未调用 Stop 时析构记录（提前 return 的路径）
+    { ClipboardLockTimer timer(stats); }
+    CHECK_EQ(stats.Snapshot().count, 2u);
+}
+
+TEST(ConcurrentRecordKeepsMax) {
+    ClipboardLockStats stats;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&stats, t]() {
+            for (uint64_t i = 0; i < 10000; i++) stats.Record(i * 4 + t);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    ClipboardLockStatsSnapshot s = stats.Snapshot();
+    CHECK_EQ(s.count, 40000u);
+    CHECK_EQ(s.maxUs, 9999u * 4 + 3);
+}
+
+TEST(DibOffsetForCommonLayouts) {
+    size_t offset = 0;
+    // 32 位 BI_RGB：像素紧跟头部
+    CHECK(DibPixelOffset(Dib(4, 2, 32, 0, 0, 32).data(), 40 + 32, &offset));
+    CHECK_EQ(offset, 40u);
+
+    // 32 位 BI_BITFIELDS：头部后有 3 个 DWORD 掩码
+    std::string bitfields = Dib(4, 2, 32, 3, 0, 12 + 32);
+    CHECK(DibPixelOffset(bitfields.data(), bitfields.size(), &offset));
+    CHECK_EQ(offset, 52u);
+
+    // 8 位调色板：默认 256 色
+    std::string paletted = Dib(3, 2, 8, 0, 0, 1024 + 8);
+    CHECK(DibPixelOffset(paletted.data(), paletted.size(), &offset));
+    CHECK_EQ(offset, 40u + 1024u);
+
+    // biClrUsed 指定颜色数；自下而上（负高度）
+    std::string used = Dib(3, -2, 4, 0, 5, 20 + 8);
+    CHECK(DibPixelOffset(used.data(), used.size(), &offset));
+    CHECK_EQ(offset, 60u);
+
+    // BITMAPV5HEADER：掩码在头部内
+    std::string v5 = Dib(1, 1, 32, 3, 0, 4, 124);
+    CHECK(DibPixelOffset(v5.data(), v5.size(), &offset));
+    CHECK_EQ(offset, 124u);
+}
+
+TEST(DibOffsetRejectsTruncatedData) {
+    size_t offset = 0;
+    std::string dib = Dib(100, 100, 24, 0, 0, 100);  // 需要 300*100 字节像素
+    CHECK(!DibPixelOffset(dib.data(), dib.size(), &offset));
+    CHECK(!DibPixelOffset(dib.data(), 20, &offset));
+    CHECK(!DibPixelOffset(nullptr, 0, &offset));
+    std::string zeroWidth = Dib(0, 1, 32, 0, 0, 4);
+    CHECK(!DibPixelOffset(zeroWidth.data(), zeroWidth.size(), &offset));
+    std::string badBits = Dib(1, 1, 7, 0, 0, 4);
+    CHECK(!DibPixelOffset(badBits.data(), badBits.size(), &offset));
+    std::string hugeHeader = Dib(1, 1, 32, 0, 0, 4);
+    hugeHeader[0] = '\x7f';
+    CHECK(!DibPixelOffset(hugeHeader.data(), hugeHeader.size(), &offset));
+}
+
+int main() {
+    return ztest::RunAll("ClipboardRead");
+}
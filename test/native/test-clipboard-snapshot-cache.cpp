@@ -0,0 +1,136 @@
+#include "test-util.h"
+
+#include <string>
+#include <vector>
+
+#include "common/clipboard_snapshot_cache.h"
+
+using ztools::ClipboardSlot;
+using ztools::ClipboardSnapshotCache;
+
+namespace {
+
+// 模拟剪贴板：序列号 + 内容 + 读取计数
+struct FakeClipboard {
+    uint64_t sequence = 1;
+    std::string text = "hello";
+    int reads = 0;
+    bool busy = false;
+
+    ClipboardSnapshotCache::SequenceFn Sequence() {
+        return [this]() { return sequence; };
+    }
+    std::function<bool(std::string&)> Loader() {
+        return [this](std::string& out) {
+            reads++;
+            if (busy) return false;
+            out = text;
+            return true;
+        };
+    }
+};
+
+}  // namespace
+
+TEST(RepeatedReadsHitCache) {
+    ClipboardSnapshotCache cache;
+    FakeClipboard cb;
+
+    for (int i = 0; i < 5; i++) {
+        auto text = cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+        CHECK(text != nullptr);
+        CHECK_EQ(*text, "hello");
+    }
+    CHECK_EQ(cb.reads, 1);
+    CHECK_EQ(cache.Stats().hits, 4u);
+    CHECK_EQ(cache.Stats().misses, 1u);
+}
+
+TEST(SequenceChangeInvalidates) {
+    ClipboardSnapshotCache cache;
+    FakeClipboard cb;
+
+    cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+    cb.sequence = 2;
+    cb.text = "world";
+    auto text = cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+    CHECK_EQ(*text, "world");
+    CHECK_EQ(cb.reads, 2);
+}
+
+TEST(SlotsAreIndependent) {
+    ClipboardSnapshotCache cache;
+    FakeClipboard cb;
+    int fileReads = 0;
+    auto loadFiles = [&](std::vector<std::string>& out) {
+        fileReads++;
+        out = {"/a", "/b"};
+        return true;
+    };
+
+    cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+    auto files = cache.Read<std::vector<std::string>>(ClipboardSlot::FilesList, cb.Sequence(), loadFiles);
+    files = cache.Read<std::vector<std::string>>(ClipboardSlot::FilesList, cb.Sequence(), loadFiles);
+    CHECK_EQ(files->size(), 2u);
+    CHECK_EQ(fileReads, 1);
+    CHECK_EQ(cb.reads, 1);
+}
+
+TEST(ZeroSequenceBypassesCache) {
+    ClipboardSnapshotCache cache;
+    FakeClipboard cb;
+    cb.sequence = 0;
+
+    cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+    cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+    CHECK_EQ(cb.reads, 2);
+    CHECK_EQ(cache.Stats().bypassed, 2u);
+    CHECK_EQ(cache.Stats().hits, 0u);
+}
+
+TEST(FailedLoadIsNotCached) {
+    ClipboardSnapshotCache cache;
+    FakeClipboard cb;
+    cb.busy = true;
+
+    CHECK(cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader()) == nullptr);
+    cb.busy = false;
+    auto text = cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+    CHECK(text != nullptr);
+    CHECK_EQ(cb.reads, 2);
+}
+
+TEST(ChangeDuringLoadIsNotCached) {
+    ClipboardSnapshotCache cache;
+    FakeClipboard cb;
+    auto racingLoader = [&](std::string& out) {
+        cb.reads++;
+        out = cb.text;
+        cb.sequence++;  // 读取期间其他程序写入了剪贴板
+        return true;
+    };
+
+    auto text = cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), racingLoader);
+    CHECK_EQ(*text, "hello");
+    CHECK_EQ(cache.Stats().discarded, 1u);
+
+    cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+    CHECK_EQ(cb.reads, 2);
+}
+
+TEST(InvalidateDropsEntries) {
+    ClipboardSnapshotCache cache;
+    FakeClipboard cb;
+
+    cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+    cache.Invalidate();
+    cache.Read<std::string>(ClipboardSlot::Text, cb.Sequence(), cb.Loader());
+    CHECK_EQ(cb.reads, 2);
+
+    cache.ResetStats();
+    CHECK_EQ(cache.Stats().misses, 0u);
+}
+
+int main() {
+    return ztest::RunAll("ClipboardSnapshotCache");
+}
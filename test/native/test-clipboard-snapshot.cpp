@@ -0,0 +1,320 @@
+#include "test-util.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/clipboard_snapshot.h"
+#include "common/content_hash.h"
+
+using ztools::ByteArena;
+using ztools::ClipboardBackend;
+using ztools::ClipboardSnapshot;
+using ztools::ClipboardSnapshotOptions;
+
+namespace {
+
+// 内存剪贴板：记录打开次数，可模拟打开失败/不可读格式/写入失败
+class FakeClipboard : public ClipboardBackend {
+public:
+    std::vector<std::pair<uint32_t, std::string>> formats;  // 保持枚举顺序
+    std::vector<uint32_t> unreadable;
+    uint32_t rejectWrite = 0;
+    bool failOpen = false;
+    bool isOpen = false;
+    int opens = 0;
+    int reads = 0;
+
+    bool Open() override {
+        if (failOpen || isOpen) return false;
+        isOpen = true;
+        opens++;
+        return true;
+    }
+    void Close() override { isOpen = false; }
+
+    std::vector<uint32_t> EnumerateFormats() override {
+        CHECK(isOpen);
+        std::vector<uint32_t> ids;
+        for (const auto& f : formats) ids.push_back(f.first);
+        return ids;
+    }
+
+    bool ReadFormat(uint32_t format, const Reader& reader) override {
+        CHECK(isOpen);
+        reads++;
+        for (uint32_t id : unreadable) {
+            if (id == format) return false;
+        }
+        for (const auto& f : formats) {
+            if (f.first == format) {
+                reader(f.second.data(), f.second.size());
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool Empty() override {
+        CHECK(isOpen);
+        formats.clear();
+        return true;
+    }
+
+    bool WriteFormat(uint32_t format, const void* data, size_t size) override {
+        CHECK(isOpen);
+        if (format == rejectWrite) return false;
+        formats.push_back({format, std::string(static_cast<const char*>(data), size)});
+        return true;
+    }
+};
+
+std::string Binary(size_t size, unsigned seed) {
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; i++) data[i] = static_cast<char>((i * 131 + seed) & 0xFF);
+    return data;
+}
+
+}  // namespace
+
+TEST(ArenaKeepsPointersStable) {
+    ByteArena arena(256);
+    std::vector<std::pair<char*, size_t>> allocations;
+    for (size_t i = 1; i <= 200; i++) {
+        size_t size = (i * 37) % 300 + 1;  // 混合小块与超大块
+        char* p = arena.Allocate(size);
+        memset(p, static_cast<int>(i), size);
+        CHECK_EQ(reinterpret_cast<uintptr_t>(p) % 8, 0u);
+        allocations.push_back({p, size});
+    }
+    for (size_t i = 0; i < allocations.size(); i++) {
+        for (size_t j = 0; j < allocations[i].second; j++) {
+            if (allocations[i].first[j] != static_cast<char>(i + 1)) {
+                CHECK(false);
+                return;
+            }
+        }
+    }
+    CHECK(arena.Used() <= arena.Capacity());
+    CHECK(arena.Allocate(0) == nullptr);
+
+    arena.Reset();
+    CHECK_EQ(arena.Used(), 0u);
+    CHECK_EQ(arena.BlockCount(), 1u);
+    CHECK_EQ(arena.Capacity(), 256u);
+}
+
+TEST(RoundTripIsByteForByte) {
+    FakeClipboard clipboard;
+    const std::string text16("h\0i\0\0\0", 6);
+    const std::string dib = Binary(1 << 20, 7);  // 1MB 位图
+    const std::string html = "Version:0.9\r\nStartHTML:0\r\n<b>x</b>";
+    clipboard.formats = {{13, text16}, {8, dib}, {49321, html}, {49999, std::string()}};
+    const auto original = clipboard.formats;
+
+    ClipboardSnapshot snapshot;
+    CHECK(snapshot.Capture(clipboard));
+    CHECK_EQ(clipboard.opens, 1);
+    CHECK_EQ(snapshot.Entries().size(), 4u);
+    CHECK_EQ(snapshot.Bytes(), text16.size() + dib.size() + html.size());
+    CHECK(!clipboard.isOpen);
+
+    // 模拟复制覆盖剪贴板
+    clipboard.formats = {{13, std::string("n\0e\0w\0\0\0", 8)}};
+
+    size_t written = 0;
+    CHECK(snapshot.Restore(clipboard, &written));
+    CHECK_EQ(written, 4u);
+    CHECK_EQ(clipboard.opens, 2);
+    CHECK(clipboard.formats == original);
+}
+
+TEST(FormatFilterAndFind) {
+    FakeClipboard clipboard;
+    clipboard.formats = {{1, "ansi"}, {13, "wide"}, {15, "drop"}, {8, "dib"}};
+    ClipboardSnapshotOptions options;
+    options.formats = {13, 15, 8};
+
+    ClipboardSnapshot snapshot;
+    CHECK(snapshot.Capture(clipboard, options));
+    CHECK_EQ(snapshot.Entries().size(), 3u);
+    CHECK_EQ(clipboard.reads, 3);  // 未选中的格式不读取
+    CHECK(snapshot.Find(1) == nullptr);
+    const ClipboardSnapshot::Entry* drop = snapshot.Find(15);
+    CHECK(drop != nullptr);
+    CHECK_EQ(std::string(drop->data, drop->size), "drop");
+}
+
+TEST(UnreadableAndOversizedFormatsAreSkipped) {
+    FakeClipboard clipboard;
+    clipboard.formats = {{2, "gdi-handle"}, {13, "text"}, {8, Binary(1000, 1)}, {49400, "tail"}};
+    clipboard.unreadable = {2};
+    ClipboardSnapshotOptions options;
+    options.maxBytes = 100;
+
+    ClipboardSnapshot snapshot;
+    CHECK(snapshot.Capture(clipboard, options));
+    CHECK_EQ(snapshot.Skipped(), 2u);
+    CHECK_EQ(snapshot.Entries().size(), 2u);
+    CHECK(snapshot.Find(13) != nullptr);
+    CHECK(snapshot.Find(49400) != nullptr);  // 超限格式之后的小格式仍会保存
+}
+
+TEST(OpenFailureIsReported) {
+    FakeClipboard clipboard;
+    clipboard.formats = {{13, "text"}};
+    clipboard.failOpen = true;
+
+    ClipboardSnapshot snapshot;
+    CHECK(!snapshot.Capture(clipboard));
+    CHECK(!snapshot.Captured());
+    CHECK(!snapshot.Restore(clipboard));
+    CHECK_EQ(clipboard.formats.size(), 1u);  // 未清空
+}
+
+TEST(PartialRestoreContinues) {
+    FakeClipboard clipboard;
+    clipboard.formats = {{13, "text"}, {49161, "rejected"}, {8, "dib"}};
+    ClipboardSnapshot snapshot;
+    CHECK(snapshot.Capture(clipboard));
+
+    clipboard.rejectWrite = 49161;
+    size_t written = 0;
+    CHECK(!snapshot.Restore(clipboard, &written));
+    CHECK_EQ(written, 2u);
+    CHECK_EQ(clipboard.formats.size(), 2u);
+    CHECK_EQ(clipboard.formats[1].first, 8u);
+}
+
+TEST(EmptyClipboardRestoresToEmpty) {
+    FakeClipboard clipboard;
+    ClipboardSnapshot snapshot;
+    CHECK(snapshot.Capture(clipboard));
+    CHECK(snapshot.Captured());
+    CHECK(snapshot.Empty());
+
+    clipboard.formats = {{13, "copied"}};
+    CHECK(snapshot.Restore(clipboard));
+    CHECK(clipboard.formats.empty());
+}
+
+TEST(RecaptureReusesArena) {
+    FakeClipboard clipboard;
+    clipboard.formats = {{13, Binary(100, 3)}};
+    ClipboardSnapshot snapshot;
+    for (int i = 0; i < 3; i++) {
+        clipboard.formats[0].second = Binary(100, i);
+        CHECK(snapshot.Capture(clipboard));
+        CHECK_EQ(snapshot.Entries().size(), 1u);
+        CHECK_EQ(std::string(snapshot.Entries()[0].data, 100), Binary(100, i));
+    }
+}
+
+TEST(HashesMatchWhileCopying) {
+    FakeClipboard clipboard;
+    const std::string dib = Binary(300000, 9);  // 跨越多个复制块
+    clipboard.formats = {{13, "text"}, {8, dib}};
+    ClipboardSnapshotOptions options;
+    options.hashFormats = {8};
+
+    ClipboardSnapshot snapshot;
+    CHECK(snapshot.Capture(clipboard, options));
+    const ClipboardSnapshot::Entry* entry = snapshot.Find(8);
+    CHECK(entry->hashed);
+    CHECK_EQ(entry->hash, ztools::ContentHash64(dib));
+    CHECK_EQ(std::string(entry->data, entry->size), dib);
+    CHECK(!snapshot.Find(13)->hashed);
+}
+
+TEST(HashOnlyFormatsAreNotCopied) {
+    FakeClipboard clipboard;
+    const std::string dib = Binary(1 << 20, 5);
+    clipboard.formats = {{13, "text"}, {8, dib}};
+    ClipboardSnapshotOptions options;
+    options.hashFormats = {13};
+    options.hashOnly = {8};
+
+    ClipboardSnapshot snapshot;
+    CHECK(snapshot.Capture(clipboard, options));
+    const ClipboardSnapshot::Entry* entry = snapshot.Find(8);
+    CHECK(entry->data == nullptr);
+    CHECK_EQ(entry->size, dib.size());
+    CHECK_EQ(entry->hash, ztools::ContentHash64(dib));
+    CHECK_EQ(snapshot.Bytes(), 4u);  // 只计入复制的文本
+
+    // 只有哈希的快照不能用于恢复
+    CHECK(!snapshot.Restore(clipboard));
+}
+
+TEST(HashOnlyCopiesWhenDifferentFromBaseline) {
+    FakeClipboard clipboard;
+    const std::string dib = Binary(1 << 20, 5);
+    clipboard.formats = {{13, "text"}, {8, dib}};
+    ClipboardSnapshotOptions options;
+    options.hashFormats = {13, 8};
+    options.hashOnly = {8};
+    ClipboardSnapshot original;
+    CHECK(original.Capture(clipboard, options));
+
+    // 图像未变化：只保留哈希
+    options.baseline = &original;
+    ClipboardSnapshot unchanged;
+    CHECK(unchanged.Capture(clipboard, options));
+    CHECK(unchanged.Find(8)->data == nullptr);
+    CHECK(ClipboardSnapshot::SameContent(unchanged.Find(8), original.Find(8)));
+
+    // 同样大小、内容不同，以及大小不同：一次打开内完整复制，并带有哈希
+    for (const std::string& image : {Binary(1 << 20, 6), Binary((1 << 20) + 4, 5)}) {
+        clipboard.formats = {{13, "text"}, {8, image}};
+        const int opens = clipboard.opens;
+        ClipboardSnapshot changed;
+        CHECK(changed.Capture(clipboard, options));
+        CHECK_EQ(clipboard.opens, opens + 1);
+        const ClipboardSnapshot::Entry* entry = changed.Find(8);
+        CHECK(entry->data != nullptr);
+        CHECK_EQ(std::string(entry->data, entry->size), image);
+        CHECK(entry->hashed);
+        CHECK_EQ(entry->hash, ztools::ContentHash64(image));
+        CHECK(!ClipboardSnapshot::SameContent(entry, original.Find(8)));
+    }
+
+    // baseline 中没有该格式时同样视为变化
+    ClipboardSnapshot empty;
+    FakeClipboard blank;
+    CHECK(empty.Capture(blank));
+    options.baseline = &empty;
+    ClipboardSnapshot added;
+    CHECK(added.Capture(clipboard, options));
+    CHECK(added.Find(8)->data != nullptr);
+}
+
+TEST(SameContentComparesLengthThenHash) {
+    FakeClipboard before;
+    before.formats = {{13, "same"}, {15, "drop-a"}, {8, Binary(5000, 1)}};
+    FakeClipboard after;
+    after.formats = {{13, "same"}, {15, "drop-b"}, {8, Binary(5001, 1)}};
+
+    ClipboardSnapshotOptions options;
+    options.hashFormats = {13, 15, 8};
+    ClipboardSnapshot a;
+    ClipboardSnapshot b;
+    CHECK(a.Capture(before, options));
+    options.hashOnly = {8};
+    CHECK(b.Capture(after, options));
+
+    CHECK(ClipboardSnapshot::SameContent(a.Find(13), b.Find(13)));
+    CHECK(!ClipboardSnapshot::SameContent(a.Find(15), b.Find(15)));
+    CHECK(!ClipboardSnapshot::SameContent(a.Find(8), b.Find(8)));
+    CHECK(!ClipboardSnapshot::SameContent(a.Find(13), nullptr));
+    CHECK(ClipboardSnapshot::SameContent(a.Find(99), b.Find(99)));
+
+    // 没有哈希时逐字节比较
+    ClipboardSnapshot c;
+    CHECK(c.Capture(before));
+    CHECK(ClipboardSnapshot::SameContent(c.Find(15), a.Find(15)));
+    CHECK(!ClipboardSnapshot::SameContent(c.Find(15), b.Find(15)));
+}
+
+int main() {
+    return ztest::RunAll("ClipboardSnapshot");
+}
@@ -0,0 +1,337 @@
+#include "test-util.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/clipboard_read.h"
+#include "common/clipboard_write.h"
+#include "common/pasteboard.h"
+
+using ztools::ClipboardWriteBlob;
+using ztools::ClipboardWriteFormat;
+using ztools::ClipboardWriteImage;
+using ztools::ClipboardWriteItem;
+using ztools::ClipboardWriteRequest;
+
+namespace {
+
+uint32_t Load32(const std::string& s, size_t at) {
+    uint32_t v;
+    memcpy(&v, s.data() + at, 4);
+    return v;
+}
+
+uint16_t Load16(const std::string& s, size_t at) {
+    uint16_t v;
+    memcpy(&v, s.data() + at, 2);
+    return v;
+}
+
+// CF_HTML 头部中某个偏移字段的值
+size_t HeaderValue(const std::string& cfHtml, const std::string& name) {
+    size_t pos = cfHtml.find(name + ":");
+    return pos == std::string::npos ? 0 : static_cast<size_t>(std::stoul(cfHtml.substr(pos + name.size() + 1, 10)));
+}
+
+// 2x2 图像，像素 i 的 BGRA 为 (i, 10+i, 20+i, 30+i)，每行额外 4 字节填充
+ClipboardWriteImage TestImage() {
+    ClipboardWriteImage image;
+    image.width = 2;
+    image.height = 2;
+    image.stride = 12;
+    image.bgra.assign(24, '\xee');
+    for (int i = 0; i < 4; i++) {
+        size_t at = (i / 2) * 12 + (i % 2) * 4;
+        image.bgra[at] = static_cast<char>(i);
+        image.bgra[at + 1] = static_cast<char>(10 + i);
+        image.bgra[at + 2] = static_cast<char>(20 + i);
+        image.bgra[at + 3] = static_cast<char>(30 + i);
+    }
+    return image;
+}
+
+// 内存剪贴板：可让指定格式的写入失败
+class FakeClipboard : public ztools::ClipboardBackend {
+public:
+    std::vector<std::pair<uint32_t, std::string>> formats;
+    uint32_t rejectWrite = 0;
+    bool failOpen = false;
+    bool isOpen = false;
+
+    bool Open() override {
+        if (failOpen) return false;
+        isOpen = true;
+        return true;
+    }
+    void Close() override { isOpen = false; }
+    std::vector<uint32_t> EnumerateFormats() override { return {}; }
+    bool ReadFormat(uint32_t, const Reader&) override { return false; }
+    bool Empty() override {
+        CHECK(isOpen);
+        formats.clear();
+        return true;
+    }
+    bool WriteFormat(uint32_t format, const void* data, size_t size) override {
+        CHECK(isOpen);
+        if (format == rejectWrite) return false;
+        formats.emplace_back(format, std::string(static_cast<const char*>(data), size));
+        return true;
+    }
+};
+
+}  // namespace
+
+TEST(Utf8ToUtf16HandlesSurrogatesAndInvalidBytes) {
+    // "a" + U+00E9 + U+4E2D + U+1F600
+    std::string utf16 = ztools::Utf8ToUtf16Le("a\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80");
+    CHECK_EQ(utf16.size(), 10u);
+    CHECK_EQ(Load16(utf16, 0), 0x61);
+    CHECK_EQ(Load16(utf16, 2), 0xE9);
+    CHECK_EQ(Load16(utf16, 4), 0x4E2D);
+    CHECK_EQ(Load16(utf16, 6), 0xD83D);
+    CHECK_EQ(Load16(utf16, 8), 0xDE00);
+
+    // 截断序列、孤立续字节、过长编码与编码的代理项都替换为 U+FFFD
+    std::string bad = ztools::Utf8ToUtf16Le(std::string("\x80\xC0\xAF\xED\xA0\x80\xE4\xB8"));
+    CHECK(!bad.empty());
+    for (size_t i = 0; i < bad.size(); i += 2) {
+        CHECK_EQ(Load16(bad, i), 0xFFFD);
+    }
+}
+
+TEST(CfHtmlOffsetsPointAtFragment) {
+    const std::string fragment = "<b>\xE4\xB8\xAD</b>";
+    std::string cf = ztools::BuildCfHtml(fragment);
+    size_t startHtml = HeaderValue(cf, "StartHTML");
+    size_t endHtml = HeaderValue(cf, "EndHTML");
+    size_t start = HeaderValue(cf, "StartFragment");
+    size_t end = HeaderValue(cf, "EndFragment");
+    CHECK_EQ(cf.compare(startHtml, 6, "<html>"), 0);
+    CHECK_EQ(endHtml, cf.size());
+    CHECK_EQ(cf.substr(start, end - start), fragment);
+
+    // 已带标记的文档不再包装
+    const std::string doc = "<html><body><!--StartFragment--><i>x</i><!--EndFragment--></body></html>";
+    cf = ztools::BuildCfHtml(doc);
+    start = HeaderValue(cf, "StartFragment");
+    end = HeaderValue(cf, "EndFragment");
+    CHECK_EQ(cf.substr(start, end - start), std::string("<i>x</i>"));
+    CHECK_EQ(cf.substr(HeaderValue(cf, "StartHTML")), doc);
+}
+
+TEST(DibIsBottomUpBgraWithoutPadding) {
+    std::string dib;
+    CHECK(ztools::BuildDibFromBgra(TestImage(), dib));
+    CHECK_EQ(dib.size(), 40u + 16u);
+    CHECK_EQ(Load32(dib, 0), 40u);
+    CHECK_EQ(Load32(dib, 4), 2u);
+    CHECK_EQ(Load32(dib, 8), 2u);
+    CHECK_EQ(Load16(dib, 14), 32);
+    CHECK_EQ(Load32(dib, 20), 16u);
+
+    size_t offset = 0;
+    CHECK(ztools::DibPixelOffset(dib.data(), dib.size(), &offset));
+    CHECK_EQ(offset, 40u);
+    // 第一行像素来自图像底行（像素 2、3）
+    CHECK_EQ(dib[40], 2);
+    CHECK_EQ(dib[44], 3);
+    CHECK_EQ(dib[48], 0);
+    CHECK_EQ(dib[52 + 3], 31);
+}
+
+TEST(DibV5CarriesAlphaMaskAndSharesPixelLayout) {
+    std::string dib;
+    std::string plain;
+    CHECK(ztools::BuildDibV5FromBgra(TestImage(), dib));
+    CHECK(ztools::BuildDibFromBgra(TestImage(), plain));
+    CHECK_EQ(dib.size(), 124u + 16u);
+    CHECK_EQ(Load32(dib, 0), 124u);
+    CHECK_EQ(Load32(dib, 16), 3u);           // BI_BITFIELDS
+    CHECK_EQ(Load32(dib, 52), 0xFF000000u);  // bV5AlphaMask
+    CHECK_EQ(Load32(dib, 56), 0x73524742u);  // LCS_sRGB
+
+    size_t offset = 0;
+    CHECK(ztools::DibPixelOffset(dib.data(), dib.size(), &offset));
+    CHECK_EQ(offset, 124u);
+    CHECK(dib.compare(124, 16, plain, 40, 16) == 0);
+}
+
+TEST(TiffStoresRgbaStrip) {
+    std::string tiff;
+    CHECK(ztools::BuildTiffFromBgra(TestImage(), tiff));
+    CHECK_EQ(tiff.compare(0, 4, std::string("II*\0", 4)), 0);
+    uint32_t ifd = Load32(tiff, 4);
+    uint16_t entries = Load16(tiff, ifd);
+    uint32_t stripOffset = 0;
+    uint32_t stripBytes = 0;
+    uint16_t lastTag = 0;
+    for (uint16_t i = 0; i < entries; i++) {
+        size_t at = ifd + 2 + i * 12;
+        uint16_t tag = Load16(tiff, at);
+        CHECK(tag > lastTag);
+        lastTag = tag;
+        if (tag == 273) stripOffset = Load32(tiff, at + 8);
+        if (tag == 279) stripBytes = Load32(tiff, at + 8);
+    }
+    CHECK_EQ(stripBytes, 16u);
+    CHECK_EQ(stripOffset + stripBytes, tiff.size());
+    // 像素 1：BGRA (1, 11, 21, 31) → RGBA (21, 11, 1, 31)
+    CHECK_EQ(tiff[stripOffset + 4], 21);
+    CHECK_EQ(tiff[stripOffset + 5], 11);
+    CHECK_EQ(tiff[stripOffset + 6], 1);
+    CHECK_EQ(tiff[stripOffset + 7], 31);
+}
+
+TEST(ImageValidationRejectsShortBuffers) {
+    ClipboardWriteImage image = TestImage();
+    std::string error;
+    CHECK(ztools::ValidateClipboardWriteImage(image, &error));
+    // 最后一行不需要完整 stride
+    image.bgra.resize(20);
+    CHECK(ztools::ValidateClipboardWriteImage(image, &error));
+    image.bgra.resize(19);
+    CHECK(!ztools::ValidateClipboardWriteImage(image, &error));
+    CHECK(!error.empty());
+
+    image = TestImage();
+    image.stride = 4;
+    CHECK(!ztools::ValidateClipboardWriteImage(image, nullptr));
+    image.stride = 0;
+    image.width = 0;
+    CHECK(!ztools::ValidateClipboardWriteImage(image, nullptr));
+    image.width = 65536;
+    image.height = 65536;
+    CHECK(!ztools::ValidateClipboardWriteImage(image, nullptr));
+}
+
+TEST(BlobsCoverEveryRequestedFormat) {
+    ClipboardWriteRequest request;
+    request.hasText = true;
+    request.text = "hi";
+    request.hasHtml = true;
+    request.html = "<p>hi</p>";
+    request.hasRtf = true;
+    request.rtf = "{\\rtf1 hi}";
+    request.hasImage = true;
+    request.image = TestImage();
+    request.hasFiles = true;
+    request.files = {"C:\\a.txt", "", "C:\\\xE4\xB8\xAD"};
+
+    std::vector<ClipboardWriteBlob> blobs;
+    std::string error;
+    CHECK(ztools::BuildClipboardWriteBlobs(request, blobs, &error));
+    CHECK_EQ(blobs.size(), 5u);
+    CHECK(blobs[0].format == ClipboardWriteFormat::UnicodeText);
+    CHECK_EQ(blobs[0].data, std::string("h\0i\0\0\0", 6));
+    CHECK(blobs[1].format == ClipboardWriteFormat::Html);
+    CHECK_EQ(blobs[1].data.back(), '\0');
+    CHECK(blobs[2].format == ClipboardWriteFormat::Rtf);
+    CHECK_EQ(blobs[2].data, std::string("{\\rtf1 hi}\0", 11));
+    CHECK(blobs[3].format == ClipboardWriteFormat::Dib);
+
+    // DROPFILES：20 字节头部，空路径被跳过，双 NUL 结尾
+    const std::string& drop = blobs[4].data;
+    CHECK(blobs[4].format == ClipboardWriteFormat::Files);
+    CHECK_EQ(Load32(drop, 0), 20u);
+    CHECK_EQ(Load32(drop, 16), 1u);
+    CHECK_EQ(drop.size(), 20u + (8 + 1) * 2 + (4 + 1) * 2 + 2);
+    CHECK_EQ(Load16(drop, 20 + 8 * 2), 0);
+    CHECK_EQ(Load16(drop, drop.size() - 4), 0);
+    CHECK_EQ(Load16(drop, drop.size() - 2), 0);
+
+    ClipboardWriteRequest empty;
+    CHECK(!ztools::BuildClipboardWriteBlobs(empty, blobs, &error));
+    ClipboardWriteRequest noPaths;
+    noPaths.hasFiles = true;
+    noPaths.files = {""};
+    CHECK(!ztools::BuildClipboardWriteBlobs(noPaths, blobs, &error));
+    CHECK(blobs.empty());
+}
+
+TEST(PngIsWrittenVerbatimAfterSignatureCheck) {
+    const std::string png("\x89PNG\r\n\x1a\n\x00\x00\x00\x0dIHDR", 16);
+    ClipboardWriteRequest request;
+    request.hasPng = true;
+    request.png = png;
+    CHECK(!request.Empty());
+
+    std::vector<ClipboardWriteBlob> blobs;
+    std::string error;
+    CHECK(ztools::BuildClipboardWriteBlobs(request, blobs, &error));
+    CHECK_EQ(blobs.size(), 1u);
+    CHECK(blobs[0].format == ClipboardWriteFormat::Png);
+    CHECK(blobs[0].data == png);
+
+    ztools::PasteboardSnapshot snapshot;
+    CHECK(ztools::BuildPasteboardWriteSnapshot(request, snapshot, &error));
+    CHECK_EQ(snapshot.items.size(), 1u);
+    CHECK_EQ(snapshot.items[0].entries[0].type, std::string("public.png"));
+    CHECK(snapshot.items[0].entries[0].data == png);
+
+    request.png = "GIF89a";
+    CHECK(!ztools::BuildClipboardWriteBlobs(request, blobs, &error));
+    CHECK_EQ(error, std::string("png is not PNG data"));
+    CHECK(!ztools::BuildPasteboardWriteSnapshot(request, snapshot, nullptr));
+}
+
+TEST(PasteboardSnapshotRoundTripsFileUrls) {
+    ClipboardWriteRequest request;
+    request.hasText = true;
+    request.text = "hi";
+    request.hasImage = true;
+    request.image = TestImage();
+    request.hasFiles = true;
+    request.files = {"/tmp/a b.txt", "/tmp/\xE4\xB8\xAD#1"};
+
+    ztools::PasteboardSnapshot snapshot;
+    CHECK(ztools::BuildPasteboardWriteSnapshot(request, snapshot, nullptr));
+    CHECK_EQ(snapshot.items.size(), 2u);
+    CHECK_EQ(snapshot.items[0].entries.size(), 3u);
+    CHECK_EQ(snapshot.items[0].entries[0].type, std::string("public.utf8-plain-text"));
+    CHECK_EQ(snapshot.items[0].entries[1].type, std::string("public.tiff"));
+    CHECK_EQ(snapshot.items[0].entries[2].data, std::string("file:///tmp/a%20b.txt"));
+
+    // 经过快照编码后仍可还原，URL 能被 ParseUriList 解回原路径
+    std::string encoded = ztools::EncodePasteboardSnapshot(snapshot);
+    ztools::PasteboardSnapshot decoded;
+    CHECK(ztools::DecodePasteboardSnapshot(encoded.data(), encoded.size(), decoded));
+    std::string uriList = decoded.items[0].entries[2].data + "\r\n" + decoded.items[1].entries[0].data + "\r\n";
+    std::vector<std::string> paths = ztools::ParseUriList(uriList);
+    CHECK_EQ(paths.size(), 2u);
+    CHECK_EQ(paths[0], request.files[0]);
+    CHECK_EQ(paths[1], request.files[1]);
+}
+
+TEST(PublishIsAllOrNothing) {
+    const std::string text = "text";
+    const std::string html = "html";
+    const std::string dib = "dib";
+    const std::vector<ClipboardWriteItem> items = {{13, &text}, {49300, &html}, {8, &dib}};
+
+    FakeClipboard clipboard;
+    clipboard.formats = {{1, "old"}};
+    std::string error;
+    CHECK(ztools::PublishClipboardWrite(clipboard, items, &error));
+    CHECK(!clipboard.isOpen);
+    CHECK_EQ(clipboard.formats.size(), 3u);
+    CHECK_EQ(clipboard.formats[1].second, "html");
+
+    // 中途失败：已写入的文本被撤销，旧内容也不保留
+    clipboard.formats = {{1, "old"}};
+    clipboard.rejectWrite = 49300;
+    CHECK(!ztools::PublishClipboardWrite(clipboard, items, &error));
+    CHECK(!clipboard.isOpen);
+    CHECK(clipboard.formats.empty());
+    CHECK_EQ(error, "SetClipboardData failed");
+
+    // 无法打开时不触碰剪贴板
+    clipboard.formats = {{1, "old"}};
+    clipboard.failOpen = true;
+    CHECK(!ztools::PublishClipboardWrite(clipboard, items, &error));
+    CHECK_EQ(clipboard.formats.size(), 1u);
+}
+
+int main() {
+    return ztest::RunAll("ClipboardWrite");
+}
@@ -0,0 +1,211 @@
+#include "test-util.h"
+
+#include <vector>
+
+#include "common/event_coalescer.h"
+
+using ztools::CoalescedBurst;
+using ztools::CoalescerOptions;
+using ztools::CoalesceReason;
+using ztools::EventCoalescer;
+
+namespace {
+
+// 可手动推进的时钟 + 触发记录
+struct Harness {
+    uint64_t now = 1000000;
+    std::vector<CoalescedBurst> fired;
+    EventCoalescer coalescer;
+
+    explicit Harness(const CoalescerOptions& options)
+        : coalescer(options, [this]() { return now; }) {
+        coalescer.SetSink([this](const CoalescedBurst& b) { fired.push_back(b); });
+    }
+
+    void Advance(uint64_t us) {
+        now += us;
+        coalescer.Poll();
+    }
+};
+
+CoalescerOptions Options(bool leading, uint64_t quietMs, uint64_t maxWaitMs) {
+    CoalescerOptions options;
+    options.leading = leading;
+    options.quietUs = quietMs * 1000;
+    options.maxWaitUs = maxWaitMs * 1000;
+    return options;
+}
+
+}  // namespace
+
+TEST(SingleEventFiresImmediatelyWithLeading) {
+    Harness h(Options(true, 100, 500));
+    CHECK(h.coalescer.Push());
+    CHECK_EQ(h.fired.size(), 1u);
+    CHECK(h.fired[0].reason == CoalesceReason::Leading);
+
+    // 之后没有新事件：静默期结束不再触发
+    h.Advance(200000);
+    CHECK_EQ(h.fired.size(), 1u);
+    CHECK_EQ(h.coalescer.PendingGroups(), 0u);
+}
+
+TEST(BurstFiresLeadingAndTrailing) {
+    Harness h(Options(true, 100, 500));
+    h.coalescer.Push();
+    for (int i = 0; i < 4; i++) {
+        h.Advance(20000);
+        h.coalescer.Push();
+    }
+    CHECK_EQ(h.fired.size(), 1u);
+
+    h.Advance(99000);
+    CHECK_EQ(h.fired.size(), 1u);
+    h.Advance(1000);
+    CHECK_EQ(h.fired.size(), 2u);
+    CHECK(h.fired[1].reason == CoalesceReason::Quiet);
+    CHECK_EQ(h.fired[1].count, 4u);
+    CHECK_EQ(h.fired[1].lastUs - h.fired[1].firstUs, 60000u);
+}
+
+TEST(TrailingOnlyMatchesFixedDebounce) {
+    // leading=false 等价于原来的 SetTimer(100ms) 防抖
+    Harness h(Options(false, 100, 0));
+    CHECK(!h.coalescer.Push());
+    h.Advance(50000);
+    h.coalescer.Push();
+    h.Advance(99000);
+    CHECK_EQ(h.fired.size(), 0u);
+    h.Advance(1000);
+    CHECK_EQ(h.fired.size(), 1u);
+    CHECK_EQ(h.fired[0].count, 2u);
+}
+
+TEST(LeadingAndTrailingCannotBothBeDisabled) {
+    // 两者都关闭时永远不会触发：按 trailing 处理
+    CoalescerOptions options = Options(false, 100, 0);
+    options.trailing = false;
+    Harness h(options);
+    CHECK(h.coalescer.Options().trailing);
+    h.coalescer.Push();
+    h.Advance(100000);
+    CHECK_EQ(h.fired.size(), 1u);
+    CHECK(h.fired[0].reason == CoalesceReason::Quiet);
+
+    h.coalescer.SetOptions(options);
+    CHECK(h.coalescer.Options().trailing);
+}
+
+TEST(MaxWaitCapsContinuousStream) {
+    Harness h(Options(false, 100, 300));
+    // 每 50ms 一个事件，持续 1 秒：静默期永远不会结束
+    for (int i = 0; i < 20; i++) {
+        h.coalescer.Push();
+        h.Advance(50000);
+    }
+    size_t maxWaitFires = 0;
+    for (const CoalescedBurst& b : h.fired) {
+        if (b.reason == CoalesceReason::MaxWait) maxWaitFires++;
+        CHECK(b.firedUs - b.firstUs <= 300000u);
+    }
+    CHECK_EQ(maxWaitFires, 3u);
+
+    h.Advance(100000);
+    CHECK(h.fired.back().reason == CoalesceReason::Quiet);
+}
+
+TEST(GroupsAreIndependent) {
+    Harness h(Options(false, 100, 0));
+    h.coalescer.Push(1);
+    h.Advance(60000);
+    h.coalescer.Push(2);
+    CHECK_EQ(h.coalescer.PendingGroups(), 2u);
+
+    h.Advance(40000);
+    CHECK_EQ(h.fired.size(), 1u);
+    CHECK_EQ(h.fired[0].key, 1u);
+    h.Advance(60000);
+    CHECK_EQ(h.fired.size(), 2u);
+    CHECK_EQ(h.fired[1].key, 2u);
+}
+
+TEST(KeyChangeWithinBurstStaysInOneGroup) {
+    Harness h(Options(false, 100, 0));
+    // 格式集合逐步扩大（按位表示）视为同一轮
+    h.coalescer.SetKeyMatcher([](uint64_t burstKey, uint64_t key) { return (key & burstKey) == burstKey; });
+    h.coalescer.Push(0x1);
+    h.Advance(30000);
+    h.coalescer.Push(0x3);
+    h.Advance(30000);
+    h.coalescer.Push(0x7);
+    CHECK_EQ(h.coalescer.PendingGroups(), 1u);
+
+    h.Advance(100000);
+    CHECK_EQ(h.fired.size(), 1u);
+    CHECK_EQ(h.fired[0].key, 0x1u);
+    CHECK_EQ(h.fired[0].count, 3u);
+
+    // 与进行中分组不匹配的键另起一轮
+    h.coalescer.Push(0x2);
+    h.Advance(10000);
+    h.coalescer.Push(0x4);
+    CHECK_EQ(h.coalescer.PendingGroups(), 2u);
+    h.Advance(100000);
+    CHECK_EQ(h.fired.size(), 3u);
+}
+
+TEST(NextDeadlineTracksEarliestGroup) {
+    Harness h(Options(false, 100, 250));
+    CHECK_EQ(h.coalescer.NextDeadline(), EventCoalescer::kNoDeadline);
+
+    h.coalescer.Push(7);
+    CHECK_EQ(h.coalescer.TimeUntilNextDeadline(), 100000u);
+    h.now += 80000;
+    h.coalescer.Push(7);
+    CHECK_EQ(h.coalescer.TimeUntilNextDeadline(), 100000u);
+    h.now += 80000;
+    h.coalescer.Push(7);
+    // 最长等待先于静默期到期
+    CHECK_EQ(h.coalescer.TimeUntilNextDeadline(), 90000u);
+}
+
+TEST(LatePollIsSettledByPush) {
+    // 定时器被延迟时，下一次 Push 先结算上一轮
+    Harness h(Options(false, 100, 0));
+    h.coalescer.Push();
+    h.now += 500000;
+    h.coalescer.Push();
+    CHECK_EQ(h.fired.size(), 1u);
+    CHECK_EQ(h.fired[0].count, 1u);
+    CHECK_EQ(h.coalescer.PendingGroups(), 1u);
+}
+
+TEST(FlushAndClear) {
+    Harness h(Options(false, 100, 0));
+    h.coalescer.Push(1);
+    h.coalescer.Push(2);
+    CHECK_EQ(h.coalescer.Flush(), 2u);
+    CHECK(h.fired[0].reason == CoalesceReason::Flush);
+    CHECK_EQ(h.coalescer.PendingGroups(), 0u);
+
+    h.coalescer.Push(3);
+    h.coalescer.Clear();
+    h.Advance(200000);
+    CHECK_EQ(h.fired.size(), 2u);
+}
+
+TEST(StatsCountReasons) {
+    Harness h(Options(true, 100, 0));
+    h.coalescer.Push();
+    h.coalescer.Push();
+    h.Advance(100000);
+    ztools::CoalescerStats stats = h.coalescer.Stats();
+    CHECK_EQ(stats.events, 2u);
+    CHECK_EQ(stats.fired, 2u);
+    CHECK_EQ(stats.leading, 1u);
+    CHECK_EQ(stats.quiet, 1u);
+}
+
+int main() {
+    return ztest::RunAll("EventCoalescer");
+}
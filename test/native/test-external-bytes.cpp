@@ -0,0 +1,54 @@
+#include "test-util.h"
+
+#include <string>
+#include <utility>
+
+#include "common/external_bytes.h"
+
+using ztools::ExternalBytes;
+using ztools::ExternalBytesStats;
+
+TEST(AdoptTakesOverStorageWithoutCopy) {
+    std::string payload(1 << 20, 'x');
+    const char* storage = payload.data();
+
+    ExternalBytes* bytes = ExternalBytes::Adopt(std::move(payload));
+    CHECK(bytes->Data() == storage);
+    CHECK_EQ(bytes->Size(), size_t(1) << 20);
+    CHECK(payload.empty());
+    ExternalBytes::Release(bytes);
+}
+
+TEST(StatsTrackLiveBuffers) {
+    ExternalBytesStats before = ExternalBytes::Stats();
+    ExternalBytes* a = ExternalBytes::Adopt(std::string(100, 'a'));
+    ExternalBytes* b = ExternalBytes::Adopt(std::string(28, 'b'));
+
+    ExternalBytesStats during = ExternalBytes::Stats();
+    CHECK_EQ(during.liveCount, before.liveCount + 2);
+    CHECK_EQ(during.liveBytes, before.liveBytes + 128);
+    CHECK_EQ(during.adopted, before.adopted + 2);
+
+    ExternalBytes::Release(a);
+    ExternalBytes::Release(b);
+    ExternalBytesStats after = ExternalBytes::Stats();
+    CHECK_EQ(after.liveCount, before.liveCount);
+    CHECK_EQ(after.liveBytes, before.liveBytes);
+    CHECK_EQ(after.adopted, before.adopted + 2);
+}
+
+TEST(EmptyAndShortPayloadsStayAddressable) {
+    ExternalBytes* empty = ExternalBytes::Adopt(std::string());
+    CHECK(empty->Data() != nullptr);
+    CHECK_EQ(empty->Size(), 0u);
+    ExternalBytes::Release(empty);
+
+    // 短字符串存放在对象内部，接管后数据指针随之改变但内容不变
+    ExternalBytes* small = ExternalBytes::Adopt(std::string("hi"));
+    CHECK_EQ(std::string(small->Data(), small->Size()), "hi");
+    ExternalBytes::Release(small);
+}
+
+int main() {
+    return ztest::RunAll("ExternalBytes");
+}
@@ -0,0 +1,399 @@
+#include "test-util.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/history_log.h"
+
+using ztools::ClipboardHistoryFormat;
+using ztools::HistoryLog;
+using ztools::HistoryLogOptions;
+using ztools::HistoryLogRecord;
+
+namespace {
+
+// 每个用例使用独立的临时目录
+struct TempDir {
+    std::string path;
+    TempDir() {
+        char tmpl[] = "/tmp/ztools-history-XXXXXX";
+        path = mkdtemp(tmpl);
+    }
+    ~TempDir() {
+        for (const char* name : {HistoryLog::kLogFileName, HistoryLog::kIndexFileName}) {
+            unlink(File(name).c_str());
+            unlink((File(name) + ".compact").c_str());
+        }
+        rmdir(path.c_str());
+    }
+    std::string File(const char* name) const { return path + "/" + name; }
+};
+
+HistoryLogRecord Text(const std::string& text, uint64_t id = 0) {
+    HistoryLogRecord record;
+    record.id = id;
+    record.createdAtMs = 1000;
+    record.formats = {ClipboardHistoryFormat{"text", text}};
+    return record;
+}
+
+std::string ReadText(const HistoryLog& log, uint64_t id) {
+    auto data = log.ReadFormat(id, "text");
+    return data ? *data : std::string("<missing>");
+}
+
+long FileSize(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+HistoryLogOptions NoAutoCompact() {
+    HistoryLogOptions options;
+    options.autoCompact = false;
+    return options;
+}
+
+}  // namespace
+
+TEST(AppendAndReopen) {
+    TempDir dir;
+    uint64_t a = 0, b = 0;
+    {
+        HistoryLog log;
+        CHECK(log.Open(dir.path));
+        a = log.Append(Text("first"));
+        b = log.Append(Text("second"));
+        CHECK(a != 0 && b != 0 && a != b);
+        CHECK_EQ(log.Size(), 2u);
+    }
+
+    HistoryLog log;
+    CHECK(log.Open(dir.path));
+    CHECK_EQ(log.Size(), 2u);
+    CHECK(!log.Stats().indexRebuilt);
+    CHECK_EQ(log.Stats().recoveredRecords, 0u);
+    CHECK_EQ(ReadText(log, a), "first");
+    CHECK_EQ(ReadText(log, b), "second");
+
+    auto page = log.Page(0, 10);
+    CHECK_EQ(page.size(), 2u);
+    CHECK_EQ(page[0].id, b);
+    CHECK_EQ(page[0].formats[0].name, "text");
+    CHECK_EQ(page[0].formats[0].size, 6u);
+    CHECK_EQ(log.NextId(), b + 1);
+}
+
+TEST(SupersedeById) {
+    TempDir dir;
+    HistoryLog log;
+    CHECK(log.Open(dir.path, NoAutoCompact()));
+    uint64_t id = log.Append(Text("v1"));
+    log.Append(Text("other"));
+
+    HistoryLogRecord update = Text("v1");
+    update.id = id;
+    update.copyCount = 5;
+    update.lastSeenAtMs = 9000;
+    CHECK_EQ(log.Append(update), id);
+
+    // 相同 id 以调用方为准，不累加
+    HistoryLogRecord record;
+    CHECK(log.Read(id, record));
+    CHECK_EQ(record.copyCount, 5u);
+    CHECK_EQ(record.lastSeenAtMs, 9000u);
+    CHECK_EQ(log.Size(), 2u);
+    CHECK_EQ(log.Page(0, 1)[0].id, id);
+    CHECK(log.Stats().deadBytes > 0);
+}
+
+TEST(SameContentMergesAcrossIds) {
+    TempDir dir;
+    HistoryLog log;
+    CHECK(log.Open(dir.path, NoAutoCompact()));
+    uint64_t first = log.Append(Text("dup"));
+
+    HistoryLogRecord again = Text("dup", 100);
+    again.createdAtMs = 5000;
+    CHECK_EQ(log.Append(again), 100u);
+
+    HistoryLogRecord record;
+    CHECK(!log.Read(first, record));
+    CHECK(log.Read(100, record));
+    CHECK_EQ(record.copyCount, 2u);
+    CHECK_EQ(record.createdAtMs, 1000u);
+    CHECK_EQ(log.Size(), 1u);
+    CHECK_EQ(log.NextId(), 101u);
+}
+
+TEST(RemoveSurvivesReopen) {
+    TempDir dir;
+    uint64_t a = 0;
+    {
+        HistoryLog log;
+        CHECK(log.Open(dir.path));
+        a = log.Append(Text("a"));
+        log.Append(Text("b"));
+        CHECK(log.Remove(a));
+        CHECK(!log.Remove(a));
+    }
+    HistoryLog log;
+    CHECK(log.Open(dir.path));
+    CHECK_EQ(log.Size(), 1u);
+    CHECK(log.ReadFormat(a, "text") == nullptr);
+}
+
+TEST(TornTailIsTruncated) {
+    TempDir dir;
+    {
+        HistoryLog log;
+        CHECK(log.Open(dir.path));
+        log.Append(Text("committed"));
+    }
+    // 模拟崩溃：追加半条记录（有记录头魔数但内容不完整）
+    long before = FileSize(dir.File(HistoryLog::kLogFileName));
+    FILE* file = fopen(dir.File(HistoryLog::kLogFileName).c_str(), "ab");
+    const unsigned char torn[] = {0x5A, 0x48, 0x52, 0x43, 0x80, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    fwrite(torn, 1, sizeof(torn), file);
+    fclose(file);
+
+    HistoryLog log;
+    CHECK(log.Open(dir.path));
+    CHECK_EQ(log.Size(), 1u);
+    CHECK_EQ(log.Stats().truncatedBytes, sizeof(torn));
+    CHECK_EQ(log.Stats().logBytes, static_cast<uint64_t>(before));
+
+    // 截断后可以继续追加
+    uint64_t id = log.Append(Text("after crash"));
+    CHECK_EQ(ReadText(log, id), "after crash");
+    log.Close();
+    CHECK(log.Open(dir.path));
+    CHECK_EQ(log.Size(), 2u);
+    CHECK_EQ(log.Stats().truncatedBytes, 0u);
+}
+
+TEST(UnindexedTailIsRecovered) {
+    TempDir dir;
+    std::string savedIndex;
+    uint64_t late = 0;
+    {
+        HistoryLog log;
+        CHECK(log.Open(dir.path));
+        log.Append(Text("one"));
+        log.Close();
+
+        // 保存此时的索引，再追加记录后用旧索引覆盖：模拟索引落后于日志
+        FILE* file = fopen(dir.File(HistoryLog::kIndexFileName).c_str(), "rb");
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) savedIndex.append(buffer, n);
+        fclose(file);
+
+        CHECK(log.Open(dir.path));
+        late = log.Append(Text("two"));
+    }
+    FILE* file = fopen(dir.File(HistoryLog::kIndexFileName).c_str(), "wb");
+    fwrite(savedIndex.data(), 1, savedIndex.size(), file);
+    fclose(file);
+
+    HistoryLog log;
+    CHECK(log.Open(dir.path));
+    CHECK(!log.Stats().indexRebuilt);
+    CHECK_EQ(log.Stats().recoveredRecords, 1u);
+    CHECK_EQ(log.Size(), 2u);
+    CHECK_EQ(ReadText(log, late), "two");
+}
+
+TEST(MissingIndexIsRebuilt) {
+    TempDir dir;
+    uint64_t b = 0;
+    {
+        HistoryLog log;
+        CHECK(log.Open(dir.path));
+        uint64_t a = log.Append(Text("a"));
+        b = log.Append(Text("b"));
+        log.Append(Text("c"));
+        log.Remove(a);
+    }
+    unlink(dir.File(HistoryLog::kIndexFileName).c_str());
+
+    HistoryLog log;
+    CHECK(log.Open(dir.path));
+    CHECK(log.Stats().indexRebuilt);
+    CHECK_EQ(log.Size(), 2u);
+    CHECK_EQ(ReadText(log, b), "b");
+    CHECK_EQ(log.Page(0, 10)[1].id, b);
+}
+
+TEST(CompactDropsDeadRecords) {
+    TempDir dir;
+    HistoryLog log;
+    CHECK(log.Open(dir.path, NoAutoCompact()));
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 100; i++) {
+        ids.push_back(log.Append(Text("entry" + std::to_string(i) + std::string(100, 'x'))));
+    }
+    for (int i = 0; i < 90; i++) {
+        log.Remove(ids[i]);
+    }
+    uint64_t before = log.Stats().logBytes;
+    CHECK(log.Compact());
+
+    auto stats = log.Stats();
+    CHECK_EQ(stats.compactions, 1u);
+    CHECK_EQ(stats.live, 10u);
+    CHECK_EQ(stats.records, 10u);
+    CHECK_EQ(stats.deadBytes, 0u);
+    CHECK(stats.logBytes < before / 5);
+    CHECK_EQ(ReadText(log, ids[95]).substr(0, 7), "entry95");
+    CHECK_EQ(log.NextId(), ids.back() + 1);
+
+    // 压缩后重新打开不需要重建索引
+    log.Close();
+    CHECK(log.Open(dir.path));
+    CHECK(!log.Stats().indexRebuilt);
+    CHECK_EQ(log.Size(), 10u);
+}
+
+TEST(BackgroundCompactKeepsConcurrentAppends) {
+    TempDir dir;
+    HistoryLog log;
+    CHECK(log.Open(dir.path, NoAutoCompact()));
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 2000; i++) {
+        ids.push_back(log.Append(Text("bulk" + std::to_string(i))));
+    }
+    for (int i = 0; i < 1500; i++) {
+        log.Remove(ids[i]);
+    }
+
+    CHECK(log.CompactAsync());
+    // 压缩期间继续追加与删除
+    std::vector<uint64_t> added;
+    for (int i = 0; i < 200; i++) {
+        added.push_back(log.Append(Text("during" + std::to_string(i))));
+    }
+    log.Remove(ids[1999]);
+    log.WaitForCompaction();
+
+    CHECK_EQ(log.Stats().compactions, 1u);
+    CHECK_EQ(log.Size(), 500u - 1 + 200u);
+    CHECK_EQ(ReadText(log, added.back()), "during199");
+    CHECK(log.ReadFormat(ids[1999], "text") == nullptr);
+    CHECK_EQ(ReadText(log, ids[1998]), "bulk1998");
+}
+
+TEST(AutoCompactAfterThreshold) {
+    TempDir dir;
+    HistoryLogOptions options;
+    options.compactMinBytes = 16 << 10;
+    options.compactDeadRatio = 0.5;
+    HistoryLog log;
+    CHECK(log.Open(dir.path, options));
+    HistoryLogRecord record = Text(std::string(512, 'z'), 1);
+    for (int i = 0; i < 200; i++) {
+        log.Append(record);  // 同一 id 反复覆盖
+    }
+    log.WaitForCompaction();
+    CHECK(log.Stats().compactions >= 1u);
+    CHECK_EQ(log.Size(), 1u);
+    CHECK_EQ(ReadText(log, 1), std::string(512, 'z'));
+}
+
+TEST(LimitsEvictOldestWithTombstones) {
+    TempDir dir;
+    HistoryLogOptions options = NoAutoCompact();
+    options.maxEntries = 3;
+    HistoryLog log;
+    CHECK(log.Open(dir.path, options));
+    for (const char* text : {"a", "b", "c", "d", "e"}) {
+        log.Append(Text(text));
+    }
+    CHECK_EQ(log.Size(), 3u);
+    CHECK_EQ(log.Stats().evicted, 2u);
+    auto page = log.Page(0, 10);
+    CHECK_EQ(page.size(), 3u);
+    CHECK_EQ(ReadText(log, page[0].id), "e");
+    CHECK_EQ(ReadText(log, page[2].id), "c");
+
+    // 墓碑已落盘，重新打开后仍是 3 条；容量调小时立即淘汰
+    log.Close();
+    CHECK(log.Open(dir.path, options));
+    CHECK_EQ(log.Size(), 3u);
+    log.SetLimits(1, 0);
+    CHECK_EQ(log.Size(), 1u);
+    CHECK_EQ(ReadText(log, log.Page(0, 1)[0].id), "e");
+
+    // 单条超过 maxBytes 的记录不写入
+    log.SetLimits(0, 256);
+    CHECK_EQ(log.Append(Text(std::string(1024, 'x'))), 0u);
+    CHECK_EQ(log.Size(), 1u);
+}
+
+TEST(LogSizeStaysBoundedAcrossEvictions) {
+    TempDir dir;
+    HistoryLogOptions options;
+    options.maxEntries = 16;
+    options.maxBytes = 256 << 10;
+    options.compactMinBytes = 256 << 10;
+    HistoryLog log;
+    CHECK(log.Open(dir.path, options));
+
+    // 约 24 MB 互不相同的内容反复淘汰
+    std::string payload(8 << 10, 'p');
+    for (int i = 0; i < 3000; i++) {
+        memcpy(&payload[0], &i, sizeof(i));
+        log.Append(Text(payload));
+    }
+    log.WaitForCompaction();
+    auto stats = log.Stats();
+    CHECK_EQ(stats.live, 16u);
+    CHECK(stats.evicted >= 3000u - 16u);
+    CHECK(stats.compactions >= 1u);
+    CHECK(stats.logBytes < (2u << 20));
+
+    log.Close();
+    CHECK(FileSize(dir.File(HistoryLog::kLogFileName)) < (2 << 20));
+    CHECK(FileSize(dir.File(HistoryLog::kIndexFileName)) < (1 << 20));
+}
+
+TEST(ClearKeepsIdsMonotonic) {
+    TempDir dir;
+    HistoryLog log;
+    CHECK(log.Open(dir.path));
+    log.Append(Text("a"));
+    uint64_t b = log.Append(Text("b"));
+    CHECK(log.Clear());
+    CHECK_EQ(log.Size(), 0u);
+    CHECK_EQ(log.Page(0, 10).size(), 0u);
+    CHECK(log.Append(Text("c")) > b);
+
+    log.Close();
+    CHECK(log.Open(dir.path));
+    CHECK_EQ(log.Size(), 1u);
+}
+
+TEST(RejectsForeignFile) {
+    TempDir dir;
+    FILE* file = fopen(dir.File(HistoryLog::kLogFileName).c_str(), "wb");
+    std::string junk(128, 'j');
+    fwrite(junk.data(), 1, junk.size(), file);
+    fclose(file);
+
+    HistoryLog log;
+    CHECK(!log.Open(dir.path));
+    CHECK(!log.LastError().empty());
+    CHECK_EQ(log.Append(Text("x")), 0u);
+}
+
+int main() {
+    return ztest::RunAll("HistoryLog");
+}
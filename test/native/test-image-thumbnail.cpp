@@ -0,0 +1,188 @@
+#include "test-util.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "common/clipboard_write.h"
+#include "common/image_thumbnail.h"
+
+using ztools::BgraAlpha;
+using ztools::ThumbnailImage;
+using ztools::ThumbnailOptions;
+
+namespace {
+
+std::string SolidImage(uint32_t width, uint32_t height, unsigned char b, unsigned char g, unsigned char r,
+                       unsigned char a) {
+    std::string pixels;
+    pixels.reserve(static_cast<size_t>(width) * height * 4);
+    for (size_t i = 0; i < static_cast<size_t>(width) * height; i++) {
+        pixels.push_back(static_cast<char>(b));
+        pixels.push_back(static_cast<char>(g));
+        pixels.push_back(static_cast<char>(r));
+        pixels.push_back(static_cast<char>(a));
+    }
+    return pixels;
+}
+
+const unsigned char* Bytes(const std::string& s) {
+    return reinterpret_cast<const unsigned char*>(s.data());
+}
+
+unsigned char At(const ThumbnailImage& image, uint32_t x, uint32_t y, int channel) {
+    return static_cast<unsigned char>(image.pixels[(static_cast<size_t>(y) * image.width + x) * 4 + channel]);
+}
+
+}  // namespace
+
+TEST(KeepsAspectRatioAndDoesNotUpscale) {
+    std::string big = SolidImage(400, 200, 10, 20, 30, 255);
+    ThumbnailImage thumb;
+    CHECK(ztools::DownscaleBgra(Bytes(big), 400, 200, 400 * 4, BgraAlpha::Premultiplied, ThumbnailOptions(), thumb));
+    CHECK_EQ(thumb.width, 96u);
+    CHECK_EQ(thumb.height, 48u);
+    CHECK_EQ(thumb.pixels.size(), 96u * 48u * 4u);
+    CHECK_EQ(At(thumb, 95, 47, 0), 10);
+    CHECK_EQ(At(thumb, 0, 0, 2), 30);
+    CHECK_EQ(At(thumb, 50, 20, 3), 255);
+
+    std::string small = SolidImage(40, 3, 1, 2, 3, 255);
+    CHECK(ztools::DownscaleBgra(Bytes(small), 40, 3, 40 * 4, BgraAlpha::Premultiplied, ThumbnailOptions(), thumb));
+    CHECK_EQ(thumb.width, 40u);
+    CHECK_EQ(thumb.height, 3u);
+    CHECK(thumb.pixels == small);
+}
+
+TEST(AveragesByCoveredArea) {
+    // 3 个像素缩为 2 个：权重分别为 (1, 0.5) 与 (0.5, 1)
+    std::string row;
+    for (unsigned char v : {0, 90, 180}) {
+        row += std::string(3, static_cast<char>(v)) + '\xFF';
+    }
+    ThumbnailOptions options;
+    options.maxSize = 2;
+    ThumbnailImage thumb;
+    CHECK(ztools::DownscaleBgra(Bytes(row), 3, 1, 12, BgraAlpha::Premultiplied, options, thumb));
+    CHECK_EQ(thumb.width, 2u);
+    CHECK_EQ(thumb.height, 1u);
+    CHECK_EQ(At(thumb, 0, 0, 0), 30);
+    CHECK_EQ(At(thumb, 1, 0, 0), 150);
+
+    // 4x4 棋盘（0 / 200）缩为 2x2：每个 2x2 块平均为 100
+    std::string board;
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            char v = ((x + y) % 2) ? static_cast<char>(200) : 0;
+            board += std::string(3, v) + '\xFF';
+        }
+    }
+    CHECK(ztools::DownscaleBgra(Bytes(board), 4, 4, 16, BgraAlpha::Premultiplied, options, thumb));
+    for (uint32_t y = 0; y < 2; y++) {
+        for (uint32_t x = 0; x < 2; x++) {
+            CHECK_EQ(At(thumb, x, y, 1), 100);
+        }
+    }
+}
+
+TEST(PremultipliesStraightAlpha) {
+    // 不透明红色与全透明绿色平均：预乘后绿色不应渗入
+    std::string pixels;
+    pixels += std::string("\x00\x00\xFF\xFF", 4);
+    pixels += std::string("\x00\xFF\x00\x00", 4);
+    ThumbnailOptions options;
+    options.maxSize = 1;
+    ThumbnailImage thumb;
+    CHECK(ztools::DownscaleBgra(Bytes(pixels), 2, 1, 8, BgraAlpha::Straight, options, thumb));
+    CHECK_EQ(thumb.width, 1u);
+    CHECK_EQ(At(thumb, 0, 0, 1), 0);
+    CHECK_EQ(At(thumb, 0, 0, 2), 128);
+    CHECK_EQ(At(thumb, 0, 0, 3), 128);
+
+    // alpha 无意义时结果不透明
+    CHECK(ztools::DownscaleBgra(Bytes(pixels), 2, 1, 8, BgraAlpha::Ignore, options, thumb));
+    CHECK_EQ(At(thumb, 0, 0, 3), 255);
+}
+
+TEST(VectorizedMatchesScalar) {
+    srand(7);
+    const uint32_t width = 1013;
+    const uint32_t height = 377;
+    std::string pixels(static_cast<size_t>(width) * height * 4, '\0');
+    for (char& c : pixels) c = static_cast<char>(rand() & 0xFF);
+
+    ThumbnailOptions vectorized;
+    ThumbnailOptions scalar;
+    scalar.vectorized = false;
+    for (uint32_t maxSize : {96u, 250u, 1000u}) {
+        vectorized.maxSize = scalar.maxSize = maxSize;
+        ThumbnailImage a, b;
+        CHECK(ztools::DownscaleBgra(Bytes(pixels), width, height, width * 4, BgraAlpha::Straight, vectorized, a));
+        CHECK(ztools::DownscaleBgra(Bytes(pixels), width, height, width * 4, BgraAlpha::Straight, scalar, b));
+        CHECK_EQ(a.width, b.width);
+        CHECK(a.pixels == b.pixels);
+    }
+}
+
+TEST(ReadsBottomUpAndTopDownDibs) {
+    // 上半红、下半蓝
+    ztools::ClipboardWriteImage image;
+    image.width = 8;
+    image.height = 8;
+    image.bgra = SolidImage(8, 4, 0, 0, 255, 255) + SolidImage(8, 4, 255, 0, 0, 255);
+
+    ThumbnailOptions options;
+    options.maxSize = 2;
+    std::string dib;
+    CHECK(ztools::BuildDibFromBgra(image, dib));
+    ThumbnailImage thumb;
+    CHECK(ztools::ThumbnailFromDib(dib.data(), dib.size(), options, thumb));
+    CHECK_EQ(thumb.width, 2u);
+    CHECK_EQ(thumb.height, 2u);
+    CHECK_EQ(At(thumb, 0, 0, 2), 255);
+    CHECK_EQ(At(thumb, 0, 0, 0), 0);
+    CHECK_EQ(At(thumb, 1, 1, 0), 255);
+    CHECK_EQ(At(thumb, 1, 1, 3), 255);
+
+    // V5 带 alpha 掩码：alpha 按非预乘处理
+    image.bgra = SolidImage(8, 8, 0, 0, 200, 100);
+    CHECK(ztools::BuildDibV5FromBgra(image, dib));
+    CHECK(ztools::ThumbnailFromDib(dib.data(), dib.size(), options, thumb));
+    CHECK_EQ(At(thumb, 0, 0, 2), 78);
+    CHECK_EQ(At(thumb, 0, 0, 3), 100);
+
+    // 24 位自上而下（负高度）
+    std::string dib24(40, '\0');
+    const unsigned char header[] = {40, 0, 0, 0, 2, 0, 0, 0, 0xFE, 0xFF, 0xFF, 0xFF, 1, 0, 24, 0};
+    memcpy(&dib24[0], header, sizeof(header));
+    dib24 += std::string("\x10\x20\x30\x10\x20\x30\x00\x00", 8);  // 第一行（每行 8 字节对齐）
+    dib24 += std::string("\x50\x60\x70\x50\x60\x70\x00\x00", 8);
+    CHECK(ztools::ThumbnailFromDib(dib24.data(), dib24.size(), ThumbnailOptions(), thumb));
+    CHECK_EQ(thumb.width, 2u);
+    CHECK_EQ(thumb.height, 2u);
+    CHECK_EQ(At(thumb, 0, 0, 0), 0x10);
+    CHECK_EQ(At(thumb, 1, 1, 2), 0x70);
+    CHECK_EQ(At(thumb, 1, 1, 3), 255);
+
+    CHECK(!ztools::ThumbnailFromDib(dib24.data(), 20, ThumbnailOptions(), thumb));
+}
+
+TEST(SerializationRoundTrip) {
+    ThumbnailImage thumb;
+    thumb.width = 3;
+    thumb.height = 2;
+    thumb.pixels = SolidImage(3, 2, 1, 2, 3, 4);
+    std::string data = ztools::SerializeThumbnail(thumb);
+    CHECK_EQ(data.size(), 8u + 24u);
+
+    ThumbnailImage parsed;
+    CHECK(ztools::ParseThumbnail(data, parsed));
+    CHECK_EQ(parsed.width, 3u);
+    CHECK_EQ(parsed.height, 2u);
+    CHECK(parsed.pixels == thumb.pixels);
+    CHECK(!ztools::ParseThumbnail(data.substr(0, 20), parsed));
+}
+
+int main() {
+    return ztest::RunAll("ImageThumbnail");
+}
@@ -0,0 +1,138 @@
+#include "test-util.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/keyword_matcher.h"
+#include "common/utf_transcode.h"
+
+using ztools::KeywordMatcher;
+using ztools::KeywordMatchMode;
+
+namespace {
+
+std::u16string U(const char* utf8) {
+    return ztools::Utf8ToUtf16(utf8, strlen(utf8));
+}
+
+// 参照实现：原 binding_windows.cpp 的逐关键字 find / 前缀比较
+std::u16string Fold(std::u16string text) {
+    for (char16_t& ch : text) {
+        ch = ztools::FoldKeywordCase(ch);
+    }
+    return text;
+}
+
+bool NaiveMatches(const KeywordMatcher& matcher, const std::u16string& text) {
+    std::u16string lower = Fold(text);
+    if (matcher.Mode() == KeywordMatchMode::Prefix) {
+        size_t start = 0;
+        while (start < lower.size() && (lower[start] == u' ' || lower[start] == u'\t' ||
+                                        lower[start] == u'\n' || lower[start] == 0x3000)) {
+            start++;
+        }
+        lower.erase(0, start);
+        for (const auto& keyword : matcher.Keywords()) {
+            if (lower.compare(0, keyword.size(), keyword) == 0) return true;
+        }
+        return false;
+    }
+    for (const auto& keyword : matcher.Keywords()) {
+        if (lower.find(keyword) != std::u16string::npos) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+TEST(MatchesBrowserUrlPrefixes) {
+    const KeywordMatcher urls = ztools::MakeBrowserUrlPrefixMatcher();
+    CHECK(urls.Matches(U("https://example.com/")));
+    CHECK(urls.Matches(U("  \tHTTP://EXAMPLE.COM")));
+    CHECK(urls.Matches(U("\xE3\x80\x80" "chrome://settings")));  // 全角空格
+    CHECK(urls.Matches(U("about:blank")));
+    CHECK(urls.Matches(U("Moz-Extension://abc/popup.html")));
+    CHECK(urls.Matches(U("file:///C:/Users/a.txt")));
+    CHECK(!urls.Matches(U("file://server/share")));
+    CHECK(!urls.Matches(U("example.com")));
+    CHECK(!urls.Matches(U("see https://example.com")));  // 必须以前缀开头
+    CHECK(!urls.Matches(U("http:/")));
+    CHECK(!urls.Matches(U("   ")));
+    CHECK(!urls.Matches(std::u16string()));
+}
+
+TEST(MatchesAddressBarNamesAnywhereIgnoringCase) {
+    const KeywordMatcher names = ztools::MakeBrowserAddressBarNameMatcher();
+    CHECK(names.Matches(U("Address and search bar")));
+    CHECK(names.Matches(U("Search or enter address")));
+    CHECK(names.Matches(U("Firefox: Search with Google or enter address")));
+    CHECK(names.Matches(U("地址和搜索栏")));
+    CHECK(names.Matches(U("Chrome 地址栏")));
+    CHECK(!names.Matches(U("Addressbar")));
+    CHECK(!names.Matches(U("Tab search")));
+    CHECK(!names.Matches(U("地址")));
+    // 失败链接：前一个关键字的前缀中途失配后，仍能识别后面重叠开始的关键字
+    CHECK(names.Matches(U("search or enter addrESS BAR")));
+    CHECK(names.Matches(U("address and search address bar")));
+}
+
+TEST(FoldsCaseBeyondAscii) {
+    KeywordMatcher matcher(KeywordMatchMode::Substring, {"адресная строка", "barre d'adresse é", "ΔΙΕΎΘΥΝΣΗ"});
+    CHECK(matcher.Matches(U("АДРЕСНАЯ СТРОКА")));
+    CHECK(matcher.Matches(U("Barre d'adresse É")));
+    CHECK(matcher.Matches(U("διεύθυνση")));
+    CHECK(!matcher.Matches(U("адресная строк")));
+    CHECK_EQ(static_cast<uint32_t>(ztools::FoldKeywordCase(0x401)), 0x451u);  // Ё → ё
+    CHECK_EQ(static_cast<uint32_t>(ztools::FoldKeywordCase(0xD7)), 0xD7u);    // × 不是字母
+}
+
+TEST(ExtendsKeywordsAtRuntime) {
+    KeywordMatcher matcher = ztools::MakeBrowserAddressBarNameMatcher();
+    const size_t count = matcher.Keywords().size();
+    CHECK(!matcher.Matches(U("Adressleiste")));
+    CHECK(matcher.Add("Adressleiste"));
+    CHECK(!matcher.Add("ADRESSLEISTE"));  // 折叠后重复
+    CHECK(!matcher.Add(""));
+    // Build 之前新关键字不参与匹配
+    CHECK(!matcher.Matches(U("Adressleiste")));
+    matcher.Build();
+    CHECK_EQ(matcher.Keywords().size(), count + 1);
+    CHECK(matcher.Matches(U("Adress- und Suchleiste / adressleiste")));
+    CHECK(matcher.Matches(U("Address bar")));
+
+    KeywordMatcher empty;
+    CHECK(!empty.Matches(U("anything")));
+    CHECK_EQ(empty.StateCount(), 1u);
+}
+
+TEST(AgreesWithNaiveSearchOnRandomText) {
+    // 小字母表的随机关键字与文本，覆盖大量重叠前缀/后缀的情形
+    std::mt19937 rng(7);
+    const char16_t alphabet[] = {u'a', u'B', u'b', u'c', u' ', 0x5730, 0x0416, 0x0436};
+    auto randomText = [&](size_t maxLength) {
+        std::u16string text(rng() % (maxLength + 1), u'\0');
+        for (char16_t& ch : text) ch = alphabet[rng() % 8];
+        return text;
+    };
+    for (int round = 0; round < 200; round++) {
+        const KeywordMatchMode mode = round % 2 ? KeywordMatchMode::Prefix : KeywordMatchMode::Substring;
+        KeywordMatcher matcher(mode);
+        for (int k = 0; k < 1 + round % 6; k++) {
+            const std::u16string keyword = randomText(5);
+            std::string utf8 = ztools::Utf16ToUtf8(keyword.data(), keyword.size());
+            matcher.Add(utf8);
+        }
+        matcher.Build();
+        for (int t = 0; t < 50; t++) {
+            const std::u16string text = randomText(24);
+            CHECK_EQ(matcher.Matches(text), NaiveMatches(matcher, text));
+        }
+    }
+}
+
+int main() {
+    return ztest::RunAll("KeywordMatcher");
+}
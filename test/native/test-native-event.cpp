@@ -0,0 +1,199 @@
+#include "test-util.h"
+
+#include <cstring>
+#include <string>
+
+#include "common/native_event.h"
+
+using ztools::ColorPickerEventRecord;
+using ztools::MouseEventRecord;
+using ztools::NativeEventKind;
+using ztools::NativeEventReader;
+using ztools::NativeEventWriter;
+using ztools::kNativeStringAbsent;
+using ztools::WindowEventRecord;
+
+namespace {
+
+// 把回调的字段重新写成 JSON，与 Swift 原 jsonForWindowMetadata 的输出逐字比较
+class JsonVisitor : public ztools::NativeEventFieldVisitor {
+public:
+    std::string json;
+
+    void String(const char* name, const char* data, size_t size) override {
+        Key(name);
+        json += '"';
+        json.append(data, size);
+        json += '"';
+    }
+    void Number(const char* name, double value) override {
+        Key(name);
+        json += std::to_string(static_cast<long long>(value));
+    }
+    void Boolean(const char* name, bool value) override {
+        Key(name);
+        json += value ? "true" : "false";
+    }
+    void Null(const char* name) override {
+        Key(name);
+        json += "null";
+    }
+
+    std::string Result() const { return "{" + json + "}"; }
+
+private:
+    void Key(const char* name) {
+        if (!json.empty()) json += ',';
+        json += '"';
+        json += name;
+        json += "\":";
+    }
+};
+
+std::string Visit(const std::string& encoded, bool* ok = nullptr) {
+    JsonVisitor visitor;
+    const bool result = ztools::VisitNativeEvent(encoded.data(), encoded.size(), visitor);
+    if (ok != nullptr) *ok = result;
+    return result ? visitor.Result() : std::string();
+}
+
+std::string EncodeWindow(bool withFinder) {
+    NativeEventWriter writer;
+    WindowEventRecord record;
+    memset(&record, 0, sizeof(record));
+    record.x = -1440;
+    record.y = 25;
+    record.width = 1280;
+    record.height = 800;
+    record.pid = 412;
+    record.windowId = 8812;
+    record.flags = ztools::kWindowEventPreciseTarget;
+    record.appName = writer.AddString("Finder");
+    record.bundleId = writer.AddString("com.apple.finder");
+    record.title = writer.AddString("下载");
+    record.app = writer.AddString("Finder.app");
+    record.appPath = writer.AddString("/System/Library/CoreServices/Finder.app");
+    record.axRole = writer.AddString("AXWindow");
+    record.axSubrole = writer.AddString("");
+    if (withFinder) {
+        record.flags |= ztools::kWindowEventHasFinderId;
+        record.finderId = 9007199254740991LL;
+        record.path = writer.AddString("/Users/a/Downloads");
+        record.url = writer.AddString("file:///Users/a/Downloads/");
+        record.kind = writer.AddString("finder");
+    } else {
+        record.path = NativeEventWriter::Absent();
+        record.url = NativeEventWriter::Absent();
+        record.kind = NativeEventWriter::Absent();
+    }
+    return writer.Finish(NativeEventKind::Window, &record, sizeof(record));
+}
+
+}  // namespace
+
+TEST(WindowEventMatchesLegacyJsonFields) {
+    CHECK_EQ(Visit(EncodeWindow(false)),
+             std::string("{\"appName\":\"Finder\",\"bundleId\":\"com.apple.finder\",\"title\":\"下载\","
+                         "\"app\":\"Finder.app\",\"x\":-1440,\"y\":25,\"width\":1280,\"height\":800,"
+                         "\"appPath\":\"/System/Library/CoreServices/Finder.app\",\"pid\":412,\"windowId\":8812,"
+                         "\"axRole\":\"AXWindow\",\"axSubrole\":\"\",\"preciseTarget\":true}"));
+    const std::string full = Visit(EncodeWindow(true));
+    CHECK(full.find(",\"preciseTarget\":true,\"finderId\":9007199254740991,\"path\":\"/Users/a/Downloads\","
+                    "\"url\":\"file:///Users/a/Downloads/\",\"kind\":\"finder\"}") != std::string::npos);
+}
+
+TEST(MouseAndColorPickerEvents) {
+    NativeEventWriter writer;
+    MouseEventRecord mouse;
+    mouse.type = writer.AddString("backLongPress");
+    CHECK_EQ(Visit(writer.Finish(NativeEventKind::Mouse, &mouse, sizeof(mouse))),
+             std::string("{\"type\":\"backLongPress\"}"));
+
+    ColorPickerEventRecord color;
+    memset(&color, 0, sizeof(color));
+    color.success = 1;
+    color.hex = writer.AddString("#1E90FF");
+    CHECK_EQ(Visit(writer.Finish(NativeEventKind::ColorPicker, &color, sizeof(color))),
+             std::string("{\"success\":true,\"hex\":\"#1E90FF\"}"));
+
+    color.success = 0;
+    color.hex = NativeEventWriter::Absent();
+    CHECK_EQ(Visit(writer.Finish(NativeEventKind::ColorPicker, &color, sizeof(color))),
+             std::string("{\"success\":false,\"hex\":null}"));
+}
+
+TEST(RecordSizeCanGrowOrShrinkAcrossVersions) {
+    // 较新的 Swift 库在记录末尾追加字段：旧读取方忽略多出的部分
+    NativeEventWriter writer;
+    struct {
+        MouseEventRecord base;
+        uint64_t futureField;
+    } extended;
+    extended.base.type = writer.AddString("middleClick");
+    extended.futureField = 42;
+    CHECK_EQ(Visit(writer.Finish(NativeEventKind::Mouse, &extended, sizeof(extended))),
+             std::string("{\"type\":\"middleClick\"}"));
+
+    // 较短的记录只有前 4 字节：数值字段置 0，字符串字段为缺失而不是空串
+    ColorPickerEventRecord color;
+    memset(&color, 0xAB, sizeof(color));
+    const uint32_t success = 1;
+    const std::string encoded = writer.Finish(NativeEventKind::ColorPicker, &success, sizeof(success));
+    NativeEventReader reader;
+    CHECK(reader.Open(encoded.data(), encoded.size()));
+    CHECK(reader.Read(color));
+    CHECK_EQ(color.success, 1u);
+    CHECK_EQ(color.reserved, 0u);
+    CHECK_EQ(color.hex.offset, kNativeStringAbsent);
+    CHECK_EQ(color.hex.length, 0u);
+    CHECK_EQ(Visit(encoded), std::string("{\"success\":true,\"hex\":null}"));
+}
+
+TEST(RejectsMalformedEvents) {
+    const std::string good = EncodeWindow(true);
+    bool ok = true;
+    Visit(good, &ok);
+    CHECK(ok);
+
+    // 截断、多余字节、magic / 版本不符
+    Visit(good.substr(0, good.size() - 1), &ok);
+    CHECK(!ok);
+    Visit(good + "x", &ok);
+    CHECK(!ok);
+    Visit(good.substr(0, 10), &ok);
+    CHECK(!ok);
+    std::string badMagic = good;
+    badMagic[0] = 'Y';
+    Visit(badMagic, &ok);
+    CHECK(!ok);
+    std::string badVersion = good;
+    badVersion[4] = 2;
+    Visit(badVersion, &ok);
+    CHECK(!ok);
+
+    // 字符串引用越出字符串表
+    NativeEventWriter writer;
+    MouseEventRecord mouse;
+    mouse.type = ztools::NativeString{2, 100};
+    writer.AddString("abc");
+    Visit(writer.Finish(NativeEventKind::Mouse, &mouse, sizeof(mouse)), &ok);
+    CHECK(!ok);
+    // 必有字段缺失
+    mouse.type = NativeEventWriter::Absent();
+    Visit(writer.Finish(NativeEventKind::Mouse, &mouse, sizeof(mouse)), &ok);
+    CHECK(!ok);
+
+    // 记录类型不符、未知类型
+    NativeEventReader reader;
+    CHECK(reader.Open(good.data(), good.size()));
+    MouseEventRecord wrongKind;
+    CHECK(!reader.Read(wrongKind));
+    const std::string unknown = writer.Finish(static_cast<NativeEventKind>(9), &mouse, sizeof(mouse));
+    Visit(unknown, &ok);
+    CHECK(!ok);
+    CHECK(!reader.Open(nullptr, 0));
+}
+
+int main() {
+    return ztest::RunAll("NativeEvent");
+}
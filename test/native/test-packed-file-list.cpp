@@ -0,0 +1,148 @@
+#include "test-util.h"
+
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/clipboard_write.h"
+#include "common/packed_file_list.h"
+
+using ztools::FileProbeOptions;
+using ztools::FileProbePool;
+using ztools::FileProbeStats;
+using ztools::PackedFileList;
+
+TEST(AppendPacksPathsWithOffsets) {
+    PackedFileList list;
+    list.Append("C:\\Users\\a.txt");
+    list.Append("/tmp/dir/");
+    list.Append("plain");
+
+    CHECK_EQ(list.Count(), 3u);
+    CHECK_EQ(list.offsets.size(), 4u);
+    CHECK_EQ(list.offsets[3], list.paths.size());
+    CHECK_EQ(list.Path(0), "C:\\Users\\a.txt");
+    CHECK_EQ(list.Name(0), "a.txt");
+    CHECK_EQ(list.Name(1), "");
+    CHECK_EQ(list.Name(2), "plain");
+    CHECK_EQ(list.flags[1], ztools::kFileFlagUnknown);
+}
+
+TEST(DropFilesRoundTrip) {
+    std::vector<std::string> paths = {"C:\\文档\\报告.docx", "D:\\emoji-\xF0\x9F\x98\x80.png", "\\\\server\\share\\x"};
+    std::string dropFiles = ztools::BuildDropFiles(paths);
+
+    PackedFileList list;
+    CHECK(ztools::ParseDropFiles(dropFiles.data(), dropFiles.size(), list));
+    CHECK_EQ(list.Count(), 3u);
+    for (size_t i = 0; i < paths.size(); i++) {
+        CHECK_EQ(list.Path(i), paths[i]);
+    }
+    CHECK_EQ(list.Name(0), "报告.docx");
+}
+
+TEST(DropFilesRejectsAnsiAndTruncatedData) {
+    std::string dropFiles = ztools::BuildDropFiles({"C:\\a", "C:\\b"});
+    PackedFileList list;
+
+    std::string truncated = dropFiles.substr(0, dropFiles.size() - 2);  // 缺少结尾的双 NUL
+    CHECK(!ztools::ParseDropFiles(truncated.data(), truncated.size(), list));
+    CHECK_EQ(list.Count(), 0u);
+
+    std::string ansi = dropFiles;
+    ansi[16] = 0;  // fWide = 0
+    CHECK(!ztools::ParseDropFiles(ansi.data(), ansi.size(), list));
+    CHECK(!ztools::ParseDropFiles(dropFiles.data(), 10, list));
+}
+
+TEST(ProbeResolvesEveryEntry) {
+    PackedFileList list;
+    for (int i = 0; i < 1000; i++) {
+        list.Append("/data/" + std::string(i % 3 == 0 ? "dir" : "file") + std::to_string(i));
+    }
+    FileProbePool pool(4);
+    FileProbeStats stats = pool.Probe(
+        list, [](const std::string& path) -> uint8_t {
+            return path.find("/dir") != std::string::npos ? ztools::kFileFlagDirectory : 0;
+        },
+        FileProbeOptions());
+
+    CHECK(!stats.timedOut);
+    CHECK_EQ(stats.resolved, 1000u);
+    CHECK_EQ(stats.pending, 0u);
+    CHECK_EQ(list.flags[0], ztools::kFileFlagDirectory);
+    CHECK_EQ(list.flags[1], 0);
+}
+
+TEST(ProbeTimeoutLeavesSlowEntriesUnknown) {
+    FileProbePool pool(3);
+    FileProbeOptions options;
+    options.timeoutMs = 50;
+
+    double start = ztest::NowSeconds();
+    FileProbeStats stats;
+    {
+        // 超时返回后释放调用方的 list：迟到的结果只写入线程池持有的副本
+        PackedFileList list;
+        list.Append("/fast/a");
+        list.Append("/slow/b");
+        list.Append("/fast/c");
+        stats = pool.Probe(
+            list, [](const std::string& path) -> uint8_t {
+                if (path.compare(0, 6, "/slow/") == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+                }
+                return 0;
+            },
+            options);
+        CHECK_EQ(list.flags[0], 0);
+        CHECK_EQ(list.flags[1], ztools::kFileFlagUnknown);
+        CHECK_EQ(list.flags[2], 0);
+    }
+    double elapsed = ztest::NowSeconds() - start;
+
+    CHECK(stats.timedOut);
+    CHECK_EQ(stats.pending, 1u);
+    CHECK(elapsed < 0.3);
+    // 析构时等待仍在查询的工作线程结束
+}
+
+TEST(ProbePoolStaysBoundedAcrossTimeouts) {
+    FileProbePool pool(2);
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    FileProbeOptions options;
+    options.timeoutMs = 5;
+    auto slow = [&mutex, &threads](const std::string&) -> uint8_t {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return 0;
+    };
+
+    // 每次都超时；旧实现每次新建并分离线程
+    for (int i = 0; i < 20; i++) {
+        PackedFileList list;
+        for (int j = 0; j < 8; j++) list.Append("/share/f" + std::to_string(j));
+        CHECK(pool.Probe(list, slow, options).timedOut);
+    }
+    pool.Shutdown();
+    CHECK(threads.size() <= 2u);
+
+    // 关闭后不再查询
+    PackedFileList list;
+    list.Append("/share/after");
+    FileProbeStats stats = pool.Probe(list, slow, options);
+    CHECK(stats.timedOut);
+    CHECK_EQ(stats.pending, 1u);
+    CHECK_EQ(list.flags[0], ztools::kFileFlagUnknown);
+}
+
+int main() {
+    return ztest::RunAll("PackedFileList");
+}
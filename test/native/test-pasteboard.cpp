@@ -0,0 +1,122 @@
+#include "test-util.h"
+
+#include <string>
+#include <vector>
+
+#include "common/pasteboard.h"
+
+using ztools::DecodePasteboardSnapshot;
+using ztools::EncodePasteboardSnapshot;
+using ztools::PasteboardEntry;
+using ztools::PasteboardItem;
+using ztools::PasteboardSnapshot;
+
+namespace {
+
+PasteboardSnapshot Sample() {
+    PasteboardSnapshot snapshot;
+    PasteboardItem first;
+    first.entries.push_back(PasteboardEntry{"public.utf8-plain-text", "hello"});
+    first.entries.push_back(PasteboardEntry{"public.html", "<b>hello</b>"});
+    std::string binary(70000, '\0');
+    for (size_t i = 0; i < binary.size(); i++) binary[i] = static_cast<char>(i * 7);
+    first.entries.push_back(PasteboardEntry{"public.tiff", binary});
+    PasteboardItem second;
+    second.entries.push_back(PasteboardEntry{"public.file-url", "file:///tmp/a"});
+    second.entries.push_back(PasteboardEntry{"com.example.empty", ""});
+    snapshot.items = {first, second};
+    return snapshot;
+}
+
+bool SameSnapshot(const PasteboardSnapshot& a, const PasteboardSnapshot& b) {
+    if (a.items.size() != b.items.size()) return false;
+    for (size_t i = 0; i < a.items.size(); i++) {
+        const auto& x = a.items[i].entries;
+        const auto& y = b.items[i].entries;
+        if (x.size() != y.size()) return false;
+        for (size_t j = 0; j < x.size(); j++) {
+            if (x[j].type != y[j].type || x[j].data != y[j].data) return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(SnapshotRoundTrip) {
+    PasteboardSnapshot snapshot = Sample();
+    std::string encoded = EncodePasteboardSnapshot(snapshot);
+    CHECK_EQ(encoded.compare(0, 4, "ZPB1"), 0);
+
+    PasteboardSnapshot decoded;
+    CHECK(DecodePasteboardSnapshot(encoded.data(), encoded.size(), decoded));
+    CHECK(SameSnapshot(snapshot, decoded));
+    CHECK_EQ(decoded.Bytes(), snapshot.Bytes());
+
+    // 空快照（剪贴板为空）同样可以往返
+    PasteboardSnapshot empty;
+    encoded = EncodePasteboardSnapshot(empty);
+    CHECK_EQ(encoded.size(), 8u);
+    CHECK(DecodePasteboardSnapshot(encoded.data(), encoded.size(), decoded));
+    CHECK(decoded.Empty());
+}
+
+TEST(CorruptSnapshotIsRejected) {
+    std::string encoded = EncodePasteboardSnapshot(Sample());
+    PasteboardSnapshot decoded;
+
+    // 每个截断位置都必须被拒绝，且不越界读取
+    for (size_t cut = 0; cut < encoded.size(); cut += 997) {
+        CHECK(!DecodePasteboardSnapshot(encoded.data(), cut, decoded));
+        CHECK(decoded.Empty());
+    }
+    CHECK(!DecodePasteboardSnapshot(encoded.data(), encoded.size() - 1, decoded));
+    CHECK(!DecodePasteboardSnapshot((encoded + "x").data(), encoded.size() + 1, decoded));
+
+    std::string badMagic = encoded;
+    badMagic[3] = '2';
+    CHECK(!DecodePasteboardSnapshot(badMagic.data(), badMagic.size(), decoded));
+
+    // 伪造的超大长度
+    std::string hugeLength = EncodePasteboardSnapshot(PasteboardSnapshot{{PasteboardItem{{{"t", "x"}}}}});
+    hugeLength[8 + 4 + 4 + 1 + 7] = '\x7f';
+    CHECK(!DecodePasteboardSnapshot(hugeLength.data(), hugeLength.size(), decoded));
+    CHECK(!DecodePasteboardSnapshot(nullptr, 0, decoded));
+}
+
+TEST(SameTypeComparesAcrossItems) {
+    PasteboardSnapshot a = Sample();
+    PasteboardSnapshot b = Sample();
+    CHECK(ztools::SamePasteboardType(a, b, "public.tiff"));
+    CHECK(ztools::SamePasteboardType(a, b, "public.missing"));
+
+    b.items[1].entries[0].data = "file:///tmp/b";
+    CHECK(!ztools::SamePasteboardType(a, b, "public.file-url"));
+    CHECK(ztools::SamePasteboardType(a, b, "public.utf8-plain-text"));
+
+    // 多出一个同类型 item
+    PasteboardSnapshot c = Sample();
+    c.items.push_back(PasteboardItem{{{"public.file-url", "file:///tmp/a"}}});
+    CHECK(!ztools::SamePasteboardType(a, c, "public.file-url"));
+}
+
+TEST(ParseUriListSkipsCommentsAndDecodes) {
+    std::string list =
+        "# copied by file manager\r\n"
+        "file:///home/user/My%20Documents/a.txt\r\n"
+        "file://localhost/tmp/%E4%B8%AD%E6%96%87\r\n"
+        "https://example.com/not-a-file\r\n"
+        "file://otherhost/share/x\r\n"
+        "\r\n"
+        "file:///tmp/bad%zzescape%";
+    std::vector<std::string> paths = ztools::ParseUriList(list);
+    CHECK_EQ(paths.size(), 3u);
+    CHECK_EQ(paths[0], "/home/user/My Documents/a.txt");
+    CHECK_EQ(paths[1], "/tmp/\xE4\xB8\xAD\xE6\x96\x87");
+    CHECK_EQ(paths[2], "/tmp/bad%zzescape%");
+    CHECK(ztools::ParseUriList("").empty());
+}
+
+int main() {
+    return ztest::RunAll("Pasteboard");
+}
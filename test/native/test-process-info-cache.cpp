@@ -0,0 +1,238 @@
+#include "test-util.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+
+#include "common/process_info_cache.h"
+#include "linux/procfs_process_source.h"
+
+using ztools::ProcessInfoCache;
+
+namespace {
+
+// 可控的进程表：记录每个接口的调用次数，句柄泄漏时 openHandles 不为 0
+class FakeSource : public ztools::ProcessInfoSource {
+public:
+    struct Process {
+        uint64_t startTime;
+        std::string path;
+    };
+    std::map<uint32_t, Process> processes;
+    int opens = 0;
+    int pathReads = 0;
+    int openHandles = 0;
+
+    bool Open(uint32_t pid, uintptr_t* handle, uint64_t* startTime) override {
+        opens++;
+        auto it = processes.find(pid);
+        if (it == processes.end()) {
+            return false;
+        }
+        *startTime = it->second.startTime;
+        *handle = 1000 + pid;
+        openHandles++;
+        return true;
+    }
+    bool IsAlive(uint32_t pid, uintptr_t handle, uint64_t startTime) override {
+        CHECK_EQ(handle, static_cast<uintptr_t>(1000 + pid));
+        auto it = processes.find(pid);
+        return it != processes.end() && it->second.startTime == startTime;
+    }
+    bool ExecutablePath(uint32_t pid, uintptr_t, std::string* path) override {
+        pathReads++;
+        const std::string& value = processes.at(pid).path;
+        if (value.empty()) {
+            return false;
+        }
+        *path = value;
+        return true;
+    }
+    void Close(uintptr_t) override { openHandles--; }
+};
+
+std::string App(const std::string& path) {
+    std::string app, appName;
+    ztools::SplitExecutableName(path, &app, &appName);
+    return app + "|" + appName;
+}
+
+}  // namespace
+
+TEST(SplitExecutableName) {
+    CHECK_EQ(App("C:\\Program Files\\Microsoft VS Code\\Code.exe"), std::string("Code.exe|Code"));
+    CHECK_EQ(App("/usr/lib/firefox/firefox"), std::string("firefox|firefox"));
+    CHECK_EQ(App("D:/tools/my.app.v2/Tool.Setup.exe"), std::string("Tool.Setup.exe|Tool.Setup"));
+    CHECK_EQ(App("C:\\微信\\WeChat.exe"), std::string("WeChat.exe|WeChat"));
+    CHECK_EQ(App("/home/a/.hidden"), std::string(".hidden|.hidden"));
+    CHECK_EQ(App("notepad.exe"), std::string("notepad.exe|notepad"));
+    CHECK_EQ(App(""), std::string("|"));
+}
+
+TEST(RepeatedLookupsOnlyCheckLiveness) {
+    FakeSource source;
+    source.processes[42] = {7, "C:\\Windows\\explorer.exe"};
+    {
+        ProcessInfoCache cache(source);
+        auto first = cache.Lookup(42);
+        CHECK(first != nullptr);
+        CHECK_EQ(first->appPath, std::string("C:\\Windows\\explorer.exe"));
+        CHECK_EQ(first->app, std::string("explorer.exe"));
+        CHECK_EQ(first->appName, std::string("explorer"));
+        CHECK_EQ(first->startTime, 7u);
+        for (int i = 0; i < 10; i++) {
+            CHECK(cache.Lookup(42) == first);
+        }
+        CHECK_EQ(source.opens, 1);
+        CHECK_EQ(source.pathReads, 1);
+        CHECK_EQ(cache.Stats().hits, 10u);
+        CHECK_EQ(cache.Stats().misses, 1u);
+
+        // 不存在的进程与 pid 0 不缓存
+        CHECK(cache.Lookup(99) == nullptr);
+        CHECK(cache.Lookup(0) == nullptr);
+        CHECK_EQ(cache.Size(), 1u);
+    }
+    CHECK_EQ(source.openHandles, 0);
+}
+
+TEST(ExitAndPidReuseInvalidate) {
+    FakeSource source;
+    source.processes[42] = {7, "C:\\Windows\\explorer.exe"};
+    ProcessInfoCache cache(source);
+    auto old = cache.Lookup(42);
+
+    // 同一 pid 被新进程复用：启动时间不同，重新读取
+    source.processes[42] = {8, "C:\\Windows\\notepad.exe"};
+    auto reused = cache.Lookup(42);
+    CHECK(reused != nullptr);
+    CHECK_EQ(reused->appName, std::string("notepad"));
+    CHECK_EQ(reused->startTime, 8u);
+    CHECK_EQ(old->appName, std::string("explorer"));  // 已返回的快照不受影响
+    CHECK_EQ(cache.Stats().evicted, 1u);
+    CHECK_EQ(source.openHandles, 1);
+
+    // 进程退出：查询失败且条目被移除
+    source.processes.erase(42);
+    CHECK(cache.Lookup(42) == nullptr);
+    CHECK_EQ(cache.Size(), 0u);
+    CHECK_EQ(source.openHandles, 0);
+}
+
+TEST(EvictExitedAndCapacity) {
+    FakeSource source;
+    for (uint32_t pid = 1; pid <= 5; pid++) {
+        source.processes[pid] = {pid, "/bin/p" + std::to_string(pid)};
+    }
+    ProcessInfoCache cache(source, 3);
+    cache.Lookup(1);
+    cache.Lookup(2);
+    cache.Lookup(3);
+    cache.Lookup(1);  // 2 成为最久未使用
+
+    source.processes.erase(3);
+    CHECK_EQ(cache.EvictExited(), 1u);
+    CHECK_EQ(cache.Size(), 2u);
+
+    cache.Lookup(4);
+    CHECK_EQ(cache.Size(), 3u);
+    cache.Lookup(5);  // 满：淘汰 2
+    CHECK_EQ(cache.Size(), 3u);
+    const int opens = source.opens;
+    cache.Lookup(1);
+    cache.Lookup(4);
+    cache.Lookup(5);
+    CHECK_EQ(source.opens, opens);
+    cache.Lookup(2);
+    CHECK_EQ(source.opens, opens + 1);
+    CHECK_EQ(source.openHandles, 3);
+}
+
+TEST(PeriodicSweepClosesExitedHandles) {
+    FakeSource source;
+    source.processes[1] = {1, "/bin/a"};
+    source.processes[2] = {2, "/bin/b"};
+    ProcessInfoCache cache(source);
+    cache.Lookup(1);
+    cache.Lookup(2);
+    CHECK_EQ(cache.EvictExitedIfDue(10000, 5000), 0u);
+
+    // 进程退出后即使不再查询该 pid，到期的清理也会关闭句柄
+    source.processes.erase(2);
+    CHECK_EQ(cache.EvictExitedIfDue(12000, 5000), 0u);
+    CHECK_EQ(source.openHandles, 2);
+    CHECK_EQ(cache.EvictExitedIfDue(15000, 5000), 1u);
+    CHECK_EQ(source.openHandles, 1);
+    CHECK_EQ(cache.Size(), 1u);
+}
+
+TEST(UnreadablePathIsCachedAndIconKeyIsStored) {
+    FakeSource source;
+    source.processes[4] = {1, ""};  // 如受保护进程：能打开但读不到路径
+    source.processes[9] = {2, "C:\\Apps\\Foo.exe"};
+    ProcessInfoCache cache(source);
+    auto system = cache.Lookup(4);
+    CHECK(system != nullptr);
+    CHECK(system->appPath.empty());
+    CHECK(system->appName.empty());
+    cache.Lookup(4);
+    CHECK_EQ(source.pathReads, 1);
+
+    auto foo = cache.Lookup(9);
+    CHECK(foo->iconKey.empty());
+    CHECK(!cache.SetIconKey(9, 3, "stale"));
+    CHECK(!cache.SetIconKey(10, 2, "missing"));
+    CHECK(cache.SetIconKey(9, 2, "c:\\apps\\foo.exe,0"));
+    CHECK_EQ(cache.Lookup(9)->iconKey, std::string("c:\\apps\\foo.exe,0"));
+    CHECK(foo->iconKey.empty());
+}
+
+TEST(ProcfsSourceReadsSelf) {
+    ztools::ProcfsProcessSource source;
+    ProcessInfoCache cache(source);
+    const uint32_t self = static_cast<uint32_t>(getpid());
+    auto info = cache.Lookup(self);
+    CHECK(info != nullptr);
+    char exe[4096];
+    const ssize_t size = readlink("/proc/self/exe", exe, sizeof(exe));
+    CHECK(size > 0);
+    CHECK_EQ(info->appPath, std::string(exe, static_cast<size_t>(size)));
+    CHECK_EQ(info->app, std::string("test-process-info-cache"));
+    uint64_t startTime = 0;
+    CHECK(ztools::ReadProcessStartTime(self, &startTime));
+    CHECK_EQ(info->startTime, startTime);
+    CHECK(cache.Lookup(self) == info);
+    CHECK_EQ(cache.Stats().hits, 1u);
+}
+
+TEST(ProcfsSourceDetectsExit) {
+    ztools::ProcfsProcessSource source;
+    ProcessInfoCache cache(source);
+    const pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    CHECK(child > 0);
+    auto info = cache.Lookup(static_cast<uint32_t>(child));
+    CHECK(info != nullptr);
+    CHECK_EQ(info->app, std::string("test-process-info-cache"));
+    CHECK_EQ(cache.EvictExited(), 0u);
+
+    // 僵尸状态（未回收）即视为退出
+    kill(child, SIGKILL);
+    siginfo_t status;
+    waitid(P_PID, static_cast<id_t>(child), &status, WEXITED | WNOWAIT);
+    CHECK_EQ(cache.EvictExited(), 1u);
+    CHECK(cache.Lookup(static_cast<uint32_t>(child)) == nullptr);
+    waitpid(child, nullptr, 0);
+    CHECK(cache.Lookup(static_cast<uint32_t>(child)) == nullptr);
+    CHECK_EQ(cache.Size(), 0u);
+}
+
+int main() {
+    return ztest::RunAll("ProcessInfoCache");
+}
@@ -0,0 +1,109 @@
+#include "test-util.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "common/sequence_waiter.h"
+
+using ztools::SequenceWaiter;
+using ztools::SequenceWaitOptions;
+using ztools::SequenceWaitResult;
+
+namespace {
+
+// 虚拟时钟：sleep 只推进时间；按时间表在指定时刻修改序列号
+struct Harness {
+    uint64_t now = 0;
+    uint64_t sequence = 10;
+    std::vector<std::pair<uint64_t, uint64_t>> schedule;  // (时间, 新序列号)
+    SequenceWaiter waiter;
+
+    Harness()
+        : waiter([this]() { return Sequence(); }, [this]() { return now; }, [this](uint64_t us) { now += us; }) {}
+
+    uint64_t Sequence() {
+        for (const auto& step : schedule) {
+            if (now >= step.first) sequence = step.second;
+        }
+        return sequence;
+    }
+};
+
+SequenceWaitOptions Options(uint64_t timeoutMs, uint64_t pollMs, uint64_t settleMs) {
+    SequenceWaitOptions options;
+    options.timeoutUs = timeoutMs * 1000;
+    options.pollUs = pollMs * 1000;
+    options.settleUs = settleMs * 1000;
+    return options;
+}
+
+}  // namespace
+
+TEST(ReturnsRightAfterChange) {
+    Harness h;
+    h.schedule = {{7000, 11}};
+    SequenceWaitResult r = h.waiter.Wait(10, Options(500, 2, 0));
+    CHECK(r.changed);
+    CHECK_EQ(r.sequence, 11u);
+    CHECK_EQ(r.waitedUs, 8000u);  // 下一次轮询即返回
+}
+
+TEST(TimesOutWithoutChange) {
+    Harness h;
+    SequenceWaitResult r = h.waiter.Wait(10, Options(100, 3, 15));
+    CHECK(!r.changed);
+    CHECK_EQ(r.sequence, 10u);
+    CHECK_EQ(r.waitedUs, 100000u);  // 最后一次休眠被截断到超时时刻
+}
+
+TEST(WaitsForWritesToSettle) {
+    // 目标程序先清空再分三次写入格式
+    Harness h;
+    h.schedule = {{4000, 11}, {10000, 12}, {18000, 13}};
+    SequenceWaitResult r = h.waiter.Wait(10, Options(500, 2, 15));
+    CHECK(r.changed);
+    CHECK_EQ(r.sequence, 13u);
+    CHECK(r.waitedUs >= 18000u + 15000u);
+    CHECK(r.waitedUs < 18000u + 15000u + 2000u);
+}
+
+TEST(SettleIsBoundedByTimeout) {
+    // 序列号持续变化（例如另一个程序在不停写剪贴板）
+    Harness h;
+    for (uint64_t t = 1000; t < 2000000; t += 5000) {
+        h.schedule.push_back({t, 100 + t});
+    }
+    SequenceWaitResult r = h.waiter.Wait(10, Options(100, 2, 15));
+    CHECK(r.changed);
+    CHECK(r.waitedUs <= 100000u + 15000u);
+}
+
+TEST(ChangeBeforeFirstPollIsSeen) {
+    Harness h;
+    h.sequence = 42;  // 调用 Wait 之前已经变化
+    SequenceWaitResult r = h.waiter.Wait(10, Options(500, 2, 0));
+    CHECK(r.changed);
+    CHECK_EQ(r.polls, 1u);
+    CHECK_EQ(r.waitedUs, 0u);
+}
+
+TEST(RealClockAndThread) {
+    std::atomic<uint64_t> sequence(1);
+    SequenceWaiter waiter([&]() { return sequence.load(); });
+    std::thread writer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        sequence = 2;
+    });
+    double start = ztest::NowSeconds();
+    SequenceWaitResult r = waiter.Wait(1, Options(1000, 1, 5));
+    double elapsed = ztest::NowSeconds() - start;
+    writer.join();
+    CHECK(r.changed);
+    CHECK_EQ(r.sequence, 2u);
+    CHECK(elapsed < 0.5);
+}
+
+int main() {
+    return ztest::RunAll("SequenceWaiter");
+}
@@ -0,0 +1,151 @@
+#include "test-util.h"
+
+#include <string>
+#include <vector>
+
+#include "common/text_classifier.h"
+
+using ztools::ClassifyText;
+using ztools::TextClassification;
+using ztools::TextClassifyOptions;
+
+namespace {
+
+std::string Span(const std::string& text, const ztools::TextMatch& match) {
+    return text.substr(match.begin, match.end - match.begin);
+}
+
+// 向量化与逐字节路径的结果必须一致
+TextClassification ClassifyBoth(const std::string& text) {
+    TextClassification vectorized = ClassifyText(text);
+    TextClassifyOptions scalarOptions;
+    scalarOptions.vectorized = false;
+    TextClassification scalar = ClassifyText(text, scalarOptions);
+    CHECK_EQ(vectorized.kinds, scalar.kinds);
+    CHECK_EQ(vectorized.exact, scalar.exact);
+    CHECK_EQ(vectorized.matches.size(), scalar.matches.size());
+    for (size_t i = 0; i < vectorized.matches.size() && i < scalar.matches.size(); i++) {
+        CHECK_EQ(vectorized.matches[i].begin, scalar.matches[i].begin);
+        CHECK_EQ(vectorized.matches[i].end, scalar.matches[i].end);
+    }
+    return vectorized;
+}
+
+}  // namespace
+
+TEST(DetectsExactUrl) {
+    std::string text = "  https://example.com/a?b=1#top\n";
+    TextClassification result = ClassifyBoth(text);
+    CHECK_EQ(result.kinds, ztools::kTextKindUrl);
+    CHECK_EQ(result.exact, ztools::kTextKindUrl);
+    CHECK_EQ(result.matches.size(), 1u);
+    CHECK_EQ(Span(text, result.matches[0]), "https://example.com/a?b=1#top");
+}
+
+TEST(UrlStopsAtPunctuation) {
+    std::string text = "访问 https://example.com/x，或者 (see http://a.org/wiki_(b)). 然后 ftp://h/p.";
+    TextClassification result = ClassifyBoth(text);
+    CHECK_EQ(result.kinds, ztools::kTextKindUrl);
+    CHECK_EQ(result.exact, 0u);
+    CHECK_EQ(result.matches.size(), 3u);
+    CHECK_EQ(Span(text, result.matches[0]), "https://example.com/x");
+    CHECK_EQ(Span(text, result.matches[1]), "http://a.org/wiki_(b)");
+    CHECK_EQ(Span(text, result.matches[2]), "ftp://h/p");
+}
+
+TEST(DetectsEmailsAndColors) {
+    std::string text = "mail dev.team+x@mail.example.org, color: #1e90ff; bg rgba(0, 0, 0, .5) not#abc &#123; x@y";
+    TextClassification result = ClassifyBoth(text);
+    CHECK_EQ(result.kinds, ztools::kTextKindEmail | ztools::kTextKindColor);
+    CHECK_EQ(result.matches.size(), 3u);
+    CHECK_EQ(Span(text, result.matches[0]), "dev.team+x@mail.example.org");
+    CHECK_EQ(Span(text, result.matches[1]), "#1e90ff");
+    CHECK_EQ(Span(text, result.matches[2]), "rgba(0, 0, 0, .5)");
+
+    CHECK_EQ(ClassifyBoth("#FFF").exact, ztools::kTextKindColor);
+    CHECK_EQ(ClassifyBoth("#12345").kinds, 0u);
+}
+
+TEST(DetectsPaths) {
+    std::string text =
+        "打开 C:\\Users\\dev\\文档\\报告.docx，再看 \"D:\\Program Files\\app.exe\" 和 \\\\nas\\share\\a "
+        "以及 /usr/local/bin 与 ~/notes.txt。and/or /single";
+    TextClassification result = ClassifyBoth(text);
+    CHECK_EQ(result.kinds, ztools::kTextKindPath);
+    CHECK_EQ(result.matches.size(), 5u);
+    CHECK_EQ(Span(text, result.matches[0]), "C:\\Users\\dev\\文档\\报告.docx");
+    CHECK_EQ(Span(text, result.matches[1]), "D:\\Program Files\\app.exe");
+    CHECK_EQ(Span(text, result.matches[2]), "\\\\nas\\share\\a");
+    CHECK_EQ(Span(text, result.matches[3]), "/usr/local/bin");
+    CHECK_EQ(Span(text, result.matches[4]), "~/notes.txt");
+}
+
+TEST(DetectsJson) {
+    TextClassification object = ClassifyBoth("{\n  \"url\": \"https://a.com/\\\"x\",\n  \"n\": [1, -2.5e3, true, null]\n}\n");
+    CHECK(object.kinds & ztools::kTextKindJson);
+    CHECK(object.kinds & ztools::kTextKindUrl);
+    CHECK_EQ(object.exact, ztools::kTextKindJson);
+    CHECK((object.kinds & ztools::kTextKindCode) == 0);
+
+    CHECK_EQ(ClassifyBoth("[{\"a\": {}}, []]").exact, ztools::kTextKindJson);
+    CHECK_EQ(ClassifyBoth("[hello world]").kinds & ztools::kTextKindJson, 0u);
+    CHECK_EQ(ClassifyBoth("{a: 1}").kinds & ztools::kTextKindJson, 0u);
+    CHECK_EQ(ClassifyBoth("{\"a\": 1} {\"b\": 2}").kinds & ztools::kTextKindJson, 0u);
+    CHECK_EQ(ClassifyBoth("[1, 2}").kinds & ztools::kTextKindJson, 0u);
+    CHECK_EQ(ClassifyBoth("{\"a\": \"]\"}").exact, ztools::kTextKindJson);
+}
+
+TEST(DetectsCode) {
+    std::string code =
+        "int main() {\n"
+        "    printf(\"hi\");\n"
+        "    return 0;\n"
+        "}\n";
+    CHECK(ClassifyBoth(code).kinds & ztools::kTextKindCode);
+
+    std::string prose = "第一行文字\n第二行文字。\nThird line here.";
+    CHECK_EQ(ClassifyBoth(prose).kinds, 0u);
+    CHECK_EQ(ClassifyBoth(prose).lines, 3u);
+}
+
+TEST(LimitsMatchesAndBytes) {
+    std::string text;
+    for (int i = 0; i < 40; i++) {
+        text += "see https://h" + std::to_string(i) + ".com now\n";
+    }
+    TextClassifyOptions options;
+    options.maxMatches = 4;
+    TextClassification result = ClassifyText(text, options);
+    CHECK_EQ(result.matches.size(), 4u);
+    CHECK(result.truncated);
+    CHECK_EQ(result.kinds, ztools::kTextKindUrl);
+
+    options.maxMatches = 16;
+    options.maxBytes = 10;
+    result = ClassifyText("{\"a\": \"https://x.com\"}", options);
+    CHECK(result.truncated);
+    CHECK_EQ(result.kinds, 0u);
+}
+
+TEST(ConvertsOffsetsToUtf16) {
+    std::string text = "中文\xF0\x9F\x98\x80 https://a.com x";
+    TextClassification result = ClassifyText(text);
+    CHECK_EQ(result.matches.size(), 1u);
+    ztools::ConvertTextMatchesToUtf16(text.data(), text.size(), result.matches);
+    // 中(1) 文(1) 😀(2) 空格(1)
+    CHECK_EQ(result.matches[0].begin, 5u);
+    CHECK_EQ(result.matches[0].end, 18u);
+}
+
+TEST(ScanPathsAgreeOnBlockBoundaries) {
+    // 触发字符落在 16 字节分组边界前后
+    for (size_t pad = 0; pad < 40; pad++) {
+        std::string text = std::string(pad, 'x') + " a@b.cn #abc C:\\x\\y http://q.io/z " + std::string(pad % 7, ' ');
+        TextClassification result = ClassifyBoth(text);
+        CHECK_EQ(result.matches.size(), 4u);
+    }
+}
+
+int main() {
+    return ztest::RunAll("TextClassifier");
+}
@@ -0,0 +1,121 @@
+#include "test-util.h"
+
+#include <cstdlib>
+#include <string>
+
+#include "common/utf_transcode.h"
+
+using ztools::TranscodeOptions;
+
+namespace {
+
+TranscodeOptions Scalar() {
+    TranscodeOptions options;
+    options.vectorized = false;
+    return options;
+}
+
+std::u16string U16(std::initializer_list<uint16_t> units) {
+    std::u16string s;
+    for (uint16_t u : units) s.push_back(static_cast<char16_t>(u));
+    return s;
+}
+
+std::string ToUtf8(const std::u16string& s, const TranscodeOptions& options = TranscodeOptions()) {
+    return ztools::Utf16ToUtf8(s.data(), s.size(), options);
+}
+
+std::u16string ToUtf16(const std::string& s, const TranscodeOptions& options = TranscodeOptions()) {
+    return ztools::Utf8ToUtf16(s.data(), s.size(), options);
+}
+
+}  // namespace
+
+TEST(AsciiRoundTripsAtEveryLength) {
+    // 覆盖 16/32 码元整组与尾部的所有组合
+    for (size_t length = 0; length < 100; length++) {
+        std::string ascii;
+        for (size_t i = 0; i < length; i++) ascii.push_back(static_cast<char>(' ' + (i * 7) % 95));
+        std::u16string wide = ToUtf16(ascii);
+        CHECK_EQ(wide.size(), length);
+        CHECK(wide == ToUtf16(ascii, Scalar()));
+        CHECK_EQ(ToUtf8(wide), ascii);
+        CHECK_EQ(ToUtf8(wide, Scalar()), ascii);
+    }
+}
+
+TEST(EncodesEachSequenceLength) {
+    // "a" + U+00E9 + U+4E2D + U+1F600
+    const std::string utf8 = "a\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80";
+    const std::u16string utf16 = U16({0x61, 0xE9, 0x4E2D, 0xD83D, 0xDE00});
+    CHECK(ToUtf16(utf8) == utf16);
+    CHECK_EQ(ToUtf8(utf16), utf8);
+    CHECK_EQ(ztools::Utf8LengthOfUtf16(utf16.data(), utf16.size()), utf8.size());
+
+    // 边界码点
+    CHECK_EQ(ToUtf8(U16({0x7F, 0x80, 0x7FF, 0x800, 0xFFFF})), "\x7F\xC2\x80\xDF\xBF\xE0\xA0\x80\xEF\xBF\xBF");
+    CHECK_EQ(ToUtf8(U16({0xDBFF, 0xDFFF})), "\xF4\x8F\xBF\xBF");  // U+10FFFF
+    CHECK(ToUtf16("\xF0\x90\x80\x80") == U16({0xD800, 0xDC00}));    // U+10000
+}
+
+TEST(LoneSurrogatesBecomeReplacement) {
+    const std::string fffd = "\xEF\xBF\xBD";
+    CHECK_EQ(ToUtf8(U16({0xD800})), fffd);                      // 结尾的高代理
+    CHECK_EQ(ToUtf8(U16({0xDC00, 0x41})), fffd + "A");          // 孤立低代理
+    CHECK_EQ(ToUtf8(U16({0xD800, 0x41})), fffd + "A");          // 高代理后不是低代理
+    CHECK_EQ(ToUtf8(U16({0xD800, 0xD800, 0xDC00})), fffd + "\xF0\x90\x80\x80");
+    CHECK_EQ(ToUtf8(U16({0xDC00, 0xD800})), fffd + fffd);       // 顺序颠倒
+    CHECK_EQ(ztools::Utf8LengthOfUtf16(U16({0xD800, 0x41}).data(), 2), 4u);
+}
+
+TEST(InvalidUtf8BecomesReplacementPerLeadByte) {
+    const std::u16string one = U16({0xFFFD});
+    CHECK(ToUtf16("\x80") == one);                                  // 孤立续字节
+    CHECK(ToUtf16("\xFF") == one);
+    CHECK(ToUtf16("\xC0\x80") == U16({0xFFFD, 0xFFFD}));            // 过长编码
+    CHECK(ToUtf16("\xED\xA0\x80") == U16({0xFFFD, 0xFFFD, 0xFFFD}));  // 编码的代理项
+    CHECK(ToUtf16("\xF4\x90\x80\x80") == U16({0xFFFD, 0xFFFD, 0xFFFD, 0xFFFD}));  // 超过 U+10FFFF
+    CHECK(ToUtf16("\xE4\xB8") == U16({0xFFFD, 0xFFFD}));            // 截断
+    CHECK(ToUtf16("\xE4\xB8" "A") == U16({0xFFFD, 0xFFFD, 0x41}));
+}
+
+TEST(VectorizedMatchesScalar) {
+    // ASCII 为主、随机插入多字节字符与非法码元，跨越各个组边界
+    srand(11);
+    static const char* const kPieces[] = {"\xC3\xA9", "\xE4\xB8\xAD", "\xF0\x9F\x98\x80", "\xED\xA0\x80", "\x80"};
+    for (int round = 0; round < 50; round++) {
+        std::string utf8;
+        const size_t length = static_cast<size_t>(rand() % 400);
+        while (utf8.size() < length) {
+            if (rand() % 20 == 0) {
+                utf8 += kPieces[rand() % 5];
+            } else {
+                utf8.push_back(static_cast<char>('a' + rand() % 26));
+            }
+        }
+        const std::u16string wide = ToUtf16(utf8);
+        CHECK(wide == ToUtf16(utf8, Scalar()));
+
+        std::u16string withLone = wide;
+        if (!withLone.empty()) withLone[rand() % withLone.size()] = 0xDC01;
+        const std::string back = ToUtf8(withLone);
+        CHECK_EQ(back, ToUtf8(withLone, Scalar()));
+        CHECK_EQ(back.size(), ztools::Utf8LengthOfUtf16(withLone.data(), withLone.size()));
+    }
+}
+
+TEST(AppendKeepsExistingContent) {
+    std::string out = "prefix:";
+    const std::u16string wide = U16({0x4E2D, 0x6587});
+    CHECK_EQ(ztools::AppendUtf16AsUtf8(wide.data(), wide.size(), out), 6u);
+    CHECK_EQ(out, "prefix:\xE4\xB8\xAD\xE6\x96\x87");
+
+    std::u16string wideOut = U16({0x41});
+    CHECK_EQ(ztools::AppendUtf8AsUtf16("bc", 2, wideOut), 2u);
+    CHECK(wideOut == U16({0x41, 0x62, 0x63}));
+    CHECK_EQ(ztools::AppendUtf8AsUtf16("", 0, wideOut), 0u);
+}
+
+int main() {
+    return ztest::RunAll("UtfTranscode");
+}
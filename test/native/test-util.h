@@ -0,0 +1,110 @@
+// 原生模块单元测试 / 基准测试的公共辅助
+//
+// 每个 test-*.cpp / bench-*.cpp 都是独立可执行文件，由 scripts/native-test.js 编译运行。
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ztest {
+
+struct TestCase {
+    const char* name;
+    std::function<void()> fn;
+};
+
+inline std::vector<TestCase>& Registry() {
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline int& Failures() {
+    static int failures = 0;
+    return failures;
+}
+
+struct Registrar {
+    Registrar(const char* name, std::function<void()> fn) {
+        Registry().push_back({name, std::move(fn)});
+    }
+};
+
+// 运行所有已注册的用例，返回进程退出码
+inline int RunAll(const char* suite) {
+    printf("【%s】\n", suite);
+    int failedCases = 0;
+    for (const auto& tc : Registry()) {
+        int before = Failures();
+        tc.fn();
+        bool ok = Failures() == before;
+        if (!ok) failedCases++;
+        printf("  %s %s\n", ok ? "✅" : "❌", tc.name);
+    }
+    printf("  %zu 个用例，%d 个失败\n", Registry().size(), failedCases);
+    return failedCases == 0 ? 0 : 1;
+}
+
+// 需要外部环境（如 X 服务器）的测试在条件不满足时跳过
+inline int Skip(const char* suite, const char* reason) {
+    printf("【%s】\n  ⏭️  跳过: %s\n", suite, reason);
+    return 0;
+}
+
+// 单调时钟（秒）
+inline double NowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 重复执行 fn 至少 minSeconds 秒，返回平均每次耗时（秒）
+inline double TimeIt(const std::function<void()>& fn, double minSeconds = 0.2) {
+    fn();  // 预热
+    size_t iterations = 0;
+    double start = NowSeconds();
+    double elapsed = 0;
+    do {
+        fn();
+        iterations++;
+        elapsed = NowSeconds() - start;
+    } while (elapsed < minSeconds);
+    return elapsed / iterations;
+}
+
+// 打印一行基准结果；bytes 为每次处理的数据量（0 表示不计算吞吐）
+inline void Report(const std::string& name, double secondsPerOp, size_t bytes = 0) {
+    if (bytes > 0) {
+        double mbps = bytes / secondsPerOp / (1024.0 * 1024.0);
+        printf("  %-44s %12.3f us/op %10.1f MB/s\n", name.c_str(), secondsPerOp * 1e6, mbps);
+    } else {
+        printf("  %-44s %12.3f us/op\n", name.c_str(), secondsPerOp * 1e6);
+    }
+}
+
+// 防止编译器优化掉基准中的计算结果
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+}  // namespace ztest
+
+#define ZTEST_CONCAT_INNER(a, b) a##b
+#define ZTEST_CONCAT(a, b) ZTEST_CONCAT_INNER(a, b)
+
+#define TEST(name)                                                      \
+    static void name();                                                 \
+    static ztest::Registrar ZTEST_CONCAT(registrar_, name)(#name, name); \
+    static void name()
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            fprintf(stderr, "    %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ztest::Failures()++;                                                    \
+        }                                                                           \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
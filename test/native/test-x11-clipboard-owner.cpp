@@ -0,0 +1,124 @@
+// X11 延迟渲染选区所有者测试（需要 X 服务器，无头环境可使用: xvfb-run node scripts/native-test.js x11）
+#include "test-util.h"
+#include "x11-selection-owner.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/clipboard_provider.h"
+#include "linux/x11_clipboard_owner.h"
+#include "linux/x11_pasteboard.h"
+
+using ztools::ClipboardProvider;
+using ztools::X11ClipboardOwner;
+using ztools::X11Pasteboard;
+
+namespace {
+
+std::shared_ptr<ClipboardProvider> CountingProvider(const std::string& format, const std::string& payload) {
+    auto provider = std::make_shared<ClipboardProvider>();
+    provider->Add(format, [payload](std::string& data) {
+        data = payload;
+        return true;
+    });
+    return provider;
+}
+
+}  // namespace
+
+TEST(TargetsAreAdvertisedWithoutRendering) {
+    auto provider = std::make_shared<ClipboardProvider>();
+    provider->Add("image/png", [](std::string& data) {
+        data = "png";
+        return true;
+    });
+    provider->Add("image/bmp", [](std::string& data) {
+        data = "bmp";
+        return true;
+    });
+
+    X11ClipboardOwner owner;
+    CHECK(owner.Start());
+    CHECK(owner.Own(provider));
+    CHECK(owner.Owns());
+
+    X11Pasteboard pasteboard;
+    CHECK(pasteboard.Open());
+    std::vector<std::string> targets;
+    CHECK(pasteboard.ReadTargets(targets));
+    CHECK(std::find(targets.begin(), targets.end(), "image/png") != targets.end());
+    CHECK(std::find(targets.begin(), targets.end(), "image/bmp") != targets.end());
+    CHECK_EQ(provider->RenderCount(), 0u);
+}
+
+TEST(RequestedTargetRendersOnce) {
+    auto provider = CountingProvider("image/png", "\x89PNG payload");
+    X11ClipboardOwner owner;
+    CHECK(owner.Start());
+    CHECK(owner.Own(provider));
+
+    X11Pasteboard pasteboard;
+    CHECK(pasteboard.Open());
+    std::string first;
+    std::string second;
+    CHECK(pasteboard.ReadTarget("image/png", first));
+    CHECK(pasteboard.ReadTarget("image/png", second));
+    CHECK_EQ(first, "\x89PNG payload");
+    CHECK(second == first);
+    CHECK_EQ(provider->RenderCount(), 1u);
+
+    std::string missing;
+    CHECK(!pasteboard.ReadTarget("text/plain", missing));
+}
+
+TEST(LargeRenderIsSentIncrementally) {
+    std::string big(3 * 64 * 1024 + 17, '\0');
+    for (size_t i = 0; i < big.size(); i++) big[i] = static_cast<char>(i * 13 + 5);
+
+    X11ClipboardOwner owner;
+    owner.SetIncrChunk(64 * 1024);
+    CHECK(owner.Start());
+    CHECK(owner.Own(CountingProvider("image/png", big)));
+
+    X11Pasteboard pasteboard;
+    CHECK(pasteboard.Open());
+    std::string image;
+    CHECK(pasteboard.ReadImagePng(image));
+    CHECK_EQ(image.size(), big.size());
+    CHECK(image == big);
+}
+
+TEST(LosingOwnershipReleasesProvider) {
+    auto provider = CountingProvider("image/png", "png");
+    std::weak_ptr<ClipboardProvider> weak = provider;
+
+    X11ClipboardOwner owner;
+    CHECK(owner.Start());
+    CHECK(owner.Own(std::move(provider)));
+    CHECK(!weak.expired());
+
+    ztest::SelectionOwner other;
+    other.Offer({{"UTF8_STRING", "taken"}});
+    double start = ztest::NowSeconds();
+    while (owner.Owns() && ztest::NowSeconds() - start < 2.0) {
+    }
+    CHECK(!owner.Owns());
+    CHECK(weak.expired());
+
+    X11Pasteboard pasteboard;
+    CHECK(pasteboard.Open());
+    std::string text;
+    CHECK(pasteboard.ReadText(text));
+    CHECK_EQ(text, "taken");
+}
+
+int main() {
+    Display* probe = XOpenDisplay(nullptr);
+    if (probe == nullptr) {
+        return ztest::Skip("X11ClipboardOwner", "无法连接 X 服务器（未设置 DISPLAY）");
+    }
+    XCloseDisplay(probe);
+    return ztest::RunAll("X11ClipboardOwner");
+}
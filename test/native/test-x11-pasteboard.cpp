@@ -0,0 +1,133 @@
+// X11 选区读取测试（需要 X 服务器，无头环境可使用: xvfb-run node scripts/native-test.js x11）
+#include "test-util.h"
+#include "x11-selection-owner.h"
+
+#include <string>
+#include <vector>
+
+#include "linux/x11_pasteboard.h"
+
+using ztest::SelectionOwner;
+using ztools::ClipboardSource;
+using ztools::PasteboardSnapshot;
+using ztools::X11Pasteboard;
+
+TEST(ReadsTextFilesAndImage) {
+    SelectionOwner owner;
+    std::string png = "\x89PNG\r\n\x1a\n" + std::string(1000, 'p');
+    owner.Offer({{"UTF8_STRING", "你好 clipboard"},
+                 {"text/uri-list", "file:///tmp/a%20b\r\nfile:///tmp/c\r\n"},
+                 {"image/png", png}});
+
+    X11Pasteboard pasteboard;
+    CHECK(pasteboard.Open());
+    std::string text;
+    CHECK(pasteboard.ReadText(text));
+    CHECK_EQ(text, "你好 clipboard");
+
+    std::vector<std::string> files;
+    CHECK(pasteboard.ReadFiles(files));
+    CHECK_EQ(files.size(), 2u);
+    CHECK_EQ(files[0], "/tmp/a b");
+
+    std::string image;
+    CHECK(pasteboard.ReadImagePng(image));
+    CHECK(image == png);
+}
+
+TEST(MissingTargetsReadAsEmpty) {
+    SelectionOwner owner;
+    owner.Offer({{"STRING", "caf\xE9"}});
+
+    X11Pasteboard pasteboard;
+    CHECK(pasteboard.Open());
+    std::string text;
+    CHECK(pasteboard.ReadText(text));
+    CHECK_EQ(text, "caf\xC3\xA9");  // Latin-1 回退并转为 UTF-8
+
+    std::vector<std::string> files = {"stale"};
+    CHECK(pasteboard.ReadFiles(files));
+    CHECK(files.empty());
+    std::string image = "stale";
+    CHECK(pasteboard.ReadImagePng(image));
+    CHECK(image.empty());
+}
+
+TEST(IncrTransferIsReassembled) {
+    SelectionOwner owner;
+    std::string big(3 * SelectionOwner::kIncrChunk + 123, '\0');
+    for (size_t i = 0; i < big.size(); i++) big[i] = static_cast<char>(i * 31 + 7);
+    owner.Offer({{"image/png", big}});
+
+    X11Pasteboard pasteboard;
+    CHECK(pasteboard.Open());
+    std::string image;
+    CHECK(pasteboard.ReadImagePng(image));
+    CHECK_EQ(image.size(), big.size());
+    CHECK(image == big);
+
+    // INCR 之后同一连接上的普通读取不受影响
+    owner.Offer({{"UTF8_STRING", "after"}});
+    std::string text;
+    CHECK(pasteboard.ReadText(text));
+    CHECK_EQ(text, "after");
+}
+
+TEST(SaveCapturesEveryTarget) {
+    SelectionOwner owner;
+    owner.Offer({{"UTF8_STRING", "a"}, {"text/html", "<i>a</i>"}, {"application/x-custom", std::string("\0\1\2", 3)}});
+
+    X11Pasteboard pasteboard;
+    CHECK(pasteboard.Open());
+    std::vector<std::string> targets;
+    CHECK(pasteboard.ReadTargets(targets));
+    CHECK_EQ(targets.size(), 3u);  // TARGETS 本身被排除
+
+    PasteboardSnapshot snapshot;
+    CHECK(pasteboard.Save(snapshot));
+    CHECK_EQ(snapshot.items.size(), 1u);
+    CHECK_EQ(snapshot.items[0].entries.size(), 3u);
+    CHECK_EQ(snapshot.Bytes(), 1u + 8u + 3u);
+
+    // 写入需要持有选区，当前实现明确拒绝
+    CHECK(!pasteboard.Restore(snapshot));
+    CHECK(!pasteboard.Clear());
+}
+
+TEST(ChangeCountFollowsOwner) {
+    SelectionOwner owner;
+    X11Pasteboard pasteboard;
+    CHECK(pasteboard.Open());
+    uint64_t before = pasteboard.ChangeCount();
+    CHECK(before != 0);
+
+    owner.Offer({{"UTF8_STRING", "one"}});
+    uint64_t after = before;
+    double start = ztest::NowSeconds();
+    while (after == before && ztest::NowSeconds() - start < 2.0) {
+        after = pasteboard.ChangeCount();
+    }
+    CHECK(after > before);
+}
+
+TEST(PrimarySelectionIsIndependent) {
+    SelectionOwner clipboard;
+    SelectionOwner primary("PRIMARY");
+    clipboard.Offer({{"UTF8_STRING", "clipboard"}});
+    primary.Offer({{"UTF8_STRING", "primary"}});
+
+    X11Pasteboard pasteboard(ClipboardSource::Primary);
+    CHECK(pasteboard.Open());
+    std::string text;
+    CHECK(pasteboard.ReadText(text));
+    CHECK_EQ(text, "primary");
+}
+
+int main() {
+    Display* probe = XOpenDisplay(nullptr);
+    if (probe == nullptr) {
+        return ztest::Skip("X11Pasteboard", "无法连接 X 服务器（未设置 DISPLAY）");
+    }
+    XCloseDisplay(probe);
+    return ztest::RunAll("X11Pasteboard");
+}
@@ -0,0 +1,93 @@
+// PRIMARY 选区选中内容读取测试（需要 X 服务器，无头环境可使用: xvfb-run node scripts/native-test.js x11）
+#include "test-util.h"
+#include "x11-selection-owner.h"
+
+#include <string>
+
+#include "linux/x11_selected_content.h"
+
+using ztest::SelectionOwner;
+using ztools::ClipboardSource;
+using ztools::X11Pasteboard;
+using ztools::X11SelectedContent;
+
+TEST(ReadsTextAndFilesWithoutTouchingClipboard) {
+    SelectionOwner clipboard;
+    SelectionOwner primary("PRIMARY");
+    clipboard.Offer({{"UTF8_STRING", "clipboard"}});
+    primary.Offer({{"UTF8_STRING", "选中的文字"},
+                   {"STRING", "ignored"},
+                   {"text/uri-list", "file:///tmp/a%20b\r\nfile:///tmp/c\r\n"}});
+
+    X11Pasteboard pasteboard(ClipboardSource::Primary);
+    CHECK(pasteboard.Open());
+    X11SelectedContent content;
+    CHECK(ztools::ReadSelectedContent(pasteboard, ztools::kDefaultSelectedContentTimeoutMs, content));
+    CHECK(content.hasText);
+    CHECK_EQ(content.text, "选中的文字");
+    CHECK(content.hasFiles);
+    CHECK_EQ(content.files.size(), 2u);
+    CHECK_EQ(content.files[0], "/tmp/a b");
+
+    // TARGETS + 文本 + 文件列表，CLIPBOARD 所有者没有收到任何请求
+    CHECK_EQ(primary.Requests(), 3);
+    CHECK_EQ(clipboard.Requests(), 0);
+}
+
+TEST(FallsBackToLatin1String) {
+    SelectionOwner primary("PRIMARY");
+    primary.Offer({{"STRING", "caf\xE9"}});
+
+    X11Pasteboard pasteboard(ClipboardSource::Primary);
+    CHECK(pasteboard.Open());
+    X11SelectedContent content;
+    CHECK(ztools::ReadSelectedContent(pasteboard, ztools::kDefaultSelectedContentTimeoutMs, content));
+    CHECK(content.hasText);
+    CHECK_EQ(content.text, "caf\xC3\xA9");
+    CHECK(!content.hasFiles);
+}
+
+TEST(NoOwnerReadsAsEmpty) {
+    Display* display = XOpenDisplay(nullptr);
+    XSetSelectionOwner(display, XA_PRIMARY, None, CurrentTime);
+    XSync(display, False);
+    XCloseDisplay(display);
+
+    X11Pasteboard pasteboard(ClipboardSource::Primary);
+    CHECK(pasteboard.Open());
+    X11SelectedContent content;
+    content.hasText = true;
+    CHECK(ztools::ReadSelectedContent(pasteboard, ztools::kDefaultSelectedContentTimeoutMs, content));
+    CHECK(!content.hasText);
+    CHECK(!content.hasFiles);
+}
+
+TEST(UnresponsiveOwnerTimesOut) {
+    // 取得 PRIMARY 所有权但从不处理 SelectionRequest
+    Display* display = XOpenDisplay(nullptr);
+    Window window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 1, 1, 0, 0, 0);
+    XSetSelectionOwner(display, XA_PRIMARY, window, CurrentTime);
+    XSync(display, False);
+
+    X11Pasteboard pasteboard(ClipboardSource::Primary);
+    CHECK(pasteboard.Open());
+    X11SelectedContent content;
+    double start = ztest::NowSeconds();
+    CHECK(!ztools::ReadSelectedContent(pasteboard, 50, content));
+    double elapsed = ztest::NowSeconds() - start;
+    CHECK(elapsed >= 0.04);
+    CHECK(elapsed < 0.5);
+    CHECK(!content.hasText);
+
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+}
+
+int main() {
+    Display* probe = XOpenDisplay(nullptr);
+    if (probe == nullptr) {
+        return ztest::Skip("X11SelectedContent", "无法连接 X 服务器（未设置 DISPLAY）");
+    }
+    XCloseDisplay(probe);
+    return ztest::RunAll("X11SelectedContent");
+}
@@ -0,0 +1,128 @@
+// X11 选区监控测试（需要 X 服务器，无头环境可使用: xvfb-run node scripts/native-test.js x11）
+#include "test-util.h"
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "linux/x11_selection_monitor.h"
+
+using ztools::ClipboardSource;
+using ztools::X11SelectionMonitor;
+
+namespace {
+
+struct Collector {
+    std::mutex mutex;
+    std::condition_variable cv;
+    int clipboard = 0;
+    int primary = 0;
+
+    void Add(ClipboardSource source) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (source == ClipboardSource::Clipboard) clipboard++;
+        else primary++;
+        cv.notify_all();
+    }
+
+    bool WaitFor(int clipboardCount, int primaryCount, int timeoutMs) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&]() {
+            return clipboard >= clipboardCount && primary >= primaryCount;
+        });
+    }
+};
+
+// 作为选区所有者的本地客户端
+struct Owner {
+    Display* display;
+    Window window;
+    Atom clipboard;
+
+    Owner() {
+        display = XOpenDisplay(nullptr);
+        window = XCreateSimpleWindow(display, DefaultRootWindow(display), 0, 0, 1, 1, 0, 0, 0);
+        clipboard = XInternAtom(display, "CLIPBOARD", False);
+    }
+    ~Owner() {
+        XDestroyWindow(display, window);
+        XCloseDisplay(display);
+    }
+    void Take(Atom selection) {
+        XSetSelectionOwner(display, selection, window, CurrentTime);
+        XFlush(display);
+    }
+};
+
+}  // namespace
+
+TEST(ReportsClipboardOwnerChange) {
+    Collector collector;
+    X11SelectionMonitor monitor;
+    CHECK(monitor.Start([&](ClipboardSource source, uint64_t, uint64_t) { collector.Add(source); }));
+
+    Owner owner;
+    owner.Take(owner.clipboard);
+    CHECK(collector.WaitFor(1, 0, 2000));
+    CHECK_EQ(monitor.Sequence(ClipboardSource::Clipboard), 1u);
+    monitor.Stop();
+    CHECK(!monitor.IsRunning());
+}
+
+TEST(ReportsPrimarySeparately) {
+    Collector collector;
+    X11SelectionMonitor monitor;
+    CHECK(monitor.Start([&](ClipboardSource source, uint64_t, uint64_t) { collector.Add(source); }));
+
+    Owner owner;
+    owner.Take(XA_PRIMARY);
+    owner.Take(owner.clipboard);
+    CHECK(collector.WaitFor(1, 1, 2000));
+    monitor.Stop();
+}
+
+TEST(LatencyUnderFiveMilliseconds) {
+    std::atomic<double> receivedAt(0);
+    X11SelectionMonitor monitor;
+    CHECK(monitor.Start([&](ClipboardSource source, uint64_t, uint64_t) {
+        if (source == ClipboardSource::Clipboard) receivedAt = ztest::NowSeconds();
+    }));
+
+    Owner owner;
+    double worst = 0;
+    for (int i = 0; i < 20; i++) {
+        receivedAt = 0;
+        double sentAt = ztest::NowSeconds();
+        owner.Take(owner.clipboard);
+        while (receivedAt == 0 && ztest::NowSeconds() - sentAt < 1.0) {
+            std::this_thread::yield();
+        }
+        CHECK(receivedAt != 0);
+        worst = std::max(worst, receivedAt - sentAt);
+    }
+    printf("    最大通知延迟: %.3f ms\n", worst * 1000);
+    CHECK(worst < 0.005);
+    monitor.Stop();
+}
+
+TEST(StopIsIdempotentAndRestartable) {
+    X11SelectionMonitor monitor;
+    CHECK(monitor.Start(nullptr));
+    monitor.Stop();
+    monitor.Stop();
+    CHECK(monitor.Start(nullptr));
+    monitor.Stop();
+}
+
+int main() {
+    Display* probe = XOpenDisplay(nullptr);
+    if (probe == nullptr) {
+        return ztest::Skip("X11SelectionMonitor", "无法连接 X 服务器（未设置 DISPLAY）");
+    }
+    XCloseDisplay(probe);
+    return ztest::RunAll("X11SelectionMonitor");
+}
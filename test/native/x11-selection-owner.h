@@ -0,0 +1,170 @@
+// 测试/基准用的 X11 选区所有者：在独立线程中响应 SelectionRequest（支持 TARGETS 与 INCR）
+#pragma once
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ztest {
+
+class SelectionOwner {
+public:
+    // 超过该大小的数据以 INCR 分段发送
+    static const size_t kIncrChunk = 256 * 1024;
+
+    explicit SelectionOwner(const char* selectionName = "CLIPBOARD") : running_(true), requests_(0) {
+        display_ = XOpenDisplay(nullptr);
+        window_ = XCreateSimpleWindow(display_, DefaultRootWindow(display_), 0, 0, 1, 1, 0, 0, 0);
+        selection_ = XInternAtom(display_, selectionName, False);
+        targets_ = XInternAtom(display_, "TARGETS", False);
+        incr_ = XInternAtom(display_, "INCR", False);
+        if (pipe(wake_) == 0) {
+            fcntl(wake_[0], F_SETFL, O_NONBLOCK);
+        }
+        thread_ = std::thread(&SelectionOwner::Run, this);
+    }
+
+    ~SelectionOwner() {
+        running_ = false;
+        char byte = 1;
+        ssize_t written = write(wake_[1], &byte, 1);
+        (void)written;
+        thread_.join();
+        close(wake_[0]);
+        close(wake_[1]);
+        XDestroyWindow(display_, window_);
+        XCloseDisplay(display_);
+    }
+
+    // 设置提供的目标并取得选区所有权（按目标名提供原始字节）
+    void Offer(const std::map<std::string, std::string>& data) {
+        {
+            // 连接由两个线程共用，所有 Xlib 调用都在锁内进行
+            std::lock_guard<std::mutex> lock(mutex_);
+            data_.clear();
+            for (const auto& entry : data) {
+                data_[XInternAtom(display_, entry.first.c_str(), False)] = entry.second;
+            }
+            XSetSelectionOwner(display_, selection_, window_, CurrentTime);
+            XFlush(display_);
+        }
+        char byte = 1;
+        ssize_t written = write(wake_[1], &byte, 1);
+        (void)written;
+    }
+
+    int Requests() const { return requests_; }
+
+private:
+    struct Transfer {
+        Window requestor = 0;
+        Atom property = 0;
+        Atom type = 0;
+        std::string data;
+        size_t offset = 0;
+        bool active = false;
+    };
+
+    void Run() {
+        const int xfd = ConnectionNumber(display_);
+        while (running_) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (XPending(display_) > 0) {
+                XEvent event;
+                XNextEvent(display_, &event);
+                if (event.type == SelectionRequest) {
+                    HandleRequest(event.xselectionrequest);
+                } else if (event.type == PropertyNotify && transfer_.active &&
+                           event.xproperty.window == transfer_.requestor &&
+                           event.xproperty.atom == transfer_.property && event.xproperty.state == PropertyDelete) {
+                    SendChunk();
+                }
+            }
+            lock.unlock();
+            pollfd fds[2] = {{xfd, POLLIN, 0}, {wake_[0], POLLIN, 0}};
+            poll(fds, 2, -1);
+            char buffer[16];
+            while (read(wake_[0], buffer, sizeof(buffer)) > 0) {
+            }
+        }
+    }
+
+    void HandleRequest(const XSelectionRequestEvent& request) {
+        requests_++;
+        XSelectionEvent reply = {};
+        reply.type = SelectionNotify;
+        reply.requestor = request.requestor;
+        reply.selection = request.selection;
+        reply.target = request.target;
+        reply.time = request.time;
+        reply.property = request.property;
+
+        if (request.target == targets_) {
+            std::vector<Atom> atoms = {targets_};
+            for (const auto& entry : data_) atoms.push_back(entry.first);
+            XChangeProperty(display_, request.requestor, request.property, XA_ATOM, 32, PropModeReplace,
+                            reinterpret_cast<const unsigned char*>(atoms.data()), static_cast<int>(atoms.size()));
+        } else {
+            auto it = data_.find(request.target);
+            if (it == data_.end()) {
+                reply.property = None;
+            } else if (it->second.size() > kIncrChunk) {
+                transfer_.requestor = request.requestor;
+                transfer_.property = request.property;
+                transfer_.type = request.target;
+                transfer_.data = it->second;
+                transfer_.offset = 0;
+                transfer_.active = true;
+                XSelectInput(display_, request.requestor, PropertyChangeMask);
+                long size = static_cast<long>(it->second.size());
+                XChangeProperty(display_, request.requestor, request.property, incr_, 32, PropModeReplace,
+                                reinterpret_cast<const unsigned char*>(&size), 1);
+            } else {
+                XChangeProperty(display_, request.requestor, request.property, request.target, 8, PropModeReplace,
+                                reinterpret_cast<const unsigned char*>(it->second.data()),
+                                static_cast<int>(it->second.size()));
+            }
+        }
+        XSendEvent(display_, request.requestor, False, NoEventMask, reinterpret_cast<XEvent*>(&reply));
+        XFlush(display_);
+    }
+
+    // 请求方删除属性后发送下一段；最后发送长度为 0 的段
+    void SendChunk() {
+        size_t remaining = transfer_.data.size() - transfer_.offset;
+        size_t chunk = remaining < kIncrChunk ? remaining : kIncrChunk;
+        XChangeProperty(display_, transfer_.requestor, transfer_.property, transfer_.type, 8, PropModeReplace,
+                        reinterpret_cast<const unsigned char*>(transfer_.data.data() + transfer_.offset),
+                        static_cast<int>(chunk));
+        transfer_.offset += chunk;
+        if (chunk == 0) {
+            transfer_.active = false;
+            XSelectInput(display_, transfer_.requestor, NoEventMask);
+        }
+        XFlush(display_);
+    }
+
+    Display* display_;
+    Window window_;
+    Atom selection_;
+    Atom targets_;
+    Atom incr_;
+    int wake_[2];
+    std::atomic<bool> running_;
+    std::atomic<int> requests_;
+    std::mutex mutex_;
+    std::map<Atom, std::string> data_;
+    Transfer transfer_;
+    std::thread thread_;
+};
+
+}  // namespace ztest
@@ -1,13 +1,16 @@
-const { getSelectedContent } = require('../index.js');
+const { getSelectedContent, getSelectedContentAsync } = require('../index.js');
 
-console.log('=== 测试获取选中内容功能 ===\n');
+// node test/test-selected-content.js --async 使用 Promise 版本
+const useAsync = process.argv.includes('--async');
+
+console.log(`=== 测试获取选中内容功能${useAsync ? '（异步）' : ''} ===\n`);
 console.log('支持文本、文件、图像三种类型');
 console.log('请在任意应用中选中一些内容（文本/文件/图像）...');
 console.log('将在 3 秒后自动获取选中的内容\n');
 
 // 倒计时
 let countdown = 3;
-const timer = setInterval(() => {
+const timer = setInterval(async () => {
   console.log(`${countdown}...`);
   countdown--;
 
@@ -16,7 +19,19 @@ const timer = setInterval(() => {
     console.log('\n正在获取选中的内容...\n');
 
     try {
-      const contents = getSelectedContent();
+      const start = Date.now();
+      let contents;
+      if (useAsync) {
+        // 等待期间主线程保持响应：统计事件循环的 tick 次数
+        let ticks = 0;
+        const ticker = setInterval(() => ticks++, 5);
+        contents = await getSelectedContentAsync();
+        clearInterval(ticker);
+        console.log(`耗时 ${Date.now() - start}ms，期间事件循环 tick ${ticks} 次\n`);
+      } else {
+        contents = getSelectedContent();
+        console.log(`耗时 ${Date.now() - start}ms\n`);
+      }
 
       if (contents && contents.length > 0) {
         console.log(`✓ 成功获取 ${contents.length} 项内容:\n`);